@@ -194,6 +194,98 @@ void Stepper::update_dt(const State2D& Y_old, const State2D& Ystar, State2D& Y_n
     }
 }
 
+//--------------------------------------------------------------
+//  Heun-Euler step size control for the implicit E field solver
+void Stepper::update_dt(const State1D& Y_old, const State1D& Yerr, State1D& Y_new, int E_attempts){
+//--------------------------------------------------------------
+
+    /// f00 and f1m are checked for convergence
+    err_val =  check_dist(Yerr,Y_new,acceptability);
+
+    update_dt_implicitE(E_attempts);
+
+    /// If failed, restore old state and updated time step.
+    /// Success time-step is updated at the end of outer loop.
+    if (!overall_check)
+    {
+        _dt = dt_next;
+        Y_new = Y_old;
+    }
+    else
+    {
+        _success = true;
+    }
+}
+//--------------------------------------------------------------
+//  Heun-Euler step size control for the implicit E field solver
+void Stepper::update_dt(const State2D& Y_old, const State2D& Yerr, State2D& Y_new, int E_attempts){
+//--------------------------------------------------------------
+
+    /// f00 and f1m are checked for convergence
+    err_val =  check_dist(Yerr,Y_new,acceptability);
+
+    update_dt_implicitE(E_attempts);
+
+    /// If failed, restore old state and updated time step.
+    /// Success time-step is updated at the end of outer loop.
+    if (!overall_check)
+    {
+        _dt = dt_next;
+        Y_new = Y_old;
+    }
+    else
+    {
+        _success = true;
+    }
+}
+//--------------------------------------------------------------
+//  Determine the new time step from err_val and the E-field attempts
+void Stepper::update_dt_implicitE(int E_attempts){
+//--------------------------------------------------------------
+
+    /// Error is determined
+    acceptability = err_val/(atol + rtol*acceptability);
+    if (acceptability > 1) overall_check = false;
+    else overall_check = true;
+
+    /// The hardest E field inversion on any node sets the pace
+    MPI_Allreduce(MPI_IN_PLACE, &E_attempts, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+
+    /// Error is shared so that global timestep can be determined on rank 0
+    MPI_Gather(&acceptability, 1, MPI_DOUBLE, acceptabilitylist, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    if (world_rank == 0)
+    {   
+
+        /// Determine whether to proceed
+        for (int iprocess(0); iprocess < world_size; ++iprocess)
+        {
+            overall_check = ((!(acceptabilitylist[iprocess] > 1)) && overall_check);
+            acceptability = max(acceptabilitylist[iprocess],acceptability);
+        }
+
+        /// Heun-Euler is a (2,1) pair, so the error scales as dt^2
+        dt_next = 0.9*_dt/pow(acceptability,0.5);
+
+        if (!(overall_check > 0))
+        {
+            ++failed_steps;
+            if (failed_steps > max_failures) 
+            {
+                fprintf(stderr, "Time Stepper failed to converge within %zu steps \n", max_failures);
+                MPI_Finalize();
+                exit(1);
+            }
+        }
+
+        /// Retries in the E field inversion mean the step was too stiff
+        if (E_attempts > 1) dt_next = min(dt_next, 0.5*_dt);
+    }
+
+    /// Share success and new timestep
+    MPI_Bcast(&overall_check, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(&dt_next, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+}
+
 //--------------------------------------------------------------
 //  Collect all of the terms
 double Stepper::check_temperature(const State1D& Ystar, const State1D& Y){
@@ -259,6 +351,64 @@ double Stepper::check_flds(const State2D& Ystar, const State2D& Y, double& maxva
 }
 
 
+//--------------------------------------------------------------
+//  Largest error in f00 and f1m, maxval is the largest value of those harmonics
+double Stepper::check_dist(const State1D& Yerr, const State1D& Y, double& maxval){
+//--------------------------------------------------------------
+    maxval = 0.;
+    double err(0.);
+
+    for (size_t s(0); s < Y.Species(); ++s)
+    {
+        for (size_t l(0); l < 2; ++l)
+        {
+            for (size_t m(0); m < min(l,Y.DF(s).m0())+1; ++m)
+            {
+                for (size_t ip(0); ip < Y.SH(s,l,m).nump(); ++ip)
+                {
+                    for (size_t ix(Nbc); ix < Y.SH(s,l,m).numx() - Nbc; ++ix)
+                    {
+                        err    = max(err,abs(Yerr.SH(s,l,m)(ip,ix)));
+                        maxval = max(maxval,abs(Y.SH(s,l,m)(ip,ix)));
+                    }
+                }
+            }
+        }
+    }
+
+    return err;
+}
+//--------------------------------------------------------------
+//  Largest error in f00 and f1m, maxval is the largest value of those harmonics
+double Stepper::check_dist(const State2D& Yerr, const State2D& Y, double& maxval){
+//--------------------------------------------------------------
+    maxval = 0.;
+    double err(0.);
+
+    for (size_t s(0); s < Y.Species(); ++s)
+    {
+        for (size_t l(0); l < 2; ++l)
+        {
+            for (size_t m(0); m < min(l,Y.DF(s).m0())+1; ++m)
+            {
+                for (size_t ip(0); ip < Y.SH(s,l,m).nump(); ++ip)
+                {
+                    for (size_t ix(Nbc); ix < Y.SH(s,l,m).numx() - Nbc; ++ix)
+                    {
+                        for (size_t iy(Nbc); iy < Y.SH(s,l,m).numy() - Nbc; ++iy)
+                        {
+                            err    = max(err,abs(Yerr.SH(s,l,m)(ip,ix,iy)));
+                            maxval = max(maxval,abs(Y.SH(s,l,m)(ip,ix,iy)));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return err;
+}
+
 //--------------------------------------------------------------
 //  Collect all of the terms
 double Stepper::check_js(const State1D& Ystar, const State1D& Y){
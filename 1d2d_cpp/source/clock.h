@@ -24,12 +24,22 @@ public:
     double check_flds(const State1D& Ystar, const State1D& Y, double& maxval);
     double check_flds(const State2D& Ystar, const State2D& Y, double& maxval);
     double check_js(const State1D& Ystar, const State1D& Y);
+    double check_dist(const State1D& Yerr, const State1D& Y, double& maxval);
+    double check_dist(const State2D& Yerr, const State2D& Y, double& maxval);
 
     void update_dt(const State1D& Y_old, const State1D& Ystar, State1D& Y_new);
     void update_dt(const State2D& Y_old, const State2D& Ystar, State2D& Y_new);
 
+//      Heun-Euler control for the implicit-E step. Yerr holds the embedded error
+//      estimate and E_attempts the number of tries the implicit E solve needed.
+    void update_dt(const State1D& Y_old, const State1D& Yerr, State1D& Y_new, int E_attempts);
+    void update_dt(const State2D& Y_old, const State2D& Yerr, State2D& Y_new, int E_attempts);
+
     Stepper& operator++();
 
+//      Continue the clock from the time of a restart file
+    void resume(double starttime) {current_time = starttime;}
+
     double dt() {return _dt;}
     double nextdt() {return dt_next;}
     double time() {return current_time;}
@@ -37,6 +47,8 @@ public:
 
 private:
 
+    void update_dt_implicitE(int E_attempts);
+
     double current_time, dt_next, _dt;
     double atol, rtol, acceptability, err_val;
     
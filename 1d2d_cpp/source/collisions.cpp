@@ -20,6 +20,7 @@
 #include <cstdlib>
 #include <math.h>
 #include <map>
+#include <mpi.h>
 #include <omp.h>
 
 //  My libraries
@@ -34,6 +35,7 @@
 #include "formulary.h"
 #include "nmethods.h"
 #include "collisions.h"
+#include "parallel.h"
 
 
 
@@ -249,42 +251,24 @@ double self_f00_implicit_step::calc_delta_ChangCooper(const size_t& k, const dou
 }
 //---------------------------------------------------------------------------------------------
 //---------------------------------------------------------------------------------------------
-void self_f00_implicit_step::update_D_inversebremsstrahlung(const double& Z0, const double& heating_coefficient, const double& vos){
+double self_f00_implicit_step::D_inversebremsstrahlung(const size_t& ip, const double& heating_coefficient, const double& vw_cube){
 
-    double vw_cube;// = vw_coeff_cube; * ZLn_ei * 4.0*M_PI*I2;;
-
-    double temperature = I4_Lnee/3.0/C_RB[C_RB.size()-1];
-    vw_cube  = Z0*formulas.Zeta*formulas.LOGei(C_RB[C_RB.size()-1],temperature,Z0*formulas.Zeta);  ///< ZLogLambda
-    vw_cube *= vw_coeff_cube * C_RB[C_RB.size()-1];
-
-    double ZLnee = Z0*formulas.Zeta*formulas.LOGee(C_RB[C_RB.size()-1],temperature);
-
-    double g, b0, nueff, xsi;
-
-//    xsi     = 3.84+(142.59-65.48*vos/sqrt(temperature)/(27.3*vos/sqrt(temperature)+vos*vos/temperature);
-    
-
-    for (size_t ip(1); ip < D_RB.size()-1; ++ip){
+    /// Langdon factor at the cell edge ip
 //        b0      = (vos*vos+5.0*vr[ip]*vr[ip])/(5.0*vr[ip]*vr[ip]);
 //        nueff   = ZLnee/pow(vr[ip]*vr[ip]+vos*vos/xsi,1.5);
 //        g       = 1.0 - b0*nueff*vw_cube/(1.0+b0*b0*nuOeff*vw_cube);
+    double g(laser_Inv_Uav6[ip] * vw_cube * vw_cube);
+    g = 1.0 / (1.0 + g);
 
-
-
-        g = laser_Inv_Uav6[ip] * vw_cube * vw_cube;
-        g = 1.0 / (1.0 + g);
-
-        D_RB[ip] += heating_coefficient * g / vr[ip];
-    }
-
+    return heating_coefficient * g / vr[ip];
 }
 //---------------------------------------------------------------------------------------------
-//---------------------------------------------------------------------------------------------
 void self_f00_implicit_step::takestep(valarray<double>  &fin, valarray<double> &fh, const double& Z0, const double& vos, const double& step_size)//, const double& cooling) {
 {
 
     double collisional_coefficient;
-    double heating_coefficient;
+    double heating_coefficient(0.0);
+    double vw_cube(0.0);
 
     Array2D<double> LHS(fin.size(),fin.size());
 
@@ -292,25 +276,38 @@ void self_f00_implicit_step::takestep(valarray<double>  &fin, valarray<double> &
     update_C_Rosenbluth(fin);   /// Also fills in I4_Lnee (the temperature for the Lnee calculation)
     update_D_and_delta(fin);    /// And takes care of boundaries
 
+    const double density(C_RB[C_RB.size()-1]);
+    const double temperature(I4_Lnee/3.0/density);
+
     /// Normalizing quantities (Inspired by previous collision routines and OSHUN notes by M. Tzoufras)
-    collisional_coefficient  = formulas.LOGee(C_RB[C_RB.size()-1],I4_Lnee/3.0/C_RB[C_RB.size()-1]);
+    collisional_coefficient  = formulas.LOGee(density,temperature);
     collisional_coefficient *= 4.0*M_PI/3.0*c_kpre;
 
     collisional_coefficient *= step_size;           /// Step size incorporated here
 
 
+    /// Inverse bremsstrahlung only where the laser is on, ZLogLambda is shared
+    /// by the heating rate and the Langdon factor
+    const bool heating(ib && vos != 0.0);
+    if (heating) {
+        const double ZLogLambda(formulas.Zeta*Z0*formulas.LOGei(density,temperature,Z0*formulas.Zeta));
 
-    heating_coefficient  = formulas.Zeta*Z0*formulas.LOGei(C_RB[C_RB.size()-1],I4_Lnee/3.0/C_RB[C_RB.size()-1],Z0*formulas.Zeta);  ///< ZLogLambda
-    heating_coefficient *= c_kpre / 6.0 * pow(vos,2.0) * C_RB[C_RB.size()-1];
-    heating_coefficient /= collisional_coefficient;
+        heating_coefficient  = ZLogLambda;
+        heating_coefficient *= c_kpre / 6.0 * (vos*vos) * density;
+        heating_coefficient /= collisional_coefficient;
 
-    if (ib) update_D_inversebremsstrahlung(Z0, heating_coefficient, vos);
+        vw_cube  = ZLogLambda;
+        vw_cube *= vw_coeff_cube * density;
+    }
 
-    /// Fill in matrix
+    /// Fill in matrix, the heating is added to D at the upper edge of each row
+    /// as the row is assembled
 
     size_t ip(0);
 
     /// Boundaries by hand -- This operates on f(0)
+    if (heating) D_RB[ip + 1] += D_inversebremsstrahlung(ip + 1, heating_coefficient, vw_cube);
+
     LHS(ip, ip + 1) = - oneoverv2[ip] * collisional_coefficient
                       * (C_RB[ip + 1] * (1.0 - delta_CC[ip + 1])
                          + D_RB[ip + 1] / dvr[ip + 1]);
@@ -321,6 +318,8 @@ void self_f00_implicit_step::takestep(valarray<double>  &fin, valarray<double> &
 
 
     for (ip = 1; ip < fin.size() - 1; ++ip){
+        if (heating) D_RB[ip + 1] += D_inversebremsstrahlung(ip + 1, heating_coefficient, vw_cube);
+
         LHS(ip, ip + 1) = - oneoverv2[ip] * collisional_coefficient
                           * (C_RB[ip + 1] * (1.0 - delta_CC[ip + 1])
                              + D_RB[ip + 1] / dvr[ip + 1]);
@@ -378,19 +377,32 @@ self_f00_implicit_collisions::self_f00_implicit_collisions(
             IB_heating(Input::List().IB_heating),// MX_cooling(Input::List().MX_cooling),
             heatingprofile_1d(0.0,Input::List().NxLocal[0]),
             // coolingprofile_1d(0.0,Input::List().NxLocal[0]),
-            heatingprofile_2d(Input::List().NxLocal[0],Input::List().NxLocal[1])
+            heatingprofile_2d(Input::List().NxLocal[0],Input::List().NxLocal[1]),
             // coolingprofile_2d(Input::List().NxLocal[0],Input::List().NxLocal[1])
+            intensity_1d(0.0,Input::List().NxLocal[0]),
+            intensity_2d(Input::List().NxLocal[0],Input::List().NxLocal[1]),
+            vos_amplitude(Input::List().lambda_0 * sqrt(7.3e-19*Input::List().I_0)),
+            timecoeff_last(0.0), heating_built(false),
+            celltime_1d(0.0,Input::List().NxLocalnobnd[0]),
+            celltime_2d(Input::List().NxLocalnobnd[0],Input::List().NxLocalnobnd[1])
 {
     
     Nbc = Input::List().BoundaryCells;
     szx = Input::List().NxLocalnobnd[0];  // size of useful x axis
     szy = Input::List().NxLocalnobnd[1];  // size of useful y axis
+
+    /// The intensity profile does not depend on time
+    if (IB_heating && ib){
+        if (Input::List().dim == 1) Parser::parseprofile(xgrid, Input::List().intensity_profile_str, intensity_1d);
+        else                        Parser::parseprofile(xgrid, ygrid, Input::List().intensity_profile_str, intensity_2d);
+    }
 }
 //-------------------------------------------------------------------
 
 
 //-------------------------------------------------------------------
-void self_f00_implicit_collisions::loop(SHarmonic1D& f00, valarray<double>& Zarray, SHarmonic1D& f00h, const double time, const double step_size){
+void self_f00_implicit_collisions::loop(SHarmonic1D& f00, valarray<double>& Zarray, SHarmonic1D& f00h, const double time, const double step_size,
+                                       const size_t x0, const size_t x1){
 
     //-------------------------------------------------------------------
     //  This loop scans all the locations in configuration space
@@ -404,16 +416,22 @@ void self_f00_implicit_collisions::loop(SHarmonic1D& f00, valarray<double>& Zarr
 
         /// Get time and heating profile
         /// Ray-trace would go here
-        Parser::parseprofile(xgrid, Input::List().intensity_profile_str, heatingprofile_1d);
         Parser::parseprofile(time, Input::List().intensity_time_profile_str, timecoeff);
 
-        /// Make vos(x,t)
-        heatingprofile_1d *= (Input::List().lambda_0 * sqrt(7.3e-19*Input::List().I_0))*timecoeff;
-
+        /// Make vos(x,t), only when the time envelope has changed
+        if (!heating_built || timecoeff != timecoeff_last){
+            heatingprofile_1d = intensity_1d * (vos_amplitude*timecoeff);
+            timecoeff_last = timecoeff;
+            heating_built  = true;
+        }
     }
 
-    for (size_t ix(0); ix < szx; ++ix)
+    //  The interior cells of [x0,x1), counted from the first interior cell
+    const size_t ix0(std::min(std::max(x0,Nbc),szx+Nbc)-Nbc), ix1(std::max(std::min(x1,szx+Nbc),Nbc)-Nbc);
+
+    for (size_t ix(ix0); ix < ix1; ++ix)
     {
+        double started(omp_get_wtime());
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         // Copy data for a specific location in space to valarray
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -431,14 +449,15 @@ void self_f00_implicit_collisions::loop(SHarmonic1D& f00, valarray<double>& Zarr
             f00h(ip,ix+Nbc) = fout[ip];
             // std::cout << "fout[" << ip << "," << ix << "] = " << fout[ip] << "\n";
         }
-        
+        celltime_1d[ix] += omp_get_wtime() - started;
     }
     //-------------------------------------------------------------------
 
 }
 
 //-------------------------------------------------------------------
-void self_f00_implicit_collisions::loop(SHarmonic2D& f00, Array2D<double>& Zarray, SHarmonic2D& f00h, const double time, const double step_size){
+void self_f00_implicit_collisions::loop(SHarmonic2D& f00, Array2D<double>& Zarray, SHarmonic2D& f00h, const double time, const double step_size,
+                                       const size_t x0, const size_t x1, const size_t y0, const size_t y1){
 
     //-------------------------------------------------------------------
     //  This loop scans all the locations in configuration space
@@ -452,20 +471,25 @@ void self_f00_implicit_collisions::loop(SHarmonic2D& f00, Array2D<double>& Zarra
 
         /// Get time and heating profile
         /// Ray-trace would go here
-        /// 
-        
-        Parser::parseprofile(xgrid, ygrid, Input::List().intensity_profile_str, heatingprofile_2d);
         Parser::parseprofile(time, Input::List().intensity_time_profile_str, timecoeff);
 
-        /// Make vos(x,t)
-        heatingprofile_2d *= (Input::List().lambda_0 * sqrt(7.3e-19*Input::List().I_0))*timecoeff;
-
+        /// Make vos(x,t), only when the time envelope has changed
+        if (!heating_built || timecoeff != timecoeff_last){
+            heatingprofile_2d.array() = intensity_2d.array() * (vos_amplitude*timecoeff);
+            timecoeff_last = timecoeff;
+            heating_built  = true;
+        }
     }
 
-    for (size_t ix(0); ix < szx; ++ix)
+    //  The interior cells of [x0,x1) x [y0,y1), counted from the first interior cell
+    const size_t ix0(std::min(std::max(x0,Nbc),szx+Nbc)-Nbc), ix1(std::max(std::min(x1,szx+Nbc),Nbc)-Nbc);
+    const size_t iy0(std::min(std::max(y0,Nbc),szy+Nbc)-Nbc), iy1(std::max(std::min(y1,szy+Nbc),Nbc)-Nbc);
+
+    for (size_t ix(ix0); ix < ix1; ++ix)
     {
-        for (size_t iy(0); iy < szy; ++iy)
+        for (size_t iy(iy0); iy < iy1; ++iy)
         {
+            double started(omp_get_wtime());
             // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
             // Copy data for a specific location in space to valarray
             // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -485,6 +509,7 @@ void self_f00_implicit_collisions::loop(SHarmonic2D& f00, Array2D<double>& Zarra
                 f00h(ip,ix+Nbc,iy+Nbc) = fout[ip];
                 // std::cout << "fout[" << ip << "," << ix << "] = " << fout[ip] << "\n";
             }
+            celltime_2d(ix,iy) += omp_get_wtime() - started;
         }
         
     }
@@ -492,6 +517,16 @@ void self_f00_implicit_collisions::loop(SHarmonic2D& f00, Array2D<double>& Zarra
 
 }
 //-------------------------------------------------------------------
+void self_f00_implicit_collisions::celltime(valarray<double>& seconds){
+    seconds    += celltime_1d;
+    celltime_1d = 0.0;
+}
+//-------------------------------------------------------------------
+void self_f00_implicit_collisions::celltime(Array2D<double>& seconds){
+    seconds    += celltime_2d;
+    celltime_2d = 0.0;
+}
+//-------------------------------------------------------------------
 //-------------------------------------------------------------------
 /**
  * @brief      Constructor that needs a distribution function input.
@@ -734,7 +769,8 @@ self_f00_explicit_collisions::self_f00_explicit_collisions(const valarray<double
 
 
 //-------------------------------------------------------------------
-void self_f00_explicit_collisions::loop(SHarmonic1D& f00,SHarmonic1D& f00h, const double deltat){
+void self_f00_explicit_collisions::loop(SHarmonic1D& f00,SHarmonic1D& f00h, const double deltat,
+                                       const size_t x0, const size_t x1){
 
     //-------------------------------------------------------------------
     //  This loop scans all the locations in configuration space
@@ -745,8 +781,10 @@ void self_f00_explicit_collisions::loop(SHarmonic1D& f00,SHarmonic1D& f00h, cons
     num_h = size_t(deltat/Input::List().small_dt)+1;
     h = deltat/static_cast<double>(num_h);
 
+    //  The interior cells of [x0,x1), counted from the first interior cell
+    const size_t ix0(std::min(std::max(x0,Nbc),szx+Nbc)-Nbc), ix1(std::max(std::min(x1,szx+Nbc),Nbc)-Nbc);
 
-    for (size_t ix(0); ix < szx; ++ix){
+    for (size_t ix(ix0); ix < ix1; ++ix){
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
         // Copy data for a specific location in space to valarray
@@ -770,7 +808,8 @@ void self_f00_explicit_collisions::loop(SHarmonic1D& f00,SHarmonic1D& f00h, cons
 }
 //-------------------------------------------------------------------
 //-------------------------------------------------------------------
-void self_f00_explicit_collisions::loop(SHarmonic2D& f00,SHarmonic2D& f00h, const double deltat){
+void self_f00_explicit_collisions::loop(SHarmonic2D& f00,SHarmonic2D& f00h, const double deltat,
+                                       const size_t x0, const size_t x1, const size_t y0, const size_t y1){
 
     //-------------------------------------------------------------------
     //  This loop scans all the locations in configuration space
@@ -781,9 +820,13 @@ void self_f00_explicit_collisions::loop(SHarmonic2D& f00,SHarmonic2D& f00h, cons
     num_h = size_t(deltat/Input::List().small_dt)+1;
     h = deltat/static_cast<double>(num_h);
 
-    for (size_t ix(0); ix < szx; ++ix)
+    //  The interior cells of [x0,x1) x [y0,y1), counted from the first interior cell
+    const size_t ix0(std::min(std::max(x0,Nbc),szx+Nbc)-Nbc), ix1(std::max(std::min(x1,szx+Nbc),Nbc)-Nbc);
+    const size_t iy0(std::min(std::max(y0,Nbc),szy+Nbc)-Nbc), iy1(std::max(std::min(y1,szy+Nbc),Nbc)-Nbc);
+
+    for (size_t ix(ix0); ix < ix1; ++ix)
     {
-        for (size_t iy(0); iy < szy; ++iy)
+        for (size_t iy(iy0); iy < iy1; ++iy)
         {
             // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
             // Copy data for a specific location in space to valarray
@@ -1176,7 +1219,22 @@ self_flm_implicit_collisions::self_flm_implicit_collisions(const size_t _l0, con
 }
 //-------------------------------------------------------------------
 //-------------------------------------------------------------------
-void self_flm_implicit_collisions::advanceflm(DistFunc1D& DF, valarray<double>& Zarray, DistFunc1D& DFh)
+void self_flm_implicit_collisions::kept_harmonics(const Array2D<int>& ind, vector<size_t>& ls, vector<size_t>& ms) const
+{
+    for(size_t l = 2; l < l0+1 ; ++l)
+    {
+        for(size_t m = 0; m < ((m0 < l)? m0:l)+1; ++m)
+        {
+            if (!Harmonic_Group::Keeps(l0, m0, size_t(ind(l,m)))) continue;
+            ls.push_back(l);
+            ms.push_back(m);
+        }
+    }
+}
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+void self_flm_implicit_collisions::advanceflm(DistFunc1D& DF, valarray<double>& Zarray, DistFunc1D& DFh,
+                                              const size_t x0, const size_t x1)
 {
 //-------------------------------------------------------------------
 //  This is the calculation for the high order harmonics 
@@ -1203,28 +1261,31 @@ void self_flm_implicit_collisions::advanceflm(DistFunc1D& DF, valarray<double>&
     }*/
     
     // ************************* //
+    //  The interior cells of [x0,x1), counted from the first interior cell
+    const size_t ix0(std::min(std::max(x0,Nbc),szx-Nbc)-Nbc), ix1(std::max(std::min(x1,szx-Nbc),Nbc)-Nbc);
+    //  In a harmonic group each member collides the harmonics it keeps
+    vector<size_t> ls, ms;
+    kept_harmonics(DF.indx(), ls, ms);
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
     // Loop over the harmonics for this (x,y)
     #pragma omp parallel for collapse(2) schedule(static) num_threads(Input::List().ompthreads)
-    for (size_t ix = 0; ix < szx - 2*Nbc; ++ix)
+    for (size_t ix = ix0; ix < ix1; ++ix)
     {           
-        for(size_t l = 2; l < l0+1 ; ++l)
+        for(size_t k = 0; k < ls.size(); ++k)
         {
-            for(size_t m = 0; m < ((m0 < l)? m0:l)+1; ++m)
-            {
+            size_t l(ls[k]), m(ms[k]);
 
-                valarray<complex<double> > fc(0.,DF(0,0).nump());
-                // This harmonic --> Valarray
-                for (size_t ip(0); ip < fc.size(); ++ip){
-                    fc[ip] = (DF(l,m))(ip,ix+Nbc);
-                }
-                
-                // Take an implicit step
-                implicit_step.advance(fc, l, ix + Nbc);
-                //  Valarray --> This harmonic
-                for (size_t ip(0); ip < fc.size(); ++ip){
-                    DFh(l,m)(ip,ix+Nbc) = fc[ip];
-                }
+            valarray<complex<double> > fc(0.,DF(0,0).nump());
+            // This harmonic --> Valarray
+            for (size_t ip(0); ip < fc.size(); ++ip){
+                fc[ip] = (DF(l,m))(ip,ix+Nbc);
+            }
+            
+            // Take an implicit step
+            implicit_step.advance(fc, l, ix + Nbc);
+            //  Valarray --> This harmonic
+            for (size_t ip(0); ip < fc.size(); ++ip){
+                DFh(l,m)(ip,ix+Nbc) = fc[ip];
             }
         }
     }
@@ -1232,7 +1293,8 @@ void self_flm_implicit_collisions::advanceflm(DistFunc1D& DF, valarray<double>&
 }
 //-------------------------------------------------------------------
 //-------------------------------------------------------------------
-void self_flm_implicit_collisions::advancef1(DistFunc1D& DF, valarray<double>& Zarray, DistFunc1D& DFh, double step_size){
+void self_flm_implicit_collisions::advancef1(DistFunc1D& DF, valarray<double>& Zarray, DistFunc1D& DFh, double step_size,
+                                             const size_t x0, const size_t x1){
 //-------------------------------------------------------------------
 //  This is the collision calculation for the harmonics f10, f11 
 //-------------------------------------------------------------------
@@ -1240,50 +1302,57 @@ void self_flm_implicit_collisions::advancef1(DistFunc1D& DF, valarray<double>& Z
 // For every location in space within the domain of this node
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -          
     // Need advance f1 over whole domain for implicit E solver
-    #pragma omp parallel for num_threads(Input::List().ompthreads)
-    for (size_t ix = 0; ix < szx; ++ix)
+    const size_t fx1(std::min(x1,szx)), fx0(std::min(x0,fx1));
+    //  One team for both sweeps; the coefficients are complete at the
+    //  implicit barrier of the first loop
+    #pragma omp parallel num_threads(Input::List().ompthreads)
     {
+        #pragma omp for
+        for (size_t ix = fx0; ix < fx1; ++ix)
+        {
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -      
-        // "00" harmonic --> Valarray
-        valarray<double> f00(0.,DF(0,0).nump());
-        for (size_t ip(0); ip < f00.size(); ++ip){
-            f00[ip] = (DF(0,0)(ip,ix)).real();
-        }
-        // Reset the integrals and coefficients
-        implicit_step.reset_coeff(f00, Zarray[ix], step_size, ix);
+            // "00" harmonic --> Valarray
+            valarray<double> f00(0.,DF(0,0).nump());
+            for (size_t ip(0); ip < f00.size(); ++ip){
+                f00[ip] = (DF(0,0)(ip,ix)).real();
+            }
+            // Reset the integrals and coefficients
+            implicit_step.reset_coeff(f00, Zarray[ix], step_size, ix);
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -      
-    }
+        }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -      
-    #pragma omp parallel for num_threads(Input::List().ompthreads)
-    for (size_t ix = 0; ix < szx; ++ix)
-    {
-        // Loop over the harmonics for this (x,y)
-        for(size_t m = 0; m < f1_m_upperlimit; ++m)
+        #pragma omp for
+        for (size_t ix = fx0; ix < fx1; ++ix)
         {
-            valarray<complex<double> > fc(0.,DF(0,0).nump());
-            // This harmonic --> Valarray
-            for (size_t ip(0); ip < DF(1,m).nump(); ++ip) {
-                fc[ip] = DF(1,m)(ip,ix);
-            }
+            // Loop over the harmonics for this (x,y)
+            for(size_t m = 0; m < f1_m_upperlimit; ++m)
+            {
+                valarray<complex<double> > fc(0.,DF(0,0).nump());
+                // This harmonic --> Valarray
+                for (size_t ip(0); ip < DF(1,m).nump(); ++ip) {
+                    fc[ip] = DF(1,m)(ip,ix);
+                }
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -      
-            // Take an implicit step
-            implicit_step.advance(fc, 1, ix);
+                // Take an implicit step
+                implicit_step.advance(fc, 1, ix);
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -      
 
-            //  Valarray --> This harmonic
-            for (size_t ip(0); ip < DF(1,m).nump(); ++ip) {
-                DFh(1,m)(ip,ix) = fc[ip];
+                //  Valarray --> This harmonic
+                for (size_t ip(0); ip < DF(1,m).nump(); ++ip) {
+                    DFh(1,m)(ip,ix) = fc[ip];
+                }
             }
-        }
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -  
+        }
     }
 }
 //-------------------------------------------------------------------
 
 //-------------------------------------------------------------------
 //-------------------------------------------------------------------
-void self_flm_implicit_collisions::advancef1(DistFunc2D& DF, Array2D<double>& Zarray, DistFunc2D& DFh, const double step_size){
+void self_flm_implicit_collisions::advancef1(DistFunc2D& DF, Array2D<double>& Zarray, DistFunc2D& DFh, const double step_size,
+                                             const size_t x0, const size_t x1, const size_t y0, const size_t y1){
 //-------------------------------------------------------------------
 //  This is the collision calculation for the harmonics f10, f11 
 //-------------------------------------------------------------------
@@ -1291,55 +1360,63 @@ void self_flm_implicit_collisions::advancef1(DistFunc2D& DF, Array2D<double>& Za
 // For every location in space within the domain of this node
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -          
     // Need advance f1 over whole domain for implicit E solver
-    #pragma omp parallel for collapse(2) num_threads(Input::List().ompthreads)
-    for (size_t ix = 0; ix < szx; ++ix)
+    const size_t fx1(std::min(x1,szx)), fx0(std::min(x0,fx1));
+    const size_t fy1(std::min(y1,szy)), fy0(std::min(y0,fy1));
+    //  One team for both sweeps; the coefficients are complete at the
+    //  implicit barrier of the first loop
+    #pragma omp parallel num_threads(Input::List().ompthreads)
     {
-        for (size_t iy = 0; iy < szy; ++iy)
+        #pragma omp for collapse(2)
+        for (size_t ix = fx0; ix < fx1; ++ix)
         {
+            for (size_t iy = fy0; iy < fy1; ++iy)
+            {
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -      
-            // "00" harmonic --> Valarray
-            valarray<double> f00(0.,DF(0,0).nump());
-            for (size_t ip(0); ip < f00.size(); ++ip){
-                f00[ip] = (DF(0,0)(ip,ix,iy)).real();
+                // "00" harmonic --> Valarray
+                valarray<double> f00(0.,DF(0,0).nump());
+                for (size_t ip(0); ip < f00.size(); ++ip){
+                    f00[ip] = (DF(0,0)(ip,ix,iy)).real();
+                }
+                // Reset the integrals and coefficients
+                implicit_step.reset_coeff(f00, Zarray(ix,iy), step_size, ix*szy+iy);
             }
-            // Reset the integrals and coefficients
-            implicit_step.reset_coeff(f00, Zarray(ix,iy), step_size, ix*szy+iy);
-        }
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -      
-    }
+        }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -      
-    #pragma omp parallel for collapse(2) num_threads(Input::List().ompthreads)
-    for (size_t ix = 0; ix < szx; ++ix)
-    {
-        for (size_t iy = 0; iy < szy; ++iy)
+        #pragma omp for collapse(2)
+        for (size_t ix = fx0; ix < fx1; ++ix)
         {
-            // Loop over the harmonics for this (x,y)
-            for(size_t m = 0; m < f1_m_upperlimit; ++m)
+            for (size_t iy = fy0; iy < fy1; ++iy)
             {
-                valarray<complex<double> > fc(0.,DF(0,0).nump());
-                // This harmonic --> Valarray
-                for (size_t ip(0); ip < DF(1,m).nump(); ++ip) {
-                    fc[ip] = DF(1,m)(ip,ix,iy);
-                }
-    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -      
-                // Take an implicit step
-                implicit_step.advance(fc, 1, ix*szy+iy);
-    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -      
+                // Loop over the harmonics for this (x,y)
+                for(size_t m = 0; m < f1_m_upperlimit; ++m)
+                {
+                    valarray<complex<double> > fc(0.,DF(0,0).nump());
+                    // This harmonic --> Valarray
+                    for (size_t ip(0); ip < DF(1,m).nump(); ++ip) {
+                        fc[ip] = DF(1,m)(ip,ix,iy);
+                    }
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -      
+                    // Take an implicit step
+                    implicit_step.advance(fc, 1, ix*szy+iy);
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -      
 
-                //  Valarray --> This harmonic
-                for (size_t ip(0); ip < DF(1,m).nump(); ++ip) {
-                    DFh(1,m)(ip,ix,iy) = fc[ip];
+                    //  Valarray --> This harmonic
+                    for (size_t ip(0); ip < DF(1,m).nump(); ++ip) {
+                        DFh(1,m)(ip,ix,iy) = fc[ip];
+                    }
                 }
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -  
             }
-    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -  
         }
     }
 }
 //-------------------------------------------------------------------
 
 //-------------------------------------------------------------------
-void self_flm_implicit_collisions::advanceflm(DistFunc2D& DF, Array2D<double>& Zarray, DistFunc2D& DFh)
+void self_flm_implicit_collisions::advanceflm(DistFunc2D& DF, Array2D<double>& Zarray, DistFunc2D& DFh,
+                                              const size_t x0, const size_t x1, const size_t y0, const size_t y1)
 {
 //-------------------------------------------------------------------
 //  This is the calculation for the high order harmonics 
@@ -1347,30 +1424,35 @@ void self_flm_implicit_collisions::advanceflm(DistFunc2D& DF, Array2D<double>& Z
 //-------------------------------------------------------------------
 
     // ********************************************** //
+    //  The interior cells of [x0,x1) x [y0,y1), counted from the first interior cell
+    const size_t ix0(std::min(std::max(x0,Nbc),szx-Nbc)-Nbc), ix1(std::max(std::min(x1,szx-Nbc),Nbc)-Nbc);
+    const size_t iy0(std::min(std::max(y0,Nbc),szy-Nbc)-Nbc), iy1(std::max(std::min(y1,szy-Nbc),Nbc)-Nbc);
+    //  In a harmonic group each member collides the harmonics it keeps
+    vector<size_t> ls, ms;
+    kept_harmonics(DF.indx(), ls, ms);
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
     // Loop over the harmonics for this (x,y)
     #pragma omp parallel for collapse(3) schedule(static) num_threads(Input::List().ompthreads)
-    for (size_t ix = 0; ix < szx - 2*Nbc; ++ix)
+    for (size_t ix = ix0; ix < ix1; ++ix)
     {
-        for (size_t iy = 0; iy < szy - 2*Nbc; ++iy)
+        for (size_t iy = iy0; iy < iy1; ++iy)
         {
-            for(size_t l = 2; l < l0+1 ; ++l)
+            for(size_t k = 0; k < ls.size(); ++k)
             {
-                for(size_t m = 0; m < ((m0 < l)? m0:l)+1; ++m)
-                {       
-                    valarray<complex<double> > fc(0.,DF(0,0).nump());
-                    // This harmonic --> Valarray
-                    for (size_t ip(0); ip < fc.size(); ++ip){
-                        fc[ip] = (DF(l,m))(ip,ix+Nbc,iy+Nbc);
-                    }
+                size_t l(ls[k]), m(ms[k]);
 
-                    // Take an implicit step
-                    implicit_step.advance(fc, l, (ix+Nbc)*szy+(iy+Nbc));
+                valarray<complex<double> > fc(0.,DF(0,0).nump());
+                // This harmonic --> Valarray
+                for (size_t ip(0); ip < fc.size(); ++ip){
+                    fc[ip] = (DF(l,m))(ip,ix+Nbc,iy+Nbc);
+                }
 
-                    //  Valarray --> This harmonic
-                    for (size_t ip(0); ip < fc.size(); ++ip){
-                        DFh(l,m)(ip,ix+Nbc,iy+Nbc) = fc[ip];
-                    }
+                // Take an implicit step
+                implicit_step.advance(fc, l, (ix+Nbc)*szy+(iy+Nbc));
+
+                //  Valarray --> This harmonic
+                for (size_t ip(0); ip < fc.size(); ++ip){
+                    DFh(l,m)(ip,ix+Nbc,iy+Nbc) = fc[ip];
                 }
             }
         }
@@ -1391,49 +1473,67 @@ self_collisions::self_collisions(const size_t _l0, const size_t _m0,
 //-------------------------------------------------------------------
 
 //-------------------------------------------------------------------
-void self_collisions::advancef00(SHarmonic1D& f00, valarray<double>& Zarray,SHarmonic1D& f00h,  const double time, const double step_size)
+void self_collisions::advancef00(SHarmonic1D& f00, valarray<double>& Zarray,SHarmonic1D& f00h,  const double time, const double step_size,
+                                 const size_t x0, const size_t x1)
 //-------------------------------------------------------------------
 {    
-    if (Input::List().f00_implicitorexplicit == 2) self_f00_imp_collisions.loop(f00,Zarray,f00h,time,step_size);
-    else self_f00_exp_collisions.loop(f00,f00h,step_size);
+    if (Input::List().f00_implicitorexplicit == 2) self_f00_imp_collisions.loop(f00,Zarray,f00h,time,step_size,x0,x1);
+    else self_f00_exp_collisions.loop(f00,f00h,step_size,x0,x1);
     
 }
 //-------------------------------------------------------------------
 //-------------------------------------------------------------------
-void self_collisions::advanceflm(DistFunc1D& DFin, valarray<double>& Zarray, DistFunc1D& DFh)
+void self_collisions::advanceflm(DistFunc1D& DFin, valarray<double>& Zarray, DistFunc1D& DFh,
+                                 const size_t x0, const size_t x1)
 //-------------------------------------------------------------------
 {
-    self_flm_imp_collisions.advanceflm(DFin,Zarray,DFh);
+    self_flm_imp_collisions.advanceflm(DFin,Zarray,DFh,x0,x1);
 }
 
 //-------------------------------------------------------------------
 //-------------------------------------------------------------------
-void self_collisions::advancef1(DistFunc1D& DFin,  valarray<double>& Zarray, DistFunc1D& DFh, const double step_size)
+void self_collisions::advancef1(DistFunc1D& DFin,  valarray<double>& Zarray, DistFunc1D& DFh, const double step_size,
+                                const size_t x0, const size_t x1)
 //-------------------------------------------------------------------
 {    
-    self_flm_imp_collisions.advancef1(DFin,Zarray,DFh,step_size);
+    self_flm_imp_collisions.advancef1(DFin,Zarray,DFh,step_size,x0,x1);
 }
 //-------------------------------------------------------------------
-void self_collisions::advancef00(SHarmonic2D& f00, Array2D<double>& Zarray, SHarmonic2D& f00h, const double time, const double step_size)
+void self_collisions::advancef00(SHarmonic2D& f00, Array2D<double>& Zarray, SHarmonic2D& f00h, const double time, const double step_size,
+                                 const size_t x0, const size_t x1, const size_t y0, const size_t y1)
 //-------------------------------------------------------------------
 {    
-    if (Input::List().f00_implicitorexplicit == 2) self_f00_imp_collisions.loop(f00,Zarray,f00h,time,step_size);
-    else self_f00_exp_collisions.loop(f00,f00h,step_size);
+    if (Input::List().f00_implicitorexplicit == 2) self_f00_imp_collisions.loop(f00,Zarray,f00h,time,step_size,x0,x1,y0,y1);
+    else self_f00_exp_collisions.loop(f00,f00h,step_size,x0,x1,y0,y1);
     
 }
 //-------------------------------------------------------------------
 //-------------------------------------------------------------------
-void self_collisions::advanceflm(DistFunc2D& DFin, Array2D<double>& Zarray, DistFunc2D& DFh)
+void self_collisions::advanceflm(DistFunc2D& DFin, Array2D<double>& Zarray, DistFunc2D& DFh,
+                                 const size_t x0, const size_t x1, const size_t y0, const size_t y1)
 //-------------------------------------------------------------------
 {
-    self_flm_imp_collisions.advanceflm(DFin,Zarray,DFh);
+    self_flm_imp_collisions.advanceflm(DFin,Zarray,DFh,x0,x1,y0,y1);
 }
 
 //-------------------------------------------------------------------
-void self_collisions::advancef1(DistFunc2D& DFin,  Array2D<double>& Zarray, DistFunc2D& DFh, const double step_size)
+void self_collisions::advancef1(DistFunc2D& DFin,  Array2D<double>& Zarray, DistFunc2D& DFh, const double step_size,
+                                const size_t x0, const size_t x1, const size_t y0, const size_t y1)
 //-------------------------------------------------------------------
 {    
-    self_flm_imp_collisions.advancef1(DFin,Zarray,DFh, step_size);
+    self_flm_imp_collisions.advancef1(DFin,Zarray,DFh, step_size,x0,x1,y0,y1);
+}
+//-------------------------------------------------------------------
+void self_collisions::celltime(valarray<double>& seconds)
+//-------------------------------------------------------------------
+{
+    self_f00_imp_collisions.celltime(seconds);
+}
+//-------------------------------------------------------------------
+void self_collisions::celltime(Array2D<double>& seconds)
+//-------------------------------------------------------------------
+{
+    self_f00_imp_collisions.celltime(seconds);
 }
 ////*******************************************************************
 
@@ -1470,7 +1570,7 @@ void collisions_1D::advanceflm(State1D& Yin, State1D& Yh)
     {
         if (Yin.DF(s).l0() > 1)
         {
-            self_coll[s].advanceflm(Yin.DF(s), Yin.HYDRO().Zarray(), Yh.DF(s) );    
+            self_coll[s].advanceflm(Yin.DF(s), Yin.HYDRO().Zarray(), Yh.DF(s), 0, Yin.DF(s)(0,0).numx() );    
         }
         if (Yin.Species() > 1)
         {
@@ -1494,25 +1594,68 @@ void collisions_1D::advanceflm(State1D& Yin, State1D& Yh)
 void collisions_1D::advance(State1D& Yin, double current_time, double step_size)
 //-------------------------------------------------------------------
 {
-    // Yh = complex<double>(0.0,0.0);
-    
-    if (Input::List().f00_implicitorexplicit)
-    {
-        advancef0(Yin,Yh,current_time,step_size);    
-    }
+    advance(Yin,current_time,step_size,0,Yin.DF(0)(0,0).numx());
+}
+//-------------------------------------------------------------------
+void collisions_1D::advance_boundary(State1D& Yin, const double current_time, const double step_size)
+//-------------------------------------------------------------------
+{
+    size_t x0, x1;
+    inner(Yin,x0,x1);
+
+    advance(Yin,current_time,step_size,0,x0);
+    advance(Yin,current_time,step_size,x1,Yin.DF(0)(0,0).numx());
+}
+//-------------------------------------------------------------------
+void collisions_1D::advance_interior(State1D& Yin, const double current_time, const double step_size)
+//-------------------------------------------------------------------
+{
+    size_t x0, x1;
+    inner(Yin,x0,x1);
+
+    advance(Yin,current_time,step_size,x0,x1);
+}
+//-------------------------------------------------------------------
+void collisions_1D::inner(const State1D& Yin, size_t& x0, size_t& x1) const
+//-------------------------------------------------------------------
+{
+    //  The exchange reads the Nbc cells next to the guard cells
+    size_t Nbc(Input::List().BoundaryCells), Nx(Yin.DF(0)(0,0).numx());
+
+    x0 = std::min(2*Nbc,Nx/2);
+    x1 = std::max(Nx-2*Nbc,x0);
+}
+//-------------------------------------------------------------------
+void collisions_1D::advance(State1D& Yin, const double current_time, const double step_size, 
+                            const size_t x0, const size_t x1)
+//-------------------------------------------------------------------
+{
+    if (x1 <= x0) return;
+
+    for(size_t s(0); s < Yin.Species(); ++s)
+    {   
+        if (Input::List().f00_implicitorexplicit)
+        {
+            self_coll[s].advancef00(Yin.DF(s)(0,0),Yin.HYDRO().Zarray(),Yh.DF(s)(0,0),current_time,step_size,x0,x1);
+        }
     
-    if (Input::List().flm_collisions )
-    {
-        advancef1(Yin,Yh,step_size);
-        advanceflm(Yin,Yh);
+        if (Input::List().flm_collisions )
+        {
+            self_coll[s].advancef1(Yin.DF(s), Yin.HYDRO().Zarray(), Yh.DF(s), step_size, x0, x1);
+            if (Yin.DF(s).l0() > 1) self_coll[s].advanceflm(Yin.DF(s), Yin.HYDRO().Zarray(), Yh.DF(s), x0, x1);
+        }
     }
 
+    //  Only the cells of this part, the rest may still be read
     for (size_t s(0); s < Yin.Species(); ++s){
         for (size_t i(0); i < Yin.DF(s).dim(); ++i){
-            Yin.DF(s)(i) = Yh.DF(s)(i);
+            for (size_t ix(x0); ix < x1; ++ix){
+                for (size_t ip(0); ip < Yin.DF(s)(i).nump(); ++ip){
+                    Yin.DF(s)(i)(ip,ix) = Yh.DF(s)(i)(ip,ix);
+                }
+            }
         }
     }
-    
 }
 //-------------------------------------------------------------------
 void collisions_1D::advancef0(State1D& Yin, State1D& Yh, double current_time, double step_size)
@@ -1523,7 +1666,8 @@ void collisions_1D::advancef0(State1D& Yin, State1D& Yh, double current_time, do
 
     for(size_t s(0); s < Yin.Species(); ++s)
     {   
-        self_coll[s].advancef00(Yin.DF(s)(0,0),Yin.HYDRO().Zarray(),Yh.DF(s)(0,0),current_time,step_size);
+        self_coll[s].advancef00(Yin.DF(s)(0,0),Yin.HYDRO().Zarray(),Yh.DF(s)(0,0),current_time,step_size,
+                                0, Yin.DF(s)(0,0).numx());
     
         if (Yin.Species() > 1)
         {
@@ -1554,7 +1698,7 @@ void collisions_1D::advancef1(State1D& Yin, State1D& Yh, double step_size)
 
     for(size_t s(0); s < Yin.Species(); ++s)
     {
-        self_coll[s].advancef1(Yin.DF(s), Yin.HYDRO().Zarray(), Yh.DF(s) , step_size );
+        self_coll[s].advancef1(Yin.DF(s), Yin.HYDRO().Zarray(), Yh.DF(s) , step_size, 0, Yin.DF(s)(0,0).numx() );
 
         if (Yin.Species() > 1)
         {
@@ -1576,6 +1720,12 @@ vector<self_collisions> collisions_1D::self(){
 
     return self_coll;
 
+}
+//-------------------------------------------------------------------
+void collisions_1D::celltime(valarray<double>& seconds){
+
+    for(size_t s(0); s < self_coll.size(); ++s) self_coll[s].celltime(seconds);
+
 }
 
 //-------------------------------------------------------------------
@@ -1605,27 +1755,80 @@ collisions_2D::collisions_2D(const State2D& Yin):Yh(Yin)
 void collisions_2D::advance(State2D& Yin, const double time, const double step_size)
 //-------------------------------------------------------------------
 {
-    // Yh = complex<double>(0.0,0.0);
-    
-    if (Input::List().f00_implicitorexplicit)
-    {
-        advancef0(Yin,Yh,time,step_size);    
-    }
+    advance(Yin,time,step_size,0,Yin.DF(0)(0,0).numx(),0,Yin.DF(0)(0,0).numy());
+}
+//-------------------------------------------------------------------
+void collisions_2D::advance_boundary(State2D& Yin, const double time, const double step_size)
+//-------------------------------------------------------------------
+{
+    size_t x0, x1, y0, y1;
+    size_t Nx(Yin.DF(0)(0,0).numx()), Ny(Yin.DF(0)(0,0).numy());
+    inner(Yin,x0,x1,y0,y1);
+
+    //  The frame: bottom and top rows over the full width, then the
+    //  left and right columns in between
+    advance(Yin,time,step_size,0,Nx,0,y0);
+    advance(Yin,time,step_size,0,Nx,y1,Ny);
+    advance(Yin,time,step_size,0,x0,y0,y1);
+    advance(Yin,time,step_size,x1,Nx,y0,y1);
+}
+//-------------------------------------------------------------------
+void collisions_2D::advance_interior(State2D& Yin, const double time, const double step_size)
+//-------------------------------------------------------------------
+{
+    size_t x0, x1, y0, y1;
+    inner(Yin,x0,x1,y0,y1);
+
+    advance(Yin,time,step_size,x0,x1,y0,y1);
+}
+//-------------------------------------------------------------------
+void collisions_2D::inner(const State2D& Yin, size_t& x0, size_t& x1, size_t& y0, size_t& y1) const
+//-------------------------------------------------------------------
+{
+    //  The exchange reads the Nbc cells next to the guard cells
+    size_t Nbc(Input::List().BoundaryCells);
+    size_t Nx(Yin.DF(0)(0,0).numx()), Ny(Yin.DF(0)(0,0).numy());
+
+    x0 = std::min(2*Nbc,Nx/2);
+    x1 = std::max(Nx-2*Nbc,x0);
+    y0 = std::min(2*Nbc,Ny/2);
+    y1 = std::max(Ny-2*Nbc,y0);
+}
+//-------------------------------------------------------------------
+void collisions_2D::advance(State2D& Yin, const double time, const double step_size, 
+                            const size_t x0, const size_t x1, const size_t y0, const size_t y1)
+//-------------------------------------------------------------------
+{
+    if (x1 <= x0 || y1 <= y0) return;
+
+    for(size_t s(0); s < Yin.Species(); ++s)
+    {   
+        if (Input::List().f00_implicitorexplicit)
+        {
+            self_coll[s].advancef00(Yin.DF(s)(0,0),Yin.HYDRO().Zarray(),Yh.DF(s)(0,0),time,step_size,x0,x1,y0,y1);
+        }
     
-    if (Input::List().flm_collisions )
-    {
-        advancef1(Yin,Yh,step_size);
-        advanceflm(Yin,Yh);
+        if (Input::List().flm_collisions )
+        {
+            self_coll[s].advancef1(Yin.DF(s), Yin.HYDRO().Zarray(), Yh.DF(s), step_size, x0, x1, y0, y1);
+            if (Yin.DF(s).l0() > 1) self_coll[s].advanceflm(Yin.DF(s), Yin.HYDRO().Zarray(), Yh.DF(s), x0, x1, y0, y1);
+        }
     }
     
     // if (Input::List().filterdistribution) Yh.DF(s) = Yh.DF(s).Filterp();
 
+    //  Only the cells of this part, the rest may still be read
     for (size_t s(0); s < Yin.Species(); ++s){
         for (size_t i(0); i < Yin.DF(s).dim(); ++i){
-            Yin.DF(s)(i) = Yh.DF(s)(i);
+            for (size_t iy(y0); iy < y1; ++iy){
+                for (size_t ix(x0); ix < x1; ++ix){
+                    for (size_t ip(0); ip < Yin.DF(s)(i).nump(); ++ip){
+                        Yin.DF(s)(i)(ip,ix,iy) = Yh.DF(s)(i)(ip,ix,iy);
+                    }
+                }
+            }
         }
     }
-    
 }
 //-------------------------------------------------------------------
 void collisions_2D::advancef0(State2D& Yin, State2D& Yh, const double time, const double step_size)
@@ -1636,7 +1839,8 @@ void collisions_2D::advancef0(State2D& Yin, State2D& Yh, const double time, cons
 
     for(size_t s(0); s < Yin.Species(); ++s)
     {   
-        self_coll[s].advancef00(Yin.DF(s)(0,0),Yin.HYDRO().Zarray(),Yh.DF(s)(0,0),time,step_size);
+        self_coll[s].advancef00(Yin.DF(s)(0,0),Yin.HYDRO().Zarray(),Yh.DF(s)(0,0),time,step_size,
+                                0, Yin.DF(s)(0,0).numx(), 0, Yin.DF(s)(0,0).numy());
     
         if (Yin.Species() > 1)
         {
@@ -1667,7 +1871,8 @@ void collisions_2D::advancef1(State2D& Yin, State2D& Yh, const double step_size)
 
     for(size_t s(0); s < Yin.Species(); ++s)
     {
-        self_coll[s].advancef1(Yin.DF(s), Yin.HYDRO().Zarray(), Yh.DF(s), step_size );
+        self_coll[s].advancef1(Yin.DF(s), Yin.HYDRO().Zarray(), Yh.DF(s), step_size,
+                               0, Yin.DF(s)(0,0).numx(), 0, Yin.DF(s)(0,0).numy() );
 
         if (Yin.Species() > 1)
         {
@@ -1695,7 +1900,8 @@ void collisions_2D::advanceflm(State2D& Yin, State2D& Yh)
 
         if (Yin.DF(s).l0()>1)
         {
-            self_coll[s].advanceflm(Yin.DF(s), Yin.HYDRO().Zarray(), Yh.DF(s) );
+            self_coll[s].advanceflm(Yin.DF(s), Yin.HYDRO().Zarray(), Yh.DF(s),
+                                    0, Yin.DF(s)(0,0).numx(), 0, Yin.DF(s)(0,0).numy() );
         }
 
         if (Yin.Species() > 1)
@@ -1723,5 +1929,11 @@ vector<self_collisions> collisions_2D::self(){
 
     return self_coll;
 
+}
+//-------------------------------------------------------------------
+void collisions_2D::celltime(Array2D<double>& seconds){
+
+    for(size_t s(0); s < self_coll.size(); ++s) self_coll[s].celltime(seconds);
+
 }
 //*******************************************************************
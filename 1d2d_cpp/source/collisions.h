@@ -50,7 +50,7 @@ private:
     void   update_C_Rosenbluth(valarray<double>& fin);
     double update_D_Rosenbluth(const size_t& k, valarray<double>& fin, const double& delta);
     void   update_D_and_delta(valarray<double>& fin);
-    void   update_D_inversebremsstrahlung(const double& Z0, const double& heatingcoefficient, const double& vos);
+    double D_inversebremsstrahlung(const size_t& ip, const double& heating_coefficient, const double& vw_cube);
     double calc_delta_ChangCooper(const size_t& k, const double& C, const double& D);
 
 public:
@@ -79,9 +79,16 @@ public:
 
     /// This loop calls the RK4_f00 private member that is
     /// responsible for setting up the RK4 algorithm to advance
-    /// the collision step.
-    void loop(SHarmonic1D& SHin, valarray<double>& Zarray, SHarmonic1D& SHout, const double time, const double step_size);
-    void loop(SHarmonic2D& SHin, Array2D<double>& Zarray, SHarmonic2D& SHout, const double time, const double step_size);
+    /// the collision step. Only the interior cells within 
+    /// [x0,x1) x [y0,y1) of the local grid are advanced
+    void loop(SHarmonic1D& SHin, valarray<double>& Zarray, SHarmonic1D& SHout, const double time, const double step_size,
+              const size_t x0, const size_t x1);
+    void loop(SHarmonic2D& SHin, Array2D<double>& Zarray, SHarmonic2D& SHout, const double time, const double step_size,
+              const size_t x0, const size_t x1, const size_t y0, const size_t y1);
+
+    /// Adds the seconds spent on each interior cell since the last call
+    void celltime(valarray<double>& seconds);
+    void celltime(Array2D<double>& seconds);
 
 private:
     //  Variables
@@ -100,6 +107,18 @@ private:
     Array2D<double>            heatingprofile_2d;
     // Array2D<double>            coolingprofile_2d;
 
+    ///     Intensity profile, parsed once, and the time envelope vos(x,t) was last built for
+    valarray<double>            intensity_1d;
+    Array2D<double>             intensity_2d;
+    double                      vos_amplitude;
+    double                      timecoeff_last;
+    bool                        heating_built;
+
+    ///     Time of each interior cell, the Rosenbluth iterations converge 
+    ///     at different rates in hot and cold cells
+    valarray<double>            celltime_1d;
+    Array2D<double>             celltime_2d;
+
 
     size_t                         Nbc; ///< Number of boundary cells in each direction
     size_t                         szx,szy; ///< Total cells including boundary cells in x-direction
@@ -188,9 +207,12 @@ class self_f00_explicit_step {
 
         /// This loop calls the RK4_f00 private member that is
         /// responsible for setting up the RK4 algorithm to advance
-        /// the collision step. 
-            void loop(SHarmonic1D& SHin, SHarmonic1D& SHout, const double step_size);
-            void loop(SHarmonic2D& SHin, SHarmonic2D& SHout, const double step_size);
+        /// the collision step. Only the interior cells within 
+        /// [x0,x1) x [y0,y1) of the local grid are advanced
+            void loop(SHarmonic1D& SHin, SHarmonic1D& SHout, const double step_size,
+                      const size_t x0, const size_t x1);
+            void loop(SHarmonic2D& SHin, SHarmonic2D& SHout, const double step_size,
+                      const size_t x0, const size_t x1, const size_t y0, const size_t y1);
 
         private:
         //  Variables
@@ -291,11 +313,17 @@ class self_f00_explicit_step {
             self_flm_implicit_collisions(const size_t _l0, const size_t _m0,
                              const valarray<double>& dp); 
 
-            void advancef1(DistFunc1D& DF, valarray<double>& Zarray, DistFunc1D& DFh, const double step_size);
-            void advanceflm(DistFunc1D& DF, valarray<double>& Zarray, DistFunc1D& DFh);
+        /// The cells [x0,x1) x [y0,y1) of the local grid, f1 on the
+        /// guard cells as well and flm on the interior cells only
+            void advancef1(DistFunc1D& DF, valarray<double>& Zarray, DistFunc1D& DFh, const double step_size,
+                           const size_t x0, const size_t x1);
+            void advanceflm(DistFunc1D& DF, valarray<double>& Zarray, DistFunc1D& DFh,
+                            const size_t x0, const size_t x1);
 
-            void advancef1(DistFunc2D& DF, Array2D<double>& Zarray, DistFunc2D& DFh, const double step_size);
-            void advanceflm(DistFunc2D& DF, Array2D<double>& Zarray, DistFunc2D& DFh);
+            void advancef1(DistFunc2D& DF, Array2D<double>& Zarray, DistFunc2D& DFh, const double step_size,
+                           const size_t x0, const size_t x1, const size_t y0, const size_t y1);
+            void advanceflm(DistFunc2D& DF, Array2D<double>& Zarray, DistFunc2D& DFh,
+                            const size_t x0, const size_t x1, const size_t y0, const size_t y1);
 
         private:
 
@@ -315,6 +343,9 @@ class self_f00_explicit_step {
 /// ---------------------------------------------------------------------------- ///
             size_t f1_m_upperlimit;
 
+///         The harmonics l >= 2 that this member of a harmonic group keeps
+            void kept_harmonics(const Array2D<int>& ind, vector<size_t>& ls, vector<size_t>& ms) const;
+
         };
 //-------------------------------------------------------------------
 
@@ -332,14 +363,23 @@ class self_f00_explicit_step {
             self_collisions(const size_t _l0, const size_t _m0,
                              const valarray<double>& dp, const double& charge, const double& mass); 
             // ~self_collisions();
-            void advancef00(SHarmonic1D& f00, valarray<double>& Zarray, SHarmonic1D& f00h, const double time, const double step_size);
-            void advancef1(DistFunc1D& DF, valarray<double>& Zarray, DistFunc1D& DFh, const double step_size);
-            void advanceflm(DistFunc1D& DF, valarray<double>& Zarray, DistFunc1D& DFh);
-
-            void advancef00(SHarmonic2D& f00, Array2D<double>& Zarray, SHarmonic2D& f00h, const double time, const double step_size);
-            void advancef1(DistFunc2D& DF, Array2D<double>& Zarray, DistFunc2D& DFh, const double step_size);
-            void advanceflm(DistFunc2D& DF, Array2D<double>& Zarray, DistFunc2D& DFh);
-
+        /// On the cells [x0,x1) x [y0,y1) of the local grid
+            void advancef00(SHarmonic1D& f00, valarray<double>& Zarray, SHarmonic1D& f00h, const double time, const double step_size,
+                            const size_t x0, const size_t x1);
+            void advancef1(DistFunc1D& DF, valarray<double>& Zarray, DistFunc1D& DFh, const double step_size,
+                           const size_t x0, const size_t x1);
+            void advanceflm(DistFunc1D& DF, valarray<double>& Zarray, DistFunc1D& DFh,
+                            const size_t x0, const size_t x1);
+
+            void advancef00(SHarmonic2D& f00, Array2D<double>& Zarray, SHarmonic2D& f00h, const double time, const double step_size,
+                            const size_t x0, const size_t x1, const size_t y0, const size_t y1);
+            void advancef1(DistFunc2D& DF, Array2D<double>& Zarray, DistFunc2D& DFh, const double step_size,
+                           const size_t x0, const size_t x1, const size_t y0, const size_t y1);
+            void advanceflm(DistFunc2D& DF, Array2D<double>& Zarray, DistFunc2D& DFh,
+                            const size_t x0, const size_t x1, const size_t y0, const size_t y1);
+
+            void celltime(valarray<double>& seconds);
+            void celltime(Array2D<double>& seconds);
 
         private:
         //  Variables
@@ -366,6 +406,17 @@ class self_f00_explicit_step {
             void advancef1(State1D& Y, State1D& Yh, const double step_size);
             void advanceflm(State1D& Y, State1D& Yh);
 
+        /// advance in two parts around the halo exchange. The guard 
+        /// cells and the boundary cells next to them come first, the 
+        /// interior cells can follow while the boundary cells are in 
+        /// flight
+            void advance_boundary(State1D& Y, const double time, const double step_size);
+            void advance_interior(State1D& Y, const double time, const double step_size);
+
+        /// Adds the seconds the implicit f00 step spent on each interior
+        /// cell since the last call, all species
+            void celltime(valarray<double>& seconds);
+
             vector<self_collisions> self();
             // void advancef1(State1D& Y);
             // void advanceflm(State1D& Y);
@@ -374,6 +425,11 @@ class self_f00_explicit_step {
         //  Variables
             State1D Yh;
             vector<self_collisions> self_coll;
+
+        /// Cells [x0,x1) of the local grid, from Y to Yh and back
+            void advance(State1D& Y, const double time, const double step_size, const size_t x0, const size_t x1);
+        /// Interior cells that the halo exchange does not read
+            void inner(const State1D& Y, size_t& x0, size_t& x1) const;
             // vector<interspecies_collisions> unself_coll;
 //            vector<interspecies_f00_explicit_collisions> unself_f00_coll;
         };
@@ -389,6 +445,16 @@ class self_f00_explicit_step {
             void advancef1(State2D& Y, State2D& Yh, const double step_size);
             void advanceflm(State2D& Y, State2D& Yh);
 
+        /// advance in two parts around the halo exchange. The frame of 
+        /// guard cells and boundary cells comes first, the interior 
+        /// cells can follow while the boundary cells are in flight
+            void advance_boundary(State2D& Y, const double time, const double step_size);
+            void advance_interior(State2D& Y, const double time, const double step_size);
+
+        /// Adds the seconds the implicit f00 step spent on each interior
+        /// cell since the last call, all species
+            void celltime(Array2D<double>& seconds);
+
             vector<self_collisions> self();
             // void advancef1(State1D& Y);
             // void advanceflm(State1D& Y);
@@ -397,6 +463,12 @@ class self_f00_explicit_step {
         //  Variables
             State2D Yh;
             vector<self_collisions> self_coll;
+
+        /// Cells [x0,x1) x [y0,y1) of the local grid, from Y to Yh and back
+            void advance(State2D& Y, const double time, const double step_size, 
+                         const size_t x0, const size_t x1, const size_t y0, const size_t y1);
+        /// Interior cells that the halo exchange does not read
+            void inner(const State2D& Y, size_t& x0, size_t& x1, size_t& y0, size_t& y1) const;
             // vector<interspecies_collisions> unself_coll;
 //            vector<interspecies_f00_explicit_collisions> unself_f00_coll;
         };
@@ -18,12 +18,20 @@
 #include <sstream>
 #include <string>
 #include <cstring>
+#include <cstdio>
 
 #include <math.h>
 #include <map>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <signal.h>
 
 //  My libraries
 #include "lib-array.h"
@@ -542,8 +550,16 @@ Export_Files::Header::Header(string _axis_units, string _quantity_units, string
 Export_Files::Xport::Xport(const Algorithms::AxisBundle<double>& _axis,
    const vector< string > oTags,
    string homedir)
-
+    : hdir(homedir), stepfile(NULL), stepfile_mpio(false), queue(NULL)
 {
+//  Serial HDF5 output goes to the I/O thread, collective MPI-IO
+//  writes stay on the time stepping thread. The single restart 
+//  file is written with HDF5 on the time stepping thread, so the
+//  queue is flushed before it (main)
+#ifndef H5_HAVE_PARALLEL
+    if (Input::List().async_output) queue = new Output_Queue(Input::List().output_queue_depth);
+#endif
+
     size_t species(_axis.pdim());
     DefaultTags dTags(species);
 
@@ -669,1544 +685,1269 @@ string Export_Files::Xport::oH5Fextension(size_t step, int species){
 
 //**************************************************************
 //--------------------------------------------------------------
+//  Set by the handler of SIGTERM/SIGUSR1, the scheduler warning of
+//  the end of the job
+static volatile sig_atomic_t emergency_signal(0);
+
+static void Catch_emergency_signal(int) {
+    emergency_signal = 1;
+}
+//--------------------------------------------------------------
 Export_Files::Restart_Facility::Restart_Facility(const int rank, string homedir) {
     hdir = homedir;
+    alignment = Input::List().restart_alignment;
 
     if (!rank) Makefolder(hdir+"restart/");
 
 //        if (Makefolder(hdir+"restart/") != 0) cout<<"Warning: Folder "<< hdir+"restart/"<<" exists\n";
+
+//  The node-local level, every node makes the folder on its own disk
+    local_dir = Input::List().local_restart_dir;
+    if (!local_dir.empty()) {
+        if (local_dir[local_dir.size()-1] != '/') local_dir.append("/");
+        Makefolder(local_dir);
+    }
+    dumps = 0;
+    base_step = 0;
+
+    if (Input::List().emergency_restart) {
+        signal(SIGTERM, Catch_emergency_signal);
+        signal(SIGUSR1, Catch_emergency_signal);
+    }
+
+    deadline = 0.0;
+    if (Input::List().walltime > 0.0) {
+        deadline = MPI_Wtime() + 60.0 * (Input::List().walltime - Input::List().walltime_margin);
+    }
 }
 
 //--------------------------------------------------------------
-//  Read restart file
-void Export_Files::Restart_Facility::Read(const int rank, const size_t re_step, State1D& Y, double time_start) {
+//  Read restart file, from the local level if the step has no
+//  durable file
+void Export_Files::Restart_Facility::Read(Parallel_Environment_1D& PE, const size_t re_step, State1D& Y, double& time_start) {
 
-//      Generate filename 
-    string   filename(hdir+"restart/re_1D_");
-    filename.append(rFextension(rank,re_step));
-
-//      Open file
-    ifstream  fin(filename.c_str(), ios::binary);
+    string durable(hdir+"restart/re_1D_");
+    durable.append(Input::List().single_restart_file ? rH5extension(re_step) : rFextension(PE.RANK(),re_step));
 
-    if (fin)
-    {
-        fin.read((char *) &time,sizeof(time_start));
-    //      Read distribution functions
-        for(size_t s(0); s < Y.Species(); ++s) {
-            for(size_t nh(0); nh < Y.DF(s).dim(); ++nh) {
-                for(size_t i(0); i < (Y.DF(s))(nh).dim(); ++i) {
-                    fin.read((char *)&(Y.DF(s))(nh)(i), sizeof((Y.DF(s))(nh)(i)));
-                }
-            }
-        }
+    if (!local_dir.empty() && !ifstream(durable.c_str())) {
+        time_start = Read_blocks(PE.RANK(), local_dir+"re_1D_", re_step, State_blocks(Y));
+        return;
     }
-    else {
-
-        if (!rank) std::cout << "\n\n ERROR :: No files to read! \n\n";
-        exit(1);
 
+    if (Input::List().single_restart_file) {
+        time_start = Read_h5(durable, Checkpoint_sets(Y), Layout(PE), Harmonic_Group::Space());
+        PE.Neighbor_Communications(Y);
+        return;
     }
 
-//      Read fields
-    for(size_t ifields(0); ifields < Y.Fields(); ++ifields){
-        for(size_t i(0); i < Y.EMF().Ex().numx(); ++i) {
-            fin.read((char *)(&(Y.FLD(ifields))(i)), sizeof(Y.FLD(ifields)(i)));
-        }
+    if (Legacy(durable)) {
+        time_start = Read_legacy(durable, State_blocks(Y));
+        return;
     }
 
-    fin.close();
+    time_start = Read_blocks(PE.RANK(), hdir+"restart/re_1D_", re_step, State_blocks(Y));
 }
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-//  Write restart file
-void Export_Files::Restart_Facility::Write(const int rank, const size_t re_step, State1D& Y, double time_dump) {
+//  Write restart file, to the local level and every 
+//  durable_restart_every dumps to restart/
+void Export_Files::Restart_Facility::Write(const Parallel_Environment_1D& PE, const size_t re_step, State1D& Y, double time_dump,
+ const bool durable_now) {
 
-//      Generate filename 
-    string   filename(hdir+"restart/re_1D_");
-    filename.append(rFextension(rank,re_step));
-
-//      Open file
-    ofstream  fout(filename.c_str(), ios::binary);
+    if (Harmonic_Group::Rank()) return;                 //  The first member of a group has collected the state
 
-    fout.write((char *) &time_dump,sizeof(time_dump));
+    bool durable(Durable(durable_now));
 
-//      Write distribution functions
-    for (size_t s(0); s < Y.Species(); ++s) {
-        for (size_t nh(0); nh < Y.DF(s).dim(); ++nh) {
-            for (size_t i(0); i < (Y.DF(s))(nh).dim(); ++i) {
-                fout.write((char *) &(Y.DF(s))(nh)(i), sizeof((Y.DF(s))(nh)(i)));
-            }
-        }
-    }
+    if (!local_dir.empty()) Write_local(PE.RANK(), "re_1D_", re_step, State_blocks(Y), time_dump, durable);
+    if (!durable) return;
 
-//      Write fields
-    for(size_t ifields(0); ifields < Y.Fields(); ++ifields){
-        for(size_t i(0); i < Y.EMF().Ex().numx(); ++i) {
-            fout.write((char *)(&(Y.FLD(ifields))(i)), sizeof(Y.FLD(ifields)(i)));
-        }
+    if (Input::List().single_restart_file) {
+        Write_h5(hdir+"restart/re_1D_"+rH5extension(re_step), Checkpoint_sets(Y), Layout(PE), Harmonic_Group::Space(), time_dump);
+        return;
     }
 
+//      Generate filename 
+    string   filename(hdir+"restart/re_1D_");
+    filename.append(rFextension(PE.RANK(),re_step));
 
-    fout.flush();
-    fout.close();
+    Write_blocks(filename, State_blocks(Y), time_dump, 0);
 }
 //--------------------------------------------------------------
 //--------------------------------------------------------------
 //  Read restart file
-void Export_Files::Restart_Facility::Read(const int rank, const size_t re_step, State2D& Y, double time_start) {
-
-//      Generate filename 
-    string   filename(hdir+"restart/re_2D_");
-    filename.append(rFextension(rank,re_step));
+void Export_Files::Restart_Facility::Read(Parallel_Environment_2D& PE, const size_t re_step, State2D& Y, double& time_start) {
 
-//      Open file
-    ifstream  fin(filename.c_str(), ios::binary);
+    string durable(hdir+"restart/re_2D_");
+    durable.append(Input::List().single_restart_file ? rH5extension(re_step) : rFextension(PE.RANK(),re_step));
 
-    if (fin)
-    {
-        fin.read((char *) &time,sizeof(time_start));
-    //      Read distribution functions
-        for(size_t s(0); s < Y.Species(); ++s) {
-            for(size_t nh(0); nh < Y.DF(s).dim(); ++nh) {
-                for(size_t i(0); i < (Y.DF(s))(nh).dim(); ++i) {
-                    fin.read((char *)&(Y.DF(s))(nh)(i), sizeof((Y.DF(s))(nh)(i)));
-                }
-            }
-        }
+    if (!local_dir.empty() && !ifstream(durable.c_str())) {
+        time_start = Read_blocks(PE.RANK(), local_dir+"re_2D_", re_step, State_blocks(Y));
+        return;
     }
-    else {
-        
-        if (!rank) std::cout << "\n\n ERROR :: No files to read! \n\n";
-        exit(1);
 
+    if (Input::List().single_restart_file) {
+        time_start = Read_h5(durable, Checkpoint_sets(Y), Layout(PE), PE.Comm());
+        PE.Neighbor_Communications(Y);
+        return;
     }
 
-//      Read fields
-    for(size_t ifields(0); ifields < Y.Fields(); ++ifields){
-        for(size_t ix(0); ix < Y.EMF().Ex().numx(); ++ix) 
-        {
-            for(size_t iy(0); iy < Y.EMF().Ex().numy(); ++iy) 
-            {
-                fin.read((char *)(&(Y.FLD(ifields))(ix,iy)), sizeof(Y.FLD(ifields)(ix,iy)));
+    if (Legacy(durable)) {
+        time_start = Read_legacy(durable, State_blocks(Y));
+
+//      The fields of these files run fastest in y
+        for (size_t ifields(0); ifields < Y.Fields(); ++ifields) {
+            valarray< complex<double> > raw(Y.FLD(ifields).array().array());
+            for (size_t ix(0); ix < Y.EMF().Ex().numx(); ++ix) {
+                for (size_t iy(0); iy < Y.EMF().Ex().numy(); ++iy) {
+                    Y.FLD(ifields)(ix,iy) = raw[ix*Y.EMF().Ex().numy()+iy];
+                }
             }
         }
+        return;
     }
 
-    fin.close();
+    time_start = Read_blocks(PE.RANK(), hdir+"restart/re_2D_", re_step, State_blocks(Y));
 }
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
 //  Write restart file
-void Export_Files::Restart_Facility::Write(const int rank, const size_t re_step, State2D& Y, double time_dump) {
+void Export_Files::Restart_Facility::Write(const Parallel_Environment_2D& PE, const size_t re_step, State2D& Y, double time_dump,
+ const bool durable_now) {
+
+    if (Harmonic_Group::Rank()) return;                 //  The first member of a group has collected the state
+
+    bool durable(Durable(durable_now));
+
+    if (!local_dir.empty()) Write_local(PE.RANK(), "re_2D_", re_step, State_blocks(Y), time_dump, durable);
+    if (!durable) return;
+
+    if (Input::List().single_restart_file) {
+        Write_h5(hdir+"restart/re_2D_"+rH5extension(re_step), Checkpoint_sets(Y), Layout(PE), PE.Comm(), time_dump);
+        return;
+    }
 
 //      Generate filename 
     string   filename(hdir+"restart/re_2D_");
-    filename.append(rFextension(rank,re_step));
+    filename.append(rFextension(PE.RANK(),re_step));
 
-//      Open file
-    ofstream  fout(filename.c_str(), ios::binary);
+    Write_blocks(filename, State_blocks(Y), time_dump, 0);
+}
+//--------------------------------------------------------------
 
+//--------------------------------------------------------------
+//  Checked at the top of every step. The nodes agree on it, so that
+//  they all write the checkpoint of the same step
+bool Export_Files::Restart_Facility::Emergency() {
 
-    fout.write((char *) &time_dump,sizeof(time_dump));
-//      Write distribution functions
-    
-    for (size_t s(0); s < Y.Species(); ++s) {
-        for (size_t nh(0); nh < Y.DF(s).dim(); ++nh) {
-            for (size_t i(0); i < (Y.DF(s))(nh).dim(); ++i) {
-                fout.write((char *) &(Y.DF(s))(nh)(i), sizeof((Y.DF(s))(nh)(i)));
+    if (!Input::List().emergency_restart && (deadline == 0.0)) return false;
+
+    int local(emergency_signal || ((deadline != 0.0) && (MPI_Wtime() > deadline))), any(0);
+    MPI_Allreduce(&local, &any, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+
+    return (any != 0);
+}
+//--------------------------------------------------------------
+//  Count the dump, true if it goes to the parallel filesystem
+bool Export_Files::Restart_Facility::Durable(const bool forced) {
+    ++dumps;
+    return local_dir.empty() || forced || (dumps % size_t(max(Input::List().durable_restart_every, 1)) == 0);
+}
+//--------------------------------------------------------------
+//  Dump to the node-local level and drop the oldest dumps beyond
+//  local_restarts_kept. With local_restart_delta the dumps are 
+//  deltas against the last full one, which is kept in memory
+void Export_Files::Restart_Facility::Write_local(const int rank, const string prefix, const size_t re_step, 
+ const Blocks& blocks, double time_dump, const bool full) {
+
+    size_t base(0);
+
+//  The dumps are named by the output step, one at the step of the
+//  base replaces it with a new full dump
+    if (Input::List().local_restart_delta && !full && !shadow.empty() && (re_step != base_step)) {
+        base = base_step+1;
+        Write_blocks(local_dir+prefix+rFextension(rank,re_step), blocks, time_dump, base);
+    }
+    else {
+        Write_blocks(local_dir+prefix+rFextension(rank,re_step), blocks, time_dump, 0);
+        if (Input::List().local_restart_delta) {
+            shadow.resize(blocks.size());
+            for (size_t ib(0); ib < blocks.size(); ++ib) {
+                shadow[ib].assign(blocks[ib].first, blocks[ib].first + blocks[ib].second);
             }
+            base_step = re_step;
         }
     }
-    
+    if (!local_steps.empty() && (local_steps.back().first == re_step)) local_steps.pop_back();
+    local_steps.push_back(std::make_pair(re_step, base));
 
-//      Write fields
-    for(size_t ifields(0); ifields < Y.Fields(); ++ifields){
-        for(size_t ix(0); ix < Y.EMF().Ex().numx(); ++ix) 
-        {
-            for(size_t iy(0); iy < Y.EMF().Ex().numy(); ++iy) 
-            {
-                fout.write((char *)(&(Y.FLD(ifields))(ix,iy)), sizeof(Y.FLD(ifields)(ix,iy)));
-            }
+//  Oldest first, a full dump stays while a kept delta needs it
+    size_t kept(max(Input::List().local_restarts_kept, 1));
+    size_t excess(local_steps.size() > kept ? local_steps.size() - kept : 0);
+    for (size_t il(0); (excess > 0) && (il < local_steps.size()); ) {
+        bool needed(false);
+        for (size_t jl(il+1); jl < local_steps.size(); ++jl) {
+            needed = needed || (local_steps[jl].second == local_steps[il].first+1);
         }
+        if (needed) {
+            ++il;
+            continue;
+        }
+        std::remove((local_dir+prefix+rFextension(rank,local_steps[il].first)).c_str());
+        local_steps.erase(local_steps.begin()+il);
+        --excess;
     }
-
-
-    fout.flush();
-    fout.close();
 }
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-//  Adjust filenames with zeros to reach some prescribed length. 
-//  Add the filename extension. 
-string Export_Files::Restart_Facility::rFextension(const int rank, const size_t rstep){
-    stringstream sFilename;
+//  The state as contiguous blocks, the harmonics of each species
+//  followed by the fields
+Export_Files::Restart_Facility::Blocks Export_Files::Restart_Facility::State_blocks(State1D& Y) {
 
-    // Number of zeros to add to the filename
-    int Nzeros(ofconventions::rank_digits - stringify(rank).length());
-    while (Nzeros-- > 0) {
-        sFilename << "0";
+    Blocks blocks;
+    for (size_t s(0); s < Y.Species(); ++s) {
+        for (size_t nh(0); nh < Y.DF(s).dim(); ++nh) {
+            valarray< complex<double> >& sh((Y.DF(s))(nh).array().array());
+            blocks.push_back(make_pair((char *) &sh[0], sh.size()*sizeof(sh[0])));
+        }
+    }
+    for (size_t ifields(0); ifields < Y.Fields(); ++ifields) {
+        valarray< complex<double> >& fld(Y.FLD(ifields).array());
+        blocks.push_back(make_pair((char *) &fld[0], fld.size()*sizeof(fld[0])));
     }
 
-    sFilename << rank << "_";
+    return blocks;
+}
+//--------------------------------------------------------------
+Export_Files::Restart_Facility::Blocks Export_Files::Restart_Facility::State_blocks(State2D& Y) {
 
-    // Number of zeros to add to the filename
-    Nzeros = ofconventions::rfile_digits - stringify(rstep).length();
-    while (Nzeros-- > 0) {
-        sFilename << "0";
+    Blocks blocks;
+    for (size_t s(0); s < Y.Species(); ++s) {
+        for (size_t nh(0); nh < Y.DF(s).dim(); ++nh) {
+            valarray< complex<double> >& sh((Y.DF(s))(nh).array().array());
+            blocks.push_back(make_pair((char *) &sh[0], sh.size()*sizeof(sh[0])));
+        }
+    }
+    for (size_t ifields(0); ifields < Y.Fields(); ++ifields) {
+        valarray< complex<double> >& fld(Y.FLD(ifields).array().array());
+        blocks.push_back(make_pair((char *) &fld[0], fld.size()*sizeof(fld[0])));
     }
 
-    sFilename << rstep << ofconventions::rfile_extension;
-
-    return sFilename.str();
+    return blocks;
 }
 //--------------------------------------------------------------
-//**************************************************************
 
-//**************************************************************
 //--------------------------------------------------------------
-Output_Data::PLegendre2D::PLegendre2D( size_t Nl, size_t Nm,
-    double pmax, valarray<double> px, valarray<double> py){
+//  64-bit multiplicative hash of the payload, word by word so 
+//  that it keeps up with the disk
+size_t Export_Files::Restart_Facility::Checksum(size_t hash, const char* data, const size_t bytes) {
 
-    size_t sz(((Nm+1)*(2*Nl-Nm+2))/2);
+    const size_t prime(1099511628211ULL);
+    size_t       word;
 
-//  Generate the structure to save the polynomials
-    for (size_t i(0);i < sz; ++i)
-    {
-        plegendre.push_back(Array2D<double>(px.size(),py.size()));
+    size_t i(0);
+    for ( ; i + sizeof(word) <= bytes; i += sizeof(word)) {
+        memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * prime;
+    }
+    for ( ; i < bytes; ++i) {
+        hash = (hash ^ size_t((unsigned char) data[i])) * prime;
     }
-    
-//  Generate the polynomial values for each cos(theta) = px/p 
-    if (Nl > 1)
-    {
-        for (size_t ipy(0); ipy < py.size(); ++ipy) {
-
-            for (size_t ipx(0); ipx < px.size(); ++ipx) {
 
-                double invp(sqrt(py[ipy] * py[ipy] + px[ipx] * px[ipx]));
+    return hash;
+}
+//--------------------------------------------------------------
+//  Bytes of padding to the next multiple of the alignment
+size_t Export_Files::Restart_Facility::Padding(const size_t bytes, const size_t align) {
+    if (align < 2) return 0;
+    return (align - bytes % align) % align;
+}
+//--------------------------------------------------------------
+//  Difference to the base as the XOR of the bit patterns, with the
+//  bytes regrouped by significance so that the unchanged sign, 
+//  exponent and leading mantissa bytes form runs of zeros. These
+//  are stored as (zeros, literals) counts followed by the literals
+void Export_Files::Restart_Facility::Encode_delta(const char* data, const char* base, const size_t bytes, 
+ vector<char>& packed) {
 
-                if (invp > pmax) invp = 0;
-                if (invp > 0.0) invp = 1.0 / invp;
+    const size_t words(bytes / sizeof(double));
+    vector<char> x(bytes);
+    for (size_t b(0); b < sizeof(double); ++b) {
+        for (size_t w(0); w < words; ++w) {
+            x[b*words + w] = data[w*sizeof(double) + b] ^ base[w*sizeof(double) + b];
+        }
+    }
+    for (size_t i(words*sizeof(double)); i < bytes; ++i) x[i] = data[i] ^ base[i];
 
-    //          For given px/p generate all the polynomial values ...
-                Array2D<double> vL(Algorithms::Legendre(static_cast<double>(px[ipx]) * invp, Nl, Nm));
-                //          ... and save them
-                size_t k(0);
-                for (size_t l(0); l < Nl + 1; ++l) 
-                {
-                    for (size_t m(0); m < ((Nm < l) ? Nm : l) + 1; ++m) 
-                    {
-                        (plegendre)[k](ipx, ipy) = vL(l, m);
-                        ++k;
-                    }
-                }
-            }
+    packed.clear();
+    size_t i(0);
+    while (i < bytes) {
+        size_t run[2] = {0, 0};
+        while ((i < bytes) && (x[i] == 0)) { ++run[0]; ++i; }
+
+//      The literals end at the next run of 2*sizeof(run) zeros
+        size_t start(i), zeros(0);
+        while ((i < bytes) && (zeros < 2*sizeof(run))) {
+            zeros = (x[i] == 0) ? zeros + 1 : 0;
+            ++i;
         }
+        if (zeros == 2*sizeof(run)) i -= zeros;
+        run[1] = i - start;
+
+        packed.insert(packed.end(), (char *) run, (char *) run + sizeof(run));
+        packed.insert(packed.end(), &x[0] + start, &x[0] + i);
     }
 }
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+//--------------------------------------------------------------
+//  Undo Encode_delta on data, which holds the base
+void Export_Files::Restart_Facility::Decode_delta(const vector<char>& packed, char* data, const size_t bytes) {
 
-Output_Data::PLegendre2D::PLegendre2D( const PLegendre2D& other ) {
+    const size_t words(bytes / sizeof(double));
+    vector<char> x(bytes, 0);
 
-//  Generate the structure to save the polynomials
-    for (size_t i(0); i < other.dim(); ++i) {
-        (plegendre).push_back( other(i) );
+    size_t i(0), p(0);
+    while ((i < bytes) && (p + 2*sizeof(size_t) <= packed.size())) {
+        size_t run[2];
+        memcpy(run, &packed[p], sizeof(run));
+        p += sizeof(run);
+        i += run[0];
+        if ((i + run[1] > bytes) || (p + run[1] > packed.size())) break;
+        std::copy(&packed[0] + p, &packed[0] + p + run[1], &x[0] + i);
+        i += run[1];
+        p += run[1];
     }
-}
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-Output_Data::PLegendre2D::~PLegendre2D(){
+    for (size_t b(0); b < sizeof(double); ++b) {
+        for (size_t w(0); w < words; ++w) {
+            data[w*sizeof(double) + b] ^= x[b*words + w];
+        }
+    }
+    for (size_t k(words*sizeof(double)); k < bytes; ++k) data[k] ^= x[k];
 }
 //--------------------------------------------------------------
+//  Header, table of the block sizes and the blocks, each padded
+//  to the alignment. The checksum goes in once the payload is out.
+//  A delta (base > 0) has the encoded blocks, each after its size
+void Export_Files::Restart_Facility::Write_blocks(const string filename, const Blocks& blocks, double time_dump,
+ const size_t base) {
+
+    Header header;
+    memcpy(header.magic, ofconventions::restart_magic, sizeof(header.magic));
+    header.version   = ofconventions::restart_version;
+    header.nblocks   = blocks.size();
+    header.alignment = base ? 0 : alignment;
+    header.base      = base;
+    header.payload   = 0;
+    header.checksum  = ofconventions::restart_seed;
+    header.time      = time_dump;
+
+    vector<size_t> sizes(blocks.size());
+    for (size_t ib(0); ib < blocks.size(); ++ib) {
+        sizes[ib] = blocks[ib].second;
+        header.payload += sizes[ib];
+    }
+
+    size_t table(sizeof(header) + sizes.size()*sizeof(size_t));
+    size_t widest(Padding(table, header.alignment));
+    for (size_t ib(0); ib < blocks.size(); ++ib) widest = max(widest, Padding(blocks[ib].second, header.alignment));
+    vector<char> zeros(widest + 1, 0);
+    vector<char> packed;
 
-//**************************************************************
-//--------------------------------------------------------------
-Output_Data::harmonicvsposition::harmonicvsposition(const Grid_Info& _G) {
+//      Open file
+    ofstream  fout(filename.c_str(), ios::binary);
 
-//  Generate the required structures
-    for (size_t s(0); s < _G.axis.pdim(); ++s) {
-        pmax.push_back( static_cast<double>(_G.axis.pmax(s)) );
-        pmin.push_back( static_cast<double>(_G.axis.pmin(s)) );
-        nump.push_back( static_cast<double>(_G.axis.Np(s))   );
+    fout.write((char *) &header, sizeof(header));
+    fout.write((char *) &sizes[0], sizes.size()*sizeof(size_t));
+    fout.write(&zeros[0], Padding(table, header.alignment));
+
+    for (size_t ib(0); ib < blocks.size(); ++ib) {
+        if (base) {
+            Encode_delta(blocks[ib].first, &shadow[ib][0], blocks[ib].second, packed);
+            size_t bytes(packed.size());
+            fout.write((char *) &bytes, sizeof(bytes));
+            fout.write(&packed[0], bytes);
+        }
+        else {
+            fout.write(blocks[ib].first, blocks[ib].second);
+            fout.write(&zeros[0], Padding(blocks[ib].second, header.alignment));
+        }
+        header.checksum = Checksum(header.checksum, blocks[ib].first, blocks[ib].second);
     }
+
+    fout.seekp(0);
+    fout.write((char *) &header, sizeof(header));
+
+    fout.flush();
+    fout.close();
 }
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+//--------------------------------------------------------------
+//  Check the header and the block sizes against the state, read
+//  the blocks in place and verify the checksum. A delta is applied
+//  on top of its base, read first
+double Export_Files::Restart_Facility::Read_blocks(const int rank, const string prefix, const size_t re_step, 
+ const Blocks& blocks) {
 
-Output_Data::harmonicvsposition::harmonicvsposition( const harmonicvsposition& other) {
+    string filename(prefix + rFextension(rank,re_step));
 
-    for (size_t s(0); s < other.Species(); ++s) {
-        pmin.push_back( other.Pmin(s) );
-        pmax.push_back( other.Pmax(s) );
-        nump.push_back( other.Np(s)   );
+//      Open file
+    ifstream  fin(filename.c_str(), ios::binary);
+
+    if (!fin) {
+        if (!rank) std::cout << "\n\n ERROR :: No files to read! \n\n";
+        exit(1);
     }
-}
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-Output_Data::harmonicvsposition::~harmonicvsposition(){
+    Header header;
+    fin.read((char *) &header, sizeof(header));
+
+    if ( !fin || memcmp(header.magic, ofconventions::restart_magic, sizeof(header.magic)) != 0
+              || header.version != ofconventions::restart_version ) {
+        std::cout << "\n\n ERROR :: " << filename << " is not a version " << ofconventions::restart_version << " restart file \n\n";
+        exit(1);
+    }
+
+    vector<size_t> sizes(header.nblocks);
+    if (header.nblocks) fin.read((char *) &sizes[0], sizes.size()*sizeof(size_t));
+
+    bool match(header.nblocks == blocks.size());
+    for (size_t ib(0); match && ib < blocks.size(); ++ib) match = (sizes[ib] == blocks[ib].second);
+    if (!match) {
+        std::cout << "\n\n ERROR :: " << filename << " does not match the size of the state \n\n";
+        exit(1);
+    }
+
+    if (header.base) Read_blocks(rank, prefix, header.base-1, blocks);
+
+//      The padding follows the alignment the file was written with
+    size_t table(sizeof(header) + sizes.size()*sizeof(size_t));
+    fin.seekg(table + Padding(table, header.alignment));
+
+    size_t checksum(ofconventions::restart_seed);
+    vector<char> packed;
+    for (size_t ib(0); ib < blocks.size(); ++ib) {
+        if (header.base) {
+            size_t bytes(0);
+            fin.read((char *) &bytes, sizeof(bytes));
+            packed.resize(fin ? bytes : 0);
+            if (bytes) fin.read(&packed[0], bytes);
+            Decode_delta(packed, blocks[ib].first, blocks[ib].second);
+        }
+        else {
+            fin.read(blocks[ib].first, blocks[ib].second);
+            fin.seekg(Padding(blocks[ib].second, header.alignment), ios::cur);
+        }
+        checksum = Checksum(checksum, blocks[ib].first, blocks[ib].second);
+    }
+
+    if (!fin || checksum != header.checksum) {
+        std::cout << "\n\n ERROR :: " << filename << " is corrupted, the checksum does not match \n\n";
+        exit(1);
+    }
+
+    fin.close();
 
+    return header.time;
 }
-//-------------------------------------------------------------
 //--------------------------------------------------------------
-//  Turn the Distribution function at some spatial location x0 
-//  into a cartesian grid.
-Array2D<double>  Output_Data::harmonicvsposition::operator()(DistFunc1D& df, size_t l, size_t m, size_t x0, size_t s) {
-    
-    Array2D<double> fx1(Np(s),2); 
+//  Files of the per-element layout that came before the header 
+//  start with the dump time instead of the magic
+bool Export_Files::Restart_Facility::Legacy(const string filename) {
 
-    for (size_t ip(0); ip < Np(s); ++ip) {
-        //  At each location in |p|
-        fx1(ip,0) = static_cast<double>( (df(l,m))(ip,x0).real() );
-        fx1(ip,1) = static_cast<double>( (df(l,m))(ip,x0).imag() );
-    }
+    ifstream  fin(filename.c_str(), ios::binary);
 
-    return fx1;
+    char magic[sizeof(ofconventions::restart_magic)];
+    fin.read(magic, sizeof(magic));
+
+    return fin && memcmp(magic, ofconventions::restart_magic, sizeof(magic)) != 0;
 }
+//--------------------------------------------------------------
+//  The dump time followed by the elements of the harmonics and 
+//  of the fields, without padding or checksum
+double Export_Files::Restart_Facility::Read_legacy(const string filename, const Blocks& blocks) {
 
-Array2D<double>  Output_Data::harmonicvsposition::operator()(DistFunc2D& df, size_t l, size_t m, size_t x0, size_t y0, size_t s) {
-    
-    Array2D<double> fx1(Np(s),2); 
+    ifstream  fin(filename.c_str(), ios::binary);
 
-    for (size_t ip(0); ip < Np(s); ++ip) {
-        //  At each location in |p|
-        fx1(ip,0) = static_cast<double>( (df(l,m))(ip,x0,y0).real() );
-        fx1(ip,1) = static_cast<double>( (df(l,m))(ip,x0,y0).imag() );
+    double time_dump;
+    fin.read((char *) &time_dump, sizeof(time_dump));
+
+    for (size_t ib(0); ib < blocks.size(); ++ib) fin.read(blocks[ib].first, blocks[ib].second);
+
+    if (!fin || fin.peek() != ifstream::traits_type::eof()) {
+        std::cout << "\n\n ERROR :: " << filename << " does not match the size of the state \n\n";
+        exit(1);
     }
 
-    return fx1;
+    fin.close();
+
+    return time_dump;
 }
 //--------------------------------------------------------------
-//**************************************************************
 
-//**************************************************************
 //--------------------------------------------------------------
-Output_Data::fulldistvsposition::fulldistvsposition( const Grid_Info& _G): grid(_G) 
-{
-    
-    //  Generate the required structures
-    for (size_t s(0); s < _G.axis.pdim(); ++s) {
-        pvec.push_back(valtovec(_G.axis.p(s)));
-        
-        pxvec.push_back(_G.axis.px(s));
-        pyvec.push_back(_G.axis.py(s));
-        pzvec.push_back(_G.axis.pz(s));
-
-        PL2D.push_back( PLegendre2D( _G.l0[s], _G.m0[s],
-          (_G.axis.pmax(s)), _G.axis.px(s), _G.axis.py(s) ) );  
-    
-        pout1D_p1.push_back( valarray<double>( _G.axis.Npx(s))); 
-        pout1D_p2.push_back( valarray<double>( _G.axis.Npy(s))); 
-        pout1D_p3.push_back( valarray<double>( _G.axis.Npz(s)));         
-        pout2D_p1p2.push_back( Array2D<double>( _G.axis.Npx(s),_G.axis.Npy(s))); 
-        pout2D_p1p3.push_back( Array2D<double>( _G.axis.Npx(s),_G.axis.Npz(s))); 
-        pout2D_p2p3.push_back( Array2D<double>( _G.axis.Npy(s),_G.axis.Npz(s))); 
+//  The harmonics of each species and the fields of the single 
+//  restart file
+vector<Export_Files::Restart_Facility::Checkpoint_Set> Export_Files::Restart_Facility::Checkpoint_sets(State1D& Y) {
 
-        pout3D.push_back( Array3D<double>( _G.axis.Npx(s),_G.axis.Npy(s),_G.axis.Npz(s)));
-    }
-    
-    
-
-    double py_sq, pz_sqppy_sq;
-    size_t pindlt;
-
-    for (size_t s(0); s < _G.axis.pdim(); ++s) 
-    {
-        pradius.push_back(Array3D<double>(_G.axis.Npx(s),_G.axis.Npy(s),_G.axis.Npz(s)));
-        phi.push_back(Array2D<double>(_G.axis.Npy(s),_G.axis.Npz(s)));  phi[s] = 0.;
-        
-        for (size_t ipy(0); ipy < _G.axis.Npy(s); ++ipy)
-        {
-            py_sq = (_G.axis.py(s))[ipy]*(_G.axis.py(s))[ipy];
-            for (size_t ipz(0); ipz < _G.axis.Npz(s); ++ipz)
-            {
-                pz_sqppy_sq = py_sq + (_G.axis.pz(s))[ipz]*(_G.axis.pz(s))[ipz];
-                for (size_t ipx(0); ipx < _G.axis.Npx(s); ++ipx)
-                {
-
-                    pradius[s](ipx,ipy,ipz) = sqrt((_G.axis.px(s))[ipx]*(_G.axis.px(s))[ipx]+pz_sqppy_sq);
-
-                    if (pradius[s](ipx,ipy,ipz) < _G.axis.pmax(s))
-                    {
-                        
-                        phi[s](ipy,ipz) = (atan2((_G.axis.pz(s))[ipz],(_G.axis.py(s))[ipy]) + M_PI);
-                    }
-                    else
-                    {
-                    }
-                }
-            }       
+    vector<Checkpoint_Set> sets(Y.Species()+1);
+    for (size_t s(0); s < Y.Species(); ++s) {
+        sets[s].name = "f_s" + stringify(s);
+        sets[s].nump = (Y.DF(s))(0).nump();
+        for (size_t nh(0); nh < Y.DF(s).dim(); ++nh) {
+            sets[s].arrays.push_back(&((Y.DF(s))(nh).array().array()[0]));
         }
-        dpx.push_back(_G.axis.dpx(s));
-        dpy.push_back(_G.axis.dpy(s));
-        dpz.push_back(_G.axis.dpz(s));
     }
-        
-}
-//-------------------------------------------------------------
-/**
- * @brief      Destroys the object.
- */
-//-------------------------------------------------------------
-Output_Data::fulldistvsposition::~fulldistvsposition(){
+    sets.back().name = "fields";
+    sets.back().nump = 1;
+    for (size_t ifields(0); ifields < Y.Fields(); ++ifields) {
+        sets.back().arrays.push_back(&(Y.FLD(ifields).array()[0]));
+    }
 
+    return sets;
 }
+//--------------------------------------------------------------
+vector<Export_Files::Restart_Facility::Checkpoint_Set> Export_Files::Restart_Facility::Checkpoint_sets(State2D& Y) {
 
-//-------------------------------------------------------------
-/**
- * @brief      Creates p1 from a 3D grid
- */
-//-------------------------------------------------------------
-valarray<double>  Output_Data::fulldistvsposition::p1(DistFunc1D& df, size_t x0, size_t s) {
-
-    pout1D_p1[s] = 0.0; 
-
-    size_t im(0);
-    for(size_t il = 0; il < grid.l0[s]+1; ++il)
-    {
-
-        size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
-
-
-        vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0)));
-                 
-        tk::spline splSH;
-        splSH.set_points(pvec[s],shdata_real);
-                
-        double YSH_re;
-
-        for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-        {
-            for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-            {
-                for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                {
-                    if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                    {                       
-                        YSH_re = (splSH(pradius[s](ipx,ipy,ipz)));
-                        pout1D_p1[s][ipx] += static_cast<double>(YSH_re * (PL2D[s])(i_dist)(ipx,ipy) * dpy[s][ipy]*dpz[s][ipz]);
-                    }
-                    else pout1D_p1[s][ipx] += 0.;
-                }
-            }
+    vector<Checkpoint_Set> sets(Y.Species()+1);
+    for (size_t s(0); s < Y.Species(); ++s) {
+        sets[s].name = "f_s" + stringify(s);
+        sets[s].nump = (Y.DF(s))(0).nump();
+        for (size_t nh(0); nh < Y.DF(s).dim(); ++nh) {
+            sets[s].arrays.push_back(&((Y.DF(s))(nh).array().array()[0]));
         }
     }
+    sets.back().name = "fields";
+    sets.back().nump = 1;
+    for (size_t ifields(0); ifields < Y.Fields(); ++ifields) {
+        sets.back().arrays.push_back(&(Y.FLD(ifields).array().array()[0]));
+    }
 
-    for (im = 1; im < grid.m0[s]+1; ++im)
-    {
-        for (size_t il(im); il < grid.l0[s]+1; ++il)
-        {
-            vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0)));
-            vector<double> shdata_imag( vdouble_imag(   df(il,im).xVec(x0)));
-                 
-            tk::spline splSH_r, splSH_i;
-            splSH_r.set_points(pvec[s],shdata_real);
-            splSH_i.set_points(pvec[s],shdata_imag);
-
-            size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
-
-            double YSH_re, YSH_im;
-
-            double mphi,calcos,calsin;
-
-            for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-            {
-                for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-                {
-                    for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                    {
-                        mphi = im*phi[s](ipy,ipz);
-                        calcos = cos(mphi);
-                        calsin = sin(mphi);
-
-
-                        if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                        {                       
-                            YSH_re = (splSH_r(pradius[s](ipx,ipy,ipz)));
-                            YSH_im = (splSH_i(pradius[s](ipx,ipy,ipz)));
+    return sets;
+}
+//--------------------------------------------------------------
+//  Where the interior of this node sits in the global grid
+Export_Files::Restart_Facility::Decomposition Export_Files::Restart_Facility::Layout(const Parallel_Environment_1D&) {
 
-                            YSH_re *= calcos; 
-                            YSH_im *= calsin; 
-                            YSH_re -= YSH_im;
+    Decomposition layout;
+    layout.bndx = Input::List().BoundaryCells;
+    layout.numx = Input::List().NxLocal[0];
+    layout.offx = Input::List().NxOffset[0];
+    layout.Nx   = Input::List().NxGlobal[0];
 
-                            pout1D_p1[s][ipx] += static_cast<double>(2.0*(PL2D[s])(i_dist)(ipx,ipy)*YSH_re*dpy[s][ipy]*dpz[s][ipz]);
-                        }
-                        else pout1D_p1[s][ipx] += 0.;
+    layout.bndy = 0;    layout.numy = 1;
+    layout.offy = 0;    layout.Ny   = 1;
 
-                    }
-                }
-            }
-        }
-    }
-    return pout1D_p1[s];    
+    return layout;
 }
-//-------------------------------------------------------------
-valarray<double>  Output_Data::fulldistvsposition::p1(DistFunc2D& df, size_t x0, size_t y0, size_t s) {
+//--------------------------------------------------------------
+Export_Files::Restart_Facility::Decomposition Export_Files::Restart_Facility::Layout(const Parallel_Environment_2D&) {
 
-    pout1D_p1[s] = 0.0; 
-    
+    Decomposition layout;
+    layout.bndx = Input::List().BoundaryCells;
+    layout.numx = Input::List().NxLocal[0];
+    layout.offx = Input::List().NxOffset[0];
+    layout.Nx   = Input::List().NxGlobal[0];
 
+    layout.bndy = Input::List().BoundaryCells;
+    layout.numy = Input::List().NxLocal[1];
+    layout.offy = Input::List().NxOffset[1];
+    layout.Ny   = Input::List().NxGlobal[1];
 
-    size_t im(0);
-    for(size_t il = 0; il < grid.l0[s]+1; ++il)
-    {
+    return layout;
+}
+//--------------------------------------------------------------
+//  Write (or read) the interior of every array of the set to its
+//  slab of the dataset "name" of loc
+void Export_Files::Restart_Facility::Transfer_h5(hid_t loc, const Checkpoint_Set& set, const Decomposition& layout,
+ const bool write, hid_t xfer) {
 
-        size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
+    hsize_t h_local[4] = { layout.numy, layout.numx, set.nump, 2 };
+    hsize_t h_start[4] = { layout.bndy, layout.bndx, 0, 0 };
+    hsize_t h_count[4] = { layout.numy - 2*layout.bndy, layout.numx - 2*layout.bndx, set.nump, 2 };
 
+    hsize_t f_start[5] = { 0, layout.offy, layout.offx, 0, 0 };
+    hsize_t f_count[5] = { 1, h_count[0], h_count[1], set.nump, 2 };
 
-        vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0,y0)));
-                 
-        tk::spline splSH;
-        splSH.set_points(pvec[s],shdata_real);
-                
-        double YSH_re;
+    hid_t dataset(H5Dopen2(loc, set.name.c_str(), H5P_DEFAULT));
+    hid_t filespace(H5Dget_space(dataset));
+    hid_t memspace (H5Screate_simple(4, h_local, NULL));
+    H5Sselect_hyperslab(memspace, H5S_SELECT_SET, h_start, NULL, h_count, NULL);
 
-        for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-        {
-            for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-            {
-                for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                {
-                    if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                    {                       
-                        YSH_re = (splSH(pradius[s](ipx,ipy,ipz)));
-                        pout1D_p1[s][ipx] += static_cast<double>(YSH_re * (PL2D[s])(i_dist)(ipx,ipy) * dpy[s][ipy]*dpz[s][ipz]);
-                    }
-                    else pout1D_p1[s][ipx] += 0.;
-                }
-            }
-        }
+    herr_t status(0);
+    for (size_t ia(0); ia < set.arrays.size(); ++ia) {
+        f_start[0] = ia;
+        H5Sselect_hyperslab(filespace, H5S_SELECT_SET, f_start, NULL, f_count, NULL);
+        double* data((double *) set.arrays[ia]);
+        if (write) status |= H5Dwrite(dataset, H5T_NATIVE_DOUBLE, memspace, filespace, xfer, data);
+        else       status |= H5Dread (dataset, H5T_NATIVE_DOUBLE, memspace, filespace, xfer, data);
     }
 
-    for (im = 1; im < grid.m0[s]+1; ++im)
-    {
-        for (size_t il(im); il < grid.l0[s]+1; ++il)
-        {
-            vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0,y0)));
-            vector<double> shdata_imag( vdouble_imag(   df(il,im).xVec(x0,y0)));
-                 
-            tk::spline splSH_r, splSH_i;
-            splSH_r.set_points(pvec[s],shdata_real);
-            splSH_i.set_points(pvec[s],shdata_imag);
-
-            size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
-
-            double YSH_re, YSH_im;
-
-            double mphi,calcos,calsin;
-
-            for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-            {
-                for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-                {
-                    for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                    {
-                        mphi = im*phi[s](ipy,ipz);
-                        calcos = cos(mphi);
-                        calsin = sin(mphi);
-
-
-                        if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                        {                       
-                            YSH_re = (splSH_r(pradius[s](ipx,ipy,ipz)));
-                            YSH_im = (splSH_i(pradius[s](ipx,ipy,ipz)));
-
-                            YSH_re *= calcos; 
-                            YSH_im *= calsin; 
-                            YSH_re -= YSH_im;
-
-                            pout1D_p1[s][ipx] += static_cast<double>(2.0*(PL2D[s])(i_dist)(ipx,ipy)*YSH_re*dpy[s][ipy]*dpz[s][ipz]);
-                        }
-                        else pout1D_p1[s][ipx] += 0.;
+    H5Sclose(memspace);
+    H5Sclose(filespace);
+    H5Dclose(dataset);
 
-                    }
-                }
-            }
-        }
+    if ((dataset < 0) || (status < 0)) {
+        std::cout << "\n\n ERROR :: Restart dataset " << set.name << " could not be " << (write ? "written" : "read") << " \n\n";
+        exit(1);
     }
-    return pout1D_p1[s];    
 }
+//--------------------------------------------------------------
+//  With parallel HDF5 all the nodes write their slabs in collective
+//  transfers, otherwise they take turns on the file
+void Export_Files::Restart_Facility::Write_h5(const string filename, const vector<Checkpoint_Set>& sets, 
+ const Decomposition& layout, MPI_Comm comm, double time_dump) {
 
-//-------------------------------------------------------------
-/**
- * @brief      Creates p1p2 from a 3D grid
- */
-//-------------------------------------------------------------
-valarray<double>  Output_Data::fulldistvsposition::p2(DistFunc1D& df, size_t x0, size_t s) {
+    int rank, nodes;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &nodes);
 
-    pout1D_p2[s] = 0.0;
-    
+    hid_t fapl(H5Pcreate(H5P_FILE_ACCESS));
+    hid_t xfer(H5Pcreate(H5P_DATASET_XFER));
+#ifdef H5_HAVE_PARALLEL
+    H5Pset_fapl_mpio(fapl, comm, MPI_INFO_NULL);
+    H5Pset_dxpl_mpio(xfer, H5FD_MPIO_COLLECTIVE);
+    int turns(1);
+#else
+    int turns(nodes);
+#endif
 
+    for (int turn(0); turn < turns; ++turn) {
+        if ((turns == 1) || (turn == rank)) {
 
-    size_t im(0);
-    for(size_t il = 0; il < grid.l0[s]+1; ++il)
-    {
-        size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
-     
-        vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0)));
-                 
-        tk::spline splSH;
-        splSH.set_points(pvec[s],shdata_real);
-                
-        double YSH_re;
+            hid_t file;
+            if (turn == 0) {
+//              The file, the datasets and the time
+                file = H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
 
-        for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-        {
-            for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-            {
-                for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                {
-                    if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                    {                       
-                        YSH_re = (splSH(pradius[s](ipx,ipy,ipz)));
-                        pout1D_p2[s][ipy] += static_cast<double>(YSH_re * (PL2D[s])(i_dist)(ipx,ipy) * dpx[s][ipx]*dpz[s][ipz]);
-                    }
-                    else pout1D_p2[s][ipy] += 0.;
+                for (size_t is(0); is < sets.size(); ++is) {
+                    hsize_t h_dims[5] = { sets[is].arrays.size(), layout.Ny, layout.Nx, sets[is].nump, 2 };
+                    hid_t space(H5Screate_simple(5, h_dims, NULL));
+                    H5Dclose(H5Dcreate2(file, sets[is].name.c_str(), H5T_NATIVE_DOUBLE, space, 
+                                        H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT));
+                    H5Sclose(space);
                 }
-            }
-        }
-    }
-
-    for (im = 1; im < grid.m0[s]+1; ++im)
-    {
-        for (size_t il(im); il < grid.l0[s]+1; ++il)
-        {
-            vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0)));
-            vector<double> shdata_imag( vdouble_imag(   df(il,im).xVec(x0)));
-                 
-            tk::spline splSH_r, splSH_i;
-            splSH_r.set_points(pvec[s],shdata_real);
-            splSH_i.set_points(pvec[s],shdata_imag);
-
-            size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
-
-            double YSH_re, YSH_im;
-
-            double mphi,calcos,calsin;
-
-
-            for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-            {
-                for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-                {
-                    for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                    {
-                        mphi = im*phi[s](ipy,ipz);
-                        calcos = cos(mphi);
-                        calsin = sin(mphi);
-
 
-                        if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                        {                       
-                            YSH_re = (splSH_r(pradius[s](ipx,ipy,ipz)));
-                            YSH_im = (splSH_i(pradius[s](ipx,ipy,ipz)));
-
-                            YSH_re *= calcos; 
-                            YSH_im *= calsin; 
-                            YSH_re -= YSH_im;
-
-                            pout1D_p2[s][ipy] += static_cast<double>(2.0*(PL2D[s])(i_dist)(ipx,ipy)*YSH_re* dpx[s][ipx]*dpz[s][ipz]);
-                        }
-                        else pout1D_p2[s][ipy] += 0.;
-
-                    }
-                }
+                hid_t scalar(H5Screate(H5S_SCALAR));
+                hid_t attr(H5Acreate2(file, "time", H5T_NATIVE_DOUBLE, scalar, H5P_DEFAULT, H5P_DEFAULT));
+                H5Awrite(attr, H5T_NATIVE_DOUBLE, &time_dump);
+                H5Aclose(attr);
+                H5Sclose(scalar);
             }
-        }
-    }
-
-    return pout1D_p2[s];    
-}
-//-------------------------------------------------------------
-/**
- * @brief      Creates p1p2 from a 3D grid
- */
-//-------------------------------------------------------------
-valarray<double>  Output_Data::fulldistvsposition::p2(DistFunc2D& df, size_t x0, size_t y0, size_t s) {
-
-    pout1D_p2[s] = 0.0; 
-    
-
-    size_t im(0);
-    for(size_t il = 0; il < grid.l0[s]+1; ++il)
-    {
-        size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
-     
-        vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0,y0)));
-                 
-        tk::spline splSH;
-        splSH.set_points(pvec[s],shdata_real);
-                
-        double YSH_re;
+            else file = H5Fopen(filename.c_str(), H5F_ACC_RDWR, fapl);
 
-        for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-        {
-            for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-            {
-                for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                {
-                    if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                    {                       
-                        YSH_re = (splSH(pradius[s](ipx,ipy,ipz)));
-                        pout1D_p2[s][ipy] += static_cast<double>(YSH_re * (PL2D[s])(i_dist)(ipx,ipy) * dpx[s][ipx]*dpz[s][ipz]);
-                    }
-                    else pout1D_p2[s][ipy] += 0.;
-                }
+            if (file < 0) {
+                std::cout << "\n\n ERROR :: " << filename << " could not be written \n\n";
+                exit(1);
             }
-        }
-    }
-
-    for (im = 1; im < grid.m0[s]+1; ++im)
-    {
-        for (size_t il(im); il < grid.l0[s]+1; ++il)
-        {
-            vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0,y0)));
-            vector<double> shdata_imag( vdouble_imag(   df(il,im).xVec(x0,y0)));
-                 
-            tk::spline splSH_r, splSH_i;
-            splSH_r.set_points(pvec[s],shdata_real);
-            splSH_i.set_points(pvec[s],shdata_imag);
-
-            size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
-
-            double YSH_re, YSH_im;
-
-            double mphi,calcos,calsin;
-
-
-            for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-            {
-                for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-                {
-                    for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                    {
-                        mphi = im*phi[s](ipy,ipz);
-                        calcos = cos(mphi);
-                        calsin = sin(mphi);
 
+            for (size_t is(0); is < sets.size(); ++is) Transfer_h5(file, sets[is], layout, true, xfer);
 
-                        if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                        {                       
-                            YSH_re = (splSH_r(pradius[s](ipx,ipy,ipz)));
-                            YSH_im = (splSH_i(pradius[s](ipx,ipy,ipz)));
-
-                            YSH_re *= calcos; 
-                            YSH_im *= calsin; 
-                            YSH_re -= YSH_im;
-
-                            pout1D_p2[s][ipy] += static_cast<double>(2.0*(PL2D[s])(i_dist)(ipx,ipy)*YSH_re* dpx[s][ipx]*dpz[s][ipz]);
-                        }
-                        else pout1D_p2[s][ipy] += 0.;
-
-                    }
-                }
-            }
+            H5Fclose(file);
         }
+        if (turns > 1) MPI_Barrier(comm);
     }
 
-    return pout1D_p2[s];    
+    H5Pclose(xfer);
+    H5Pclose(fapl);
 }
-//-------------------------------------------------------------
-/**
- * @brief      Creates p1p2 from a 3D grid
- */
-//-------------------------------------------------------------
-valarray<double>  Output_Data::fulldistvsposition::p3(DistFunc1D& df, size_t x0, size_t s) {
+//--------------------------------------------------------------
+//  Every node checks the global shape and reads its own slabs
+double Export_Files::Restart_Facility::Read_h5(const string filename, const vector<Checkpoint_Set>& sets, 
+ const Decomposition& layout, MPI_Comm comm) {
 
-    pout1D_p3[s] = 0.0; 
-    
-    size_t im(0);
-    for(size_t il = 0; il < grid.l0[s]+1; ++il)
-    {
+    hid_t fapl(H5Pcreate(H5P_FILE_ACCESS));
+    hid_t xfer(H5Pcreate(H5P_DATASET_XFER));
+#ifdef H5_HAVE_PARALLEL
+    H5Pset_fapl_mpio(fapl, comm, MPI_INFO_NULL);
+    H5Pset_dxpl_mpio(xfer, H5FD_MPIO_COLLECTIVE);
+#endif
 
-        size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
+    int rank;
+    MPI_Comm_rank(comm, &rank);
 
+    hid_t file;
+    H5E_BEGIN_TRY {
+        file = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, fapl);
+    } H5E_END_TRY;
 
-        vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0)));
-                 
-        tk::spline splSH;
-        splSH.set_points(pvec[s],shdata_real);
-                
-        double YSH_re;
+    if (file < 0) {
+        if (!rank) std::cout << "\n\n ERROR :: No files to read! \n\n";
+        exit(1);
+    }
 
-        for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-        {
-            for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-            {
-                for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                {
-                    if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                    {                       
-                        YSH_re = (splSH(pradius[s](ipx,ipy,ipz)));
-                        pout1D_p3[s][ipz] += static_cast<double>(YSH_re * (PL2D[s])(i_dist)(ipx,ipy) * dpx[s][ipx]*dpy[s][ipy]);
-                    }
-                    else pout1D_p3[s][ipz] += 0.;
-                }
+    for (size_t is(0); is < sets.size(); ++is) {
+        hsize_t h_dims[5] = { sets[is].arrays.size(), layout.Ny, layout.Nx, sets[is].nump, 2 };
+        hsize_t f_dims[5] = { 0, 0, 0, 0, 0 };
+
+        bool match(false);
+        H5E_BEGIN_TRY {
+            hid_t dataset(H5Dopen2(file, sets[is].name.c_str(), H5P_DEFAULT));
+            if (dataset >= 0) {
+                hid_t space(H5Dget_space(dataset));
+                match = (H5Sget_simple_extent_ndims(space) == 5);
+                if (match) H5Sget_simple_extent_dims(space, f_dims, NULL);
+                H5Sclose(space);
+                H5Dclose(dataset);
             }
+        } H5E_END_TRY;
+        for (size_t d(0); match && d < 5; ++d) match = (f_dims[d] == h_dims[d]);
+
+        if (!match) {
+            std::cout << "\n\n ERROR :: " << sets[is].name << " of " << filename << " does not match the global grid \n\n";
+            exit(1);
         }
-    }
 
-    for (im = 1; im < grid.m0[s]+1; ++im)
-    {
-        for (size_t il(im); il < grid.l0[s]+1; ++il)
-        {
-            vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0)));
-            vector<double> shdata_imag( vdouble_imag(   df(il,im).xVec(x0)));
-                 
-            tk::spline splSH_r, splSH_i;
-            splSH_r.set_points(pvec[s],shdata_real);
-            splSH_i.set_points(pvec[s],shdata_imag);
+        Transfer_h5(file, sets[is], layout, false, xfer);
+    }
 
-            size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
+    double time_start(0.0);
+    hid_t attr(H5Aopen(file, "time", H5P_DEFAULT));
+    H5Aread(attr, H5T_NATIVE_DOUBLE, &time_start);
+    H5Aclose(attr);
 
-            double YSH_re, YSH_im;
+    H5Fclose(file);
+    H5Pclose(xfer);
+    H5Pclose(fapl);
 
-            double mphi,calcos,calsin;
+    return time_start;
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+//  Name of the single restart file
+string Export_Files::Restart_Facility::rH5extension(const size_t rstep){
+    stringstream sFilename;
 
-            for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-            {
-                for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-                {
-                    for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                    {
-                        mphi = im*phi[s](ipy,ipz);
-                        calcos = cos(mphi);
-                        calsin = sin(mphi);
+    // Number of zeros to add to the filename
+    int Nzeros(ofconventions::rfile_digits - stringify(rstep).length());
+    while (Nzeros-- > 0) {
+        sFilename << "0";
+    }
 
+    sFilename << rstep << ofconventions::h5file_extension;
 
-                        if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                        {                       
-                            YSH_re = (splSH_r(pradius[s](ipx,ipy,ipz)));
-                            YSH_im = (splSH_i(pradius[s](ipx,ipy,ipz)));
+    return sFilename.str();
+}
+//--------------------------------------------------------------
+//  Adjust filenames with zeros to reach some prescribed length. 
+//  Add the filename extension. 
+string Export_Files::Restart_Facility::rFextension(const int rank, const size_t rstep){
+    stringstream sFilename;
 
-                            YSH_re *= calcos; 
-                            YSH_im *= calsin; 
-                            YSH_re -= YSH_im;
+    // Number of zeros to add to the filename
+    int Nzeros(ofconventions::rank_digits - stringify(rank).length());
+    while (Nzeros-- > 0) {
+        sFilename << "0";
+    }
 
-                            pout1D_p3[s][ipz] += static_cast<double>(2.0*(PL2D[s])(i_dist)(ipx,ipy)*YSH_re* dpx[s][ipx]*dpy[s][ipy]);
-                        }
-                        else pout1D_p3[s][ipz] += 0.;
+    sFilename << rank << "_";
 
-                    }
-                }
-            }
-        }
+    // Number of zeros to add to the filename
+    Nzeros = ofconventions::rfile_digits - stringify(rstep).length();
+    while (Nzeros-- > 0) {
+        sFilename << "0";
     }
 
-    return pout1D_p3[s];    
-}
-//-------------------------------------------------------------
-/**
- * @brief      Creates p1p2 from a 3D grid
- */
-//-------------------------------------------------------------
-valarray<double>  Output_Data::fulldistvsposition::p3(DistFunc2D& df, size_t x0, size_t y0, size_t s) {
-
-    pout1D_p3[s] = 0.;
-    
-    size_t im(0);
-    for(size_t il = 0; il < grid.l0[s]+1; ++il)
-    {
+    sFilename << rstep << ofconventions::rfile_extension;
 
-        size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
+    return sFilename.str();
+}
+//--------------------------------------------------------------
+//**************************************************************
 
+//**************************************************************
+//--------------------------------------------------------------
+Output_Data::PLegendre2D::PLegendre2D( size_t Nl, size_t Nm,
+    double pmax, valarray<double> px, valarray<double> py){
 
-        vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0,y0)));
-                 
-        tk::spline splSH;
-        splSH.set_points(pvec[s],shdata_real);
-                
-        double YSH_re;
+    size_t sz(((Nm+1)*(2*Nl-Nm+2))/2);
 
-        for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-        {
-            for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-            {
-                for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                {
-                    if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                    {                       
-                        YSH_re = (splSH(pradius[s](ipx,ipy,ipz)));
-                        pout1D_p3[s][ipz] += static_cast<double>(YSH_re * (PL2D[s])(i_dist)(ipx,ipy) * dpx[s][ipx]*dpy[s][ipy]);
-                    }
-                    else pout1D_p3[s][ipz] += 0.;
-                }
-            }
-        }
+//  Generate the structure to save the polynomials
+    for (size_t i(0);i < sz; ++i)
+    {
+        plegendre.push_back(Array2D<double>(px.size(),py.size()));
     }
-
-    for (im = 1; im < grid.m0[s]+1; ++im)
+    
+//  Generate the polynomial values for each cos(theta) = px/p 
+    if (Nl > 1)
     {
-        for (size_t il(im); il < grid.l0[s]+1; ++il)
-        {
-            vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0,y0)));
-            vector<double> shdata_imag( vdouble_imag(   df(il,im).xVec(x0,y0)));
-                 
-            tk::spline splSH_r, splSH_i;
-            splSH_r.set_points(pvec[s],shdata_real);
-            splSH_i.set_points(pvec[s],shdata_imag);
+        for (size_t ipy(0); ipy < py.size(); ++ipy) {
 
-            size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
+            for (size_t ipx(0); ipx < px.size(); ++ipx) {
 
-            double YSH_re, YSH_im;
+                double invp(sqrt(py[ipy] * py[ipy] + px[ipx] * px[ipx]));
 
-            double mphi,calcos,calsin;
+                if (invp > pmax) invp = 0;
+                if (invp > 0.0) invp = 1.0 / invp;
 
-            for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-            {
-                for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
+    //          For given px/p generate all the polynomial values ...
+                Array2D<double> vL(Algorithms::Legendre(static_cast<double>(px[ipx]) * invp, Nl, Nm));
+                //          ... and save them
+                size_t k(0);
+                for (size_t l(0); l < Nl + 1; ++l) 
                 {
-                    for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
+                    for (size_t m(0); m < ((Nm < l) ? Nm : l) + 1; ++m) 
                     {
-                        mphi = im*phi[s](ipy,ipz);
-                        calcos = cos(mphi);
-                        calsin = sin(mphi);
-
-
-                        if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                        {                       
-                            YSH_re = (splSH_r(pradius[s](ipx,ipy,ipz)));
-                            YSH_im = (splSH_i(pradius[s](ipx,ipy,ipz)));
-
-                            YSH_re *= calcos; 
-                            YSH_im *= calsin; 
-                            YSH_re -= YSH_im;
-
-                            pout1D_p3[s][ipz] += static_cast<double>(2.0*(PL2D[s])(i_dist)(ipx,ipy)*YSH_re* dpx[s][ipx]*dpy[s][ipy]);
-                        }
-                        else pout1D_p3[s][ipz] += 0.;
-
+                        (plegendre)[k](ipx, ipy) = vL(l, m);
+                        ++k;
                     }
                 }
             }
         }
     }
-
-    return pout1D_p3[s];    
 }
-//-------------------------------------------------------------
-/**
- * @brief      Creates p1p2 from a 3D grid
- */
-//-------------------------------------------------------------
-Array2D<double>  Output_Data::fulldistvsposition::p1p2(DistFunc1D& df, size_t x0, size_t s) {
-
-    pout2D_p1p2[s] = 0.0; 
-    size_t im(0);
-
-    for(size_t il = 0; il < grid.l0[s]+1; ++il)
-    {
-
-        size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
-
-
-        vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0)));
-                 
-        tk::spline splSH;
-        splSH.set_points(pvec[s],shdata_real);
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-        double YSH_re;                   
-        for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-        {
-            for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-            {
-                for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                {
+Output_Data::PLegendre2D::PLegendre2D( const PLegendre2D& other ) {
 
-                    if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                    {                       
-                        YSH_re = (splSH(pradius[s](ipx,ipy,ipz)));
-                        pout2D_p1p2[s](ipx,ipy) += static_cast<double>(YSH_re * (PL2D[s])(i_dist)(ipx,ipy) * dpz[s][ipz]);
-                    }
-                    else pout2D_p1p2[s](ipx,ipy) += 0.;
-                }
-            }
-        }
+//  Generate the structure to save the polynomials
+    for (size_t i(0); i < other.dim(); ++i) {
+        (plegendre).push_back( other(i) );
     }
+}
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-    for (im = 1; im < grid.m0[s]+1; ++im)
-    {
-        for (size_t il(im); il < grid.l0[s]+1; ++il)
-        {
-
-            vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0)));
-            vector<double> shdata_imag( vdouble_imag(   df(il,im).xVec(x0)));
-                 
-            tk::spline splSH_r, splSH_i;
-            splSH_r.set_points(pvec[s],shdata_real);
-            splSH_i.set_points(pvec[s],shdata_imag);
+Output_Data::PLegendre2D::~PLegendre2D(){
+}
+//--------------------------------------------------------------
 
-            size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
+//**************************************************************
+//--------------------------------------------------------------
+Output_Data::harmonicvsposition::harmonicvsposition(const Grid_Info& _G) {
 
-            double YSH_re, YSH_im;
+//  Generate the required structures
+    for (size_t s(0); s < _G.axis.pdim(); ++s) {
+        pmax.push_back( static_cast<double>(_G.axis.pmax(s)) );
+        pmin.push_back( static_cast<double>(_G.axis.pmin(s)) );
+        nump.push_back( static_cast<double>(_G.axis.Np(s))   );
+    }
+}
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-            double mphi,calcos,calsin;
+Output_Data::harmonicvsposition::harmonicvsposition( const harmonicvsposition& other) {
 
+    for (size_t s(0); s < other.Species(); ++s) {
+        pmin.push_back( other.Pmin(s) );
+        pmax.push_back( other.Pmax(s) );
+        nump.push_back( other.Np(s)   );
+    }
+}
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-            for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-            {
-                for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-                {
-                    for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                    {
-                        mphi = im*phi[s](ipy,ipz);
-                        calcos = cos(mphi);
-                        calsin = sin(mphi);
+Output_Data::harmonicvsposition::~harmonicvsposition(){
 
+}
+//-------------------------------------------------------------
+//--------------------------------------------------------------
+//  Turn the Distribution function at some spatial location x0 
+//  into a cartesian grid.
+Array2D<double>  Output_Data::harmonicvsposition::operator()(DistFunc1D& df, size_t l, size_t m, size_t x0, size_t s) {
+    
+    Array2D<double> fx1(Np(s),2); 
 
-                        if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                        {                       
-                            YSH_re = (splSH_r(pradius[s](ipx,ipy,ipz)));
-                            YSH_im = (splSH_i(pradius[s](ipx,ipy,ipz)));
+    for (size_t ip(0); ip < Np(s); ++ip) {
+        //  At each location in |p|
+        fx1(ip,0) = static_cast<double>( (df(l,m))(ip,x0).real() );
+        fx1(ip,1) = static_cast<double>( (df(l,m))(ip,x0).imag() );
+    }
 
-                            YSH_re *= calcos; 
-                            YSH_im *= calsin; 
-                            YSH_re -= YSH_im;
+    return fx1;
+}
 
-                            pout2D_p1p2[s](ipx,ipy) += static_cast<double>(2.0*(PL2D[s])(i_dist)(ipx,ipy)*YSH_re * dpz[s][ipz]);
-                        }
-                        else pout2D_p1p2[s](ipx,ipy) += 0.;
+Array2D<double>  Output_Data::harmonicvsposition::operator()(DistFunc2D& df, size_t l, size_t m, size_t x0, size_t y0, size_t s) {
+    
+    Array2D<double> fx1(Np(s),2); 
 
-                    }
-                }
-            }
-        }
+    for (size_t ip(0); ip < Np(s); ++ip) {
+        //  At each location in |p|
+        fx1(ip,0) = static_cast<double>( (df(l,m))(ip,x0,y0).real() );
+        fx1(ip,1) = static_cast<double>( (df(l,m))(ip,x0,y0).imag() );
     }
 
-    return pout2D_p1p2[s];    
+    return fx1;
 }
-//-------------------------------------------------------------
-/**
- * @brief      Creates p1p2 from a 3D grid
- */
-//-------------------------------------------------------------
-Array2D<double>  Output_Data::fulldistvsposition::p1p2(DistFunc2D& df, size_t x0,  size_t y0, size_t s) {
-
-    pout2D_p1p2[s] = 0.0; 
-    size_t im(0);
-    for(size_t il = 0; il < grid.l0[s]+1; ++il)
-    {
+//--------------------------------------------------------------
+//**************************************************************
 
-        size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
+//**************************************************************
+//--------------------------------------------------------------
+Output_Data::fulldistvsposition::fulldistvsposition( const Grid_Info& _G): grid(_G) 
+{
+    
+    //  Generate the required structures
+    for (size_t s(0); s < _G.axis.pdim(); ++s) {
+        pvec.push_back(valtovec(_G.axis.p(s)));
+        
+        pxvec.push_back(_G.axis.px(s));
+        pyvec.push_back(_G.axis.py(s));
+        pzvec.push_back(_G.axis.pz(s));
 
+        PL2D.push_back( PLegendre2D( _G.l0[s], _G.m0[s],
+          (_G.axis.pmax(s)), _G.axis.px(s), _G.axis.py(s) ) );  
+    }
+    
+    
 
-        vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0,y0)));
-                 
-        tk::spline splSH;
-        splSH.set_points(pvec[s],shdata_real);
+    double py_sq, pz_sqppy_sq;
 
-        double YSH_re;
-                        
-        for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
+    for (size_t s(0); s < _G.axis.pdim(); ++s) 
+    {
+        pradius.push_back(Array3D<double>(_G.axis.Npx(s),_G.axis.Npy(s),_G.axis.Npz(s)));
+        phi.push_back(Array2D<double>(_G.axis.Npy(s),_G.axis.Npz(s)));  phi[s] = 0.;
+        
+        for (size_t ipy(0); ipy < _G.axis.Npy(s); ++ipy)
         {
-            for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
+            py_sq = (_G.axis.py(s))[ipy]*(_G.axis.py(s))[ipy];
+            for (size_t ipz(0); ipz < _G.axis.Npz(s); ++ipz)
             {
-                for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
+                pz_sqppy_sq = py_sq + (_G.axis.pz(s))[ipz]*(_G.axis.pz(s))[ipz];
+                for (size_t ipx(0); ipx < _G.axis.Npx(s); ++ipx)
                 {
 
-                    if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                    {                       
-                        YSH_re = (splSH(pradius[s](ipx,ipy,ipz)));
-                        pout2D_p1p2[s](ipx,ipy) += static_cast<double>(YSH_re * (PL2D[s])(i_dist)(ipx,ipy) * dpz[s][ipz]);
+                    pradius[s](ipx,ipy,ipz) = sqrt((_G.axis.px(s))[ipx]*(_G.axis.px(s))[ipx]+pz_sqppy_sq);
+
+                    if (pradius[s](ipx,ipy,ipz) < _G.axis.pmax(s))
+                    {
+                        
+                        phi[s](ipy,ipz) = (atan2((_G.axis.pz(s))[ipz],(_G.axis.py(s))[ipy]) + M_PI);
                     }
-                    else pout2D_p1p2[s](ipx,ipy) += 0.;
                 }
-            }
+            }       
         }
+        dpx.push_back(_G.axis.dpx(s));
+        dpy.push_back(_G.axis.dpy(s));
+        dpz.push_back(_G.axis.dpz(s));
     }
 
-    for (im = 1; im < grid.m0[s]+1; ++im)
+    //  Interpolation matrix: the Cartesian points inside pmax, the
+    //  interval of the |p| grid they fall in and the offset from its
+    //  left node, as in tk::spline
+    for (size_t s(0); s < _G.axis.pdim(); ++s) 
     {
-        for (size_t il(im); il < grid.l0[s]+1; ++il)
-        {
+        const vector<double>& x(pvec[s]);
+        size_t n(x.size());
 
-            vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0,y0)));
-            vector<double> shdata_imag( vdouble_imag(   df(il,im).xVec(x0,y0)));
-                 
-            tk::spline splSH_r, splSH_i;
-            splSH_r.set_points(pvec[s],shdata_real);
-            splSH_i.set_points(pvec[s],shdata_imag);
-
-            size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
-
-            double YSH_re, YSH_im;
-
-            double mphi,calcos,calsin;
-
-
-            for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
+        points.push_back(vector<Spline_Point>());
+        for (size_t ipx(0); ipx < _G.axis.Npx(s); ++ipx)
+        {
+            for (size_t ipy(0); ipy < _G.axis.Npy(s); ++ipy)
             {
-                for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
+                for (size_t ipz(0); ipz < _G.axis.Npz(s); ++ipz)
                 {
-                    for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                    {
-                        mphi = im*phi[s](ipy,ipz);
-                        calcos = cos(mphi);
-                        calsin = sin(mphi);
-
+                    double r(pradius[s](ipx,ipy,ipz));
+                    if (r > _G.axis.pmax(s)) continue;
 
-                        if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                        {                       
-                            YSH_re = (splSH_r(pradius[s](ipx,ipy,ipz)));
-                            YSH_im = (splSH_i(pradius[s](ipx,ipy,ipz)));
+                    Spline_Point pt;
+                    pt.ipx = ipx; pt.ipy = ipy; pt.ipz = ipz;
+                    pt.j   = std::max( int(std::lower_bound(x.begin(), x.end(), r) - x.begin()) - 1, 0);
+                    pt.h   = r - x[pt.j];
+                    pt.ha  = (r < x[0]) ? 0.0 : pt.h;    // quadratic extrapolation below p0
+                    points[s].push_back(pt);
+                }
+            }
+        }
 
-                            YSH_re *= calcos; 
-                            YSH_im *= calsin; 
-                            YSH_re -= YSH_im;
+    //  Natural spline system, the Thomas factors only depend on |p|
+        lower.push_back(vector<double>(n, 0.0));
+        upper.push_back(vector<double>(n, 0.0));
+        pivot.push_back(vector<double>(n, 0.0));
 
-                            pout2D_p1p2[s](ipx,ipy) += static_cast<double>(2.0*(PL2D[s])(i_dist)(ipx,ipy)*YSH_re * dpz[s][ipz]);
-                        }
-                        else pout2D_p1p2[s](ipx,ipy) += 0.;
+        pivot[s][0] = 2.0;
+        for (size_t i(1); i < n-1; ++i) {
+            lower[s][i] = 1.0/3.0*(x[i]-x[i-1]);
+            upper[s][i] = 1.0/3.0*(x[i+1]-x[i]);
+            pivot[s][i] = 2.0/3.0*(x[i+1]-x[i-1]) - lower[s][i] * upper[s][i-1] / pivot[s][i-1];
+        }
+        pivot[s][n-1] = 2.0;
 
-                    }
-                }
+    //  Trigonometric factors of the harmonics, cos(m phi) and sin(m phi)
+        cosmphi.push_back(vector< Array2D<double> >());
+        sinmphi.push_back(vector< Array2D<double> >());
+        for (size_t im(0); im < _G.m0[s]+1; ++im) {
+            cosmphi[s].push_back(Array2D<double>(_G.axis.Npy(s),_G.axis.Npz(s)));
+            sinmphi[s].push_back(Array2D<double>(_G.axis.Npy(s),_G.axis.Npz(s)));
+            for (size_t i(0); i < phi[s].dim(); ++i) {
+                cosmphi[s][im](i) = cos(im*phi[s](i));
+                sinmphi[s][im](i) = sin(im*phi[s](i));
             }
         }
     }
-
-    return pout2D_p1p2[s];    
+        
 }
 //-------------------------------------------------------------
 /**
- * @brief      Creates p2p3 from a 3D grid
+ * @brief      Destroys the object.
  */
 //-------------------------------------------------------------
-Array2D<double>  Output_Data::fulldistvsposition::p2p3(DistFunc1D& df, size_t x0, size_t s) {
-
-    pout2D_p2p3[s] = 0.0; 
-    size_t im(0);
-    for(size_t il = 0; il < grid.l0[s]+1; ++il)
-    {
+Output_Data::fulldistvsposition::~fulldistvsposition(){
 
-        size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
+}
+//-------------------------------------------------------------
+/**
+ * @brief      Cubic spline of y on the |p| grid, natural boundaries. 
+ *             Same coefficients as tk::spline, solved with the
+ *             precomputed Thomas factors
+ */
+//-------------------------------------------------------------
+void Output_Data::fulldistvsposition::spline(const size_t s, const vector<double>& y, 
+    vector<double>& a, vector<double>& b, vector<double>& c) {
 
+    const vector<double>& x(pvec[s]);
+    size_t n(x.size());
 
-        vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0)));
-                 
-        tk::spline splSH;
-        splSH.set_points(pvec[s],shdata_real);
+    a.resize(n); b.resize(n); c.resize(n);
 
-        double YSH_re;
-                        
-        for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-        {
-            for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-            {
-                for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                {
-                    if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                    {                       
-                        YSH_re = (splSH(pradius[s](ipx,ipy,ipz)));
-                        pout2D_p2p3[s](ipy,ipz) += static_cast<double>(YSH_re * (PL2D[s])(i_dist)(ipx,ipy) * dpx[s][ipx]);
-                    }
-                    else pout2D_p2p3[s](ipy,ipz) += 0.;
-                }
-            }
-        }
+    b[0] = 0.0;
+    for (size_t i(1); i < n-1; ++i) {
+        b[i]  = (y[i+1]-y[i])/(x[i+1]-x[i]) - (y[i]-y[i-1])/(x[i]-x[i-1]);
+        b[i] -= lower[s][i] * b[i-1] / pivot[s][i-1];
     }
+    b[n-1] = 0.0;
 
-    for (im = 1; im < grid.m0[s]+1; ++im)
-    {
-        for (size_t il(im); il < grid.l0[s]+1; ++il)
-        {
-
-            vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0)));
-            vector<double> shdata_imag( vdouble_imag(   df(il,im).xVec(x0)));
-                 
-            tk::spline splSH_r, splSH_i;
-            splSH_r.set_points(pvec[s],shdata_real);
-            splSH_i.set_points(pvec[s],shdata_imag);
-
-            size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
-
-            double YSH_re, YSH_im;
-
-            double mphi,calcos,calsin;
-
-            for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-            {
-                for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-                {
-                    for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                    {
-                        mphi = im*phi[s](ipy,ipz);
-                        calcos = cos(mphi);
-                        calsin = sin(mphi);
-
-                        if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                        {                       
-                            YSH_re = (splSH_r(pradius[s](ipx,ipy,ipz)));
-                            YSH_im = (splSH_i(pradius[s](ipx,ipy,ipz)));
-
-                            YSH_re *= calcos; 
-                            YSH_im *= calsin; 
-                            YSH_re -= YSH_im;
-
-                            pout2D_p2p3[s](ipy,ipz) += static_cast<double>(2.0*(PL2D[s])(i_dist)(ipx,ipy)*YSH_re * dpx[s][ipx]);
-                        }
-                        else pout2D_p2p3[s](ipy,ipz) += 0.;
+    for (int i(n-2); i > 0; --i) {
+        b[i] = (b[i] - upper[s][i] * b[i+1]) / pivot[s][i];
+    }
+    b[0] = 0.0;
 
-                    }
-                }
-            }
-        }
+    for (size_t i(0); i < n-1; ++i) {
+        a[i] = 1.0/3.0*(b[i+1]-b[i])/(x[i+1]-x[i]);
+        c[i] = (y[i+1]-y[i])/(x[i+1]-x[i]) - 1.0/3.0*(2.0*b[i]+b[i+1])*(x[i+1]-x[i]);
     }
 
-    return pout2D_p2p3[s];    
+    //  Linear in the last interval and above
+    double h(x[n-1]-x[n-2]);
+    a[n-1] = 0.0;
+    c[n-1] = 3.0*a[n-2]*h*h+2.0*b[n-2]*h+c[n-2];
 }
 //-------------------------------------------------------------
 /**
- * @brief      Creates p2p3 from a 3D grid
+ * @brief      Cartesian projection of the harmonics of one cell.
+ *             The output is indexed by the axes in keep (px = 1,
+ *             py = 2, pz = 4) and integrated over the other ones
  */
 //-------------------------------------------------------------
-Array2D<double>  Output_Data::fulldistvsposition::p2p3(DistFunc2D& df, size_t x0, size_t y0, size_t s) {
+void Output_Data::fulldistvsposition::project(const size_t s, const vector< vector<complex<double> > >& sh,
+    const int keep, double* out) {
 
-    pout2D_p2p3[s] = 0.0; 
-    size_t im(0);
-    for(size_t il = 0; il < grid.l0[s]+1; ++il)
-    {
-
-        size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
-
-
-        vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0,y0)));
-                 
-        tk::spline splSH;
-        splSH.set_points(pvec[s],shdata_real);
+    size_t sx(0), sy(0), sz(0), stride(1);
+    if (keep & 1) { sx = stride; stride *= grid.axis.Npx(s); }
+    if (keep & 2) { sy = stride; stride *= grid.axis.Npy(s); }
+    if (keep & 4) { sz = stride; stride *= grid.axis.Npz(s); }
 
-        double YSH_re;
-                        
-        for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-        {
-            for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-            {
-                for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                {
-                    if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                    {                       
-                        YSH_re = (splSH(pradius[s](ipx,ipy,ipz)));
-                        pout2D_p2p3[s](ipy,ipz) += static_cast<double>(YSH_re * (PL2D[s])(i_dist)(ipx,ipy) * dpx[s][ipx]);
-                    }
-                    else pout2D_p2p3[s](ipy,ipz) += 0.;
-                }
-            }
-        }
-    }
+    vector<double> ydata, ar, br, cr, yi, ai, bi, ci;
 
-    for (im = 1; im < grid.m0[s]+1; ++im)
+    for (size_t im(0); im < grid.m0[s]+1; ++im)
     {
         for (size_t il(im); il < grid.l0[s]+1; ++il)
         {
-
-            vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0,y0)));
-            vector<double> shdata_imag( vdouble_imag(   df(il,im).xVec(x0,y0)));
-                 
-            tk::spline splSH_r, splSH_i;
-            splSH_r.set_points(pvec[s],shdata_real);
-            splSH_i.set_points(pvec[s],shdata_imag);
-
             size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
 
-            double YSH_re, YSH_im;
+            ydata = vdouble_real(sh[i_dist]);
+            spline(s, ydata, ar, br, cr);
+            if (im > 0) {
+                yi = vdouble_imag(sh[i_dist]);
+                spline(s, yi, ai, bi, ci);
+            }
 
-            double mphi,calcos,calsin;
+            Array2D<double>& PL(PL2D[s](i_dist));
+            Array2D<double>& cosm(cosmphi[s][im]);
+            Array2D<double>& sinm(sinmphi[s][im]);
 
-            for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
+            for (size_t ip(0); ip < points[s].size(); ++ip)
             {
-                for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-                {
-                    for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                    {
-                        mphi = im*phi[s](ipy,ipz);
-                        calcos = cos(mphi);
-                        calsin = sin(mphi);
-
-                        if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                        {                       
-                            YSH_re = (splSH_r(pradius[s](ipx,ipy,ipz)));
-                            YSH_im = (splSH_i(pradius[s](ipx,ipy,ipz)));
+                const Spline_Point& pt(points[s][ip]);
 
-                            YSH_re *= calcos; 
-                            YSH_im *= calsin; 
-                            YSH_re -= YSH_im;
-
-                            pout2D_p2p3[s](ipy,ipz) += static_cast<double>(2.0*(PL2D[s])(i_dist)(ipx,ipy)*YSH_re * dpx[s][ipx]);
-                        }
-                        else pout2D_p2p3[s](ipy,ipz) += 0.;
+                double w(PL(pt.ipx,pt.ipy));
+                if (!(keep & 1)) w *= dpx[s][pt.ipx];
+                if (!(keep & 2)) w *= dpy[s][pt.ipy];
+                if (!(keep & 4)) w *= dpz[s][pt.ipz];
 
-                    }
+                double YSH = ((ar[pt.j]*pt.ha + br[pt.j])*pt.h + cr[pt.j])*pt.h + ydata[pt.j];
+                if (im > 0) {
+                    double YSH_im = ((ai[pt.j]*pt.ha + bi[pt.j])*pt.h + ci[pt.j])*pt.h + yi[pt.j];
+                    YSH = 2.0*(YSH*cosm(pt.ipy,pt.ipz) - YSH_im*sinm(pt.ipy,pt.ipz));
                 }
+
+                out[pt.ipx*sx + pt.ipy*sy + pt.ipz*sz] += YSH * w;
             }
         }
     }
-
-    return pout2D_p2p3[s];    
 }
 //-------------------------------------------------------------
-/**
- * @brief      Creates p1p3 from a 3D grid
- */
-//-------------------------------------------------------------
-Array2D<double>  Output_Data::fulldistvsposition::p1p3(DistFunc1D& df, size_t x0, size_t s) {
+void Output_Data::fulldistvsposition::harmonics(DistFunc1D& df, const size_t x0, const size_t s, 
+    vector< vector<complex<double> > >& sh) {
 
-    pout2D_p1p3[s] = 0.0; 
-    size_t im(0);
-    for(size_t il = 0; il < grid.l0[s]+1; ++il)
+    sh.resize(PL2D[s].dim());
+    for (size_t im(0); im < grid.m0[s]+1; ++im)
     {
-
-        size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
-
-
-        vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0)));
-                 
-        tk::spline splSH;
-        splSH.set_points(pvec[s],shdata_real);
-
-        double YSH_re;
-                        
-        for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
+        for (size_t il(im); il < grid.l0[s]+1; ++il)
         {
-            for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-            {
-                for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                {
-                    if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                    {                       
-                        YSH_re = (splSH(pradius[s](ipx,ipy,ipz)));
-                        pout2D_p1p3[s](ipx,ipz) += static_cast<double>(YSH_re * (PL2D[s])(i_dist)(ipx,ipy) * dpy[s][ipy]);
-                    }
-                    else pout2D_p1p3[s](ipx,ipz) += 0.;
-                }
-            }
+            size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
+            sh[i_dist] = df(il,im).xVec(x0);
         }
     }
+}
+//-------------------------------------------------------------
+void Output_Data::fulldistvsposition::harmonics(DistFunc2D& df, const size_t x0, const size_t y0, const size_t s, 
+    vector< vector<complex<double> > >& sh) {
 
-    for (im = 1; im < grid.m0[s]+1; ++im)
+    sh.resize(PL2D[s].dim());
+    for (size_t im(0); im < grid.m0[s]+1; ++im)
     {
         for (size_t il(im); il < grid.l0[s]+1; ++il)
         {
-
-            vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0)));
-            vector<double> shdata_imag( vdouble_imag(   df(il,im).xVec(x0)));
-                 
-            tk::spline splSH_r, splSH_i;
-            splSH_r.set_points(pvec[s],shdata_real);
-            splSH_i.set_points(pvec[s],shdata_imag);
-
             size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
-
-            double YSH_re, YSH_im;
-
-            double mphi,calcos,calsin;
-
-            for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-            {
-                for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-                {
-                    for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                    {
-                        mphi = im*phi[s](ipy,ipz);
-                        calcos = cos(mphi);
-                        calsin = sin(mphi);
-
-
-                        if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                        {                       
-                            YSH_re = (splSH_r(pradius[s](ipx,ipy,ipz)));
-                            YSH_im = (splSH_i(pradius[s](ipx,ipy,ipz)));
-
-                            YSH_re *= calcos; 
-                            YSH_im *= calsin; 
-                            YSH_re -= YSH_im;
-
-                            pout2D_p1p3[s](ipx,ipz) += static_cast<double>(2.0*(PL2D[s])(i_dist)(ipx,ipy)*YSH_re * dpy[s][ipy]);
-                        }
-                        else pout2D_p1p3[s](ipx,ipz) += 0.;
-
-                    }
-                }
-            }
+            sh[i_dist] = df(il,im).xVec(x0,y0);
         }
     }
-
-    return pout2D_p1p3[s];    
 }
 //-------------------------------------------------------------
 /**
- * @brief      Creates p1p3 from a 3D grid
+ * @brief      Creates p1 from a 3D grid
  */
 //-------------------------------------------------------------
-Array2D<double>  Output_Data::fulldistvsposition::p1p3(DistFunc2D& df, size_t x0, size_t y0, size_t s) {
-
-    pout2D_p1p3[s] = 0.0; 
-    size_t im(0);
-    for(size_t il = 0; il < grid.l0[s]+1; ++il)
-    {
-
-        size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
-
-
-        vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0,y0)));
-                 
-        tk::spline splSH;
-        splSH.set_points(pvec[s],shdata_real);
-
-        double YSH_re;
-                        
-        for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-        {
-            for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-            {
-                for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                {
-                    if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                    {                       
-                        YSH_re = (splSH(pradius[s](ipx,ipy,ipz)));
-                        pout2D_p1p3[s](ipx,ipz) += static_cast<double>(YSH_re * (PL2D[s])(i_dist)(ipx,ipy) * dpy[s][ipy]);
-                    }
-                    else pout2D_p1p3[s](ipx,ipz) += 0.;
-                }
-            }
-        }
-    }
-
-    for (im = 1; im < grid.m0[s]+1; ++im)
-    {
-        for (size_t il(im); il < grid.l0[s]+1; ++il)
-        {
-
-            vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0,y0)));
-            vector<double> shdata_imag( vdouble_imag(   df(il,im).xVec(x0,y0)));
-                 
-            tk::spline splSH_r, splSH_i;
-            splSH_r.set_points(pvec[s],shdata_real);
-            splSH_i.set_points(pvec[s],shdata_imag);
-
-            size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
-
-            double YSH_re, YSH_im;
+valarray<double>  Output_Data::fulldistvsposition::p1(DistFunc1D& df, size_t x0, size_t s) {
 
-            double mphi,calcos,calsin;
+    vector< vector<complex<double> > > sh;
+    harmonics(df, x0, s, sh);
 
-            for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-            {
-                for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-                {
-                    for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                    {
-                        mphi = im*phi[s](ipy,ipz);
-                        calcos = cos(mphi);
-                        calsin = sin(mphi);
+    valarray<double> pout(0.0, grid.axis.Npx(s));
+    project(s, sh, 1, &pout[0]);
+    return pout;
+}
+//-------------------------------------------------------------
+valarray<double>  Output_Data::fulldistvsposition::p1(DistFunc2D& df, size_t x0, size_t y0, size_t s) {
 
+    vector< vector<complex<double> > > sh;
+    harmonics(df, x0, y0, s, sh);
 
-                        if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                        {                       
-                            YSH_re = (splSH_r(pradius[s](ipx,ipy,ipz)));
-                            YSH_im = (splSH_i(pradius[s](ipx,ipy,ipz)));
+    valarray<double> pout(0.0, grid.axis.Npx(s));
+    project(s, sh, 1, &pout[0]);
+    return pout;
+}
+//-------------------------------------------------------------
+valarray<double>  Output_Data::fulldistvsposition::p2(DistFunc1D& df, size_t x0, size_t s) {
 
-                            YSH_re *= calcos; 
-                            YSH_im *= calsin; 
-                            YSH_re -= YSH_im;
+    vector< vector<complex<double> > > sh;
+    harmonics(df, x0, s, sh);
 
-                            pout2D_p1p3[s](ipx,ipz) += static_cast<double>(2.0*(PL2D[s])(i_dist)(ipx,ipy)*YSH_re * dpy[s][ipy]);
-                        }
-                        else pout2D_p1p3[s](ipx,ipz) += 0.;
+    valarray<double> pout(0.0, grid.axis.Npy(s));
+    project(s, sh, 2, &pout[0]);
+    return pout;
+}
+//-------------------------------------------------------------
+valarray<double>  Output_Data::fulldistvsposition::p2(DistFunc2D& df, size_t x0, size_t y0, size_t s) {
 
-                    }
-                }
-            }
-        }
-    }
+    vector< vector<complex<double> > > sh;
+    harmonics(df, x0, y0, s, sh);
 
-    return pout2D_p1p3[s];    
+    valarray<double> pout(0.0, grid.axis.Npy(s));
+    project(s, sh, 2, &pout[0]);
+    return pout;
 }
-//--------------------------------------------------------------
-Array3D<double>  Output_Data::fulldistvsposition::p1p2p3(DistFunc1D& df, size_t x0, size_t s){
-//--------------------------------------------------------------
-//  Turn the Distribution function at some spatial location (x0,y0) 
-//  into a cartesian grid.
-//--------------------------------------------------------------
-    pout3D[s] = 0.0;
-    size_t im(0);
-    for(size_t il = 0; il < grid.l0[s]+1; ++il)
-    {
+//-------------------------------------------------------------
+valarray<double>  Output_Data::fulldistvsposition::p3(DistFunc1D& df, size_t x0, size_t s) {
 
-        size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
+    vector< vector<complex<double> > > sh;
+    harmonics(df, x0, s, sh);
 
+    valarray<double> pout(0.0, grid.axis.Npz(s));
+    project(s, sh, 4, &pout[0]);
+    return pout;
+}
+//-------------------------------------------------------------
+valarray<double>  Output_Data::fulldistvsposition::p3(DistFunc2D& df, size_t x0, size_t y0, size_t s) {
 
-        vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0)));
-                 
-        tk::spline splSH;
-        splSH.set_points(pvec[s],shdata_real);
+    vector< vector<complex<double> > > sh;
+    harmonics(df, x0, y0, s, sh);
 
-        double YSH_re;
-                        
-        for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-        {
-            for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-            {
-                for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                {
-                    if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                    {                       
-                        YSH_re = (splSH(pradius[s](ipx,ipy,ipz)));
-                        pout3D[s](ipx,ipy,ipz) += static_cast<double>(YSH_re * (PL2D[s])(i_dist)(ipx,ipy));
-                    }
-                    else pout3D[s](ipx,ipy,ipz) += 0.;
-                }
-            }
-        }
-    }
+    valarray<double> pout(0.0, grid.axis.Npz(s));
+    project(s, sh, 4, &pout[0]);
+    return pout;
+}
+//-------------------------------------------------------------
+/**
+ * @brief      Creates p1p2 from a 3D grid
+ */
+//-------------------------------------------------------------
+Array2D<double>  Output_Data::fulldistvsposition::p1p2(DistFunc1D& df, size_t x0, size_t s) {
 
-    for (im = 1; im < grid.m0[s]+1; ++im)
-    {
-        for (size_t il(im); il < grid.l0[s]+1; ++il)
-        {
+    vector< vector<complex<double> > > sh;
+    harmonics(df, x0, s, sh);
 
-            vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0)));
-            vector<double> shdata_imag( vdouble_imag(   df(il,im).xVec(x0)));
-                 
-            tk::spline splSH_r, splSH_i;
-            splSH_r.set_points(pvec[s],shdata_real);
-            splSH_i.set_points(pvec[s],shdata_imag);
+    Array2D<double> pout(grid.axis.Npx(s),grid.axis.Npy(s));
+    pout = 0.0;
+    project(s, sh, 1|2, &(pout.array()[0]));
+    return pout;
+}
+//-------------------------------------------------------------
+Array2D<double>  Output_Data::fulldistvsposition::p1p2(DistFunc2D& df, size_t x0, size_t y0, size_t s) {
 
-            size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
+    vector< vector<complex<double> > > sh;
+    harmonics(df, x0, y0, s, sh);
 
-            double YSH_re, YSH_im;
+    Array2D<double> pout(grid.axis.Npx(s),grid.axis.Npy(s));
+    pout = 0.0;
+    project(s, sh, 1|2, &(pout.array()[0]));
+    return pout;
+}
+//-------------------------------------------------------------
+Array2D<double>  Output_Data::fulldistvsposition::p2p3(DistFunc1D& df, size_t x0, size_t s) {
 
-            double mphi,calcos,calsin;
+    vector< vector<complex<double> > > sh;
+    harmonics(df, x0, s, sh);
 
+    Array2D<double> pout(grid.axis.Npy(s),grid.axis.Npz(s));
+    pout = 0.0;
+    project(s, sh, 2|4, &(pout.array()[0]));
+    return pout;
+}
+//-------------------------------------------------------------
+Array2D<double>  Output_Data::fulldistvsposition::p2p3(DistFunc2D& df, size_t x0, size_t y0, size_t s) {
 
-            for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-            {
-                for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-                {
-                    for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                    {
-                        mphi = im*phi[s](ipy,ipz);
-                        calcos = cos(mphi);
-                        calsin = sin(mphi);
+    vector< vector<complex<double> > > sh;
+    harmonics(df, x0, y0, s, sh);
 
+    Array2D<double> pout(grid.axis.Npy(s),grid.axis.Npz(s));
+    pout = 0.0;
+    project(s, sh, 2|4, &(pout.array()[0]));
+    return pout;
+}
+//-------------------------------------------------------------
+Array2D<double>  Output_Data::fulldistvsposition::p1p3(DistFunc1D& df, size_t x0, size_t s) {
 
-                        if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-                        {                       
-                            YSH_re = (splSH_r(pradius[s](ipx,ipy,ipz)));
-                            YSH_im = (splSH_i(pradius[s](ipx,ipy,ipz)));
+    vector< vector<complex<double> > > sh;
+    harmonics(df, x0, s, sh);
 
-                            YSH_re *= calcos; 
-                            YSH_im *= calsin; 
-                            YSH_re -= YSH_im;
+    Array2D<double> pout(grid.axis.Npx(s),grid.axis.Npz(s));
+    pout = 0.0;
+    project(s, sh, 1|4, &(pout.array()[0]));
+    return pout;
+}
+//-------------------------------------------------------------
+Array2D<double>  Output_Data::fulldistvsposition::p1p3(DistFunc2D& df, size_t x0, size_t y0, size_t s) {
 
-                            pout3D[s](ipx,ipy,ipz) += static_cast<double>(2.0*(PL2D[s])(i_dist)(ipx,ipy)*YSH_re);//*dpy[s]*dpz[s];
-                        }
-                        else pout3D[s](ipx,ipy,ipz) += 0.;
+    vector< vector<complex<double> > > sh;
+    harmonics(df, x0, y0, s, sh);
 
-                    }
-                }
-            }
-        }
-    }
-    return pout3D[s];
+    Array2D<double> pout(grid.axis.Npx(s),grid.axis.Npz(s));
+    pout = 0.0;
+    project(s, sh, 1|4, &(pout.array()[0]));
+    return pout;
+}
+//-------------------------------------------------------------
+Array3D<double>  Output_Data::fulldistvsposition::p1p2p3(DistFunc1D& df, size_t x0, size_t s){
+//--------------------------------------------------------------
+//  Turn the Distribution function at some spatial location (x0,y0) 
+//  into a cartesian grid.
+//--------------------------------------------------------------
+    vector< vector<complex<double> > > sh;
+    harmonics(df, x0, s, sh);
+
+    Array3D<double> pout(grid.axis.Npx(s),grid.axis.Npy(s),grid.axis.Npz(s));
+    pout = 0.0;
+    project(s, sh, 1|2|4, &(pout.array()[0]));
+    return pout;
 }
 //**************************************************************
 //--------------------------------------------------------------
@@ -2214,6 +1955,10 @@ Array3D<double>  Output_Data::fulldistvsposition::p1p2p3(DistFunc1D& df, size_t
 void Output_Data::Output_Preprocessor::operator()(const State1D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
  const Parallel_Environment_1D& PE) {
 
+    if (Harmonic_Group::Rank()) return;                 //  The first member of a group writes
+
+    expo.Open_step("diagnostics", tout, time, dt, Harmonic_Group::Space());
+
     if (Input::List().o_Ex) {
         Ex( Y, grid, tout, time, dt, PE );
     }
@@ -2310,6 +2055,7 @@ void Output_Data::Output_Preprocessor::operator()(const State1D& Y, const Grid_I
         particles_pz( Y, grid, tout, time, dt, PE );
     }
 
+    expo.Close_step();
 }
 //--------------------------------------------------------------
 //--------------------------------------------------------------
@@ -2318,6 +2064,10 @@ void Output_Data::Output_Preprocessor::distdump(const State1D& Y, const Grid_Inf
    const Parallel_Environment_1D& PE) 
 {
 
+    if (Harmonic_Group::Rank()) return;
+
+    expo.Open_step("distdump", tout, time, dt, Harmonic_Group::Space());
+
     if (Input::List().o_p1x1){
         px( Y, grid, tout, time, dt, PE );
     }
@@ -2341,12 +2091,17 @@ void Output_Data::Output_Preprocessor::distdump(const State1D& Y, const Grid_Inf
         fl0( Y, grid, tout, time, dt, PE );
     }
 
+    expo.Close_step();
 }
 
 void Output_Data::Output_Preprocessor::bigdistdump(const State1D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
    const Parallel_Environment_1D& PE) 
 {
 
+    if (Harmonic_Group::Rank()) return;
+
+    expo.Open_step("bigdistdump", tout, time, dt, Harmonic_Group::Space());
+
     if (Input::List().o_p1p2x1)
     {
         pxpy( Y, grid, tout, time, dt, PE );
@@ -2364,6 +2119,7 @@ void Output_Data::Output_Preprocessor::bigdistdump(const State1D& Y, const Grid_
         // pxpypz( Y, grid, tout, time, dt, PE );
     }
 
+    expo.Close_step();
 }
 //--------------------------------------------------------------
 //--------------------------------------------------------------
@@ -2371,6 +2127,10 @@ void Output_Data::Output_Preprocessor::bigdistdump(const State1D& Y, const Grid_
 void Output_Data::Output_Preprocessor::operator()(const State2D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
  const Parallel_Environment_2D& PE) {
 
+    if (Harmonic_Group::Rank()) return;                 //  The first member of a group writes
+
+    expo.Open_step("diagnostics", tout, time, dt, PE.Comm());
+
     if (Input::List().o_Ex) {
         Ex( Y, grid, tout, time, dt, PE );
     }
@@ -2467,6 +2227,7 @@ void Output_Data::Output_Preprocessor::operator()(const State2D& Y, const Grid_I
     //     particles_pz( Y, grid, tout, time, dt, PE );
     // }
 
+    expo.Close_step();
 }
 //--------------------------------------------------------------
 //--------------------------------------------------------------
@@ -2474,6 +2235,10 @@ void Output_Data::Output_Preprocessor::operator()(const State2D& Y, const Grid_I
 void Output_Data::Output_Preprocessor::distdump(const State2D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
    const Parallel_Environment_2D& PE) 
 {
+
+    if (Harmonic_Group::Rank()) return;
+
+    expo.Open_step("distdump", tout, time, dt, PE.Comm());
     if (Input::List().o_p1x1){
         px( Y, grid, tout, time, dt, PE );
     }
@@ -2496,11 +2261,17 @@ void Output_Data::Output_Preprocessor::distdump(const State2D& Y, const Grid_Inf
     if (Input::List().o_fl0x1){
         fl0( Y, grid, tout, time, dt, PE );
     }
+
+    expo.Close_step();
 }
 
 void Output_Data::Output_Preprocessor::bigdistdump(const State2D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
    const Parallel_Environment_2D& PE) 
 {
+
+    if (Harmonic_Group::Rank()) return;
+
+    expo.Open_step("bigdistdump", tout, time, dt, PE.Comm());
     if (Input::List().o_p1p2x1)
     {
         pxpy( Y, grid, tout, time, dt, PE );
@@ -2517,6 +2288,79 @@ void Output_Data::Output_Preprocessor::bigdistdump(const State2D& Y, const Grid_
     {
         // pxpypz( Y, grid, tout, time, dt, PE );
     }
+
+    expo.Close_step();
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+//  Every node writes the slab [NxOffset, NxOffset+NxLocal) of the
+//  spatial axis, the remaining axes are written whole
+//--------------------------------------------------------------
+void Output_Data::Output_Preprocessor::Export_slab(const std::string tag, vector< vector<double> >& axes, const vector<double>& local, 
+ const Grid_Info& grid, const size_t tout, const double time, const double dt,
+ const Parallel_Environment_1D&, const int spec) {
+
+    size_t Nbc = Input::List().BoundaryCells;
+
+    vector<size_t> offset(axes.size(), 0), count(axes.size());
+    for (size_t d(0); d < axes.size(); ++d) count[d] = axes[d].size();
+
+    count[0]  = grid.axis.Nx(0) - 2*Nbc;
+    offset[0] = Input::List().NxOffset[0];
+
+    expo.Export_h5(tag, axes, &local[0], offset, count, tout, time, dt, Harmonic_Group::Space(), spec);
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+//  Same in 2D, the slab of the node is placed by its coordinates
+//  in the Cartesian topology
+//--------------------------------------------------------------
+void Output_Data::Output_Preprocessor::Export_slab(const std::string tag, vector< vector<double> >& axes, const vector<double>& local, 
+ const Grid_Info& grid, const size_t tout, const double time, const double dt,
+ const Parallel_Environment_2D& PE, const int spec) {
+
+    size_t Nbc = Input::List().BoundaryCells;
+
+    vector<size_t> offset(axes.size(), 0), count(axes.size());
+    for (size_t d(0); d < axes.size(); ++d) count[d] = axes[d].size();
+
+    count[0]  = grid.axis.Nx(0) - 2*Nbc;
+    count[1]  = grid.axis.Nx(1) - 2*Nbc;
+    offset[0] = Input::List().NxOffset[0];
+    offset[1] = Input::List().NxOffset[1];
+
+    expo.Export_h5(tag, axes, &local[0], offset, count, tout, time, dt, PE.Comm(), spec);
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+//  Gather of a momentum projection, the local buffer holds width
+//  values for each cell of the node
+//--------------------------------------------------------------
+bool Output_Data::Output_Preprocessor::Gather_slab(const std::string tag, const vector<double>& local, const size_t width,
+ const Grid_Info& grid, const Parallel_Environment_1D&, const int spec, vector<double>& global) {
+
+    size_t Nbc = Input::List().BoundaryCells;
+
+    vector<size_t> offset(2, 0), count(2), dims(2);
+    count[0]  = grid.axis.Nx(0) - 2*Nbc;      count[1] = width;
+    dims[0]   = grid.axis.Nxg(0);             dims[1]  = width;
+    offset[0] = Input::List().NxOffset[0];
+
+    return expo.Gather(tag, spec, &local[0], offset, count, dims, Harmonic_Group::Space(), global);
+}
+//--------------------------------------------------------------
+bool Output_Data::Output_Preprocessor::Gather_slab(const std::string tag, const vector<double>& local, const size_t width,
+ const Grid_Info& grid, const Parallel_Environment_2D& PE, const int spec, vector<double>& global) {
+
+    size_t Nbc = Input::List().BoundaryCells;
+
+    vector<size_t> offset(3, 0), count(3), dims(3);
+    count[0]  = grid.axis.Nx(0) - 2*Nbc;      count[1] = grid.axis.Nx(1) - 2*Nbc;     count[2] = width;
+    dims[0]   = grid.axis.Nxg(0);             dims[1]  = grid.axis.Nxg(1);            dims[2]  = width;
+    offset[0] = Input::List().NxOffset[0];
+    offset[1] = Input::List().NxOffset[1];
+
+    return expo.Gather(tag, spec, &local[0], offset, count, dims, PE.Comm(), global);
 }
 //--------------------------------------------------------------
 //--------------------------------------------------------------
@@ -2526,47 +2370,22 @@ void Output_Data::Output_Preprocessor::Ex(const State1D& Y, const Grid_Info& gri
  const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); 
     
-    double Exbuf[msg_sz];
-    vector<double> ExGlobal(outNxGlobal,0.);
+    vector<double> Exbuf(msg_sz);
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     for(size_t i(0); i < msg_sz; ++i) {
         Exbuf[i] = static_cast<double>( Y.EMF().Ex()(Nbc+i).real() );
     }
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(Exbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            for(size_t i(0); i < outNxLocal; i++) {
-                ExGlobal[i] = Exbuf[i];
-            }
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                MPI_Recv(Exbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                for(size_t i(0); i < outNxLocal; i++) {
-                    ExGlobal[i + outNxLocal*rr] = Exbuf[i];
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        for(size_t i(0); i < outNxGlobal; i++) {
-            ExGlobal[i] = Exbuf[i];
-        }
-    }
+    vector< vector<double> > axes;
+    axes.push_back(xaxis);
 
-    if (PE.RANK() == 0) expo.Export_h5("Ex", xaxis, ExGlobal, tout, time, dt);
+    Export_slab("Ex", axes, Exbuf, grid, tout, time, dt, PE);
 
 }
 //--------------------------------------------------------------     
@@ -2576,47 +2395,22 @@ void Output_Data::Output_Preprocessor::Ey(const State1D& Y, const Grid_Info& gri
  const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
      
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal);
-    double Eybuf[msg_sz];
+    vector<double> Eybuf(msg_sz);
     
-    vector<double> EyGlobal(outNxGlobal); 
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     for(size_t i(0); i < msg_sz; ++i) {
         Eybuf[i] = static_cast<double>( Y.EMF().Ey()(Nbc+i).real() );
     }
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(Eybuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            for(size_t i(0); i < outNxLocal; i++) {
-                EyGlobal[i] = Eybuf[i];
-            }
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                MPI_Recv(Eybuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                for(size_t i(0); i < outNxLocal; i++) {
-                    EyGlobal[i + outNxLocal*rr] = Eybuf[i];
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        for(size_t i(0); i < outNxGlobal; i++) {
-            EyGlobal[i] = Eybuf[i];
-        }
-    }
+    vector< vector<double> > axes;
+    axes.push_back(xaxis);
 
-    if (PE.RANK() == 0) expo.Export_h5("Ey", xaxis, EyGlobal, tout, time, dt);
+    Export_slab("Ey", axes, Eybuf, grid, tout, time, dt, PE);
 
 }
 //--------------------------------------------------------------     
@@ -2626,47 +2420,22 @@ void Output_Data::Output_Preprocessor::Ez(const State1D& Y, const Grid_Info& gri
  const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
      
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal);
-    double Ezbuf[msg_sz];
+    vector<double> Ezbuf(msg_sz);
     
-    vector<double> EzGlobal(outNxGlobal);
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     for(size_t i(0); i < msg_sz; ++i) {
         Ezbuf[i] = static_cast<double>( Y.EMF().Ez()(Nbc+i).real() );
     }
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(Ezbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            for(size_t i(0); i < outNxLocal; i++) {
-                EzGlobal[i] = Ezbuf[i];
-            }
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                MPI_Recv(Ezbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                for(size_t i(0); i < outNxLocal; i++) {
-                    EzGlobal[i + outNxLocal*rr] = Ezbuf[i];
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        for(size_t i(0); i < outNxGlobal; i++) {
-            EzGlobal[i] = Ezbuf[i];
-        }
-    }
+    vector< vector<double> > axes;
+    axes.push_back(xaxis);
 
-    if (PE.RANK() == 0) expo.Export_h5("Ez", xaxis, EzGlobal, tout, time, dt);
+    Export_slab("Ez", axes, Ezbuf, grid, tout, time, dt, PE);
 
 
 }
@@ -2677,46 +2446,21 @@ void Output_Data::Output_Preprocessor::Bx(const State1D& Y, const Grid_Info& gri
  const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
      
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
-    double Bxbuf[msg_sz];
-    vector<double> BxGlobal(outNxGlobal);
+    vector<double> Bxbuf(msg_sz);
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     for(size_t i(0); i < msg_sz; ++i) {
         Bxbuf[i] = static_cast<double>( Y.EMF().Bx()(Nbc+i).real() );
     }
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(Bxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            for(size_t i(0); i < outNxLocal; i++) {
-                BxGlobal[i] = Bxbuf[i];
-            }
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                MPI_Recv(Bxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                for(size_t i(0); i < outNxLocal; i++) {
-                    BxGlobal[i + outNxLocal*rr] = Bxbuf[i];
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        for(size_t i(0); i < outNxGlobal; i++) {
-            BxGlobal[i] = Bxbuf[i];
-        }
-    }
+    vector< vector<double> > axes;
+    axes.push_back(xaxis);
 
-    if (PE.RANK() == 0) expo.Export_h5("Bx", xaxis, BxGlobal, tout, time, dt);
+    Export_slab("Bx", axes, Bxbuf, grid, tout, time, dt, PE);
 
 }
 //--------------------------------------------------------------     
@@ -2726,46 +2470,21 @@ void Output_Data::Output_Preprocessor::By(const State1D& Y, const Grid_Info& gri
  const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
      
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
-    double Bybuf[msg_sz];
-    vector<double> ByGlobal(outNxGlobal);
+    vector<double> Bybuf(msg_sz);
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     for(size_t i(0); i < msg_sz; ++i) {
         Bybuf[i] = static_cast<double>( Y.EMF().By()(Nbc+i).real() );
     }
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(Bybuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            for(size_t i(0); i < outNxLocal; i++) {
-                ByGlobal[i] = Bybuf[i];
-            }
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                MPI_Recv(Bybuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                for(size_t i(0); i < outNxLocal; i++) {
-                    ByGlobal[i + outNxLocal*rr] = Bybuf[i];
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        for(size_t i(0); i < outNxGlobal; i++) {
-            ByGlobal[i] = Bybuf[i];
-        }
-    }
+    vector< vector<double> > axes;
+    axes.push_back(xaxis);
 
-    if (PE.RANK() == 0) expo.Export_h5("By", xaxis, ByGlobal, tout, time, dt);
+    Export_slab("By", axes, Bybuf, grid, tout, time, dt, PE);
 
 
 }
@@ -2776,46 +2495,21 @@ void Output_Data::Output_Preprocessor::Bz(const State1D& Y, const Grid_Info& gri
  const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
      
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
-    double Bzbuf[msg_sz];
-    vector<double> BzGlobal(outNxGlobal); 
+    vector<double> Bzbuf(msg_sz);
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     for(size_t i(0); i < msg_sz; ++i) {
         Bzbuf[i] = static_cast<double>( Y.EMF().Bz()(Nbc+i).real() );
     }
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(Bzbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            for(size_t i(0); i < outNxLocal; i++) {
-                BzGlobal[i] = Bzbuf[i];
-            }
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                MPI_Recv(Bzbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                for(size_t i(0); i < outNxLocal; i++) {
-                    BzGlobal[i + outNxLocal*rr] = Bzbuf[i];
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        for(size_t i(0); i < outNxGlobal; i++) {
-            BzGlobal[i] = Bzbuf[i];
-        }
-    }
+    vector< vector<double> > axes;
+    axes.push_back(xaxis);
 
-    if (PE.RANK() == 0) expo.Export_h5("Bz", xaxis, BzGlobal, tout, time, dt);
+    Export_slab("Bz", axes, Bzbuf, grid, tout, time, dt, PE);
 
 
 }
@@ -2827,16 +2521,12 @@ void Output_Data::Output_Preprocessor::Ex(const State2D& Y, const Grid_Info& gri
                                              const Parallel_Environment_2D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc), outNyLocal(grid.axis.Nx(1) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0)), outNyGlobal(grid.axis.Nxg(1));
 
     int msg_sz(outNxLocal*outNyLocal);
-    double Exbuf[msg_sz];
-    Array2D<double> ExGlobal(outNxGlobal,outNyGlobal);
+    vector<double> Exbuf(msg_sz);
     size_t i(0);
-    int rankx,ranky;
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
 
@@ -2847,48 +2537,11 @@ void Output_Data::Output_Preprocessor::Ex(const State2D& Y, const Grid_Info& gri
         }
     }
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(Exbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            i = 0;
-            for(size_t ix(0); ix < outNxLocal; ++ix) {
-                for(size_t iy(0); iy < outNyLocal; ++iy) {
-                    // for(size_t i(0); i < outNxLocal; i++) {
-                    ExGlobal(ix,iy) = Exbuf[i]; ++i;
-                }
-            }
-
-
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                rankx = rr % PE.MPI_X();
-                ranky = rr / PE.MPI_X();
-                i = 0;
-
-                MPI_Recv(Exbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                for(size_t ix(0); ix < outNxLocal; ++ix) {
-                    for(size_t iy(0); iy < outNyLocal; ++iy) {
-                        ExGlobal(ix + outNxLocal*rankx,iy + outNyLocal*ranky) = Exbuf[i]; ++i;
-                    }
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        i=0;
-        for(size_t ix(0); ix < outNxLocal; ++ix) {
-            for(size_t iy(0); iy < outNyLocal; ++iy) {
-                ExGlobal(ix,iy) = Exbuf[i];++i;
-            }
-        }
-    }
+    vector< vector<double> > axes;
+    axes.push_back(xaxis);
+    axes.push_back(yaxis);
 
-    if (PE.RANK() == 0) expo.Export_h5("Ex", xaxis, yaxis, ExGlobal, tout, time, dt);
+    Export_slab("Ex", axes, Exbuf, grid, tout, time, dt, PE);
 
 }
 //--------------------------------------------------------------     
@@ -2898,17 +2551,13 @@ void Output_Data::Output_Preprocessor::Ey(const State2D& Y, const Grid_Info& gri
                                              const Parallel_Environment_2D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc), outNyLocal(grid.axis.Nx(1) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0)), outNyGlobal(grid.axis.Nxg(1));
 
     int msg_sz(outNxLocal*outNyLocal); 
-    double Eybuf[msg_sz];
-    Array2D<double> EyGlobal(outNxGlobal,outNyGlobal);
+    vector<double> Eybuf(msg_sz);
 
     size_t i(0);
-    int rankx,ranky; 
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
 
@@ -2919,48 +2568,11 @@ void Output_Data::Output_Preprocessor::Ey(const State2D& Y, const Grid_Info& gri
         }
     }
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(Eybuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            i = 0;
-            for(size_t ix(0); ix < outNxLocal; ++ix) {
-                for(size_t iy(0); iy < outNyLocal; ++iy) {
-                    // for(size_t i(0); i < outNxLocal; i++) {
-                    EyGlobal(ix,iy) = Eybuf[i]; ++i;
-                }
-            }
-
-
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                rankx = rr % PE.MPI_X();
-                ranky = rr / PE.MPI_X();
-                i = 0;
-
-                MPI_Recv(Eybuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+    vector< vector<double> > axes;
+    axes.push_back(xaxis);
+    axes.push_back(yaxis);
 
-                for(size_t ix(0); ix < outNxLocal; ++ix) {
-                    for(size_t iy(0); iy < outNyLocal; ++iy) {
-                        EyGlobal(ix + outNxLocal*rankx,iy + outNyLocal*ranky) = Eybuf[i]; ++i;
-                    }
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        i=0;
-        for(size_t ix(0); ix < outNxLocal; ++ix) {
-            for(size_t iy(0); iy < outNyLocal; ++iy) {
-                EyGlobal(ix,iy) = Eybuf[i];++i;
-            }
-        }
-    }
-
-    if (PE.RANK() == 0) expo.Export_h5("Ey", xaxis, yaxis, EyGlobal, tout, time, dt);
+    Export_slab("Ey", axes, Eybuf, grid, tout, time, dt, PE);
 
 
 }
@@ -2971,16 +2583,12 @@ void Output_Data::Output_Preprocessor::Ez(const State2D& Y, const Grid_Info& gri
                                              const Parallel_Environment_2D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc), outNyLocal(grid.axis.Nx(1) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0)), outNyGlobal(grid.axis.Nxg(1));
 
     int msg_sz(outNxLocal*outNyLocal); //*szy);
-    double Ezbuf[msg_sz];
-    Array2D<double> EzGlobal(outNxGlobal,outNyGlobal); //, yglob_axis.dim());
+    vector<double> Ezbuf(msg_sz);
     size_t i(0);
-    int rankx,ranky; 
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
 
@@ -2991,48 +2599,11 @@ void Output_Data::Output_Preprocessor::Ez(const State2D& Y, const Grid_Info& gri
         }
     }
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(Ezbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            i = 0;
-            for(size_t ix(0); ix < outNxLocal; ++ix) {
-                for(size_t iy(0); iy < outNyLocal; ++iy) {
-                    // for(size_t i(0); i < outNxLocal; i++) {
-                    EzGlobal(ix,iy) = Ezbuf[i]; ++i;
-                }
-            }
-
-
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                rankx = rr % PE.MPI_X();
-                ranky = rr / PE.MPI_X();
-                i = 0;
-
-                MPI_Recv(Ezbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                for(size_t ix(0); ix < outNxLocal; ++ix) {
-                    for(size_t iy(0); iy < outNyLocal; ++iy) {
-                        EzGlobal(ix + outNxLocal*rankx,iy + outNyLocal*ranky) = Ezbuf[i]; ++i;
-                    }
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        i=0;
-        for(size_t ix(0); ix < outNxLocal; ++ix) {
-            for(size_t iy(0); iy < outNyLocal; ++iy) {
-                EzGlobal(ix,iy) = Ezbuf[i];++i;
-            }
-        }
-    }
+    vector< vector<double> > axes;
+    axes.push_back(xaxis);
+    axes.push_back(yaxis);
 
-    if (PE.RANK() == 0) expo.Export_h5("Ez", xaxis, yaxis, EzGlobal, tout, time, dt);
+    Export_slab("Ez", axes, Ezbuf, grid, tout, time, dt, PE);
 
 
 }
@@ -3043,16 +2614,12 @@ void Output_Data::Output_Preprocessor::Bx(const State2D& Y, const Grid_Info& gri
                                              const Parallel_Environment_2D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc), outNyLocal(grid.axis.Nx(1) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0)), outNyGlobal(grid.axis.Nxg(1));
 
     int msg_sz(outNxLocal*outNyLocal); //*szy);
-    double Bxbuf[msg_sz];
-    Array2D<double> BxGlobal(outNxGlobal,outNyGlobal); //, yglob_axis.dim());
+    vector<double> Bxbuf(msg_sz);
     size_t i(0);
-    int rankx,ranky; 
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
 
@@ -3063,48 +2630,11 @@ void Output_Data::Output_Preprocessor::Bx(const State2D& Y, const Grid_Info& gri
         }
     }
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(Bxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            i = 0;
-            for(size_t ix(0); ix < outNxLocal; ++ix) {
-                for(size_t iy(0); iy < outNyLocal; ++iy) {
-                    // for(size_t i(0); i < outNxLocal; i++) {
-                    BxGlobal(ix,iy) = Bxbuf[i]; ++i;
-                }
-            }
-
-
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                rankx = rr % PE.MPI_X();
-                ranky = rr / PE.MPI_X();
-                i = 0;
-
-                MPI_Recv(Bxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                for(size_t ix(0); ix < outNxLocal; ++ix) {
-                    for(size_t iy(0); iy < outNyLocal; ++iy) {
-                        BxGlobal(ix + outNxLocal*rankx,iy + outNyLocal*ranky) = Bxbuf[i]; ++i;
-                    }
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        i=0;
-        for(size_t ix(0); ix < outNxLocal; ++ix) {
-            for(size_t iy(0); iy < outNyLocal; ++iy) {
-                BxGlobal(ix,iy) = Bxbuf[i];++i;
-            }
-        }
-    }
+    vector< vector<double> > axes;
+    axes.push_back(xaxis);
+    axes.push_back(yaxis);
 
-    if (PE.RANK() == 0) expo.Export_h5("Bx", xaxis, yaxis, BxGlobal, tout, time, dt);
+    Export_slab("Bx", axes, Bxbuf, grid, tout, time, dt, PE);
 
 }
 //--------------------------------------------------------------     
@@ -3114,16 +2644,12 @@ void Output_Data::Output_Preprocessor::By(const State2D& Y, const Grid_Info& gri
                                              const Parallel_Environment_2D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
      
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc), outNyLocal(grid.axis.Nx(1) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0)), outNyGlobal(grid.axis.Nxg(1));
 
     int msg_sz(outNxLocal*outNyLocal); //*szy);
-    double Bybuf[msg_sz];
-    Array2D<double> ByGlobal(outNxGlobal,outNyGlobal); //, yglob_axis.dim());
+    vector<double> Bybuf(msg_sz);
     size_t i(0);
-    int rankx,ranky;
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
 
@@ -3134,48 +2660,11 @@ void Output_Data::Output_Preprocessor::By(const State2D& Y, const Grid_Info& gri
         }
     }
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(Bybuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            i = 0;
-            for(size_t ix(0); ix < outNxLocal; ++ix) {
-                for(size_t iy(0); iy < outNyLocal; ++iy) {
-                    // for(size_t i(0); i < outNxLocal; i++) {
-                    ByGlobal(ix,iy) = Bybuf[i]; ++i;
-                }
-            }
-
-
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                rankx = rr % PE.MPI_X();
-                ranky = rr / PE.MPI_X();
-                i = 0;
-
-                MPI_Recv(Bybuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                for(size_t ix(0); ix < outNxLocal; ++ix) {
-                    for(size_t iy(0); iy < outNyLocal; ++iy) {
-                        ByGlobal(ix + outNxLocal*rankx,iy + outNyLocal*ranky) = Bybuf[i]; ++i;
-                    }
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        i=0;
-        for(size_t ix(0); ix < outNxLocal; ++ix) {
-            for(size_t iy(0); iy < outNyLocal; ++iy) {
-                ByGlobal(ix,iy) = Bybuf[i];++i;
-            }
-        }
-    }
+    vector< vector<double> > axes;
+    axes.push_back(xaxis);
+    axes.push_back(yaxis);
 
-    if (PE.RANK() == 0) expo.Export_h5("By", xaxis, yaxis, ByGlobal, tout, time, dt);
+    Export_slab("By", axes, Bybuf, grid, tout, time, dt, PE);
 
 }
 //--------------------------------------------------------------     
@@ -3185,16 +2674,12 @@ void Output_Data::Output_Preprocessor::Bz(const State2D& Y, const Grid_Info& gri
                                              const Parallel_Environment_2D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc), outNyLocal(grid.axis.Nx(1) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0)), outNyGlobal(grid.axis.Nxg(1));
 
     int msg_sz(outNxLocal*outNyLocal);
-    double Bzbuf[msg_sz];
-    Array2D<double> BzGlobal(outNxGlobal,outNyGlobal);
+    vector<double> Bzbuf(msg_sz);
     size_t i(0);
-    int rankx,ranky;
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
 
@@ -3205,49 +2690,11 @@ void Output_Data::Output_Preprocessor::Bz(const State2D& Y, const Grid_Info& gri
         }
     }
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(Bzbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            i = 0;
-            for(size_t ix(0); ix < outNxLocal; ++ix) {
-                for(size_t iy(0); iy < outNyLocal; ++iy) {
-                    BzGlobal(ix,iy) = Bzbuf[i]; ++i;
-                }
-            }
-
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-
-                rankx = rr % PE.MPI_X();
-                ranky = rr / PE.MPI_X();
-
-                i = 0;
-
-                MPI_Recv(Bzbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                for(size_t ix(0); ix < outNxLocal; ++ix) {
-                    for(size_t iy(0); iy < outNyLocal; ++iy) {
-                        BzGlobal(ix + outNxLocal * rankx , iy + outNyLocal * ranky) = Bzbuf[i];
-                        ++i;
-                    }
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        i=0;
-        for(size_t ix(0); ix < outNxLocal; ++ix) {
-            for(size_t iy(0); iy < outNyLocal; ++iy) {
-                BzGlobal(ix,iy) = Bzbuf[i];++i;
-            }
-        }
-    }
+    vector< vector<double> > axes;
+    axes.push_back(xaxis);
+    axes.push_back(yaxis);
 
-    if (PE.RANK() == 0) expo.Export_h5("Bz", xaxis, yaxis, BzGlobal, tout, time, dt);
+    Export_slab("Bz", axes, Bzbuf, grid, tout, time, dt, PE);
 
 }
 //--------------------------------------------------------------   
@@ -3256,7 +2703,6 @@ void Output_Data::Output_Preprocessor::px(const State1D& Y, const Grid_Info& gri
  const Parallel_Environment_1D& PE) {
     // std::cout << "0 \n";
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
      
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
     size_t outNxGlobal(grid.axis.Nxg(0));
@@ -3267,52 +2713,32 @@ void Output_Data::Output_Preprocessor::px(const State1D& Y, const Grid_Info& gri
         size_t Npx(grid.axis.Npx(s));
         int msg_sz(outNxLocal*Npx);
         
-        Array2D<double> p1x1Global(Npx,outNxGlobal); 
         vector<double> p1axis(valtovec(grid.axis.px(s)));
 
-        double pxbuf[Npx*outNxLocal];
-
-        for (size_t i(0); i < outNxLocal; ++i) 
-        {
-            valarray<double> data1D = p_x.p1( Y.DF(s), i+Nbc, s);
+        vector<double> pxbuf(msg_sz);
 
-            for (size_t j(0); j < Npx; ++j) {
-                pxbuf[j+i*Npx]=data1D[j];
-            }
-        }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(pxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    for (size_t j(0); j < Npx; ++j) {
-                        p1x1Global(j,i) = pxbuf[j+i*Npx];
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(pxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        for (size_t j(0); j < Npx; ++j) {
-                            p1x1Global(j,i + outNxLocal*rr) = pxbuf[j+i*Npx];
-                        }
-                    }
-                }
+        #pragma omp parallel for num_threads(Input::List().ompthreads)
+        for (size_t i = 0; i < outNxLocal; ++i) 
+        {
+            valarray<double> data1D = p_x.p1( Y.DF(s), i+Nbc, s);
+
+            for (size_t j(0); j < Npx; ++j) {
+                pxbuf[j+i*Npx]=data1D[j];
             }
         }
-        else {
+
+        vector<double> global;
+        if (Gather_slab("px", pxbuf, Npx, grid, PE, s, global)) {
+            Array2D<double> p1x1Global(Npx,outNxGlobal);
             for(size_t i(0); i < outNxGlobal; i++) {
                 for (size_t j(0); j < Npx; ++j) {
-                    p1x1Global(j,i) = pxbuf[j+i*Npx];
+                    p1x1Global(j,i) = global[j+i*Npx];
                 }
             }
+            expo.Export_h5("px", p1axis, xaxis, p1x1Global, tout, time, dt, s);
         }
 
-        if (PE.RANK() == 0) expo.Export_h5("px", p1axis, xaxis, p1x1Global, tout, time, dt, s);
-
     }
 
 }
@@ -3322,7 +2748,6 @@ void Output_Data::Output_Preprocessor::py(const State1D& Y, const Grid_Info& gri
  const Parallel_Environment_1D& PE) {
     // std::cout << "0 \n";
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
      
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
     size_t outNxGlobal(grid.axis.Nxg(0));
@@ -3332,14 +2757,15 @@ void Output_Data::Output_Preprocessor::py(const State1D& Y, const Grid_Info& gri
     for(int s(0); s < Y.Species(); ++s) {
         size_t Npy(grid.axis.Npy(s));
         int msg_sz(outNxLocal*Npy);
-        Array2D<double> p2x1Global(Npy,outNxGlobal); 
 
         vector<double> p2axis(valtovec(grid.axis.py(s)));
 
 
-        double pybuf[Npy*outNxLocal];
+        vector<double> pybuf(msg_sz);
+
 
-        for (size_t i(0); i < outNxLocal; ++i) 
+        #pragma omp parallel for num_threads(Input::List().ompthreads)
+        for (size_t i = 0; i < outNxLocal; ++i) 
         {
             valarray<double> data1D = p_x.p2( Y.DF(s), i+Nbc, s);
 
@@ -3348,40 +2774,17 @@ void Output_Data::Output_Preprocessor::py(const State1D& Y, const Grid_Info& gri
             }       
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(pybuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    for (size_t j(0); j < Npy; ++j) {
-                        p2x1Global(j,i) = pybuf[j+i*Npy];
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(pybuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        for (size_t j(0); j < Npy; ++j) {
-                            p2x1Global(j,i + outNxLocal*rr) = pybuf[j+i*Npy];
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) 
-            {
-                for (size_t j(0); j < Npy; ++j) 
-                {
-                    p2x1Global(j,i) = pybuf[j+i*Npy];
+        vector<double> global;
+        if (Gather_slab("py", pybuf, Npy, grid, PE, s, global)) {
+            Array2D<double> p2x1Global(Npy,outNxGlobal);
+            for(size_t i(0); i < outNxGlobal; i++) {
+                for (size_t j(0); j < Npy; ++j) {
+                    p2x1Global(j,i) = global[j+i*Npy];
                 }
             }
+            expo.Export_h5("py", p2axis, xaxis, p2x1Global, tout, time, dt, s);
         }
 
-        if (PE.RANK() == 0) expo.Export_h5("py", p2axis, xaxis, p2x1Global, tout, time, dt, s);
-
     }
 
 }
@@ -3390,7 +2793,6 @@ void Output_Data::Output_Preprocessor::pz(const State1D& Y, const Grid_Info& gri
  const Parallel_Environment_1D& PE) {
     // std::cout << "0 \n";
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
     size_t outNxGlobal(grid.axis.Nxg(0));
 
@@ -3400,12 +2802,13 @@ void Output_Data::Output_Preprocessor::pz(const State1D& Y, const Grid_Info& gri
         size_t Npz(grid.axis.Npz(s));
         int msg_sz(outNxLocal*Npz);
         
-        Array2D<double> p3x1Global(Npz,outNxGlobal); 
         vector<double> p3axis(valtovec(grid.axis.pz(s)));
 
-        double pzbuf[Npz*outNxLocal];
+        vector<double> pzbuf(msg_sz);
 
-        for (size_t i(0); i < outNxLocal; ++i) {
+
+        #pragma omp parallel for num_threads(Input::List().ompthreads)
+        for (size_t i = 0; i < outNxLocal; ++i) {
 
             valarray<double> data1D = p_x.p3( Y.DF(s), i+Nbc, s);
 
@@ -3414,38 +2817,17 @@ void Output_Data::Output_Preprocessor::pz(const State1D& Y, const Grid_Info& gri
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(pzbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    for (size_t j(0); j < Npz; ++j) {
-                        p3x1Global(j,i) = pzbuf[j+i*Npz];
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(pzbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        for (size_t j(0); j < Npz; ++j) {
-                            p3x1Global(j,i + outNxLocal*rr) = pzbuf[j+i*Npz];
-                        }
-                    }
-                }
-            }
-        }
-        else {
+        vector<double> global;
+        if (Gather_slab("pz", pzbuf, Npz, grid, PE, s, global)) {
+            Array2D<double> p3x1Global(Npz,outNxGlobal);
             for(size_t i(0); i < outNxGlobal; i++) {
                 for (size_t j(0); j < Npz; ++j) {
-                    p3x1Global(j,i) = pzbuf[j+i*Npz];
+                    p3x1Global(j,i) = global[j+i*Npz];
                 }
             }
+            expo.Export_h5("pz", p3axis, xaxis, p3x1Global, tout, time, dt, s);
         }
 
-        if (PE.RANK() == 0) expo.Export_h5("pz", p3axis, xaxis, p3x1Global, tout, time, dt, s);
-
     }
 
 }
@@ -3456,98 +2838,57 @@ void Output_Data::Output_Preprocessor::px(const State2D& Y, const Grid_Info& gri
  const Parallel_Environment_2D& PE) {
     // std::cout << "0 \n";
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc), outNyLocal(grid.axis.Nx(1) - 2*Nbc);
     size_t outNxGlobal(grid.axis.Nxg(0)), outNyGlobal(grid.axis.Nxg(1));
 
-    int rankx,ranky;
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
 
     for(int s(0); s < Y.Species(); ++s) {
         size_t Npx(grid.axis.Npx(s));
         int msg_sz(outNxLocal*outNyLocal*Npx);
-        Array3D<double> p1x1Global(Npx,outNxGlobal,outNyGlobal); //, yglob_axis.dim());
-        double pxbuf[Npx*outNxLocal*outNyLocal];
+        vector<double> pxbuf(msg_sz);
 
         vector<double> p1axis(valtovec(grid.axis.px(s)));
 
         size_t counter(0);
 
-        for(size_t ix(0); ix < outNxLocal; ++ix) 
+
+        #pragma omp parallel for collapse(2) num_threads(Input::List().ompthreads)
+        for(size_t ix = 0; ix < outNxLocal; ++ix) 
         {
-            for(size_t iy(0); iy < outNyLocal; ++iy) 
+            for(size_t iy = 0; iy < outNyLocal; ++iy) 
             {
 
                 valarray<double> data1D = p_x.p1( Y.DF(s), ix+Nbc, iy + Nbc, s);
+                size_t ic((ix*outNyLocal + iy)*Npx);
 
                 for (size_t j(0); j < Npx; ++j) {
-                    pxbuf[counter]=data1D[j];
-                    ++counter;
+                    pxbuf[ic]=data1D[j];
+                    ++ic;
                 }
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(pxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else 
-            {
-                size_t counter(0);
-                // Fill data for rank = 0
-                for(size_t ix(0); ix < outNxLocal; ++ix) 
-                {
-                    for(size_t iy(0); iy < outNyLocal; ++iy) 
-                    {
-                        for (size_t j(0); j < Npx; ++j) 
-                        {
-                            p1x1Global(j,ix,iy) = pxbuf[counter];
-                            ++counter;
-                        }
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr)
-                {
-                    rankx = rr % PE.MPI_X();
-                    ranky = rr / PE.MPI_X();
-
-                    MPI_Recv(pxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    counter = 0;    
-                    for(size_t ix(0); ix < outNxLocal; ++ix) 
-                    {
-                        for(size_t iy(0); iy < outNyLocal; ++iy) 
-                        {
-                            for (size_t j(0); j < Npx; ++j) 
-                            {
-                                p1x1Global(j,ix + outNxLocal*rankx, iy + outNyLocal*ranky) = pxbuf[counter];
-                                ++counter;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else 
-        {
-            size_t counter(0);            
-            for(size_t ix(0); ix < outNxLocal; ++ix) 
+        vector<double> global;
+        if (Gather_slab("px", pxbuf, Npx, grid, PE, s, global)) {
+            Array3D<double> p1x1Global(Npx,outNxGlobal,outNyGlobal);
+            counter = 0;
+            for(size_t ix(0); ix < outNxGlobal; ++ix)
             {
-                for(size_t iy(0); iy < outNyLocal; ++iy) 
+                for(size_t iy(0); iy < outNyGlobal; ++iy)
                 {
-                    for (size_t j(0); j < Npx; ++j) 
+                    for (size_t j(0); j < Npx; ++j)
                     {
-                        p1x1Global(j,ix,iy) = pxbuf[counter];
+                        p1x1Global(j,ix,iy) = global[counter];
                         ++counter;
                     }
                 }
             }
+            expo.Export_h5("px", p1axis,xaxis, yaxis, p1x1Global, tout, time, dt, s);
         }
 
-        if (PE.RANK() == 0) expo.Export_h5("px", p1axis,xaxis, yaxis, p1x1Global, tout, time, dt, s);
-
     }
 
 }
@@ -3558,98 +2899,56 @@ void Output_Data::Output_Preprocessor::py(const State2D& Y, const Grid_Info& gri
  const Parallel_Environment_2D& PE) {
     // std::cout << "0 \n";
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc), outNyLocal(grid.axis.Nx(1) - 2*Nbc);
     size_t outNxGlobal(grid.axis.Nxg(0)), outNyGlobal(grid.axis.Nxg(1));
 
-    int rankx,ranky;
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
 
     for(int s(0); s < Y.Species(); ++s) {
         size_t Npy(grid.axis.Npy(s));
         int msg_sz(outNxLocal*outNyLocal*Npy);
-        Array3D<double> p1x1Global(Npy,outNxGlobal,outNyGlobal); //, yglob_axis.dim());
-        double pxbuf[Npy*outNxLocal*outNyLocal];
+        vector<double> pxbuf(msg_sz);
         vector<double> p2axis(valtovec(grid.axis.py(s)));
         
 
         size_t counter(0);
 
-        for(size_t ix(0); ix < outNxLocal; ++ix) 
+
+        #pragma omp parallel for collapse(2) num_threads(Input::List().ompthreads)
+        for(size_t ix = 0; ix < outNxLocal; ++ix) 
         {
-            for(size_t iy(0); iy < outNyLocal; ++iy) 
+            for(size_t iy = 0; iy < outNyLocal; ++iy) 
             {
                 valarray<double> data1D = p_x.p2( Y.DF(s), ix+Nbc, iy + Nbc, s);
+                size_t ic((ix*outNyLocal + iy)*Npy);
 
                 for (size_t j(0); j < Npy; ++j) {
-                    pxbuf[counter]=data1D[j];
-                    ++counter;
+                    pxbuf[ic]=data1D[j];
+                    ++ic;
                 }
             }
         }
 
-        if (PE.MPI_Processes() > 1) 
-        {
-            if (PE.RANK()!=0) {
-                MPI_Send(pxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else 
-            {
-                size_t counter(0);
-                // Fill data for rank = 0
-                for(size_t ix(0); ix < outNxLocal; ++ix) 
-                {
-                    for(size_t iy(0); iy < outNyLocal; ++iy) 
-                    {
-                        for (size_t j(0); j < Npy; ++j) 
-                        {
-                            p1x1Global(j,ix,iy) = pxbuf[counter];
-                            ++counter;
-                        }
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr)
-                {
-                    rankx = rr % PE.MPI_X();
-                    ranky = rr / PE.MPI_X();
-
-                    MPI_Recv(pxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    counter = 0;    
-                    for(size_t ix(0); ix < outNxLocal; ++ix) 
-                    {
-                        for(size_t iy(0); iy < outNyLocal; ++iy) 
-                        {
-                            for (size_t j(0); j < Npy; ++j) 
-                            {
-                                p1x1Global(j,ix + outNxLocal*rankx, iy + outNyLocal*ranky) = pxbuf[counter];
-                                ++counter;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else 
-        {
-            size_t counter(0);            
-            for(size_t ix(0); ix < outNxLocal; ++ix) 
+        vector<double> global;
+        if (Gather_slab("py", pxbuf, Npy, grid, PE, s, global)) {
+            Array3D<double> p1x1Global(Npy,outNxGlobal,outNyGlobal);
+            counter = 0;
+            for(size_t ix(0); ix < outNxGlobal; ++ix)
             {
-                for(size_t iy(0); iy < outNyLocal; ++iy) 
+                for(size_t iy(0); iy < outNyGlobal; ++iy)
                 {
-                    for (size_t j(0); j < Npy; ++j) 
+                    for (size_t j(0); j < Npy; ++j)
                     {
-                        p1x1Global(j,ix,iy) = pxbuf[counter];
+                        p1x1Global(j,ix,iy) = global[counter];
                         ++counter;
                     }
                 }
             }
+            expo.Export_h5("py", p2axis, xaxis, yaxis, p1x1Global, tout, time, dt, s);
         }
 
-        if (PE.RANK() == 0) expo.Export_h5("py", p2axis, xaxis, yaxis, p1x1Global, tout, time, dt, s);
-
     }
 
 }
@@ -3659,97 +2958,56 @@ void Output_Data::Output_Preprocessor::pz(const State2D& Y, const Grid_Info& gri
  const Parallel_Environment_2D& PE) {
     // std::cout << "0 \n";
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc), outNyLocal(grid.axis.Nx(1) - 2*Nbc);
     size_t outNxGlobal(grid.axis.Nxg(0)), outNyGlobal(grid.axis.Nxg(1));
 
-    int rankx,ranky;
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
 
     for(int s(0); s < Y.Species(); ++s) {
         size_t Npz(grid.axis.Npz(s));
         int msg_sz(outNxLocal*outNyLocal*Npz);
-        Array3D<double> p1x1Global(Npz,outNxGlobal,outNyGlobal); //, yglob_axis.dim());
-        double pxbuf[Npz*outNxLocal*outNyLocal];
+        vector<double> pxbuf(msg_sz);
         vector<double> p3axis(valtovec(grid.axis.pz(s)));
 
         size_t counter(0);
 
-        for(size_t ix(0); ix < outNxLocal; ++ix) 
+
+        #pragma omp parallel for collapse(2) num_threads(Input::List().ompthreads)
+        for(size_t ix = 0; ix < outNxLocal; ++ix) 
         {
-            for(size_t iy(0); iy < outNyLocal; ++iy) 
+            for(size_t iy = 0; iy < outNyLocal; ++iy) 
             {
 
                 valarray<double> data1D = p_x.p3( Y.DF(s), ix+Nbc, iy + Nbc, s);
+                size_t ic((ix*outNyLocal + iy)*Npz);
 
                 for (size_t j(0); j < Npz; ++j) {
-                    pxbuf[counter]=data1D[j];
-                    ++counter;
+                    pxbuf[ic]=data1D[j];
+                    ++ic;
                 }
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(pxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else 
-            {
-                size_t counter(0);
-                // Fill data for rank = 0
-                for(size_t ix(0); ix < outNxLocal; ++ix) 
-                {
-                    for(size_t iy(0); iy < outNyLocal; ++iy) 
-                    {
-                        for (size_t j(0); j < Npz; ++j) 
-                        {
-                            p1x1Global(j,ix,iy) = pxbuf[counter];
-                            ++counter;
-                        }
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr)
-                {
-                    rankx = rr % PE.MPI_X();
-                    ranky = rr / PE.MPI_X();
-
-                    MPI_Recv(pxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    counter = 0;    
-                    for(size_t ix(0); ix < outNxLocal; ++ix) 
-                    {
-                        for(size_t iy(0); iy < outNyLocal; ++iy) 
-                        {
-                            for (size_t j(0); j < Npz; ++j) 
-                            {
-                                p1x1Global(j,ix + outNxLocal*rankx, iy + outNyLocal*ranky) = pxbuf[counter];
-                                ++counter;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else 
-        {
-            size_t counter(0);            
-            for(size_t ix(0); ix < outNxLocal; ++ix) 
+        vector<double> global;
+        if (Gather_slab("pz", pxbuf, Npz, grid, PE, s, global)) {
+            Array3D<double> p1x1Global(Npz,outNxGlobal,outNyGlobal);
+            counter = 0;
+            for(size_t ix(0); ix < outNxGlobal; ++ix)
             {
-                for(size_t iy(0); iy < outNyLocal; ++iy) 
+                for(size_t iy(0); iy < outNyGlobal; ++iy)
                 {
-                    for (size_t j(0); j < Npz; ++j) 
+                    for (size_t j(0); j < Npz; ++j)
                     {
-                        p1x1Global(j,ix,iy) = pxbuf[counter];
+                        p1x1Global(j,ix,iy) = global[counter];
                         ++counter;
                     }
                 }
             }
+            expo.Export_h5("pz", p3axis, xaxis, yaxis, p1x1Global, tout, time, dt, s);
         }
 
-        if (PE.RANK() == 0) expo.Export_h5("pz", p3axis, xaxis, yaxis, p1x1Global, tout, time, dt, s);
-
     }
 
 }
@@ -3768,7 +3026,6 @@ void Output_Data::Output_Preprocessor::pxpy(const State1D& Y, const Grid_Info& g
 {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
@@ -3781,79 +3038,46 @@ void Output_Data::Output_Preprocessor::pxpy(const State1D& Y, const Grid_Info& g
     {
         
         int msg_sz(outNxLocal*grid.axis.Npx(s)*grid.axis.Npy(s));        
-        Array3D<double> pxpyGlobal(grid.axis.Npx(s),grid.axis.Npy(s),outNxGlobal);
         
-        double pbuf[grid.axis.Npx(s)*grid.axis.Npy(s)*outNxLocal];        
+        vector<double> pbuf(msg_sz);        
         vector<double> p1axis(valtovec(grid.axis.px(s)));
         vector<double> p2axis(valtovec(grid.axis.py(s)));
 
-        ind = 0;    
-        for (size_t i(0); i < outNxLocal; ++i) 
+        #pragma omp parallel for num_threads(Input::List().ompthreads)
+        for (size_t i = 0; i < outNxLocal; ++i) 
         {
             Array2D<double> data2D = p_x.p1p2( Y.DF(s), i+Nbc, s);
+            size_t ic(i*grid.axis.Npx(s)*grid.axis.Npy(s));
             for (size_t j(0); j < grid.axis.Npx(s); ++j) 
             {
 
                 for (size_t k(0); k < grid.axis.Npy(s); ++k) 
                 {
-                    pbuf[ind]=data2D(j,k);
-                    ++ind;
+                    pbuf[ic]=data2D(j,k);
+                    ++ic;
                 }
 
             }
             
         }
 
-        if (PE.MPI_Processes() > 1) 
-        {
-           if (PE.RANK()!=0) {
-               MPI_Send(pbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-           }
-           else {
-               // Fill data for rank = 0
-               ind = 0;
-               for(size_t i(0); i < outNxLocal; i++) 
-               {
-                    for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-                    {
-                        for (size_t k(0); k < grid.axis.Npy(s); ++k) 
-                        {
-                            pxpyGlobal(j,k,i) = pbuf[ind];
-                            ++ind;
-                        }
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr(1); rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(pbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    ind = 0;
-                    for(size_t i(0); i < outNxLocal; i++) 
+        vector<double> global;
+        if (Gather_slab("pxpy", pbuf, grid.axis.Npx(s)*grid.axis.Npy(s), grid, PE, s, global)) {
+            Array3D<double> pxpyGlobal(grid.axis.Npx(s),grid.axis.Npy(s),outNxGlobal);
+            ind = 0;
+            for(size_t i(0); i < outNxGlobal; i++)
+            {
+                for (size_t j(0); j < grid.axis.Npx(s); ++j)
+                {
+                    for (size_t k(0); k < grid.axis.Npy(s); ++k)
                     {
-                        for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-                        {
-                            for (size_t k(0); k < grid.axis.Npy(s); ++k) 
-                            {
-                                pxpyGlobal(j,k,i + outNxLocal*rr) = pbuf[ind];
-                                ++ind;
-                            }
-                        }
+                        pxpyGlobal(j,k,i) = global[ind];
+                        ++ind;
                     }
                 }
             }
+            expo.Export_h5("pxpy", p1axis, p2axis, xaxis, pxpyGlobal, tout, time, dt, s);
         }
-       else {
-           ind = 0;
-           for(size_t i(0); i < outNxLocal; i++) {
-               for (size_t j(0); j < grid.axis.Npx(s); ++j) {
-                   for (size_t k(0); k < grid.axis.Npy(s); ++k) {
-                       pxpyGlobal(j,k,i) = pbuf[ind];
-                       ++ind;
-                   }
-               }
-           }
-       }
-
-       if (PE.RANK() == 0) expo.Export_h5("pxpy", p1axis, p2axis, xaxis, pxpyGlobal, tout, time, dt, s);
 
    }
 
@@ -3864,12 +3088,10 @@ void Output_Data::Output_Preprocessor::pxpy(const State2D& Y, const Grid_Info& g
   const Parallel_Environment_2D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc), outNyLocal(grid.axis.Nx(1) - 2*Nbc);
     size_t outNxGlobal(grid.axis.Nxg(0)), outNyGlobal(grid.axis.Nxg(1));
 
-    int rankx,ranky;
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
     size_t counter;
@@ -3878,101 +3100,49 @@ void Output_Data::Output_Preprocessor::pxpy(const State2D& Y, const Grid_Info& g
     {
 
         int msg_sz(outNxLocal*outNyLocal*grid.axis.Npx(s)*grid.axis.Npy(s));
-        Array4D<double> pxpyGlobal(grid.axis.Npx(s),grid.axis.Npy(s),outNxGlobal,outNyGlobal); //, yglob_axis.dim());
-        double pbuf[grid.axis.Npx(s)*grid.axis.Npy(s)*outNxLocal*outNyLocal];
+        vector<double> pbuf(msg_sz);
         vector<double> p1axis(valtovec(grid.axis.px(s)));
         vector<double> p2axis(valtovec(grid.axis.py(s)));
 
-        counter = 0;
-        for(size_t ix(0); ix < outNxLocal; ++ix) 
+        #pragma omp parallel for collapse(2) num_threads(Input::List().ompthreads)
+        for(size_t ix = 0; ix < outNxLocal; ++ix) 
         {
-            for(size_t iy(0); iy < outNyLocal; ++iy) 
+            for(size_t iy = 0; iy < outNyLocal; ++iy) 
             {
                 Array2D<double> data2D = p_x.p1p2( Y.DF(s), ix+Nbc, iy+Nbc, s);
+                size_t ic((ix*outNyLocal + iy)*grid.axis.Npx(s)*grid.axis.Npy(s));
 
                 for (size_t j(0); j < grid.axis.Npx(s); ++j) 
                 {
                     for (size_t k(0); k < grid.axis.Npy(s); ++k) 
                     {
-                        pbuf[counter]=data2D(j,k);
-                        ++counter;
+                        pbuf[ic]=data2D(j,k);
+                        ++ic;
                     }
                 }
             }
         }
 
-        if (PE.MPI_Processes() > 1) 
-        {
-            if (PE.RANK()!=0) {
-                MPI_Send(pbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else 
-            {
-                // Fill data for rank = 0
-                counter = 0;
-                for(size_t ix(0); ix < outNxLocal; ++ix) 
-                {
-                    for(size_t iy(0); iy < outNyLocal; ++iy) 
-                    {
-                        for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-                        {
-                            for (size_t k(0); k < grid.axis.Npy(s); ++k) 
-                            {
-                                pxpyGlobal(j,k,ix,iy) = pbuf[counter];
-                                ++counter;
-                            }
-                        }
-                   }
-               }
-               // Fill data for rank > 0
-               for (int rr(1); rr < PE.MPI_Processes(); ++rr)
-               {
-                    rankx = rr % PE.MPI_X();
-                    ranky = rr / PE.MPI_X();
-
-                    counter = 0;
-
-                    MPI_Recv(pbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                    for(size_t ix(0); ix < outNxLocal; ++ix) 
-                    {
-                        for(size_t iy(0); iy < outNyLocal; ++iy)
-                        {
-                            for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-                            {
-                                for (size_t k(0); k < grid.axis.Npy(s); ++k) 
-                                {
-                                    pxpyGlobal(j,k,ix + outNxLocal*rankx,iy + outNyLocal*ranky) = pbuf[counter];
-                                    ++counter;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else 
-        {
+        vector<double> global;
+        if (Gather_slab("pxpy", pbuf, grid.axis.Npx(s)*grid.axis.Npy(s), grid, PE, s, global)) {
+            Array4D<double> pxpyGlobal(grid.axis.Npx(s),grid.axis.Npy(s),outNxGlobal,outNyGlobal);
             counter = 0;
-
-            for(size_t ix(0); ix < outNxLocal; ++ix) 
+            for(size_t ix(0); ix < outNxGlobal; ++ix)
             {
-                for(size_t iy(0); iy < outNyLocal; ++iy) 
+                for(size_t iy(0); iy < outNyGlobal; ++iy)
                 {
-                    for (size_t j(0); j < grid.axis.Npx(s); ++j) 
+                    for (size_t j(0); j < grid.axis.Npx(s); ++j)
                     {
-                        for (size_t k(0); k < grid.axis.Npy(s); ++k) 
+                        for (size_t k(0); k < grid.axis.Npy(s); ++k)
                         {
-                            pxpyGlobal(j,k,ix,iy) = pbuf[counter];
+                            pxpyGlobal(j,k,ix,iy) = global[counter];
                             ++counter;
                         }
                     }
                 }
             }
+            expo.Export_h5("pxpy", p1axis, p2axis, xaxis, yaxis, pxpyGlobal, tout, time, dt, s);
         }
-       
-
-       if (PE.RANK() == 0) expo.Export_h5("pxpy", p1axis, p2axis, xaxis, yaxis, pxpyGlobal, tout, time, dt, s);
 
    }
 
@@ -3993,7 +3163,6 @@ void Output_Data::Output_Preprocessor::pypz(const State1D& Y, const Grid_Info& g
   const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
     size_t outNxGlobal(grid.axis.Nxg(0));
@@ -4004,80 +3173,48 @@ void Output_Data::Output_Preprocessor::pypz(const State1D& Y, const Grid_Info& g
     for(int s(0); s < Y.Species(); ++s) {
 
         int msg_sz(outNxLocal*grid.axis.Npy(s)*grid.axis.Npz(s));
-        Array3D<double> pypzGlobal(grid.axis.Npy(s),grid.axis.Npz(s),outNxGlobal);
-        double pbuf[grid.axis.Npy(s)*grid.axis.Npz(s)*outNxLocal];
+        vector<double> pbuf(msg_sz);
 
         ind = 0;
 
         vector<double> p2axis(valtovec(grid.axis.py(s)));
         vector<double> p3axis(valtovec(grid.axis.pz(s)));
 
-        for (size_t i(0); i < outNxLocal; ++i) {
+
+        #pragma omp parallel for num_threads(Input::List().ompthreads)
+        for (size_t i = 0; i < outNxLocal; ++i) {
 
             Array2D<double> data2D = p_x.p2p3( Y.DF(s), i+Nbc, s);
+            size_t ic(i*grid.axis.Npy(s)*grid.axis.Npz(s));
 
             for (size_t j(0); j < grid.axis.Npy(s); ++j) 
             {
                for (size_t k(0); k < grid.axis.Npz(s); ++k) 
                 {
-                   pbuf[ind]=data2D(j,k);
-                   ++ind;
+                   pbuf[ic]=data2D(j,k);
+                   ++ic;
                 }
            }
        }
 
-       if (PE.MPI_Processes() > 1) {
-           if (PE.RANK()!=0) {
-               MPI_Send(pbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-           }
-           else 
-           {
-               // Fill data for rank = 0
-                ind = 0;
-                for(size_t i(0); i < outNxLocal; i++) 
-                {
-                    for (size_t j(0); j < grid.axis.Npy(s); ++j) 
-                    {
-                        for (size_t k(0); k < grid.axis.Npz(s); ++k) 
-                        {
-                           pypzGlobal(j,k,i) = pbuf[ind];
-                           ++ind;
-                        }
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr(1); rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(pbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    ind = 0;
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        for (size_t j(0); j < grid.axis.Npy(s); ++j) {
-                            for (size_t k(0); k < grid.axis.Npz(s); ++k) {
-                                pypzGlobal(j,k,i + outNxLocal*rr) = pbuf[ind];
-                                ++ind;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else 
-        {
+        vector<double> global;
+        if (Gather_slab("pypz", pbuf, grid.axis.Npy(s)*grid.axis.Npz(s), grid, PE, s, global)) {
+            Array3D<double> pypzGlobal(grid.axis.Npy(s),grid.axis.Npz(s),outNxGlobal);
             ind = 0;
-            for(size_t i(0); i < outNxLocal; i++) 
+            for(size_t i(0); i < outNxGlobal; i++)
             {
-                for (size_t j(0); j < grid.axis.Npy(s); ++j) 
+                for (size_t j(0); j < grid.axis.Npy(s); ++j)
                 {
-                    for (size_t k(0); k < grid.axis.Npz(s); ++k) 
+                    for (size_t k(0); k < grid.axis.Npz(s); ++k)
                     {
-                        pypzGlobal(j,k,i) = pbuf[ind];
+                        pypzGlobal(j,k,i) = global[ind];
                         ++ind;
                     }
                 }
             }
+            expo.Export_h5("pypz", p2axis, p3axis, xaxis, pypzGlobal, tout, time, dt, s);
         }
 
-       if (PE.RANK() == 0) expo.Export_h5("pypz", p2axis, p3axis, xaxis, pypzGlobal, tout, time, dt, s);
-
    }
 
 }
@@ -4087,12 +3224,10 @@ void Output_Data::Output_Preprocessor::pypz(const State2D& Y, const Grid_Info& g
   const Parallel_Environment_2D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc), outNyLocal(grid.axis.Nx(1) - 2*Nbc);
     size_t outNxGlobal(grid.axis.Nxg(0)), outNyGlobal(grid.axis.Nxg(1));
 
-    int rankx,ranky;
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
     size_t counter;
@@ -4100,102 +3235,50 @@ void Output_Data::Output_Preprocessor::pypz(const State2D& Y, const Grid_Info& g
 
     for(int s(0); s < Y.Species(); ++s) 
     {
-        int msg_sz(outNxLocal*outNyLocal*grid.axis.Npx(s)*grid.axis.Npy(s));
-        Array4D<double> dataGlobal(grid.axis.Npx(s),grid.axis.Npy(s),outNxGlobal,outNyGlobal); 
-        double pbuf[grid.axis.Npx(s)*grid.axis.Npy(s)*outNxLocal*outNyLocal];
+        int msg_sz(outNxLocal*outNyLocal*grid.axis.Npy(s)*grid.axis.Npz(s));
+        vector<double> pbuf(msg_sz);
         vector<double> p2axis(valtovec(grid.axis.py(s)));
         vector<double> p3axis(valtovec(grid.axis.pz(s)));
 
-        counter = 0;
-        for(size_t ix(0); ix < outNxLocal; ++ix) 
+        #pragma omp parallel for collapse(2) num_threads(Input::List().ompthreads)
+        for(size_t ix = 0; ix < outNxLocal; ++ix) 
         {
-            for(size_t iy(0); iy < outNyLocal; ++iy) 
+            for(size_t iy = 0; iy < outNyLocal; ++iy) 
             {
                 Array2D<double> data2D = p_x.p2p3( Y.DF(s), ix+Nbc, iy+Nbc, s);
+                size_t ic((ix*outNyLocal + iy)*grid.axis.Npy(s)*grid.axis.Npz(s));
 
-                for (size_t j(0); j < grid.axis.Npx(s); ++j) 
+                for (size_t j(0); j < grid.axis.Npy(s); ++j) 
                 {
-                    for (size_t k(0); k < grid.axis.Npy(s); ++k) 
+                    for (size_t k(0); k < grid.axis.Npz(s); ++k) 
                     {
-                        pbuf[counter]=data2D(j,k);
-                        ++counter;
+                        pbuf[ic]=data2D(j,k);
+                        ++ic;
                     }
                 }
             }
         }
 
-        if (PE.MPI_Processes() > 1) 
-        {
-            if (PE.RANK()!=0) {
-                MPI_Send(pbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else 
-            {
-                // Fill data for rank = 0
-                counter = 0;
-                for(size_t ix(0); ix < outNxLocal; ++ix) 
-                {
-                    for(size_t iy(0); iy < outNyLocal; ++iy) 
-                    {
-                        for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-                        {
-                            for (size_t k(0); k < grid.axis.Npy(s); ++k) 
-                            {
-                                dataGlobal(j,k,ix,iy) = pbuf[counter];
-                                ++counter;
-                            }
-                        }
-                   }
-               }
-               // Fill data for rank > 0
-               for (int rr(1); rr < PE.MPI_Processes(); ++rr)
-               {
-                    rankx = rr % PE.MPI_X();
-                    ranky = rr / PE.MPI_X();
-
-                    counter = 0;
-
-                    MPI_Recv(pbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    
-                    for(size_t ix(0); ix < outNxLocal; ++ix) 
-                    {
-                        for(size_t iy(0); iy < outNyLocal; ++iy)
-                        {
-                            for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-                            {
-                                for (size_t k(0); k < grid.axis.Npy(s); ++k) 
-                                {
-                                    dataGlobal(j,k,ix + outNxLocal*rankx,iy + outNyLocal*ranky) = pbuf[counter];
-                                    ++counter;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else 
-        {
+        vector<double> global;
+        if (Gather_slab("pypz", pbuf, grid.axis.Npy(s)*grid.axis.Npz(s), grid, PE, s, global)) {
+            Array4D<double> dataGlobal(grid.axis.Npy(s),grid.axis.Npz(s),outNxGlobal,outNyGlobal);
             counter = 0;
-
-            for(size_t ix(0); ix < outNxLocal; ++ix) 
+            for(size_t ix(0); ix < outNxGlobal; ++ix)
             {
-                for(size_t iy(0); iy < outNyLocal; ++iy) 
+                for(size_t iy(0); iy < outNyGlobal; ++iy)
                 {
-                    for (size_t j(0); j < grid.axis.Npx(s); ++j) 
+                    for (size_t j(0); j < grid.axis.Npy(s); ++j)
                     {
-                        for (size_t k(0); k < grid.axis.Npy(s); ++k) 
+                        for (size_t k(0); k < grid.axis.Npz(s); ++k)
                         {
-                            dataGlobal(j,k,ix,iy) = pbuf[counter];
+                            dataGlobal(j,k,ix,iy) = global[counter];
                             ++counter;
                         }
                     }
                 }
             }
+            expo.Export_h5("pypz", p2axis, p3axis, xaxis, yaxis, dataGlobal, tout, time, dt, s);
         }
-       
-
-       if (PE.RANK() == 0) expo.Export_h5("pypz", p2axis, p3axis, xaxis, yaxis, dataGlobal, tout, time, dt, s);
 
    }
 
@@ -4215,7 +3298,6 @@ void Output_Data::Output_Preprocessor::pxpz(const State1D& Y, const Grid_Info& g
   const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
     size_t outNxGlobal(grid.axis.Nxg(0));
@@ -4225,80 +3307,45 @@ void Output_Data::Output_Preprocessor::pxpz(const State1D& Y, const Grid_Info& g
     for(int s(0); s < Y.Species(); ++s) {
 
         int msg_sz(outNxLocal*grid.axis.Npx(s)*grid.axis.Npz(s));
-        Array3D<double> pxpzGlobal(grid.axis.Npx(s),grid.axis.Npz(s),outNxGlobal); 
-        double pbuf[grid.axis.Npx(s)*grid.axis.Npz(s)*outNxLocal];
+        vector<double> pbuf(msg_sz);
         vector<double> p1axis(valtovec(grid.axis.px(s)));
         vector<double> p3axis(valtovec(grid.axis.pz(s)));
 
-        for (size_t i(0); i < outNxLocal; ++i) {
 
-            Array2D<double> data2D = p_x.p1p2( Y.DF(s), i+Nbc, s);
-            ind = 0;
+        #pragma omp parallel for num_threads(Input::List().ompthreads)
+        for (size_t i = 0; i < outNxLocal; ++i) {
+
+            Array2D<double> data2D = p_x.p1p3( Y.DF(s), i+Nbc, s);
+            size_t ic(i*grid.axis.Npx(s)*grid.axis.Npz(s));
+            ic = 0;
 
             for (size_t j(0); j < grid.axis.Npx(s); ++j) {
                 for (size_t k(0); k < grid.axis.Npz(s); ++k) {
-                    pbuf[ind]=data2D(j,k);
-                    ++ind;
+                    pbuf[ic]=data2D(j,k);
+                    ++ic;
                 }
             }
            
         }
 
-       if (PE.MPI_Processes() > 1) {
-           if (PE.RANK()!=0) {
-               MPI_Send(pbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-           }
-           else 
-           {
-               ind = 0;
-               // Fill data for rank = 0
-               for(size_t i(0); i < outNxLocal; i++) 
-               {
-                    for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-                    {
-                        for (size_t k(0); k < grid.axis.Npz(s); ++k) 
-                        {
-                            pxpzGlobal(j,k,i) = pbuf[ind];
-                            ++ind;
-                        }
-                    }
-                }
-               // Fill data for rank > 0
-                for (int rr(1); rr < PE.MPI_Processes(); ++rr){
-                    ind = 0;
-                    MPI_Recv(pbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) 
-                    {
-                        for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-                        {
-                            for (size_t k(0); k < grid.axis.Npz(s); ++k) 
-                            {
-                                pxpzGlobal(j,k,i + outNxLocal*rr) = pbuf[ind];
-                                ++ind;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else 
-        {
+        vector<double> global;
+        if (Gather_slab("pxpz", pbuf, grid.axis.Npx(s)*grid.axis.Npz(s), grid, PE, s, global)) {
+            Array3D<double> pxpzGlobal(grid.axis.Npx(s),grid.axis.Npz(s),outNxGlobal);
             ind = 0;
-            for(size_t i(0); i < outNxLocal; i++) 
+            for(size_t i(0); i < outNxGlobal; i++)
             {
-                for (size_t j(0); j < grid.axis.Npx(s); ++j) 
+                for (size_t j(0); j < grid.axis.Npx(s); ++j)
                 {
-                    for (size_t k(0); k < grid.axis.Npz(s); ++k) 
+                    for (size_t k(0); k < grid.axis.Npz(s); ++k)
                     {
-                        pxpzGlobal(j,k,i) = pbuf[ind];
+                        pxpzGlobal(j,k,i) = global[ind];
                         ++ind;
                     }
                 }
             }
+            expo.Export_h5("pxpz", p1axis, p3axis, xaxis, pxpzGlobal, tout, time, dt, s);
         }
 
-       if (PE.RANK() == 0) expo.Export_h5("pxpz", p1axis, p3axis, xaxis, pxpzGlobal, tout, time, dt, s);
-
    }
 
 }
@@ -4307,12 +3354,10 @@ void Output_Data::Output_Preprocessor::pxpz(const State2D& Y, const Grid_Info& g
   const Parallel_Environment_2D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc), outNyLocal(grid.axis.Nx(1) - 2*Nbc);
     size_t outNxGlobal(grid.axis.Nxg(0)), outNyGlobal(grid.axis.Nxg(1));
 
-    int rankx,ranky;
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
     size_t counter;
@@ -4321,102 +3366,50 @@ void Output_Data::Output_Preprocessor::pxpz(const State2D& Y, const Grid_Info& g
     for(int s(0); s < Y.Species(); ++s) 
     {
 
-        int msg_sz(outNxLocal*outNyLocal*grid.axis.Npx(s)*grid.axis.Npy(s));
-        Array4D<double> dataGlobal(grid.axis.Npx(s),grid.axis.Npy(s),outNxGlobal,outNyGlobal); //, yglob_axis.dim());
-        double pbuf[grid.axis.Npx(s)*grid.axis.Npy(s)*outNxLocal*outNyLocal];
+        int msg_sz(outNxLocal*outNyLocal*grid.axis.Npx(s)*grid.axis.Npz(s));
+        vector<double> pbuf(msg_sz);
         vector<double> p1axis(valtovec(grid.axis.px(s)));
         vector<double> p3axis(valtovec(grid.axis.pz(s)));
 
-        counter = 0;
-        for(size_t ix(0); ix < outNxLocal; ++ix) 
+        #pragma omp parallel for collapse(2) num_threads(Input::List().ompthreads)
+        for(size_t ix = 0; ix < outNxLocal; ++ix) 
         {
-            for(size_t iy(0); iy < outNyLocal; ++iy) 
+            for(size_t iy = 0; iy < outNyLocal; ++iy) 
             {
                 Array2D<double> data2D = p_x.p1p3( Y.DF(s), ix+Nbc, iy+Nbc, s);
+                size_t ic((ix*outNyLocal + iy)*grid.axis.Npx(s)*grid.axis.Npz(s));
 
                 for (size_t j(0); j < grid.axis.Npx(s); ++j) 
                 {
-                    for (size_t k(0); k < grid.axis.Npy(s); ++k) 
+                    for (size_t k(0); k < grid.axis.Npz(s); ++k) 
                     {
-                        pbuf[counter]=data2D(j,k);
-                        ++counter;
+                        pbuf[ic]=data2D(j,k);
+                        ++ic;
                     }
                 }
             }
         }
 
-        if (PE.MPI_Processes() > 1) 
-        {
-            if (PE.RANK()!=0) {
-                MPI_Send(pbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else 
-            {
-                // Fill data for rank = 0
-                counter = 0;
-                for(size_t ix(0); ix < outNxLocal; ++ix) 
-                {
-                    for(size_t iy(0); iy < outNyLocal; ++iy) 
-                    {
-                        for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-                        {
-                            for (size_t k(0); k < grid.axis.Npy(s); ++k) 
-                            {
-                                dataGlobal(j,k,ix,iy) = pbuf[counter];
-                                ++counter;
-                            }
-                        }
-                   }
-               }
-               // Fill data for rank > 0
-               for (int rr(1); rr < PE.MPI_Processes(); ++rr)
-               {
-                    rankx = rr % PE.MPI_X();
-                    ranky = rr / PE.MPI_X();
-
-                    counter = 0;
-
-                    MPI_Recv(pbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    
-                    for(size_t ix(0); ix < outNxLocal; ++ix) 
-                    {
-                        for(size_t iy(0); iy < outNyLocal; ++iy)
-                        {
-                            for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-                            {
-                                for (size_t k(0); k < grid.axis.Npy(s); ++k) 
-                                {
-                                    dataGlobal(j,k,ix + outNxLocal*rankx,iy + outNyLocal*ranky) = pbuf[counter];
-                                    ++counter;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else 
-        {
+        vector<double> global;
+        if (Gather_slab("pxpz", pbuf, grid.axis.Npx(s)*grid.axis.Npz(s), grid, PE, s, global)) {
+            Array4D<double> dataGlobal(grid.axis.Npx(s),grid.axis.Npz(s),outNxGlobal,outNyGlobal);
             counter = 0;
-
-            for(size_t ix(0); ix < outNxLocal; ++ix) 
+            for(size_t ix(0); ix < outNxGlobal; ++ix)
             {
-                for(size_t iy(0); iy < outNyLocal; ++iy) 
+                for(size_t iy(0); iy < outNyGlobal; ++iy)
                 {
-                    for (size_t j(0); j < grid.axis.Npx(s); ++j) 
+                    for (size_t j(0); j < grid.axis.Npx(s); ++j)
                     {
-                        for (size_t k(0); k < grid.axis.Npy(s); ++k) 
+                        for (size_t k(0); k < grid.axis.Npz(s); ++k)
                         {
-                            dataGlobal(j,k,ix,iy) = pbuf[counter];
+                            dataGlobal(j,k,ix,iy) = global[counter];
                             ++counter;
                         }
                     }
                 }
             }
+            expo.Export_h5("pxpz", p1axis, p3axis, xaxis, yaxis, dataGlobal, tout, time, dt, s);
         }
-       
-
-       if (PE.RANK() == 0) expo.Export_h5("pxpz", p1axis, p3axis, xaxis, yaxis, dataGlobal, tout, time, dt, s);
 
    }
 
@@ -4436,7 +3429,6 @@ void Output_Data::Output_Preprocessor::pxpypz(const State1D& Y, const Grid_Info&
   const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
     size_t outNxGlobal(grid.axis.Nxg(0));
@@ -4446,17 +3438,16 @@ void Output_Data::Output_Preprocessor::pxpypz(const State1D& Y, const Grid_Info&
     for(int s(0); s < Y.Species(); ++s) {
 
         int msg_sz(outNxLocal*grid.axis.Npx(s)*grid.axis.Npy(s)*grid.axis.Npz(s));
-        Array4D<double> pxpypzGlobal(grid.axis.Npx(s),grid.axis.Npy(s),grid.axis.Npz(s),outNxGlobal); 
-        double pbuf[msg_sz];
+        vector<double> pbuf(msg_sz);
         vector<double> p1axis(valtovec(grid.axis.px(s)));
         vector<double> p2axis(valtovec(grid.axis.py(s)));
         vector<double> p3axis(valtovec(grid.axis.pz(s)));
 
-        ind = 0;
-
-        for (size_t i(0); i < outNxLocal; ++i) {
+        #pragma omp parallel for num_threads(Input::List().ompthreads)
+        for (size_t i = 0; i < outNxLocal; ++i) {
 
             Array3D<double> data3D = p_x.p1p2p3( Y.DF(s), i+Nbc, s);
+            size_t ic(i*grid.axis.Npx(s)*grid.axis.Npy(s)*grid.axis.Npz(s));
 
             for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
             {
@@ -4464,80 +3455,33 @@ void Output_Data::Output_Preprocessor::pxpypz(const State1D& Y, const Grid_Info&
                 {
                     for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
                     {
-                        pbuf[ind]=data3D(ipx,ipy,ipz);
-                        ++ind;
-                    }
-                }
-            }
-        }
-
-        if (PE.MPI_Processes() > 1) 
-        {
-            if (PE.RANK()!=0) 
-            {
-                MPI_Send(pbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else 
-            {
-                // Fill data for rank = 0
-                ind = 0;
-                for(size_t i(0); i < outNxLocal; i++) 
-                {
-                    
-                    for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-                    {
-                        for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-                        {
-                            for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                            {
-                                pxpypzGlobal(ipx,ipy,ipz,i) = pbuf[ind];
-                                ++ind;
-                            }
-                        }
-                    }
-                }
-               // Fill data for rank > 0
-                for (int rr(1); rr < PE.MPI_Processes(); ++rr)
-                {
-                    MPI_Recv(pbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    ind = 0;
-                    for(size_t i(0); i < outNxLocal; i++) 
-                    {
-                        for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-                        {
-                            for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-                            {
-                                for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                                {
-                                    pxpypzGlobal(ipx,ipy,ipz,i + outNxLocal*rr) = pbuf[ind];
-                                    ++ind;
-                                }
-                            }
-                        }
+                        pbuf[ic]=data3D(ipx,ipy,ipz);
+                        ++ic;
                     }
                 }
             }
         }
-        else 
-        {
+
+        vector<double> global;
+        if (Gather_slab("pxpypz", pbuf, grid.axis.Npx(s)*grid.axis.Npy(s)*grid.axis.Npz(s), grid, PE, s, global)) {
+            Array4D<double> pxpypzGlobal(grid.axis.Npx(s),grid.axis.Npy(s),grid.axis.Npz(s),outNxGlobal);
             ind = 0;
-            for(size_t i(0); i < outNxLocal; i++) 
-            {                
-                for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
+            for(size_t i(0); i < outNxGlobal; i++)
+            {
+                for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx)
                 {
-                    for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
+                    for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy)
                     {
-                        for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
+                        for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz)
                         {
-                            pxpypzGlobal(ipx,ipy,ipz,i) = pbuf[ind];
+                            pxpypzGlobal(ipx,ipy,ipz,i) = global[ind];
                             ++ind;
                         }
                     }
                 }
             }
+            expo.Export_h5("pxpypz", p1axis, p2axis, p3axis, xaxis, pxpypzGlobal, tout, time, dt, s);
         }
-
-        if (PE.RANK() == 0) expo.Export_h5("pxpypz", p1axis, p2axis, p3axis, xaxis, pxpypzGlobal, tout, time, dt, s);
     }
 
 }
@@ -4546,10 +3490,8 @@ void Output_Data::Output_Preprocessor::f0(const State1D& Y, const Grid_Info& gri
  const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     vector<double> re_im_axis;
     re_im_axis.push_back(0.);
@@ -4560,11 +3502,10 @@ void Output_Data::Output_Preprocessor::f0(const State1D& Y, const Grid_Info& gri
     for(int s(0); s < Y.Species(); ++s) 
     {
         int msg_sz(2*outNxLocal*f_x.Np(s));
-        Array3D<double> f0x1Global(outNxGlobal,f_x.Np(s),2); 
 
         vector<double> paxis(valtovec(grid.axis.p(s)));
 
-        double f0xbuf[msg_sz];
+        vector<double> f0xbuf(msg_sz);
 
         for (size_t i(0); i < outNxLocal; ++i) {
 
@@ -4578,45 +3519,12 @@ void Output_Data::Output_Preprocessor::f0(const State1D& Y, const Grid_Info& gri
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(f0xbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-
-                    for (size_t j(0); j < f_x.Np(s); ++j) {
-                        f0x1Global(i,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                        f0x1Global(i,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(f0xbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        for (size_t j(0); j < f_x.Np(s); ++j) {
-                            f0x1Global(i + outNxLocal*rr,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                            f0x1Global(i + outNxLocal*rr,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                        }
-                    }
-                }
-            }
-        }
-        else 
-        {
-            for(size_t i(0); i < outNxGlobal; i++) 
-            {
-                for (size_t j(0); j < f_x.Np(s); ++j) 
-                {
-                    f0x1Global(i,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                    f0x1Global(i,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                }
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
+        axes.push_back(paxis);
+        axes.push_back(re_im_axis);
 
-        if (PE.RANK() == 0) expo.Export_h5("f0", xaxis, paxis, re_im_axis, f0x1Global, tout, time, dt, s);
+        Export_slab("f0", axes, f0xbuf, grid, tout, time, dt, PE, s);
 
     }
 
@@ -4627,10 +3535,8 @@ void Output_Data::Output_Preprocessor::f10(const State1D& Y, const Grid_Info& gr
   const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
     
     vector<double> re_im_axis;
     re_im_axis.push_back(0.);
@@ -4641,10 +3547,9 @@ void Output_Data::Output_Preprocessor::f10(const State1D& Y, const Grid_Info& gr
     for(int s(0); s < Y.Species(); ++s) {
 
         int msg_sz(2*outNxLocal*f_x.Np(s));
-        Array3D<double> f0x1Global(outNxGlobal,f_x.Np(s),2); //, yglob_axis.dim());
         vector<double> paxis(valtovec(grid.axis.p(s)));
 
-        double f0xbuf[msg_sz];
+        vector<double> f0xbuf(msg_sz);
 
         for (size_t i(0); i < outNxLocal; ++i) {
 
@@ -4658,43 +3563,12 @@ void Output_Data::Output_Preprocessor::f10(const State1D& Y, const Grid_Info& gr
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(f0xbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-
-                    for (size_t j(0); j < f_x.Np(s); ++j) {
-                        f0x1Global(i,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                        f0x1Global(i,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(f0xbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        for (size_t j(0); j < f_x.Np(s); ++j) {
-                            f0x1Global(i + outNxLocal*rr,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                            f0x1Global(i + outNxLocal*rr,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) 
-            {
-                for (size_t j(0); j < f_x.Np(s); ++j) {
-                    f0x1Global(i,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                    f0x1Global(i,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                }
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
+        axes.push_back(paxis);
+        axes.push_back(re_im_axis);
 
-        if (PE.RANK() == 0) expo.Export_h5("f10", xaxis, paxis, re_im_axis, f0x1Global, tout, time, dt, s);
+        Export_slab("f10", axes, f0xbuf, grid, tout, time, dt, PE, s);
 
     }
 
@@ -4705,10 +3579,8 @@ void Output_Data::Output_Preprocessor::f11(const State1D& Y, const Grid_Info& gr
   const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     vector<double> re_im_axis;
     re_im_axis.push_back(0.);
@@ -4719,10 +3591,9 @@ void Output_Data::Output_Preprocessor::f11(const State1D& Y, const Grid_Info& gr
     for(int s(0); s < Y.Species(); ++s) {
 
         int msg_sz(2*outNxLocal*f_x.Np(s));
-        Array3D<double> f0x1Global(outNxGlobal,f_x.Np(s),2); 
         vector<double> paxis(valtovec(grid.axis.p(s)));
 
-        double f0xbuf[msg_sz];
+        vector<double> f0xbuf(msg_sz);
 
         for (size_t i(0); i < outNxLocal; ++i) {
 
@@ -4736,43 +3607,12 @@ void Output_Data::Output_Preprocessor::f11(const State1D& Y, const Grid_Info& gr
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(f0xbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-
-                    for (size_t j(0); j < f_x.Np(s); ++j) {
-                        f0x1Global(i,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                        f0x1Global(i,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(f0xbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        for (size_t j(0); j < f_x.Np(s); ++j) {
-                            f0x1Global(i + outNxLocal*rr,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                            f0x1Global(i + outNxLocal*rr,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                
-                for (size_t j(0); j < f_x.Np(s); ++j) {
-                    f0x1Global(i,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                    f0x1Global(i,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                }
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
+        axes.push_back(paxis);
+        axes.push_back(re_im_axis);
 
-        if (PE.RANK() == 0) expo.Export_h5("f11", xaxis, paxis, re_im_axis, f0x1Global, tout, time, dt, s);
+        Export_slab("f11", axes, f0xbuf, grid, tout, time, dt, PE, s);
     }
 
 
@@ -4783,10 +3623,8 @@ void Output_Data::Output_Preprocessor::f20(const State1D& Y, const Grid_Info& gr
   const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     vector<double> re_im_axis;
     re_im_axis.push_back(0.);
@@ -4799,9 +3637,8 @@ void Output_Data::Output_Preprocessor::f20(const State1D& Y, const Grid_Info& gr
         if (Y.DF(s).l0() > 1)
         {
             int msg_sz(2*outNxLocal*f_x.Np(s));
-            Array3D<double> f0x1Global(outNxGlobal,f_x.Np(s),2); //, yglob_axis.dim());
             vector<double> paxis(valtovec(grid.axis.p(s)));
-            double f0xbuf[msg_sz];
+            vector<double> f0xbuf(msg_sz);
 
             for (size_t i(0); i < outNxLocal; ++i) {
 
@@ -4814,42 +3651,12 @@ void Output_Data::Output_Preprocessor::f20(const State1D& Y, const Grid_Info& gr
 
             }
 
-            if (PE.MPI_Processes() > 1) {
-                if (PE.RANK()!=0) {
-                    MPI_Send(f0xbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-                }
-                else {
-                    // Fill data for rank = 0
-                    for(size_t i(0); i < outNxLocal; i++) {
-
-                        for (size_t j(0); j < f_x.Np(s); ++j) {
-                            f0x1Global(i,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                            f0x1Global(i,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                        }
-                    }
-                    // Fill data for rank > 0
-                    for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                        MPI_Recv(f0xbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                        for(size_t i(0); i < outNxLocal; i++) {
-                            for (size_t j(0); j < f_x.Np(s); ++j) {
-                                f0x1Global(i + outNxLocal*rr,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                                f0x1Global(i + outNxLocal*rr,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                            }
-                        }
-                    }
-                }
-            }
-            else {
-                for(size_t i(0); i < outNxGlobal; i++) {
-                    for (size_t j(0); j < f_x.Np(s); ++j) {
-                        f0x1Global(i,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                        f0x1Global(i,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                    }
-                }
-            }
+            vector< vector<double> > axes;
+            axes.push_back(xaxis);
+            axes.push_back(paxis);
+            axes.push_back(re_im_axis);
 
-            if (PE.RANK() == 0) expo.Export_h5("f20", xaxis, paxis, re_im_axis, f0x1Global, tout, time, dt, s);
+            Export_slab("f20", axes, f0xbuf, grid, tout, time, dt, PE, s);
 
         }
     }
@@ -4862,10 +3669,8 @@ void Output_Data::Output_Preprocessor::fl0(const State1D& Y, const Grid_Info& gr
   const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     vector<double> re_im_axis;
     re_im_axis.push_back(0.);
@@ -4876,10 +3681,9 @@ void Output_Data::Output_Preprocessor::fl0(const State1D& Y, const Grid_Info& gr
     for(int s(0); s < Y.Species(); ++s) {
 
         int msg_sz(2*outNxLocal*f_x.Np(s));
-        Array3D<double> f0x1Global(outNxGlobal,f_x.Np(s),2);
         vector<double> paxis(valtovec(grid.axis.p(s)));
 
-        double f0xbuf[msg_sz];
+        vector<double> f0xbuf(msg_sz);
 
         for (size_t i(0); i < outNxLocal; ++i) {
 
@@ -4892,42 +3696,12 @@ void Output_Data::Output_Preprocessor::fl0(const State1D& Y, const Grid_Info& gr
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(f0xbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-
-                    for (size_t j(0); j < f_x.Np(s); ++j) {
-                        f0x1Global(i,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                        f0x1Global(i,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(f0xbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        for (size_t j(0); j < f_x.Np(s); ++j) {
-                            f0x1Global(i + outNxLocal*rr,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                            f0x1Global(i + outNxLocal*rr,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                for (size_t j(0); j < f_x.Np(s); ++j) {
-                    f0x1Global(i,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                    f0x1Global(i,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                }
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
+        axes.push_back(paxis);
+        axes.push_back(re_im_axis);
 
-        if (PE.RANK() == 0) expo.Export_h5("fl0", xaxis, paxis, re_im_axis, f0x1Global, tout, time, dt, s);
+        Export_slab("fl0", axes, f0xbuf, grid, tout, time, dt, PE, s);
 
     }
 
@@ -4938,13 +3712,9 @@ void Output_Data::Output_Preprocessor::fl0(const State1D& Y, const Grid_Info& gr
 void Output_Data::Output_Preprocessor::f0(const State2D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
                                              const Parallel_Environment_2D& PE) {
     size_t Nbc(Input::List().BoundaryCells);
-    MPI_Status status;
     size_t i(0);
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
     size_t outNyLocal(grid.axis.Nx(1) - 2 * Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
-    size_t outNyGlobal(grid.axis.Nxg(1));
-    int rankx,ranky;
     
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
@@ -4955,8 +3725,7 @@ void Output_Data::Output_Preprocessor::f0(const State2D& Y, const Grid_Info& gri
 
     for(int s(0); s < Y.Species(); ++s) {
         int msg_sz(2*outNxLocal*outNyLocal*f_x.Np(s));
-        Array4D<double> global(outNxGlobal,outNyGlobal,f_x.Np(s),2); //, yglob_axis.dim());
-        double buf[msg_sz];
+        vector<double> buf(msg_sz);
         vector<double> paxis(valtovec(grid.axis.p(s)));
 
         i=0;
@@ -4975,54 +3744,13 @@ void Output_Data::Output_Preprocessor::f0(const State2D& Y, const Grid_Info& gri
 
         }
 
-            if (PE.MPI_Processes() > 1) {
-                if (PE.RANK()!=0) {
-                    MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-                }
-                else {
-                    // Fill data for rank = 0
-                    i=0;
-                    for (size_t ix(0); ix < outNxLocal; ++ix) {
-                        for (size_t iy(0); iy < outNyLocal; ++iy) {
-                            for (size_t j(0); j < f_x.Np(s); ++j) {
-                                global(ix, iy, j, 0) = buf[i];
-                                global(ix, iy, j, 1) = buf[i+1];
-                                i+=2;
-                            }
-                        }
-                    }
-                    // Fill data for rank > 0
-                    for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                        MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                        rankx = rr % PE.MPI_X();
-                        ranky = rr / PE.MPI_X();
-                        i=0;
-                        for (size_t ix(0); ix < outNxLocal; ++ix) {
-                            for (size_t iy(0); iy < outNyLocal; ++iy) {
-                                for (size_t j(0); j < f_x.Np(s); ++j) {
-                                    global(ix + outNxLocal * rankx, iy + outNyLocal * ranky, j, 0) = buf[i];
-                                    global(ix + outNxLocal * rankx, iy + outNyLocal * ranky, j, 1) = buf[i+1];
-                                    i+=2;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            else {
-                i=0;
-                for (size_t ix(0); ix < outNxLocal; ++ix) {
-                    for (size_t iy(0); iy < outNyLocal; ++iy) {
-                        for (size_t j(0); j < f_x.Np(s); ++j) {
-                            global(ix, iy, j, 0) = buf[i];
-                            global(ix, iy, j, 1) = buf[i+1];
-                            i+=2;
-                        }
-                    }
-                }
-            }
+            vector< vector<double> > axes;
+            axes.push_back(xaxis);
+            axes.push_back(yaxis);
+            axes.push_back(paxis);
+            axes.push_back(re_im_axis);
 
-            if (PE.RANK() == 0) expo.Export_h5("f0", xaxis, yaxis, paxis, re_im_axis, global, tout, time, dt, s);
+            Export_slab("f0", axes, buf, grid, tout, time, dt, PE, s);
 
         }
 
@@ -5032,13 +3760,9 @@ void Output_Data::Output_Preprocessor::f0(const State2D& Y, const Grid_Info& gri
     void Output_Data::Output_Preprocessor::f10(const State2D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
                                                  const Parallel_Environment_2D& PE) {
         size_t Nbc(Input::List().BoundaryCells);
-        MPI_Status status;
         size_t i(0);
         size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
         size_t outNyLocal(grid.axis.Nx(1) - 2 * Nbc);
-        size_t outNxGlobal(grid.axis.Nxg(0));
-        size_t outNyGlobal(grid.axis.Nxg(1));
-        int rankx,ranky;
         vector<double> xaxis(valtovec(grid.axis.xg(0)));
         vector<double> yaxis(valtovec(grid.axis.xg(1)));
 
@@ -5049,10 +3773,9 @@ void Output_Data::Output_Preprocessor::f0(const State2D& Y, const Grid_Info& gri
 
         for(int s(0); s < Y.Species(); ++s) {
             int msg_sz(2*outNxLocal*outNyLocal*f_x.Np(s));
-            Array4D<double> global(outNxGlobal,outNyGlobal,f_x.Np(s),2);
             vector<double> paxis(valtovec(grid.axis.p(s)));
 
-            double buf[msg_sz];
+            vector<double> buf(msg_sz);
             i=0;
             for (size_t ix(0); ix < outNxLocal; ++ix) {
                 for (size_t iy(0); iy < outNyLocal; ++iy) {
@@ -5066,54 +3789,13 @@ void Output_Data::Output_Preprocessor::f0(const State2D& Y, const Grid_Info& gri
                 }
             }
 
-                if (PE.MPI_Processes() > 1) {
-                    if (PE.RANK()!=0) {
-                        MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-                    }
-                    else {
-                        // Fill data for rank = 0
-                        i=0;
-                        for (size_t ix(0); ix < outNxLocal; ++ix) {
-                            for (size_t iy(0); iy < outNyLocal; ++iy) {
-                                for (size_t j(0); j < f_x.Np(s); ++j) {
-                                    global(ix, iy, j, 0) = buf[i];
-                                    global(ix, iy, j, 1) = buf[i+1];
-                                    i+=2;
-                                }
-                            }
-                        }
-                        // Fill data for rank > 0
-                        for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                            MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                            rankx = rr % PE.MPI_X();
-                            ranky = rr / PE.MPI_X();
-                            i=0;
-                            for (size_t ix(0); ix < outNxLocal; ++ix) {
-                                for (size_t iy(0); iy < outNyLocal; ++iy) {
-                                    for (size_t j(0); j < f_x.Np(s); ++j) {
-                                        global(ix + outNxLocal * rankx, iy + outNyLocal * ranky, j, 0) = buf[i];
-                                        global(ix + outNxLocal * rankx, iy + outNyLocal * ranky, j, 1) = buf[i+1];
-                                        i+=2;
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-                else {
-                    i=0;
-                    for (size_t ix(0); ix < outNxLocal; ++ix) {
-                        for (size_t iy(0); iy < outNyLocal; ++iy) {
-                            for (size_t j(0); j < f_x.Np(s); ++j) {
-                                global(ix, iy, j, 0) = buf[i];
-                                global(ix, iy, j, 1) = buf[i+1];
-                                i+=2;
-                            }
-                        }
-                    }
-                }
+                vector< vector<double> > axes;
+                axes.push_back(xaxis);
+                axes.push_back(yaxis);
+                axes.push_back(paxis);
+                axes.push_back(re_im_axis);
 
-                if (PE.RANK() == 0) expo.Export_h5("f10", xaxis, yaxis, paxis, re_im_axis, global, tout, time, dt, s);
+                Export_slab("f10", axes, buf, grid, tout, time, dt, PE, s);
 
             }
 
@@ -5123,13 +3805,9 @@ void Output_Data::Output_Preprocessor::f0(const State2D& Y, const Grid_Info& gri
 void Output_Data::Output_Preprocessor::f11(const State2D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
                                              const Parallel_Environment_2D& PE) {
     size_t Nbc(Input::List().BoundaryCells);
-    MPI_Status status;
     size_t i(0);
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
     size_t outNyLocal(grid.axis.Nx(1) - 2 * Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
-    size_t outNyGlobal(grid.axis.Nxg(1));
-    int rankx,ranky;
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
 
@@ -5139,8 +3817,7 @@ void Output_Data::Output_Preprocessor::f11(const State2D& Y, const Grid_Info& gr
 
     for(int s(0); s < Y.Species(); ++s) {
         int msg_sz(2*outNxLocal*outNyLocal*f_x.Np(s));
-        Array4D<double> global(outNxGlobal,outNyGlobal,f_x.Np(s),2);
-        double buf[msg_sz];
+        vector<double> buf(msg_sz);
         vector<double> paxis(valtovec(grid.axis.p(s)));
 
         i=0;
@@ -5159,54 +3836,13 @@ void Output_Data::Output_Preprocessor::f11(const State2D& Y, const Grid_Info& gr
 
         }
 
-            if (PE.MPI_Processes() > 1) {
-                if (PE.RANK()!=0) {
-                    MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-                }
-                else {
-                    // Fill data for rank = 0
-                    i=0;
-                    for (size_t ix(0); ix < outNxLocal; ++ix) {
-                        for (size_t iy(0); iy < outNyLocal; ++iy) {
-                            for (size_t j(0); j < f_x.Np(s); ++j) {
-                                global(ix, iy, j, 0) = buf[i];
-                                global(ix, iy, j, 1) = buf[i+1];
-                                i+=2;
-                            }
-                        }
-                    }
-                    // Fill data for rank > 0
-                    for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                        MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                        rankx = rr % PE.MPI_X();
-                        ranky = rr / PE.MPI_X();
-                        i=0;
-                        for (size_t ix(0); ix < outNxLocal; ++ix) {
-                            for (size_t iy(0); iy < outNyLocal; ++iy) {
-                                for (size_t j(0); j < f_x.Np(s); ++j) {
-                                    global(ix + outNxLocal * rankx, iy + outNyLocal * ranky, j, 0) = buf[i];
-                                    global(ix + outNxLocal * rankx, iy + outNyLocal * ranky, j, 1) = buf[i+1];
-                                    i+=2;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            else {
-                i=0;
-                for (size_t ix(0); ix < outNxLocal; ++ix) {
-                    for (size_t iy(0); iy < outNyLocal; ++iy) {
-                        for (size_t j(0); j < f_x.Np(s); ++j) {
-                            global(ix, iy, j, 0) = buf[i];
-                            global(ix, iy, j, 1) = buf[i+1];
-                            i+=2;
-                        }
-                    }
-                }
-            }
+            vector< vector<double> > axes;
+            axes.push_back(xaxis);
+            axes.push_back(yaxis);
+            axes.push_back(paxis);
+            axes.push_back(re_im_axis);
 
-            if (PE.RANK() == 0) expo.Export_h5("f11", xaxis, yaxis, paxis, re_im_axis, global, tout, time, dt, s);
+            Export_slab("f11", axes, buf, grid, tout, time, dt, PE, s);
 
         }
 
@@ -5216,13 +3852,9 @@ void Output_Data::Output_Preprocessor::f11(const State2D& Y, const Grid_Info& gr
 void Output_Data::Output_Preprocessor::f20(const State2D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
                                              const Parallel_Environment_2D& PE) {
     size_t Nbc(Input::List().BoundaryCells);
-    MPI_Status status;
     size_t i(0);
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
     size_t outNyLocal(grid.axis.Nx(1) - 2 * Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
-    size_t outNyGlobal(grid.axis.Nxg(1));
-    int rankx,ranky;
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
 
@@ -5230,13 +3862,12 @@ void Output_Data::Output_Preprocessor::f20(const State2D& Y, const Grid_Info& gr
     re_im_axis.push_back(0.);
     re_im_axis.push_back(1.);
 
-//    double buf[msg_sz];
+//    vector<double> buf(msg_sz);
 //    Array2D<double> global(outNxGlobal,outNyGlobal); //, yglob_axis.dim());
 
     for(int s(0); s < Y.Species(); ++s) {
         int msg_sz(2*outNxLocal*outNyLocal*f_x.Np(s));
-        Array4D<double> global(outNxGlobal,outNyGlobal,f_x.Np(s),2); //, yglob_axis.dim());
-        double buf[msg_sz];
+        vector<double> buf(msg_sz);
         vector<double> paxis(valtovec(grid.axis.p(s)));
 
 
@@ -5256,54 +3887,13 @@ void Output_Data::Output_Preprocessor::f20(const State2D& Y, const Grid_Info& gr
 
         }
 
-            if (PE.MPI_Processes() > 1) {
-                if (PE.RANK()!=0) {
-                    MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-                }
-                else {
-                    // Fill data for rank = 0
-                    i=0;
-                    for (size_t ix(0); ix < outNxLocal; ++ix) {
-                        for (size_t iy(0); iy < outNyLocal; ++iy) {
-                            for (size_t j(0); j < f_x.Np(s); ++j) {
-                                global(ix, iy, j, 0) = buf[i];
-                                global(ix, iy, j, 1) = buf[i+1];
-                                i+=2;
-                            }
-                        }
-                    }
-                    // Fill data for rank > 0
-                    for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                        MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                        rankx = rr % PE.MPI_X();
-                        ranky = rr / PE.MPI_X();
-                        i=0;
-                        for (size_t ix(0); ix < outNxLocal; ++ix) {
-                            for (size_t iy(0); iy < outNyLocal; ++iy) {
-                                for (size_t j(0); j < f_x.Np(s); ++j) {
-                                    global(ix + outNxLocal * rankx, iy + outNyLocal * ranky, j, 0) = buf[i];
-                                    global(ix + outNxLocal * rankx, iy + outNyLocal * ranky, j, 1) = buf[i+1];
-                                    i+=2;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            else {
-                i=0;
-                for (size_t ix(0); ix < outNxLocal; ++ix) {
-                    for (size_t iy(0); iy < outNyLocal; ++iy) {
-                        for (size_t j(0); j < f_x.Np(s); ++j) {
-                            global(ix, iy, j, 0) = buf[i];
-                            global(ix, iy, j, 1) = buf[i+1];
-                            i+=2;
-                        }
-                    }
-                }
-            }
+            vector< vector<double> > axes;
+            axes.push_back(xaxis);
+            axes.push_back(yaxis);
+            axes.push_back(paxis);
+            axes.push_back(re_im_axis);
 
-            if (PE.RANK() == 0) expo.Export_h5("f20", xaxis, yaxis, paxis, re_im_axis, global, tout, time, dt, s);
+            Export_slab("f20", axes, buf, grid, tout, time, dt, PE, s);
 
         }
 
@@ -5313,13 +3903,9 @@ void Output_Data::Output_Preprocessor::f20(const State2D& Y, const Grid_Info& gr
 void Output_Data::Output_Preprocessor::fl0(const State2D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
                                              const Parallel_Environment_2D& PE) {
     size_t Nbc(Input::List().BoundaryCells);
-    MPI_Status status;
     size_t i(0);
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
     size_t outNyLocal(grid.axis.Nx(1) - 2 * Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
-    size_t outNyGlobal(grid.axis.Nxg(1));
-    int rankx,ranky;
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
 
@@ -5327,13 +3913,12 @@ void Output_Data::Output_Preprocessor::fl0(const State2D& Y, const Grid_Info& gr
     re_im_axis.push_back(0.);
     re_im_axis.push_back(1.);
 
-//    double buf[msg_sz];
+//    vector<double> buf(msg_sz);
 //    Array2D<double> global(outNxGlobal,outNyGlobal); //, yglob_axis.dim());
 
     for(int s(0); s < Y.Species(); ++s) {
         int msg_sz(2*outNxLocal*outNyLocal*f_x.Np(s));
-        Array4D<double> global(outNxGlobal,outNyGlobal,f_x.Np(s),2); //, yglob_axis.dim());
-        double buf[msg_sz];
+        vector<double> buf(msg_sz);
         vector<double> paxis(valtovec(grid.axis.p(s)));
 
         i=0;
@@ -5352,54 +3937,13 @@ void Output_Data::Output_Preprocessor::fl0(const State2D& Y, const Grid_Info& gr
 
         }
 
-            if (PE.MPI_Processes() > 1) {
-                if (PE.RANK()!=0) {
-                    MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-                }
-                else {
-                    // Fill data for rank = 0
-                    i=0;
-                    for (size_t ix(0); ix < outNxLocal; ++ix) {
-                        for (size_t iy(0); iy < outNyLocal; ++iy) {
-                            for (size_t j(0); j < f_x.Np(s); ++j) {
-                                global(ix, iy, j, 0) = buf[i];
-                                global(ix, iy, j, 1) = buf[i+1];
-                                i+=2;
-                            }
-                        }
-                    }
-                    // Fill data for rank > 0
-                    for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                        MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                        rankx = rr % PE.MPI_X();
-                        ranky = rr / PE.MPI_X();
-                        i=0;
-                        for (size_t ix(0); ix < outNxLocal; ++ix) {
-                            for (size_t iy(0); iy < outNyLocal; ++iy) {
-                                for (size_t j(0); j < f_x.Np(s); ++j) {
-                                    global(ix + outNxLocal * rankx, iy + outNyLocal * ranky, j, 0) = buf[i];
-                                    global(ix + outNxLocal * rankx, iy + outNyLocal * ranky, j, 1) = buf[i+1];
-                                    i+=2;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            else {
-                i=0;
-                for (size_t ix(0); ix < outNxLocal; ++ix) {
-                    for (size_t iy(0); iy < outNyLocal; ++iy) {
-                        for (size_t j(0); j < f_x.Np(s); ++j) {
-                            global(ix, iy, j, 0) = buf[i];
-                            global(ix, iy, j, 1) = buf[i+1];
-                            i+=2;
-                        }
-                    }
-                }
-            }
+            vector< vector<double> > axes;
+            axes.push_back(xaxis);
+            axes.push_back(yaxis);
+            axes.push_back(paxis);
+            axes.push_back(re_im_axis);
 
-            if (PE.RANK() == 0) expo.Export_h5("fl0", xaxis, yaxis, paxis, re_im_axis, global, tout, time, dt, s);
+            Export_slab("fl0", axes, buf, grid, tout, time, dt, PE, s);
 
         }
 
@@ -5412,14 +3956,11 @@ void Output_Data::Output_Preprocessor::n(const State1D& Y, const Grid_Info& grid
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
      
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
-    double nbuf[msg_sz];
-    vector<double> nGlobal(outNxGlobal); 
+    vector<double> nbuf(msg_sz);
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     for(int s(0); s < Y.Species(); ++s) {
@@ -5428,32 +3969,10 @@ void Output_Data::Output_Preprocessor::n(const State1D& Y, const Grid_Info& grid
             nbuf[i] = 4.0*M_PI*Algorithms::moment(  vdouble_real( (Y.SH(s,0,0)).xVec(i+Nbc) ), pra, 2);
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(nbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    nGlobal[i] = nbuf[i];
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(nbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        nGlobal[i + outNxLocal*rr] = nbuf[i];
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                nGlobal[i] = nbuf[i];
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
 
-        if (PE.RANK() == 0) expo.Export_h5("n", xaxis, nGlobal, tout, time, dt, s);
+        Export_slab("n", axes, nbuf, grid, tout, time, dt, PE, s);
 
     }
 
@@ -5465,42 +3984,17 @@ void Output_Data::Output_Preprocessor::particles_x(const State1D& Y, const Grid_
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     int msg_sz(Y.particles().numpar()) ; 
-    double buf[msg_sz];
+    vector<double> buf(msg_sz);
     vector<double> pGlobal(Y.particles().numpar()); 
 
     for (int ip(0); ip < Y.particles().numpar(); ++ip) {
         buf[ip] = Y.particles().x(ip)* (double (Y.particles().ishere(ip)));
     }
 
-
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            for(size_t i(0); i < msg_sz; i++) {
-                pGlobal[i] += buf[i];
-            }
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                for(size_t i(0); i < msg_sz; i++) {
-                    pGlobal[i] += buf[i];
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        for(size_t i(0); i < msg_sz; i++) {
-            pGlobal[i] = buf[i];
-        }
-    }
-    
+    // The particles not on this node hold 0
+    MPI_Reduce(&buf[0], &pGlobal[0], msg_sz, MPI_DOUBLE, MPI_SUM, 0, Harmonic_Group::Space());
 
     // if (PE.RANK() == 0) expo.Export_h5("prtx", pGlobal, tout, time, dt);
 
@@ -5513,10 +4007,9 @@ void Output_Data::Output_Preprocessor::particles_px(const State1D& Y, const Grid
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     int msg_sz(Y.particles().numpar()) ; 
-    double buf[msg_sz];
+    vector<double> buf(msg_sz);
     vector<double> pGlobal(Y.particles().numpar()); 
 
     for (int ip(0); ip < Y.particles().numpar(); ++ip) {
@@ -5524,30 +4017,7 @@ void Output_Data::Output_Preprocessor::particles_px(const State1D& Y, const Grid
     }
 
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            for(size_t i(0); i < msg_sz; i++) {
-                pGlobal[i] += buf[i];
-            }
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                for(size_t i(0); i < msg_sz; i++) {
-                    pGlobal[i] += buf[i];
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        for(size_t i(0); i < msg_sz; i++) {
-            pGlobal[i] = buf[i];
-        }
-    }
+    MPI_Reduce(&buf[0], &pGlobal[0], msg_sz, MPI_DOUBLE, MPI_SUM, 0, Harmonic_Group::Space());
 
     // if (PE.RANK() == 0) expo.Export_h5("prtpx", pGlobal, tout, time, dt);
 
@@ -5560,10 +4030,9 @@ void Output_Data::Output_Preprocessor::particles_py(const State1D& Y, const Grid
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     int msg_sz(Y.particles().numpar()) ; 
-    double buf[msg_sz];
+    vector<double> buf(msg_sz);
     vector<double> pGlobal(Y.particles().numpar()); 
 
     for (int ip(0); ip < Y.particles().numpar(); ++ip) {
@@ -5571,30 +4040,7 @@ void Output_Data::Output_Preprocessor::particles_py(const State1D& Y, const Grid
     }
 
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            for(size_t i(0); i < msg_sz; i++) {
-                pGlobal[i] += buf[i];
-            }
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                for(size_t i(0); i < msg_sz; i++) {
-                    pGlobal[i] += buf[i];
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        for(size_t i(0); i < msg_sz; i++) {
-            pGlobal[i] = buf[i];
-        }
-    }
+    MPI_Reduce(&buf[0], &pGlobal[0], msg_sz, MPI_DOUBLE, MPI_SUM, 0, Harmonic_Group::Space());
 
     // if (PE.RANK() == 0) expo.Export_h5("prtpy", pGlobal, tout, time, dt);
 
@@ -5607,10 +4053,9 @@ void Output_Data::Output_Preprocessor::particles_pz(const State1D& Y, const Grid
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     int msg_sz(Y.particles().numpar()) ; 
-    double buf[msg_sz];
+    vector<double> buf(msg_sz);
     vector<double> pGlobal(Y.particles().numpar()); 
 
     for (int ip(0); ip < Y.particles().numpar(); ++ip) {
@@ -5618,30 +4063,7 @@ void Output_Data::Output_Preprocessor::particles_pz(const State1D& Y, const Grid
     }
 
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            for(size_t i(0); i < msg_sz; i++) {
-                pGlobal[i] += buf[i];
-            }
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                for(size_t i(0); i < msg_sz; i++) {
-                    pGlobal[i] += buf[i];
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        for(size_t i(0); i < msg_sz; i++) {
-            pGlobal[i] = buf[i];
-        }
-    }
+    MPI_Reduce(&buf[0], &pGlobal[0], msg_sz, MPI_DOUBLE, MPI_SUM, 0, Harmonic_Group::Space());
 
     // if (PE.RANK() == 0) expo.Export_h5("prtpz", pGlobal, tout, time, dt);
 
@@ -5652,15 +4074,12 @@ void Output_Data::Output_Preprocessor::T(const State1D& Y, const Grid_Info& grid
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     //  
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal);
     
-    double tbuf[msg_sz];
-    vector<double> tGlobal(outNxGlobal); 
+    vector<double> tbuf(msg_sz);
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     double convert_factor = (2.99792458e8)*(2.99792458e8)*(9.1093829e-31)/(1.602176565e-19);
@@ -5675,32 +4094,10 @@ void Output_Data::Output_Preprocessor::T(const State1D& Y, const Grid_Info& grid
             tbuf[i] *= 1.0/Y.DF(s).mass();
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(tbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    tGlobal[i] = tbuf[i];
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(tbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        tGlobal[i + outNxLocal*rr] = tbuf[i];
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                tGlobal[i] = tbuf[i];
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
 
-        if (PE.RANK() == 0) expo.Export_h5("T", xaxis, tGlobal, tout, time, dt, s);
+        Export_slab("T", axes, tbuf, grid, tout, time, dt, PE, s);
 
     }
 
@@ -5713,14 +4110,11 @@ void Output_Data::Output_Preprocessor::Jx(const State1D& Y, const Grid_Info& gri
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     //  
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal);
-    double Jxbuf[msg_sz];
-    vector<double> JxGlobal(outNxGlobal); 
+    vector<double> Jxbuf(msg_sz);
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     for(int s(0); s < Y.Species(); ++s) 
@@ -5731,32 +4125,10 @@ void Output_Data::Output_Preprocessor::Jx(const State1D& Y, const Grid_Info& gri
             Jxbuf[i] = Y.DF(s).q()*4.0/3.0*M_PI*Algorithms::moment(  vdouble_real( (Y.SH(s,1,0)).xVec(i+Nbc) ), pra, 3);
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(Jxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    JxGlobal[i] = Jxbuf[i];
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(Jxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        JxGlobal[i + outNxLocal*rr] = Jxbuf[i];
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                JxGlobal[i] = Jxbuf[i];
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
 
-        if (PE.RANK() == 0) expo.Export_h5("Jx", xaxis, JxGlobal, tout, time, dt, s);
+        Export_slab("Jx", axes, Jxbuf, grid, tout, time, dt, PE, s);
 
     }
 
@@ -5770,14 +4142,11 @@ void Output_Data::Output_Preprocessor::Jy(const State1D& Y, const Grid_Info& gri
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     //  
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal);
-    double Jybuf[msg_sz];
-    vector<double> JyGlobal(outNxGlobal); 
+    vector<double> Jybuf(msg_sz);
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     for(int s(0); s < Y.Species(); ++s) 
@@ -5788,32 +4157,10 @@ void Output_Data::Output_Preprocessor::Jy(const State1D& Y, const Grid_Info& gri
             Jybuf[i] = Y.DF(s).q()*8.0/3.0*M_PI*Algorithms::moment(  vdouble_real( (Y.SH(s,1,1)).xVec(i+Nbc) ), pra, 3);
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(Jybuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    JyGlobal[i] = Jybuf[i];
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(Jybuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        JyGlobal[i + outNxLocal*rr] = Jybuf[i];
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                JyGlobal[i] = Jybuf[i];
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
 
-        if (PE.RANK() == 0) expo.Export_h5("Jy", xaxis, JyGlobal, tout, time, dt, s);
+        Export_slab("Jy", axes, Jybuf, grid, tout, time, dt, PE, s);
 
     }
 
@@ -5826,14 +4173,11 @@ void Output_Data::Output_Preprocessor::Jz(const State1D& Y, const Grid_Info& gri
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     //  
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal);
-    double Jzbuf[msg_sz];
-    vector<double> JzGlobal(outNxGlobal); 
+    vector<double> Jzbuf(msg_sz);
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     for(int s(0); s < Y.Species(); ++s) 
@@ -5843,32 +4187,10 @@ void Output_Data::Output_Preprocessor::Jz(const State1D& Y, const Grid_Info& gri
             Jzbuf[i] = Y.DF(s).q()*-8.0/3.0*M_PI*Algorithms::moment(  vdouble_imag( (Y.SH(s,1,1)).xVec(i+Nbc) ), pra, 3);
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(Jzbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    JzGlobal[i] = Jzbuf[i];
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(Jzbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        JzGlobal[i + outNxLocal*rr] = Jzbuf[i];
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                JzGlobal[i] = Jzbuf[i];
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
 
-        if (PE.RANK() == 0) expo.Export_h5("Jz", xaxis, JzGlobal, tout, time, dt, s);
+        Export_slab("Jz", axes, Jzbuf, grid, tout, time, dt, PE, s);
 
     }
 
@@ -5880,53 +4202,28 @@ void Output_Data::Output_Preprocessor::Qx(const State1D& Y, const Grid_Info& gri
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
 
-    double Qxbuf[msg_sz];
+    vector<double> Qxbuf(msg_sz);
 
-    vector<double> QxGlobal(outNxGlobal); 
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     for(int s(0); s < Y.Species(); ++s) {
 
         valarray<double> pra( (grid.axis.p(s)) );
         for(size_t i(0); i < msg_sz; ++i) {
-
-            Qxbuf[i] = 4.0*M_PI/3.0*Y.DF(s).mass()*Algorithms::moment(  vdouble_real( (Y.SH(s,1,0)).xVec(i+Nbc) ), pra, 5);
-            Qxbuf[i] *= 0.5;
-        }
-
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(Qxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    QxGlobal[i] = Qxbuf[i];
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(Qxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        QxGlobal[i + outNxLocal*rr] = Qxbuf[i];
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                QxGlobal[i] = Qxbuf[i];
-            }
+
+            Qxbuf[i] = 4.0*M_PI/3.0*Y.DF(s).mass()*Algorithms::moment(  vdouble_real( (Y.SH(s,1,0)).xVec(i+Nbc) ), pra, 5);
+            Qxbuf[i] *= 0.5;
         }
 
-        if (PE.RANK() == 0) expo.Export_h5("Qx", xaxis, QxGlobal, tout, time, dt, s);
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
+
+        Export_slab("Qx", axes, Qxbuf, grid, tout, time, dt, PE, s);
 
     }
 
@@ -5939,15 +4236,12 @@ void Output_Data::Output_Preprocessor::Qy(const State1D& Y, const Grid_Info& gri
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
 
-    double Qxbuf[msg_sz];
-    vector<double> QxGlobal(outNxGlobal); 
+    vector<double> Qxbuf(msg_sz);
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     for(int s(0); s < Y.Species(); ++s) {
@@ -5959,32 +4253,10 @@ void Output_Data::Output_Preprocessor::Qy(const State1D& Y, const Grid_Info& gri
 
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(Qxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    QxGlobal[i] = Qxbuf[i];
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(Qxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        QxGlobal[i + outNxLocal*rr] = Qxbuf[i];
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                QxGlobal[i] = Qxbuf[i];
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
 
-        if (PE.RANK() == 0) expo.Export_h5("Qy", xaxis, QxGlobal, tout, time, dt, s);
+        Export_slab("Qy", axes, Qxbuf, grid, tout, time, dt, PE, s);
 
     }
 
@@ -5997,15 +4269,12 @@ void Output_Data::Output_Preprocessor::Qz(const State1D& Y, const Grid_Info& gri
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
 
-    double Qxbuf[msg_sz];
-    vector<double> QxGlobal(outNxGlobal);
+    vector<double> Qxbuf(msg_sz);
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     for(int s(0); s < Y.Species(); ++s) 
@@ -6019,32 +4288,10 @@ void Output_Data::Output_Preprocessor::Qz(const State1D& Y, const Grid_Info& gri
             Qxbuf[i] *= 0.5;
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(Qxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    QxGlobal[i] = Qxbuf[i];
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(Qxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        QxGlobal[i + outNxLocal*rr] = Qxbuf[i];
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                QxGlobal[i] = Qxbuf[i];
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
 
-        if (PE.RANK() == 0) expo.Export_h5("Qz", xaxis, QxGlobal, tout, time, dt, s);
+        Export_slab("Qz", axes, Qxbuf, grid, tout, time, dt, PE, s);
 
     }
 
@@ -6058,14 +4305,11 @@ void Output_Data::Output_Preprocessor::vNx(const State1D& Y, const Grid_Info& gr
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     //  
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
-    double vNxbuf[msg_sz];
-    vector<double> vNxGlobal(outNxGlobal);
+    vector<double> vNxbuf(msg_sz);
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     for(int s(0); s < Y.Species(); ++s) {
@@ -6079,32 +4323,10 @@ void Output_Data::Output_Preprocessor::vNx(const State1D& Y, const Grid_Info& gr
               / Algorithms::moment(  vdouble_real( (Y.SH(s,0,0)).xVec(i+Nbc) ), pra, 5))) );
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(vNxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    vNxGlobal[i] = vNxbuf[i];
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(vNxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        vNxGlobal[i + outNxLocal*rr] = vNxbuf[i];
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                vNxGlobal[i] = vNxbuf[i];
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
 
-        if (PE.RANK() == 0) expo.Export_h5("vNx", xaxis, vNxGlobal, tout, time, dt, 0);
+        Export_slab("vNx", axes, vNxbuf, grid, tout, time, dt, PE, 0);
 
     }
 
@@ -6116,13 +4338,10 @@ void Output_Data::Output_Preprocessor::vNy(const State1D& Y, const Grid_Info& gr
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
-    double vNxbuf[msg_sz];
-    vector<double> vNxGlobal(outNxGlobal);
+    vector<double> vNxbuf(msg_sz);
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     for(int s(0); s < Y.Species(); ++s) {
@@ -6133,31 +4352,10 @@ void Output_Data::Output_Preprocessor::vNy(const State1D& Y, const Grid_Info& gr
             vNxbuf[i] = static_cast<double>( (2.0 / 6.0 * (Algorithms::moment(vdouble_real((Y.SH(s, 1, 1)).xVec(i + Nbc) ), pra, 6)
               / Algorithms::moment(  vdouble_real( (Y.SH(s,0,0)).xVec(i+Nbc) ), pra, 5))) );
         }
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(vNxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    vNxGlobal[i] = vNxbuf[i];
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(vNxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        vNxGlobal[i + outNxLocal*rr] = vNxbuf[i];
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                vNxGlobal[i] = vNxbuf[i];
-            }
-        }
-        if (PE.RANK() == 0) expo.Export_h5("vNy", xaxis, vNxGlobal, tout, time, dt, 0);
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
+
+        Export_slab("vNy", axes, vNxbuf, grid, tout, time, dt, PE, 0);
     }
 }
 // --------------------------------------------------------------
@@ -6168,13 +4366,10 @@ void Output_Data::Output_Preprocessor::vNz(const State1D& Y, const Grid_Info& gr
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal);
-    double vNxbuf[msg_sz];
-    vector<double> vNxGlobal(outNxGlobal);
+    vector<double> vNxbuf(msg_sz);
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     for(int s(0); s < Y.Species(); ++s) {
@@ -6186,31 +4381,10 @@ void Output_Data::Output_Preprocessor::vNz(const State1D& Y, const Grid_Info& gr
             vNxbuf[i] = static_cast<double>( (-2.0 / 6.0 * (Algorithms::moment(vdouble_imag((Y.SH(s, 1, 1)).xVec(i + Nbc) ), pra, 6)
                / Algorithms::moment(  vdouble_real( (Y.SH(s,0,0)).xVec(i+Nbc) ), pra, 5))));
         }
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(vNxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    vNxGlobal[i] = vNxbuf[i];
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(vNxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        vNxGlobal[i + outNxLocal*rr] = vNxbuf[i];
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                vNxGlobal[i] = vNxbuf[i];
-            }
-        }
-        if (PE.RANK() == 0) expo.Export_h5("vNz", xaxis, vNxGlobal, tout, time, dt, 0);
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
+
+        Export_slab("vNz", axes, vNxbuf, grid, tout, time, dt, PE, 0);
     }
     
 }
@@ -6221,16 +4395,12 @@ void Output_Data::Output_Preprocessor::n(const State2D& Y, const Grid_Info& grid
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     size_t i(0);
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc), outNyLocal(grid.axis.Nx(1) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0)), outNyGlobal(grid.axis.Nxg(1));
 
     int msg_sz(outNxLocal*outNyLocal); //*szy);
-    double nbuf[msg_sz];
-    Array2D<double> nGlobal(outNxGlobal,outNyGlobal); //, yglob_axis.dim());
+    vector<double> nbuf(msg_sz);
 
-    int rankx,ranky;
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
 
@@ -6247,46 +4417,11 @@ void Output_Data::Output_Preprocessor::n(const State2D& Y, const Grid_Info& grid
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(nbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                i=0;
-                for(size_t ix(0); ix < outNxLocal; ++ix) {
-                    for(size_t iy(0); iy < outNyLocal; ++iy) {
-                        nGlobal(ix,iy) = nbuf[i]; ++i;
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    rankx = rr % PE.MPI_X();
-                    ranky = rr / PE.MPI_X();
-
-                    i=0;
-                    MPI_Recv(nbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t ix(0); ix < outNxLocal; ++ix) {
-                        for(size_t iy(0); iy < outNyLocal; ++iy) {
-                            nGlobal(ix + outNxLocal*rankx, iy + outNyLocal*ranky) = nbuf[i]; 
-                            ++i;
-                        }
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            i=0;
-            for(size_t ix(0); ix < outNxLocal; ++ix) {
-                for(size_t iy(0); iy < outNyLocal; ++iy) {
-                    nGlobal(ix,iy) = nbuf[i];
-                    ++i;
-                }
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
+        axes.push_back(yaxis);
 
-        if (PE.RANK() == 0) expo.Export_h5("n", xaxis, yaxis, nGlobal, tout, time, dt, s);
+        Export_slab("n", axes, nbuf, grid, tout, time, dt, PE, s);
 
     }
 
@@ -6300,19 +4435,14 @@ void Output_Data::Output_Preprocessor::T(const State2D& Y, const Grid_Info& grid
 
 
     size_t Nbc(Input::List().BoundaryCells);
-    MPI_Status status;
     size_t i(0);
     int outNxLocal(grid.axis.Nx(0) - 2*Nbc);
     int outNyLocal(grid.axis.Nx(1) - 2 * Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
-    size_t outNyGlobal(grid.axis.Nxg(1));
-    int rankx,ranky;
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
     int msg_sz(outNxLocal*outNyLocal);
 
-    double tbuf[msg_sz];
-    Array2D<double> tGlobal(outNxGlobal,outNyGlobal);
+    vector<double> tbuf(msg_sz);
 
     double convert_factor = (2.99792458e8)*(2.99792458e8)*(9.1093829e-31)/(1.602176565e-19);
 
@@ -6338,51 +4468,11 @@ void Output_Data::Output_Preprocessor::T(const State2D& Y, const Grid_Info& grid
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(tbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                i=0;
-                for(size_t ix(0); ix < outNxLocal; ++ix) {
-                    for(size_t iy(0); iy < outNyLocal; ++iy) {
-                        tGlobal(ix,iy) = tbuf[i];++i;
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr(1); rr < PE.MPI_Processes(); ++rr){
-                    rankx = rr % PE.MPI_X();
-                    ranky = rr / PE.MPI_X();
-
-                    MPI_Recv(tbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                    i=0;
-                    for(size_t ix(0); ix < outNxLocal; ++ix) {
-                        for(size_t iy(0); iy < outNyLocal; ++iy) {
-                            tGlobal(ix + outNxLocal*rankx, iy + outNyLocal*ranky) = tbuf[i]; 
-                            ++i;
-                        }
-                    }
-                }
-            }
-        }
-        // Fill data for Nodes = 0
-        else 
-        {
-            i=0;
-            for(size_t ix(0); ix < outNxLocal; ++ix) {
-                for(size_t iy(0); iy < outNyLocal; ++iy) {
-                    tGlobal(ix,iy) = tbuf[i]; 
-                    // std::cout << "T2[" << ix << "," << iy << "] = " << tbuf[i] << "\n";
-                    ++i;
-                    
-                }
-            }
-            // exit(1);
-        }
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
+        axes.push_back(yaxis);
 
-        if (PE.RANK() == 0) expo.Export_h5("T", xaxis, yaxis, tGlobal, tout, time, dt, s);
+        Export_slab("T", axes, tbuf, grid, tout, time, dt, PE, s);
 
     }
 
@@ -6397,19 +4487,14 @@ void Output_Data::Output_Preprocessor::Jx(const State2D& Y, const Grid_Info& gri
 
 
     size_t Nbc(Input::List().BoundaryCells);
-    MPI_Status status;
     size_t i(0);
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
     size_t outNyLocal(grid.axis.Nx(1) - 2 * Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
-    size_t outNyGlobal(grid.axis.Nxg(1));
-    int rankx,ranky;
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
     int msg_sz(outNxLocal*outNyLocal);
 
-    double buf[msg_sz];
-    Array2D<double> global(outNxGlobal,outNyGlobal); //, yglob_axis.dim());
+    vector<double> buf(msg_sz);
 
     for(int s(0); s < Y.Species(); ++s) 
     {
@@ -6424,50 +4509,11 @@ void Output_Data::Output_Preprocessor::Jx(const State2D& Y, const Grid_Info& gri
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                i=0;
-                for(size_t ix(0); ix < outNxLocal; ++ix) {
-                    for(size_t iy(0); iy < outNyLocal; ++iy) {
-                        global(ix,iy) = buf[i];
-                        ++i;
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr(1); rr < PE.MPI_Processes(); ++rr){
-                    rankx = rr % PE.MPI_X();
-                    ranky = rr / PE.MPI_X();
-
-                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                    i=0;
-                    for(size_t ix(0); ix < outNxLocal; ++ix) {
-                        for(size_t iy(0); iy < outNyLocal; ++iy) {
-                            global(ix + outNxLocal*rankx, iy + outNyLocal*ranky) = buf[i]; 
-                            ++i;
-                        }
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else 
-        {
-            i=0;
-            for(size_t ix(0); ix < outNxLocal; ++ix) 
-            {
-                for(size_t iy(0); iy < outNyLocal; ++iy) 
-                {
-                    global(ix,iy) = buf[i]; ++i;
-                }
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
+        axes.push_back(yaxis);
 
-        if (PE.RANK() == 0) expo.Export_h5("Jx", xaxis, yaxis, global, tout, time, dt, s);
+        Export_slab("Jx", axes, buf, grid, tout, time, dt, PE, s);
 
     }
 
@@ -6482,19 +4528,14 @@ void Output_Data::Output_Preprocessor::Jy(const State2D& Y, const Grid_Info& gri
 
 
     size_t Nbc(Input::List().BoundaryCells);
-    MPI_Status status;
     size_t i(0);
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
     size_t outNyLocal(grid.axis.Nx(1) - 2 * Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
-    size_t outNyGlobal(grid.axis.Nxg(1));
-    int rankx,ranky;
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
     int msg_sz(outNxLocal*outNyLocal);
 
-    double buf[msg_sz];
-    Array2D<double> global(outNxGlobal,outNyGlobal);
+    vector<double> buf(msg_sz);
 
     for(int s(0); s < Y.Species(); ++s) {
 
@@ -6509,45 +4550,11 @@ void Output_Data::Output_Preprocessor::Jy(const State2D& Y, const Grid_Info& gri
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                i=0;
-                for(size_t ix(0); ix < outNxLocal; ++ix) {
-                    for(size_t iy(0); iy < outNyLocal; ++iy) {
-                        global(ix,iy) = buf[i];++i;
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr(1); rr < PE.MPI_Processes(); ++rr){
-                    rankx = rr % PE.MPI_X();
-                    ranky = rr / PE.MPI_X();
-
-                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                    i=0;
-                    for(size_t ix(0); ix < outNxLocal; ++ix) {
-                        for(size_t iy(0); iy < outNyLocal; ++iy) {
-                            global(ix + outNxLocal*rankx, iy + outNyLocal*ranky) = buf[i]; ++i;
-                        }
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            i=0;
-            for(size_t ix(0); ix < outNxLocal; ++ix) {
-                for(size_t iy(0); iy < outNyLocal; ++iy) {
-                    global(ix,iy) = buf[i]; ++i;
-                }
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
+        axes.push_back(yaxis);
 
-        if (PE.RANK() == 0) expo.Export_h5("Jy", xaxis, yaxis, global, tout, time, dt, s);
+        Export_slab("Jy", axes, buf, grid, tout, time, dt, PE, s);
 
     }
 
@@ -6561,19 +4568,14 @@ void Output_Data::Output_Preprocessor::Jz(const State2D& Y, const Grid_Info& gri
 
 
     size_t Nbc(Input::List().BoundaryCells);
-    MPI_Status status;
     size_t i(0);
     size_t outNxLocal(grid.axis.Nx(0) - 2 * Nbc);
     size_t outNyLocal(grid.axis.Nx(1) - 2 * Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
-    size_t outNyGlobal(grid.axis.Nxg(1));
-    int rankx,ranky;
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
     int msg_sz(outNxLocal * outNyLocal);
 
-    double buf[msg_sz];
-    Array2D<double> global(outNxGlobal, outNyGlobal);
+    vector<double> buf(msg_sz);
 
     for (int s(0); s < Y.Species(); ++s) {
 
@@ -6586,47 +4588,11 @@ void Output_Data::Output_Preprocessor::Jz(const State2D& Y, const Grid_Info& gri
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK() != 0) {
-                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            } else {
-                // Fill data for rank = 0
-                i = 0;
-                for (size_t ix(0); ix < outNxLocal; ++ix) {
-                    for (size_t iy(0); iy < outNyLocal; ++iy) {
-                        global(ix, iy) = buf[i];
-                        ++i;
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr(1); rr < PE.MPI_Processes(); ++rr) {
-                    rankx = rr % PE.MPI_X();
-                    ranky = rr / PE.MPI_X();
-
-                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                    i = 0;
-                    for (size_t ix(0); ix < outNxLocal; ++ix) {
-                        for (size_t iy(0); iy < outNyLocal; ++iy) {
-                            global(ix + outNxLocal * rankx, iy + outNyLocal * ranky) = buf[i];
-                            ++i;
-                        }
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            i = 0;
-            for (size_t ix(0); ix < outNxLocal; ++ix) {
-                for (size_t iy(0); iy < outNyLocal; ++iy) {
-                    global(ix, iy) = buf[i];
-                    ++i;
-                }
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
+        axes.push_back(yaxis);
 
-        if (PE.RANK() == 0) expo.Export_h5("Jz", xaxis, yaxis, global, tout, time, dt, s);
+        Export_slab("Jz", axes, buf, grid, tout, time, dt, PE, s);
 
     }
 
@@ -6637,19 +4603,14 @@ void Output_Data::Output_Preprocessor::Jz(const State2D& Y, const Grid_Info& gri
 void Output_Data::Output_Preprocessor::Qx(const State2D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
                                              const Parallel_Environment_2D& PE) {
     size_t Nbc(Input::List().BoundaryCells);
-    MPI_Status status;
     size_t i(0);
     size_t outNxLocal(grid.axis.Nx(0) - 2 * Nbc);
     size_t outNyLocal(grid.axis.Nx(1) - 2 * Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
-    size_t outNyGlobal(grid.axis.Nxg(1));
-    int rankx,ranky;
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
     int msg_sz(outNxLocal * outNyLocal);
 
-    double buf[msg_sz];
-    Array2D<double> global(outNxGlobal, outNyGlobal);
+    vector<double> buf(msg_sz);
 
     for (int s(0); s < Y.Species(); ++s) {
 
@@ -6662,47 +4623,11 @@ void Output_Data::Output_Preprocessor::Qx(const State2D& Y, const Grid_Info& gri
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK() != 0) {
-                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            } else {
-                // Fill data for rank = 0
-                i = 0;
-                for (size_t ix(0); ix < outNxLocal; ++ix) {
-                    for (size_t iy(0); iy < outNyLocal; ++iy) {
-                        global(ix, iy) = buf[i];
-                        ++i;
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr(1); rr < PE.MPI_Processes(); ++rr) {
-                    rankx = rr % PE.MPI_X();
-                    ranky = rr / PE.MPI_X();
-
-                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                    i = 0;
-                    for (size_t ix(0); ix < outNxLocal; ++ix) {
-                        for (size_t iy(0); iy < outNyLocal; ++iy) {
-                            global(ix + outNxLocal * rankx, iy + outNyLocal * ranky) = buf[i];
-                            ++i;
-                        }
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            i = 0;
-            for (size_t ix(0); ix < outNxLocal; ++ix) {
-                for (size_t iy(0); iy < outNyLocal; ++iy) {
-                    global(ix, iy) = buf[i];
-                    ++i;
-                }
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
+        axes.push_back(yaxis);
 
-        if (PE.RANK() == 0) expo.Export_h5("Qx", xaxis, yaxis, global, tout, time, dt, s);
+        Export_slab("Qx", axes, buf, grid, tout, time, dt, PE, s);
 
     }
 
@@ -6713,19 +4638,14 @@ void Output_Data::Output_Preprocessor::Qx(const State2D& Y, const Grid_Info& gri
 void Output_Data::Output_Preprocessor::Qy(const State2D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
                                              const Parallel_Environment_2D& PE) {
     size_t Nbc(Input::List().BoundaryCells);
-    MPI_Status status;
     size_t i(0);
     size_t outNxLocal(grid.axis.Nx(0) - 2 * Nbc);
     size_t outNyLocal(grid.axis.Nx(1) - 2 * Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
-    size_t outNyGlobal(grid.axis.Nxg(1));
-    int rankx,ranky;
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
     int msg_sz(outNxLocal * outNyLocal);
 
-    double buf[msg_sz];
-    Array2D<double> global(outNxGlobal, outNyGlobal);
+    vector<double> buf(msg_sz);
 
     for (int s(0); s < Y.Species(); ++s) {
 
@@ -6738,47 +4658,11 @@ void Output_Data::Output_Preprocessor::Qy(const State2D& Y, const Grid_Info& gri
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK() != 0) {
-                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            } else {
-                // Fill data for rank = 0
-                i = 0;
-                for (size_t ix(0); ix < outNxLocal; ++ix) {
-                    for (size_t iy(0); iy < outNyLocal; ++iy) {
-                        global(ix, iy) = buf[i];
-                        ++i;
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr(1); rr < PE.MPI_Processes(); ++rr) {
-                    rankx = rr % PE.MPI_X();
-                    ranky = rr / PE.MPI_X();
-
-                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                    i = 0;
-                    for (size_t ix(0); ix < outNxLocal; ++ix) {
-                        for (size_t iy(0); iy < outNyLocal; ++iy) {
-                            global(ix + outNxLocal * rankx, iy + outNyLocal * ranky) = buf[i];
-                            ++i;
-                        }
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            i = 0;
-            for (size_t ix(0); ix < outNxLocal; ++ix) {
-                for (size_t iy(0); iy < outNyLocal; ++iy) {
-                    global(ix, iy) = buf[i];
-                    ++i;
-                }
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
+        axes.push_back(yaxis);
 
-        if (PE.RANK() == 0) expo.Export_h5("Qy", xaxis, yaxis, global, tout, time, dt, s);
+        Export_slab("Qy", axes, buf, grid, tout, time, dt, PE, s);
 
     }
 
@@ -6789,19 +4673,14 @@ void Output_Data::Output_Preprocessor::Qy(const State2D& Y, const Grid_Info& gri
 void Output_Data::Output_Preprocessor::Qz(const State2D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
                                              const Parallel_Environment_2D& PE) {
     size_t Nbc(Input::List().BoundaryCells);
-    MPI_Status status;
     size_t i(0);
     size_t outNxLocal(grid.axis.Nx(0) - 2 * Nbc);
     size_t outNyLocal(grid.axis.Nx(1) - 2 * Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
-    size_t outNyGlobal(grid.axis.Nxg(1));
-    int rankx,ranky;
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
     int msg_sz(outNxLocal * outNyLocal);
 
-    double buf[msg_sz];
-    Array2D<double> global(outNxGlobal, outNyGlobal);
+    vector<double> buf(msg_sz);
 
     for (int s(0); s < Y.Species(); ++s) {
 
@@ -6814,47 +4693,11 @@ void Output_Data::Output_Preprocessor::Qz(const State2D& Y, const Grid_Info& gri
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK() != 0) {
-                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            } else {
-                // Fill data for rank = 0
-                i = 0;
-                for (size_t ix(0); ix < outNxLocal; ++ix) {
-                    for (size_t iy(0); iy < outNyLocal; ++iy) {
-                        global(ix, iy) = buf[i];
-                        ++i;
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr(1); rr < PE.MPI_Processes(); ++rr) {
-                    rankx = rr % PE.MPI_X();
-                    ranky = rr / PE.MPI_X();
-
-                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                    i = 0;
-                    for (size_t ix(0); ix < outNxLocal; ++ix) {
-                        for (size_t iy(0); iy < outNyLocal; ++iy) {
-                            global(ix + outNxLocal * rankx, iy + outNyLocal * ranky) = buf[i];
-                            ++i;
-                        }
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            i = 0;
-            for (size_t ix(0); ix < outNxLocal; ++ix) {
-                for (size_t iy(0); iy < outNyLocal; ++iy) {
-                    global(ix, iy) = buf[i];
-                    ++i;
-                }
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
+        axes.push_back(yaxis);
 
-        if (PE.RANK() == 0) expo.Export_h5("Qz", xaxis, yaxis, global, tout, time, dt, s);
+        Export_slab("Qz", axes, buf, grid, tout, time, dt, PE, s);
 
     }
 
@@ -6867,19 +4710,14 @@ void Output_Data::Output_Preprocessor::vNx(const State2D& Y, const Grid_Info& gr
                                               const Parallel_Environment_2D& PE) {
 
     size_t Nbc(Input::List().BoundaryCells);
-    MPI_Status status;
     size_t i(0);
     size_t outNxLocal(grid.axis.Nx(0) - 2 * Nbc);
     size_t outNyLocal(grid.axis.Nx(1) - 2 * Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
-    size_t outNyGlobal(grid.axis.Nxg(1));
-    int rankx,ranky;
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
     int msg_sz(outNxLocal * outNyLocal);
 
-    double buf[msg_sz];
-    Array2D<double> global(outNxGlobal, outNyGlobal); //, yglob_axis.dim());
+    vector<double> buf(msg_sz);
 
     for (int s(0); s < Y.Species(); ++s) {
 
@@ -6893,47 +4731,11 @@ void Output_Data::Output_Preprocessor::vNx(const State2D& Y, const Grid_Info& gr
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK() != 0) {
-                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            } else {
-                // Fill data for rank = 0
-                i = 0;
-                for (size_t ix(0); ix < outNxLocal; ++ix) {
-                    for (size_t iy(0); iy < outNyLocal; ++iy) {
-                        global(ix, iy) = buf[i];
-                        ++i;
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr(1); rr < PE.MPI_Processes(); ++rr) {
-                    rankx = rr % PE.MPI_X();
-                    ranky = rr / PE.MPI_X();
-
-                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                    i = 0;
-                    for (size_t ix(0); ix < outNxLocal; ++ix) {
-                        for (size_t iy(0); iy < outNyLocal; ++iy) {
-                            global(ix + outNxLocal * rankx, iy + outNyLocal * ranky) = buf[i];
-                            ++i;
-                        }
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            i = 0;
-            for (size_t ix(0); ix < outNxLocal; ++ix) {
-                for (size_t iy(0); iy < outNyLocal; ++iy) {
-                    global(ix, iy) = buf[i];
-                    ++i;
-                }
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
+        axes.push_back(yaxis);
 
-        if (PE.RANK() == 0) expo.Export_h5("vNx", xaxis, yaxis, global, tout, time, dt, s);
+        Export_slab("vNx", axes, buf, grid, tout, time, dt, PE, s);
 
     }
 
@@ -6947,19 +4749,14 @@ void Output_Data::Output_Preprocessor::vNy(const State2D& Y, const Grid_Info& gr
                                               const Parallel_Environment_2D& PE) {
 
     size_t Nbc(Input::List().BoundaryCells);
-    MPI_Status status;
     size_t i(0);
     size_t outNxLocal(grid.axis.Nx(0) - 2 * Nbc);
     size_t outNyLocal(grid.axis.Nx(1) - 2 * Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
-    size_t outNyGlobal(grid.axis.Nxg(1));
-    int rankx,ranky;
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
     int msg_sz(outNxLocal * outNyLocal);
 
-    double buf[msg_sz];
-    Array2D<double> global(outNxGlobal, outNyGlobal); //, yglob_axis.dim());
+    vector<double> buf(msg_sz);
 
     for (int s(0); s < Y.Species(); ++s) {
 
@@ -6973,47 +4770,11 @@ void Output_Data::Output_Preprocessor::vNy(const State2D& Y, const Grid_Info& gr
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK() != 0) {
-                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            } else {
-                // Fill data for rank = 0
-                i = 0;
-                for (size_t ix(0); ix < outNxLocal; ++ix) {
-                    for (size_t iy(0); iy < outNyLocal; ++iy) {
-                        global(ix, iy) = buf[i];
-                        ++i;
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr(1); rr < PE.MPI_Processes(); ++rr) {
-                    rankx = rr % PE.MPI_X();
-                    ranky = rr / PE.MPI_X();
-
-                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                    i = 0;
-                    for (size_t ix(0); ix < outNxLocal; ++ix) {
-                        for (size_t iy(0); iy < outNyLocal; ++iy) {
-                            global(ix + outNxLocal * rankx, iy + outNyLocal * ranky) = buf[i];
-                            ++i;
-                        }
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            i = 0;
-            for (size_t ix(0); ix < outNxLocal; ++ix) {
-                for (size_t iy(0); iy < outNyLocal; ++iy) {
-                    global(ix, iy) = buf[i];
-                    ++i;
-                }
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
+        axes.push_back(yaxis);
 
-        if (PE.RANK() == 0) expo.Export_h5("vNy", xaxis, yaxis, global, tout, time, dt, s);
+        Export_slab("vNy", axes, buf, grid, tout, time, dt, PE, s);
 
     }
 
@@ -7027,19 +4788,14 @@ void Output_Data::Output_Preprocessor::vNz(const State2D& Y, const Grid_Info& gr
                                               const Parallel_Environment_2D& PE) {
 
     size_t Nbc(Input::List().BoundaryCells);
-    MPI_Status status;
     size_t i(0);
     size_t outNxLocal(grid.axis.Nx(0) - 2 * Nbc);
     size_t outNyLocal(grid.axis.Nx(1) - 2 * Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
-    size_t outNyGlobal(grid.axis.Nxg(1));
-    int rankx,ranky;
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
     vector<double> yaxis(valtovec(grid.axis.xg(1)));
     int msg_sz(outNxLocal * outNyLocal);
 
-    double buf[msg_sz];
-    Array2D<double> global(outNxGlobal, outNyGlobal); //, yglob_axis.dim());
+    vector<double> buf(msg_sz);
 
     for (int s(0); s < Y.Species(); ++s) {
 
@@ -7055,47 +4811,11 @@ void Output_Data::Output_Preprocessor::vNz(const State2D& Y, const Grid_Info& gr
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK() != 0) {
-                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            } else {
-                // Fill data for rank = 0
-                i = 0;
-                for (size_t ix(0); ix < outNxLocal; ++ix) {
-                    for (size_t iy(0); iy < outNyLocal; ++iy) {
-                        global(ix, iy) = buf[i];
-                        ++i;
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr(1); rr < PE.MPI_Processes(); ++rr) {
-                    rankx = rr % PE.MPI_X();
-                    ranky = rr / PE.MPI_X();
-
-                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                    i = 0;
-                    for (size_t ix(0); ix < outNxLocal; ++ix) {
-                        for (size_t iy(0); iy < outNyLocal; ++iy) {
-                            global(ix + outNxLocal * rankx, iy + outNyLocal * ranky) = buf[i];
-                            ++i;
-                        }
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            i = 0;
-            for (size_t ix(0); ix < outNxLocal; ++ix) {
-                for (size_t iy(0); iy < outNyLocal; ++iy) {
-                    global(ix, iy) = buf[i];
-                    ++i;
-                }
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(xaxis);
+        axes.push_back(yaxis);
 
-        if (PE.RANK() == 0) expo.Export_h5("vNz", xaxis, yaxis, global, tout, time, dt, s);
+        Export_slab("vNz", axes, buf, grid, tout, time, dt, PE, s);
 
     }
 }
@@ -7108,14 +4828,11 @@ void Output_Data::Output_Preprocessor::Ux(const State1D& Y, const Grid_Info& gri
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     //  
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); 
-    double Uxbuf[msg_sz];
-    vector<double> UxGlobal(outNxGlobal);
+    vector<double> Uxbuf(msg_sz);
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     for(size_t i(0); i < msg_sz; ++i) 
@@ -7123,32 +4840,10 @@ void Output_Data::Output_Preprocessor::Ux(const State1D& Y, const Grid_Info& gri
         Uxbuf[i] = static_cast<double>(Y.HYDRO().vx(i+Nbc));
     }
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(Uxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            for(size_t i(0); i < outNxLocal; i++) {
-                UxGlobal[i] = Uxbuf[i];
-            }
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                MPI_Recv(Uxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                for(size_t i(0); i < outNxLocal; i++) {
-                    UxGlobal[i + outNxLocal*rr] = Uxbuf[i];
-                }
-            }
-        }
-    }
-    // Fill data for Nodes = 0
-    else {
-        for(size_t i(0); i < outNxGlobal; i++) {
-            UxGlobal[i] = Uxbuf[i];
-        }
-    }
+    vector< vector<double> > axes;
+    axes.push_back(xaxis);
 
-    if (PE.RANK() == 0) expo.Export_h5("Ux", xaxis, UxGlobal, tout, time, dt, 0);
+    Export_slab("Ux", axes, Uxbuf, grid, tout, time, dt, PE, 0);
 
 }
 //--------------------------------------------------------------
@@ -7158,46 +4853,21 @@ void Output_Data::Output_Preprocessor::Uy(const State1D& Y, const Grid_Info& gri
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     //  
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); 
-    double Uxbuf[msg_sz];
-    vector<double> UxGlobal(outNxGlobal); 
+    vector<double> Uxbuf(msg_sz);
     vector<double> xaxis(valtovec(grid.axis.xg(0)));  
 
     for(size_t i(0); i < msg_sz; ++i) {
         Uxbuf[i] = static_cast<double>(Y.HYDRO().vy(i+Nbc));
     }
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(Uxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            for(size_t i(0); i < outNxLocal; i++) {
-                UxGlobal[i] = Uxbuf[i];
-            }
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                MPI_Recv(Uxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                for(size_t i(0); i < outNxLocal; i++) {
-                    UxGlobal[i + outNxLocal*rr] = Uxbuf[i];
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        for(size_t i(0); i < outNxGlobal; i++) {
-            UxGlobal[i] = Uxbuf[i];
-        }
-    }
+    vector< vector<double> > axes;
+    axes.push_back(xaxis);
 
-    if (PE.RANK() == 0) expo.Export_h5("Uy", xaxis, UxGlobal, tout, time, dt, 0);
+    Export_slab("Uy", axes, Uxbuf, grid, tout, time, dt, PE, 0);
 
 }
 //--------------------------------------------------------------
@@ -7207,47 +4877,22 @@ void Output_Data::Output_Preprocessor::Uz(const State1D& Y, const Grid_Info& gri
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     //  
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
-    double Uxbuf[msg_sz];
-    vector<double> UxGlobal(outNxGlobal);
+    vector<double> Uxbuf(msg_sz);
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
-
-    for(size_t i(0); i < msg_sz; ++i) {
-        Uxbuf[i] = static_cast<double>(Y.HYDRO().vz(i+Nbc));
-    }
-
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(Uxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            for(size_t i(0); i < outNxLocal; i++) {
-                UxGlobal[i] = Uxbuf[i];
-            }
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                MPI_Recv(Uxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                for(size_t i(0); i < outNxLocal; i++) {
-                    UxGlobal[i + outNxLocal*rr] = Uxbuf[i];
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        for(size_t i(0); i < outNxGlobal; i++) {
-            UxGlobal[i] = Uxbuf[i];
-        }
+
+    for(size_t i(0); i < msg_sz; ++i) {
+        Uxbuf[i] = static_cast<double>(Y.HYDRO().vz(i+Nbc));
     }
 
-    if (PE.RANK() == 0) expo.Export_h5("Uz", xaxis, UxGlobal, tout, time, dt, 0);
+    vector< vector<double> > axes;
+    axes.push_back(xaxis);
+
+    Export_slab("Uz", axes, Uxbuf, grid, tout, time, dt, PE, 0);
 
 }
 //--------------------------------------------------------------
@@ -7257,14 +4902,11 @@ void Output_Data::Output_Preprocessor::Z(const State1D& Y, const Grid_Info& grid
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
-    double Uxbuf[msg_sz];
-    vector<double> UxGlobal(outNxGlobal);
+    vector<double> Uxbuf(msg_sz);
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
 
@@ -7272,32 +4914,10 @@ void Output_Data::Output_Preprocessor::Z(const State1D& Y, const Grid_Info& grid
         Uxbuf[i] = static_cast<double>(Y.HYDRO().Z(i+Nbc));
     }
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(Uxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            for(size_t i(0); i < outNxLocal; i++) {
-                UxGlobal[i] = Uxbuf[i];
-            }
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                MPI_Recv(Uxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                for(size_t i(0); i < outNxLocal; i++) {
-                    UxGlobal[i + outNxLocal*rr] = Uxbuf[i];
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        for(size_t i(0); i < outNxGlobal; i++) {
-            UxGlobal[i] = Uxbuf[i];
-        }
-    }
+    vector< vector<double> > axes;
+    axes.push_back(xaxis);
 
-    if (PE.RANK() == 0) expo.Export_h5("Z", xaxis, UxGlobal, tout, time, dt, 0);
+    Export_slab("Z", axes, Uxbuf, grid, tout, time, dt, PE, 0);
 
 }
 //--------------------------------------------------------------
@@ -7310,47 +4930,21 @@ void Output_Data::Output_Preprocessor::ni(const State1D& Y, const Grid_Info& gri
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     //  
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
-    double nibuf[msg_sz];
-    vector<double> niGlobal(outNxGlobal);
+    vector<double> nibuf(msg_sz);
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     for(size_t i(0); i < msg_sz; ++i) {
         nibuf[i] = static_cast<double>(Y.HYDRO().density(i+Nbc));
     }
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(nibuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            for(size_t i(0); i < outNxLocal; i++) {
-                niGlobal[i] = nibuf[i];
-            }
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                MPI_Recv(nibuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                for(size_t i(0); i < outNxLocal; i++) {
-                    niGlobal[i + outNxLocal*rr] = nibuf[i];
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        for(size_t i(0); i < outNxGlobal; i++) {
-            niGlobal[i] = nibuf[i];
+    vector< vector<double> > axes;
+    axes.push_back(xaxis);
 
-        }
-    }
-
-    if (PE.RANK() == 0) expo.Export_h5("ni",  xaxis, niGlobal, tout, time, dt, 0);
+    Export_slab("ni", axes, nibuf, grid, tout, time, dt, PE, 0);
 
 }
 //--------------------------------------------------------------
@@ -7363,46 +4957,21 @@ void Output_Data::Output_Preprocessor::Ti(const State1D& Y, const Grid_Info& gri
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     //  
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
-    double Thydrobuf[msg_sz];
-    vector<double> ThydroGlobal(outNxGlobal);
+    vector<double> Thydrobuf(msg_sz);
     vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     for(size_t i(0); i < msg_sz; ++i) {
         Thydrobuf[i] = static_cast<double>(511000.0/3.0*Y.HYDRO().temperature(i+Nbc));
     }
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(Thydrobuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            for(size_t i(0); i < outNxLocal; i++) {
-                ThydroGlobal[i] = Thydrobuf[i];
-            }
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                MPI_Recv(Thydrobuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                for(size_t i(0); i < outNxLocal; i++) {
-                    ThydroGlobal[i + outNxLocal*rr] = Thydrobuf[i];
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        for(size_t i(0); i < outNxGlobal; i++) {
-            ThydroGlobal[i] = Thydrobuf[i];
-        }
-    }
+    vector< vector<double> > axes;
+    axes.push_back(xaxis);
 
-    if (PE.RANK() == 0) expo.Export_h5("Ti", xaxis, ThydroGlobal, tout, time, dt, 0);
+    Export_slab("Ti", axes, Thydrobuf, grid, tout, time, dt, PE, 0);
 
 }
 //--------------------------------------------------------------
@@ -7417,268 +4986,485 @@ void Export_Files::Xport:: Export_h5(const std::string tag,
 //  Export data to H5 file
 //--------------------------------------------------------------
 
-    string      filename(Hdr[tag].Directory());
+    vector< vector<double> > axes(1, axis1);
+    vector<double> flat(data);
 
-    //  Check Header file correctness
-    // if (Hdr[tag].dim() != 1) {
-    //     cout << "ERROR "<< tag <<" : "  << Hdr[tag].dim() << " dimensions != 1D structure\n";
-    //     exit(1);
-    // }
+    Stage_h5(tag, axes, flat, vector<size_t>(1, flat.size()), step, time, dt, spec);
 
-    //  Open File
-    filename.append(tag).append(oH5Fextension(step,spec));
-    // we create a new hdf5 file
-    HighFive::File file(filename, HighFive::File::ReadWrite | HighFive::File::Create | HighFive::File::Truncate);
+}
+//--------------------------------------------------------------
+// --------------------------------------------------------------
+void Export_Files::Xport:: Export_h5(const std::string tag,
+ std::vector<double> &axis1, std::vector<double> &axis2, Array2D<double> &dataA,
+ const size_t  step, const double  time, const double  dt,
+ const int spec){
+//--------------------------------------------------------------
+//  Export data to H5 file
+//--------------------------------------------------------------
 
-    // lets create a dataset of native double with the size of the vector
-    // 'data'
-    HighFive::DataSet dataset =
-        file.createDataSet<double>(tag, HighFive::DataSpace::From(data));
+    vector< vector<double> > axes;
+    axes.push_back(axis1); axes.push_back(axis2);
+
+    vector<size_t> dims(2);
+    dims[0] = dataA.dim1();
+    dims[1] = dataA.dim2();
 
-    // lets write our vector of double to the HDF5 dataset
-    dataset.write(data);
+    vector<double> flat(dataA.dim());
+    for (size_t i(0); i < dataA.dim1(); ++i)
+        for (size_t j(0); j < dataA.dim2(); ++j)
+            flat[i*dataA.dim2() + j] = dataA(i,j);
 
-    add_attributes(dataset,tag,time,dt);
+    Stage_h5(tag, axes, flat, dims, step, time, dt, spec);
 
-    HighFive::Group Axes = file.createGroup("Axes");
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+void Export_Files::Xport:: Export_h5(const std::string tag,
+ std::vector<double> &axis1, std::vector<double> &axis2, std::vector<double> &axis3,
+ Array3D<double> &dataA,
+ const size_t  step, const double  time, const double  dt,
+ const int spec){
+//--------------------------------------------------------------
+//  Export data to H5 file
+//--------------------------------------------------------------
+
+    vector< vector<double> > axes;
+    axes.push_back(axis1); axes.push_back(axis2); axes.push_back(axis3);
+
+    vector<size_t> dims(3);
+    dims[0] = dataA.dim1();
+    dims[1] = dataA.dim2();
+    dims[2] = dataA.dim3();
 
-    HighFive::DataSet dataset_axis1 =
-        Axes.createDataSet<double>("Axis1", HighFive::DataSpace::From(axis1));
+    vector<double> flat(dataA.dim());
+    for (size_t i(0); i < dataA.dim1(); ++i)
+        for (size_t j(0); j < dataA.dim2(); ++j)
+            for (size_t k(0); k < dataA.dim3(); ++k)
+                flat[(i*dataA.dim2() + j)*dataA.dim3() + k] = dataA(i,j,k);
 
-    // lets write our vector of double to the HDF5 dataset
-    dataset_axis1.write(axis1);
+    Stage_h5(tag, axes, flat, dims, step, time, dt, spec);
 
 }
 //--------------------------------------------------------------
-// --------------------------------------------------------------
 void Export_Files::Xport:: Export_h5(const std::string tag,
- std::vector<double> &axis1, std::vector<double> &axis2, Array2D<double> &dataA,
+ std::vector<double> &axis1, std::vector<double> &axis2, std::vector<double> &axis3, std::vector<double> &axis4,
+ Array4D<double> &dataA,
  const size_t  step, const double  time, const double  dt,
  const int spec){
 //--------------------------------------------------------------
 //  Export data to H5 file
 //--------------------------------------------------------------
 
-    string      filename(Hdr[tag].Directory());
+    vector< vector<double> > axes;
+    axes.push_back(axis1); axes.push_back(axis2); axes.push_back(axis3); axes.push_back(axis4);
 
-    //  Check Header file correctness
-    // if (Hdr[tag].dim() != 2) {
-    //     cout << "ERROR "<< tag <<" : "  << Hdr[tag].dim() << " dimensions != 2D structure\n";
-    //     exit(1);
-    // }
+    vector<size_t> dims(4);
+    dims[0] = dataA.dim1();
+    dims[1] = dataA.dim2();
+    dims[2] = dataA.dim3();
+    dims[3] = dataA.dim4();
+
+    vector<double> flat(dataA.dim());
+    for (size_t i(0); i < dataA.dim1(); ++i)
+        for (size_t j(0); j < dataA.dim2(); ++j)
+            for (size_t k(0); k < dataA.dim3(); ++k)
+                for (size_t l(0); l < dataA.dim4(); ++l)
+                    flat[((i*dataA.dim2() + j)*dataA.dim3() + k)*dataA.dim4() + l] = dataA(i,j,k,l);
+
+    Stage_h5(tag, axes, flat, dims, step, time, dt, spec);
+
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+void Export_Files::Xport:: Export_h5(const std::string tag,
+ vector< vector<double> > &axes,
+ const double* local, const vector<size_t>& offset, const vector<size_t>& count,
+ const size_t  step, const double  time, const double  dt,
+ MPI_Comm comm, const int spec){
+//--------------------------------------------------------------
+//  Export the slabs of all the nodes to one H5 file
+//--------------------------------------------------------------
+
+    size_t dim(axes.size());
+    std::vector<size_t> dims(dim);
+    for (size_t d(0); d < dim; ++d) dims[d] = axes[d].size();
 
-    //  Open File
+#ifdef H5_HAVE_PARALLEL
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+
+    string      filename(Hdr[tag].Directory());
     filename.append(tag).append(oH5Fextension(step,spec));
-    // we create a new hdf5 file
-    HighFive::File file(filename, HighFive::File::ReadWrite | HighFive::File::Create | HighFive::File::Truncate);
 
-    // lets create a dataset of native double with the size of the Array2D
-    // 'data'
-    vector<double> dummyvec(dataA.dim2());
-    vector<vector<double> > data;
+//  All the nodes open the file with the MPI-IO driver and write 
+//  their hyperslab of the dataset in one collective transfer
+    if (stepfile != NULL) {
+//      The dataset creation is collective, so the chunks have to be 
+//      the same everywhere: they are cut from the smallest slab
+        vector<size_t> slab(count);
+        MPI_Allreduce(MPI_IN_PLACE, &slab[0], int(dim), MPI_UNSIGNED_LONG, MPI_MIN, comm);
 
+        HighFive::Group group(stepfile->createGroup(Groupname(tag,spec)));
+        Write_slab(group.getId(), tag, axes, local, offset, count, Chunk(slab), true, rank);
+        return;
+    }
 
-    // exit(1);
-    
-    for (size_t i(0); i < dataA.dim1(); ++i)
-    {
-        for (size_t j(0); j < dataA.dim2(); ++j)
-        {
-            // std::cout << "(i,j) = " << i << "," << j << "\n";
-            dummyvec[j] = dataA(i,j);
+    HighFive::File file(filename, HighFive::File::ReadWrite | HighFive::File::Create | HighFive::File::Truncate,
+                        HighFive::MPIOFileDriver(comm, MPI_INFO_NULL));
+
+    Write_slab(file.getId(), tag, axes, local, offset, count, vector<size_t>(), true, rank);
+
+    HighFive::DataSet dataset(file.getDataSet(tag));
+    add_attributes(dataset,time,dt);
+
+#else
+//  Serial HDF5: gather the slabs on node 0 and write from there
+    vector<double> global;
+    if (Gather(tag, spec, local, offset, count, dims, comm, global))
+        Stage_h5(tag, axes, global, count, step, time, dt, spec);
+#endif
+
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+//  Gatherv of the slabs to node 0, which places them in the global
+//  array one contiguous row of the last dimension at a time
+//--------------------------------------------------------------
+bool Export_Files::Xport::Gather(const std::string tag, const int spec, const double* local, 
+ const vector<size_t>& offset, const vector<size_t>& count, const vector<size_t>& dims,
+ MPI_Comm comm, vector<double>& global){
+
+    int rank, nodes;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &nodes);
+
+    size_t dim(dims.size());
+    int local_sz(1);
+    for (size_t d(0); d < dim; ++d) local_sz *= count[d];
+
+//  The decomposition is fixed for the life of the output, the layout is exchanged once per diagnostic
+    map< string, Slab_Layout >::iterator it(layouts.find(Groupname(tag,spec)));
+    if (it == layouts.end()) {
+        Slab_Layout layout;
+        vector<unsigned long> slab(2*dim);
+        for (size_t d(0); d < dim; ++d) {
+            slab[d]     = offset[d];
+            slab[d+dim] = count[d];
+        }
+        if (rank == 0) {
+            layout.slabs.resize(2*dim*nodes);
+            layout.sizes.resize(nodes);
+            layout.displs.resize(nodes);
         }
 
-        data.push_back(dummyvec);
-    }
+        MPI_Gather(&slab[0], 2*dim, MPI_UNSIGNED_LONG, (rank == 0 ? &layout.slabs[0] : NULL), 2*dim, MPI_UNSIGNED_LONG, 0, comm);
+        MPI_Gather(&local_sz, 1, MPI_INT, (rank == 0 ? &layout.sizes[0] : NULL), 1, MPI_INT, 0, comm);
 
-    
+        if (rank == 0) {
+            layout.displs[0] = 0;
+            for (int rr(1); rr < nodes; ++rr) layout.displs[rr] = layout.displs[rr-1] + layout.sizes[rr-1];
+        }
+        it = layouts.insert(std::make_pair(Groupname(tag,spec), layout)).first;
+    }
+    Slab_Layout& layout(it->second);
 
-    std::vector<size_t> dims(2);
-    dims[0] = dataA.dim1();
-    dims[1] = dataA.dim2();
-    
-    
-    HighFive::DataSet dataset =
-        file.createDataSet<double>(tag, HighFive::DataSpace(dims));
+    vector<double> gathered;
+    if (rank == 0) gathered.resize(layout.displs[nodes-1] + layout.sizes[nodes-1]);
 
-    // lets write our vector of double to the HDF5 dataset
-    dataset.write(data);
+    MPI_Gatherv(const_cast<double*>(local), local_sz, MPI_DOUBLE, 
+                (rank == 0 ? &gathered[0] : NULL), (rank == 0 ? &layout.sizes[0] : NULL), 
+                (rank == 0 ? &layout.displs[0] : NULL), MPI_DOUBLE, 0, comm);
 
-    add_attributes(dataset,tag,time,dt);
+    if (rank != 0) return false;
 
-    HighFive::Group Axes = file.createGroup("Axes");
+    size_t global_sz(1);
+    for (size_t d(0); d < dim; ++d) global_sz *= dims[d];
+    global.resize(global_sz);
 
-    HighFive::DataSet dataset_axis1 =
-        Axes.createDataSet<double>("Axis1", HighFive::DataSpace::From(axis1));
-    dataset_axis1.write(axis1);
+    for (int rr(0); rr < nodes; ++rr) {
+        unsigned long* off(&layout.slabs[2*dim*rr]);
+        unsigned long* cnt(off+dim);
+        size_t row(cnt[dim-1]), rows(layout.sizes[rr]/row);
 
-    HighFive::DataSet dataset_axis2 =
-    Axes.createDataSet<double>("Axis2", HighFive::DataSpace::From(axis2));
-    dataset_axis2.write(axis2);
+        for (size_t r(0); r < rows; ++r) {
+            size_t index(0), rem(r), stride(1);
+            for (int d(dim-2); d > -1; --d) {
+                stride *= dims[d+1];
+                index  += (off[d] + rem % cnt[d]) * stride;
+                rem    /= cnt[d];
+            }
+            index += off[dim-1];
+            std::copy(&gathered[layout.displs[rr]+r*row], &gathered[layout.displs[rr]+r*row] + row, &global[index]);
+        }
+    }
 
+    return true;
 }
 //--------------------------------------------------------------
 //--------------------------------------------------------------
-void Export_Files::Xport:: Export_h5(const std::string tag,
- std::vector<double> &axis1, std::vector<double> &axis2, std::vector<double> &axis3,
- Array3D<double> &dataA,
- const size_t  step, const double  time, const double  dt,
- const int spec){
-//--------------------------------------------------------------
-//  Export data to H5 file
+//  Move the data to a staging buffer and write it, right away or 
+//  on the I/O thread. The data is left empty
 //--------------------------------------------------------------
+void Export_Files::Xport::Stage_h5(const std::string tag, const vector< vector<double> > &axes,
+ vector<double> &data, const vector<size_t>& slab,
+ const size_t  step, const double  time, const double  dt, const int spec){
 
     string      filename(Hdr[tag].Directory());
+    filename.append(tag).append(oH5Fextension(step,spec));
 
-    //  Check Header file correctness
-    // if (Hdr[tag].dim() != 3) {
-    //     cout << "ERROR "<< tag <<" : "  << Hdr[tag].dim() << " dimensions != 3D structure\n";
-    //     exit(1);
-    // }
+    std::shared_ptr< vector<double> > staged(new vector<double>);
+    staged->swap(data);
 
-    //  Open File
-    filename.append(tag).append(oH5Fextension(step,spec));
-    // we create a new hdf5 file
-    HighFive::File file(filename, HighFive::File::ReadWrite | HighFive::File::Create | HighFive::File::Truncate);
+    Submit([=]() { Write_h5(filename, tag, axes, *staged, slab, time, dt, spec); });
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+//  Write a whole dataset from this node, to its group of the
+//  single output file or to a file of its own. slab is the 
+//  chunk before the halving in Chunk
+//--------------------------------------------------------------
+void Export_Files::Xport::Write_h5(const std::string filename, const std::string tag,
+ const vector< vector<double> > &axes, const vector<double> &data, const vector<size_t>& slab,
+ const double  time, const double  dt, const int spec){
 
-    // lets create a dataset of native double with the size of the vector
-    // 'data'
-    
-    vector<double> dummyvec(dataA.dim3());
-    vector<vector<double> > dummyvec2(dataA.dim2());
-    vector<vector<vector<double> > > data;
+    size_t dim(axes.size());
+    vector<size_t> dims(dim);
+    for (size_t d(0); d < dim; ++d) dims[d] = axes[d].size();
 
-    for (size_t i(0); i < dataA.dim1(); ++i)
-    {
-        for (size_t j(0); j < dataA.dim2(); ++j)
-        {
-            for (size_t k(0); k < dataA.dim3(); ++k)
-            {
-                dummyvec[k] = dataA(i,j,k);
-            }
-            dummyvec2[j] = dummyvec;
-        }
-        data.push_back(dummyvec2);
+    if ((stepfile != NULL) && !stepfile_mpio) {
+        vector<size_t> origin(dim, 0);
+        HighFive::Group group(stepfile->createGroup(Groupname(tag,spec)));
+        Write_slab(group.getId(), tag, axes, &data[0], origin, dims, Chunk(slab), false, 0);
+        return;
     }
 
-    std::vector<size_t> dims(3);
-    dims[0] = dataA.dim1();
-    dims[1] = dataA.dim2();
-    dims[2] = dataA.dim3();
-    
+    HighFive::File file(filename, HighFive::File::ReadWrite | HighFive::File::Create | HighFive::File::Truncate);
+
     HighFive::DataSet dataset =
         file.createDataSet<double>(tag, HighFive::DataSpace(dims));
+    if (H5Dwrite(dataset.getId(), H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, &data[0]) < 0) {
+        std::cout << "Error writing " << filename << std::endl;
+        exit(1);
+    }
 
-    // lets write our vector of double to the HDF5 dataset
-    dataset.write(data);
-
-    /// Attributes
-    /// Only a few defined for now
-    /// dt, time
-    add_attributes(dataset,tag,time,dt);
+    add_attributes(dataset,time,dt);
 
     HighFive::Group Axes = file.createGroup("Axes");
 
-    HighFive::DataSet dataset_axis1 =
-        Axes.createDataSet<double>("Axis1", HighFive::DataSpace::From(axis1));
-    dataset_axis1.write(axis1);
+    for (size_t d(0); d < dim; ++d) {
+        HighFive::DataSet dataset_axis =
+            Axes.createDataSet<double>("Axis"+stringify(d+1), HighFive::DataSpace::From(axes[d]));
+        dataset_axis.write(axes[d]);
+    }
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+//  Write the slab of this node to the dataset "tag" of loc and the
+//  axes to loc/Axes. The dataset is contiguous if chunk is empty,
+//  otherwise it is chunked and filtered as requested in the deck. 
+//  With mpio the nodes write collectively and node 0 writes the axes
+//--------------------------------------------------------------
+void Export_Files::Xport::Write_slab(hid_t loc, const std::string tag, const vector< vector<double> > &axes,
+ const double* local, const vector<size_t>& offset, const vector<size_t>& count,
+ const vector<size_t>& chunk, const bool mpio, const int rank){
+
+    size_t dim(axes.size());
+    vector<hsize_t> h_dims(dim), h_offset(offset.begin(), offset.end()), h_count(count.begin(), count.end());
+    for (size_t d(0); d < dim; ++d) h_dims[d] = axes[d].size();
 
-    HighFive::DataSet dataset_axis2 =
-        Axes.createDataSet<double>("Axis2", HighFive::DataSpace::From(axis2));
-    dataset_axis2.write(axis2);
+    hid_t xfer(H5Pcreate(H5P_DATASET_XFER));
+#ifdef H5_HAVE_PARALLEL
+    if (mpio) H5Pset_dxpl_mpio(xfer, H5FD_MPIO_COLLECTIVE);
+#else
+    (void) mpio;
+#endif
 
-    HighFive::DataSet dataset_axis3 =
-        Axes.createDataSet<double>("Axis3", HighFive::DataSpace::From(axis3));
-    dataset_axis3.write(axis3);
+    hid_t dcpl(H5Pcreate(H5P_DATASET_CREATE));
+    if (!chunk.empty()) {
+        vector<hsize_t> h_chunk(chunk.begin(), chunk.end());
+        H5Pset_chunk(dcpl, dim, &h_chunk[0]);
+        if (Input::List().output_shuffle)         H5Pset_shuffle(dcpl);
+        if (Input::List().output_compression > 0) H5Pset_deflate(dcpl, Input::List().output_compression);
+    }
+
+    hid_t filespace(H5Screate_simple(dim, &h_dims[0], NULL));
+    hid_t memspace (H5Screate_simple(dim, &h_count[0], NULL));
+    H5Sselect_hyperslab(filespace, H5S_SELECT_SET, &h_offset[0], NULL, &h_count[0], NULL);
+
+    hid_t dataset(H5Dcreate2(loc, tag.c_str(), H5T_NATIVE_DOUBLE, filespace, H5P_DEFAULT, dcpl, H5P_DEFAULT));
+    if ((dataset < 0) || (H5Dwrite(dataset, H5T_NATIVE_DOUBLE, memspace, filespace, xfer, local) < 0)) {
+        std::cout << "Error writing " << tag << std::endl;
+        exit(1);
+    }
+    H5Dclose(dataset);
+    H5Sclose(memspace);
+    H5Sclose(filespace);
+    H5Pclose(dcpl);
+
+//  The axes are the same everywhere, node 0 writes them
+    hid_t Axes(H5Gcreate2(loc, "Axes", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT));
+
+    for (size_t d(0); d < dim; ++d) {
+        hsize_t sz(axes[d].size());
+        hid_t axisspace(H5Screate_simple(1, &sz, NULL));
+        hid_t axis(H5Dcreate2(Axes, ("Axis"+stringify(d+1)).c_str(), H5T_NATIVE_DOUBLE, axisspace, 
+                              H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT));
+        if (rank != 0) H5Sselect_none(axisspace);
+        H5Dwrite(axis, H5T_NATIVE_DOUBLE, axisspace, axisspace, xfer, &(axes[d][0]));
+        H5Dclose(axis);
+        H5Sclose(axisspace);
+    }
 
+    H5Gclose(Axes);
+    H5Pclose(xfer);
 }
 //--------------------------------------------------------------
-void Export_Files::Xport:: Export_h5(const std::string tag,
- std::vector<double> &axis1, std::vector<double> &axis2, std::vector<double> &axis3, std::vector<double> &axis4,
- Array4D<double> &dataA,
- const size_t  step, const double  time, const double  dt,
- const int spec){
 //--------------------------------------------------------------
-//  Export data to H5 file
+//  Chunks of the single output file: the slab of a node, halved
+//  along the slowest axes until it fits in h5chunk_bytes
 //--------------------------------------------------------------
+vector<size_t> Export_Files::Xport::Chunk(const vector<size_t>& slab){
 
-    string      filename(Hdr[tag].Directory());
+    vector<size_t> chunk(slab);
+    size_t bytes(sizeof(double)), d(0);
+    for (size_t i(0); i < chunk.size(); ++i) bytes *= chunk[i];
 
-    //  Check Header file correctness
-    // if (Hdr[tag].dim() != 3) {
-    //     cout << "ERROR "<< tag <<" : "  << Hdr[tag].dim() << " dimensions != 3D structure\n";
-    //     exit(1);
-    // }
+    while ( (bytes > ofconventions::h5chunk_bytes) && (d < chunk.size()) ) {
+        if (chunk[d] > 1) {
+            bytes /= chunk[d];
+            chunk[d] = (chunk[d]+1)/2;
+            bytes *= chunk[d];
+        }
+        else ++d;
+    }
 
-    //  Open File
-    filename.append(tag).append(oH5Fextension(step,spec));
-    // we create a new hdf5 file
-    HighFive::File file(filename, HighFive::File::ReadWrite | HighFive::File::Create | HighFive::File::Truncate);
+    return chunk;
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+string Export_Files::Xport::Groupname(const std::string tag, const int spec){
 
-    // lets create a dataset of native double with the size of the vector
-    // 'data'
-    
-    vector<double> dummyvec(dataA.dim4());
-    vector<vector<double> > dummyvec2(dataA.dim3());
-    vector<vector<vector<double> > > dummyvec3(dataA.dim2());
-    vector<vector<vector<vector<double> > > > data;
+    if (spec < 0) return tag;
+    return tag + "_s" + stringify(spec);
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+//  Open the single output file of this step. With serial HDF5 only
+//  node 0 holds it, the other nodes send their slabs there
+//--------------------------------------------------------------
+void Export_Files::Xport::Open_step(const std::string name, const size_t step, const double time, const double dt,
+ MPI_Comm comm){
 
-    for (size_t i(0); i < dataA.dim1(); ++i)
-    {
-        for (size_t j(0); j < dataA.dim2(); ++j)
-        {
-            for (size_t k(0); k < dataA.dim3(); ++k)
-            {
-                for (size_t l(0); k < dataA.dim4(); ++l)
-                {
-                    dummyvec[l] = dataA(i,j,k,l);
-                }
-                dummyvec2[k] = dummyvec;
-            }
-            dummyvec3[j] = dummyvec2;
-        }
-        data.push_back(dummyvec3);
-    }
+    if (!Input::List().single_output_file) return;
 
-    std::vector<size_t> dims(4);
-    dims[0] = dataA.dim1();
-    dims[1] = dataA.dim2();
-    dims[2] = dataA.dim3();
-    dims[3] = dataA.dim4();
-    
-    HighFive::DataSet dataset =
-        file.createDataSet<double>(tag, HighFive::DataSpace(dims));
+    string filename(hdir + "output/" + name + oH5Fextension(step));
+
+#ifdef H5_HAVE_PARALLEL
+    stepfile = new HighFive::File(filename, HighFive::File::ReadWrite | HighFive::File::Create | HighFive::File::Truncate,
+                                  HighFive::MPIOFileDriver(comm, MPI_INFO_NULL));
+    stepfile_mpio = true;
+
+//  The time of the step is shared by all the diagnostics
+    add_attributes(*stepfile, time, dt);
+#else
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    if (rank == 0) Submit([=]() {
+        stepfile = new HighFive::File(filename, HighFive::File::ReadWrite | HighFive::File::Create | HighFive::File::Truncate);
+        add_attributes(*stepfile, time, dt);
+    });
+#endif
+}
+//--------------------------------------------------------------
+void Export_Files::Xport::Close_step(){
 
-    // lets write our vector of double to the HDF5 dataset
-    dataset.write(data);
+    Submit([this]() {
+        delete stepfile;
+        stepfile = NULL;
+    });
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+void Export_Files::Xport::Submit(const std::function<void()>& job){
 
-    /// Attributes
-    /// Only a few defined for now
-    /// dt, time
-    add_attributes(dataset,tag,time,dt);
+    if (queue == NULL) job();
+    else queue->push(job);
+}
+//--------------------------------------------------------------
+void Export_Files::Xport::flush(){
 
-    HighFive::Group Axes = file.createGroup("Axes");
+    if (queue != NULL) queue->flush();
+}
+//--------------------------------------------------------------
+Export_Files::Xport::~Xport(){
+
+    delete queue;   // writes what is left and joins the I/O thread
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+Export_Files::Output_Queue::Output_Queue(const size_t _depth)
+    : depth(std::max(_depth, size_t(1))), done(false), busy(false)
+{
+    worker = std::thread(&Output_Queue::run, this);
+}
+//--------------------------------------------------------------
+Export_Files::Output_Queue::~Output_Queue(){
+
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        done = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+//  Back-pressure: the time stepping waits here when the I/O thread
+//  falls depth diagnostics behind
+//--------------------------------------------------------------
+void Export_Files::Output_Queue::push(const std::function<void()>& job){
 
-    HighFive::DataSet dataset_axis1 =
-        Axes.createDataSet<double>("Axis1", HighFive::DataSpace::From(axis1));
-    dataset_axis1.write(axis1);
+    std::unique_lock<std::mutex> guard(lock);
+    room.wait(guard, [this]() { return jobs.size() < depth; });
+    jobs.push_back(job);
+    wake.notify_one();
+}
+//--------------------------------------------------------------
+void Export_Files::Output_Queue::flush(){
+
+    std::unique_lock<std::mutex> guard(lock);
+    room.wait(guard, [this]() { return jobs.empty() && !busy; });
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+//  The I/O thread, runs the jobs in order until the queue is 
+//  closed and empty
+//--------------------------------------------------------------
+void Export_Files::Output_Queue::run(){
 
-    HighFive::DataSet dataset_axis2 =
-        Axes.createDataSet<double>("Axis2", HighFive::DataSpace::From(axis2));
-    dataset_axis2.write(axis2);
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+        wake.wait(guard, [this]() { return done || !jobs.empty(); });
+        if (jobs.empty()) return;
 
-    HighFive::DataSet dataset_axis3 =
-        Axes.createDataSet<double>("Axis3", HighFive::DataSpace::From(axis3));
-    dataset_axis3.write(axis3);
+        std::function<void()> job;
+        job.swap(jobs.front());
+        jobs.pop_front();
+        busy = true;
+        room.notify_all();
 
-    HighFive::DataSet dataset_axis4 =
-        Axes.createDataSet<double>("Axis4", HighFive::DataSpace::From(axis4));
-    dataset_axis4.write(axis4);
+        guard.unlock();
+        job();
+        guard.lock();
 
+        busy = false;
+        room.notify_all();
+    }
 }
 //--------------------------------------------------------------
 //--------------------------------------------------------------
-    void Export_Files::Xport::add_attributes(HighFive::DataSet &dataset, const std::string tag, 
+    template<class H5Object>
+    void Export_Files::Xport::add_attributes(H5Object &dataset,
         const double  time, const double  dt) {
 //--------------------------------------------------------------
 //    Add initial attributes:
@@ -7687,14 +5473,14 @@ void Export_Files::Xport:: Export_h5(const std::string tag,
 //--------------------------------------------------------------
 
         // Now let's add a attribute on this dataset
-        HighFive::Attribute adt = dataset.createAttribute<double>("dt", HighFive::DataSpace::From(dt));
+        HighFive::Attribute adt = dataset.template createAttribute<double>("dt", HighFive::DataSpace::From(dt));
         adt.write(dt);
 
-        HighFive::Attribute at = dataset.createAttribute<double>("Time (c/\\omega_p)", HighFive::DataSpace::From(time));
+        HighFive::Attribute at = dataset.template createAttribute<double>("Time (c/\\omega_p)", HighFive::DataSpace::From(time));
         at.write(time);
 
         double timeps = time*formulary().Uconv("Time_ps");
-        HighFive::Attribute at_ps = dataset.createAttribute<double>("Time (ps)", HighFive::DataSpace::From(timeps));
+        HighFive::Attribute at_ps = dataset.template createAttribute<double>("Time (ps)", HighFive::DataSpace::From(timeps));
         at_ps.write(timeps);
 
 
@@ -21,8 +21,12 @@ namespace Export_Files{
         const int    rfile_digits = 3;
         const int    rank_digits = 6;
         const string rfile_extension = ".dat";
+        const char   restart_magic[8] = {'O','S','H','U','N','R','E','S'};
+        const size_t restart_version = 3;
+        const size_t restart_seed = 14695981039346656037ULL;
 
         const string h5file_extension = ".h5";
+        const size_t h5chunk_bytes = 1048576;  // Upper bound of the chunks of a dataset
     }
 //--------------------------------------------------------------
 
@@ -146,6 +150,31 @@ ofstream& operator<<(ofstream& s, const Array4D<T>& array4D) {
         };
 //--------------------------------------------------------------
 
+//--------------------------------------------------------------
+//  Background writer of the output. The jobs run in order on one
+//  I/O thread, push blocks while depth jobs are waiting
+        class Output_Queue {
+//--------------------------------------------------------------        
+        public:
+//          Constructor
+            Output_Queue(const size_t _depth);
+            ~Output_Queue();
+
+            void push(const std::function<void()>& job);
+            void flush();        // wait until all the jobs are written
+
+        private:
+            size_t                                depth;
+            bool                                  done, busy;
+            std::deque< std::function<void()> >   jobs;
+            std::mutex                            lock;
+            std::condition_variable               wake, room;
+            std::thread                           worker;
+
+            void run();
+        };
+//--------------------------------------------------------------
+
 //--------------------------------------------------------------
 //  Main facility for exporting data 
         class Xport {
@@ -155,6 +184,7 @@ ofstream& operator<<(ofstream& s, const Array4D<T>& array4D) {
             Xport(const Algorithms::AxisBundle<double>& _axis, 
               const vector< string > oTags,
               string homedir=""); 
+            ~Xport();
 
             void Export_h5(const std::string tag, std::vector<double> &axis1, 
                 std::vector<double> &data, 
@@ -179,13 +209,72 @@ ofstream& operator<<(ofstream& s, const Array4D<T>& array4D) {
                 const size_t  step, const double time, const double dt,
                 const int spec = -1);
             
-            void add_attributes(HighFive::DataSet &dataset, const std::string tag, 
+//          Collective export, every node of comm holds the hyperslab
+//          [offset, offset+count) of the global dataset, row-major.
+//          The global shape is given by the axes. With parallel HDF5
+//          all the nodes write their slab to the same file with
+//          MPI-IO, otherwise the slabs are gathered on node 0.
+            void Export_h5(const std::string tag,
+                vector< vector<double> > &axes,
+                const double* local, const vector<size_t>& offset, const vector<size_t>& count,
+                const size_t  step, const double time, const double dt,
+                MPI_Comm comm, const int spec = -1);
+
+//          Gather of the row-major slabs of the nodes of comm to the
+//          global array of node 0, returns true there. The layout of
+//          the slabs of a diagnostic is exchanged on its first gather
+            bool Gather(const std::string tag, const int spec, const double* local, 
+                const vector<size_t>& offset, const vector<size_t>& count, const vector<size_t>& dims,
+                MPI_Comm comm, vector<double>& global);
+
+//          Single output file, the diagnostics exported between
+//          Open_step and Close_step are groups of output/name_#####.h5
+            void Open_step(const std::string name, const size_t step, const double time, const double dt,
+                MPI_Comm comm);
+            void Close_step();
+
+//          Wait for the output staged on the I/O thread
+            void flush();
+
+            template<class H5Object>
+            void add_attributes(H5Object &h5obj,
                 const double time, const double dt);
 
         private:
             map< string, Header > Hdr; // Dictionary of headers
             string oH5Fextension(size_t step, int species = -1);
 
+//          Offset and count of the slab of every node, sizes and
+//          displacements of the Gatherv, valid on node 0 only
+            struct Slab_Layout {
+                vector<unsigned long>   slabs;
+                vector<int>             sizes, displs;
+            };
+            map< string, Slab_Layout > layouts;
+
+//          Single output file, NULL with one file per diagnostic. 
+//          With MPI-IO the file is shared by all the nodes 
+            string           hdir;
+            HighFive::File*  stepfile;
+            bool             stepfile_mpio;
+
+            string Groupname(const std::string tag, const int spec);
+            vector<size_t> Chunk(const vector<size_t>& slab);
+            void Write_slab(hid_t loc, const std::string tag, const vector< vector<double> > &axes,
+                const double* local, const vector<size_t>& offset, const vector<size_t>& count,
+                const vector<size_t>& chunk, const bool mpio, const int rank);
+
+//          With async_output the HDF5 calls are jobs of the queue, 
+//          the data of a diagnostic is staged in a buffer of its own
+            Output_Queue*    queue;
+            void Submit(const std::function<void()>& job);
+            void Stage_h5(const std::string tag, const vector< vector<double> > &axes, 
+                vector<double> &data, const vector<size_t>& slab,
+                const size_t step, const double time, const double dt, const int spec);
+            void Write_h5(const std::string filename, const std::string tag, 
+                const vector< vector<double> > &axes, const vector<double> &data, const vector<size_t>& slab,
+                const double time, const double dt, const int spec);
+
         };
 //--------------------------------------------------------------
 
@@ -195,15 +284,90 @@ ofstream& operator<<(ofstream& s, const Array4D<T>& array4D) {
         public:
             Restart_Facility(const int rank, string homedir="");
 
-            void Read(const int rank, const size_t re_step, State1D& Y, double time_start);
-            void Write(const int rank, const size_t re_step, State1D& Y, double time_dump);
+            void Read(Parallel_Environment_1D& PE, const size_t re_step, State1D& Y, double& time_start);
+            void Write(const Parallel_Environment_1D& PE, const size_t re_step, State1D& Y, double time_dump,
+                const bool durable = false);
 
-            void Read(const int rank, const size_t re_step, State2D& Y, double time_start);
-            void Write(const int rank, const size_t re_step, State2D& Y, double time_dump);
+            void Read(Parallel_Environment_2D& PE, const size_t re_step, State2D& Y, double& time_start);
+            void Write(const Parallel_Environment_2D& PE, const size_t re_step, State2D& Y, double time_dump,
+                const bool durable = false);
+
+//          True on all the nodes once one of them caught SIGTERM/SIGUSR1
+//          or is within walltime_margin of the walltime
+            bool Emergency();
 
         private:
             string hdir;
+            size_t alignment;
             string rFextension(const int rank, const size_t rstep);
+            string rH5extension(const size_t rstep);
+            double deadline;        // MPI_Wtime of the walltime checkpoint, 0 for none
+
+//          Fixed part of the file, followed by the size of each block
+            struct Header {
+                char   magic[8];
+                size_t version, nblocks, alignment, base, payload, checksum;
+                double time;
+            };
+
+//          The harmonics and fields as contiguous (pointer, bytes) blocks
+            typedef vector< pair<char*, size_t> > Blocks;
+            Blocks State_blocks(State1D& Y);
+            Blocks State_blocks(State2D& Y);
+
+            static size_t Checksum(size_t hash, const char* data, const size_t bytes);
+            static size_t Padding(const size_t bytes, const size_t align);
+
+//          base is the step of the full dump a delta is against, plus 
+//          one, and 0 for a full dump
+            void   Write_blocks(const string filename, const Blocks& blocks, double time_dump, const size_t base);
+            double Read_blocks(const int rank, const string prefix, const size_t re_step, const Blocks& blocks);
+
+//          The per-element files written before the header, read so 
+//          that a run can be continued across the upgrade
+            static bool Legacy(const string filename);
+            double Read_legacy(const string filename, const Blocks& blocks);
+
+            static void Encode_delta(const char* data, const char* base, const size_t bytes, vector<char>& packed);
+            static void Decode_delta(const vector<char>& packed, char* data, const size_t bytes);
+
+//          Multi-level: every dump goes to the node-local folder, every
+//          durable_restart_every-th also to restart/ 
+            string                         local_dir;
+            size_t                         dumps, base_step;
+            deque< pair<size_t, size_t> >  local_steps;    // (step, base) of the local dumps, oldest first
+            vector< vector<char> >         shadow;         // the state at base_step for the deltas
+
+            bool Durable(const bool forced);
+            void Write_local(const int rank, const string prefix, const size_t re_step, 
+                const Blocks& blocks, double time_dump, const bool full);
+
+//          Single restart file, the global state without the guard
+//          cells as [array][y][x][p][re,im] datasets, one per species
+//          and one for the fields. Any decomposition reads its slabs
+            struct Checkpoint_Set {
+                string                      name;
+                size_t                      nump;
+                vector< complex<double>* >  arrays;
+            };
+            struct Decomposition {
+                size_t numx, numy;      // local cells with the guard cells
+                size_t bndx, bndy;      // guard cells on each side
+                size_t offx, offy;      // first interior cell in the global grid
+                size_t Nx, Ny;          // global cells
+            };
+
+            vector<Checkpoint_Set> Checkpoint_sets(State1D& Y);
+            vector<Checkpoint_Set> Checkpoint_sets(State2D& Y);
+            Decomposition Layout(const Parallel_Environment_1D& PE);
+            Decomposition Layout(const Parallel_Environment_2D& PE);
+
+            void   Write_h5(const string filename, const vector<Checkpoint_Set>& sets, const Decomposition& layout,
+                MPI_Comm comm, double time_dump);
+            double Read_h5(const string filename, const vector<Checkpoint_Set>& sets, const Decomposition& layout,
+                MPI_Comm comm);
+            void   Transfer_h5(hid_t loc, const Checkpoint_Set& set, const Decomposition& layout,
+                const bool write, hid_t xfer);
         }; 
 //--------------------------------------------------------------
     }
@@ -297,14 +461,28 @@ ofstream& operator<<(ofstream& s, const Array4D<T>& array4D) {
             
 
             vector< PLegendre2D     >  PL2D;
-            vector< valarray<double>  >  pout1D_p1, pout1D_p2, pout1D_p3;
-            vector< Array2D<double>  >  pout2D_p1p2, pout2D_p1p3, pout2D_p2p3;
-            vector< Array3D<double>  >  pout3D;
 
             // Interpolation quantities
             vector< Array3D<double>  >  pradius;
             vector< Array2D<double>  >  phi;
             vector< valarray<double> >            dpx,dpy,dpz;
+
+            // Sparse interpolation matrix, the points of the Cartesian 
+            // grid inside pmax with the interval j of the |p| grid and 
+            // the offset h from its left node (ha = 0 extrapolates below p0)
+            struct Spline_Point {
+                size_t ipx, ipy, ipz, j;
+                double h, ha;
+            };
+            vector< vector<Spline_Point> >          points;
+            vector< vector<double> >                lower, upper, pivot;     // Thomas factors of the spline
+            vector< vector< Array2D<double> > >     cosmphi, sinmphi;
+
+            void spline(const size_t s, const vector<double>& y, 
+                vector<double>& a, vector<double>& b, vector<double>& c);
+            void harmonics(DistFunc1D& df, const size_t x0, const size_t s, vector< vector<complex<double> > >& sh);
+            void harmonics(DistFunc2D& df, const size_t x0, const size_t y0, const size_t s, vector< vector<complex<double> > >& sh);
+            void project(const size_t s, const vector< vector<complex<double> > >& sh, const int keep, double* out);
         };
 //--------------------------------------------------------------
 
@@ -373,12 +551,31 @@ ofstream& operator<<(ofstream& s, const Array4D<T>& array4D) {
         void bigdistdump(const State2D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
             const Parallel_Environment_2D& PE);
 
+//      Wait for the asynchronous output
+        void flush() { expo.flush(); }
+
     private:
         size_t                          Nbc;
         Export_Files::Xport             expo;
         fulldistvsposition              p_x;
         harmonicvsposition              f_x;
         vector< string >                oTags;
+
+        // Collective export of the local slab of a diagnostic,
+        // the leading axes of the dataset are the spatial ones
+        void Export_slab(const std::string tag, vector< vector<double> >& axes, const vector<double>& local, 
+            const Grid_Info& grid, const size_t tout, const double time, const double dt,
+            const Parallel_Environment_1D& PE, const int spec = -1);
+        void Export_slab(const std::string tag, vector< vector<double> >& axes, const vector<double>& local, 
+            const Grid_Info& grid, const size_t tout, const double time, const double dt,
+            const Parallel_Environment_2D& PE, const int spec = -1);
+
+        // Gather on node 0 of the momentum projections, width values 
+        // per cell. global is ordered by the cells, true on node 0
+        bool Gather_slab(const std::string tag, const vector<double>& local, const size_t width,
+            const Grid_Info& grid, const Parallel_Environment_1D& PE, const int spec, vector<double>& global);
+        bool Gather_slab(const std::string tag, const vector<double>& local, const size_t width,
+            const Grid_Info& grid, const Parallel_Environment_2D& PE, const int spec, vector<double>& global);
         
         // Fields
         void Ex(const State1D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
@@ -16,6 +16,7 @@
 
 #include <math.h>
 #include <map>
+#include <mpi.h>
 
 //  My libraries
 #include "lib-array.h"
@@ -23,12 +24,23 @@
 
 //  Declerations
 #include "state.h"
-// #include "input.h"
+#include "input.h"
 #include "fluid.h"
 #include "vlasov.h"
 #include "functors.h"
+#include "parallel.h"
 
 //**************************************************************
+//--------------------------------------------------------------
+//  The chunked operators are run by the whole team. When every
+//  species is l0 = 1 all the terms are serial and no team is forked
+template<class T>
+static bool harmonic_team(const T& Y) {
+    for (size_t s(0); s < Y.Species(); ++s) {
+        if (Y.DF(s).l0() > 1) return true;
+    }
+    return false;
+}
 
 //**************************************************************
 //--------------------------------------------------------------
@@ -68,93 +80,109 @@ void VlasovFunctor1D_explicitE::operator()(const State1D& Yin, State1D& Yslope){
 //--------------------------------------------------------------
     bool debug(0);
 
+    Harmonic_Group::Refresh(Yin);                   //  The harmonics of the share from their keepers
+
     Yslope = 0.0;
 
-    for (size_t s(0); s < Yin.Species(); ++s) {
+    //  One team for all species: the chunked operators are work-shared
+    //  by it and the serial terms run on one of its threads
+    #pragma omp parallel num_threads(Input::List().ompthreads) if(harmonic_team(Yin))
+    {
+        for (size_t s(0); s < Yin.Species(); ++s) {
 
-        if (Yin.DF(s).l0() == 1) {
+            if (Yin.DF(s).l0() == 1) {
 
-            SA[s].f1only(Yin.DF(s),Yslope.DF(s));
+                #pragma omp single
+                {
+                    SA[s].f1only(Yin.DF(s),Yslope.DF(s));
 
-            EF[s].f1only(Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
+                    EF[s].f1only(Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
 
-            BF[s].f1only(Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
+                    BF[s].f1only(Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
 
-            JX[s](Yin.DF(s),Yslope.EMF().Ex(),Yslope.EMF().Ey(),Yslope.EMF().Ez());
+                    JX[s](Yin.DF(s),Yslope.EMF().Ex(),Yslope.EMF().Ey(),Yslope.EMF().Ez());
 
-            AM[s](Yin.EMF(),Yslope.EMF());
+                    AM[s](Yin.EMF(),Yslope.EMF());
 
-            FA[s](Yin.EMF(),Yslope.EMF());
+                    FA[s](Yin.EMF(),Yslope.EMF());
+                }
 
-        }
-        else if (Yin.DF(s).m0() == 0) {
+            }
+            else if (Yin.DF(s).m0() == 0) {
 
-            // GA[s].es1d(Yin.DF(s),Yslope.EMF().Ex());
+                // GA[s].es1d(Yin.DF(s),Yslope.EMF().Ex());
             
-            // if (debug) 
-            // {
-            //     std::cout << "\n\n f at start:";
-            //     for (size_t ip(0); ip < Yin.SH(0,0,0).nump(); ++ip){
-            //         std::cout << "\nf(" << ip << ") = " << Yin.SH(0,1,0)(ip,4);
-            //     }
-
-            //     std::cout << "\n\n E at start:";
-            //     for (size_t ix(0); ix < Yin.SH(0,0,0).numx(); ++ix){
-            //         std::cout << "\nEx(" << ix << ") = " << Yin.EMF().Ex()(ix);
-            //     }            
-            // }
-            EF[s].es1d(Yin.DF(s),Yin.EMF().Ex(),Yslope.DF(s));
-
-
-            // if (debug) 
-            // {
-            //     std::cout << "\n\nf after E:";
-            //     for (size_t ip(0); ip < Yin.SH(0,0,0).nump(); ++ip){
-            //         std::cout << "\nf(" << ip << ") = " << Yslope.SH(0,1,0)(ip,4);
-            //     }
-            // }
-            JX[s].es1d(Yin.DF(s),Yslope.EMF().Ex());
-
-
-
-            // if (debug) 
-            // {
-            //     std::cout << "\n\n after J:";
-            //     for (size_t ix(0); ix < Yin.SH(0,0,0).numx(); ++ix){
-            //         std::cout << "\nEx(" << ix << ") = " << Yslope.EMF().Ex()(ix);
-            //     }            
-            // }
+                // if (debug) 
+                // {
+                //     std::cout << "\n\n f at start:";
+                //     for (size_t ip(0); ip < Yin.SH(0,0,0).nump(); ++ip){
+                //         std::cout << "\nf(" << ip << ") = " << Yin.SH(0,1,0)(ip,4);
+                //     }
+
+                //     std::cout << "\n\n E at start:";
+                //     for (size_t ix(0); ix < Yin.SH(0,0,0).numx(); ++ix){
+                //         std::cout << "\nEx(" << ix << ") = " << Yin.EMF().Ex()(ix);
+                //     }            
+                // }
+                EF[s].es1d(Yin.DF(s),Yin.EMF().Ex(),Yslope.DF(s));
+
+
+                // if (debug) 
+                // {
+                //     std::cout << "\n\nf after E:";
+                //     for (size_t ip(0); ip < Yin.SH(0,0,0).nump(); ++ip){
+                //         std::cout << "\nf(" << ip << ") = " << Yslope.SH(0,1,0)(ip,4);
+                //     }
+                // }
+                #pragma omp single
+                JX[s].es1d(Yin.DF(s),Yslope.EMF().Ex());
+
+
+
+                // if (debug) 
+                // {
+                //     std::cout << "\n\n after J:";
+                //     for (size_t ix(0); ix < Yin.SH(0,0,0).numx(); ++ix){
+                //         std::cout << "\nEx(" << ix << ") = " << Yslope.EMF().Ex()(ix);
+                //     }            
+                // }
             
-            SA[s].es1d(Yin.DF(s),Yslope.DF(s));
-
-            // if (debug) 
-            // {
-            //     std::cout << "\n\n after SA:";
-            //     for (size_t ip(0); ip < Yin.SH(0,0,0).nump(); ++ip){
-            //         std::cout << "\nf(" << ip << ") = " << Yslope.SH(0,1,0)(ip,4);
-            //     }
-            // }
-        }
+                SA[s].es1d(Yin.DF(s),Yslope.DF(s));
 
-        else {
+                // if (debug) 
+                // {
+                //     std::cout << "\n\n after SA:";
+                //     for (size_t ip(0); ip < Yin.SH(0,0,0).nump(); ++ip){
+                //         std::cout << "\nf(" << ip << ") = " << Yslope.SH(0,1,0)(ip,4);
+                //     }
+                // }
+            }
 
-            SA[s](Yin.DF(s),Yslope.DF(s));
+            else {
 
-            EF[s](Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
+                SA[s](Yin.DF(s),Yslope.DF(s));
 
-            BF[s](Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
+                EF[s](Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
 
-            JX[s](Yin.DF(s),Yslope.EMF().Ex(),Yslope.EMF().Ey(),Yslope.EMF().Ez());
+                BF[s](Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
 
-            AM[s](Yin.EMF(),Yslope.EMF());
+                #pragma omp single
+                {
+                    JX[s](Yin.DF(s),Yslope.EMF().Ex(),Yslope.EMF().Ey(),Yslope.EMF().Ez());
 
-            FA[s](Yin.EMF(),Yslope.EMF());
+                    AM[s](Yin.EMF(),Yslope.EMF());
+
+                    FA[s](Yin.EMF(),Yslope.EMF());
+                }
 
             
-        }
+            }
 
+        }
     }
 
+    Harmonic_Group::Fold(Yslope);
+
 }
 
 //--------------------------------------------------------------
@@ -163,93 +191,109 @@ void VlasovFunctor1D_explicitE::operator()(const State1D& Yin, State1D& Yslope,
 //--------------------------------------------------------------
     bool debug(0);
 
+    Harmonic_Group::Refresh(Yin);                   //  The harmonics of the share from their keepers
+
     Yslope = 0.0;
 
-    for (size_t s(0); s < Yin.Species(); ++s) {
+    //  One team for all species: the chunked operators are work-shared
+    //  by it and the serial terms run on one of its threads
+    #pragma omp parallel num_threads(Input::List().ompthreads) if(harmonic_team(Yin))
+    {
+        for (size_t s(0); s < Yin.Species(); ++s) {
 
-        if (Yin.DF(s).l0() == 1) {
+            if (Yin.DF(s).l0() == 1) {
 
-            SA[s].f1only(Yin.DF(s),Yslope.DF(s));
+                #pragma omp single
+                {
+                    SA[s].f1only(Yin.DF(s),Yslope.DF(s));
 
-            EF[s].f1only(Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
+                    EF[s].f1only(Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
 
-            BF[s].f1only(Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
+                    BF[s].f1only(Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
 
-            JX[s](Yin.DF(s),Yslope.EMF().Ex(),Yslope.EMF().Ey(),Yslope.EMF().Ez());
+                    JX[s](Yin.DF(s),Yslope.EMF().Ex(),Yslope.EMF().Ey(),Yslope.EMF().Ez());
 
-            AM[s](Yin.EMF(),Yslope.EMF());
+                    AM[s](Yin.EMF(),Yslope.EMF());
 
-            FA[s](Yin.EMF(),Yslope.EMF());
+                    FA[s](Yin.EMF(),Yslope.EMF());
+                }
 
-        }
-        else if (Yin.DF(s).m0() == 0) {
+            }
+            else if (Yin.DF(s).m0() == 0) {
 
-            // GA[s].es1d(Yin.DF(s),Yslope.EMF().Ex());
+                // GA[s].es1d(Yin.DF(s),Yslope.EMF().Ex());
             
-            // if (debug) 
-            // {
-            //     std::cout << "\n\n f at start:";
-            //     for (size_t ip(0); ip < Yin.SH(0,0,0).nump(); ++ip){
-            //         std::cout << "\nf(" << ip << ") = " << Yin.SH(0,1,0)(ip,4);
-            //     }
-
-            //     std::cout << "\n\n E at start:";
-            //     for (size_t ix(0); ix < Yin.SH(0,0,0).numx(); ++ix){
-            //         std::cout << "\nEx(" << ix << ") = " << Yin.EMF().Ex()(ix);
-            //     }            
-            // }
-            EF[s].es1d(Yin.DF(s),Yin.EMF().Ex(),Yslope.DF(s));
-
-
-            // if (debug) 
-            // {
-            //     std::cout << "\n\nf after E:";
-            //     for (size_t ip(0); ip < Yin.SH(0,0,0).nump(); ++ip){
-            //         std::cout << "\nf(" << ip << ") = " << Yslope.SH(0,1,0)(ip,4);
-            //     }
-            // }
-            JX[s].es1d(Yin.DF(s),Yslope.EMF().Ex());
-
-
-
-            // if (debug) 
-            // {
-            //     std::cout << "\n\n after J:";
-            //     for (size_t ix(0); ix < Yin.SH(0,0,0).numx(); ++ix){
-            //         std::cout << "\nEx(" << ix << ") = " << Yslope.EMF().Ex()(ix);
-            //     }            
-            // }
+                // if (debug) 
+                // {
+                //     std::cout << "\n\n f at start:";
+                //     for (size_t ip(0); ip < Yin.SH(0,0,0).nump(); ++ip){
+                //         std::cout << "\nf(" << ip << ") = " << Yin.SH(0,1,0)(ip,4);
+                //     }
+
+                //     std::cout << "\n\n E at start:";
+                //     for (size_t ix(0); ix < Yin.SH(0,0,0).numx(); ++ix){
+                //         std::cout << "\nEx(" << ix << ") = " << Yin.EMF().Ex()(ix);
+                //     }            
+                // }
+                EF[s].es1d(Yin.DF(s),Yin.EMF().Ex(),Yslope.DF(s));
+
+
+                // if (debug) 
+                // {
+                //     std::cout << "\n\nf after E:";
+                //     for (size_t ip(0); ip < Yin.SH(0,0,0).nump(); ++ip){
+                //         std::cout << "\nf(" << ip << ") = " << Yslope.SH(0,1,0)(ip,4);
+                //     }
+                // }
+                #pragma omp single
+                JX[s].es1d(Yin.DF(s),Yslope.EMF().Ex());
+
+
+
+                // if (debug) 
+                // {
+                //     std::cout << "\n\n after J:";
+                //     for (size_t ix(0); ix < Yin.SH(0,0,0).numx(); ++ix){
+                //         std::cout << "\nEx(" << ix << ") = " << Yslope.EMF().Ex()(ix);
+                //     }            
+                // }
             
-            SA[s].es1d(Yin.DF(s),Yslope.DF(s));
-
-            // if (debug) 
-            // {
-            //     std::cout << "\n\n after SA:";
-            //     for (size_t ip(0); ip < Yin.SH(0,0,0).nump(); ++ip){
-            //         std::cout << "\nf(" << ip << ") = " << Yslope.SH(0,1,0)(ip,4);
-            //     }
-            // }
-        }
+                SA[s].es1d(Yin.DF(s),Yslope.DF(s));
 
-        else {
+                // if (debug) 
+                // {
+                //     std::cout << "\n\n after SA:";
+                //     for (size_t ip(0); ip < Yin.SH(0,0,0).nump(); ++ip){
+                //         std::cout << "\nf(" << ip << ") = " << Yslope.SH(0,1,0)(ip,4);
+                //     }
+                // }
+            }
 
-            SA[s](Yin.DF(s),Yslope.DF(s));
+            else {
 
-            EF[s](Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
+                SA[s](Yin.DF(s),Yslope.DF(s));
 
-            BF[s](Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
+                EF[s](Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
 
-            JX[s](Yin.DF(s),Yslope.EMF().Ex(),Yslope.EMF().Ey(),Yslope.EMF().Ez());
+                BF[s](Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
 
-            AM[s](Yin.EMF(),Yslope.EMF());
+                #pragma omp single
+                {
+                    JX[s](Yin.DF(s),Yslope.EMF().Ex(),Yslope.EMF().Ey(),Yslope.EMF().Ez());
 
-            FA[s](Yin.EMF(),Yslope.EMF());
+                    AM[s](Yin.EMF(),Yslope.EMF());
+
+                    FA[s](Yin.EMF(),Yslope.EMF());
+                }
 
             
-        }
+            }
 
+        }
     }
 
+    Harmonic_Group::Fold(Yslope);
+
 }
 
 void VlasovFunctor1D_explicitE::operator()(const State1D& Yin, State1D& Yslope, size_t direction){}
@@ -282,28 +326,38 @@ void VlasovFunctor1D_spatialAdvection::operator()(const State1D& Yin, State1D& Y
 //--------------------------------------------------------------
     bool debug(0);
 
+    Harmonic_Group::Refresh(Yin);                   //  The harmonics of the share from their keepers
+
     Yslope = 0.0;
 
-    for (size_t s(0); s < Yin.Species(); ++s) {
+    //  One team for all species: the chunked operators are work-shared
+    //  by it and the serial terms run on one of its threads
+    #pragma omp parallel num_threads(Input::List().ompthreads) if(harmonic_team(Yin))
+    {
+        for (size_t s(0); s < Yin.Species(); ++s) {
 
-        if (Yin.DF(s).l0() == 1) {
+            if (Yin.DF(s).l0() == 1) {
 
-            SA[s].f1only(Yin.DF(s),Yslope.DF(s));
+                #pragma omp single
+                SA[s].f1only(Yin.DF(s),Yslope.DF(s));
 
-        }
-        else if (Yin.DF(s).m0() == 0) {
+            }
+            else if (Yin.DF(s).m0() == 0) {
             
-            SA[s].es1d(Yin.DF(s),Yslope.DF(s));
+                SA[s].es1d(Yin.DF(s),Yslope.DF(s));
 
-        }
+            }
 
-        else {
+            else {
 
-            SA[s](Yin.DF(s),Yslope.DF(s));            
-        }
+                SA[s](Yin.DF(s),Yslope.DF(s));            
+            }
 
+        }
     }
 
+    Harmonic_Group::Fold(Yslope);
+
 }
 
 void VlasovFunctor1D_spatialAdvection::operator()(const State1D& Yin, State1D& Yslope, size_t direction){}
@@ -393,33 +447,45 @@ void VlasovFunctor1D_momentumAdvection::operator()(const State1D& Yin, State1D&
 //--------------------------------------------------------------
     bool debug(0);
 
+    Harmonic_Group::Refresh(Yin);                   //  The harmonics of the share from their keepers
+
     Yslope = 0.0;
 
-    for (size_t s(0); s < Yin.Species(); ++s) {
+    //  One team for all species: the chunked operators are work-shared
+    //  by it and the serial terms run on one of its threads
+    #pragma omp parallel num_threads(Input::List().ompthreads) if(harmonic_team(Yin))
+    {
+        for (size_t s(0); s < Yin.Species(); ++s) {
 
-        if (Yin.DF(s).l0() == 1) {
+            if (Yin.DF(s).l0() == 1) {
 
-            EF[s].f1only(Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
+                #pragma omp single
+                {
+                    EF[s].f1only(Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
 
-            BF[s].f1only(Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
+                    BF[s].f1only(Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
+                }
 
-        }
-        else if (Yin.DF(s).m0() == 0) {
+            }
+            else if (Yin.DF(s).m0() == 0) {
             
-            EF[s].es1d(Yin.DF(s),Yin.EMF().Ex(),Yslope.DF(s));
+                EF[s].es1d(Yin.DF(s),Yin.EMF().Ex(),Yslope.DF(s));
 
-        }
+            }
 
-        else {
+            else {
 
-            EF[s](Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
+                EF[s](Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
 
-            BF[s](Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
+                BF[s](Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
                      
-        }
+            }
 
+        }
     }
 
+    Harmonic_Group::Fold(Yslope);
+
 }
 
 void VlasovFunctor1D_momentumAdvection::operator()(const State1D& Yin, State1D& Yslope, size_t direction){}
@@ -459,45 +525,60 @@ void VlasovFunctor2D_explicitE::operator()(const State2D& Yin, State2D& Yslope){
 //--------------------------------------------------------------
     bool debug(0);
 
+    Harmonic_Group::Refresh(Yin);                   //  The harmonics of the share from their keepers
+
     Yslope = 0.0;
 
-    for (size_t s(0); s < Yin.Species(); ++s) {
+    //  One team for all species: the chunked operators are work-shared
+    //  by it and the serial terms run on one of its threads
+    #pragma omp parallel num_threads(Input::List().ompthreads) if(harmonic_team(Yin))
+    {
+        for (size_t s(0); s < Yin.Species(); ++s) {
 
-        if (Yin.DF(s).l0() == 1) {
+            if (Yin.DF(s).l0() == 1) {
 
-            SA[s].f1only(Yin.DF(s),Yslope.DF(s));
+                #pragma omp single
+                {
+                    SA[s].f1only(Yin.DF(s),Yslope.DF(s));
 
-            EF[s].f1only(Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
+                    EF[s].f1only(Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
 
-            BF[s].f1only(Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
+                    BF[s].f1only(Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
 
-            JX[s](Yin.DF(s),Yslope.EMF().Ex(),Yslope.EMF().Ey(),Yslope.EMF().Ez());
+                    JX[s](Yin.DF(s),Yslope.EMF().Ex(),Yslope.EMF().Ey(),Yslope.EMF().Ez());
 
-            AM[s](Yin.EMF(),Yslope.EMF());
+                    AM[s](Yin.EMF(),Yslope.EMF());
 
-            FA[s](Yin.EMF(),Yslope.EMF());
+                    FA[s](Yin.EMF(),Yslope.EMF());
+                }
 
-        }
+            }
         
-        else {
+            else {
 
-            SA[s](Yin.DF(s),Yslope.DF(s));
+                SA[s](Yin.DF(s),Yslope.DF(s));
 
-            EF[s](Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
+                EF[s](Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
 
-            BF[s](Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
+                BF[s](Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
 
-            JX[s](Yin.DF(s),Yslope.EMF().Ex(),Yslope.EMF().Ey(),Yslope.EMF().Ez());
+                #pragma omp single
+                {
+                    JX[s](Yin.DF(s),Yslope.EMF().Ex(),Yslope.EMF().Ey(),Yslope.EMF().Ez());
 
-            AM[s](Yin.EMF(),Yslope.EMF());
+                    AM[s](Yin.EMF(),Yslope.EMF());
 
-            FA[s](Yin.EMF(),Yslope.EMF());
+                    FA[s](Yin.EMF(),Yslope.EMF());
+                }
 
             
-        }
+            }
 
+        }
     }
 
+    Harmonic_Group::Fold(Yslope);
+
 }
 
 void VlasovFunctor2D_explicitE::operator()(const State2D& Yin, State2D& Yslope, size_t direction){}
@@ -531,27 +612,39 @@ VlasovFunctor1D_implicitE_p1::VlasovFunctor1D_implicitE_p1(vector<size_t> Nl,vec
 void VlasovFunctor1D_implicitE_p1::operator()(const State1D& Yin, State1D& Yslope){
 //--------------------------------------------------------------
 
+    Harmonic_Group::Refresh(Yin);                   //  The harmonics of the share from their keepers
+
     Yslope = 0.0;
 
-    for (size_t s(0); s < Yin.Species(); ++s) {
+    //  One team for all species: the chunked operators are work-shared
+    //  by it and the serial terms run on one of its threads
+    #pragma omp parallel num_threads(Input::List().ompthreads) if(harmonic_team(Yin))
+    {
+        for (size_t s(0); s < Yin.Species(); ++s) {
 
-        if (Yin.DF(s).l0() == 1) 
-        {
-            SA[s].f1only(Yin.DF(s),Yslope.DF(s));
-            BF[s].f1only(Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
-            // HA[s](Yin.DF(s),Yin.HYDRO(),Yslope.DF(s));
-        }
-        else {
-            SA[s](Yin.DF(s),Yslope.DF(s));
-            BF[s](Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
-            // HA[s](Yin.DF(s),Yin.HYDRO(),Yslope.DF(s));
-        }
+            if (Yin.DF(s).l0() == 1) 
+            {
+                #pragma omp single
+                {
+                    SA[s].f1only(Yin.DF(s),Yslope.DF(s));
+                    BF[s].f1only(Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
+                }
+                // HA[s](Yin.DF(s),Yin.HYDRO(),Yslope.DF(s));
+            }
+            else {
+                SA[s](Yin.DF(s),Yslope.DF(s));
+                BF[s](Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
+                // HA[s](Yin.DF(s),Yin.HYDRO(),Yslope.DF(s));
+            }
 
-        // if (Input::List().filterdistribution)  Yslope.DF(s) = Yslope.DF(s).Filterp();
+            // if (Input::List().filterdistribution)  Yslope.DF(s) = Yslope.DF(s).Filterp();
 
 
+        }
     }
 
+    Harmonic_Group::Fold(Yslope);
+
 }
 void VlasovFunctor1D_implicitE_p1::operator()(const State1D& Yin, State1D& Yslope, size_t direction){}
 
@@ -582,27 +675,39 @@ VlasovFunctor2D_implicitE_p1::VlasovFunctor2D_implicitE_p1(vector<size_t> Nl,vec
 void VlasovFunctor2D_implicitE_p1::operator()(const State2D& Yin, State2D& Yslope){
 //--------------------------------------------------------------
 
+    Harmonic_Group::Refresh(Yin);                   //  The harmonics of the share from their keepers
+
     Yslope = 0.0;
 
-    for (size_t s(0); s < Yin.Species(); ++s) {
+    //  One team for all species: the chunked operators are work-shared
+    //  by it and the serial terms run on one of its threads
+    #pragma omp parallel num_threads(Input::List().ompthreads) if(harmonic_team(Yin))
+    {
+        for (size_t s(0); s < Yin.Species(); ++s) {
 
-        if (Yin.DF(s).l0() == 1) 
-        {
-            SA[s].f1only(Yin.DF(s),Yslope.DF(s));
-            BF[s].f1only(Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
-            // HA[s](Yin.DF(s),Yin.HYDRO(),Yslope.DF(s));
-        }
-        else {
-            SA[s](Yin.DF(s),Yslope.DF(s));
-            BF[s](Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
-            // HA[s](Yin.DF(s),Yin.HYDRO(),Yslope.DF(s));
-        }
+            if (Yin.DF(s).l0() == 1) 
+            {
+                #pragma omp single
+                {
+                    SA[s].f1only(Yin.DF(s),Yslope.DF(s));
+                    BF[s].f1only(Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
+                }
+                // HA[s](Yin.DF(s),Yin.HYDRO(),Yslope.DF(s));
+            }
+            else {
+                SA[s](Yin.DF(s),Yslope.DF(s));
+                BF[s](Yin.DF(s),Yin.EMF().Bx(),Yin.EMF().By(),Yin.EMF().Bz(),Yslope.DF(s));
+                // HA[s](Yin.DF(s),Yin.HYDRO(),Yslope.DF(s));
+            }
 
-        // if (Input::List().filterdistribution)  Yslope.DF(s) = Yslope.DF(s).Filterp();
+            // if (Input::List().filterdistribution)  Yslope.DF(s) = Yslope.DF(s).Filterp();
 
 
+        }
     }
 
+    Harmonic_Group::Fold(Yslope);
+
 }
 void VlasovFunctor2D_implicitE_p1::operator()(const State2D& Yin, State2D& Yslope, size_t direction){}
 
@@ -626,18 +731,32 @@ VlasovFunctor1D_implicitE_p2::VlasovFunctor1D_implicitE_p2(vector<size_t> Nl,vec
 void VlasovFunctor1D_implicitE_p2::operator()(const State1D& Yin, State1D& Yslope){
 // //---------------------------------------------------------------------------------------------------
 
+    Harmonic_Group::Refresh(Yin);                   //  The harmonics of the share from their keepers
+
     Yslope = 0.0;
 
-    for (size_t s(0); s < Yin.Species(); ++s) {
-        FA[s](Yin.EMF(),Yslope.EMF());
+    //  One team for all species: the chunked operators are work-shared
+    //  by it and the serial terms run on one of its threads
+    #pragma omp parallel num_threads(Input::List().ompthreads) if(harmonic_team(Yin))
+    {
+        for (size_t s(0); s < Yin.Species(); ++s) {
+            //  Faraday only touches the fields, so it overlaps the E-field term
+            #pragma omp single nowait
+            FA[s](Yin.EMF(),Yslope.EMF());
 
-        if (Yin.DF(s).l0() == 1) EF[s].f1only(Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
-        else                     EF[s](Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
+            if (Yin.DF(s).l0() == 1) {
+                #pragma omp single
+                EF[s].f1only(Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
+            }
+            else EF[s](Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
 
-        // if (Input::List().filterdistribution) Yslope.DF(s) = Yslope.DF(s).Filterp();
+            // if (Input::List().filterdistribution) Yslope.DF(s) = Yslope.DF(s).Filterp();
 
+        }
     }
 
+    Harmonic_Group::Fold(Yslope);
+
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -694,18 +813,32 @@ VlasovFunctor2D_implicitE_p2::VlasovFunctor2D_implicitE_p2(vector<size_t> Nl,vec
 void VlasovFunctor2D_implicitE_p2::operator()(const State2D& Yin, State2D& Yslope){
 // //---------------------------------------------------------------------------------------------------
 
+    Harmonic_Group::Refresh(Yin);                   //  The harmonics of the share from their keepers
+
     Yslope = 0.0;
 
-    for (size_t s(0); s < Yin.Species(); ++s) {
-        FA[s](Yin.EMF(),Yslope.EMF());
+    //  One team for all species: the chunked operators are work-shared
+    //  by it and the serial terms run on one of its threads
+    #pragma omp parallel num_threads(Input::List().ompthreads) if(harmonic_team(Yin))
+    {
+        for (size_t s(0); s < Yin.Species(); ++s) {
+            //  Faraday only touches the fields, so it overlaps the E-field term
+            #pragma omp single nowait
+            FA[s](Yin.EMF(),Yslope.EMF());
 
-        if (Yin.DF(s).l0() == 1) EF[s].f1only(Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
-        else                     EF[s](Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
+            if (Yin.DF(s).l0() == 1) {
+                #pragma omp single
+                EF[s].f1only(Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
+            }
+            else EF[s](Yin.DF(s),Yin.EMF().Ex(),Yin.EMF().Ey(),Yin.EMF().Ez(),Yslope.DF(s));
 
-        // if (Input::List().filterdistribution) Yslope.DF(s) = Yslope.DF(s).Filterp();
+            // if (Input::List().filterdistribution) Yslope.DF(s) = Yslope.DF(s).Filterp();
 
+        }
     }
 
+    Harmonic_Group::Fold(Yslope);
+
 }
 
 //--------------------------------------------------------------------------------------------------
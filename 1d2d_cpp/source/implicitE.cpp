@@ -350,7 +350,7 @@
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-    void Electric_Field_Methods::Implicit_E_Field::
+    int Electric_Field_Methods::Implicit_E_Field::
     advance(Algorithms::RK2<State1D>* rk, State1D& Yin, collisions_1D& coll, VlasovFunctor1D_implicitE_p2* rkF, const double step_size){//, double time, double dt){
 //--------------------------------------------------------------
 //  Calculate the implicit electric field
@@ -484,6 +484,8 @@
                         cout << "WARNING, Det = 0 in "<<zeros_in_det <<"locations" << endl;
                         if ( zeros_in_det > 8) { exit(1);}
         }
+
+        return execution_attempt;
     }
 // }
 //--------------------------------------------------------------
@@ -555,7 +557,7 @@
 
 
 //--------------------------------------------------------------
-    void Electric_Field_Methods::Implicit_E_Field::
+    int Electric_Field_Methods::Implicit_E_Field::
     advance(Algorithms::RK2<State2D>* rk, State2D& Yin, collisions_2D& coll, VlasovFunctor2D_implicitE_p2* rkF, const double step_size){//, double time, double dt){
 //--------------------------------------------------------------
 //  Calculate the implicit electric field
@@ -695,6 +697,8 @@
                         cout << "WARNING, Det = 0 in "<<zeros_in_det <<"locations" << endl;
                         if ( zeros_in_det > 8) { exit(1);}
         }
+
+        return execution_attempt;
     }
 // }
 //--------------------------------------------------------------
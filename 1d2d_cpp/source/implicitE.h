@@ -107,8 +107,8 @@
 //      Abstract class for explicit methods
 //--------------------------------------------------------------
         public:
-            virtual void advance(Algorithms::RK2<State1D>* rk, State1D& Y, collisions_1D& coll, VlasovFunctor1D_implicitE_p2* rkF, const double step_size)=0;//, double time, double dt) = 0; // "covariant" return
-            virtual void advance(Algorithms::RK2<State2D>* rk, State2D& Y, collisions_2D& coll, VlasovFunctor2D_implicitE_p2* rkF, const double step_size)=0;//, double time, double dt) = 0; // "covariant" return
+            virtual int advance(Algorithms::RK2<State1D>* rk, State1D& Y, collisions_1D& coll, VlasovFunctor1D_implicitE_p2* rkF, const double step_size)=0;//, double time, double dt) = 0; // "covariant" return
+            virtual int advance(Algorithms::RK2<State2D>* rk, State2D& Y, collisions_2D& coll, VlasovFunctor2D_implicitE_p2* rkF, const double step_size)=0;//, double time, double dt) = 0; // "covariant" return
             virtual ~Efield_Method() = 0;
         };
 //--------------------------------------------------------------
@@ -156,9 +156,9 @@
 //          Constructor
             Implicit_E_Field(const Algorithms::AxisBundle<double> axes);
 
-//          Main function
-            void advance(Algorithms::RK2<State1D>* rk, State1D& Y, collisions_1D& coll, VlasovFunctor1D_implicitE_p2* rkF, const double step_size);
-            void advance(Algorithms::RK2<State2D>* rk, State2D& Y, collisions_2D& coll, VlasovFunctor2D_implicitE_p2* rkF, const double step_size);
+//          Main function, returns the number of attempts needed to invert the conductivity
+            int advance(Algorithms::RK2<State1D>* rk, State1D& Y, collisions_1D& coll, VlasovFunctor1D_implicitE_p2* rkF, const double step_size);
+            int advance(Algorithms::RK2<State2D>* rk, State2D& Y, collisions_2D& coll, VlasovFunctor2D_implicitE_p2* rkF, const double step_size);
 
         private:
 //          Boundary Cells
@@ -36,6 +36,10 @@ Input::Input_List::Input_List():
     isthisarestart(0),
     dim(1),
     ompthreads(1),
+    ompbalance(0),
+    mpi_balance_every(0),
+    mpi_harmonics(1),
+    mpi_shared_halos(1),
     numsp(1),
     l0(6),
     m0(4),
@@ -49,6 +53,7 @@ Input::Input_List::Input_List():
     filterdistribution(0),filter_dp(0.0001),filter_pmax(0.0002),
     if_tridiagonal(1),
     implicit_E(1),
+    adaptive_implicit_E(0),
     dbydx_order(2),dbydy_order(2),
     abs_tol(1e-16),rel_tol(1e-6),max_fails(20),
     relativity(0),
@@ -57,6 +62,7 @@ Input::Input_List::Input_List():
     f00_implicitorexplicit(2),
     flm_collisions(0),flm_acc(0),ee_bool(1),ei_bool(1),
     BoundaryCells(4),
+    deep_halos(0),
     
     bndX(0),
     bndY(0),
@@ -66,8 +72,18 @@ Input::Input_List::Input_List():
     t_stop(8000),
     restart_time(10000.0),
     n_restarts(100),
+    restart_alignment(0),
+    single_restart_file(0),
+    local_restart_dir(""),
+    durable_restart_every(1), local_restarts_kept(2),
+    local_restart_delta(0),
+    emergency_restart(0),
+    walltime(0.0), walltime_margin(5.0),
 
 //          Output
+    single_output_file(0), output_shuffle(0),
+    async_output(0),
+    output_compression(0), output_queue_depth(4),
     o_EHist(0),
     o_Ex(0), o_Ey(0), o_Ez(0), o_Bx(0), o_By(0), o_Bz(0), o_x1x2(0), o_pth(0), 
     o_p1x1(0), o_p2x1(0), o_p3x1(0), o_p1p2x1(0), o_p1p3x1(0), o_p2p3x1(0), o_p1p2p3x1(0),
@@ -211,6 +227,90 @@ Input::Input_List::Input_List():
                 deckfile >> restart_time;
             }
 
+            if (deckstring == "restart_alignment") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> restart_alignment;
+            }
+
+            if (deckstring == "single_restart_file") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> deckstringbool;
+                single_restart_file = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
+            }
+
+            if (deckstring == "local_restart_dir") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> local_restart_dir;
+            }
+
+            if (deckstring == "durable_restart_every") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> durable_restart_every;
+            }
+
+            if (deckstring == "local_restarts_kept") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> local_restarts_kept;
+            }
+
+            if (deckstring == "local_restart_delta") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> deckstringbool;
+                local_restart_delta = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
+            }
+
+            if (deckstring == "emergency_restart") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> deckstringbool;
+                emergency_restart = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
+            }
+
+            if (deckstring == "walltime") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> walltime;
+            }
+
+            if (deckstring == "walltime_margin") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> walltime_margin;
+            }
+
             if (deckstring == "MPI_Processes_X") {
                 deckfile >> deckequalssign;
                 if(deckequalssign != "=") {
@@ -240,6 +340,31 @@ Input::Input_List::Input_List():
                 deckfile >> tempint;
                 MPI_X.push_back(tempint);
             }
+            if (deckstring == "MPI_Balance_every") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> mpi_balance_every;
+            }
+            if (deckstring == "MPI_Processes_Harmonics") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> mpi_harmonics;
+            }
+            if (deckstring == "MPI_Shared_Halos") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> deckstringbool;
+                mpi_shared_halos = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
+            }
 
             if (deckstring == "OpenMP_Threads") {
                 deckfile >> deckequalssign;
@@ -249,6 +374,15 @@ Input::Input_List::Input_List():
                 }
                 deckfile >> ompthreads;
             }
+            if (deckstring == "OpenMP_Balance") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> deckstringbool;
+                ompbalance = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
+            }
 
 
             //// ---- //////// ---- //////// ---- //////// ---- //////// ---- //////// ---- ////
@@ -649,6 +783,15 @@ Input::Input_List::Input_List():
                 }
                 deckfile >> dbydy_order;
             }
+            if (deckstring == "deep_halos") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> deckstringbool;
+                deep_halos = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
+            }
             if (deckstring == "adaptive_time_step_abs_tol") {
                 deckfile >> deckequalssign;
                 if(deckequalssign != "=") {
@@ -665,6 +808,15 @@ Input::Input_List::Input_List():
                 }
                 deckfile >> rel_tol;
             }
+            if (deckstring == "adaptive_time_step_implicit_E") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> deckstringbool;
+                adaptive_implicit_E = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
+            }
             if (deckstring == "adaptive_time_step_max_iterations") {
                 deckfile >> deckequalssign;
                 if(deckequalssign != "=") {
@@ -849,6 +1001,50 @@ Input::Input_List::Input_List():
             //// ---- //////// ---- //////// ---- //////// ---- //////// ---- //////// ---- ////
             //// ---- //////// ---- //////// ---- //////// ---- //////// ---- //////// ---- ////
 
+            if (deckstring == "single_output_file") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> deckstringbool;
+                single_output_file = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
+            }
+            if (deckstring == "output_compression") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> output_compression;
+            }
+            if (deckstring == "output_shuffle") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> deckstringbool;
+                output_shuffle = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
+            }
+            if (deckstring == "async_output") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> deckstringbool;
+                async_output = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
+            }
+            if (deckstring == "output_queue_depth") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> output_queue_depth;
+            }
+
             if (deckstring == "o_EHist") {
                 deckfile >> deckequalssign;
                 if(deckequalssign != "=") {
@@ -2079,15 +2275,38 @@ Input::Input_List::Input_List():
         if (dbydx_order > 2 || dbydy_order > 2) BoundaryCells = 6;
         else BoundaryCells = 4;
 
+        // Deep halos: the guard cells are exchanged once per time step, 
+        // every stage of the step consumes one stencil radius of them. 
+        // The implicit E solver takes two 2-stage steps (RK2 or RKHE21), 
+        // the explicit solver uses RKBS54 (7 stages) in 1D and RKCK54 
+        // (6 stages) in 2D
+        if (deep_halos) {
+            int radius((dbydx_order > 2 || dbydy_order > 2) ? 2 : 1);
+            int stages(4);
+            if (!implicit_E) stages = (NxGlobal.size() > 1) ? 6 : 7;
+
+            BoundaryCells = max(BoundaryCells, radius * stages);
+        }
+
         /// Do X discretization
         for (size_t i(0); i < NxGlobal.size(); ++i){
             NxLocalnobnd.push_back(NxGlobal[i] / MPI_X[i]) ;
             NxLocal.push_back(NxLocalnobnd[i] + 2 * BoundaryCells);
+            NxOffset.push_back(0);
             xminLocal.push_back(0.0);
             xmaxLocal.push_back(0.0);
             xminLocalnobnd.push_back(0.0);
             xmaxLocalnobnd.push_back(0.0);
             globdx.push_back((xmaxGlobal[i]-xminGlobal[i])/(double (NxGlobal[i]) ));
+
+            // The guard cells are filled by the next node only, y is
+            // not decomposed in 1D
+            if (i < dim && NxLocalnobnd[i] < size_t(BoundaryCells)) {
+                std::cout << "Error: " << NxLocalnobnd[i] << " cells per node in direction " << i 
+                          << " do not fill " << BoundaryCells << " guard cells, reduce MPI_Processes"
+                          << (deep_halos ? " or turn off deep_halos" : "") << std::endl;
+                exit(1);
+            }
         }
         
     }
@@ -36,8 +36,12 @@ namespace Input{
         bool isthisarestart;
         size_t dim;
         size_t ompthreads;
+        bool ompbalance;
         
         vector<size_t> MPI_X;
+        size_t mpi_balance_every;
+        size_t mpi_harmonics;
+        bool mpi_shared_halos;
 
         size_t numsp;
 
@@ -53,6 +57,7 @@ namespace Input{
 //          Algorithms
         bool if_tridiagonal;
         bool implicit_E;
+        bool adaptive_implicit_E;
         size_t dbydx_order, dbydy_order;
         double abs_tol, rel_tol;
         size_t max_fails;
@@ -65,14 +70,24 @@ namespace Input{
         bool ee_bool,ei_bool;
 
         int BoundaryCells;
+        bool deep_halos;
         
         int bndX, bndY;
 
         size_t n_outsteps, n_distoutsteps, n_bigdistoutsteps;
         double t_stop;
         int restart_time;  int n_restarts;
+        size_t restart_alignment;
+        bool single_restart_file;
+        std::string local_restart_dir;
+        int  durable_restart_every, local_restarts_kept;
+        bool local_restart_delta;
+        bool emergency_restart;
+        double walltime, walltime_margin;
 
 //          Output
+        bool single_output_file, output_shuffle, async_output;
+        int  output_compression, output_queue_depth;
         bool o_EHist;
         bool o_Ex, o_Ey, o_Ez, o_Bx, o_By, o_Bz, o_x1x2, o_pth;
         
@@ -201,6 +216,7 @@ namespace Input{
         std::vector<size_t> NxGlobal;
         std::vector<size_t> NxLocalnobnd;
         std::vector<size_t> NxLocal;
+        std::vector<size_t> NxOffset;       ///< First interior cell of this node in the global grid
 
         std::vector<double> xminGlobal;
         std::vector<double> xmaxGlobal;
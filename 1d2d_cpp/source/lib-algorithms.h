@@ -625,6 +625,13 @@ namespace Algorithms {
         T& operator()(T& Y, double h, AbstFunctor<T>* F);
         T& operator()(T& Y, double h, AbstFunctor<T>* F, size_t dir);
 
+//      The same step in two parts. First takes step 1 and returns 
+//      the state the last stage is evaluated at, Last returns the
+//      update (h/2)*F of step 2 without adding it to Y, so that it
+//      can be added to parts of Y at different times
+        T& First(T& Y, double h, AbstFunctor<T>* F);
+        T& Last(double h, AbstFunctor<T>* F);
+
     private:
 //      R-K copies for the data
         T  Y0, Yh;
@@ -670,8 +677,75 @@ namespace Algorithms {
 
         return Y;
     }
+    template<class T> T& RK2<T>::First
+            (T& Y, double h, AbstFunctor<T>* F) {
+//      Step 1 of RK2
+
+//      Initialization
+        Y0 = Y;
+
+//      Step 1
+        (*F)(Y0,Yh); Yh *= h;     // Yh = h*F(Y0)
+        Y0 += Yh;                 // Y0 = Y0 + h*Yh
+        Yh *= 0.5; Y  += Yh;      // Y  = Y  + (h/2)*F(Y0)      
+//      ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+        return Y0;
+    }
+    template<class T> T& RK2<T>::Last
+            (double h, AbstFunctor<T>* F) {
+//      Step 2 of RK2, the caller adds Yh to Y
+
+        (*F)(Y0,Yh); Yh *= 0.5*h; // Yh = (h/2)*F(Y0)
+
+        return Yh;
+    }
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
+//  RKHE21 (Heun-Euler embedded pair)
+//  Y is advanced with Heun (identical to RK2), while Yerr accumulates
+//  the difference between the Euler and the Heun solutions. Successive
+//  calls (e.g. for the two halves of the implicit-E step) add up their
+//  local error estimates in Yerr.
+    template<class T> class RKHE21 {
+    public:
+//      Constructor
+        RKHE21(T& Yin): Yt(Yin), Yh(Yin) { }
+
+//      Main function
+        T& operator()(T& Yerr, T& Y, double h, AbstFunctor<T>* F);
+
+    private:
+//      R-K copies for the data
+        T  Yt, Yh;
+    };
+
+    template<class T> T& RKHE21<T>::operator()
+            (T& Yerr, T& Y, double h, AbstFunctor<T>* F) {
+//      Take a step using RKHE21
+
+//      Initialization
+        Yt = Y;
+
+//      Step 1
+        (*F)(Yt,Yh); Yh *= h;     // Yh = h*F(Y)
+        Yt += Yh;                 // Yt = Y + h*F(Y), the Euler solution
+        Yh *= 0.5; Y  += Yh;      // Y  = Y + (h/2)*F(Y)
+//      ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//      Step 2
+        (*F)(Yt,Yh); Yh *= 0.5*h; // Yh = (h/2)*F(Yt)
+        Y += Yh;                  // Y  = Y + (h/2)*F(Yt), the Heun solution
+//      ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//      Error estimate
+        Yerr += Yt; Yerr -= Y;    // Yerr = Yerr + (Euler - Heun)
+//      ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+        return Y;
+    }
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
 //  RK3 (Osher&Shu Method) 
     template<class T> class RK3 {
     public:
@@ -26,6 +26,12 @@
 
 
 #include <map>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <string>
 #include <iomanip>
 #include <fstream>
@@ -133,6 +139,7 @@
 int main(int argc, char** argv) {
 
     MPI_Init(&argc,&argv);
+    Harmonic_Group::Setup();                                                        ///  Processes that share a subdomain
     time_t tstart, tend;
     tstart = omp_get_wtime();
 
@@ -147,32 +154,6 @@ int main(int argc, char** argv) {
     ///////////////////////////////////////////////////////////////////////////////////
     if (Input::List().dim == 1)   /// 1-D
     {
-        ///  Initiate the Parallel Environment and decompose the Computational Domain
-        std::cout << "\nInitializing parallel environment ...";
-        Parallel_Environment_1D PE;
-
-        std::cout << "     done \n\n";
-        
-        if (PE.RANK() == 0) {
-            Export_Files::Folders();
-        }
-    // --------------------------------------------------------------------------------------------------------------------------------
-    // --------------------------------------------------------------------------------------------------------------------------------
-    ///  Set up the grid
-    ///    Moves all of the relevant data from the input deck into a single container
-    ///
-    // --------------------------------------------------------------------------------------------------------------------------------
-    // --------------------------------------------------------------------------------------------------------------------------------
-        if (!PE.RANK()) std::cout << "\nInitializing grid ...";
-        Grid_Info grid(Input::List().ls, Input::List().ms,
-                        Input::List().xminLocal, Input::List().xmaxLocal, Input::List().NxLocal,
-                        Input::List().xminGlobal, Input::List().xmaxGlobal, Input::List().NxGlobal,
-                        // Input::List().pmax, Input::List().numps,
-                        Input::List().dp,
-                        Input::List().dpx,Input::List().dpy,Input::List().dpz);
-                        // Input::List().Npx, Input::List().Npy, Input::List().Npz);
-        if (!PE.RANK()) std::cout << "     done \n";
-        
     // --------------------------------------------------------------------------------------------------------------------------------
     // --------------------------------------------------------------------------------------------------------------------------------
     ///  CLOCK
@@ -201,63 +182,117 @@ int main(int argc, char** argv) {
 
         double next_restart(dt_restart);
 
+    // --------------------------------------------------------------------------------------------------------------------------------
+    ///  The restart environment, the load balance and the time stepper persist through the epochs of the run
+    ///  objects. A new epoch starts when the load balance moves cells between the nodes
+    // --------------------------------------------------------------------------------------------------------------------------------
+        int rank;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+        if (!rank) std::cout << "\nInitializing restart environment ...";
+        Export_Files::Restart_Facility Re(rank);
+        if (!rank) std::cout << "     done \n";
+
+        Load_Balance balance;
+        size_t epoch(0);
+
+        Stepper step(start_time,Input::List().dt,Input::List().abs_tol,Input::List().rel_tol,Input::List().max_fails);
+
+        do 
+        {
+        ///  Initiate the Parallel Environment and decompose the Computational Domain
+        if (!epoch) std::cout << "\nInitializing parallel environment ...";
+        Parallel_Environment_1D PE(balance.Cuts());
+
+        if (!epoch) std::cout << "     done \n\n";
+    
+        bool talk(!PE.RANK() && !Harmonic_Group::Rank() && !epoch);                 ///  Startup messages in the first epoch only
+
+        if (talk) {
+            Export_Files::Folders();
+        }
+    // --------------------------------------------------------------------------------------------------------------------------------
+    // --------------------------------------------------------------------------------------------------------------------------------
+    ///  Set up the grid
+    ///    Moves all of the relevant data from the input deck into a single container
+    ///
+    // --------------------------------------------------------------------------------------------------------------------------------
+    // --------------------------------------------------------------------------------------------------------------------------------
+        if (talk) std::cout << "\nInitializing grid ...";
+        Grid_Info grid(Input::List().ls, Input::List().ms,
+                        Input::List().xminLocal, Input::List().xmaxLocal, Input::List().NxLocal,
+                        Input::List().xminGlobal, Input::List().xmaxGlobal, Input::List().NxGlobal,
+                        // Input::List().pmax, Input::List().numps,
+                        Input::List().dp,
+                        Input::List().dpx,Input::List().dpy,Input::List().dpz);
+                        // Input::List().Npx, Input::List().Npy, Input::List().Npz);
+        if (talk) std::cout << "     done \n";
+    
+
     // --------------------------------------------------------------------------------------------------------------------------------
     // --------------------------------------------------------------------------------------------------------------------------------
     ///  INITIALIZATION
     // --------------------------------------------------------------------------------------------------------------------------------
     // --------------------------------------------------------------------------------------------------------------------------------
     
-        if (!PE.RANK()) std::cout << "Initializing restart environment ...";
-        Export_Files::Restart_Facility Re(PE.RANK());
-        if (!PE.RANK()) std::cout << "     done \n";
     
-        if (!PE.RANK()) std::cout << "Initializing state variable ...";
+        if (talk) std::cout << "Initializing state variable ...";
         State1D Y( grid.axis.Nx(0), Input::List().ls, Input::List().ms, 
             Input::List().dp, 
             Input::List().qs, Input::List().mass, 
             Input::List().hydromass, Input::List().hydrocharge, 
             Input::List().numparticles, Input::List().particlemass, Input::List().particlecharge);
-        if (!PE.RANK()) std::cout << "     done \n";
+        if (talk) std::cout << "     done \n";
     
-        if (!PE.RANK()) std::cout << "Initializing plasma profile ...";
+        if (talk) std::cout << "Initializing plasma profile ...";
         Setup_Y::initialize(Y, grid);
-        if (!PE.RANK()) std::cout << "     done \n";
+        if (talk) std::cout << "     done \n";
+        if (balance.Pending()) balance.Take_over(PE, Y);                            ///  Cells moved by the load balance
+        if (!epoch) Placement_report(Y, PE.RANK());                                 ///  Thread affinity and NUMA placement of the harmonics
         
 
-        if (!PE.RANK()) std::cout << "Initializing collision module ...";
+        if (talk) std::cout << "Initializing collision module ...";
         collisions_1D collide(Y);
-        if (!PE.RANK()) std::cout << "     done \n";    
+        if (talk) std::cout << "     done \n";    
         
-        if (!PE.RANK()) std::cout << "Initializing hydro module ...";
+        if (talk) std::cout << "Initializing hydro module ...";
         Hydro_Functor         HydroFunc(grid.axis.xmin(0), grid.axis.xmax(0), grid.axis.Nx(0));
-        if (!PE.RANK()) std::cout << "     done \n";
+        if (talk) std::cout << "     done \n";
         
-        if (!PE.RANK()) std::cout << "Initializing particle tracker ...";
+        if (talk) std::cout << "Initializing particle tracker ...";
         Particle_Pusher       Particle_Push(Input::List().par_xpos, Input::List().par_px, Input::List().par_py,  Input::List().par_pz,
             Input::List().xminLocalnobnd[0], Input::List().xmaxLocalnobnd[0], Input::List().NxLocalnobnd[0], Y.particles());
-        if (!PE.RANK()) std::cout << "     done \n";
+        if (talk) std::cout << "     done \n";
     
-        if (Input::List().isthisarestart){
-            if (!PE.RANK()) std::cout << "Reading restart files ...";
-            Re.Read(PE.RANK(),tout_start,Y,start_time);
-            if (!PE.RANK()) std::cout << "     done \n";
+        if (Input::List().isthisarestart && !epoch){
+            if (talk) std::cout << "Reading restart files ...";
+            Re.Read(PE,tout_start,Y,start_time);
+            step.resume(start_time);
+            next_out          = dt_out          * (floor(start_time/dt_out) + 1.0);         ///  The output schedules continue from the restart
+            next_dist_out     = dt_dist_out     * (floor(start_time/dt_dist_out) + 1.0);
+            next_big_dist_out = dt_big_dist_out * (floor(start_time/dt_big_dist_out) + 1.0);
+            next_restart      = dt_restart      * (floor(start_time/dt_restart) + 1.0);
+            if (talk) std::cout << "     done \n";
         }
         
-        if (!PE.RANK()) std::cout << "Initializing output module ...";
+        if (talk) std::cout << "Initializing output module ...";
         Output_Data::Output_Preprocessor  output( grid, Input::List().oTags);
-        if (!PE.RANK()) std::cout << "     done \n";
+        if (talk) std::cout << "     done \n";
         
-        if (!PE.RANK()) std::cout << "Output #0 ...";    
-        output( Y, grid, tout_start, start_time, Input::List().dt, PE );
-        if (!PE.RANK()) std::cout << "     done \n";
+        if (!epoch)
+        {
+            if (talk) std::cout << "Output #0 ...";    
+            output( Y, grid, tout_start, start_time, Input::List().dt, PE );
+            if (talk) std::cout << "     done \n";
     
-        if (!PE.RANK()) std::cout << "Distribution function output #0 ...";    
-        output.distdump(Y, grid, tout_start, start_time, Input::List().dt, PE );
-        output.bigdistdump(Y, grid, tout_start, start_time, Input::List().dt, PE );
-        if (!PE.RANK()) std::cout << "     done \n";
+            if (talk) std::cout << "Distribution function output #0 ...";    
+            output.distdump(Y, grid, tout_start, start_time, Input::List().dt, PE );
+            output.bigdistdump(Y, grid, tout_start, start_time, Input::List().dt, PE );
+            if (talk) std::cout << "     done \n";
+        }
     
         double plasmaperiod;
-        if (!(PE.RANK())){
+        if (talk){
             plasmaperiod = startmessages();
         }
     
@@ -269,7 +304,7 @@ int main(int argc, char** argv) {
     // --------------------------------------------------------------------------------------------------------------------------------
         if (Input::List().implicit_E) 
         {
-            if (!PE.RANK())
+            if (talk)
             { 
                 std::cout << "Starting Semi-Implicit, 1D OSHUN\n";
             }
@@ -293,73 +328,132 @@ int main(int argc, char** argv) {
             Electric_Field_Methods::Implicit_E_Field eim(grid.axis);
 
             if (!Input::List().collisions) {
-                if (!PE.RANK())
+                if (!(PE.RANK() || Harmonic_Group::Rank()))
                     std::cout << "\n Need collisions for implicit E field solver. \n Exiting. \n";
                 exit(0);
             }
             
             
-            // Algorithms::RKCK54<State1D> RK54(Y);
-            // Algorithms::RK4<State1D> RK(Y);
-            // State1D Y_star(Y), Y_old(Y);
-            // bool success(false);
+            Algorithms::RKHE21<State1D> RKHE(Y);
+            State1D Y_err(Y), Y_old(Y);
+            int E_attempts(1);
 
-            Stepper step(start_time,Input::List().dt,Input::List().abs_tol,Input::List().rel_tol,Input::List().max_fails);
+            //  With a fixed step the last stage is split around the halo exchange
+            const bool split_stage(!Input::List().adaptive_implicit_E && !Input::List().trav_wave);
+            Edge_Stage_1D stage(Y);
 
             for(step; step.time() < Input::List().t_stop; ++step)
             {
+                if (Re.Emergency())                                                    ///  Preemption or walltime: dump and leave
+                {
+                    if (!(PE.RANK() || Harmonic_Group::Rank())) cout << " \n Emergency Restart Output #" << t_out << "\n";
+                    if (Input::List().single_restart_file) output.flush();            ///  The restart file is written with HDF5 outside of the I/O thread
+                    Harmonic_Group::Collect(Y);
+                    Re.Write(PE, t_out, Y, step.time(), true);
+                    break;
+                }
+
+                if (balance.Repartition(PE, collide, Y))                               ///  Cells change owner in a new epoch
+                {
+                    break;
+                }
+
                 if (Input::List().ext_fields) Setup_Y::applyexternalfields(grid, Y, step.time());
 
-                // Y_old = Y;
+                if (Input::List().adaptive_implicit_E)
+                {
+                    Y_old = Y;
 
-                // while(!success)
-                // {
-                //     RK54(Y_star,Y,step.dt(),&impE_p1_Functor);
-                //     success = step.update_dt(Y_old,Y_star, Y);
-                // }
+                    while(!step.success())
+                    {
+                        Y_err = 0.0;
+                        balance.Resume();
+                        RKHE(Y_err, Y, step.dt(), &impE_p1_Functor);                                                /// Vlasov - Heun step and Heun-Euler error estimate
+                        balance.Pause();
+                        PE.Neighbor_ImplicitE_Communications(Y);                                                    /// Boundaries
+                        balance.Resume();
+                        E_attempts = eim.advance(&RK, Y, collide,&impE_p2_Functor, step.dt());                      /// Finds new electric field
+                        RKHE(Y_err, Y, step.dt(), &impE_p2_Functor);
+                        balance.Pause();
+                        step.update_dt(Y_old, Y_err, Y, E_attempts);                                                /// Accept or retry with a smaller step
+                    }
+                }
+                else
+                {
+                    balance.Resume();
+                    Y = RK(Y, step.dt(), &impE_p1_Functor);                                                         /// Vlasov - Updates the distribution function: Spatial Advection and B Field "action".
+                    balance.Pause();
+                    PE.Neighbor_ImplicitE_Communications(Y);                                                        /// Boundaries
+                    balance.Resume();
+                    eim.advance(&RK, Y, collide,&impE_p2_Functor, step.dt());                                       /// Finds new electric field
+                    if (split_stage) stage.Edges(RK, Y, step.dt(), &impE_p2_Functor);                               /// The boundary cells first, the interior while they are sent
+                    else Y = RK(Y, step.dt(), &impE_p2_Functor);
+                    balance.Pause();
+                }
                 
-                Y = RK(Y, step.dt(), &impE_p1_Functor);                                                             /// Vlasov - Updates the distribution function: Spatial Advection and B Field "action".
-                PE.Neighbor_ImplicitE_Communications(Y);                                                            /// Boundaries
-                eim.advance(&RK, Y, collide,&impE_p2_Functor, step.dt());                                           /// Finds new electric field
-                Y = RK(Y, step.dt(), &impE_p2_Functor);         
+                if (Input::List().trav_wave) Setup_Y::applytravelingwave(grid, Y, step.time(), step.dt());
 
                 if (Input::List().collisions)
-                    collide.advance(Y,step.time(),step.dt());                                               ///  Fokker-Planck   //
+                {
+                    balance.Resume();
+                    collide.advance_boundary(Y,step.time(),step.dt());                                      ///  Fokker-Planck   //
+                    balance.Pause();
+                }
 
                 // if (Input::List().hydromotion)
                 //     Y = RK(Y, step.dt(), &HydroFunc);                                      /// Hydro Motion
 
-                if (Input::List().trav_wave) Setup_Y::applytravelingwave(grid, Y, step.time(), step.dt());
+                PE.Neighbor_Communications_Post(Y);                                    ///  Boundaries are in flight during the interior stage and collisions
+
+                if (split_stage)
+                {
+                    balance.Resume();
+                    stage.Interior(RK, Y, step.dt(), &impE_p2_Functor);
+                    balance.Pause();
+                }
+
+                if (Input::List().collisions)
+                {
+                    balance.Resume();
+                    collide.advance_interior(Y,step.time(),step.dt());
+                    balance.Pause();
+                }
+
+                PE.Neighbor_Communications_Complete(Y);                                ///  Boundaries      //
+
+                if (step.time() > next_dist_out || step.time() > next_big_dist_out ||
+                    step.time() > next_restart  || step.time() > next_out)
+                    Harmonic_Group::Collect(Y);                                        ///  The first member of a group writes the whole state
 
-                PE.Neighbor_Communications(Y);                                         ///  Boundaries      //
                 // --------------------------------------------------------------------------------------------------------------------------------
                 // --------------------------------------------------------------------------------------------------------------------------------
                 /// Output
                 // --------------------------------------------------------------------------------------------------------------------------------
                 if (step.time() > next_dist_out)
                 {
-                    if (!(PE.RANK())) cout << " \n Dist Output #" << t_out << "\n";
+                    if (!(PE.RANK() || Harmonic_Group::Rank())) cout << " \n Dist Output #" << t_out << "\n";
                     output.distdump(Y, grid, t_out, step.time(), step.dt(), PE);
                     next_dist_out += dt_dist_out;
                 }
                 
                 if (step.time() > next_big_dist_out)
                 {
-                    if (!(PE.RANK())) cout << " \n Big Dist Output #" << t_out << "\n";
+                    if (!(PE.RANK() || Harmonic_Group::Rank())) cout << " \n Big Dist Output #" << t_out << "\n";
                     output.bigdistdump(Y, grid, t_out, step.time(), step.dt(), PE);
                     next_big_dist_out += dt_big_dist_out;
                 }
 
                 if (step.time() > next_restart)
                 {
-                    if (!(PE.RANK())) cout << " \n Restart Output #" << t_out << "\n";
-                    Re.Write(PE.RANK(), t_out, Y, step.time());
+                    if (!(PE.RANK() || Harmonic_Group::Rank())) cout << " \n Restart Output #" << t_out << "\n";
+                    if (Input::List().single_restart_file) output.flush();            ///  The restart file is written with HDF5 outside of the I/O thread
+                    Re.Write(PE, t_out, Y, step.time() + step.dt());                ///  Y is past the step
                     next_restart += dt_restart;
                 }
 
                 if (step.time() > next_out)
                 {
-                    if (!(PE.RANK()))
+                    if (!(PE.RANK() || Harmonic_Group::Rank()))
                     {
                         cout << "\n dt = " << step.dt();
                         cout << " , Output #" << t_out;
@@ -378,7 +472,7 @@ int main(int argc, char** argv) {
         } 
         else 
         {
-            if (!PE.RANK())
+            if (talk)
             { 
                 std::cout << "Starting Fully-Explicit, 1D OSHUN\n";
             }
@@ -401,10 +495,22 @@ int main(int argc, char** argv) {
             // Algorithms::RK4<State1D> RK(Y);
             State1D Y_star(Y), Y_old(Y);
 
-            Stepper step(start_time,Input::List().dt,Input::List().abs_tol,Input::List().rel_tol,Input::List().max_fails);
-
             for(step; step.time() < Input::List().t_stop; ++step)
             {
+                if (Re.Emergency())                                                    ///  Preemption or walltime: dump and leave
+                {
+                    if (!(PE.RANK() || Harmonic_Group::Rank())) cout << " \n Emergency Restart Output #" << t_out << "\n";
+                    if (Input::List().single_restart_file) output.flush();            ///  The restart file is written with HDF5 outside of the I/O thread
+                    Harmonic_Group::Collect(Y);
+                    Re.Write(PE, t_out, Y, step.time(), true);
+                    break;
+                }
+
+                if (balance.Repartition(PE, collide, Y))                               ///  Cells change owner in a new epoch
+                {
+                    break;
+                }
+
                 if (Input::List().ext_fields) Setup_Y::applyexternalfields(grid, Y, step.time());
 
                 Y_old = Y;
@@ -413,50 +519,71 @@ int main(int argc, char** argv) {
 
                 while(!step.success())
                 {
+                    balance.Resume();
                     RK54(Y_star,Y,step.dt(),&rkF);
+                    balance.Pause();
                     step.update_dt(Y_old,Y_star, Y);
                 }
 
+                if (Input::List().trav_wave) 
+                {                    
+                    Setup_Y::applytravelingwave(grid, Y, step.time(), step.dt());
+                }
+
                 if (Input::List().collisions)
-                    collide.advance(Y,step.time(),step.dt());                                           ///  Fokker-Planck   //
+                {
+                    balance.Resume();
+                    collide.advance_boundary(Y,step.time(),step.dt());                                  ///  Fokker-Planck   //
+                    balance.Pause();
+                }
 
                 // if (Input::List().hydromotion)
                     // Y = RK(Y, step.dt(), &HydroFunc);                                                   /// Hydro Motion
 
-                if (Input::List().trav_wave) 
-                {                    
-                    Setup_Y::applytravelingwave(grid, Y, step.time(), step.dt());
+                PE.Neighbor_Communications_Post(Y);                                    ///  Boundaries are in flight during the interior collisions
+
+                if (Input::List().collisions)
+                {
+                    balance.Resume();
+                    collide.advance_interior(Y,step.time(),step.dt());
+                    balance.Pause();
                 }
 
-                PE.Neighbor_Communications(Y);                                         ///  Boundaries      //
+                PE.Neighbor_Communications_Complete(Y);                                ///  Boundaries      //
+
+                if (step.time() > next_dist_out || step.time() > next_big_dist_out ||
+                    step.time() > next_restart  || step.time() > next_out)
+                    Harmonic_Group::Collect(Y);                                        ///  The first member of a group writes the whole state
+
                 // --------------------------------------------------------------------------------------------------------------------------------
                 // --------------------------------------------------------------------------------------------------------------------------------
                 /// Output
                 // --------------------------------------------------------------------------------------------------------------------------------
                 if (step.time() > next_dist_out)
                 {
-                    if (!(PE.RANK())) cout << " \n Dist Output #" << t_out << "\n";
+                    if (!(PE.RANK() || Harmonic_Group::Rank())) cout << " \n Dist Output #" << t_out << "\n";
                     output.distdump(Y, grid, t_out, step.time(), step.dt(), PE);
                     next_dist_out += dt_dist_out;
                 }
                 
                 if (step.time() > next_big_dist_out)
                 {
-                    if (!(PE.RANK())) cout << " \n Big Dist Output #" << t_out << "\n";
+                    if (!(PE.RANK() || Harmonic_Group::Rank())) cout << " \n Big Dist Output #" << t_out << "\n";
                     output.bigdistdump(Y, grid, t_out, step.time(), step.dt(), PE);
                     next_big_dist_out += dt_big_dist_out;
                 }
 
                 if (step.time() > next_restart)
                 {
-                    if (!(PE.RANK())) cout << " \n Restart Output #" << t_out << "\n";
-                    Re.Write(PE.RANK(), t_out, Y, step.time());
+                    if (!(PE.RANK() || Harmonic_Group::Rank())) cout << " \n Restart Output #" << t_out << "\n";
+                    if (Input::List().single_restart_file) output.flush();            ///  The restart file is written with HDF5 outside of the I/O thread
+                    Re.Write(PE, t_out, Y, step.time() + step.dt());                ///  Y is past the step
                     next_restart += dt_restart;
                 }
 
                 if (step.time() > next_out)
                 {
-                    if (!(PE.RANK()))
+                    if (!(PE.RANK() || Harmonic_Group::Rank()))
                     {
                         cout << "\n dt = " << step.dt();
                         cout << " , Output #" << t_out;
@@ -471,8 +598,13 @@ int main(int argc, char** argv) {
                 }
             }
         }
+        output.flush();
+        ++epoch;
+        } 
+        while (balance.Pending());
+
         tend = omp_get_wtime();
-        if (!(PE.RANK())){
+        if (!rank){
             cout << "Simulation took "<< difftime(tend, tstart) <<" second(s)."<< endl;
         }
     }
@@ -484,26 +616,6 @@ int main(int argc, char** argv) {
     ///////////////////////////////////////////////////////////////////////////////////    
     else
     {
-        ///  Initiate the Parallel Environment and decompose the Computational Domain
-        std::cout << "\nInitializing parallel environment ...";
-        Parallel_Environment_2D PE;
-        std::cout << "     done \n\n";
-        
-        if (PE.RANK() == 0) {
-            Export_Files::Folders();
-        }
-    
-        ///  Set up the grid
-        ///    Moves all of the relevant data from the input deck into a single container
-        if (!PE.RANK()) std::cout << "\nInitializing grid ...";
-        Grid_Info grid(Input::List().ls, Input::List().ms,
-                        Input::List().xminLocal, Input::List().xmaxLocal, Input::List().NxLocal,
-                        Input::List().xminGlobal, Input::List().xmaxGlobal, Input::List().NxGlobal,
-                        Input::List().dp,
-                        Input::List().dpx,Input::List().dpy,Input::List().dpz);
-                        
-        if (!PE.RANK()) std::cout << "     done \n";
-        
         // --------------------------------------------------------------------------------------------------------------------------------
         // --------------------------------------------------------------------------------------------------------------------------------
         ///  CLOCK
@@ -526,61 +638,109 @@ int main(int argc, char** argv) {
 
         double next_restart(dt_restart);
 
+        // --------------------------------------------------------------------------------------------------------------------------------
+        ///  The restart environment, the load balance and the time stepper persist through the epochs of the run
+        ///  objects. A new epoch starts when the load balance moves cells between the nodes
+        // --------------------------------------------------------------------------------------------------------------------------------
+        int rank;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+        if (!rank) std::cout << "\nInitializing restart environment ...";
+        Export_Files::Restart_Facility Re(rank);
+        if (!rank) std::cout << "     done \n";
+
+        Load_Balance balance;
+        size_t epoch(0);
+
+        Stepper step(start_time,Input::List().dt,Input::List().abs_tol,Input::List().rel_tol,Input::List().max_fails);
+
+        do 
+        {
+        ///  Initiate the Parallel Environment and decompose the Computational Domain
+        if (!epoch) std::cout << "\nInitializing parallel environment ...";
+        Parallel_Environment_2D PE(balance.Cuts());
+        if (!epoch) std::cout << "     done \n\n";
+    
+        bool talk(!PE.RANK() && !Harmonic_Group::Rank() && !epoch);                 ///  Startup messages in the first epoch only
+
+        if (talk) {
+            Export_Files::Folders();
+        }
+
+        ///  Set up the grid
+        ///    Moves all of the relevant data from the input deck into a single container
+        if (talk) std::cout << "\nInitializing grid ...";
+        Grid_Info grid(Input::List().ls, Input::List().ms,
+                        Input::List().xminLocal, Input::List().xmaxLocal, Input::List().NxLocal,
+                        Input::List().xminGlobal, Input::List().xmaxGlobal, Input::List().NxGlobal,
+                        Input::List().dp,
+                        Input::List().dpx,Input::List().dpy,Input::List().dpz);
+                    
+        if (talk) std::cout << "     done \n";
+    
+
         // --------------------------------------------------------------------------------------------------------------------------------
         // --------------------------------------------------------------------------------------------------------------------------------
         ///  INITIALIZATION
         // --------------------------------------------------------------------------------------------------------------------------------
         // --------------------------------------------------------------------------------------------------------------------------------
-        if (!PE.RANK()) std::cout << "Initializing restart environment ...";
-        Export_Files::Restart_Facility Re(PE.RANK());
-        if (!PE.RANK()) std::cout << "     done \n";
     
-        if (!PE.RANK()) std::cout << "Initializing state variable ...";
+        if (talk) std::cout << "Initializing state variable ...";
         State2D Y( grid.axis.Nx(0), grid.axis.Nx(1), Input::List().ls, Input::List().ms, 
             Input::List().dp, 
             Input::List().qs, Input::List().mass, 
             Input::List().hydromass, Input::List().hydrocharge);
-        if (!PE.RANK()) std::cout << "     done \n";
+        if (talk) std::cout << "     done \n";
 
     
-        if (!PE.RANK()) std::cout << "Initializing plasma profile ...";
+        if (talk) std::cout << "Initializing plasma profile ...";
         Setup_Y::initialize(Y, grid);
-        if (!PE.RANK()) std::cout << "     done \n";
+        if (talk) std::cout << "     done \n";
+        if (balance.Pending()) balance.Take_over(PE, Y);                            ///  Cells moved by the load balance
+        if (!epoch) Placement_report(Y, PE.RANK());                                 ///  Thread affinity and NUMA placement of the harmonics
     
-        if (!PE.RANK()) std::cout << "Initializing collision module ...";
+        if (talk) std::cout << "Initializing collision module ...";
         collisions_2D collide(Y);
-        if (!PE.RANK()) std::cout << "     done \n";    
+        if (talk) std::cout << "     done \n";    
     
-        // if (!PE.RANK()) std::cout << "Initializing hydro module ...";
+        // if (talk) std::cout << "Initializing hydro module ...";
         // Hydro_Functor         HydroFunc(grid.axis.xmin(0), grid.axis.xmax(0), grid.axis.Nx(0));
-        // if (!PE.RANK()) std::cout << "     done \n";
+        // if (talk) std::cout << "     done \n";
         
-        //         if (!PE.RANK()) std::cout << "Initializing particle tracker ...";
+        //         if (talk) std::cout << "Initializing particle tracker ...";
         //         Particle_Pusher       Particle_Push(Input::List().par_xpos, Input::List().par_px, Input::List().par_py,  Input::List().par_pz,
         //             Input::List().xminLocalnobnd[0], Input::List().xmaxLocalnobnd[0], Input::List().NxLocalnobnd[0], Y.particles());
-        //         if (!PE.RANK()) std::cout << "     done \n";
+        //         if (talk) std::cout << "     done \n";
         
-        if (Input::List().isthisarestart){
-            if (!PE.RANK()) std::cout << "Reading restart files ...";
-            Re.Read(PE.RANK(),tout_start,Y,start_time);
-            if (!PE.RANK()) std::cout << "     done \n";
+        if (Input::List().isthisarestart && !epoch){
+            if (talk) std::cout << "Reading restart files ...";
+            Re.Read(PE,tout_start,Y,start_time);
+            step.resume(start_time);
+            next_out          = dt_out          * (floor(start_time/dt_out) + 1.0);         ///  The output schedules continue from the restart
+            next_dist_out     = dt_dist_out     * (floor(start_time/dt_dist_out) + 1.0);
+            next_big_dist_out = dt_big_dist_out * (floor(start_time/dt_big_dist_out) + 1.0);
+            next_restart      = dt_restart      * (floor(start_time/dt_restart) + 1.0);
+            if (talk) std::cout << "     done \n";
         }
         
-        if (!PE.RANK()) std::cout << "Initializing output module ...";
+        if (talk) std::cout << "Initializing output module ...";
         Output_Data::Output_Preprocessor  output( grid, Input::List().oTags);
-        if (!PE.RANK()) std::cout << "     done \n";
+        if (talk) std::cout << "     done \n";
                      
-        if (!PE.RANK()) std::cout << "Output #0 ...";    
-        output( Y, grid, tout_start, start_time, Input::List().dt, PE );
-        if (!PE.RANK()) std::cout << "     done \n";
+        if (!epoch)
+        {
+            if (talk) std::cout << "Output #0 ...";    
+            output( Y, grid, tout_start, start_time, Input::List().dt, PE );
+            if (talk) std::cout << "     done \n";
     
-        if (!PE.RANK()) std::cout << "Distribution function output #0 ...";    
-        output.distdump(Y, grid, tout_start, start_time, Input::List().dt, PE );
-        output.bigdistdump(Y, grid, tout_start, start_time, Input::List().dt, PE );
-        if (!PE.RANK()) std::cout << "     done \n";
+            if (talk) std::cout << "Distribution function output #0 ...";    
+            output.distdump(Y, grid, tout_start, start_time, Input::List().dt, PE );
+            output.bigdistdump(Y, grid, tout_start, start_time, Input::List().dt, PE );
+            if (talk) std::cout << "     done \n";
+        }
     
         double plasmaperiod;
-        if (!(PE.RANK())){
+        if (talk){
             plasmaperiod = startmessages();
         }
     
@@ -592,7 +752,7 @@ int main(int argc, char** argv) {
         // --------------------------------------------------------------------------------------------------------------------------------
         if (Input::List().implicit_E) 
         {
-            if (!PE.RANK())
+            if (talk)
             { 
                 std::cout << "Starting Semi-Implicit, 2D OSHUN\n";
             }
@@ -617,72 +777,131 @@ int main(int argc, char** argv) {
             Electric_Field_Methods::Implicit_E_Field eim(grid.axis);
 
             if (!Input::List().collisions) {
-                if (!PE.RANK())
+                if (!(PE.RANK() || Harmonic_Group::Rank()))
                     std::cout << "\n Need collisions for implicit E field solver. \n Exiting. \n";
                 exit(0);
             }
 
-            // Algorithms::RKCK54<State1D> RK54(Y);
-            // Algorithms::RK4<State1D> RK(Y);
-            // State1D Y_star(Y), Y_old(Y);
-            // bool success(false);
+            Algorithms::RKHE21<State2D> RKHE(Y);
+            State2D Y_err(Y), Y_old(Y);
+            int E_attempts(1);
 
-            Stepper step(start_time,Input::List().dt,Input::List().abs_tol,Input::List().rel_tol,Input::List().max_fails);
+            //  With a fixed step the last stage is split around the halo exchange
+            const bool split_stage(!Input::List().adaptive_implicit_E && !Input::List().trav_wave);
+            Edge_Stage_2D stage(Y);
 
             for(step; step.time() < Input::List().t_stop; ++step)
             {
+                if (Re.Emergency())                                                    ///  Preemption or walltime: dump and leave
+                {
+                    if (!(PE.RANK() || Harmonic_Group::Rank())) cout << " \n Emergency Restart Output #" << t_out << "\n";
+                    if (Input::List().single_restart_file) output.flush();            ///  The restart file is written with HDF5 outside of the I/O thread
+                    Harmonic_Group::Collect(Y);
+                    Re.Write(PE, t_out, Y, step.time(), true);
+                    break;
+                }
+
+                if (balance.Repartition(PE, collide, Y))                               ///  Cells change owner in a new epoch
+                {
+                    break;
+                }
+
                 if (Input::List().ext_fields) Setup_Y::applyexternalfields(grid, Y, step.time());
 
-                // Y_old = Y;
+                if (Input::List().adaptive_implicit_E)
+                {
+                    Y_old = Y;
 
-                // while(!success)
-                // {
-                //     RK54(Y_star,Y,step.dt(),&impE_p1_Functor);
-                //     success = step.update_dt(Y_old,Y_star, Y);
-                // }
+                    while(!step.success())
+                    {
+                        Y_err = 0.0;
+                        balance.Resume();
+                        RKHE(Y_err, Y, step.dt(), &impE_p1_Functor);                                                /// Vlasov - Heun step and Heun-Euler error estimate
+                        balance.Pause();
+                        PE.Neighbor_ImplicitE_Communications(Y);                                                    /// Boundaries
+                        balance.Resume();
+                        E_attempts = eim.advance(&RK, Y, collide,&impE_p2_Functor, step.dt());                      /// Finds new electric field
+                        RKHE(Y_err, Y, step.dt(), &impE_p2_Functor);
+                        balance.Pause();
+                        step.update_dt(Y_old, Y_err, Y, E_attempts);                                                /// Accept or retry with a smaller step
+                    }
+                }
+                else
+                {
+                    balance.Resume();
+                    Y = RK(Y, step.dt(), &impE_p1_Functor);                                                         /// Vlasov - Updates the distribution function: Spatial Advection and B Field "action".
+                    balance.Pause();
+                    PE.Neighbor_ImplicitE_Communications(Y);                                                        /// Boundaries
+                    balance.Resume();
+                    eim.advance(&RK, Y, collide,&impE_p2_Functor, step.dt());                                       /// Finds new electric field
+                    if (split_stage) stage.Edges(RK, Y, step.dt(), &impE_p2_Functor);                               /// The boundary cells first, the interior while they are sent
+                    else Y = RK(Y, step.dt(), &impE_p2_Functor);
+                    balance.Pause();
+                }
                 
-                Y = RK(Y, step.dt(), &impE_p1_Functor);                                                             /// Vlasov - Updates the distribution function: Spatial Advection and B Field "action".
-                PE.Neighbor_ImplicitE_Communications(Y);                                                            /// Boundaries
-                eim.advance(&RK, Y, collide,&impE_p2_Functor, step.dt());                                           /// Finds new electric field
-                Y = RK(Y, step.dt(), &impE_p2_Functor);         
+                if (Input::List().trav_wave) Setup_Y::applytravelingwave(grid, Y, step.time(), step.dt());
 
                 if (Input::List().collisions)
-                    collide.advance(Y,step.time(),step.dt());                                               ///  Fokker-Planck   //
+                {
+                    balance.Resume();
+                    collide.advance_boundary(Y,step.time(),step.dt());                                      ///  Fokker-Planck   //
+                    balance.Pause();
+                }
 
                 // if (Input::List().hydromotion)
                     // Y = RK(Y, step.dt(), &HydroFunc);                                      /// Hydro Motion
 
-                if (Input::List().trav_wave) Setup_Y::applytravelingwave(grid, Y, step.time(), step.dt());
+                PE.Neighbor_Communications_Post(Y);                                    ///  Boundaries are in flight during the interior stage and collisions
+
+                if (split_stage)
+                {
+                    balance.Resume();
+                    stage.Interior(RK, Y, step.dt(), &impE_p2_Functor);
+                    balance.Pause();
+                }
+
+                if (Input::List().collisions)
+                {
+                    balance.Resume();
+                    collide.advance_interior(Y,step.time(),step.dt());
+                    balance.Pause();
+                }
+
+                PE.Neighbor_Communications_Complete(Y);                                ///  Boundaries      //
+
+                if (step.time() > next_dist_out || step.time() > next_big_dist_out ||
+                    step.time() > next_restart  || step.time() > next_out)
+                    Harmonic_Group::Collect(Y);                                        ///  The first member of a group writes the whole state
 
-                PE.Neighbor_Communications(Y);                                         ///  Boundaries      //
                 // --------------------------------------------------------------------------------------------------------------------------------
                 // --------------------------------------------------------------------------------------------------------------------------------
                 /// Output
                 // --------------------------------------------------------------------------------------------------------------------------------
                 if (step.time() > next_dist_out)
                 {
-                    if (!(PE.RANK())) cout << " \n Dist Output #" << t_out << "\n";
+                    if (!(PE.RANK() || Harmonic_Group::Rank())) cout << " \n Dist Output #" << t_out << "\n";
                     output.distdump(Y, grid, t_out, step.time(), step.dt(), PE);
                     next_dist_out += dt_dist_out;
                 }
                 
                 if (step.time() > next_big_dist_out)
                 {
-                    if (!(PE.RANK())) cout << " \n Big Dist Output #" << t_out << "\n";
+                    if (!(PE.RANK() || Harmonic_Group::Rank())) cout << " \n Big Dist Output #" << t_out << "\n";
                     output.bigdistdump(Y, grid, t_out, step.time(), step.dt(), PE);
                     next_big_dist_out += dt_big_dist_out;
                 }
 
                 if (step.time() > next_restart)
                 {
-                    if (!(PE.RANK())) cout << " \n Restart Output #" << t_out << "\n";
-                    Re.Write(PE.RANK(), t_out, Y, step.time());
+                    if (!(PE.RANK() || Harmonic_Group::Rank())) cout << " \n Restart Output #" << t_out << "\n";
+                    if (Input::List().single_restart_file) output.flush();            ///  The restart file is written with HDF5 outside of the I/O thread
+                    Re.Write(PE, t_out, Y, step.time() + step.dt());                ///  Y is past the step
                     next_restart += dt_restart;
                 }
 
                 if (step.time() > next_out)
                 {
-                    if (!(PE.RANK()))
+                    if (!(PE.RANK() || Harmonic_Group::Rank()))
                     {
                         cout << "\n dt = " << step.dt();
                         cout << " , Output #" << t_out;
@@ -701,7 +920,7 @@ int main(int argc, char** argv) {
         } 
         else 
         {
-            if (!PE.RANK())
+            if (talk)
             { 
                 std::cout << "Starting Fully-Explicit, 2D OSHUN\n";
             }
@@ -721,57 +940,90 @@ int main(int argc, char** argv) {
             // Algorithms::RK4<State1D> RK(Y);
             State2D Y_star(Y), Y_old(Y);
 
-            Stepper step(start_time,Input::List().dt,Input::List().abs_tol,Input::List().rel_tol,Input::List().max_fails);
-
             for(step; step.time() < Input::List().t_stop; ++step)
             {
+                if (Re.Emergency())                                                    ///  Preemption or walltime: dump and leave
+                {
+                    if (!(PE.RANK() || Harmonic_Group::Rank())) cout << " \n Emergency Restart Output #" << t_out << "\n";
+                    if (Input::List().single_restart_file) output.flush();            ///  The restart file is written with HDF5 outside of the I/O thread
+                    Harmonic_Group::Collect(Y);
+                    Re.Write(PE, t_out, Y, step.time(), true);
+                    break;
+                }
+
+                if (balance.Repartition(PE, collide, Y))                               ///  Cells change owner in a new epoch
+                {
+                    break;
+                }
+
                 if (Input::List().ext_fields) Setup_Y::applyexternalfields(grid, Y, step.time());
 
                 Y_old = Y;
 
                 while(!step.success())
                 {
+                    balance.Resume();
                     RK54(Y_star,Y,step.dt(),&rkF);
+                    balance.Pause();
                     step.update_dt(Y_old,Y_star, Y);
                 }
 
+                if (Input::List().trav_wave) Setup_Y::applytravelingwave(grid, Y, step.time(), step.dt());
+
                 if (Input::List().collisions)
-                    collide.advance(Y,step.time(),step.dt());                                           ///  Fokker-Planck   //
+                {
+                    balance.Resume();
+                    collide.advance_boundary(Y,step.time(),step.dt());                                  ///  Fokker-Planck   //
+                    balance.Pause();
+                }
 
                 // if (Input::List().hydromotion)
                     // Y = RK(Y, step.dt(), &HydroFunc);                                                   /// Hydro Motion
 
-                if (Input::List().trav_wave) Setup_Y::applytravelingwave(grid, Y, step.time(), step.dt());
+                PE.Neighbor_Communications_Post(Y);                                    ///  Boundaries are in flight during the interior collisions
+
+                if (Input::List().collisions)
+                {
+                    balance.Resume();
+                    collide.advance_interior(Y,step.time(),step.dt());
+                    balance.Pause();
+                }
+
+                PE.Neighbor_Communications_Complete(Y);                                ///  Boundaries      //
+
+                if (step.time() > next_dist_out || step.time() > next_big_dist_out ||
+                    step.time() > next_restart  || step.time() > next_out)
+                    Harmonic_Group::Collect(Y);                                        ///  The first member of a group writes the whole state
 
-                PE.Neighbor_Communications(Y);                                         ///  Boundaries      //
                 // --------------------------------------------------------------------------------------------------------------------------------
                 // --------------------------------------------------------------------------------------------------------------------------------
                 /// Output
                 // --------------------------------------------------------------------------------------------------------------------------------
                 if (step.time() > next_dist_out)
                 {
-                    if (!(PE.RANK())) cout << " \n Dist Output #" << t_out << "\n";
+                    if (!(PE.RANK() || Harmonic_Group::Rank())) cout << " \n Dist Output #" << t_out << "\n";
                     output.distdump(Y, grid, t_out, step.time(), step.dt(), PE);
                     next_dist_out += dt_dist_out;
                 }
                 
                 if (step.time() > next_big_dist_out)
                 {
-                    if (!(PE.RANK())) cout << " \n Big Dist Output #" << t_out << "\n";
+                    if (!(PE.RANK() || Harmonic_Group::Rank())) cout << " \n Big Dist Output #" << t_out << "\n";
                     output.bigdistdump(Y, grid, t_out, step.time(), step.dt(), PE);
                     next_big_dist_out += dt_big_dist_out;
                 }
 
                 if (step.time() > next_restart)
                 {
-                    if (!(PE.RANK())) cout << " \n Restart Output #" << t_out << "\n";
-                    Re.Write(PE.RANK(), t_out, Y, step.time());
+                    if (!(PE.RANK() || Harmonic_Group::Rank())) cout << " \n Restart Output #" << t_out << "\n";
+                    if (Input::List().single_restart_file) output.flush();            ///  The restart file is written with HDF5 outside of the I/O thread
+                    Re.Write(PE, t_out, Y, step.time() + step.dt());                ///  Y is past the step
                     next_restart += dt_restart;
                 }
 
                 if (step.time() > next_out)
                 {
-                    if (!(PE.RANK()))
+                    if (!(PE.RANK() || Harmonic_Group::Rank()))
                     {
                         cout << "\n dt = " << step.dt();
                         cout << " , Output #" << t_out;
@@ -786,8 +1038,13 @@ int main(int argc, char** argv) {
                 }                
             }
         }
+        output.flush();
+        ++epoch;
+        } 
+        while (balance.Pending());
+
         tend = omp_get_wtime();
-        if (!(PE.RANK())){
+        if (!rank){
             cout << "Simulation took "<< difftime(tend, tstart) <<" second(s)."<< endl;
         }
     }
@@ -18,961 +18,895 @@
 #include <vector>
 #include <valarray>
 #include <complex>
+#include <cstring>
 #include <cmath>
 #include <stdio.h>
 #include <float.h>
 #include <string>
 #include <iomanip>
 #include <fstream>
+#include <omp.h>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
 
 //  My libraries
 #include "lib-array.h"
+#include "lib-algorithms.h"
 #include <map>
+#include <set>
 
 //  Declarations
 #include "input.h"
 #include "state.h"
 #include "parallel.h"
+#include "formulary.h"
+#include "collisions.h"
 
 
 //**************************************************************
 //**************************************************************
-//  Definition of the Nodes Communications class
+//  Harmonic groups of the hybrid decomposition
 //**************************************************************
 //**************************************************************
 
+MPI_Comm Harmonic_Group::space(MPI_COMM_WORLD);
+MPI_Comm Harmonic_Group::harmonics(MPI_COMM_SELF);
+int      Harmonic_Group::rank(0);
+int      Harmonic_Group::size(1);
 
-//**************************************************************
 //--------------------------------------------------------------
-Node_ImplicitE_Communications_1D:: Node_ImplicitE_Communications_1D() :
+void Harmonic_Group:: Setup() {
 //--------------------------------------------------------------
-//  Constructor
+//  Consecutive world ranks form a group, so that a group stays on
+//  one host when the launcher fills the hosts in order. Member r
+//  of every group is a node of the r-th spatial communicator. The
+//  first member writes the output and the messages of a node are
+//  gated on Rank() == 0
 //--------------------------------------------------------------
-        Nbc(Input::List().BoundaryCells),      // # of boundary cells
-        bndX(Input::List().bndX) {        // Type of boundary in X
+    size = std::max(int(Input::List().mpi_harmonics), 1);
+    if (size == 1) return;
 
-    // 3 components for Bx, By, Bz
-    msg_sizeX = 3;
+    int world_rank, world_size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
 
-    msg_sizeX *= Nbc; //(IN().inp().y.dim()*Nbc);
-    msg_bufX = new complex<double>[msg_sizeX];
+    if (world_size % size != 0) {
+        if (!world_rank) std::cout << "the " << world_size << " processes do not split into groups of "
+                                   << size << ", terminating ..." << endl;
+        MPI_Finalize(); exit(1);
+    }
 
+    rank = world_rank % size;
+    MPI_Comm_split(MPI_COMM_WORLD, world_rank / size, rank, &harmonics);
+    MPI_Comm_split(MPI_COMM_WORLD, rank, world_rank / size, &space);
 }
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-Node_ImplicitE_Communications_1D:: ~Node_ImplicitE_Communications_1D(){
-//--------------------------------------------------------------
-//  Destructor
-//--------------------------------------------------------------
-    delete[] msg_bufX;
-}
+MPI_Comm Harmonic_Group:: Space()     {return space;}
+MPI_Comm Harmonic_Group:: Harmonics() {return harmonics;}
+int Harmonic_Group:: Rank() {return rank;}
+int Harmonic_Group:: Size() {return size;}
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-int Node_ImplicitE_Communications_1D:: BNDX()  const {return bndX;}
+void Harmonic_Group:: Share(const size_t first, const size_t num, size_t& h0, size_t& h1) {
 //--------------------------------------------------------------
-
+//  Equal shares in the order of the members
+//--------------------------------------------------------------
+    size_t n(num - first);
+    h0 = first + (n * rank) / size;
+    h1 = first + (n * (rank+1)) / size;
+}
 //--------------------------------------------------------------
-
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-//  Send and receive in the X direction
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
 //--------------------------------------------------------------
-void Node_ImplicitE_Communications_1D::Send_right_X(State1D& Y, int dest) {
+void Harmonic_Group:: Chunks(const size_t first, const size_t num,
+                             valarray<size_t>& f_start, valarray<size_t>& f_end) {
 //--------------------------------------------------------------
-//  X-axis : Read data from the right boundary and send them 
-//           to the node on the right
+//  Equal chunks with a boundary gap of 2 between them, the gaps
+//  are done after the chunks. The cut is made in signed numbers,
+//  a share too small for a chunk of 2 per thread goes whole to
+//  the last thread and the other chunks are left empty
 //--------------------------------------------------------------
+    size_t h0, h1;
+    Share(first, num, h0, h1);
 
-    static size_t step_f(Nbc);
-    size_t bufind(0);
+    long num_threads(f_start.size());
+    long fsperthread((long(first) + long(h1) - long(h0))/num_threads - 2);
+    valarray<long> s(num_threads), e(num_threads);
 
-    // Fields:   x0 "Right-Bound --> "
-    for(size_t i(3); i < Y.EMF().dim(); ++i){  // "3" as opposed to "0"
-        for(size_t e(0); e < Nbc; e++) {
-            msg_bufX[bufind + e] = Y.FLD(i)(Y.FLD(i).numx()-2*Nbc+e);
-        }
-        bufind += step_f;
+    s[0] = long(h0);
+    e[0] = long(h0) - long(first) + fsperthread - 2;   // f_end isn't processed until the
+    for (long i(1); i < num_threads; ++i) {             // boundaries, a gap of 2 is a gap of 3
+        s[i] = e[i-1] + 2;
+        e[i] = s[i] + fsperthread;
     }
+    e[num_threads-1] = long(h1);
+
+    bool chunked(true);
+    for (long i(0); i < num_threads; ++i) chunked = chunked && (e[i] >= s[i] + 2);
 
-    MPI_Send(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 0, MPI_COMM_WORLD);
+    for (long i(0); i < num_threads; ++i) {
+        f_start[i] = (chunked ? size_t(s[i]) : h0);
+        f_end[i]   = (chunked ? size_t(e[i]) : h0);
+    }
+    if (!chunked) f_end[num_threads-1] = h1;
 }
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-void Node_ImplicitE_Communications_1D::Recv_from_left_X(State1D& Y, int origin) {
-//--------------------------------------------------------------
-//  X-axis : Receive data from the node on the left and update
-//           the left guard cells
+//  The harmonics whose terms this member evaluates, and who reads
+//  and writes which harmonics kept by another member, for the 
+//  distributions of (l0,m0)
 //--------------------------------------------------------------
+typedef std::pair<size_t,size_t> Harmonic;
+static map< Harmonic, std::set<Harmonic> > evaluated;
 
-    static size_t step_f(Nbc);
-    size_t bufind(0);
-    MPI_Status status;
+struct Harmonic_Exchange {
+    vector< vector<size_t> > reads, writes;     //  The harmonics of member q that this member reads, writes to
+    vector< vector<size_t> > serves, takes;     //  The harmonics of this member that q reads, writes to
+};
+static map< Harmonic, Harmonic_Exchange > exchanges;
 
-    // Receive Data
-    MPI_Recv(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 0, MPI_COMM_WORLD, &status);
+//  The harmonics sent to or received from each member
+typedef vector< vector<valarray<complex<double> >*> > Harmonic_Lists;
+//--------------------------------------------------------------
 
-    // Fields:   x0-"---> Left-Guard"
-    for(size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
-        for(size_t e(0); e < Nbc; e++) {
-            Y.FLD(i)(e) = msg_bufX[bufind + e];
-        }
-        bufind += step_f;
-    }
+//--------------------------------------------------------------
+void Harmonic_Group:: Evaluates(const size_t l0, const size_t m0, const size_t l, const size_t m) {
+//--------------------------------------------------------------
+    if (size == 1) return;
+    evaluated[Harmonic(l0,m0)].insert(Harmonic(l,m));
 }
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-void Node_ImplicitE_Communications_1D::Send_left_X(State1D& Y, int dest) {
+size_t Harmonic_Group:: Low(const size_t l0, const size_t m0) {
 //--------------------------------------------------------------
-//  X-axis : Read data from the left boundary and send them 
-//           to the node on the left 
+//  The current and the f1 collisions read the harmonics up to 
+//  l = 1, the implicit E field solver those up to l = 3
+//--------------------------------------------------------------
+    size_t l_low(std::min(l0, size_t(Input::List().implicit_E ? 3 : 1))), low(0);
+    for (size_t l(0); l < l_low+1; ++l) low += std::min(l, m0) + 1;
+    return low;
+}
 //--------------------------------------------------------------
 
-    static size_t step_f(Nbc);
-    size_t bufind(0);
-
-    // Fields:   x0 " <--- Left-Bound "
-    for(size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
-        for(size_t e(0); e < Nbc; e++) {
-            msg_bufX[bufind + e] = Y.FLD(i)(Nbc+e);
-        }
-        bufind += step_f;
-    }
+//--------------------------------------------------------------
+int Harmonic_Group:: Owner(const size_t l0, const size_t m0, const size_t id) {
+//--------------------------------------------------------------
+//  Equal shares of the rest in the order of the members
+//--------------------------------------------------------------
+    size_t num(((m0+1)*(2*l0-m0+2))/2), low(Low(l0, m0));
+    if (id < low) return -1;
 
-    MPI_Send(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 1, MPI_COMM_WORLD);
+    int r(size-1);
+    while (r > 0 && low + ((num-low) * r) / size > id) --r;
+    return r;
 }
 //--------------------------------------------------------------
-
+bool Harmonic_Group:: Keeps(const size_t l0, const size_t m0, const size_t id) {
+    int owner(Owner(l0, m0, id));
+    return owner < 0 || owner == rank;
+}
 //--------------------------------------------------------------
-void Node_ImplicitE_Communications_1D::Recv_from_right_X(State1D& Y, int origin) {
+
 //--------------------------------------------------------------
-//  X-axis : Receive data from the node on the right and update
-//           the right guard cells
+//  Every member learns the lists the others hold of its harmonics
+static void tell(const vector< vector<size_t> >& lists, vector< vector<size_t> >& told) {
 //--------------------------------------------------------------
+    int size(Harmonic_Group::Size());
+    MPI_Comm comm(Harmonic_Group::Harmonics());
 
-    static size_t step_f(Nbc);
-    size_t bufind(0);
-    MPI_Status status;
+    vector<int> counts(size), displs(size, 0), told_counts(size), told_displs(size, 0);
+    for (int q(0); q < size; ++q) counts[q] = int(lists[q].size());
+    MPI_Alltoall(&counts[0], 1, MPI_INT, &told_counts[0], 1, MPI_INT, comm);
 
-    // Receive Data
-    MPI_Recv(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 1, MPI_COMM_WORLD, &status);
+    vector<unsigned long> out, in;
+    for (int q(0); q < size; ++q) {
+        displs[q] = int(out.size());
+        out.insert(out.end(), lists[q].begin(), lists[q].end());
+    }
+    for (int q(1); q < size; ++q) told_displs[q] = told_displs[q-1] + told_counts[q-1];
+    out.push_back(0);
+    in.resize(told_displs[size-1] + told_counts[size-1] + 1);
 
-    // Fields:   x0-"Right-Guard <--- "
-    for(size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
-        for(size_t e(0); e < Nbc; e++) {
-            Y.FLD(i)(Y.FLD(i).numx()-Nbc+e) = msg_bufX[bufind + e];
-        }
-        bufind += step_f;
+    MPI_Alltoallv(&out[0], &counts[0], &displs[0], MPI_UNSIGNED_LONG,
+                  &in[0], &told_counts[0], &told_displs[0], MPI_UNSIGNED_LONG, comm);
+
+    told.assign(size, vector<size_t>());
+    for (int q(0); q < size; ++q) {
+        told[q].assign(in.begin() + told_displs[q], in.begin() + told_displs[q] + told_counts[q]);
     }
 }
 //--------------------------------------------------------------
 
+//--------------------------------------------------------------
+//  The exchange of a distribution is set up at its first use. The
+//  terms of a harmonic are read from it and written to the ones 
+//  next to it in l and m
+template<class D>
+static Harmonic_Exchange& exchange(const D& DF) {
+//--------------------------------------------------------------
+    Harmonic key(DF.l0(), DF.m0());
+    map< Harmonic, Harmonic_Exchange >::iterator found(exchanges.find(key));
+    if (found != exchanges.end()) return found->second;
 
-//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-//  Boundary conditions
-//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-//  Mirror conditions on one side
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-
-//*************************************************************************************
-//-------------------------------------------------------------------------------------
-void Node_ImplicitE_Communications_1D::mirror_bound_Xleft(State1D& Y) {
-//-------------------------------------------------------------------------------------
-//  Mirror boundary in the x direction on the left
-//-------------------------------------------------------------------------------------
-
-    size_t Nx(Y.SH(0,0,0).numx());
+    int rank(Harmonic_Group::Rank()), size(Harmonic_Group::Size());
+    size_t l0(DF.l0()), m0(DF.m0());
+    Array2D<int> ind(DF.indx());
 
-    // Mirror the fields
-    for(size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
-        for (size_t c(0); c < Nbc; ++c)
-            Y.FLD(i)(c) = Y.FLD(i)(2*Nbc-c-1);
+    vector<char> read(DF.dim(), 0), written(DF.dim(), 0);
+    const std::set<Harmonic>& mine(evaluated[key]);
+    for (std::set<Harmonic>::const_iterator h(mine.begin()); h != mine.end(); ++h) {
+        read[ind(h->first, h->second)] = 1;
+        for (size_t l(h->first ? h->first-1 : 0); l < std::min(h->first+1, l0)+1; ++l) {
+            for (size_t m(h->second ? h->second-1 : 0); m < std::min(std::min(h->second+1, l), m0)+1; ++m) {
+                written[ind(l,m)] = 1;
+            }
+        }
     }
 
-    //Bx
-    for(size_t c(0); c < Nbc; ++c) {
-        Y.EMF().Bx()(c) *= -1.0; // left  boundary
+    Harmonic_Exchange& x(exchanges[key]);
+    x.reads.resize(size);
+    x.writes.resize(size);
+    for (size_t id(0); id < DF.dim(); ++id) {
+        int owner(Harmonic_Group::Owner(l0, m0, id));
+        if (owner < 0 || owner == rank) continue;
+        if (read[id])    x.reads[owner].push_back(id);
+        if (written[id]) x.writes[owner].push_back(id);
     }
+    tell(x.reads,  x.serves);
+    tell(x.writes, x.takes);
 
+    return x;
 }
-//-------------------------------------------------------------------------------------
-
 //--------------------------------------------------------------
-void Node_ImplicitE_Communications_1D::mirror_bound_Xright(State1D& Y) {
+
 //--------------------------------------------------------------
-//  Mirror boundary in the x direction on the right
+//  Sends the harmonics of out[q] to member q and receives the 
+//  harmonics of in[q] from it, one message each way
+static void trade(const Harmonic_Lists& out, const Harmonic_Lists& in, 
+                  vector< vector<complex<double> > >& received, const int tag) {
 //--------------------------------------------------------------
+    int size(Harmonic_Group::Size());
+    MPI_Comm comm(Harmonic_Group::Harmonics());
 
-    size_t Nx(Y.SH(0,0,0).numx());
+    vector< vector<complex<double> > > sent(size);
+    vector<MPI_Request> requests;
+    received.assign(size, vector<complex<double> >());
 
-    // Mirror the fields
-    for(size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
-        for (size_t c(0); c < Nbc; ++c)
-            Y.FLD(i)(Nx-c-1) = Y.FLD(i)(Nx-2*Nbc+c);
+    for (int q(0); q < size; ++q) {
+        if (in[q].empty()) continue;
+        size_t count(0);
+        for (size_t k(0); k < in[q].size(); ++k) count += in[q][k]->size();
+        received[q].resize(count);
+        requests.push_back(MPI_REQUEST_NULL);
+        MPI_Irecv(&received[q][0], int(count), MPI_DOUBLE_COMPLEX, q, tag, comm, &requests.back());
     }
-
-    //Bx
-    for(size_t c(0); c < Nbc; ++c) {
-        Y.EMF().Bx()(Nx-1-c) *= -1.0; // right  boundary
+    for (int q(0); q < size; ++q) {
+        if (out[q].empty()) continue;
+        for (size_t k(0); k < out[q].size(); ++k) {
+            sent[q].insert(sent[q].end(), &(*out[q][k])[0], &(*out[q][k])[0] + out[q][k]->size());
+        }
+        requests.push_back(MPI_REQUEST_NULL);
+        MPI_Isend(&sent[q][0], int(sent[q].size()), MPI_DOUBLE_COMPLEX, q, tag, comm, &requests.back());
     }
-
+    if (!requests.empty()) MPI_Waitall(int(requests.size()), &requests[0], MPI_STATUSES_IGNORE);
 }
 //--------------------------------------------------------------
 
-
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-//  Boundary conditions on both sides of a node
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-
 //--------------------------------------------------------------
-void Node_ImplicitE_Communications_1D::sameNode_bound_X(State1D& Y) {
+template<class T>
+static valarray<complex<double> >* harmonic(const T& Y, const size_t s, const size_t id) {
+    return &((Y.DF(s))(id).array().array());
+}
 //--------------------------------------------------------------
-//  Choose between boundary conditions in the x direction
+
 //--------------------------------------------------------------
-    switch (BNDX()) {
-        case 0:                   // periodic
-            sameNode_periodic_X(Y);
+//  The species with l0 = 1 are evaluated whole by every member
+template<class T>
+static void refresh(const T& Y) {
+//--------------------------------------------------------------
+    int size(Harmonic_Group::Size());
+    if (size == 1) return;
 
-            break;
-        case 1:                   // mirror boundary
-            sameNode_mirror_X(Y);
-            break;
-        default:
-            cout<<"Not a valid boundary condition." << endl;
-            break;
+    Harmonic_Lists out(size), in(size);
+    for (size_t s(0); s < Y.Species(); ++s) {
+        if (Y.DF(s).l0() == 1) continue;
+        Harmonic_Exchange& x(exchange(Y.DF(s)));
+        for (int q(0); q < size; ++q) {
+            for (size_t k(0); k < x.serves[q].size(); ++k) out[q].push_back(harmonic(Y, s, x.serves[q][k]));
+            for (size_t k(0); k < x.reads[q].size();  ++k) in[q].push_back(harmonic(Y, s, x.reads[q][k]));
+        }
+    }
+
+    vector< vector<complex<double> > > received;
+    trade(out, in, received, 0);
+
+    for (int q(0); q < size; ++q) {
+        const complex<double>* b(in[q].empty() ? 0 : &received[q][0]);
+        for (size_t k(0); k < in[q].size(); ++k) {
+            std::copy(b, b + in[q][k]->size(), &(*in[q][k])[0]);
+            b += in[q][k]->size();
+        }
     }
 }
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-void Node_ImplicitE_Communications_1D::sameNode_periodic_X(State1D& Y) {
-//--------------------------------------------------------------
-//  Periodic boundary in the x direction for 1 node
+//  The terms of the leading harmonics are summed in the order of
+//  the members, so that the members keep bitwise equal copies
+template<class T>
+static void fold(T& Yslope) {
 //--------------------------------------------------------------
+    int size(Harmonic_Group::Size());
+    if (size == 1) return;
+    MPI_Comm comm(Harmonic_Group::Harmonics());
 
-    // Fields:   x0 "Right-Bound ---> Left-Guard"
-    for(size_t i(3); i < Y.EMF().dim(); ++i) // "3" as opposed to "0"
-        for(size_t c(0); c < Nbc; c++) {
-            Y.FLD(i)(c) = Y.FLD(i)(Y.EMF().Ex().numx()-2*Nbc+c);
+    vector<valarray<complex<double> >*> low;
+    Harmonic_Lists out(size), in(size);
+    for (size_t s(0); s < Yslope.Species(); ++s) {
+        if (Yslope.DF(s).l0() == 1) continue;
+        for (size_t id(0); id < Harmonic_Group::Low(Yslope.DF(s).l0(), Yslope.DF(s).m0()); ++id) {
+            low.push_back(harmonic(Yslope, s, id));
+        }
+        Harmonic_Exchange& x(exchange(Yslope.DF(s)));
+        for (int q(0); q < size; ++q) {
+            for (size_t k(0); k < x.writes[q].size(); ++k) out[q].push_back(harmonic(Yslope, s, x.writes[q][k]));
+            for (size_t k(0); k < x.takes[q].size();  ++k) in[q].push_back(harmonic(Yslope, s, x.takes[q][k]));
         }
+    }
+    if (low.empty()) return;
 
-    // Fields:   x0 "Left-Bound ---> Right-Guard"
-    for(size_t i(3); i < Y.EMF().dim(); ++i) // "3" as opposed to "0"
-        for(size_t c(0); c < Nbc; c++) {
-            Y.FLD(i)(Y.EMF().Ex().numx()-Nbc+c) = Y.FLD(i)(Nbc+c);
+//  The leading harmonics
+    size_t count(0);
+    for (size_t k(0); k < low.size(); ++k) count += low[k]->size();
+
+    vector<complex<double> > mine(count), all(count * size);
+    complex<double>* b(&mine[0]);
+    for (size_t k(0); k < low.size(); ++k) b = std::copy(&(*low[k])[0], &(*low[k])[0] + low[k]->size(), b);
+
+    MPI_Allgather(&mine[0], int(count), MPI_DOUBLE_COMPLEX, &all[0], int(count), MPI_DOUBLE_COMPLEX, comm);
+
+    for (size_t i(0); i < count; ++i) {
+        for (int r(1); r < size; ++r) all[i] += all[r * count + i];
+    }
+    b = &all[0];
+    for (size_t k(0); k < low.size(); ++k) {
+        std::copy(b, b + low[k]->size(), &(*low[k])[0]);
+        b += low[k]->size();
+    }
+
+//  The terms written to the harmonics of the others
+    vector< vector<complex<double> > > received;
+    trade(out, in, received, 1);
+
+    for (int q(0); q < size; ++q) {
+        const complex<double>* t(in[q].empty() ? 0 : &received[q][0]);
+        for (size_t k(0); k < in[q].size(); ++k) {
+            valarray<complex<double> >& h(*in[q][k]);
+            for (size_t i(0); i < h.size(); ++i) h[i] += t[i];
+            t += h.size();
         }
+    }
 
+    for (size_t s(0); s < Yslope.Species(); ++s) {
+        if (Yslope.DF(s).l0() == 1) continue;
+        for (size_t id(0); id < Yslope.DF(s).dim(); ++id) {
+            if (!Harmonic_Group::Keeps(Yslope.DF(s).l0(), Yslope.DF(s).m0(), id)) *harmonic(Yslope, s, id) = 0.0;
+        }
+    }
 }
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-void Node_ImplicitE_Communications_1D::sameNode_mirror_X(State1D& Y) {
-//--------------------------------------------------------------
-//  Mirror boundary in the x direction for 1 node
+template<class T>
+static void collect(T& Y) {
 //--------------------------------------------------------------
+    int rank(Harmonic_Group::Rank()), size(Harmonic_Group::Size());
+    if (size == 1) return;
 
-    size_t Nx(Y.SH(0,0,0).numx());
-
-    // Mirror the fields
-    for(size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
-        // right boundary
-        for (size_t c(0); c < Nbc; ++c)
-            Y.FLD(i)(Nx-c-1) = Y.FLD(i)(Nx-2*Nbc+c);
-        // left boundary
-        for (size_t c(0); c < Nbc; ++c)
-            Y.FLD(i)(c) = Y.FLD(i)(2*Nbc-c-1);
+    Harmonic_Lists out(size), in(size);
+    for (size_t s(0); s < Y.Species(); ++s) {
+        if (Y.DF(s).l0() == 1) continue;
+        for (size_t id(0); id < Y.DF(s).dim(); ++id) {
+            int owner(Harmonic_Group::Owner(Y.DF(s).l0(), Y.DF(s).m0(), id));
+            if (owner < 1) continue;
+            if (rank == 0)          in[owner].push_back(harmonic(Y, s, id));
+            else if (owner == rank) out[0].push_back(harmonic(Y, s, id));
+        }
     }
 
-    //Bx
-    for (size_t c(0); c < Nbc; ++c) {
-        Y.EMF().Bx()(c) *= -1.0; // left  boundary
-        Y.EMF().Bx()(Nx-Nbc+c) *= -1.0; // right  boundary
-    }
+    vector< vector<complex<double> > > received;
+    trade(out, in, received, 2);
 
+    for (int q(1); q < size; ++q) {
+        const complex<double>* b(in[q].empty() ? 0 : &received[q][0]);
+        for (size_t k(0); k < in[q].size(); ++k) {
+            std::copy(b, b + in[q][k]->size(), &(*in[q][k])[0]);
+            b += in[q][k]->size();
+        }
+    }
 }
 //--------------------------------------------------------------
 
+//--------------------------------------------------------------
+void Harmonic_Group:: Refresh(const State1D& Y) {refresh(Y);}
+void Harmonic_Group:: Refresh(const State2D& Y) {refresh(Y);}
+void Harmonic_Group:: Fold(State1D& Yslope)     {fold(Yslope);}
+void Harmonic_Group:: Fold(State2D& Yslope)     {fold(Yslope);}
+void Harmonic_Group:: Collect(State1D& Y)       {collect(Y);}
+void Harmonic_Group:: Collect(State2D& Y)       {collect(Y);}
+//--------------------------------------------------------------
+
 
 //**************************************************************
 //**************************************************************
-//  Definition of the Nodes Communications class
+//  Halos in shared memory between the nodes of one host
 //**************************************************************
 //**************************************************************
 
-
-//**************************************************************
 //--------------------------------------------------------------
-Node_Communications_1D:: Node_Communications_1D() :
+Shared_Halos:: Shared_Halos(MPI_Comm comm, int _num_slots) :
 //--------------------------------------------------------------
 //  Constructor
 //--------------------------------------------------------------
-        Nbc(Input::List().BoundaryCells),      // # of boundary cells
-        bndX(Input::List().bndX) {        // Type of boundary in X
+        comm_host(MPI_COMM_NULL), num_slots(_num_slots), parity(0),
+        slot_bytes(0), window(MPI_WIN_NULL) {
 
-    numspec = Input::List().ls.size();
-    // numpmax = Input::List().ps;
+    int size;
+    MPI_Comm_size(comm, &size);
+    host_rank.assign(size, -1);
 
-    double temp;
+    if (!Input::List().mpi_shared_halos) return;
 
-    // # of harmonics
-    msg_sizeX = 0; temp = 0;
-    for(size_t s(0); s < numspec; ++s) {
-        temp = ((Input::List().ms[s]+1)*(2*Input::List().ls[s]-Input::List().ms[s]+2))/2;
-        msg_sizeX += temp*(Input::List().dp[s]).size();
-    }
-    // (# of harmonics) * (# cells in p)
-    // msg_sizeX *= numpmax
-    // 6 fields: Ex, Ey, Ez, Bx, By, Bz
-    msg_sizeX += 6;
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &comm_host);
 
-    // 6 Hydro Quantities, density, vx, vy, vz, temp, Z
-    if (Input::List().hydromotion)
-    {
-        msg_sizeX += 6;
+    int host_size;
+    MPI_Comm_size(comm_host, &host_size);
+    if (host_size == 1) {
+        MPI_Comm_free(&comm_host);
+        return;
     }
 
-    msg_sizeX *= Nbc;  //(IN().inp().y.dim()*Nbc);
-                       //
-    if (Input::List().particlepusher)
-    {
-        msg_sizeX += Input::List().numparticles; // Going Left or Right?
-        msg_sizeX += Input::List().numparticles; // Position
-        msg_sizeX += Input::List().numparticles; // X-momentum
-        msg_sizeX += Input::List().numparticles; // Y-momentum
-        msg_sizeX += Input::List().numparticles; // Z-momentum
+    // Ranks of the nodes of comm on this host
+    MPI_Group group, group_host;
+    MPI_Comm_group(comm, &group);
+    MPI_Comm_group(comm_host, &group_host);
+
+    vector<int> ranks(size);
+    for (int i(0); i < size; ++i) ranks[i] = i;
+    MPI_Group_translate_ranks(group, size, &ranks[0], group_host, &host_rank[0]);
+    for (int i(0); i < size; ++i) {
+        if (host_rank[i] == MPI_UNDEFINED) host_rank[i] = -1;
     }
-    
-    msg_bufX = new complex<double>[msg_sizeX];
 
+    MPI_Group_free(&group);
+    MPI_Group_free(&group_host);
 }
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-Node_Communications_1D:: ~Node_Communications_1D(){
+Shared_Halos:: ~Shared_Halos() {
 //--------------------------------------------------------------
 //  Destructor
 //--------------------------------------------------------------
-    delete[] msg_bufX;
+    int finalized;
+    MPI_Finalized(&finalized);
+    if (!finalized) {
+        Clear();
+        if (window != MPI_WIN_NULL) {
+            MPI_Win_unlock_all(window);
+            MPI_Win_free(&window);
+        }
+        if (comm_host != MPI_COMM_NULL) MPI_Comm_free(&comm_host);
+    }
 }
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-int Node_Communications_1D:: BNDX()  const {return bndX;}
+bool Shared_Halos:: Shared(int nb) const {return (host_rank[nb] > -1);}
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
+void Shared_Halos:: Send(MPI_Datatype halo, int nb, int slot) {
+//--------------------------------------------------------------
+//  The empty message tells nb that the slot is filled
+//--------------------------------------------------------------
+    send_blocks.push_back(vector<Block>());
+    Blocks(halo, 0, send_blocks.back());
+    send_slot.push_back(slot);
 
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-//  Send and receive in the X direction
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+    notify.push_back(MPI_REQUEST_NULL);
+    MPI_Send_init(NULL, 0, MPI_BYTE, host_rank[nb], slot, comm_host, &notify.back());
+}
+//--------------------------------------------------------------
 
 //--------------------------------------------------------------
-void Node_Communications_1D::Send_right_X(State1D& Y, int dest) {
+void Shared_Halos:: Recv(MPI_Datatype halo, int nb, int slot) {
 //--------------------------------------------------------------
-//  X-axis : Read data from the right boundary and send them 
-//           to the node on the right
+    recv_blocks.push_back(vector<Block>());
+    Blocks(halo, 0, recv_blocks.back());
+    recv_host.push_back(host_rank[nb]);
+    recv_slot.push_back(slot);
+
+    notify.push_back(MPI_REQUEST_NULL);
+    MPI_Recv_init(NULL, 0, MPI_BYTE, host_rank[nb], slot, comm_host, &notify.back());
+}
 //--------------------------------------------------------------
 
-    // static size_t step_h(numpmax*Nbc);
-    static size_t step_f(Nbc);
-    size_t bufind(0);
+//--------------------------------------------------------------
+void Shared_Halos:: Clear() {
+//--------------------------------------------------------------
+//  Release the requests, the window is kept
+//--------------------------------------------------------------
+    for (size_t i(0); i < notify.size(); ++i) MPI_Request_free(&notify[i]);
+    notify.clear();
+    send_blocks.clear(); send_slot.clear();
+    recv_blocks.clear(); recv_host.clear(); recv_slot.clear();
+}
+//--------------------------------------------------------------
 
-    // Harmonics:x0 "Right-Bound ---> "
-    for(size_t s(0); s < Y.Species(); ++s) {
-        for(size_t i = 0; i < Y.DF(s).dim(); ++i){
-            for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                for(size_t e(0); e < Nbc; e++) {
-                    msg_bufX[bufind + e] = (Y.DF(s)(i))(p, Y.FLD(0).numx()-2*Nbc+e);
-                }
-                bufind += step_f;
-            }
-        }
-    }
-    // Fields:   x0 "Right-Bound --> "
-    for(size_t i = 0; i < Y.EMF().dim(); ++i){
-        for(size_t e(0); e < Nbc; e++) {
-            msg_bufX[bufind + e] = Y.FLD(i)(Y.FLD(0).numx()-2*Nbc+e);
-        }
-        bufind += step_f;
+//--------------------------------------------------------------
+void Shared_Halos:: Blocks(MPI_Datatype type, MPI_Aint displ, vector<Block>& blocks) {
+//--------------------------------------------------------------
+//  Flatten the halo datatypes of the nodes, structs at absolute 
+//  addresses of contiguous or strided blocks of a predefined type
+//--------------------------------------------------------------
+    int num_ints, num_addresses, num_types, combiner;
+    MPI_Type_get_envelope(type, &num_ints, &num_addresses, &num_types, &combiner);
+
+    if (combiner == MPI_COMBINER_NAMED) {
+        int bytes;
+        MPI_Type_size(type, &bytes);
+        blocks.push_back(Block());
+        blocks.back().address = static_cast<char*>(MPI_BOTTOM) + displ;
+        blocks.back().bytes   = size_t(bytes);
+        return;
     }
 
-    if (Input::List().hydromotion)
-    {
-        // Hydro-velocity:   x0 "Right-Bound --> "
-        for(size_t e(0); e < Nbc; e++) {
-            msg_bufX[bufind + e] = Y.HYDRO().density(Y.FLD(0).numx()-2*Nbc+e);
-        }
-        bufind += step_f;
-        // Hydro-velocity:   x0 "Right-Bound --> "
-        for(size_t e(0); e < Nbc; e++) {
-            msg_bufX[bufind + e] = Y.HYDRO().vx(Y.FLD(0).numx()-2*Nbc+e);
-        }
-        bufind += step_f;
+    vector<int>          ints(num_ints);
+    vector<MPI_Aint>     addresses(max(num_addresses, 1));
+    vector<MPI_Datatype> types(num_types);
+    MPI_Type_get_contents(type, num_ints, num_addresses, num_types, 
+                          &ints[0], &addresses[0], &types[0]);
 
-        for(size_t e(0); e < Nbc; e++) {
-            msg_bufX[bufind + e] = Y.HYDRO().vy(Y.FLD(0).numx()-2*Nbc+e);
+    MPI_Aint lb, extent;
+    if (combiner == MPI_COMBINER_STRUCT) {
+        for (int b(0); b < ints[0]; ++b) {
+            MPI_Type_get_extent(types[b], &lb, &extent);
+            for (int k(0); k < ints[b+1]; ++k) Blocks(types[b], displ + addresses[b] + k*extent, blocks);
         }
-        bufind += step_f;
-
-        for(size_t e(0); e < Nbc; e++) {
-            msg_bufX[bufind + e] = Y.HYDRO().vz(Y.FLD(0).numx()-2*Nbc+e);
+    }
+    else if (combiner == MPI_COMBINER_VECTOR) {
+        MPI_Type_get_extent(types[0], &lb, &extent);
+        for (int c(0); c < ints[0]; ++c) {
+            for (int k(0); k < ints[1]; ++k) Blocks(types[0], displ + (MPI_Aint(c)*ints[2] + k)*extent, blocks);
         }
-        bufind += step_f;
+    }
+    else {
+        std::cout << "Shared halos: unexpected datatype combiner " << combiner << "\n";
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
 
-        // Hydro-temperature:   x0 "Right-Bound --> "
-        for(size_t e(0); e < Nbc; e++) {
-            msg_bufX[bufind + e] = Y.HYDRO().temperature(Y.FLD(0).numx()-2*Nbc+e);
-        }
-        bufind += step_f;
+    for (size_t t(0); t < types.size(); ++t) {
+        MPI_Type_get_envelope(types[t], &num_ints, &num_addresses, &num_types, &combiner);
+        if (combiner != MPI_COMBINER_NAMED) MPI_Type_free(&types[t]);
+    }
 
-        // Hydro-chargefraction:   x0 "Right-Bound --> "
-        for(size_t e(0); e < Nbc; e++) {
-            msg_bufX[bufind + e] = Y.HYDRO().Z(Y.FLD(0).numx()-2*Nbc+e);
-        }
-        bufind += step_f;
+    // Neighboring values of a predefined type are one block
+    size_t merged(0);
+    for (size_t b(1); b < blocks.size(); ++b) {
+        if (blocks[merged].address + blocks[merged].bytes == blocks[b].address) blocks[merged].bytes += blocks[b].bytes;
+        else blocks[++merged] = blocks[b];
     }
+    if (!blocks.empty()) blocks.resize(merged + 1);
+}
+//--------------------------------------------------------------
 
-    if (Input::List().particlepusher)
-    {
-        for (int ip(0); ip < Y.particles().numpar(); ++ip)
-        {          
-            // if (Y.particles().x(ip) > Input::List().xmaxGlobal[0]){
-            //     std::cout << " global max = " << Input::List().xmaxGlobal[0] << "\n";
-            //     Y.particles().x(ip) -= Input::List().xmaxGlobal[0]-Input::List().xminGlobal[0];
-            // }
-            // if (Y.particles().goingright(ip) == 1)
-            // {
-                msg_bufX[bufind]   = Y.particles().goingright(ip);
-                msg_bufX[bufind+1] = Y.particles().x(ip);
-                msg_bufX[bufind+2] = Y.particles().px(ip);
-                msg_bufX[bufind+3] = Y.particles().py(ip);
-                msg_bufX[bufind+4] = Y.particles().pz(ip);    
-
-                // Y.particles().goingright(ip) = 0;
-            // }
-            
+//--------------------------------------------------------------
+void Shared_Halos:: Allocate() {
+//--------------------------------------------------------------
+//  Every node of the host holds two sets of num_slots slots, all
+//  of them as large as the largest halo on the host. A node fills
+//  one set while its neighbors may still read the other, by the
+//  time it returns to a set the neighbors have sent the messages
+//  of the exchange after the one that read it
+//--------------------------------------------------------------
+    if (comm_host == MPI_COMM_NULL) return;
 
-            bufind += 4;
-        }
+    unsigned long bytes(0), halo_bytes;
+    for (size_t i(0); i < send_blocks.size(); ++i) {
+        halo_bytes = 0;
+        for (size_t b(0); b < send_blocks[i].size(); ++b) halo_bytes += send_blocks[i][b].bytes;
+        bytes = max(bytes, halo_bytes);
     }
+    MPI_Allreduce(&bytes, &halo_bytes, 1, MPI_UNSIGNED_LONG, MPI_MAX, comm_host);
 
-        
-    MPI_Send(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 0, MPI_COMM_WORLD);
-
+    if (window != MPI_WIN_NULL) {
+        MPI_Win_unlock_all(window);
+        MPI_Win_free(&window);
+    }
+    slot_bytes = halo_bytes;
+    parity     = 0;
+    if (slot_bytes == 0) return;
 
+    char* base;
+    MPI_Win_allocate_shared(2*num_slots*slot_bytes, 1, MPI_INFO_NULL, comm_host, &base, &window);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, window);
 }
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-void Node_Communications_1D::Recv_from_left_X(State1D& Y, int origin) {
+char* Shared_Halos:: Slot(int host, int slot, int set) {
 //--------------------------------------------------------------
-//  X-axis : Receive data from the node on the left and update
-//           the left guard cells
-//--------------------------------------------------------------
-
-    // static size_t step_h(Y.SH(s,0,0).nump()*Nbc);
-    static size_t step_f(Nbc);
-    size_t bufind(0);
-    
-    MPI_Status status;
+    MPI_Aint size;
+    int      disp_unit;
+    char*    base;
+    MPI_Win_shared_query(window, host, &size, &disp_unit, &base);
 
-    // Receive Data
-    MPI_Recv(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 0, MPI_COMM_WORLD, &status);
+    return base + (set*num_slots + slot) * slot_bytes;
+}
+//--------------------------------------------------------------
 
-    // Harmonics:x0-"---> Left-Guard"
-    for(size_t s(0); s < Y.Species(); ++s) {
-        for(size_t i(0); i < Y.DF(s).dim(); ++i){
-            for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                for(size_t e(0); e < Nbc; e++) {
-                    (Y.DF(s)(i))(p, e) = msg_bufX[bufind + e];
-                }
-                bufind += step_f;
-            }
-        }
-    }
+//--------------------------------------------------------------
+void Shared_Halos:: Pack() {
+//--------------------------------------------------------------
+//  Copy the edge planes into the slots of this node and tell the
+//  neighbors
+//--------------------------------------------------------------
+    if (notify.empty()) return;
 
+    int me;
+    MPI_Comm_rank(comm_host, &me);
 
-    // Fields:   x0-"---> Left-Guard"
-    for(size_t i(0); i < Y.EMF().dim(); ++i){
-        for(size_t e(0); e < Nbc; e++) {
-            Y.FLD(i)(e) = msg_bufX[bufind + e];
+    for (size_t i(0); i < send_blocks.size(); ++i) {
+        char* plane(Slot(me, send_slot[i], parity));
+        for (size_t b(0); b < send_blocks[i].size(); ++b) {
+            memcpy(plane, send_blocks[i][b].address, send_blocks[i][b].bytes);
+            plane += send_blocks[i][b].bytes;
         }
-        bufind += step_f;
     }
+    MPI_Win_sync(window);
 
-    if (Input::List().hydromotion)
-    {
-        // Hydro-velocity:   x0-"---> Left-Guard"
-        for(size_t e(0); e < Nbc; e++) {
-            Y.HYDRO().density(e) = (msg_bufX[bufind + e]).real();
-        }
-        bufind += step_f;
-
-        // Hydro-velocity:   x0-"---> Left-Guard"
-        for(size_t e(0); e < Nbc; e++) {
-            Y.HYDRO().vx(e) = (msg_bufX[bufind + e]).real();
-        }
-        bufind += step_f;
-
-        // Hydro-velocity:   x0-"---> Left-Guard"
-        for(size_t e(0); e < Nbc; e++) {
-            Y.HYDRO().vy(e) = (msg_bufX[bufind + e]).real();
-        }
-        bufind += step_f;
+    MPI_Startall(notify.size(), &notify[0]);
+}
+//--------------------------------------------------------------
 
-        // Hydro-velocity:   x0-"---> Left-Guard"
-        for(size_t e(0); e < Nbc; e++) {
-            Y.HYDRO().vz(e) = (msg_bufX[bufind + e]).real();
-        }
-        bufind += step_f;
+//--------------------------------------------------------------
+void Shared_Halos:: Unpack() {
+//--------------------------------------------------------------
+//  Wait for the neighbors and copy the guard cells straight out
+//  of their slots
+//--------------------------------------------------------------
+    if (notify.empty()) return;
 
-        // Hydro-temperature:   x0-"---> Left-Guard"
-        for(size_t e(0); e < Nbc; e++) {
-            Y.HYDRO().temperature(e) = (msg_bufX[bufind + e]).real();
-        }
-        bufind += step_f;
+    MPI_Waitall(notify.size(), &notify[0], MPI_STATUSES_IGNORE);
+    MPI_Win_sync(window);
 
-        // Hydro-charge fraction:   x0-"---> Left-Guard"
-        for(size_t e(0); e < Nbc; e++) {
-            Y.HYDRO().Z(e) = (msg_bufX[bufind + e]).real();
+    for (size_t i(0); i < recv_blocks.size(); ++i) {
+        const char* plane(Slot(recv_host[i], recv_slot[i], parity));
+        for (size_t b(0); b < recv_blocks[i].size(); ++b) {
+            memcpy(recv_blocks[i][b].address, plane, recv_blocks[i][b].bytes);
+            plane += recv_blocks[i][b].bytes;
         }
-        bufind += step_f;
     }
+    parity = 1 - parity;
+}
+//--------------------------------------------------------------
 
 
-    if (Input::List().particlepusher)
-    {   
-        
-        // if (Input::List().xminLocalnobnd[0] == 0.0)
-        // {
-        //     std::cout << "\n is here = " << Y.particles().ishere(2) << "\n";
-        // }
-
-        for (int ip(0); ip < Y.particles().numpar(); ++ip){
-            
+//**************************************************************
+//**************************************************************
+//  Definition of the Nodes Communications class
+//**************************************************************
+//**************************************************************
 
 
-            // See if particle is now in local box, but wasn't before. 
-            // Only overwrite if so.
-            // If not, step over buffer and go to next particle.
-            
-            // if (((msg_bufX[bufind]).real() < Input::List().xmaxLocalnobnd[0] && (msg_bufX[bufind]).real() >= Input::List().xminLocalnobnd[0])
-            //     // && (Y.particles().x(ip) >= Input::List().xmaxLocal || Y.particles().x(ip) < Input::List().xminLocal[0]))
-            //     && !(Y.particles().ishere(ip)) && (Y.particles().goingleft(ip)))
-            //     
-            if (int (msg_bufX[bufind].real()) == 1)
-            {
-                
-                // if (ip == 2){
-                // std::cout << "\n\n\n origin = " << origin << "\n";
-                // std::cout << "in cell = " << Input::List().xminLocalnobnd[0] << "\n" ;
-                // std::cout << "is it here? "<< Y.particles().ishere(ip) << "\n\n";  
+//**************************************************************
+//--------------------------------------------------------------
+Node_ImplicitE_Communications_1D:: Node_ImplicitE_Communications_1D() :
+//--------------------------------------------------------------
+//  Constructor
+//--------------------------------------------------------------
+        Nbc(Input::List().BoundaryCells),      // # of boundary cells
+        bndX(Input::List().bndX) {        // Type of boundary in X
 
-                if (msg_bufX[bufind+1].real() >= Input::List().xmaxGlobal[0]){
-                    Y.particles().x(ip) = (msg_bufX[bufind+1]).real() - Input::List().xmaxGlobal[0] + Input::List().xminGlobal[0];
-                }
-                else Y.particles().x(ip)  = (msg_bufX[bufind+1]).real();
+    // 3 components for Bx, By, Bz
+    msg_sizeX = 3;
 
+    msg_sizeX *= Nbc; //(IN().inp().y.dim()*Nbc);
+    msg_bufX = new complex<double>[msg_sizeX];
 
-                Y.particles().px(ip) = (msg_bufX[bufind+2]).real();
-                Y.particles().py(ip) = (msg_bufX[bufind+3]).real();
-                Y.particles().pz(ip) = (msg_bufX[bufind+4]).real();
-                Y.particles().ishere(ip) = 1;
-            }
-            
-            bufind+=4;  // Go to next particle in buffer
-        }
-    }
+}
+//--------------------------------------------------------------
 
+//--------------------------------------------------------------
+Node_ImplicitE_Communications_1D:: ~Node_ImplicitE_Communications_1D(){
+//--------------------------------------------------------------
+//  Destructor
+//--------------------------------------------------------------
+    delete[] msg_bufX;
+}
+//--------------------------------------------------------------
 
+//--------------------------------------------------------------
+int Node_ImplicitE_Communications_1D:: BNDX()  const {return bndX;}
+//--------------------------------------------------------------
 
-}
 //--------------------------------------------------------------
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+//  Send and receive in the X direction
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
 //--------------------------------------------------------------
-void Node_Communications_1D::Send_left_X(State1D& Y, int dest) {
+void Node_ImplicitE_Communications_1D::Send_right_X(State1D& Y, int dest) {
 //--------------------------------------------------------------
-//  X-axis : Read data from the left boundary and send them 
-//           to the node on the left 
+//  X-axis : Read data from the right boundary and send them 
+//           to the node on the right
 //--------------------------------------------------------------
 
-    // static size_t step_h(Y.SH(s,0,0).nump()*Nbc);
     static size_t step_f(Nbc);
     size_t bufind(0);
 
-    // Harmonics:x0 " <--- Left-Bound "
-    for(size_t s(0); s < Y.Species(); ++s) {
-        for(size_t i(0); i < Y.DF(s).dim(); ++i){
-            for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                for(size_t e(0); e < Nbc; e++) {
-                    msg_bufX[bufind + e] = (Y.DF(s)(i))(p, Nbc+e);
-                }
-                bufind += step_f;
-            }
-        }
-    }
-    // Fields:   x0 " <--- Left-Bound "
-    for(size_t i(0); i < Y.EMF().dim(); ++i){
+    // Fields:   x0 "Right-Bound --> "
+    for(size_t i(3); i < Y.EMF().dim(); ++i){  // "3" as opposed to "0"
         for(size_t e(0); e < Nbc; e++) {
-            msg_bufX[bufind + e] = Y.FLD(i)(Nbc+e);
+            msg_bufX[bufind + e] = Y.FLD(i)(Y.FLD(i).numx()-2*Nbc+e);
         }
         bufind += step_f;
     }
 
-    if (Input::List().hydromotion)
-    {
-        // Hydro-velocity:   x0 " <--- Left-Bound "
-        for(size_t e(0); e < Nbc; e++) {
-            msg_bufX[bufind + e] = Y.HYDRO().density(Nbc+e);
-        }
-        bufind += step_f;
-        // Hydro-velocity:   x0 " <--- Left-Bound "
-        for(size_t e(0); e < Nbc; e++) {
-            msg_bufX[bufind + e] = Y.HYDRO().vx(Nbc+e);
-        }
-        bufind += step_f;
+    MPI_Send(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 0, Harmonic_Group::Space());
+}
+//--------------------------------------------------------------
 
-        // Hydro-velocity:   x0 " <--- Left-Bound "
-        for(size_t e(0); e < Nbc; e++) {
-            msg_bufX[bufind + e] = Y.HYDRO().vy(Nbc+e);
-        }
-        bufind += step_f;
+//--------------------------------------------------------------
+void Node_ImplicitE_Communications_1D::Recv_from_left_X(State1D& Y, int origin) {
+//--------------------------------------------------------------
+//  X-axis : Receive data from the node on the left and update
+//           the left guard cells
+//--------------------------------------------------------------
 
-        // Hydro-velocity:   x0 " <--- Left-Bound "
-        for(size_t e(0); e < Nbc; e++) {
-            msg_bufX[bufind + e] = Y.HYDRO().vz(Nbc+e);
-        }
-        bufind += step_f;
+    static size_t step_f(Nbc);
+    size_t bufind(0);
+    MPI_Status status;
 
-        // Hydro-temperature:   x0 " <--- Left-Bound "
-        for(size_t e(0); e < Nbc; e++) {
-            msg_bufX[bufind + e] = Y.HYDRO().temperature(Nbc+e);
-        }
-        bufind += step_f;
+    // Receive Data
+    MPI_Recv(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 0, Harmonic_Group::Space(), &status);
 
-        // Hydro-charge-fraction:   x0 " <--- Left-Bound "
+    // Fields:   x0-"---> Left-Guard"
+    for(size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
         for(size_t e(0); e < Nbc; e++) {
-            msg_bufX[bufind + e] = Y.HYDRO().Z(Nbc+e);
+            Y.FLD(i)(e) = msg_bufX[bufind + e];
         }
         bufind += step_f;
     }
+}
+//--------------------------------------------------------------
 
-    
-
-    if (Input::List().particlepusher)
-    {   
-
-        // Send all
-        // Receive routine is the discriminator
-        for (int ip(0); ip < Y.particles().numpar(); ++ip)
-        {          
-            // if (Y.particles().goingright(ip) == -1){
-            //     Y.particles().x(ip) += Input::List().xmaxGlobal[0]-Input::List().xminGlobal[0];
+//--------------------------------------------------------------
+void Node_ImplicitE_Communications_1D::Send_left_X(State1D& Y, int dest) {
+//--------------------------------------------------------------
+//  X-axis : Read data from the left boundary and send them 
+//           to the node on the left 
+//--------------------------------------------------------------
 
-            msg_bufX[bufind] = Y.particles().goingright(ip);
-            msg_bufX[bufind+1] = Y.particles().x(ip);
-            msg_bufX[bufind+2] = Y.particles().px(ip);
-            msg_bufX[bufind+3] = Y.particles().py(ip);
-            msg_bufX[bufind+4] = Y.particles().pz(ip);
+    static size_t step_f(Nbc);
+    size_t bufind(0);
 
-            bufind += 4;
+    // Fields:   x0 " <--- Left-Bound "
+    for(size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
+        for(size_t e(0); e < Nbc; e++) {
+            msg_bufX[bufind + e] = Y.FLD(i)(Nbc+e);
         }
+        bufind += step_f;
     }
 
-    MPI_Send(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 1, MPI_COMM_WORLD);
+    MPI_Send(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 1, Harmonic_Group::Space());
 }
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-void Node_Communications_1D::Recv_from_right_X(State1D& Y, int origin) {
+void Node_ImplicitE_Communications_1D::Recv_from_right_X(State1D& Y, int origin) {
 //--------------------------------------------------------------
 //  X-axis : Receive data from the node on the right and update
 //           the right guard cells
 //--------------------------------------------------------------
 
-    // static size_t step_h(Y.SH(s,0,0).nump()*Nbc);
     static size_t step_f(Nbc);
     size_t bufind(0);
     MPI_Status status;
 
     // Receive Data
-    MPI_Recv(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 1, MPI_COMM_WORLD, &status);
+    MPI_Recv(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 1, Harmonic_Group::Space(), &status);
 
-    // Harmonics:x0-"Right-Guard <--- "
-    for(size_t s(0); s < Y.Species(); ++s) {
-        for(size_t i(0); i < Y.DF(s).dim(); ++i){
-            for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                for(size_t e(0); e < Nbc; e++) {
-                    (Y.DF(s)(i))(p, Y.FLD(0).numx()-Nbc+e) = msg_bufX[bufind + e];
-                }
-                bufind += step_f;
-            }
-        }
-    }
     // Fields:   x0-"Right-Guard <--- "
-    for(size_t i(0); i < Y.EMF().dim(); ++i){
+    for(size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
         for(size_t e(0); e < Nbc; e++) {
-            Y.FLD(i)(Y.FLD(0).numx()-Nbc+e) = msg_bufX[bufind + e];
+            Y.FLD(i)(Y.FLD(i).numx()-Nbc+e) = msg_bufX[bufind + e];
         }
         bufind += step_f;
     }
+}
+//--------------------------------------------------------------
 
-    if (Input::List().hydromotion)
-    {
-        // Hydro-density:   x0-"Right-Guard <--- "
-        for(size_t e(0); e < Nbc; e++) {
-            Y.HYDRO().density(Y.FLD(0).numx()-Nbc+e) = (msg_bufX[bufind + e]).real();
-        }
-        bufind += step_f;
-
-        // Hydro-velocity:   x0-"Right-Guard <--- "
-        for(size_t e(0); e < Nbc; e++) {
-            Y.HYDRO().vx(Y.FLD(0).numx()-Nbc+e) = (msg_bufX[bufind + e]).real();
-        }
-        bufind += step_f;
 
-        // Hydro-velocity:   x0-"Right-Guard <--- "
-        for(size_t e(0); e < Nbc; e++) {
-            Y.HYDRO().vy(Y.FLD(0).numx()-Nbc+e) = (msg_bufX[bufind + e]).real();
-        }
-        bufind += step_f;
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//  Boundary conditions
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+//  Mirror conditions on one side
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-        // Hydro-velocity:   x0-"Right-Guard <--- "
-        for(size_t e(0); e < Nbc; e++) {
-            Y.HYDRO().vz(Y.FLD(0).numx()-Nbc+e) = (msg_bufX[bufind + e]).real();
-        }
-        bufind += step_f;
-
-        // Hydro-temperature:   x0-"Right-Guard <--- "
-        for(size_t e(0); e < Nbc; e++) {
-            Y.HYDRO().temperature(Y.FLD(0).numx()-Nbc+e) = (msg_bufX[bufind + e]).real();
-        }
-        bufind += step_f;
-
-        // Hydro-charge fraction:   x0-"Right-Guard <--- "
-        for(size_t e(0); e < Nbc; e++) {
-            Y.HYDRO().Z(Y.FLD(0).numx()-Nbc+e) = (msg_bufX[bufind + e]).real();
-        }
-        bufind += step_f;
-    }
-
-
-    
-    if (Input::List().particlepusher)
-    {   
-        for (int ip(0); ip < Y.particles().numpar(); ++ip){
-            
-
-            // See if particle is now in local box, but wasn't before. 
-            // Only overwrite if so.
-            // If not, step over buffer and go to next particle.
-            
-            // if (((msg_bufX[bufind]).real() < Input::List().xmaxLocalnobnd[0] && (msg_bufX[bufind]).real() >= Input::List().xminLocalnobnd[0])
-            //     // && (Y.particles().x(ip) >= Input::List().xmaxLocal || Y.particles().x(ip) < Input::List().xminLocal[0]))
-            //     && !(Y.particles().ishere(ip)))
-            // {
-
-                // if (ip == 2){
-                //     std::cout << "\n\n\n origin = " << origin << "\n";
-                //     std::cout << "in cell = " << Input::List().xminLocalnobnd[0] << "\n" ;
-                //     std::cout << "is it here? "<< Y.particles().ishere(ip) << "\n\n";  
-                // } 
-            if (msg_bufX[bufind].real() == -1)
-            {
-
-                if (msg_bufX[bufind+1].real() < Input::List().xminGlobal[0]){
-                    Y.particles().x(ip) = (msg_bufX[bufind+1]).real() + Input::List().xmaxGlobal[0] - Input::List().xminGlobal[0];
-                }
-                else Y.particles().x(ip)  = (msg_bufX[bufind+1]).real();
-
-                
-                Y.particles().px(ip) = (msg_bufX[bufind+2]).real();
-                Y.particles().py(ip) = (msg_bufX[bufind+3]).real();
-                Y.particles().pz(ip) = (msg_bufX[bufind+4]).real();
-                Y.particles().ishere(ip) = 1;
-            }
-            
-            bufind+=4;  // Go to next particle in buffer
-        }
-    }
-
-}
-//--------------------------------------------------------------
-
-
-//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-//  Boundary conditions
-//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-//  Mirror conditions on one side
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-
-//**************************************************************
-//--------------------------------------------------------------
-void Node_Communications_1D::mirror_bound_Xleft(State1D& Y) {
-//--------------------------------------------------------------
+//*************************************************************************************
+//-------------------------------------------------------------------------------------
+void Node_ImplicitE_Communications_1D::mirror_bound_Xleft(State1D& Y) {
+//-------------------------------------------------------------------------------------
 //  Mirror boundary in the x direction on the left
-//--------------------------------------------------------------
-    int sign(1);
-    size_t Nx(Y.SH(0,0,0).numx());
-
-    // Mirror the harmonics
-    for(size_t s(0); s < Y.Species(); ++s) {
-        for(size_t l(0); l < Y.DF(s).l0(); ++l){
-            for(size_t m(0); m < ((Y.DF(s).m0() < l)? Y.DF(s).m0():l)+1; ++m){
-                sign = 1-2*((l+m)%2);          //(-1)^(m+n)
-
-                for (size_t c(0); c < Nbc; ++c) {
-                    for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                        Y.SH(s,l,m)(p, c) = Y.SH(s,l,m)(p, 2*Nbc-c-1);
-                        Y.SH(s,l,m)(p, c) *= sign;
-                    }
-                }
+//-------------------------------------------------------------------------------------
 
-            }
-        }
-    }
+    size_t Nx(Y.SH(0,0,0).numx());
 
     // Mirror the fields
-    for(size_t i(0); i < Y.EMF().dim(); ++i){
+    for(size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
         for (size_t c(0); c < Nbc; ++c)
             Y.FLD(i)(c) = Y.FLD(i)(2*Nbc-c-1);
     }
 
-    for (size_t c(0); c < Nbc; ++c) {
-// 			Ey
-        Y.EMF().Ey()(c) *= -1.0; // left  boundary
-// 			Ez
-        Y.EMF().Ez()(c) *= -1.0; // left  boundary
-// 			Bx
+    //Bx
+    for(size_t c(0); c < Nbc; ++c) {
         Y.EMF().Bx()(c) *= -1.0; // left  boundary
-
-//        Y.EMF().By()(c) = 1e-3; // left  boundary
-    }
-
-    if (Input::List().hydromotion)
-    {
-        // Hydro Quantities:   x0 "Right-Bound ---> Left-Guard"
-        for(size_t c(0); c < Nbc; c++) {
-            Y.HYDRO().density(c) =  Y.HYDRO().density(2*Nbc-c-1);
-            Y.HYDRO().temperature(c) =  Y.HYDRO().temperature(2*Nbc-c-1);
-            Y.HYDRO().Z(c) =  Y.HYDRO().Z(2*Nbc-c-1);
-
-            Y.HYDRO().vx(c) *= -1.0;
-        }
-    }
-
-    if (Input::List().particlepusher)
-    {
-        for (int ip(0); ip < Y.particles().numpar(); ++ip){
-            if (Y.particles().x(ip) < Input::List().xminLocalnobnd[0])  
-            {
-                Y.particles().x(ip) = Input::List().xminLocalnobnd[0] + (Input::List().xminLocalnobnd[0] - Y.particles().x(ip));
-                Y.particles().px(ip) *= -1.0;
-                Y.particles().ishere(ip) = 1;
-            }
-        }
     }
 
-
 }
-//--------------------------------------------------------------
+//-------------------------------------------------------------------------------------
 
 //--------------------------------------------------------------
-void Node_Communications_1D::mirror_bound_Xright(State1D& Y) {
+void Node_ImplicitE_Communications_1D::mirror_bound_Xright(State1D& Y) {
 //--------------------------------------------------------------
 //  Mirror boundary in the x direction on the right
 //--------------------------------------------------------------
-    int sign(1);
-    size_t Nx(Y.SH(0,0,0).numx());
-
-    // Mirror the harmonics
-    for(size_t s(0); s < Y.Species(); ++s) {
-        for(size_t l(0); l < Y.DF(s).l0(); ++l){
-            for(size_t m(0); m < ((Y.DF(s).m0() < l)? Y.DF(s).m0():l)+1; ++m){
-                sign = 1-2*((l+m)%2);          //(-1)^(m+n)
 
-                for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                    for (size_t c(0); c < Nbc; ++c) {
-                        Y.SH(s,l,m)(p, Nx-c-1) = Y.SH(s,l,m)(p, Nx-2*Nbc+c);
-                        Y.SH(s,l,m)(p, Nx-c-1) *= sign;
-                    }
-                }
-
-            }
-        }
-    }
+    size_t Nx(Y.SH(0,0,0).numx());
 
     // Mirror the fields
-    for(size_t i(0); i < Y.EMF().dim(); ++i){
+    for(size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
         for (size_t c(0); c < Nbc; ++c)
             Y.FLD(i)(Nx-c-1) = Y.FLD(i)(Nx-2*Nbc+c);
     }
 
-    for (size_t c(0); c < Nbc; ++c) {
-        //Ey
-        Y.EMF().Ey()(Nx-c-1) *= -1.0; // right boundary
-        //Ez
-        Y.EMF().Ez()(Nx-c-1) *= -1.0; // right boundary
-        //Bx
-        Y.EMF().Bx()(Nx-c-1) *= -1.0; // right boundary
-
-//        Y.EMF().By()(Nx-c-1) = 1e-3; // right  boundary
-    }
-
-    if (Input::List().hydromotion)
-    {
-        // Hydro Quantities:   x0 "Left-Bound ---> Right-Guard"
-        for(size_t c(0); c < Nbc; c++) {
-            Y.HYDRO().density(Y.EMF().Ex().numx()-Nbc+c) =  Y.HYDRO().density(Y.EMF().Ex().numx()-2*Nbc+c);
-            Y.HYDRO().temperature(Y.EMF().Ex().numx()-Nbc+c) =  Y.HYDRO().temperature(Y.EMF().Ex().numx()-2*Nbc+c);
-            Y.HYDRO().Z(Y.EMF().Ex().numx()-Nbc+c) =  Y.HYDRO().Z(Y.EMF().Ex().numx()-2*Nbc+c);
-            
-
-            Y.HYDRO().vx(Y.EMF().Ex().numx()-Nbc+c) *=  -1.0;
-        }
-    }
-
-    if (Input::List().particlepusher)
-    {
-        for (int ip(0); ip < Y.particles().numpar(); ++ip){
-            if (Y.particles().x(ip) > Input::List().xmaxLocalnobnd[0])  
-            {
-                Y.particles().x(ip) = Input::List().xmaxLocalnobnd[0] - (Y.particles().x(ip) - Input::List().xmaxLocalnobnd[0]);
-                Y.particles().px(ip) *= -1.0;
-                Y.particles().ishere(ip) = 1;
-            }
-        }
+    //Bx
+    for(size_t c(0); c < Nbc; ++c) {
+        Y.EMF().Bx()(Nx-1-c) *= -1.0; // right  boundary
     }
 
 }
 //--------------------------------------------------------------
 
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 //  Boundary conditions on both sides of a node
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
 //--------------------------------------------------------------
-void Node_Communications_1D::sameNode_bound_X(State1D& Y) {
+void Node_ImplicitE_Communications_1D::sameNode_bound_X(State1D& Y) {
 //--------------------------------------------------------------
 //  Choose between boundary conditions in the x direction
 //--------------------------------------------------------------
-
     switch (BNDX()) {
         case 0:                   // periodic
             sameNode_periodic_X(Y);
+
             break;
         case 1:                   // mirror boundary
             sameNode_mirror_X(Y);
             break;
-        // case 2:                   // mirror boundary
-            // sameNode_PML_X(Y);
-            // break;
         default:
             cout<<"Not a valid boundary condition." << endl;
             break;
@@ -981,109 +915,379 @@ void Node_Communications_1D::sameNode_bound_X(State1D& Y) {
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-void Node_Communications_1D::sameNode_periodic_X(State1D& Y) {
+void Node_ImplicitE_Communications_1D::sameNode_periodic_X(State1D& Y) {
 //--------------------------------------------------------------
 //  Periodic boundary in the x direction for 1 node
 //--------------------------------------------------------------
 
-    // Harmonics:x0 "Right-Bound ---> Left-Guard"
-    for(size_t s(0); s < Y.Species(); ++s) {
-        for(size_t i(0); i < Y.DF(s).dim(); ++i) {
-            for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                for(size_t c(0); c < Nbc; c++) {
-                    (Y.DF(s)(i))(p, c) = (Y.DF(s)(i))(p, Y.EMF().Ex().numx()-2*Nbc+c);
-                    // std::cout << "\n 1: DF(" << i << "," << p << "," << c << ") = " << (Y.DF(s)(i))(p, Y.EMF().Ex().numx()-2*Nbc+c) << "\n";
-                }
-            }
-        }
-    }
     // Fields:   x0 "Right-Bound ---> Left-Guard"
-    for(size_t i(0); i < Y.EMF().dim(); ++i) {
+    for(size_t i(3); i < Y.EMF().dim(); ++i) // "3" as opposed to "0"
         for(size_t c(0); c < Nbc; c++) {
             Y.FLD(i)(c) = Y.FLD(i)(Y.EMF().Ex().numx()-2*Nbc+c);
-            // std::cout << "\n 2: FLD(" << i << "," << c << ") = " << Y.FLD(i)(Y.EMF().Ex().numx()-2*Nbc+c) << "\n";
         }
-    }
-
 
+    // Fields:   x0 "Left-Bound ---> Right-Guard"
+    for(size_t i(3); i < Y.EMF().dim(); ++i) // "3" as opposed to "0"
+        for(size_t c(0); c < Nbc; c++) {
+            Y.FLD(i)(Y.EMF().Ex().numx()-Nbc+c) = Y.FLD(i)(Nbc+c);
+        }
 
-    // Harmonics:x0 "Left-Bound ---> Right-Guard"
-    for(size_t s(0); s < Y.Species(); ++s) {
-        for(size_t i(0); i < Y.DF(s).dim(); ++i) {
-            for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                for(size_t c(0); c < Nbc; c++) {
-                    // std::cout << "\n 3: DF(" << i << "," << p << "," << Y.EMF().Ex().numx()-Nbc+c << ") = " << (Y.DF(s)(i))(p, Y.EMF().Ex().numx()-Nbc+c) << "\n";
+}
+//--------------------------------------------------------------
 
-                    (Y.DF(s)(i))(p, Y.EMF().Ex().numx()-Nbc+c) = (Y.DF(s)(i))(p, Nbc+c);
+//--------------------------------------------------------------
+void Node_ImplicitE_Communications_1D::sameNode_mirror_X(State1D& Y) {
+//--------------------------------------------------------------
+//  Mirror boundary in the x direction for 1 node
+//--------------------------------------------------------------
 
-                    // std::cout << "\n 3n: DF(" << i << "," << p << "," << Y.EMF().Ex().numx()-Nbc+c << ") = " << (Y.DF(s)(i))(p, Y.EMF().Ex().numx()-Nbc+c-100.0) << "\n";
-                    // if (c==2)
+    size_t Nx(Y.SH(0,0,0).numx());
 
+    // Mirror the fields
+    for(size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
+        // right boundary
+        for (size_t c(0); c < Nbc; ++c)
+            Y.FLD(i)(Nx-c-1) = Y.FLD(i)(Nx-2*Nbc+c);
+        // left boundary
+        for (size_t c(0); c < Nbc; ++c)
+            Y.FLD(i)(c) = Y.FLD(i)(2*Nbc-c-1);
+    }
 
-                }
-            }
-        }
+    //Bx
+    for (size_t c(0); c < Nbc; ++c) {
+        Y.EMF().Bx()(c) *= -1.0; // left  boundary
+        Y.EMF().Bx()(Nx-Nbc+c) *= -1.0; // right  boundary
     }
 
-    // Fields:   x0 "Left-Bound ---> Right-Guard"
-    for(size_t i(0); i < Y.EMF().dim(); ++i) {
-        for(size_t c(0); c < Nbc; c++) {
-            // if (i == 0)                 std::cout << "\n 4: FLD(" << i << "," << Y.EMF().Ex().numx()-Nbc+c << ") = " << Y.FLD(i)(Y.EMF().Ex().numx()-Nbc+c) << "\n";
-            Y.FLD(i)(Y.EMF().Ex().numx()-Nbc+c) = Y.FLD(i)(Nbc+c);
-            // if (i == 0)                 std::cout << "\n 4n: FLD(" << i << "," << Y.EMF().Ex().numx()-Nbc+c << ") = " << Y.FLD(i)(Y.EMF().Ex().numx()-Nbc+c) << "\n";
+}
+//--------------------------------------------------------------
 
 
-        }
-        // Y.FLD(i)(Y.EMF().Ex().numx()-1) = 0.0;
-    }
+//**************************************************************
+//**************************************************************
+//  Definition of the Nodes Communications class
+//**************************************************************
+//**************************************************************
 
-    if (Input::List().hydromotion)
-    {
-        // Hydro Quantities:   x0 "Right-Bound ---> Left-Guard"
-        for(size_t c(0); c < Nbc; c++) {
-            Y.HYDRO().density(c) = Y.HYDRO().density(Y.EMF().Ex().numx()-2*Nbc+c);
-            Y.HYDRO().vx(c) = Y.HYDRO().vx(Y.EMF().Ex().numx()-2*Nbc+c);
-            Y.HYDRO().vy(c) = Y.HYDRO().vy(Y.EMF().Ex().numx()-2*Nbc+c);
-            Y.HYDRO().vz(c) = Y.HYDRO().vz(Y.EMF().Ex().numx()-2*Nbc+c);
-            Y.HYDRO().temperature(c) = Y.HYDRO().temperature(Y.EMF().Ex().numx()-2*Nbc+c);
-            Y.HYDRO().Z(c) = Y.HYDRO().Z(Y.EMF().Ex().numx()-2*Nbc+c);
+
+//**************************************************************
+//--------------------------------------------------------------
+Node_Communications_1D:: Node_Communications_1D() :
+//--------------------------------------------------------------
+//  Constructor
+//--------------------------------------------------------------
+        Nbc(Input::List().BoundaryCells),      // # of boundary cells
+        bndX(Input::List().bndX),        // Type of boundary in X
+        shared(Harmonic_Group::Space(), 2) {
+
+    numspec = Input::List().ls.size();
+    // numpmax = Input::List().ps;
+
+    // The harmonics, fields and hydro quantities are described by 
+    // the halo datatypes, only the particles go through a buffer
+    par_sizeX = 0;
+    if (Input::List().particlepusher)
+    {
+        par_sizeX += Input::List().numparticles; // Going Left or Right?
+        par_sizeX += Input::List().numparticles; // Position
+        par_sizeX += Input::List().numparticles; // X-momentum
+        par_sizeX += Input::List().numparticles; // Y-momentum
+        par_sizeX += Input::List().numparticles; // Z-momentum
+    }
+    
+    par_sendX = new complex<double>[par_sizeX+1];
+    for (size_t i(0); i < 2; ++i) {
+        par_recvX[i] = new complex<double>[par_sizeX+1];
+        neighborX[i] = -1;
+    }
+    num_reqX  = 0;
+    num_haloX = 0;
+    halo_base = NULL;
+
+    MPI_Comm_dup(Harmonic_Group::Space(), &comm_halo);
+
+}
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+Node_Communications_1D:: ~Node_Communications_1D(){
+//--------------------------------------------------------------
+//  Destructor
+//--------------------------------------------------------------
+    delete[] par_sendX;
+    for (size_t i(0); i < 2; ++i) {
+        delete[] par_recvX[i];
+    }
+
+    int finalized;
+    MPI_Finalized(&finalized);
+    if (!finalized) {
+        Free_X();
+        MPI_Comm_free(&comm_halo);
+    }
+}
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+int Node_Communications_1D:: BNDX()  const {return bndX;}
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+//  Non-blocking exchange in the X direction
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+//--------------------------------------------------------------
+void Node_Communications_1D::Post_X(State1D& Y, int left, int right) {
+//--------------------------------------------------------------
+//  X-axis : Start the persistent exchange. The boundary cells 
+//           of Y are read and the guard cells are written 
+//           directly, so they must not be touched until Complete_X
+//--------------------------------------------------------------
+
+    if ( (halo_base != &(Y.DF(0)(0))(0,0)) || 
+         (left != neighborX[0]) || (right != neighborX[1]) ) {
+        Setup_X(Y, left, right);
+    }
+
+    if (Input::List().particlepusher) Pack_particles_X(Y, par_sendX);
+
+    shared.Pack();
+    MPI_Startall(num_reqX, msg_reqX);
+}
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+void Node_Communications_1D::Complete_X(State1D& Y) {
+//--------------------------------------------------------------
+//  X-axis : Wait for the exchange to update the guard cells
+//--------------------------------------------------------------
+
+    MPI_Waitall(num_reqX, msg_reqX, MPI_STATUSES_IGNORE);
+    shared.Unpack();
+
+    if (Input::List().particlepusher) {
+        if (neighborX[0] > -1) Unpack_particles_left_X(Y, par_recvX[0]);
+        if (neighborX[1] > -1) Unpack_particles_right_X(Y, par_recvX[1]);
+    }
+}
+//--------------------------------------------------------------
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+//  Halo datatypes and persistent requests in the X direction
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+//--------------------------------------------------------------
+void Node_Communications_1D::Setup_X(State1D& Y, int left, int right) {
+//--------------------------------------------------------------
+//  X-axis : Describe the halos of Y and initialize the persistent 
+//           requests. This is repeated only if Y or the neighbors 
+//           change, the storage of Y is never reallocated. A halo
+//           of a neighbor on this host goes through shared memory,
+//           the slot is the tag of the message it replaces
+//--------------------------------------------------------------
+
+    size_t Nx(Y.SH(0,0,0).numx());
+
+    Free_X();
+
+    neighborX[0] = left; neighborX[1] = right;
+    halo_base = &(Y.DF(0)(0))(0,0);
+
+    if (left  > -1) {
+        haloX[num_haloX] = Halo_X(Y, 0, par_recvX[0]);                     // Left-Guard
+        if (shared.Shared(left)) shared.Recv(haloX[num_haloX], left, 0);
+        else MPI_Recv_init(MPI_BOTTOM, 1, haloX[num_haloX], left,  0, comm_halo, &msg_reqX[num_reqX++]);
+        ++num_haloX;
+    }
+    if (right > -1) {
+        haloX[num_haloX] = Halo_X(Y, Nx-Nbc, par_recvX[1]);                // Right-Guard
+        if (shared.Shared(right)) shared.Recv(haloX[num_haloX], right, 1);
+        else MPI_Recv_init(MPI_BOTTOM, 1, haloX[num_haloX], right, 1, comm_halo, &msg_reqX[num_reqX++]);
+        ++num_haloX;
+    }
+    if (right > -1) {
+        haloX[num_haloX] = Halo_X(Y, Nx-2*Nbc, par_sendX);                 // Right-Bound
+        if (shared.Shared(right)) shared.Send(haloX[num_haloX], right, 0);
+        else MPI_Send_init(MPI_BOTTOM, 1, haloX[num_haloX], right, 0, comm_halo, &msg_reqX[num_reqX++]);
+        ++num_haloX;
+    }
+    if (left  > -1) {
+        haloX[num_haloX] = Halo_X(Y, Nbc, par_sendX);                      // Left-Bound
+        if (shared.Shared(left)) shared.Send(haloX[num_haloX], left, 1);
+        else MPI_Send_init(MPI_BOTTOM, 1, haloX[num_haloX], left,  1, comm_halo, &msg_reqX[num_reqX++]);
+        ++num_haloX;
+    }
+
+    shared.Allocate();
+}
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+void Node_Communications_1D::Free_X() {
+//--------------------------------------------------------------
+//  X-axis : Release the persistent requests and the datatypes
+//--------------------------------------------------------------
+
+    shared.Clear();
+    for (int i(0); i < num_reqX; ++i) {
+        MPI_Request_free(&msg_reqX[i]);
+    }
+    for (int i(0); i < num_haloX; ++i) {
+        MPI_Type_free(&haloX[i]);
+    }
+    num_reqX  = 0;
+    num_haloX = 0;
+    halo_base = NULL;
+}
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+MPI_Datatype Node_Communications_1D::Halo_X(State1D& Y, size_t x0, complex<double>* parbuf) {
+//--------------------------------------------------------------
+//  X-axis : Datatype for the Nbc cells starting at x0. The cells 
+//           of a harmonic are contiguous in p, so every array 
+//           contributes a single block at its absolute address
+//--------------------------------------------------------------
+
+    vector<int>          blocklen;
+    vector<MPI_Aint>     address;
+    vector<MPI_Datatype> type;
+    MPI_Aint             a;
+
+    // Harmonics
+    for(size_t s(0); s < Y.Species(); ++s) {
+        for(size_t i(0); i < Y.DF(s).dim(); ++i){
+            MPI_Get_address(&(Y.DF(s)(i))(0, x0), &a);
+            blocklen.push_back(Y.SH(s,0,0).nump()*Nbc); address.push_back(a); type.push_back(MPI_DOUBLE_COMPLEX);
         }
+    }
+    // Fields
+    for(size_t i(0); i < Y.EMF().dim(); ++i){
+        MPI_Get_address(&(Y.FLD(i)(x0)), &a);
+        blocklen.push_back(Nbc); address.push_back(a); type.push_back(MPI_DOUBLE_COMPLEX);
+    }
 
-        // Hydro Quantities:   x0 "Left-Bound ---> Right-Guard"
-        for(size_t c(0); c < Nbc; c++) {
-            Y.HYDRO().density(Y.EMF().Ex().numx()-Nbc+c) =  Y.HYDRO().density(Nbc+c);
-            Y.HYDRO().vx(Y.EMF().Ex().numx()-Nbc+c) =  Y.HYDRO().vx(Nbc+c);
-            Y.HYDRO().vy(Y.EMF().Ex().numx()-Nbc+c) =  Y.HYDRO().vy(Nbc+c);
-            Y.HYDRO().vz(Y.EMF().Ex().numx()-Nbc+c) =  Y.HYDRO().vz(Nbc+c);
-            Y.HYDRO().temperature(Y.EMF().Ex().numx()-Nbc+c) =  Y.HYDRO().temperature(Nbc+c);
-            Y.HYDRO().Z(Y.EMF().Ex().numx()-Nbc+c) =  Y.HYDRO().Z(Nbc+c);
+    if (Input::List().hydromotion)
+    {
+        double* hydro[6] = {&(Y.HYDRO().density(x0)), &(Y.HYDRO().vx(x0)), &(Y.HYDRO().vy(x0)), 
+                            &(Y.HYDRO().vz(x0)), &(Y.HYDRO().temperature(x0)), &(Y.HYDRO().Z(x0))};
+        for(size_t i(0); i < 6; ++i){
+            MPI_Get_address(hydro[i], &a);
+            blocklen.push_back(Nbc); address.push_back(a); type.push_back(MPI_DOUBLE);
         }
     }
 
     if (Input::List().particlepusher)
     {
-        for (int ip(0); ip < Y.particles().numpar(); ++ip)
+        MPI_Get_address(parbuf, &a);
+        blocklen.push_back(par_sizeX); address.push_back(a); type.push_back(MPI_DOUBLE_COMPLEX);
+    }
+
+    MPI_Datatype halo;
+    MPI_Type_create_struct(blocklen.size(), &blocklen[0], &address[0], &type[0], &halo);
+    MPI_Type_commit(&halo);
+
+    return halo;
+}
+//--------------------------------------------------------------
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+//  Particles in the X direction
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+//--------------------------------------------------------------
+void Node_Communications_1D::Pack_particles_X(State1D& Y, complex<double>* buf) {
+//--------------------------------------------------------------
+//  X-axis : All the particles are sent to both neighbors, 
+//           the receiving node decides which ones to keep
+//--------------------------------------------------------------
+
+    size_t bufind(0);
+
+    for (int ip(0); ip < Y.particles().numpar(); ++ip)
+    {          
+        buf[bufind]   = Y.particles().goingright(ip);
+        buf[bufind+1] = Y.particles().x(ip);
+        buf[bufind+2] = Y.particles().px(ip);
+        buf[bufind+3] = Y.particles().py(ip);
+        buf[bufind+4] = Y.particles().pz(ip);
+
+        bufind += 5;
+    }
+}
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+void Node_Communications_1D::Unpack_particles_left_X(State1D& Y, complex<double>* buf) {
+//--------------------------------------------------------------
+//  X-axis : Keep the particles that came in from the left
+//--------------------------------------------------------------
+
+    size_t bufind(0);
+
+    for (int ip(0); ip < Y.particles().numpar(); ++ip){
+
+        if (int (buf[bufind].real()) == 1)
         {
-            if (Y.particles().x(ip) > Input::List().xmaxLocalnobnd[0])
-            {
-                Y.particles().x(ip) = Input::List().xminLocalnobnd[0] + (Y.particles().x(ip) - Input::List().xmaxLocalnobnd[0]); 
-                Y.particles().ishere(ip) = 1;  
-            }
-            else if (Y.particles().x(ip) < Input::List().xminLocalnobnd[0])
-            {
-                Y.particles().x(ip) = Input::List().xmaxLocalnobnd[0] - (Input::List().xminLocalnobnd[0] - Y.particles().x(ip));   
-                Y.particles().ishere(ip) = 1;
+            if (buf[bufind+1].real() >= Input::List().xmaxGlobal[0]){
+                Y.particles().x(ip) = (buf[bufind+1]).real() - Input::List().xmaxGlobal[0] + Input::List().xminGlobal[0];
             }
+            else Y.particles().x(ip)  = (buf[bufind+1]).real();
+
+            Y.particles().px(ip) = (buf[bufind+2]).real();
+            Y.particles().py(ip) = (buf[bufind+3]).real();
+            Y.particles().pz(ip) = (buf[bufind+4]).real();
+            Y.particles().ishere(ip) = 1;
         }
+        
+        bufind+=5;  // Go to next particle in buffer
     }
+}
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+void Node_Communications_1D::Unpack_particles_right_X(State1D& Y, complex<double>* buf) {
+//--------------------------------------------------------------
+//  X-axis : Keep the particles that came in from the right
+//--------------------------------------------------------------
+
+    size_t bufind(0);
+
+    for (int ip(0); ip < Y.particles().numpar(); ++ip){
+
+        if (buf[bufind].real() == -1)
+        {
+            if (buf[bufind+1].real() < Input::List().xminGlobal[0]){
+                Y.particles().x(ip) = (buf[bufind+1]).real() + Input::List().xmaxGlobal[0] - Input::List().xminGlobal[0];
+            }
+            else Y.particles().x(ip)  = (buf[bufind+1]).real();
 
+            Y.particles().px(ip) = (buf[bufind+2]).real();
+            Y.particles().py(ip) = (buf[bufind+3]).real();
+            Y.particles().pz(ip) = (buf[bufind+4]).real();
+            Y.particles().ishere(ip) = 1;
+        }
+        
+        bufind+=5;  // Go to next particle in buffer
+    }
 }
 //--------------------------------------------------------------
 
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//  Boundary conditions
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+//  Mirror conditions on one side
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+//**************************************************************
 //--------------------------------------------------------------
-void Node_Communications_1D::sameNode_mirror_X(State1D& Y) {
+void Node_Communications_1D::mirror_bound_Xleft(State1D& Y) {
 //--------------------------------------------------------------
-//  Mirror boundary in the x direction for 1 node
+//  Mirror boundary in the x direction on the left
 //--------------------------------------------------------------
     int sign(1);
     size_t Nx(Y.SH(0,0,0).numx());
@@ -1094,17 +1298,8 @@ void Node_Communications_1D::sameNode_mirror_X(State1D& Y) {
             for(size_t m(0); m < ((Y.DF(s).m0() < l)? Y.DF(s).m0():l)+1; ++m){
                 sign = 1-2*((l+m)%2);          //(-1)^(m+n)
 
-                // right boundary
-                for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                    for (size_t c(0); c < Nbc; ++c) {
-                        Y.SH(s,l,m)(p, Nx-c-1) = Y.SH(s,l,m)(p, Nx-2*Nbc+c);
-                        Y.SH(s,l,m)(p, Nx-c-1) *= sign;
-                    }
-                }
-
-                // left boundary
-                for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                    for (size_t c(0); c < Nbc; ++c) {
+                for (size_t c(0); c < Nbc; ++c) {
+                    for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
                         Y.SH(s,l,m)(p, c) = Y.SH(s,l,m)(p, 2*Nbc-c-1);
                         Y.SH(s,l,m)(p, c) *= sign;
                     }
@@ -1116,889 +1311,585 @@ void Node_Communications_1D::sameNode_mirror_X(State1D& Y) {
 
     // Mirror the fields
     for(size_t i(0); i < Y.EMF().dim(); ++i){
-        // right boundary
-        for (size_t c(0); c < Nbc; ++c)
-            Y.FLD(i)(Nx-c-1) = Y.FLD(i)(Nx-2*Nbc+c);
-        // left boundary
         for (size_t c(0); c < Nbc; ++c)
             Y.FLD(i)(c) = Y.FLD(i)(2*Nbc-c-1);
     }
 
-    for(size_t c(0); c < Nbc; c++) {
-        //Ey
-        Y.EMF().Ey()(Nx-Nbc+c) *= -1.0; // right boundary
-        Y.EMF().Ey()(c) *= -1.0;  // left  boundary
-
-        //Ez
-        Y.EMF().Ez()(Nx-Nbc+c) *= -1.0; // right boundary
-        Y.EMF().Ez()(c) *= -1.0;  // left  boundary
+    for (size_t c(0); c < Nbc; ++c) {
+// 			Ey
+        Y.EMF().Ey()(c) *= -1.0; // left  boundary
+// 			Ez
+        Y.EMF().Ez()(c) *= -1.0; // left  boundary
+// 			Bx
+        Y.EMF().Bx()(c) *= -1.0; // left  boundary
 
-        //Bx
-        Y.EMF().Bx()(Nx-Nbc+c) *= -1.0; // right boundary
-        Y.EMF().Bx()(c) *= -1.0;  // left  boundary
+//        Y.EMF().By()(c) = 1e-3; // left  boundary
     }
 
-
     if (Input::List().hydromotion)
     {
         // Hydro Quantities:   x0 "Right-Bound ---> Left-Guard"
         for(size_t c(0); c < Nbc; c++) {
-            Y.HYDRO().vx(c) *= -1.0;
-        }
-
-        // Hydro Quantities:   x0 "Left-Bound ---> Right-Guard"
-        for(size_t c(0); c < Nbc; c++) {
-            Y.HYDRO().vx(Y.EMF().Ex().numx()-Nbc+c) *= -1.0;
-
+            Y.HYDRO().density(c) =  Y.HYDRO().density(2*Nbc-c-1);
+            Y.HYDRO().temperature(c) =  Y.HYDRO().temperature(2*Nbc-c-1);
+            Y.HYDRO().Z(c) =  Y.HYDRO().Z(2*Nbc-c-1);
 
+            Y.HYDRO().vx(c) *= -1.0;
         }
     }
 
     if (Input::List().particlepusher)
     {
-        for (int ip(0); ip < Y.particles().numpar(); ++ip)
-        {
-            if (Y.particles().x(ip) > Input::List().xmaxLocalnobnd[0])
-            {
-                Y.particles().x(ip) = Input::List().xmaxLocalnobnd[0] - (Y.particles().x(ip) - Input::List().xmaxLocalnobnd[0]);
-                Y.particles().px(ip) *= -1.0;
-            }
-            else if (Y.particles().x(ip) < Input::List().xminLocalnobnd[0])
+        for (int ip(0); ip < Y.particles().numpar(); ++ip){
+            if (Y.particles().x(ip) < Input::List().xminLocalnobnd[0])  
             {
                 Y.particles().x(ip) = Input::List().xminLocalnobnd[0] + (Input::List().xminLocalnobnd[0] - Y.particles().x(ip));
                 Y.particles().px(ip) *= -1.0;
+                Y.particles().ishere(ip) = 1;
             }
-
         }
     }
 
+
 }
 //--------------------------------------------------------------
 
-
-//**************************************************************
-//**************************************************************
-//   Definition of the Parallel Environment
-//**************************************************************
-//**************************************************************
-
-
 //--------------------------------------------------------------
-Parallel_Environment_1D:: Parallel_Environment_1D() :
+void Node_Communications_1D::mirror_bound_Xright(State1D& Y) {
 //--------------------------------------------------------------
-//  Constructor, domain decomposition
+//  Mirror boundary in the x direction on the right
 //--------------------------------------------------------------
-        bndX(Input::List().bndX),           // Type of boundary
-        MPI_Procs(Input::List().MPI_X[0])   // Number of nodes in X-direction
-{
-    // Determination of the rank and size of the run
-    MPI_Comm_size(MPI_COMM_WORLD, &MPI_Procs);
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-
-    if (error_check()) 
-    {
-        std::cout << "PE error check failed" << std::endl;
-        MPI_Finalize(); exit(1);
-    }
-
-    // Determination of the local computational domain (i.e. the x-axis and the y-axis)
-    for(size_t i(0); i < Input::List().xminLocal.size(); ++i) {
+    int sign(1);
+    size_t Nx(Y.SH(0,0,0).numx());
 
-        Input::List().xminLocal[i] = Input::List().xminGlobal[i]
-                                     + rank * Input::List().NxLocalnobnd[i] * Input::List().globdx[i]
-                                     - Input::List().BoundaryCells * Input::List().globdx[i];
-        Input::List().xmaxLocal[i] = Input::List().xminLocal[i]
-                                     + (Input::List().NxLocal[i]) * Input::List().globdx[i];
+    // Mirror the harmonics
+    for(size_t s(0); s < Y.Species(); ++s) {
+        for(size_t l(0); l < Y.DF(s).l0(); ++l){
+            for(size_t m(0); m < ((Y.DF(s).m0() < l)? Y.DF(s).m0():l)+1; ++m){
+                sign = 1-2*((l+m)%2);          //(-1)^(m+n)
 
-        Input::List().xminLocalnobnd[i] = Input::List().xminLocal[i] + Input::List().BoundaryCells * Input::List().globdx[i];
-        Input::List().xmaxLocalnobnd[i] = Input::List().xmaxLocal[i] - Input::List().BoundaryCells * Input::List().globdx[i];
+                for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
+                    for (size_t c(0); c < Nbc; ++c) {
+                        Y.SH(s,l,m)(p, Nx-c-1) = Y.SH(s,l,m)(p, Nx-2*Nbc+c);
+                        Y.SH(s,l,m)(p, Nx-c-1) *= sign;
+                    }
+                }
 
+            }
+        }
     }
 
-    double  xval_lastcell = Input::List().xmaxLocal[0] - 0.5*Input::List().globdx[0];
-    double xval_firstcell = Input::List().xminLocal[0] + 0.5*Input::List().globdx[0];
+    // Mirror the fields
+    for(size_t i(0); i < Y.EMF().dim(); ++i){
+        for (size_t c(0); c < Nbc; ++c)
+            Y.FLD(i)(Nx-c-1) = Y.FLD(i)(Nx-2*Nbc+c);
+    }
 
-    
-    // Restart files will be generated when output_step % restart_step == 0
-//          if ( ( (Input::List().n_outsteps + 1) >  Input::List().n_restarts ) &&
-//                (Input::List().n_restarts > 0)  ) { 
-//               restart_step = Input::List().n_outsteps / Input::List().n_restarts ;
-//          } 
-//          else restart_step = -1;
-//          if ( Input::List().restart_time > Input::List().n_restarts ) {
-//              restart_time = 0; 
-//          }
-//          else restart_time = Input::List().restart_time;
+    for (size_t c(0); c < Nbc; ++c) {
+        //Ey
+        Y.EMF().Ey()(Nx-c-1) *= -1.0; // right boundary
+        //Ez
+        Y.EMF().Ez()(Nx-c-1) *= -1.0; // right boundary
+        //Bx
+        Y.EMF().Bx()(Nx-c-1) *= -1.0; // right boundary
 
-}
-//--------------------------------------------------------------
-//  Destructor
-//--------------------------------------------------------------
-Parallel_Environment_1D:: ~Parallel_Environment_1D(){ }
-//--------------------------------------------------------------
+//        Y.EMF().By()(Nx-c-1) = 1e-3; // right  boundary
+    }
 
-//--------------------------------------------------------------
-bool Parallel_Environment_1D:: error_check() {
-//--------------------------------------------------------------
-//  Temporary error check
-//--------------------------------------------------------------
+    if (Input::List().hydromotion)
+    {
+        // Hydro Quantities:   x0 "Left-Bound ---> Right-Guard"
+        for(size_t c(0); c < Nbc; c++) {
+            Y.HYDRO().density(Y.EMF().Ex().numx()-Nbc+c) =  Y.HYDRO().density(Y.EMF().Ex().numx()-2*Nbc+c);
+            Y.HYDRO().temperature(Y.EMF().Ex().numx()-Nbc+c) =  Y.HYDRO().temperature(Y.EMF().Ex().numx()-2*Nbc+c);
+            Y.HYDRO().Z(Y.EMF().Ex().numx()-Nbc+c) =  Y.HYDRO().Z(Y.EMF().Ex().numx()-2*Nbc+c);
+            
 
-    // Test the number of cells
-    if (rank == 0){
-        if (Input::List().NxLocal[0] < 2*Input::List().BoundaryCells+2){
-            std::cout << "Not enough cells per processor" << endl;
-            return true;
+            Y.HYDRO().vx(Y.EMF().Ex().numx()-Nbc+c) *=  -1.0;
         }
-        if ( MPI_Procs != (Input::List().MPI_X[0]) ) {
-            std:: cout << "the number of nodes in the input deck is "
-                       << (Input::List().MPI_X[0]) << ", terminating ..." << endl;
-            return true;
+    }
+
+    if (Input::List().particlepusher)
+    {
+        for (int ip(0); ip < Y.particles().numpar(); ++ip){
+            if (Y.particles().x(ip) > Input::List().xmaxLocalnobnd[0])  
+            {
+                Y.particles().x(ip) = Input::List().xmaxLocalnobnd[0] - (Y.particles().x(ip) - Input::List().xmaxLocalnobnd[0]);
+                Y.particles().px(ip) *= -1.0;
+                Y.particles().ishere(ip) = 1;
+            }
         }
     }
-    return false;
+
 }
 //--------------------------------------------------------------
 
-//--------------------------------------------------------------
-//  Basic information
-//--------------------------------------------------------------
-int Parallel_Environment_1D:: RANK()  const {return rank;}
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-int Parallel_Environment_1D:: MPI_Processes() const {return MPI_Procs;}
+//  Boundary conditions on both sides of a node
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-int Parallel_Environment_1D:: BNDX()  const {return bndX;}
+
+//--------------------------------------------------------------
+void Node_Communications_1D::sameNode_bound_X(State1D& Y) {
+//--------------------------------------------------------------
+//  Choose between boundary conditions in the x direction
 //--------------------------------------------------------------
 
+    switch (BNDX()) {
+        case 0:                   // periodic
+            sameNode_periodic_X(Y);
+            break;
+        case 1:                   // mirror boundary
+            sameNode_mirror_X(Y);
+            break;
+        // case 2:                   // mirror boundary
+            // sameNode_PML_X(Y);
+            // break;
+        default:
+            cout<<"Not a valid boundary condition." << endl;
+            break;
+    }
+}
+//--------------------------------------------------------------
 
 //--------------------------------------------------------------
-void Parallel_Environment_1D::Neighbor_ImplicitE_Communications(State1D& Y){
+void Node_Communications_1D::sameNode_periodic_X(State1D& Y) {
 //--------------------------------------------------------------
-//  Information exchange between neighbors 
+//  Periodic boundary in the x direction for 1 node
 //--------------------------------------------------------------
 
-    int moduloX(RANK()%2);
-    int RNx((RANK()+1)%MPI_Processes()),         // This is the right neighbor
-            LNx((RANK()-1+MPI_Processes())%MPI_Processes()); // This is the left  neighbor
-
-    if (MPI_Processes() > 1) {
-        //even nodes
-        if (moduloX==0){
-            Bfield_Data.Send_right_X(Y,RNx);                  //   (Send) 0 --> 1
-            if ((RANK() != 0) || (BNDX()==0)){
-                Bfield_Data.Recv_from_left_X(Y,LNx);          //          1 --> 0 (Receive)
-                Bfield_Data.Send_left_X(Y,LNx);               //          1 <-- 0 (Send)
-            }
-            else {
-                if (BNDX()==1) {
-                    Bfield_Data.mirror_bound_Xleft(Y);        // Update node "0" in the x direction
-                }
-                else {
-                    cout<<"Invalid Boundary." << endl;
+    // Harmonics:x0 "Right-Bound ---> Left-Guard"
+    for(size_t s(0); s < Y.Species(); ++s) {
+        for(size_t i(0); i < Y.DF(s).dim(); ++i) {
+            for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
+                for(size_t c(0); c < Nbc; c++) {
+                    (Y.DF(s)(i))(p, c) = (Y.DF(s)(i))(p, Y.EMF().Ex().numx()-2*Nbc+c);
+                    // std::cout << "\n 1: DF(" << i << "," << p << "," << c << ") = " << (Y.DF(s)(i))(p, Y.EMF().Ex().numx()-2*Nbc+c) << "\n";
                 }
             }
-            Bfield_Data.Recv_from_right_X(Y,RNx);               // (Receive) 0 <-- 1
         }
-            //odd nodes 
-        else {
-            Bfield_Data.Recv_from_left_X(Y,LNx);               //           0 --> 1 (Receive)
-            if ((RANK()!=(MPI_Processes()-1)) || (BNDX()==0)){
-                Bfield_Data.Send_right_X(Y,RNx);              //   (Send)  1 --> 0
-                Bfield_Data.Recv_from_right_X(Y,RNx);         // (Receive) 1 <-- 0
-            }
-            else {
-                if (BNDX()==1) {
-                    Bfield_Data.mirror_bound_Xright(Y);        // Update node "N-1" in the x direction
-                }
-                else {
-                    cout<<"Invalid Boundary." << endl;;
-                }
-            }
-            Bfield_Data.Send_left_X(Y,LNx);                    //           0 <-- 1 (Send)
+    }
+    // Fields:   x0 "Right-Bound ---> Left-Guard"
+    for(size_t i(0); i < Y.EMF().dim(); ++i) {
+        for(size_t c(0); c < Nbc; c++) {
+            Y.FLD(i)(c) = Y.FLD(i)(Y.EMF().Ex().numx()-2*Nbc+c);
+            // std::cout << "\n 2: FLD(" << i << "," << c << ") = " << Y.FLD(i)(Y.EMF().Ex().numx()-2*Nbc+c) << "\n";
         }
     }
-    else { Bfield_Data.sameNode_bound_X(Y); }
 
-}
-//--------------------------------------------------------------
 
 
-//--------------------------------------------------------------
-void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
-//--------------------------------------------------------------
-//  Information exchange between neighbors 
-//--------------------------------------------------------------
+    // Harmonics:x0 "Left-Bound ---> Right-Guard"
+    for(size_t s(0); s < Y.Species(); ++s) {
+        for(size_t i(0); i < Y.DF(s).dim(); ++i) {
+            for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
+                for(size_t c(0); c < Nbc; c++) {
+                    // std::cout << "\n 3: DF(" << i << "," << p << "," << Y.EMF().Ex().numx()-Nbc+c << ") = " << (Y.DF(s)(i))(p, Y.EMF().Ex().numx()-Nbc+c) << "\n";
 
-    int moduloX(RANK() % 2);
-    int RNx((RANK() + 1) % MPI_Processes()),         // This is the right neighbor
-            LNx((RANK() - 1 + MPI_Processes()) % MPI_Processes()); // This is the left  neighbor
+                    (Y.DF(s)(i))(p, Y.EMF().Ex().numx()-Nbc+c) = (Y.DF(s)(i))(p, Nbc+c);
 
-    if (MPI_Processes() > 1) {
-        //even nodes
-//        if (moduloX==0){
-        // std::cout << "\n before boundary on " << Input::List().xminLocalnobnd[0] << "? " << Y.particles().x(2) << "\n\n";  
-        if (BNDX() == 0) {
-            if (((RANK() != 0) && (RANK() != MPI_Processes() - 1))) {
-                X_Data.Send_right_X(Y, RNx);                  //   (Send) 0 --> 1
-                X_Data.Recv_from_left_X(Y, LNx);          //          1 --> 0 (Receive)
-                X_Data.Send_left_X(Y, LNx);               //          1 <-- 0 (Send)
-                X_Data.Recv_from_right_X(Y, RNx);               // (Receive) 0 <-- 1
-            } else if (RANK() == 0) {                         /// Update node "0" in the x direction
-                X_Data.Recv_from_left_X(Y, MPI_Processes() - 1);          //          1 --> 0 (Receive)
-                X_Data.Send_left_X(Y, MPI_Processes() - 1);               //          1 <-- 0 (Send)
-                X_Data.Send_right_X(Y, RNx);                ///   (Send) 0 --> 1
-                X_Data.Recv_from_right_X(Y, RNx);           /// (Receive) 0 <-- 1
-            } else if (RANK() == MPI_Processes() - 1) {               ///        // Update node "MPI_Processes()" in the x direction
-                X_Data.Send_right_X(Y, 0);                  //   (Send) 0 --> 1
-                X_Data.Recv_from_right_X(Y, 0);           /// (Receive) 0 <-- 1
-                X_Data.Recv_from_left_X(Y, LNx);          //          1 --> 0 (Receive)
-                X_Data.Send_left_X(Y, LNx);               //          1 <-- 0 (Send)
-            }
-
-            Y.particles().par_goingright_array() = 0.0;
+                    // std::cout << "\n 3n: DF(" << i << "," << p << "," << Y.EMF().Ex().numx()-Nbc+c << ") = " << (Y.DF(s)(i))(p, Y.EMF().Ex().numx()-Nbc+c-100.0) << "\n";
+                    // if (c==2)
 
-        } 
-        else if (BNDX() == 1) {
-            if (((RANK() != 0) && (RANK() != MPI_Processes() - 1))) {
-                X_Data.Send_right_X(Y, RNx);                  //   (Send) 0 --> 1
-                X_Data.Recv_from_left_X(Y, LNx);          //          1 --> 0 (Receive)
-                X_Data.Send_left_X(Y, LNx);               //          1 <-- 0 (Send)
-                X_Data.Recv_from_right_X(Y, RNx);               // (Receive) 0 <-- 1
-            } else if (RANK() == 0) {                         /// Update node "0" in the x direction
-                X_Data.mirror_bound_Xleft(Y);
-                X_Data.Send_right_X(Y, RNx);                ///   (Send) 0 --> 1
-                X_Data.Recv_from_right_X(Y, RNx);           /// (Receive) 0 <-- 1
-            } else if (RANK() == MPI_Processes() - 1) {               ///        // Update node "MPI_Processes()" in the x direction
-                X_Data.mirror_bound_Xright(Y);
-                X_Data.Recv_from_left_X(Y, LNx);          //          1 --> 0 (Receive)
-                X_Data.Send_left_X(Y, LNx);               //          1 <-- 0 (Send)
-            }
 
-        }
-        else if (BNDX() == 2) {
-            if (((RANK() != 0) && (RANK() != MPI_Processes() - 1))) {
-                X_Data.Send_right_X(Y, RNx);                  //   (Send) 0 --> 1
-                X_Data.Recv_from_left_X(Y, LNx);          //          1 --> 0 (Receive)
-                X_Data.Send_left_X(Y, LNx);               //          1 <-- 0 (Send)
-                X_Data.Recv_from_right_X(Y, RNx);               // (Receive) 0 <-- 1
-            } else if (RANK() == 0) {                         /// Update node "0" in the x direction
-                X_Data.Recv_from_left_X(Y, MPI_Processes() - 1);          //          1 --> 0 (Receive)
-                X_Data.Send_left_X(Y, MPI_Processes() - 1);               //          1 <-- 0 (Send)
-                X_Data.Send_right_X(Y, RNx);                ///   (Send) 0 --> 1
-                X_Data.Recv_from_right_X(Y, RNx);           /// (Receive) 0 <-- 1
-            } else if (RANK() == MPI_Processes() - 1) {               ///        // Update node "MPI_Processes()" in the x direction
-                X_Data.Send_right_X(Y, 0);                  //   (Send) 0 --> 1
-                X_Data.Recv_from_right_X(Y, 0);           /// (Receive) 0 <-- 1
-                X_Data.Recv_from_left_X(Y, LNx);          //          1 --> 0 (Receive)
-                X_Data.Send_left_X(Y, LNx);               //          1 <-- 0 (Send)
+                }
             }
-
         }
-        else {
-            cout << "Invalid Boundary." << endl;
-        }
-
-//            //odd nodes
-//        else {
-//            X_Data.Recv_from_left_X(Y,LNx);               //           0 --> 1 (Receive)
-//            if ((RANK()!=(MPI_Processes()-1)) || (BNDX()==0)){
-//                X_Data.Send_right_X(Y,RNx);              //   (Send)  1 --> 0
-//                X_Data.Recv_from_right_X(Y,RNx);         // (Receive) 1 <-- 0
-//            }
-//            else {
-//                if (BNDX()==1) {
-//                    X_Data.mirror_bound_Xright(Y);        // Update node "N-1" in the x direction
-//                }
-//                else {
-//                    cout<<"Invalid Boundary." << endl;
-//                }
-//            }
-//            X_Data.Send_left_X(Y,LNx);                    //           0 <-- 1 (Send)
-//        }
-    } else { X_Data.sameNode_bound_X(Y); }
-
-}
-//--------------------------------------------------------------
+    }
 
-//**************************************************************
-//--------------------------------------------------------------
-    Node_ImplicitE_Communications_2D:: Node_ImplicitE_Communications_2D() : 
-//--------------------------------------------------------------
-//  Constructor
-//--------------------------------------------------------------
-        Nbc(Input::List().BoundaryCells),      // # of boundary cells
-        bndX(Input::List().bndX),        // Type of boundary in X
-        bndY(Input::List().bndY),
-        Nx_local(Input::List().NxLocal[0]),
-        Ny_local(Input::List().NxLocal[1]) {       // Type of boundary in X
-     
-        // 3 components for Bx, By, Bz
-        msg_sizeX = 3;  
-        msg_sizeY = 3;  
-        
-        msg_sizeX *= Nbc * Ny_local;   
-        msg_sizeY *= Nbc * Nx_local;   
-        msg_bufX = new complex<double>[msg_sizeX];
-        msg_bufY = new complex<double>[msg_sizeY];
+    // Fields:   x0 "Left-Bound ---> Right-Guard"
+    for(size_t i(0); i < Y.EMF().dim(); ++i) {
+        for(size_t c(0); c < Nbc; c++) {
+            // if (i == 0)                 std::cout << "\n 4: FLD(" << i << "," << Y.EMF().Ex().numx()-Nbc+c << ") = " << Y.FLD(i)(Y.EMF().Ex().numx()-Nbc+c) << "\n";
+            Y.FLD(i)(Y.EMF().Ex().numx()-Nbc+c) = Y.FLD(i)(Nbc+c);
+            // if (i == 0)                 std::cout << "\n 4n: FLD(" << i << "," << Y.EMF().Ex().numx()-Nbc+c << ") = " << Y.FLD(i)(Y.EMF().Ex().numx()-Nbc+c) << "\n";
 
-    }
-//--------------------------------------------------------------
 
-//--------------------------------------------------------------
-    Node_ImplicitE_Communications_2D:: ~Node_ImplicitE_Communications_2D(){
-//--------------------------------------------------------------
-//  Destructor
-//--------------------------------------------------------------
-        delete[] msg_bufX;
-        delete[] msg_bufY;
+        }
+        // Y.FLD(i)(Y.EMF().Ex().numx()-1) = 0.0;
     }
-//--------------------------------------------------------------
 
-//--------------------------------------------------------------
-    int Node_ImplicitE_Communications_2D:: BNDX()  const {return bndX;} 
-//--------------------------------------------------------------
-//--------------------------------------------------------------
-    int Node_ImplicitE_Communications_2D:: BNDY()  const {return bndY;} 
-//--------------------------------------------------------------
-//--------------------------------------------------------------
-
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-//  Send and receive in the X direction
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-
-//--------------------------------------------------------------
-    void Node_ImplicitE_Communications_2D::Send_right_X(State2D& Y, int dest) {
-//--------------------------------------------------------------
-//  X-axis : Read data from the right boundary and send them 
-//           to the node on the right
-//--------------------------------------------------------------
+    if (Input::List().hydromotion)
+    {
+        // Hydro Quantities:   x0 "Right-Bound ---> Left-Guard"
+        for(size_t c(0); c < Nbc; c++) {
+            Y.HYDRO().density(c) = Y.HYDRO().density(Y.EMF().Ex().numx()-2*Nbc+c);
+            Y.HYDRO().vx(c) = Y.HYDRO().vx(Y.EMF().Ex().numx()-2*Nbc+c);
+            Y.HYDRO().vy(c) = Y.HYDRO().vy(Y.EMF().Ex().numx()-2*Nbc+c);
+            Y.HYDRO().vz(c) = Y.HYDRO().vz(Y.EMF().Ex().numx()-2*Nbc+c);
+            Y.HYDRO().temperature(c) = Y.HYDRO().temperature(Y.EMF().Ex().numx()-2*Nbc+c);
+            Y.HYDRO().Z(c) = Y.HYDRO().Z(Y.EMF().Ex().numx()-2*Nbc+c);
+        }
 
-        static size_t step_f(Nbc);
-        size_t bufind(0);
+        // Hydro Quantities:   x0 "Left-Bound ---> Right-Guard"
+        for(size_t c(0); c < Nbc; c++) {
+            Y.HYDRO().density(Y.EMF().Ex().numx()-Nbc+c) =  Y.HYDRO().density(Nbc+c);
+            Y.HYDRO().vx(Y.EMF().Ex().numx()-Nbc+c) =  Y.HYDRO().vx(Nbc+c);
+            Y.HYDRO().vy(Y.EMF().Ex().numx()-Nbc+c) =  Y.HYDRO().vy(Nbc+c);
+            Y.HYDRO().vz(Y.EMF().Ex().numx()-Nbc+c) =  Y.HYDRO().vz(Nbc+c);
+            Y.HYDRO().temperature(Y.EMF().Ex().numx()-Nbc+c) =  Y.HYDRO().temperature(Nbc+c);
+            Y.HYDRO().Z(Y.EMF().Ex().numx()-Nbc+c) =  Y.HYDRO().Z(Nbc+c);
+        }
+    }
 
-        // Fields:   x0 "Right-Bound --> "
-        
-        for(size_t i(3); i < Y.EMF().dim(); ++i){  // "3" as opposed to "0"
-            for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
-                for(size_t e(0); e < Nbc; e++) {
-                    msg_bufX[bufind + e] = Y.FLD(i)(Nx_local-2*Nbc+e,iy);
-                } 
-                bufind += step_f;
+    if (Input::List().particlepusher)
+    {
+        for (int ip(0); ip < Y.particles().numpar(); ++ip)
+        {
+            if (Y.particles().x(ip) > Input::List().xmaxLocalnobnd[0])
+            {
+                Y.particles().x(ip) = Input::List().xminLocalnobnd[0] + (Y.particles().x(ip) - Input::List().xmaxLocalnobnd[0]); 
+                Y.particles().ishere(ip) = 1;  
             }
-        } 
-
-        MPI_Send(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 0, MPI_COMM_WORLD);
+            else if (Y.particles().x(ip) < Input::List().xminLocalnobnd[0])
+            {
+                Y.particles().x(ip) = Input::List().xmaxLocalnobnd[0] - (Input::List().xminLocalnobnd[0] - Y.particles().x(ip));   
+                Y.particles().ishere(ip) = 1;
+            }
+        }
     }
+
+}
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-    void Node_ImplicitE_Communications_2D::Recv_from_left_X(State2D& Y, int origin) {
+void Node_Communications_1D::sameNode_mirror_X(State1D& Y) {
 //--------------------------------------------------------------
-//  X-axis : Receive data from the node on the left and update
-//           the left guard cells
+//  Mirror boundary in the x direction for 1 node
 //--------------------------------------------------------------
+    int sign(1);
+    size_t Nx(Y.SH(0,0,0).numx());
 
-        static size_t step_f(Nbc);
-        size_t bufind(0);
-        MPI_Status status; 
+    // Mirror the harmonics
+    for(size_t s(0); s < Y.Species(); ++s) {
+        for(size_t l(0); l < Y.DF(s).l0(); ++l){
+            for(size_t m(0); m < ((Y.DF(s).m0() < l)? Y.DF(s).m0():l)+1; ++m){
+                sign = 1-2*((l+m)%2);          //(-1)^(m+n)
 
-        // Receive Data
-        MPI_Recv(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 0, MPI_COMM_WORLD, &status);
+                // right boundary
+                for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
+                    for (size_t c(0); c < Nbc; ++c) {
+                        Y.SH(s,l,m)(p, Nx-c-1) = Y.SH(s,l,m)(p, Nx-2*Nbc+c);
+                        Y.SH(s,l,m)(p, Nx-c-1) *= sign;
+                    }
+                }
+
+                // left boundary
+                for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
+                    for (size_t c(0); c < Nbc; ++c) {
+                        Y.SH(s,l,m)(p, c) = Y.SH(s,l,m)(p, 2*Nbc-c-1);
+                        Y.SH(s,l,m)(p, c) *= sign;
+                    }
+                }
 
-        // Fields:   x0-"---> Left-Guard"
-        for(size_t i(3); i < Y.EMF().dim(); ++i){  // "3" as opposed to "0"
-            for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
-                for(size_t e(0); e < Nbc; e++) {
-                   Y.FLD(i)(e,iy) = msg_bufX[bufind + e];
-                }     
-                bufind += step_f;
             }
         }
     }
-//--------------------------------------------------------------
 
-//--------------------------------------------------------------
-    void Node_ImplicitE_Communications_2D::Send_left_X(State2D& Y, int dest) {
-//--------------------------------------------------------------
-//  X-axis : Read data from the left boundary and send them 
-//           to the node on the left 
-//--------------------------------------------------------------
+    // Mirror the fields
+    for(size_t i(0); i < Y.EMF().dim(); ++i){
+        // right boundary
+        for (size_t c(0); c < Nbc; ++c)
+            Y.FLD(i)(Nx-c-1) = Y.FLD(i)(Nx-2*Nbc+c);
+        // left boundary
+        for (size_t c(0); c < Nbc; ++c)
+            Y.FLD(i)(c) = Y.FLD(i)(2*Nbc-c-1);
+    }
 
-        static size_t step_f(Nbc);
-        size_t bufind(0); 
+    for(size_t c(0); c < Nbc; c++) {
+        //Ey
+        Y.EMF().Ey()(Nx-Nbc+c) *= -1.0; // right boundary
+        Y.EMF().Ey()(c) *= -1.0;  // left  boundary
 
-        // Fields:   x0 " <--- Left-Bound "
-        for(size_t i(3); i < Y.EMF().dim(); ++i){  // "3" as opposed to "0"
-            for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
-                for(size_t e(0); e < Nbc; e++) {
-                   msg_bufX[bufind + e] = Y.FLD(i)(Nbc+e,iy);
-                } 
-                
-                bufind += step_f;
-            }
-        }
+        //Ez
+        Y.EMF().Ez()(Nx-Nbc+c) *= -1.0; // right boundary
+        Y.EMF().Ez()(c) *= -1.0;  // left  boundary
 
-        MPI_Send(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 1, MPI_COMM_WORLD);
+        //Bx
+        Y.EMF().Bx()(Nx-Nbc+c) *= -1.0; // right boundary
+        Y.EMF().Bx()(c) *= -1.0;  // left  boundary
     }
-//--------------------------------------------------------------
 
-//--------------------------------------------------------------
-    void Node_ImplicitE_Communications_2D::Recv_from_right_X(State2D& Y, int origin) {
-//--------------------------------------------------------------
-//  X-axis : Receive data from the node on the right and update
-//           the right guard cells
-//--------------------------------------------------------------
 
-        static size_t step_f(Nbc);
-        size_t bufind(0);
-        MPI_Status status; 
+    if (Input::List().hydromotion)
+    {
+        // Hydro Quantities:   x0 "Right-Bound ---> Left-Guard"
+        for(size_t c(0); c < Nbc; c++) {
+            Y.HYDRO().vx(c) *= -1.0;
+        }
+
+        // Hydro Quantities:   x0 "Left-Bound ---> Right-Guard"
+        for(size_t c(0); c < Nbc; c++) {
+            Y.HYDRO().vx(Y.EMF().Ex().numx()-Nbc+c) *= -1.0;
 
-        // Receive Data
-        MPI_Recv(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 1, MPI_COMM_WORLD, &status);
 
-        // Fields:   x0-"Right-Guard <--- "
-        for(size_t i(3); i < Y.EMF().dim(); ++i){  // "3" as opposed to "0"
-            for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
-                for(size_t e(0); e < Nbc; e++) {
-                   Y.FLD(i)(Nx_local-Nbc+e,iy) = msg_bufX[bufind + e];
-                } 
-                bufind += step_f;
-            }
         }
     }
-//--------------------------------------------------------------
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-//  Send and receive in the Y direction
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-
-//--------------------------------------------------------------
-    void Node_ImplicitE_Communications_2D::Send_right_Y(State2D& Y, int dest) {
-//--------------------------------------------------------------
-//  Y-axis : Read data from the right boundary and send them 
-//           to the node on the right
-//--------------------------------------------------------------
 
-        static size_t step_f(Nbc);
-        size_t bufind(0);
-
-        // Fields:   x0 "Right-Bound --> "
-        
-        for(size_t i(3); i < Y.EMF().dim(); ++i){  // "3" as opposed to "0"
-            for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
-                for(size_t e(0); e < Nbc; e++) {
-                    msg_bufY[bufind + e] = Y.FLD(i)(ix,Ny_local-2*Nbc+e);
-                } 
-                bufind += step_f;
+    if (Input::List().particlepusher)
+    {
+        for (int ip(0); ip < Y.particles().numpar(); ++ip)
+        {
+            if (Y.particles().x(ip) > Input::List().xmaxLocalnobnd[0])
+            {
+                Y.particles().x(ip) = Input::List().xmaxLocalnobnd[0] - (Y.particles().x(ip) - Input::List().xmaxLocalnobnd[0]);
+                Y.particles().px(ip) *= -1.0;
+            }
+            else if (Y.particles().x(ip) < Input::List().xminLocalnobnd[0])
+            {
+                Y.particles().x(ip) = Input::List().xminLocalnobnd[0] + (Input::List().xminLocalnobnd[0] - Y.particles().x(ip));
+                Y.particles().px(ip) *= -1.0;
             }
-        } 
 
-        MPI_Send(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, dest, 0, MPI_COMM_WORLD);
+        }
     }
-//--------------------------------------------------------------
 
-//--------------------------------------------------------------
-    void Node_ImplicitE_Communications_2D::Recv_from_left_Y(State2D& Y, int origin) {
-//--------------------------------------------------------------
-//  X-axis : Receive data from the node on the left and update
-//           the left guard cells
+}
 //--------------------------------------------------------------
 
-        static size_t step_f(Nbc);
-        size_t bufind(0);
-        MPI_Status status; 
 
-        // Receive Data
-        MPI_Recv(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, origin, 0, MPI_COMM_WORLD, &status);
+//**************************************************************
+//**************************************************************
+//   Definition of the Parallel Environment
+//**************************************************************
+//**************************************************************
 
-        // Fields:   x0-"---> Left-Guard"
-        for(size_t i(3); i < Y.EMF().dim(); ++i){  // "3" as opposed to "0"
-            for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
-                for(size_t e(0); e < Nbc; e++) {
-                   Y.FLD(i)(ix,e) = msg_bufY[bufind + e];
-                }     
-                bufind += step_f;
-            }
-        }
-    }
-//--------------------------------------------------------------
 
 //--------------------------------------------------------------
-    void Node_ImplicitE_Communications_2D::Send_left_Y(State2D& Y, int dest) {
+Parallel_Environment_1D:: Parallel_Environment_1D(const vector<size_t>& xcuts) :
 //--------------------------------------------------------------
-//  X-axis : Read data from the left boundary and send them 
-//           to the node on the left 
+//  Constructor, domain decomposition. Without cuts the cells are
+//  split equally, otherwise node r owns [xcuts[r], xcuts[r+1])
 //--------------------------------------------------------------
-
-        static size_t step_f(Nbc);
-        size_t bufind(0); 
-
-        // Fields:   x0 " <--- Left-Bound "
-        for(size_t i(3); i < Y.EMF().dim(); ++i){  // "3" as opposed to "0"
-            for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
-                for(size_t e(0); e < Nbc; e++) {
-                   msg_bufY[bufind + e] = Y.FLD(i)(ix,Nbc+e);
-                } 
-                
-                bufind += step_f;
-            }
-        }
-
-        MPI_Send(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, dest, 1, MPI_COMM_WORLD);
+        bndX(Input::List().bndX),           // Type of boundary
+        MPI_Procs(Input::List().MPI_X[0])   // Number of nodes in X-direction
+{
+    // Determination of the rank and size of the run
+    MPI_Comm_size(Harmonic_Group::Space(), &MPI_Procs);
+    MPI_Comm_rank(Harmonic_Group::Space(), &rank);
+
+    // Cells of this node
+    if (xcuts.size() == size_t(MPI_Procs) + 1) {
+        Input::List().NxLocalnobnd[0] = xcuts[rank+1] - xcuts[rank];
+        Input::List().NxLocal[0]      = Input::List().NxLocalnobnd[0] + 2 * Input::List().BoundaryCells;
+        Input::List().NxOffset[0]     = xcuts[rank];
     }
-//--------------------------------------------------------------
+    else Input::List().NxOffset[0] = rank * Input::List().NxLocalnobnd[0];
 
-//--------------------------------------------------------------
-    void Node_ImplicitE_Communications_2D::Recv_from_right_Y(State2D& Y, int origin) {
-//--------------------------------------------------------------
-//  X-axis : Receive data from the node on the right and update
-//           the right guard cells
-//--------------------------------------------------------------
+    if (error_check()) 
+    {
+        std::cout << "PE error check failed" << std::endl;
+        MPI_Finalize(); exit(1);
+    }
 
-        static size_t step_f(Nbc);
-        size_t bufind(0);
-        MPI_Status status; 
+    // Determination of the local computational domain (i.e. the x-axis and the y-axis)
+    for(size_t i(0); i < Input::List().xminLocal.size(); ++i) {
 
-        // Receive Data
-        MPI_Recv(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, origin, 1, MPI_COMM_WORLD, &status);
+        Input::List().xminLocal[i] = Input::List().xminGlobal[i]
+                                     + Input::List().NxOffset[i] * Input::List().globdx[i]
+                                     - Input::List().BoundaryCells * Input::List().globdx[i];
+        Input::List().xmaxLocal[i] = Input::List().xminLocal[i]
+                                     + (Input::List().NxLocal[i]) * Input::List().globdx[i];
 
-        // Fields:   x0-"Right-Guard <--- "
-        for(size_t i(3); i < Y.EMF().dim(); ++i){  // "3" as opposed to "0"
-            for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
-                for(size_t e(0); e < Nbc; e++) {
-                   Y.FLD(i)(ix,Ny_local-Nbc+e) = msg_bufY[bufind + e];
-                } 
-                bufind += step_f;
-            }
-        }
-    }
-//--------------------------------------------------------------
+        Input::List().xminLocalnobnd[i] = Input::List().xminLocal[i] + Input::List().BoundaryCells * Input::List().globdx[i];
+        Input::List().xmaxLocalnobnd[i] = Input::List().xmaxLocal[i] - Input::List().BoundaryCells * Input::List().globdx[i];
 
+    }
 
-//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-//  Boundary conditions
-//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-//  Mirror conditions on one side
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+    double  xval_lastcell = Input::List().xmaxLocal[0] - 0.5*Input::List().globdx[0];
+    double xval_firstcell = Input::List().xminLocal[0] + 0.5*Input::List().globdx[0];
 
-//*************************************************************************************
-//-------------------------------------------------------------------------------------
-    void Node_ImplicitE_Communications_2D::mirror_bound_Xleft(State2D& Y) {
-//-------------------------------------------------------------------------------------
-//  Mirror boundary in the x direction on the left
-//-------------------------------------------------------------------------------------
+    
+    // Restart files will be generated when output_step % restart_step == 0
+//          if ( ( (Input::List().n_outsteps + 1) >  Input::List().n_restarts ) &&
+//                (Input::List().n_restarts > 0)  ) { 
+//               restart_step = Input::List().n_outsteps / Input::List().n_restarts ;
+//          } 
+//          else restart_step = -1;
+//          if ( Input::List().restart_time > Input::List().n_restarts ) {
+//              restart_time = 0; 
+//          }
+//          else restart_time = Input::List().restart_time;
 
+}
+//--------------------------------------------------------------
+//  Destructor
+//--------------------------------------------------------------
+Parallel_Environment_1D:: ~Parallel_Environment_1D(){ }
+//--------------------------------------------------------------
 
+//--------------------------------------------------------------
+bool Parallel_Environment_1D:: error_check() {
+//--------------------------------------------------------------
+//  Temporary error check
+//--------------------------------------------------------------
 
-        // Mirror the fields 
-        for (size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
-            for(size_t iy(0); iy < Ny_local; ++iy){  // All the x cells                
-                for (size_t c(0); c < Nbc; ++c) {
-                    Y.FLD(i)(c,iy) = Y.FLD(i)(2*Nbc-c-1,iy);
-                }
-            }
+    // Test the number of cells
+    if (rank == 0){
+        if (Input::List().NxLocal[0] < 2*Input::List().BoundaryCells+2){
+            std::cout << "Not enough cells per processor" << endl;
+            return true;
         }
-
-        //Bx
-        for(size_t iy(0); iy < Ny_local; ++iy){  // All the x cells                
-            for (size_t c(0); c < Nbc; ++c) {
-               Y.EMF().Bx()(c,iy) *= -1.0; // left  boundary
-            }
+        if ( MPI_Procs != (Input::List().MPI_X[0]) ) {
+            std:: cout << "the number of nodes in the input deck is "
+                       << (Input::List().MPI_X[0]) << ", terminating ..." << endl;
+            return true;
         }
-
     }
-//-------------------------------------------------------------------------------------
+    return false;
+}
+//--------------------------------------------------------------
 
 //--------------------------------------------------------------
-    void Node_ImplicitE_Communications_2D::mirror_bound_Xright(State2D& Y) {
+//  Basic information
 //--------------------------------------------------------------
-//  Mirror boundary in the x direction on the right
+int Parallel_Environment_1D:: RANK()  const {return rank;}
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+int Parallel_Environment_1D:: MPI_Processes() const {return MPI_Procs;}
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+int Parallel_Environment_1D:: BNDX()  const {return bndX;}
 //--------------------------------------------------------------
 
 
+//--------------------------------------------------------------
+void Parallel_Environment_1D::Neighbor_ImplicitE_Communications(State1D& Y){
+//--------------------------------------------------------------
+//  Information exchange between neighbors 
+//--------------------------------------------------------------
 
-        // Mirror the fields 
-        for (size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
-            for(size_t iy(0); iy < Ny_local; ++iy){  // All the x cells
-                for (size_t c(0); c < Nbc; ++c){ 
-                    Y.FLD(i)(Nx_local-c-1,iy) = Y.FLD(i)(Nx_local-2*Nbc+c,iy);
-                }       
+    int moduloX(RANK()%2);
+    int RNx((RANK()+1)%MPI_Processes()),         // This is the right neighbor
+            LNx((RANK()-1+MPI_Processes())%MPI_Processes()); // This is the left  neighbor
+
+    if (MPI_Processes() > 1) {
+        //even nodes
+        if (moduloX==0){
+            Bfield_Data.Send_right_X(Y,RNx);                  //   (Send) 0 --> 1
+            if ((RANK() != 0) || (BNDX()==0)){
+                Bfield_Data.Recv_from_left_X(Y,LNx);          //          1 --> 0 (Receive)
+                Bfield_Data.Send_left_X(Y,LNx);               //          1 <-- 0 (Send)
             }
+            else {
+                if (BNDX()==1) {
+                    Bfield_Data.mirror_bound_Xleft(Y);        // Update node "0" in the x direction
+                }
+                else {
+                    cout<<"Invalid Boundary." << endl;
+                }
+            }
+            Bfield_Data.Recv_from_right_X(Y,RNx);               // (Receive) 0 <-- 1
         }
-
-        //Bx
-        for(size_t iy(0); iy < Ny_local; ++iy){  // All the x cells                
-            for (size_t c(0); c < Nbc; ++c) {
-                Y.EMF().Bx()(Nx_local-1-c,iy) *= -1.0; // right  boundary
+            //odd nodes 
+        else {
+            Bfield_Data.Recv_from_left_X(Y,LNx);               //           0 --> 1 (Receive)
+            if ((RANK()!=(MPI_Processes()-1)) || (BNDX()==0)){
+                Bfield_Data.Send_right_X(Y,RNx);              //   (Send)  1 --> 0
+                Bfield_Data.Recv_from_right_X(Y,RNx);         // (Receive) 1 <-- 0
+            }
+            else {
+                if (BNDX()==1) {
+                    Bfield_Data.mirror_bound_Xright(Y);        // Update node "N-1" in the x direction
+                }
+                else {
+                    cout<<"Invalid Boundary." << endl;;
+                }
             }
+            Bfield_Data.Send_left_X(Y,LNx);                    //           0 <-- 1 (Send)
         }
-
     }
-//--------------------------------------------------------------
+    else { Bfield_Data.sameNode_bound_X(Y); }
 
-//-------------------------------------------------------------------------------------
-    void Node_ImplicitE_Communications_2D::mirror_bound_Yleft(State2D& Y) {
-//-------------------------------------------------------------------------------------
-//  Mirror boundary in the x direction on the left
-//-------------------------------------------------------------------------------------
+}
+//--------------------------------------------------------------
 
-        
 
-        // Mirror the fields 
-        for (size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
-            for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
-                for (size_t c(0); c < Nbc; ++c) {
-                    Y.FLD(i)(ix,c) = Y.FLD(i)(ix,2*Nbc-c-1);
-                }
-            }
-        }
+//--------------------------------------------------------------
+void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
+//--------------------------------------------------------------
+//  Information exchange between neighbors 
+//--------------------------------------------------------------
 
-        //Bx
-        for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
-            for (size_t c(0); c < Nbc; ++c) {
-                Y.EMF().By()(ix,c) *= -1.0; // left  boundary
-            }
-        }
+    Neighbor_Communications_Post(Y);
+    Neighbor_Communications_Complete(Y);
 
-    }
-//-------------------------------------------------------------------------------------
+}
+//--------------------------------------------------------------
 
 //--------------------------------------------------------------
-    void Node_ImplicitE_Communications_2D::mirror_bound_Yright(State2D& Y) {
+void Parallel_Environment_1D::Neighbor_Communications_Post(State1D& Y) {
 //--------------------------------------------------------------
-//  Mirror boundary in the x direction on the right
+//  Post the exchange between neighbors. The physical boundaries 
+//  are updated here, the guard cells from the neighbors are only 
+//  valid after Neighbor_Communications_Complete
 //--------------------------------------------------------------
 
+    int RNx((RANK() + 1) % MPI_Processes()),         // This is the right neighbor
+            LNx((RANK() - 1 + MPI_Processes()) % MPI_Processes()); // This is the left  neighbor
 
-
-        // Mirror the fields 
-        for (size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
-            for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
-                for (size_t c(0); c < Nbc; ++c) {
-                    Y.FLD(i)(ix,Ny_local-c-1) = Y.FLD(i)(ix,Ny_local-2*Nbc+c);
-                }
+    if (MPI_Processes() > 1) {
+        if (BNDX() == 1) {
+            if (RANK() == 0) {                                  /// Update node "0" in the x direction
+                X_Data.mirror_bound_Xleft(Y);
+                LNx = -1;
             }
-        }
-
-        //Bx
-        for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
-            for (size_t c(0); c < Nbc; ++c) {
-                Y.EMF().By()(ix,Ny_local-1-c) *= -1.0; // right  boundary
+            if (RANK() == MPI_Processes() - 1) {                /// Update node "MPI_Processes()" in the x direction
+                X_Data.mirror_bound_Xright(Y);
+                RNx = -1;
             }
         }
+        else if ((BNDX() != 0) && (BNDX() != 2)) {
+            cout << "Invalid Boundary." << endl;
+            return;
+        }
 
-    }
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-//  Boundary conditions on both sides of a node
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+        X_Data.Post_X(Y, LNx, RNx);
+
+    } else { X_Data.sameNode_bound_X(Y); }
 
+}
 //--------------------------------------------------------------
-    void Node_ImplicitE_Communications_2D::sameNode_bound_X(State2D& Y) {
+
 //--------------------------------------------------------------
-//  Choose between boundary conditions in the x direction
+void Parallel_Environment_1D::Neighbor_Communications_Complete(State1D& Y) {
+//--------------------------------------------------------------
+//  Wait for the exchange between neighbors and update the guard cells
 //--------------------------------------------------------------
-        switch (BNDX()) {
-            case 0:                   // periodic
-                sameNode_periodic_X(Y);
 
-                break;
-            case 1:                   // mirror boundary
-                sameNode_mirror_X(Y);
-                break;
-            default:
-                cout<<"Not a valid boundary condition." << endl;
-                break;
-        }
+    if (MPI_Processes() > 1) {
+        X_Data.Complete_X(Y);
+
+        if (BNDX() == 0) Y.particles().par_goingright_array() = 0.0;
     }
+
+}
 //--------------------------------------------------------------
 
+//**************************************************************
 //--------------------------------------------------------------
-    void Node_ImplicitE_Communications_2D::sameNode_periodic_X(State2D& Y) {
+    Node_ImplicitE_Communications_2D:: Node_ImplicitE_Communications_2D(MPI_Comm comm_cart) : 
 //--------------------------------------------------------------
-//  Periodic boundary in the x direction for 1 node
+//  Constructor
 //--------------------------------------------------------------
-
-        // Fields:   x0 "Right-Bound ---> Left-Guard"
-        for (size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
-            for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
-                for (size_t c(0); c < Nbc; c++) {
-                    Y.FLD(i)(c,iy) = Y.FLD(i)(Nx_local-2*Nbc+c,iy);
-                }
-            }
-        }
-
-        // Fields:   x0 "Left-Bound ---> Right-Guard"
-        for (size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
-            for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
-                for (size_t c(0); c < Nbc; c++) {
-                    Y.FLD(i)(Nx_local-Nbc+c,iy) = Y.FLD(i)(Nbc+c,iy);
-                }
-            }
-        }
-       
-    }
-//--------------------------------------------------------------
-
-//--------------------------------------------------------------
-    void Node_ImplicitE_Communications_2D::sameNode_mirror_X(State2D& Y) {
-//--------------------------------------------------------------
-//  Mirror boundary in the x direction for 1 node
-//--------------------------------------------------------------
- 
-
-
-        // Mirror the fields 
-        for (size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
-           for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
-               // right boundary
-               for (size_t c(0); c < Nbc; ++c) 
-                   Y.FLD(i)(Nx_local-c-1,iy) = Y.FLD(i)(Nx_local-2*Nbc+c,iy);
-               // left boundary
-               for (size_t c(0); c < Nbc; ++c) 
-                  Y.FLD(i)(c,iy) = Y.FLD(i)(2*Nbc-c-1,iy);
-          }
-        }
-
-        //Bx
-        for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
-            for (size_t c(0); c < Nbc; ++c) {
-                Y.EMF().Bx()(c,iy) *= -1.0; // left  boundary
-                Y.EMF().Bx()(Nx_local-Nbc+c,iy) *= -1.0; // right  boundary
-            }
-        }
-
-    }
-//--------------------------------------------------------------
-//--------------------------------------------------------------
-    void Node_ImplicitE_Communications_2D::sameNode_bound_Y(State2D& Y) {
-//--------------------------------------------------------------
-//  Choose between boundary conditions in the x direction
-//--------------------------------------------------------------
-        switch (BNDY()) {
-            case 0:                   // periodic
-                sameNode_periodic_Y(Y);
-
-                break;
-            case 1:                   // mirror boundary
-                sameNode_mirror_Y(Y);
-                break;
-            default:
-                cout<<"Not a valid boundary condition." << endl;
-                break;
-        }
-    }
-//--------------------------------------------------------------
-
-//--------------------------------------------------------------
-    void Node_ImplicitE_Communications_2D::sameNode_periodic_Y(State2D& Y) {
-//--------------------------------------------------------------
-//  Periodic boundary in the x direction for 1 node
-//--------------------------------------------------------------
-
-        // Fields:   x0 "Right-Bound ---> Left-Guard"
-        for (size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
-            for(size_t ix(0); ix < Nx_local; ++ix){  // All the y cells
-                for (size_t c(0); c < Nbc; c++) {
-                    Y.FLD(i)(ix,c) = Y.FLD(i)(ix,Ny_local-2*Nbc+c);
-                }
-            }
-        }
-
-        // Fields:   x0 "Left-Bound ---> Right-Guard"
-        for (size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
-            for(size_t ix(0); ix < Nx_local; ++ix){  // All the y cells
-                for (size_t c(0); c < Nbc; c++) {
-                    Y.FLD(i)(ix,Ny_local-Nbc+c) = Y.FLD(i)(ix,Nbc+c);
-                }
-            }
-        }
-       
-    }
-//--------------------------------------------------------------
-
-//--------------------------------------------------------------
-    void Node_ImplicitE_Communications_2D::sameNode_mirror_Y(State2D& Y) {
-//--------------------------------------------------------------
-//  Mirror boundary in the x direction for 1 node
-//--------------------------------------------------------------
- 
-
-
-        // Mirror the fields 
-        for (size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
-           for(size_t ix(0); ix < Nx_local; ++ix){  // All the y cells
-               // right boundary
-               for (size_t c(0); c < Nbc; ++c) 
-                   Y.FLD(i)(ix,Ny_local-c-1) = Y.FLD(i)(ix,Ny_local-2*Nbc+c);
-               // left boundary
-               for (size_t c(0); c < Nbc; ++c) 
-                  Y.FLD(i)(ix,c) = Y.FLD(i)(ix,2*Nbc-c-1);
-          }
-        }
-
-        //Bx
-        for(size_t ix(0); ix < Nx_local; ++ix){  // All the y cells
-            for (size_t c(0); c < Nbc; ++c) {
-                Y.EMF().By()(ix,c) *= -1.0; // left  boundary
-                Y.EMF().By()(ix,Ny_local-Nbc+c) *= -1.0; // right  boundary
-            }
-        }
-
-    }
-//--------------------------------------------------------------
-
-//**************************************************************
-//**************************************************************
-//  Definition of the Nodes Communications class
-//**************************************************************
-//**************************************************************
-
-
-//**************************************************************
-//--------------------------------------------------------------
-    Node_Communications_2D:: Node_Communications_2D() : 
-//--------------------------------------------------------------
-//  Constructor
-//--------------------------------------------------------------
-        Nbc(Input::List().BoundaryCells),      // # of boundary cells
-        bndX(Input::List().bndX),
-        bndY(Input::List().bndY),
-        Nx_local(Input::List().NxLocal[0]),
-        Ny_local(Input::List().NxLocal[1]){        // Type of boundary in X
-         
-        numspec = Input::List().ls.size();
-        // numpmax = Input::List().ps;
-
-        double temp;
-
-        // # of harmonics
-        msg_sizeX = 0; msg_sizeY = 0; temp = 0;
-        for (size_t s(0); s < numspec; ++s) {
-            temp = ((Input::List().ms[s]+1)*(2*Input::List().ls[s]-Input::List().ms[s]+2))/2;
-            msg_sizeX += temp*(Input::List().dp[s]).size();
-        }
-        // (# of harmonics) * (# cells in p)
-        // msg_sizeX *= numpmax
-        // 6 fields: Ex, Ey, Ez, Bx, By, Bz
-        msg_sizeX += 6;  
-        msg_sizeY  = msg_sizeX;  
-
-        // 5 Hydro Quantities, density, vel, temp
-        // if (Input::List().hydromotion)
-        // {
-        //     msg_sizeX += 3;
-        // }
-        
-        msg_sizeX *= Nbc*Input::List().NxLocal[1];   
-        msg_bufX = new complex<double>[msg_sizeX];
-
-        msg_sizeY *= Nbc*Input::List().NxLocal[0];   
-        msg_bufY = new complex<double>[msg_sizeY];
+        Nbc(Input::List().BoundaryCells),      // # of boundary cells
+        bndX(Input::List().bndX),        // Type of boundary in X
+        bndY(Input::List().bndY),
+        Nx_local(Input::List().NxLocal[0]),
+        Ny_local(Input::List().NxLocal[1]),
+        comm(comm_cart) {       // Type of boundary in X
+     
+        // 3 components for Bx, By, Bz
+        msg_sizeX = 3;  
+        msg_sizeY = 3;  
+        
+        msg_sizeX *= Nbc * Ny_local;   
+        msg_sizeY *= Nbc * Nx_local;   
+        msg_bufX = new complex<double>[msg_sizeX];
+        msg_bufY = new complex<double>[msg_sizeY];
 
     }
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-    Node_Communications_2D:: ~Node_Communications_2D(){
+    Node_ImplicitE_Communications_2D:: ~Node_ImplicitE_Communications_2D(){
 //--------------------------------------------------------------
 //  Destructor
 //--------------------------------------------------------------
@@ -2008,10 +1899,10 @@ void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-    int Node_Communications_2D:: BNDX()  const {return bndX;} 
+    int Node_ImplicitE_Communications_2D:: BNDX()  const {return bndX;} 
 //--------------------------------------------------------------
 //--------------------------------------------------------------
-    int Node_Communications_2D:: BNDY()  const {return bndY;} 
+    int Node_ImplicitE_Communications_2D:: BNDY()  const {return bndY;} 
 //--------------------------------------------------------------
 //--------------------------------------------------------------
 
@@ -2020,215 +1911,97 @@ void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
 //--------------------------------------------------------------
-    void Node_Communications_2D::Send_right_X(State2D& Y, int dest) {
+    void Node_ImplicitE_Communications_2D::Send_right_X(State2D& Y, int dest) {
 //--------------------------------------------------------------
 //  X-axis : Read data from the right boundary and send them 
 //           to the node on the right
 //--------------------------------------------------------------
 
-        // static size_t step_h(numpmax*Nbc);
         static size_t step_f(Nbc);
         size_t bufind(0);
 
-        // Harmonics:x0 "Right-Bound ---> " 
-        for (size_t s(0); s < Y.Species(); ++s) {
-            for(size_t i(0); i < Y.DF(s).dim(); ++i){
-                for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
-                    for (size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                        for (size_t e(0); e < Nbc; e++) {
-                          msg_bufX[bufind + e] = (Y.DF(s)(i))(p, Nx_local-2*Nbc+e,iy);
-                        }
-                        bufind += step_f;
-                    }
-                } 
-            }
-        }
         // Fields:   x0 "Right-Bound --> "
-        for(size_t i(0); i < Y.EMF().dim(); ++i){
+        
+        for(size_t i(3); i < Y.EMF().dim(); ++i){  // "3" as opposed to "0"
             for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
-                for (size_t e(0); e < Nbc; e++) {
+                for(size_t e(0); e < Nbc; e++) {
                     msg_bufX[bufind + e] = Y.FLD(i)(Nx_local-2*Nbc+e,iy);
-                }
-               bufind += step_f;
-            } 
-         } 
-        
-      //   if (Input::List().hydromotion)
-      //   {
-      //       // Hydro-velocity:   x0 "Right-Bound --> "
-      //       for (size_t e(0); e < Nbc; e++) {
-      //           msg_bufX[bufind + e] = Y.HYDRO().density(Nx_local-2*Nbc+e);
-      //       } 
-      //       bufind += step_f;
-      //       // Hydro-velocity:   x0 "Right-Bound --> "
-            // for (size_t e(0); e < Nbc; e++) {
-            //  msg_bufX[bufind + e] = Y.HYDRO().velocity(Nx_local-2*Nbc+e);
-            // } 
-            // bufind += step_f;
-
-      //       // Hydro-temperature:   x0 "Right-Bound --> "
-            // for (size_t e(0); e < Nbc; e++) {
-            //  msg_bufX[bufind + e] = Y.HYDRO().temperature(Nx_local-2*Nbc+e);
-            // } 
-            // bufind += step_f;
-        // }
-        MPI_Send(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 0, MPI_COMM_WORLD);
+                } 
+                bufind += step_f;
+            }
+        } 
+
+        MPI_Send(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 0, comm);
     }
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-    void Node_Communications_2D::Recv_from_left_X(State2D& Y, int origin) {
+    void Node_ImplicitE_Communications_2D::Recv_from_left_X(State2D& Y, int origin) {
 //--------------------------------------------------------------
 //  X-axis : Receive data from the node on the left and update
 //           the left guard cells
 //--------------------------------------------------------------
 
-        // static size_t step_h(Y.SH(s,0,0).nump()*Nbc);
         static size_t step_f(Nbc);
         size_t bufind(0);
         MPI_Status status; 
 
         // Receive Data
-        MPI_Recv(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 0, MPI_COMM_WORLD, &status);
-
-        // Harmonics:x0-"---> Left-Guard" 
-        for (size_t s(0); s < Y.Species(); ++s) {
-            for (size_t i(0); i < Y.DF(s).dim(); ++i){
-                for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
-                    for (size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                        for (size_t e(0); e < Nbc; e++) {
-                            (Y.DF(s)(i))(p, e, iy) = msg_bufX[bufind + e];
-                        }
-                        bufind += step_f;
-                    }
-                }
-            } 
-        }
-
+        MPI_Recv(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 0, comm, &status);
 
         // Fields:   x0-"---> Left-Guard"
-        for (size_t i(0); i < Y.EMF().dim(); ++i){
+        for(size_t i(3); i < Y.EMF().dim(); ++i){  // "3" as opposed to "0"
             for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
-                for (size_t e(0); e < Nbc; e++) {
+                for(size_t e(0); e < Nbc; e++) {
                    Y.FLD(i)(e,iy) = msg_bufX[bufind + e];
-                } 
+                }     
                 bufind += step_f;
-            }            
+            }
         }
-
-        // if (Input::List().hydromotion)
-        // {
-        //     // Hydro-velocity:   x0-"---> Left-Guard"
-        //     for (size_t e(0); e < Nbc; e++) {
-        //         Y.HYDRO().density(e) = (msg_bufX[bufind + e]).real();
-        //     } 
-        //     bufind += step_f;        
-
-        //     // Hydro-velocity:   x0-"---> Left-Guard"
-        //     for (size_t e(0); e < Nbc; e++) {
-        //         Y.HYDRO().velocity(e) = (msg_bufX[bufind + e]).real();
-        //     } 
-        //     bufind += step_f;        
-            
-        //     // Hydro-temperature:   x0-"---> Left-Guard"        
-        //     for (size_t e(0); e < Nbc; e++) {
-        //         Y.HYDRO().temperature(e) = (msg_bufX[bufind + e]).real();
-        //     } 
-        //     bufind += step_f;   
-        // }     
-        
-        
     }
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-    void Node_Communications_2D::Send_left_X(State2D& Y, int dest) {
+    void Node_ImplicitE_Communications_2D::Send_left_X(State2D& Y, int dest) {
 //--------------------------------------------------------------
 //  X-axis : Read data from the left boundary and send them 
 //           to the node on the left 
 //--------------------------------------------------------------
 
-        // static size_t step_h(Y.SH(s,0,0).nump()*Nbc);
         static size_t step_f(Nbc);
         size_t bufind(0); 
 
-        // Harmonics:x0 " <--- Left-Bound "
-        for (size_t s(0); s < Y.Species(); ++s) {
-            for (size_t i(0); i < Y.DF(s).dim(); ++i){
-                for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
-                    for (size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                        for (size_t e(0); e < Nbc; e++) {
-                          msg_bufX[bufind + e] = (Y.DF(s)(i))(p, Nbc+e,iy);
-                        }
-                        bufind += step_f;
-                    }
-                }
-            } 
-        } 
         // Fields:   x0 " <--- Left-Bound "
-        for (size_t i(0); i < Y.EMF().dim(); ++i){
+        for(size_t i(3); i < Y.EMF().dim(); ++i){  // "3" as opposed to "0"
             for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
-                for (size_t e(0); e < Nbc; e++) {
-                    msg_bufX[bufind + e] = Y.FLD(i)(Nbc+e,iy);
+                for(size_t e(0); e < Nbc; e++) {
+                   msg_bufX[bufind + e] = Y.FLD(i)(Nbc+e,iy);
                 } 
+                
                 bufind += step_f;
             }
         }
 
-        // if (Input::List().hydromotion)
-        // {
-        //     // Hydro-velocity:   x0 " <--- Left-Bound "
-        //     for (size_t e(0); e < Nbc; e++) {
-        //         msg_bufX[bufind + e] = Y.HYDRO().density(Nbc+e);
-        //     } 
-        //     bufind += step_f;
-        //     // Hydro-velocity:   x0 " <--- Left-Bound "
-        //     for (size_t e(0); e < Nbc; e++) {
-        //         msg_bufX[bufind + e] = Y.HYDRO().velocity(Nbc+e);
-        //     } 
-        //     bufind += step_f;
-
-        //     // Hydro-temperature:   x0 " <--- Left-Bound "
-        //     for (size_t e(0); e < Nbc; e++) {
-        //         msg_bufX[bufind + e] = Y.HYDRO().temperature(Nbc+e);
-        //     } 
-        //     bufind += step_f;
-        // }
-
-        MPI_Send(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 1, MPI_COMM_WORLD);
+        MPI_Send(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 1, comm);
     }
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-    void Node_Communications_2D::Recv_from_right_X(State2D& Y, int origin) {
+    void Node_ImplicitE_Communications_2D::Recv_from_right_X(State2D& Y, int origin) {
 //--------------------------------------------------------------
 //  X-axis : Receive data from the node on the right and update
 //           the right guard cells
 //--------------------------------------------------------------
 
-        // static size_t step_h(Y.SH(s,0,0).nump()*Nbc);
         static size_t step_f(Nbc);
         size_t bufind(0);
         MPI_Status status; 
 
         // Receive Data
-        MPI_Recv(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 1, MPI_COMM_WORLD, &status);
+        MPI_Recv(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 1, comm, &status);
 
-        // Harmonics:x0-"Right-Guard <--- " 
-        for(size_t s(0); s < Y.Species(); ++s) {
-            for(size_t i(0); i < Y.DF(s).dim(); ++i){
-                for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
-                    for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                        for(size_t e(0); e < Nbc; e++) {
-                            (Y.DF(s)(i))(p, Nx_local-Nbc+e,iy) = msg_bufX[bufind + e];
-                        }
-                        bufind += step_f;
-                    }
-                }
-            } 
-        }
         // Fields:   x0-"Right-Guard <--- "
-        for(size_t i(0); i < Y.EMF().dim(); ++i){
+        for(size_t i(3); i < Y.EMF().dim(); ++i){  // "3" as opposed to "0"
             for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
                 for(size_t e(0); e < Nbc; e++) {
                    Y.FLD(i)(Nx_local-Nbc+e,iy) = msg_bufX[bufind + e];
@@ -2236,466 +2009,1302 @@ void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
                 bufind += step_f;
             }
         }
-
-      //   if (Input::List().hydromotion)
-      //   {
-      //       // Hydro-density:   x0-"Right-Guard <--- "
-      //       for(size_t e(0); e < Nbc; e++) {
-      //           Y.HYDRO().density(Nx_local-Nbc+e) = (msg_bufX[bufind + e]).real();
-      //       } 
-      //       bufind += step_f;
-
-      //       // Hydro-velocity:   x0-"Right-Guard <--- "
-            // for(size_t e(0); e < Nbc; e++) {
-            //  Y.HYDRO().velocity(Nx_local-Nbc+e) = (msg_bufX[bufind + e]).real();
-            // } 
-            // bufind += step_f;
-      //       // Hydro-temperature:   x0-"Right-Guard <--- "
-            // for(size_t e(0); e < Nbc; e++) {
-            //  Y.HYDRO().temperature(Nx_local-Nbc+e) = (msg_bufX[bufind + e]).real();
-            // } 
-            // bufind += step_f;
-      //   }
-        
     }
 //--------------------------------------------------------------
-
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 //  Send and receive in the Y direction
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
 //--------------------------------------------------------------
-    void Node_Communications_2D::Send_right_Y(State2D& Y, int dest) {
+    void Node_ImplicitE_Communications_2D::Send_right_Y(State2D& Y, int dest) {
 //--------------------------------------------------------------
-//  X-axis : Read data from the right boundary and send them 
+//  Y-axis : Read data from the right boundary and send them 
 //           to the node on the right
 //--------------------------------------------------------------
 
-        // static size_t step_h(numpmax*Nbc);
         static size_t step_f(Nbc);
         size_t bufind(0);
 
-        // Harmonics:x0 "Right-Bound ---> " 
-        for(size_t s(0); s < Y.Species(); ++s) {
-            for(size_t i(0); i < Y.DF(s).dim(); ++i){
-                for(size_t ix(0); ix < Nx_local; ++ix){  // All the y cells
-                    for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                        for(size_t e(0); e < Nbc; e++) {
-                          msg_bufY[bufind + e] = (Y.DF(s)(i))(p, ix, Ny_local-2*Nbc+e);
-                        }
-                        bufind += step_f;
-                    }
+        // Fields:   x0 "Right-Bound --> "
+        
+        for(size_t i(3); i < Y.EMF().dim(); ++i){  // "3" as opposed to "0"
+            for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
+                for(size_t e(0); e < Nbc; e++) {
+                    msg_bufY[bufind + e] = Y.FLD(i)(ix,Ny_local-2*Nbc+e);
                 } 
+                bufind += step_f;
             }
-        }
-        // Fields:   x0 "Right-Bound --> "
-        for(size_t i(0); i < Y.EMF().dim(); ++i){
-            for(size_t ix(0); ix < Nx_local; ++ix){  // All the y cells
-                for(size_t e(0); e < Nbc; e++) {
-                    msg_bufY[bufind + e] = Y.FLD(i)(ix,Ny_local-2*Nbc+e);
-                }
-               bufind += step_f;
-            } 
-         } 
-        
-      //   if (Input::List().hydromotion)
-      //   {
-      //       // Hydro-velocity:   x0 "Right-Bound --> "
-      //       for(size_t e(0); e < Nbc; e++) {
-      //           msg_bufX[bufind + e] = Y.HYDRO().density(Nx_local-2*Nbc+e);
-      //       } 
-      //       bufind += step_f;
-      //       // Hydro-velocity:   x0 "Right-Bound --> "
-            // for(size_t e(0); e < Nbc; e++) {
-            //  msg_bufX[bufind + e] = Y.HYDRO().velocity(Nx_local-2*Nbc+e);
-            // } 
-            // bufind += step_f;
-
-      //       // Hydro-temperature:   x0 "Right-Bound --> "
-            // for(size_t e(0); e < Nbc; e++) {
-            //  msg_bufX[bufind + e] = Y.HYDRO().temperature(Nx_local-2*Nbc+e);
-            // } 
-            // bufind += step_f;
-        // }
-        MPI_Send(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, dest, 0, MPI_COMM_WORLD);
+        } 
+
+        MPI_Send(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, dest, 0, comm);
     }
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-    void Node_Communications_2D::Recv_from_left_Y(State2D& Y, int origin) {
+    void Node_ImplicitE_Communications_2D::Recv_from_left_Y(State2D& Y, int origin) {
 //--------------------------------------------------------------
 //  X-axis : Receive data from the node on the left and update
 //           the left guard cells
 //--------------------------------------------------------------
 
-        // static size_t step_h(Y.SH(s,0,0).nump()*Nbc);
         static size_t step_f(Nbc);
         size_t bufind(0);
         MPI_Status status; 
 
         // Receive Data
-        MPI_Recv(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, origin, 0, MPI_COMM_WORLD, &status);
-
-        // Harmonics:x0-"---> Left-Guard" 
-        for(size_t s(0); s < Y.Species(); ++s) {
-            for(size_t i(0); i < Y.DF(s).dim(); ++i){
-                for(size_t ix(0); ix < Nx_local; ++ix){  // All the y cells
-                    for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                        for(size_t e(0); e < Nbc; e++) {
-                            (Y.DF(s)(i))(p, ix, e) = msg_bufY[bufind + e];
-                        }
-                        bufind += step_f;
-                    }
-                }
-            } 
-        }
-
+        MPI_Recv(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, origin, 0, comm, &status);
 
         // Fields:   x0-"---> Left-Guard"
-        for(size_t i(0); i < Y.EMF().dim(); ++i){
-            for(size_t ix(0); ix < Nx_local; ++ix){  // All the y cells
+        for(size_t i(3); i < Y.EMF().dim(); ++i){  // "3" as opposed to "0"
+            for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
                 for(size_t e(0); e < Nbc; e++) {
-                   Y.FLD(i)(ix, e) = msg_bufY[bufind + e];
-                } 
+                   Y.FLD(i)(ix,e) = msg_bufY[bufind + e];
+                }     
                 bufind += step_f;
-            }            
+            }
         }
-
-        // if (Input::List().hydromotion)
-        // {
-        //     // Hydro-velocity:   x0-"---> Left-Guard"
-        //     for(size_t e(0); e < Nbc; e++) {
-        //         Y.HYDRO().density(e) = (msg_bufX[bufind + e]).real();
-        //     } 
-        //     bufind += step_f;        
-
-        //     // Hydro-velocity:   x0-"---> Left-Guard"
-        //     for(size_t e(0); e < Nbc; e++) {
-        //         Y.HYDRO().velocity(e) = (msg_bufX[bufind + e]).real();
-        //     } 
-        //     bufind += step_f;        
-            
-        //     // Hydro-temperature:   x0-"---> Left-Guard"        
-        //     for(size_t e(0); e < Nbc; e++) {
-        //         Y.HYDRO().temperature(e) = (msg_bufX[bufind + e]).real();
-        //     } 
-        //     bufind += step_f;   
-        // }     
-        
-        
     }
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-    void Node_Communications_2D::Send_left_Y(State2D& Y, int dest) {
+    void Node_ImplicitE_Communications_2D::Send_left_Y(State2D& Y, int dest) {
 //--------------------------------------------------------------
 //  X-axis : Read data from the left boundary and send them 
 //           to the node on the left 
 //--------------------------------------------------------------
 
-        // static size_t step_h(Y.SH(s,0,0).nump()*Nbc);
         static size_t step_f(Nbc);
         size_t bufind(0); 
 
-        // Harmonics:x0 " <--- Left-Bound "
-        for(size_t s(0); s < Y.Species(); ++s) {
-            for(size_t i(0); i < Y.DF(s).dim(); ++i){
-                for(size_t ix(0); ix < Nx_local; ++ix){  // All the y cells
-                    for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                        for(size_t e(0); e < Nbc; e++) {
-                          msg_bufY[bufind + e] = (Y.DF(s)(i))(p, ix, Nbc+e);
-                        }
-                        bufind += step_f;
-                    }
-                }
-            } 
-        } 
         // Fields:   x0 " <--- Left-Bound "
-        for(size_t i(0); i < Y.EMF().dim(); ++i){
-            for(size_t ix(0); ix < Nx_local; ++ix){  // All the y cells
+        for(size_t i(3); i < Y.EMF().dim(); ++i){  // "3" as opposed to "0"
+            for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
                 for(size_t e(0); e < Nbc; e++) {
-                    msg_bufY[bufind + e] = Y.FLD(i)(ix,Nbc+e);
+                   msg_bufY[bufind + e] = Y.FLD(i)(ix,Nbc+e);
                 } 
+                
                 bufind += step_f;
             }
         }
 
-        // if (Input::List().hydromotion)
-        // {
-        //     // Hydro-velocity:   x0 " <--- Left-Bound "
-        //     for(size_t e(0); e < Nbc; e++) {
-        //         msg_bufX[bufind + e] = Y.HYDRO().density(Nbc+e);
-        //     } 
-        //     bufind += step_f;
-        //     // Hydro-velocity:   x0 " <--- Left-Bound "
-        //     for(size_t e(0); e < Nbc; e++) {
-        //         msg_bufX[bufind + e] = Y.HYDRO().velocity(Nbc+e);
-        //     } 
-        //     bufind += step_f;
-
-        //     // Hydro-temperature:   x0 " <--- Left-Bound "
-        //     for(size_t e(0); e < Nbc; e++) {
-        //         msg_bufX[bufind + e] = Y.HYDRO().temperature(Nbc+e);
-        //     } 
-        //     bufind += step_f;
-        // }
-
-        MPI_Send(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, dest, 1, MPI_COMM_WORLD);
+        MPI_Send(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, dest, 1, comm);
     }
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-    void Node_Communications_2D::Recv_from_right_Y(State2D& Y, int origin) {
+    void Node_ImplicitE_Communications_2D::Recv_from_right_Y(State2D& Y, int origin) {
 //--------------------------------------------------------------
 //  X-axis : Receive data from the node on the right and update
 //           the right guard cells
 //--------------------------------------------------------------
 
-        // static size_t step_h(Y.SH(s,0,0).nump()*Nbc);
         static size_t step_f(Nbc);
         size_t bufind(0);
         MPI_Status status; 
 
         // Receive Data
-        MPI_Recv(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, origin, 1, MPI_COMM_WORLD, &status);
+        MPI_Recv(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, origin, 1, comm, &status);
 
-        // Harmonics:x0-"Right-Guard <--- " 
-        for(size_t s(0); s < Y.Species(); ++s) {
-            for(size_t i(0); i < Y.DF(s).dim(); ++i){
-                for(size_t ix(0); ix < Nx_local; ++ix){  // All the y cells
-                    for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                        for(size_t e(0); e < Nbc; e++) {
-                            (Y.DF(s)(i))(p, ix, Ny_local-Nbc+e) = msg_bufY[bufind + e];
-                        }
-                        bufind += step_f;
-                    }
-                }
-            } 
-        }
         // Fields:   x0-"Right-Guard <--- "
-        for(size_t i(0); i < Y.EMF().dim(); ++i){
-            for(size_t ix(0); ix < Nx_local; ++ix){  // All the y cells
+        for(size_t i(3); i < Y.EMF().dim(); ++i){  // "3" as opposed to "0"
+            for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
                 for(size_t e(0); e < Nbc; e++) {
                    Y.FLD(i)(ix,Ny_local-Nbc+e) = msg_bufY[bufind + e];
                 } 
                 bufind += step_f;
             }
         }
-
-      //   if (Input::List().hydromotion)
-      //   {
-      //       // Hydro-density:   x0-"Right-Guard <--- "
-      //       for(size_t e(0); e < Nbc; e++) {
-      //           Y.HYDRO().density(Nx_local-Nbc+e) = (msg_bufX[bufind + e]).real();
-      //       } 
-      //       bufind += step_f;
-
-      //       // Hydro-velocity:   x0-"Right-Guard <--- "
-            // for(size_t e(0); e < Nbc; e++) {
-            //  Y.HYDRO().velocity(Nx_local-Nbc+e) = (msg_bufX[bufind + e]).real();
-            // } 
-            // bufind += step_f;
-      //       // Hydro-temperature:   x0-"Right-Guard <--- "
-            // for(size_t e(0); e < Nbc; e++) {
-            //  Y.HYDRO().temperature(Nx_local-Nbc+e) = (msg_bufX[bufind + e]).real();
-            // } 
-            // bufind += step_f;
-      //   }
-        
     }
 //--------------------------------------------------------------
 
-//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 //  Boundary conditions
-//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 //  Mirror conditions on one side
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-//**************************************************************
-//--------------------------------------------------------------
-    void Node_Communications_2D::mirror_bound_Xleft(State2D& Y) {
-//--------------------------------------------------------------
+//*************************************************************************************
+//-------------------------------------------------------------------------------------
+    void Node_ImplicitE_Communications_2D::mirror_bound_Xleft(State2D& Y) {
+//-------------------------------------------------------------------------------------
 //  Mirror boundary in the x direction on the left
-//--------------------------------------------------------------
-        int sign(1);
-        
+//-------------------------------------------------------------------------------------
 
-        // Mirror the harmonics
-        for(size_t s(0); s < Y.Species(); ++s) {
-            for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
-                for(size_t l(0); l < Y.DF(s).l0(); ++l){
-                    for(size_t m(0); m < ((Y.DF(s).m0() < l)? Y.DF(s).m0():l)+1; ++m){
-                        sign = 1-2*((l+m)%2);          //(-1)^(m+n)
-                
-                        for (size_t c(0); c < Nbc; ++c) {
-                            for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                                Y.SH(s,l,m)(p, c, iy) = Y.SH(s,l,m)(p, 2*Nbc-c-1,iy);
-                                Y.SH(s,l,m)(p, c, iy) *= sign;
-                            }
-                        }
 
-                    } 
-                }
-            }
-        }
 
         // Mirror the fields 
-        for(size_t i(0); i < Y.EMF().dim(); ++i){
-            for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
+        for (size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
+            for(size_t iy(0); iy < Ny_local; ++iy){  // All the x cells                
                 for (size_t c(0); c < Nbc; ++c) {
                     Y.FLD(i)(c,iy) = Y.FLD(i)(2*Nbc-c-1,iy);
                 }
             }
         }
 
-        for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
+        //Bx
+        for(size_t iy(0); iy < Ny_local; ++iy){  // All the x cells                
             for (size_t c(0); c < Nbc; ++c) {
-//          Ey
-                 Y.EMF().Ey()(c,iy) *= -1.0; // left  boundary
-//          Ez
-                 Y.EMF().Ez()(c,iy) *= -1.0; // left  boundary
-//          Bx
-                 Y.EMF().Bx()(c,iy) *= -1.0; // left  boundary
+               Y.EMF().Bx()(c,iy) *= -1.0; // left  boundary
             }
         }
 
-        // if (Input::List().hydromotion)
-        // {
-        //   // Hydro Quantities:   x0 "Right-Bound ---> Left-Guard"
-        //     for(size_t c(0); c < Nbc; c++) {
-        //         Y.HYDRO().velocity(c) *= -1.0;
-        //     }    
-        // }
-
-
     }
-//--------------------------------------------------------------
+//-------------------------------------------------------------------------------------
 
 //--------------------------------------------------------------
-    void Node_Communications_2D::mirror_bound_Xright(State2D& Y) {
+    void Node_ImplicitE_Communications_2D::mirror_bound_Xright(State2D& Y) {
 //--------------------------------------------------------------
 //  Mirror boundary in the x direction on the right
 //--------------------------------------------------------------
-        int sign(1);
-        
 
-        // Mirror the harmonics
-        for(size_t s(0); s < Y.Species(); ++s) {
-            for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
-                for(size_t l(0); l < Y.DF(s).l0(); ++l){
-                    for(size_t m(0); m < ((Y.DF(s).m0() < l)? Y.DF(s).m0():l)+1; ++m){
-                        sign = 1-2*((l+m)%2);          //(-1)^(m+n)
 
-                        for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                            for (size_t c(0); c < Nbc; ++c) {
-                                Y.SH(s,l,m)(p, Nx_local-c-1, iy) = Y.SH(s,l,m)(p, Nx_local-2*Nbc+c, iy);
-                                Y.SH(s,l,m)(p, Nx_local-c-1, iy) *= sign;
-                            }
-                        }
-     
-                    }
-                }
+
+        // Mirror the fields 
+        for (size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
+            for(size_t iy(0); iy < Ny_local; ++iy){  // All the x cells
+                for (size_t c(0); c < Nbc; ++c){ 
+                    Y.FLD(i)(Nx_local-c-1,iy) = Y.FLD(i)(Nx_local-2*Nbc+c,iy);
+                }       
+            }
+        }
+
+        //Bx
+        for(size_t iy(0); iy < Ny_local; ++iy){  // All the x cells                
+            for (size_t c(0); c < Nbc; ++c) {
+                Y.EMF().Bx()(Nx_local-1-c,iy) *= -1.0; // right  boundary
             }
         }
 
+    }
+//--------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------
+    void Node_ImplicitE_Communications_2D::mirror_bound_Yleft(State2D& Y) {
+//-------------------------------------------------------------------------------------
+//  Mirror boundary in the x direction on the left
+//-------------------------------------------------------------------------------------
+
+        
+
         // Mirror the fields 
-        for(size_t i(0); i < Y.EMF().dim(); ++i){
-           for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
+        for (size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
+            for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
                 for (size_t c(0); c < Nbc; ++c) {
-                    Y.FLD(i)(Nx_local-c-1,iy) = Y.FLD(i)(Nx_local-2*Nbc+c,iy);
+                    Y.FLD(i)(ix,c) = Y.FLD(i)(ix,2*Nbc-c-1);
                 }
             }
         }
-        for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells   
+
+        //Bx
+        for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
             for (size_t c(0); c < Nbc; ++c) {
-                //Ey
-                Y.EMF().Ey()(Nx_local-c-1,iy) *= -1.0; // right boundary 
-                //Ez
-                Y.EMF().Ez()(Nx_local-c-1,iy) *= -1.0; // right boundary 
-                //Bx
-                Y.EMF().Bx()(Nx_local-c-1,iy) *= -1.0; // right boundary 
+                Y.EMF().By()(ix,c) *= -1.0; // left  boundary
             }
         }
 
-        // if (Input::List().hydromotion)
-        // {
-        //     // Hydro Quantities:   x0 "Left-Bound ---> Right-Guard"
-        //     for(size_t c(0); c < Nbc; c++) {
-        //         Y.HYDRO().velocity(Nx_local-Nbc+c) *=  -1.0;
-        //     }
-        // }
-
     }
-//--------------------------------------------------------------
+//-------------------------------------------------------------------------------------
 
-//**************************************************************
 //--------------------------------------------------------------
-    void Node_Communications_2D::mirror_bound_Yleft(State2D& Y) {
+    void Node_ImplicitE_Communications_2D::mirror_bound_Yright(State2D& Y) {
 //--------------------------------------------------------------
-//  Mirror boundary in the y direction on the left
+//  Mirror boundary in the x direction on the right
 //--------------------------------------------------------------
-        int sign(1);
 
 
-        // Mirror the harmonics
-        for(size_t s(0); s < Y.Species(); ++s) {
-            for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
-                for(size_t l(0); l < Y.DF(s).l0(); ++l){
-                    for(size_t m(0); m < ((Y.DF(s).m0() < l)? Y.DF(s).m0():l)+1; ++m){
-                        sign = 1-2*((l+m)%2);          //(-1)^(m+n)
-                
-                        for (size_t c(0); c < Nbc; ++c) {
-                            for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                                Y.SH(s,l,m)(p, ix, c) = Y.SH(s,l,m)(p, ix, 2*Nbc-c-1);
-                                Y.SH(s,l,m)(p, ix, c) *= sign;
-                            }
-                        }
-
-                    } 
-                }
-            }
-        }
 
         // Mirror the fields 
-        for(size_t i(0); i < Y.EMF().dim(); ++i){
+        for (size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
             for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
                 for (size_t c(0); c < Nbc; ++c) {
-                    Y.FLD(i)(ix,c) = Y.FLD(i)(ix, 2*Nbc-c-1);
+                    Y.FLD(i)(ix,Ny_local-c-1) = Y.FLD(i)(ix,Ny_local-2*Nbc+c);
                 }
             }
         }
 
+        //Bx
         for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
             for (size_t c(0); c < Nbc; ++c) {
-//          Ey
-                 Y.EMF().Ey()(ix,c) *= -1.0; // left  boundary
-//          Ez
-                 Y.EMF().Ez()(ix,c) *= -1.0; // left  boundary
-//          Bx
-                 Y.EMF().Bx()(ix,c) *= -1.0; // left  boundary
+                Y.EMF().By()(ix,Ny_local-1-c) *= -1.0; // right  boundary
             }
         }
 
-        // if (Input::List().hydromotion)
-        // {
-        //   // Hydro Quantities:   x0 "Right-Bound ---> Left-Guard"
-        //     for(size_t c(0); c < Nbc; c++) {
-        //         Y.HYDRO().velocity(c) *= -1.0;
-        //     }    
-        // }
-
-
     }
-//--------------------------------------------------------------
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+//  Boundary conditions on both sides of a node
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
 //--------------------------------------------------------------
-    void Node_Communications_2D::mirror_bound_Yright(State2D& Y) {
+    void Node_ImplicitE_Communications_2D::sameNode_bound_X(State2D& Y) {
 //--------------------------------------------------------------
-//  Mirror boundary in the x direction on the right
+//  Choose between boundary conditions in the x direction
+//--------------------------------------------------------------
+        switch (BNDX()) {
+            case 0:                   // periodic
+                sameNode_periodic_X(Y);
+
+                break;
+            case 1:                   // mirror boundary
+                sameNode_mirror_X(Y);
+                break;
+            default:
+                cout<<"Not a valid boundary condition." << endl;
+                break;
+        }
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void Node_ImplicitE_Communications_2D::sameNode_periodic_X(State2D& Y) {
+//--------------------------------------------------------------
+//  Periodic boundary in the x direction for 1 node
+//--------------------------------------------------------------
+
+        // Fields:   x0 "Right-Bound ---> Left-Guard"
+        for (size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
+            for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
+                for (size_t c(0); c < Nbc; c++) {
+                    Y.FLD(i)(c,iy) = Y.FLD(i)(Nx_local-2*Nbc+c,iy);
+                }
+            }
+        }
+
+        // Fields:   x0 "Left-Bound ---> Right-Guard"
+        for (size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
+            for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
+                for (size_t c(0); c < Nbc; c++) {
+                    Y.FLD(i)(Nx_local-Nbc+c,iy) = Y.FLD(i)(Nbc+c,iy);
+                }
+            }
+        }
+       
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void Node_ImplicitE_Communications_2D::sameNode_mirror_X(State2D& Y) {
+//--------------------------------------------------------------
+//  Mirror boundary in the x direction for 1 node
+//--------------------------------------------------------------
+ 
+
+
+        // Mirror the fields 
+        for (size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
+           for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
+               // right boundary
+               for (size_t c(0); c < Nbc; ++c) 
+                   Y.FLD(i)(Nx_local-c-1,iy) = Y.FLD(i)(Nx_local-2*Nbc+c,iy);
+               // left boundary
+               for (size_t c(0); c < Nbc; ++c) 
+                  Y.FLD(i)(c,iy) = Y.FLD(i)(2*Nbc-c-1,iy);
+          }
+        }
+
+        //Bx
+        for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
+            for (size_t c(0); c < Nbc; ++c) {
+                Y.EMF().Bx()(c,iy) *= -1.0; // left  boundary
+                Y.EMF().Bx()(Nx_local-Nbc+c,iy) *= -1.0; // right  boundary
+            }
+        }
+
+    }
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+    void Node_ImplicitE_Communications_2D::sameNode_bound_Y(State2D& Y) {
+//--------------------------------------------------------------
+//  Choose between boundary conditions in the x direction
+//--------------------------------------------------------------
+        switch (BNDY()) {
+            case 0:                   // periodic
+                sameNode_periodic_Y(Y);
+
+                break;
+            case 1:                   // mirror boundary
+                sameNode_mirror_Y(Y);
+                break;
+            default:
+                cout<<"Not a valid boundary condition." << endl;
+                break;
+        }
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void Node_ImplicitE_Communications_2D::sameNode_periodic_Y(State2D& Y) {
+//--------------------------------------------------------------
+//  Periodic boundary in the x direction for 1 node
+//--------------------------------------------------------------
+
+        // Fields:   x0 "Right-Bound ---> Left-Guard"
+        for (size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
+            for(size_t ix(0); ix < Nx_local; ++ix){  // All the y cells
+                for (size_t c(0); c < Nbc; c++) {
+                    Y.FLD(i)(ix,c) = Y.FLD(i)(ix,Ny_local-2*Nbc+c);
+                }
+            }
+        }
+
+        // Fields:   x0 "Left-Bound ---> Right-Guard"
+        for (size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
+            for(size_t ix(0); ix < Nx_local; ++ix){  // All the y cells
+                for (size_t c(0); c < Nbc; c++) {
+                    Y.FLD(i)(ix,Ny_local-Nbc+c) = Y.FLD(i)(ix,Nbc+c);
+                }
+            }
+        }
+       
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void Node_ImplicitE_Communications_2D::sameNode_mirror_Y(State2D& Y) {
+//--------------------------------------------------------------
+//  Mirror boundary in the x direction for 1 node
+//--------------------------------------------------------------
+ 
+
+
+        // Mirror the fields 
+        for (size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
+           for(size_t ix(0); ix < Nx_local; ++ix){  // All the y cells
+               // right boundary
+               for (size_t c(0); c < Nbc; ++c) 
+                   Y.FLD(i)(ix,Ny_local-c-1) = Y.FLD(i)(ix,Ny_local-2*Nbc+c);
+               // left boundary
+               for (size_t c(0); c < Nbc; ++c) 
+                  Y.FLD(i)(ix,c) = Y.FLD(i)(ix,2*Nbc-c-1);
+          }
+        }
+
+        //Bx
+        for(size_t ix(0); ix < Nx_local; ++ix){  // All the y cells
+            for (size_t c(0); c < Nbc; ++c) {
+                Y.EMF().By()(ix,c) *= -1.0; // left  boundary
+                Y.EMF().By()(ix,Ny_local-Nbc+c) *= -1.0; // right  boundary
+            }
+        }
+
+    }
+//--------------------------------------------------------------
+
+//**************************************************************
+//**************************************************************
+//  Definition of the Nodes Communications class
+//**************************************************************
+//**************************************************************
+
+
+//**************************************************************
+//--------------------------------------------------------------
+    Node_Communications_2D:: Node_Communications_2D(MPI_Comm comm_cart) : 
+//--------------------------------------------------------------
+//  Constructor
+//--------------------------------------------------------------
+        Nbc(Input::List().BoundaryCells),      // # of boundary cells
+        bndX(Input::List().bndX),
+        bndY(Input::List().bndY),
+        Nx_local(Input::List().NxLocal[0]),
+        Ny_local(Input::List().NxLocal[1]),        // Type of boundary in X
+        shared(comm_cart, 9) {
+         
+        numspec = Input::List().ls.size();
+        // numpmax = Input::List().ps;
+
+        // The neighborhood is built on the Cartesian topology 
+        // with the first exchange, the harmonics and the fields 
+        // are described by the halo datatypes
+        comm_topo = comm_cart;
+        comm_halo = MPI_COMM_NULL;
+        halo_base = NULL;
+        msg_req   = MPI_REQUEST_NULL;
+
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    Node_Communications_2D:: ~Node_Communications_2D(){
+//--------------------------------------------------------------
+//  Destructor
+//--------------------------------------------------------------
+        int finalized;
+        MPI_Finalized(&finalized);
+        if (!finalized) {
+            Free();
+            if (comm_halo != MPI_COMM_NULL) MPI_Comm_free(&comm_halo);
+        }
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    int Node_Communications_2D:: BNDX()  const {return bndX;} 
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+    int Node_Communications_2D:: BNDY()  const {return bndY;} 
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+//  Non-blocking exchange with all the neighbors
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+//--------------------------------------------------------------
+    void Node_Communications_2D::Post(State2D& Y) {
+//--------------------------------------------------------------
+//  Start the exchange of the faces and the corners. The boundary 
+//  cells of Y are read and the guard cells are written directly, 
+//  so they must not be touched until Complete
+//--------------------------------------------------------------
+
+        if (comm_halo == MPI_COMM_NULL) Neighborhood();
+        if (halo_base != &(Y.DF(0)(0))(0,0,0)) Setup(Y);
+
+        shared.Pack();
+        MPI_Ineighbor_alltoallw(MPI_BOTTOM, &halo_count[0], &halo_displ[0], &halo_send[0],
+                                MPI_BOTTOM, &halo_count[0], &halo_displ[0], &halo_recv[0],
+                                comm_halo, &msg_req);
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void Node_Communications_2D::Complete(State2D&) {
+//--------------------------------------------------------------
+//  Wait for the exchange to update the guard cells
+//--------------------------------------------------------------
+
+        MPI_Wait(&msg_req, MPI_STATUS_IGNORE);
+        shared.Unpack();
+    }
+//--------------------------------------------------------------
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+//  Neighborhood and halo datatypes
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+//--------------------------------------------------------------
+    void Node_Communications_2D::Neighborhood() {
+//--------------------------------------------------------------
+//  Graph of the 8 neighbors of the node on the Cartesian 
+//  topology, faces and corners. The directions are listed in the 
+//  same order on every node, so when two nodes are neighbors in 
+//  several directions (e.g. 2 nodes with periodic boundaries) the 
+//  n-th message from one matches the n-th message of the other.
+//  A direction with a single node is handled by sameNode_bound 
+//  and a direction without a neighbor by mirror_bound. The 
+//  neighbors on this host are left out of the graph
+//--------------------------------------------------------------
+
+        int dims[2], periods[2], coords[2];        // [0] = y, [1] = x
+        MPI_Cart_get(comm_topo, 2, dims, periods, coords);
+
+        vector<int> sources, destinations;
+        dir_send.clear(); dir_recv.clear();
+        shared_send.clear(); shared_recv.clear();
+
+        edgeX[0] = true; edgeX[1] = true;
+        edgeY[0] = true; edgeY[1] = true;
+
+        for (int dy(-1); dy < 2; ++dy) {
+            for (int dx(-1); dx < 2; ++dx) {
+                if ((dx == 0) && (dy == 0))      continue;
+                if ((dx != 0) && (dims[1] == 1)) continue;
+                if ((dy != 0) && (dims[0] == 1)) continue;
+
+                int to[2]   = {coords[0]+dy, coords[1]+dx},
+                    from[2] = {coords[0]-dy, coords[1]-dx};
+                int nb;
+
+                // Send the boundary cells on the d side to the neighbor at +d
+                if (Neighbor(dims, periods, to, nb)) {
+                    if (shared.Shared(nb)) {
+                        shared_send.push_back(dx); shared_send.push_back(dy); shared_send.push_back(nb);
+                    }
+                    else {
+                        destinations.push_back(nb);
+                        dir_send.push_back(dx); dir_send.push_back(dy);
+                    }
+                }
+                // Receive the boundary cells sent along d by the neighbor at -d
+                if (Neighbor(dims, periods, from, nb)) {
+                    if (shared.Shared(nb)) {
+                        shared_recv.push_back(dx); shared_recv.push_back(dy); shared_recv.push_back(nb);
+                    }
+                    else {
+                        sources.push_back(nb);
+                        dir_recv.push_back(dx); dir_recv.push_back(dy);
+                    }
+                }
+
+                // Sides of the node without a neighbor
+                if (dy == 0) edgeX[(dx+1)/2] = !Neighbor(dims, periods, to, nb) || (dims[1] == 1);
+                if (dx == 0) edgeY[(dy+1)/2] = !Neighbor(dims, periods, to, nb) || (dims[0] == 1);
+            }
+        }
+
+        MPI_Dist_graph_create_adjacent(comm_topo, sources.size(), sources.empty() ? MPI_WEIGHTS_EMPTY : &sources[0], MPI_UNWEIGHTED,
+                                       destinations.size(), destinations.empty() ? MPI_WEIGHTS_EMPTY : &destinations[0], MPI_UNWEIGHTED,
+                                       MPI_INFO_NULL, 0, &comm_halo);
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    bool Node_Communications_2D::Neighbor(int* dims, int* periods, int* c, int& nb) {
+//--------------------------------------------------------------
+//  Rank of the node with coordinates c, false if there is none
+//--------------------------------------------------------------
+
+        for (size_t d(0); d < 2; ++d) {
+            if ( (c[d] < 0) || (c[d] > dims[d]-1) ) {
+                if (!periods[d]) return false;
+                c[d] = (c[d] + dims[d]) % dims[d];
+            }
+        }
+        MPI_Cart_rank(comm_topo, c, &nb);
+        return true;
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void Node_Communications_2D::Setup(State2D& Y) {
+//--------------------------------------------------------------
+//  Describe the halos of Y for every direction. This is repeated 
+//  only if Y changes, the storage of Y is never reallocated. 
+//  Along a direction d the node sends its boundary cells on the 
+//  d side and receives in its guard cells on the -d side. On 
+//  this host the direction gives the slot of the halo
+//--------------------------------------------------------------
+
+        Free();
+        halo_base = &(Y.DF(0)(0))(0,0,0);
+
+        for (size_t n(0); n < dir_send.size()/2; ++n) {
+            halo_send.push_back(Halo(Y, dir_send[2*n], dir_send[2*n+1], false));
+        }
+        for (size_t n(0); n < dir_recv.size()/2; ++n) {
+            halo_recv.push_back(Halo(Y, dir_recv[2*n], dir_recv[2*n+1], true));
+        }
+
+        // One count per neighbor, the datatypes carry the addresses.
+        // Keep the arrays valid for a node without neighbors
+        size_t num_nb(max(max(halo_send.size(), halo_recv.size()), size_t(1)));
+        halo_count.assign(num_nb, 1);
+        halo_displ.assign(num_nb, 0);
+        halo_send.resize(num_nb, MPI_DATATYPE_NULL);
+        halo_recv.resize(num_nb, MPI_DATATYPE_NULL);
+
+        for (size_t n(0); n < shared_send.size()/3; ++n) {
+            int dx(shared_send[3*n]), dy(shared_send[3*n+1]);
+            halo_shared.push_back(Halo(Y, dx, dy, false));
+            shared.Send(halo_shared.back(), shared_send[3*n+2], 3*(dy+1)+dx+1);
+        }
+        for (size_t n(0); n < shared_recv.size()/3; ++n) {
+            int dx(shared_recv[3*n]), dy(shared_recv[3*n+1]);
+            halo_shared.push_back(Halo(Y, dx, dy, true));
+            shared.Recv(halo_shared.back(), shared_recv[3*n+2], 3*(dy+1)+dx+1);
+        }
+        shared.Allocate();
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void Node_Communications_2D::Free() {
+//--------------------------------------------------------------
+//  Release the datatypes
+//--------------------------------------------------------------
+
+        for (size_t n(0); n < halo_send.size(); ++n) {
+            if (halo_send[n] != MPI_DATATYPE_NULL) MPI_Type_free(&halo_send[n]);
+            if (halo_recv[n] != MPI_DATATYPE_NULL) MPI_Type_free(&halo_recv[n]);
+        }
+        halo_send.clear(); halo_recv.clear(); 
+        halo_count.clear(); halo_displ.clear();
+
+        shared.Clear();
+        for (size_t n(0); n < halo_shared.size(); ++n) MPI_Type_free(&halo_shared[n]);
+        halo_shared.clear();
+        halo_base = NULL;
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    MPI_Datatype Node_Communications_2D::Halo(State2D& Y, int dx, int dy, bool guard) {
+//--------------------------------------------------------------
+//  Datatype for the halo along the direction (dx,dy). It covers 
+//  the boundary cells on the (dx,dy) side or, for guard = true, 
+//  the guard cells on the (-dx,-dy) side. A face also carries the 
+//  guard cells of the sides without a neighbor, where there is no 
+//  corner to receive. Every y-cell contributes one block of 
+//  nump*nx harmonic values and of nx field values 
+//--------------------------------------------------------------
+
+        size_t nx(Nbc), ny(Nbc);
+        size_t x0(Nbc), y0(Nbc);
+
+        if (dx == 0) {
+            nx = Nx_local - Nbc*(2 - size_t(edgeX[0]) - size_t(edgeX[1]));
+            if (edgeX[0]) x0 = 0;
+        }
+        if (dy == 0) {
+            ny = Ny_local - Nbc*(2 - size_t(edgeY[0]) - size_t(edgeY[1]));
+            if (edgeY[0]) y0 = 0;
+        }
+
+        if (guard) {
+            if (dx ==  1) x0 = 0;                    // Right-Bound ---> Left-Guard
+            if (dx == -1) x0 = Nx_local-Nbc;         // Right-Guard <--- Left-Bound
+            if (dy ==  1) y0 = 0;
+            if (dy == -1) y0 = Ny_local-Nbc;
+        }
+        else {
+            if (dx ==  1) x0 = Nx_local-2*Nbc;
+            if (dy ==  1) y0 = Ny_local-2*Nbc;
+        }
+
+        vector<int>          blocklen;
+        vector<MPI_Aint>     address;
+        vector<MPI_Datatype> type;
+        MPI_Aint             a;
+
+        // One block type per species and one for the fields
+        vector<MPI_Datatype> block(Y.Species()+1);
+
+        // Harmonics
+        for (size_t s(0); s < Y.Species(); ++s) {
+            size_t nump(Y.SH(s,0,0).nump());
+            MPI_Type_vector(ny, nump*nx, nump*Nx_local, MPI_DOUBLE_COMPLEX, &block[s]);
+            for(size_t i(0); i < Y.DF(s).dim(); ++i){
+                MPI_Get_address(&(Y.DF(s)(i))(0, x0, y0), &a);
+                blocklen.push_back(1); address.push_back(a); type.push_back(block[s]);
+            }
+        }
+        // Fields
+        MPI_Type_vector(ny, nx, Nx_local, MPI_DOUBLE_COMPLEX, &block[Y.Species()]);
+        for(size_t i(0); i < Y.EMF().dim(); ++i){
+            MPI_Get_address(&(Y.FLD(i)(x0, y0)), &a);
+            blocklen.push_back(1); address.push_back(a); type.push_back(block[Y.Species()]);
+        }
+
+        MPI_Datatype halo;
+        MPI_Type_create_struct(blocklen.size(), &blocklen[0], &address[0], &type[0], &halo);
+        MPI_Type_commit(&halo);
+
+        // The struct keeps its own reference to the blocks
+        for (size_t b(0); b < block.size(); ++b) MPI_Type_free(&block[b]);
+
+        return halo;
+    }
+//--------------------------------------------------------------
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//  Boundary conditions
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+//  Mirror conditions on one side
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+//**************************************************************
+//--------------------------------------------------------------
+    void Node_Communications_2D::mirror_bound_Xleft(State2D& Y) {
+//--------------------------------------------------------------
+//  Mirror boundary in the x direction on the left
+//--------------------------------------------------------------
+        int sign(1);
+        
+
+        // Mirror the harmonics
+        for(size_t s(0); s < Y.Species(); ++s) {
+            for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
+                for(size_t l(0); l < Y.DF(s).l0(); ++l){
+                    for(size_t m(0); m < ((Y.DF(s).m0() < l)? Y.DF(s).m0():l)+1; ++m){
+                        sign = 1-2*((l+m)%2);          //(-1)^(m+n)
+                
+                        for (size_t c(0); c < Nbc; ++c) {
+                            for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
+                                Y.SH(s,l,m)(p, c, iy) = Y.SH(s,l,m)(p, 2*Nbc-c-1,iy);
+                                Y.SH(s,l,m)(p, c, iy) *= sign;
+                            }
+                        }
+
+                    } 
+                }
+            }
+        }
+
+        // Mirror the fields 
+        for(size_t i(0); i < Y.EMF().dim(); ++i){
+            for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
+                for (size_t c(0); c < Nbc; ++c) {
+                    Y.FLD(i)(c,iy) = Y.FLD(i)(2*Nbc-c-1,iy);
+                }
+            }
+        }
+
+        for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
+            for (size_t c(0); c < Nbc; ++c) {
+//          Ey
+                 Y.EMF().Ey()(c,iy) *= -1.0; // left  boundary
+//          Ez
+                 Y.EMF().Ez()(c,iy) *= -1.0; // left  boundary
+//          Bx
+                 Y.EMF().Bx()(c,iy) *= -1.0; // left  boundary
+            }
+        }
+
+        // if (Input::List().hydromotion)
+        // {
+        //   // Hydro Quantities:   x0 "Right-Bound ---> Left-Guard"
+        //     for(size_t c(0); c < Nbc; c++) {
+        //         Y.HYDRO().velocity(c) *= -1.0;
+        //     }    
+        // }
+
+
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void Node_Communications_2D::mirror_bound_Xright(State2D& Y) {
+//--------------------------------------------------------------
+//  Mirror boundary in the x direction on the right
+//--------------------------------------------------------------
+        int sign(1);
+        
+
+        // Mirror the harmonics
+        for(size_t s(0); s < Y.Species(); ++s) {
+            for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
+                for(size_t l(0); l < Y.DF(s).l0(); ++l){
+                    for(size_t m(0); m < ((Y.DF(s).m0() < l)? Y.DF(s).m0():l)+1; ++m){
+                        sign = 1-2*((l+m)%2);          //(-1)^(m+n)
+
+                        for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
+                            for (size_t c(0); c < Nbc; ++c) {
+                                Y.SH(s,l,m)(p, Nx_local-c-1, iy) = Y.SH(s,l,m)(p, Nx_local-2*Nbc+c, iy);
+                                Y.SH(s,l,m)(p, Nx_local-c-1, iy) *= sign;
+                            }
+                        }
+     
+                    }
+                }
+            }
+        }
+
+        // Mirror the fields 
+        for(size_t i(0); i < Y.EMF().dim(); ++i){
+           for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
+                for (size_t c(0); c < Nbc; ++c) {
+                    Y.FLD(i)(Nx_local-c-1,iy) = Y.FLD(i)(Nx_local-2*Nbc+c,iy);
+                }
+            }
+        }
+        for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells   
+            for (size_t c(0); c < Nbc; ++c) {
+                //Ey
+                Y.EMF().Ey()(Nx_local-c-1,iy) *= -1.0; // right boundary 
+                //Ez
+                Y.EMF().Ez()(Nx_local-c-1,iy) *= -1.0; // right boundary 
+                //Bx
+                Y.EMF().Bx()(Nx_local-c-1,iy) *= -1.0; // right boundary 
+            }
+        }
+
+        // if (Input::List().hydromotion)
+        // {
+        //     // Hydro Quantities:   x0 "Left-Bound ---> Right-Guard"
+        //     for(size_t c(0); c < Nbc; c++) {
+        //         Y.HYDRO().velocity(Nx_local-Nbc+c) *=  -1.0;
+        //     }
+        // }
+
+    }
+//--------------------------------------------------------------
+
+//**************************************************************
+//--------------------------------------------------------------
+    void Node_Communications_2D::mirror_bound_Yleft(State2D& Y) {
+//--------------------------------------------------------------
+//  Mirror boundary in the y direction on the left
+//--------------------------------------------------------------
+        int sign(1);
+
+
+        // Mirror the harmonics
+        for(size_t s(0); s < Y.Species(); ++s) {
+            for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
+                for(size_t l(0); l < Y.DF(s).l0(); ++l){
+                    for(size_t m(0); m < ((Y.DF(s).m0() < l)? Y.DF(s).m0():l)+1; ++m){
+                        sign = 1-2*((l+m)%2);          //(-1)^(m+n)
+                
+                        for (size_t c(0); c < Nbc; ++c) {
+                            for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
+                                Y.SH(s,l,m)(p, ix, c) = Y.SH(s,l,m)(p, ix, 2*Nbc-c-1);
+                                Y.SH(s,l,m)(p, ix, c) *= sign;
+                            }
+                        }
+
+                    } 
+                }
+            }
+        }
+
+        // Mirror the fields 
+        for(size_t i(0); i < Y.EMF().dim(); ++i){
+            for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
+                for (size_t c(0); c < Nbc; ++c) {
+                    Y.FLD(i)(ix,c) = Y.FLD(i)(ix, 2*Nbc-c-1);
+                }
+            }
+        }
+
+        for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
+            for (size_t c(0); c < Nbc; ++c) {
+//          Ey
+                 Y.EMF().Ey()(ix,c) *= -1.0; // left  boundary
+//          Ez
+                 Y.EMF().Ez()(ix,c) *= -1.0; // left  boundary
+//          Bx
+                 Y.EMF().Bx()(ix,c) *= -1.0; // left  boundary
+            }
+        }
+
+        // if (Input::List().hydromotion)
+        // {
+        //   // Hydro Quantities:   x0 "Right-Bound ---> Left-Guard"
+        //     for(size_t c(0); c < Nbc; c++) {
+        //         Y.HYDRO().velocity(c) *= -1.0;
+        //     }    
+        // }
+
+
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void Node_Communications_2D::mirror_bound_Yright(State2D& Y) {
+//--------------------------------------------------------------
+//  Mirror boundary in the x direction on the right
+//--------------------------------------------------------------
+        int sign(1);
+
+
+        // Mirror the harmonics
+        for(size_t s(0); s < Y.Species(); ++s) {
+            for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
+                for(size_t l(0); l < Y.DF(s).l0(); ++l){
+                    for(size_t m(0); m < ((Y.DF(s).m0() < l)? Y.DF(s).m0():l)+1; ++m){
+                        sign = 1-2*((l+m)%2);          //(-1)^(m+n)
+
+                        for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
+                            for (size_t c(0); c < Nbc; ++c) {
+                                Y.SH(s,l,m)(p, ix, Ny_local-c-1) = Y.SH(s,l,m)(p, ix, Ny_local-2*Nbc+c);
+                                Y.SH(s,l,m)(p, ix, Ny_local-c-1) *= sign;
+                            }
+                        }
+     
+                    }
+                }
+            }
+        }
+
+        // Mirror the fields 
+        for(size_t i(0); i < Y.EMF().dim(); ++i){
+           for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
+                for (size_t c(0); c < Nbc; ++c) {
+                    Y.FLD(i)(ix,Ny_local-c-1) = Y.FLD(i)(ix,Ny_local-2*Nbc+c);
+                }
+            }
+        }
+
+        for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
+            for (size_t c(0); c < Nbc; ++c) {
+                //Ey
+                Y.EMF().Ey()(ix,Ny_local-c-1) *= -1.0; // right boundary 
+                //Ez
+                Y.EMF().Ez()(ix,Ny_local-c-1) *= -1.0; // right boundary 
+                //Bx
+                Y.EMF().Bx()(ix,Ny_local-c-1) *= -1.0; // right boundary 
+            }
+        }
+
+        // if (Input::List().hydromotion)
+        // {
+        //     // Hydro Quantities:   x0 "Left-Bound ---> Right-Guard"
+        //     for (size_t c(0); c < Nbc; c++) {
+        //         Y.HYDRO().velocity(Nx_local-Nbc+c) *=  -1.0;
+        //     }
+        // }
+
+    }
+//--------------------------------------------------------------
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+//  Boundary conditions on both sides of a node
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+//--------------------------------------------------------------
+    void Node_Communications_2D::sameNode_bound_X(State2D& Y) {
+//--------------------------------------------------------------
+//  Choose between boundary conditions in the x direction
+//--------------------------------------------------------------
+    
+        switch (BNDX()) {
+            case 0:                   // periodic
+
+                sameNode_periodic_X(Y);
+
+                break;
+            case 1:                   // mirror boundary
+                sameNode_mirror_X(Y);
+                break;
+            default:
+                cout<<"Not a valid boundary condition." << endl;
+                break;
+        }
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void Node_Communications_2D::sameNode_periodic_X(State2D& Y) {
+//--------------------------------------------------------------
+//  Periodic boundary in the x direction for 1 node
+//--------------------------------------------------------------
+        // valarray<double> temp(0.0,Y.SH(0,0,0).numx());
+  
+       
+
+       // temp = Y.DF(0).getcurrent(0);
+       // for (size_t ix(0);ix<Y.SH(0,0,0).numx();++ix)
+    //     {        
+    //         std::cout<<"\n original[" << ix  << "] = " << temp[ix] << "\n";      
+            
+            
+    //     }
+
+
+
+        // Harmonics:x0 "Right-Bound ---> Left-Guard" 
+        for(size_t s(0); s < Y.Species(); ++s) {
+            for(size_t i(0); i < Y.DF(s).dim(); ++i) {
+                for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
+                    for(size_t c(0); c < Nbc; c++) {
+                        for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
+                            (Y.DF(s)(i))(p, c, iy) = (Y.DF(s)(i))(p, Nx_local-2*Nbc+c, iy);
+                            // std::cout << "\n 1: DF(" << i << "," << p << "," << c << ") = " << (Y.DF(s)(i))(p, Nx_local-2*Nbc+c) << "\n";
+                        }
+                    }
+                }
+            }
+        }
+        
+        // Fields:   x0 "Right-Bound ---> Left-Guard"
+        for(size_t i(0); i < Y.EMF().dim(); ++i) {
+            for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
+                for(size_t c(0); c < Nbc; c++) {
+                    Y.FLD(i)(c,iy) = Y.FLD(i)(Nx_local-2*Nbc+c,iy);
+                    // std::cout << "\n 2: FLD(" << i << "," << c << ") = " << Y.FLD(i)(Nx_local-2*Nbc+c) << "\n";
+                }
+            }
+        }
+        
+
+
+        // Harmonics:x0 "Left-Bound ---> Right-Guard" 
+        for(size_t s(0); s < Y.Species(); ++s) {
+            for(size_t i(0); i < Y.DF(s).dim(); ++i) {
+                for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells                    
+                    for(size_t c(0); c < Nbc; c++) {
+                        for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
+                            // std::cout << "\n 3: DF(" << i << "," << p << "," << Nx_local-Nbc+c << ") = " << (Y.DF(s)(i))(p, Nx_local-Nbc+c) << "\n";
+
+                            (Y.DF(s)(i))(p, Nx_local-Nbc+c,iy) = (Y.DF(s)(i))(p, Nbc+c,iy);
+
+                            // std::cout << "\n 3n: DF(" << i << "," << p << "," << Nx_local-Nbc+c << ") = " << (Y.DF(s)(i))(p, Nx_local-Nbc+c-100.0) << "\n";
+                            // if (c==2)
+
+                            
+                        }
+                    }
+                }
+            }
+        }
+        
+        // Fields:   x0 "Left-Bound ---> Right-Guard"
+        for(size_t i(0); i < Y.EMF().dim(); ++i) {
+            for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
+                for(size_t c(0); c < Nbc; c++) {
+                    // if (i == 0)                 std::cout << "\n 4: FLD(" << i << "," << Nx_local-Nbc+c << ") = " << Y.FLD(i)(Nx_local-Nbc+c) << "\n";
+                    Y.FLD(i)(Nx_local-Nbc+c,iy) = Y.FLD(i)(Nbc+c,iy);
+                    // if (i == 0)                 std::cout << "\n 4n: FLD(" << i << "," << Nx_local-Nbc+c << ") = " << Y.FLD(i)(Nx_local-Nbc+c) << "\n";
+                }
+            }
+            // Y.FLD(i)(Nx_local-1) = 0.0;
+        }
+        
+
+        // temp = Y.DF(0).getcurrent(0);
+        // for (size_t ix(0);ix<Y.SH(0,0,0).numx();++ix)
+        // {        
+        //     std::cout<<"\n      new[" << ix  << "] = " << temp[ix] << "\n";      
+            
+        // }
+
+
+   //      if (Input::List().hydromotion)
+   //      {
+   //          // Hydro Quantities:   x0 "Right-Bound ---> Left-Guard"
+            // for(size_t c(0); c < Nbc; c++) {
+            //  Y.HYDRO().density(c) = Y.HYDRO().density(Nx_local-2*Nbc+c);
+   //              Y.HYDRO().velocity(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
+            //  Y.HYDRO().temperature(c) = Y.HYDRO().temperature(Nx_local-2*Nbc+c);
+            //  // Y.HYDRO().kpressure(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
+            //  // Y.HYDRO().mpressure(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
+            // }    
+    
+   //          // Hydro Quantities:   x0 "Left-Bound ---> Right-Guard"
+            // for(size_t c(0); c < Nbc; c++) {
+            //  Y.HYDRO().density(Nx_local-Nbc+c) =  Y.HYDRO().density(Nbc+c);
+   //              Y.HYDRO().velocity(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
+            //  Y.HYDRO().temperature(Nx_local-Nbc+c) =  Y.HYDRO().temperature(Nbc+c);
+            //  // Y.HYDRO().kpressure(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
+            //  // Y.HYDRO().mpressure(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
+
+            // }
+   //      }
+
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void Node_Communications_2D::sameNode_mirror_X(State2D& Y) {
+//--------------------------------------------------------------
+//  Mirror boundary in the x direction for 1 node
+//--------------------------------------------------------------
+        int sign(1);
+
+
+        // Mirror the harmonics
+        for(size_t s(0); s < Y.Species(); ++s) {
+            for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells                
+                for(size_t l(0); l < Y.DF(s).l0(); ++l){
+                    for(size_t m(0); m < ((Y.DF(s).m0() < l)? Y.DF(s).m0():l)+1; ++m){
+                        sign = 1-2*((l+m)%2);          //(-1)^(m+n)
+
+                        // right boundary
+                        for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
+                            for (size_t c(0); c < Nbc; ++c) {
+                                Y.SH(s,l,m)(p, Nx_local-c-1, iy) = Y.SH(s,l,m)(p, Nx_local-2*Nbc+c, iy);
+                                Y.SH(s,l,m)(p, Nx_local-c-1, iy) *= sign;
+                            }
+                        }
+
+                        // left boundary
+                        for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
+                            for (size_t c(0); c < Nbc; ++c) {
+                                Y.SH(s,l,m)(p, c, iy) = Y.SH(s,l,m)(p, 2*Nbc-c-1, iy);
+                                Y.SH(s,l,m)(p, c, iy) *= sign;
+                            }
+                        }
+
+                    }
+                }
+            }           
+        }
+
+        // Mirror the fields 
+        for(size_t i(0); i < Y.EMF().dim(); ++i){
+            for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells    
+               // right boundary
+               for (size_t c(0); c < Nbc; ++c) 
+                   Y.FLD(i)(Nx_local-c-1,iy) = Y.FLD(i)(Nx_local-2*Nbc+c,iy);
+               // left boundary
+               for (size_t c(0); c < Nbc; ++c) 
+                  Y.FLD(i)(c,iy) = Y.FLD(i)(2*Nbc-c-1,iy);
+            }
+        }
+
+        for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells    
+            for(size_t c(0); c < Nbc; c++) {
+                //Ey
+                Y.EMF().Ey()(Nx_local-Nbc+c,iy) *= -1.0; // right boundary 
+                Y.EMF().Ey()(c,iy) *= -1.0;  // left  boundary
+
+                //Ez
+                Y.EMF().Ez()(Nx_local-Nbc+c,iy) *= -1.0; // right boundary 
+                Y.EMF().Ez()(c,iy) *= -1.0;  // left  boundary
+           
+                //Bx
+                Y.EMF().Bx()(Nx_local-Nbc+c,iy) *= -1.0; // right boundary 
+                Y.EMF().Bx()(c,iy) *= -1.0;  // left  boundary
+            }
+        }
+
+
+        // if (Input::List().hydromotion)
+        // {
+        //     // Hydro Quantities:   x0 "Right-Bound ---> Left-Guard"
+        //     for(size_t c(0); c < Nbc; c++) {
+        //         Y.HYDRO().velocity(c) *= -1.0;
+        //         // Y.HYDRO().temperature(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
+        //         // Y.HYDRO().kpressure(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
+        //         // Y.HYDRO().mpressure(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
+        //     }    
+    
+        //     // Hydro Quantities:   x0 "Left-Bound ---> Right-Guard"
+        //     for(size_t c(0); c < Nbc; c++) {
+        //         Y.HYDRO().velocity(Nx_local-Nbc+c) *= -1.0;// Y.HYDRO().velocity(Nbc+c);
+        //         // Y.HYDRO().temperature(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
+        //         // Y.HYDRO().kpressure(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
+        //         // Y.HYDRO().mpressure(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
+
+        //     }
+        // }
+
+    }
+//--------------------------------------------------------------
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+//  Boundary conditions on both sides of a node
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+//--------------------------------------------------------------
+    void Node_Communications_2D::sameNode_bound_Y(State2D& Y) {
+//--------------------------------------------------------------
+//  Choose between boundary conditions in the y direction
+//--------------------------------------------------------------
+    
+        switch (BNDY()) {
+            case 0:                   // periodic
+                sameNode_periodic_Y(Y);
+
+                break;
+            case 1:                   // mirror boundary
+                sameNode_mirror_Y(Y);
+                break;
+            default:
+                cout<<"Not a valid boundary condition." << endl;
+                break;
+        }
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void Node_Communications_2D::sameNode_periodic_Y(State2D& Y) {
+//--------------------------------------------------------------
+//  Periodic boundary in the x direction for 1 node
+//--------------------------------------------------------------
+        // valarray<double> temp(0.0,Y.SH(0,0,0).numx());
+  
+       
+
+       // temp = Y.DF(0).getcurrent(0);
+       // for (size_t ix(0);ix<Y.SH(0,0,0).numx();++ix)
+       //  {        
+       //      std::cout<<"\n original[" << ix  << "] = " << temp[ix] << "\n";      
+            
+            
+       //  }
+
+        // Harmonics:x0 "Right-Bound ---> Left-Guard" 
+        for(size_t s(0); s < Y.Species(); ++s) {
+            for(size_t i(0); i < Y.DF(s).dim(); ++i) {
+                for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
+                    for(size_t c(0); c < Nbc; c++) {
+                        for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
+                            
+                            (Y.DF(s)(i))(p, ix, c) = (Y.DF(s)(i))(p, ix, Ny_local-2*Nbc+c);
+                            // std::cout << "\n 1: DF(" << i << "," << p << "," << c << ") = " << (Y.DF(s)(i))(p, Nx_local-2*Nbc+c) << "\n";
+                        }
+                    }
+                }
+            }
+        }
+        
+        // Fields:   x0 "Right-Bound ---> Left-Guard"
+        for(size_t i(0); i < Y.EMF().dim(); ++i) {
+            for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
+                for(size_t c(0); c < Nbc; c++) {
+                    Y.FLD(i)(ix, c) = Y.FLD(i)(ix, Ny_local-2*Nbc+c);
+                    // std::cout << "\n 2: FLD(" << i << "," << c << ") = " << Y.FLD(i)(Nx_local-2*Nbc+c) << "\n";
+                }
+            }
+        }
+        // std::cout << "13 \n";
+
+
+        // Harmonics:x0 "Left-Bound ---> Right-Guard" 
+        for(size_t s(0); s < Y.Species(); ++s) {
+            for(size_t i(0); i < Y.DF(s).dim(); ++i) {
+                for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
+                    for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
+                        for(size_t c(0); c < Nbc; c++) {
+                            // std::cout << "\n 3: DF(" << i << "," << p << "," << Nx_local-Nbc+c << ") = " << (Y.DF(s)(i))(p, Nx_local-Nbc+c) << "\n";
+
+                            (Y.DF(s)(i))(p, ix, Ny_local-Nbc+c) = (Y.DF(s)(i))(p, ix, Nbc+c);
+
+                            // std::cout << "\n 3n: DF(" << i << "," << p << "," << Nx_local-Nbc+c << ") = " << (Y.DF(s)(i))(p, Nx_local-Nbc+c-100.0) << "\n";
+                            // if (c==2)
+
+                            
+                        }
+                    }
+                }
+            }
+        }
+        // std::cout << "14 \n";
+        // Fields:   x0 "Left-Bound ---> Right-Guard"
+        for(size_t i(0); i < Y.EMF().dim(); ++i) {
+            for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
+                for(size_t c(0); c < Nbc; c++) {
+                    // if (i == 0)                 std::cout << "\n 4: FLD(" << i << "," << Nx_local-Nbc+c << ") = " << Y.FLD(i)(Nx_local-Nbc+c) << "\n";
+                    Y.FLD(i)(ix, Ny_local-Nbc+c) = Y.FLD(i)(ix, Nbc+c);
+                    // if (i == 0)                 std::cout << "\n 4n: FLD(" << i << "," << Nx_local-Nbc+c << ") = " << Y.FLD(i)(Nx_local-Nbc+c) << "\n";
+                }
+            }
+            // Y.FLD(i)(Nx_local-1) = 0.0;
+        }
+        // std::cout << "15 \n";
+        // temp = Y.DF(0).getcurrent(0);
+        // for (size_t ix(0);ix<Y.SH(0,0,0).numx();++ix)
+        // {        
+        //     std::cout<<"\n      new[" << ix  << "] = " << temp[ix] << "\n";      
+            
+        // }
+
+
+   //      if (Input::List().hydromotion)
+   //      {
+   //          // Hydro Quantities:   x0 "Right-Bound ---> Left-Guard"
+            // for(size_t c(0); c < Nbc; c++) {
+            //  Y.HYDRO().density(c) = Y.HYDRO().density(Nx_local-2*Nbc+c);
+   //              Y.HYDRO().velocity(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
+            //  Y.HYDRO().temperature(c) = Y.HYDRO().temperature(Nx_local-2*Nbc+c);
+            //  // Y.HYDRO().kpressure(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
+            //  // Y.HYDRO().mpressure(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
+            // }    
+    
+   //          // Hydro Quantities:   x0 "Left-Bound ---> Right-Guard"
+            // for(size_t c(0); c < Nbc; c++) {
+            //  Y.HYDRO().density(Nx_local-Nbc+c) =  Y.HYDRO().density(Nbc+c);
+   //              Y.HYDRO().velocity(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
+            //  Y.HYDRO().temperature(Nx_local-Nbc+c) =  Y.HYDRO().temperature(Nbc+c);
+            //  // Y.HYDRO().kpressure(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
+            //  // Y.HYDRO().mpressure(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
+
+            // }
+   //      }
+
+    }
 //--------------------------------------------------------------
-        int sign(1);
 
+//--------------------------------------------------------------
+    void Node_Communications_2D::sameNode_mirror_Y(State2D& Y) {
+//--------------------------------------------------------------
+//  Mirror boundary in the x direction for 1 node
+//--------------------------------------------------------------
+        int sign(1);
+        
 
         // Mirror the harmonics
         for(size_t s(0); s < Y.Species(); ++s) {
@@ -2704,792 +3313,1080 @@ void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
                     for(size_t m(0); m < ((Y.DF(s).m0() < l)? Y.DF(s).m0():l)+1; ++m){
                         sign = 1-2*((l+m)%2);          //(-1)^(m+n)
 
+                        // right boundary
+                        for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
+                            for (size_t c(0); c < Nbc; ++c) {
+                                Y.SH(s,l,m)(p, ix, Ny_local-c-1) = Y.SH(s,l,m)(p, ix, Ny_local-2*Nbc+c);
+                                Y.SH(s,l,m)(p, ix, Ny_local-c-1) *= sign;
+                            }
+                        }
+
+                        // left boundary
                         for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
                             for (size_t c(0); c < Nbc; ++c) {
-                                Y.SH(s,l,m)(p, ix, Ny_local-c-1) = Y.SH(s,l,m)(p, ix, Ny_local-2*Nbc+c);
-                                Y.SH(s,l,m)(p, ix, Ny_local-c-1) *= sign;
+                                Y.SH(s,l,m)(p, ix, c) = Y.SH(s,l,m)(p, ix, 2*Nbc-c-1);
+                                Y.SH(s,l,m)(p, ix, c) *= sign;
                             }
                         }
-     
+
+                    }
+                }
+            }           
+        }
+
+        // Mirror the fields 
+        for(size_t i(0); i < Y.EMF().dim(); ++i){
+            for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
+               // right boundary
+               for (size_t c(0); c < Nbc; ++c) 
+                   Y.FLD(i)(ix, Ny_local-c-1) = Y.FLD(i)(ix, Ny_local-2*Nbc+c);
+               // left boundary
+               for (size_t c(0); c < Nbc; ++c) 
+                  Y.FLD(i)(ix, c) = Y.FLD(i)(ix, 2*Nbc-c-1);
+            }
+        }
+
+        for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
+            for(size_t c(0); c < Nbc; c++) {
+                //Ey
+                Y.EMF().Ey()(ix, Ny_local-Nbc+c) *= -1.0; // right boundary 
+                Y.EMF().Ey()(ix, c) *= -1.0;  // left  boundary
+
+                //Ez
+                Y.EMF().Ez()(ix, Ny_local-Nbc+c) *= -1.0; // right boundary 
+                Y.EMF().Ez()(ix, c) *= -1.0;  // left  boundary
+           
+                //Bx
+                Y.EMF().Bx()(ix, Ny_local-Nbc+c) *= -1.0; // right boundary 
+                Y.EMF().Bx()(ix, c) *= -1.0;  // left  boundary
+            }
+        }
+
+
+        // if (Input::List().hydromotion)
+        // {
+        //     // Hydro Quantities:   x0 "Right-Bound ---> Left-Guard"
+        //     for(size_t c(0); c < Nbc; c++) {
+        //         Y.HYDRO().velocity(c) *= -1.0;
+        //         // Y.HYDRO().temperature(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
+        //         // Y.HYDRO().kpressure(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
+        //         // Y.HYDRO().mpressure(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
+        //     }    
+    
+        //     // Hydro Quantities:   x0 "Left-Bound ---> Right-Guard"
+        //     for(size_t c(0); c < Nbc; c++) {
+        //         Y.HYDRO().velocity(Nx_local-Nbc+c) *= -1.0;// Y.HYDRO().velocity(Nbc+c);
+        //         // Y.HYDRO().temperature(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
+        //         // Y.HYDRO().kpressure(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
+        //         // Y.HYDRO().mpressure(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
+
+        //     }
+        // }
+
+    }
+//--------------------------------------------------------------
+
+//**************************************************************
+//**************************************************************
+//   Definition of the Parallel Environment
+//**************************************************************
+//**************************************************************
+
+
+//--------------------------------------------------------------
+    Parallel_Environment_2D:: Parallel_Environment_2D(const vector<size_t>& xcuts) : 
+//--------------------------------------------------------------
+//  Constructor, domain decomposition. Without cuts the cells are
+//  split equally, otherwise the column of nodes at x-coordinate
+//  r owns [xcuts[r], xcuts[r+1]) in x
+//--------------------------------------------------------------
+        bndX(Input::List().bndX),           // Type of boundary
+        bndY(Input::List().bndY),           // Type of boundary
+        
+        MPI_Processes_X(Input::List().MPI_X[0]),   // Number of processes in X-direction
+        MPI_Processes_Y(Input::List().MPI_X[1]),   // Number of processes in Y-direction
+        MPI_Procs(MPI_Processes_X*MPI_Processes_Y),
+        comm_cart(Cartesian_Topology()),
+        x_offset(Cut_X(comm_cart, xcuts)),
+        Bfield_Data(comm_cart),
+        X_Data(comm_cart)
+    {
+        // Determination of the rank and size of the run
+        MPI_Comm_size(Harmonic_Group::Space(), &MPI_Procs);
+        MPI_Comm_rank(comm_cart, &rank);
+
+        if (error_check()) {MPI_Finalize(); exit(1);}
+
+        // Coordinates of the node, x varies fastest with the rank
+        int coords[2];
+        MPI_Cart_coords(comm_cart, rank, 2, coords);
+        rankx.push_back(coords[1]);
+        rankx.push_back(coords[0]);
+
+        Input::List().NxOffset[0] = x_offset;
+        Input::List().NxOffset[1] = rankx[1] * Input::List().NxLocalnobnd[1];
+
+        // Determination of the local computational domain (i.e. the x-axis and the y-axis) 
+        for(size_t i(0); i < Input::List().xminLocal.size(); ++i) {
+            Input::List().xminLocal[i] = Input::List().xminGlobal[i]
+                                        + Input::List().NxOffset[i] * Input::List().globdx[i] 
+                                        - Input::List().BoundaryCells * Input::List().globdx[i];
+            Input::List().xmaxLocal[i] = Input::List().xminLocal[i] 
+                                        + (Input::List().NxLocal[i]) * Input::List().globdx[i];
+        }
+
+//        exit(0);
+
+         // Restart files will be generated when output_step % restart_step == 0 
+//          if ( ( (Input::List().n_outsteps + 1) >  Input::List().n_restarts ) &&
+//                (Input::List().n_restarts > 0)  ) { 
+//               restart_step = Input::List().n_outsteps / Input::List().n_restarts ;
+//          } 
+//          else restart_step = -1;
+//          if ( Input::List().restart_time > Input::List().n_restarts ) {
+//              restart_time = 0; 
+//          }
+//          else restart_time = Input::List().restart_time;
+
+    }
+//--------------------------------------------------------------
+//  Destructor
+//--------------------------------------------------------------
+    Parallel_Environment_2D:: ~Parallel_Environment_2D(){ 
+        int finalized;
+        MPI_Finalized(&finalized);
+        if (!finalized && (comm_cart != Harmonic_Group::Space())) MPI_Comm_free(&comm_cart);
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    MPI_Comm Parallel_Environment_2D:: Cartesian_Topology() {
+//--------------------------------------------------------------
+//  Cartesian topology of the nodes, periodic along the periodic 
+//  boundaries. The MPI library is allowed to reorder the ranks to
+//  match the network, unless the members of a harmonic group have
+//  to land on the same subdomain in their own topologies. The y 
+//  dimension comes first, so the ranks keep the order 
+//  rank = rankx + MPI_X * ranky
+//--------------------------------------------------------------
+        int dims[2]    = {static_cast<int>(Input::List().MPI_X[1]), static_cast<int>(Input::List().MPI_X[0])},
+            periods[2] = {Input::List().bndY == 0, Input::List().bndX == 0};
+        int nprocs;
+
+        // Wrong number of nodes, reported by error_check
+        MPI_Comm_size(Harmonic_Group::Space(), &nprocs);
+        if (nprocs != dims[0]*dims[1]) return Harmonic_Group::Space();
+
+        MPI_Comm comm;
+        MPI_Cart_create(Harmonic_Group::Space(), 2, dims, periods, Harmonic_Group::Size() == 1, &comm);
+        return comm;
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    size_t Parallel_Environment_2D:: Cut_X(MPI_Comm comm, const vector<size_t>& xcuts) {
+//--------------------------------------------------------------
+//  Cells of this node in x, set before the exchange modules read
+//  them. Returns the first interior x-cell of the node
+//--------------------------------------------------------------
+        if (comm == Harmonic_Group::Space()) return 0;
+
+        int rank, coords[2];
+        MPI_Comm_rank(comm, &rank);
+        MPI_Cart_coords(comm, rank, 2, coords);
+
+        if (xcuts.size() != size_t(Input::List().MPI_X[0]) + 1) 
+            return coords[1] * Input::List().NxLocalnobnd[0];
+
+        Input::List().NxLocalnobnd[0] = xcuts[coords[1]+1] - xcuts[coords[1]];
+        Input::List().NxLocal[0]      = Input::List().NxLocalnobnd[0] + 2 * Input::List().BoundaryCells;
+        return xcuts[coords[1]];
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    bool Parallel_Environment_2D:: error_check() {
+//--------------------------------------------------------------
+//  Temporary error check
+//--------------------------------------------------------------
+        if ( MPI_Procs != (MPI_Processes_X * MPI_Processes_Y) ) { 
+            if (rank == 0) std:: cout << "the number of nodes in the input deck is "
+                                      << (MPI_Processes_X * MPI_Processes_Y) << ", terminating ..." << endl;
+            return true; 
+        }
+        // Test the number of cells
+        if (rank == 0){ 
+            if (Input::List().NxLocal[0] < 2*Input::List().BoundaryCells+1){
+                std::cout<<"Not enough cells per processor in the x direction" << endl;
+                return true;
+            }
+            if (Input::List().NxLocal[1] < 2*Input::List().BoundaryCells+1){ 
+                std::cout<<"Not enough cells per processor in the y direction" << endl;
+                return true;
+            }
+         } 
+         return false;
+    }
+//--------------------------------------------------------------
+ 
+//--------------------------------------------------------------
+//  Basic information
+//--------------------------------------------------------------
+    int Parallel_Environment_2D:: RANK()  const {return rank;} 
+    int Parallel_Environment_2D:: RANKX() const {return rankx[0];} 
+    int Parallel_Environment_2D:: RANKY() const {return rankx[1];} 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+    int Parallel_Environment_2D:: MPI_Processes() const {return MPI_Procs;} 
+    int Parallel_Environment_2D:: MPI_X() const {return MPI_Processes_X;} 
+    int Parallel_Environment_2D:: MPI_Y() const {return MPI_Processes_Y;} 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+    int Parallel_Environment_2D:: BNDX()  const {return bndX;} 
+    int Parallel_Environment_2D:: BNDY()  const {return bndY;} 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+    MPI_Comm Parallel_Environment_2D:: Comm()  const {return comm_cart;} 
+//--------------------------------------------------------------
+
+
+//--------------------------------------------------------------
+    void Parallel_Environment_2D::Neighbor_ImplicitE_Communications(State2D& Y){
+//--------------------------------------------------------------
+//  Information exchange between neighbors 
+//--------------------------------------------------------------
+
+        int moduloX(RANKX()%2); 
+        int RNx((RANKX()+1)%MPI_X() +RANKY()*MPI_X()),         // This is the right neighbor 
+            LNx((RANKX()-1+MPI_X())%MPI_X()+RANKY()*MPI_X()); // This is the left  neighbor 
+        
+        
+        if (MPI_X() > 1) {
+            //even nodes 
+            if (moduloX==0){
+                Bfield_Data.Send_right_X(Y,RNx);                  //   (Send) 0 --> 1               
+                if ((RANKX() != 0) || (BNDX()==0)){
+                    Bfield_Data.Recv_from_left_X(Y,LNx);          //          1 --> 0 (Receive)   
+                    Bfield_Data.Send_left_X(Y,LNx);               //          1 <-- 0 (Send)
+                }
+                else {
+                    if (BNDX()==1) {
+                        Bfield_Data.mirror_bound_Xleft(Y);        // Update node "0" in the x direction
+                    }
+                    else {
+                        cout<<"Invalid Boundary." << endl;
+                    }
+               } 
+               Bfield_Data.Recv_from_right_X(Y,RNx);               // (Receive) 0 <-- 1                            
+            }
+            //odd nodes 
+            else {
+                Bfield_Data.Recv_from_left_X(Y,LNx);               //           0 --> 1 (Receive)               
+                if ((RANKX()!=(MPI_X()-1)) || (BNDX()==0)){
+                     Bfield_Data.Send_right_X(Y,RNx);              //   (Send)  1 --> 0 
+                     Bfield_Data.Recv_from_right_X(Y,RNx);         // (Receive) 1 <-- 0
+                }
+                else {
+                    if (BNDX()==1) {
+                        Bfield_Data.mirror_bound_Xright(Y);        // Update node "N-1" in the x direction
+                    }
+                    else {
+                        cout<<"Invalid Boundary." << endl;;
+                    }
+                } 
+                Bfield_Data.Send_left_X(Y,LNx);                    //           0 <-- 1 (Send)              
+            } 
+        }
+        else { Bfield_Data.sameNode_bound_X(Y); }
+
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+         int moduloY(RANKY()%2);
+         int RNy((RANK()+MPI_X())%MPI_Processes()),                  // This is the right neighbor 
+             LNy((RANK()-MPI_X()+MPI_Processes())%MPI_Processes());          // This is the left  neighbor 
+
+         if (MPI_Y() > 1) {
+            //even nodes 
+            if (moduloY==0){
+                Bfield_Data.Send_right_Y(Y,RNy);                     //   (Send) 0 --> 1               
+                if ((RANKY() != 0) || (BNDY()==0)){
+                    Bfield_Data.Recv_from_left_Y(Y,LNy);             //          1 --> 0 (Receive)                
+                    Bfield_Data.Send_left_Y(Y,LNy);                  //          1 <-- 0 (Send)
+                }
+                else {
+                    if (BNDY()==1) {
+                        Bfield_Data.mirror_bound_Yleft(Y);          //  Update node "0" in the y direction
+                    }
+                    else {
+                        cout<<"Invalid Boundary." << endl;
+                    }
+                }  
+                Bfield_Data.Recv_from_right_Y(Y,RNy);                // (Receive) 0 <-- 1                            
+            }
+            //odd nodes 
+            else {
+                Bfield_Data.Recv_from_left_Y(Y,LNy);                 //           0 --> 1 (Receive)               
+                if ((RANKY()!=(MPI_Y()-1)) || (BNDY()==0)){
+                     Bfield_Data.Send_right_Y(Y,RNy);                //   (Send)  1 --> 0 
+                     Bfield_Data.Recv_from_right_Y(Y,RNy);           // (Receive) 1 <-- 0
+                }
+                else {
+                    if (BNDY()==1) {
+                        Bfield_Data.mirror_bound_Yright(Y);          // Update node "N-1" in the x direction
                     }
-                }
+                    else {
+                        cout<<"Invalid Boundary." << endl;
+                    }
+                } 
+                Bfield_Data.Send_left_Y(Y,LNy);                      //           0 <-- 1 (Send)              
             }
-        }
+         }
+         else { Bfield_Data.sameNode_bound_Y(Y); }
+    }
+//--------------------------------------------------------------
 
-        // Mirror the fields 
-        for(size_t i(0); i < Y.EMF().dim(); ++i){
-           for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
-                for (size_t c(0); c < Nbc; ++c) {
-                    Y.FLD(i)(ix,Ny_local-c-1) = Y.FLD(i)(ix,Ny_local-2*Nbc+c);
-                }
-            }
-        }
 
-        for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
-            for (size_t c(0); c < Nbc; ++c) {
-                //Ey
-                Y.EMF().Ey()(ix,Ny_local-c-1) *= -1.0; // right boundary 
-                //Ez
-                Y.EMF().Ez()(ix,Ny_local-c-1) *= -1.0; // right boundary 
-                //Bx
-                Y.EMF().Bx()(ix,Ny_local-c-1) *= -1.0; // right boundary 
-            }
-        }
+//--------------------------------------------------------------
+    void Parallel_Environment_2D::Neighbor_Communications(State2D& Y){
+//--------------------------------------------------------------
+//  Information exchange between neighbors 
+//--------------------------------------------------------------
 
-        // if (Input::List().hydromotion)
-        // {
-        //     // Hydro Quantities:   x0 "Left-Bound ---> Right-Guard"
-        //     for (size_t c(0); c < Nbc; c++) {
-        //         Y.HYDRO().velocity(Nx_local-Nbc+c) *=  -1.0;
-        //     }
-        // }
+        Neighbor_Communications_Post(Y);
+        Neighbor_Communications_Complete(Y);
 
     }
 //--------------------------------------------------------------
 
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-//  Boundary conditions on both sides of a node
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-
 //--------------------------------------------------------------
-    void Node_Communications_2D::sameNode_bound_X(State2D& Y) {
+    void Parallel_Environment_2D::Neighbor_Communications_Post(State2D& Y){
 //--------------------------------------------------------------
-//  Choose between boundary conditions in the x direction
+//  Post the exchange of the faces and the corners with all the 
+//  neighbors on the Cartesian topology
 //--------------------------------------------------------------
-    
-        switch (BNDX()) {
-            case 0:                   // periodic
 
-                sameNode_periodic_X(Y);
+        X_Data.Post(Y);
 
-                break;
-            case 1:                   // mirror boundary
-                sameNode_mirror_X(Y);
-                break;
-            default:
-                cout<<"Not a valid boundary condition." << endl;
-                break;
-        }
     }
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-    void Node_Communications_2D::sameNode_periodic_X(State2D& Y) {
+    void Parallel_Environment_2D::Neighbor_Communications_Complete(State2D& Y){
 //--------------------------------------------------------------
-//  Periodic boundary in the x direction for 1 node
+//  Finish the exchange and update the guard cells that have no 
+//  neighbor. The x boundaries cover the guard cells of all the 
+//  rows, so that the y boundaries complete the corners
 //--------------------------------------------------------------
-        // valarray<double> temp(0.0,Y.SH(0,0,0).numx());
-  
-       
-
-       // temp = Y.DF(0).getcurrent(0);
-       // for (size_t ix(0);ix<Y.SH(0,0,0).numx();++ix)
-    //     {        
-    //         std::cout<<"\n original[" << ix  << "] = " << temp[ix] << "\n";      
-            
-            
-    //     }
 
+        X_Data.Complete(Y);
 
-
-        // Harmonics:x0 "Right-Bound ---> Left-Guard" 
-        for(size_t s(0); s < Y.Species(); ++s) {
-            for(size_t i(0); i < Y.DF(s).dim(); ++i) {
-                for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
-                    for(size_t c(0); c < Nbc; c++) {
-                        for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                            (Y.DF(s)(i))(p, c, iy) = (Y.DF(s)(i))(p, Nx_local-2*Nbc+c, iy);
-                            // std::cout << "\n 1: DF(" << i << "," << p << "," << c << ") = " << (Y.DF(s)(i))(p, Nx_local-2*Nbc+c) << "\n";
-                        }
-                    }
+        if (MPI_X() > 1) {
+            if (BNDX() != 0) {
+                if (RANKX() == 0) {
+                    if (BNDX()==1) X_Data.mirror_bound_Xleft(Y);     // Update node "0" in the x direction
+                    else cout<<"Invalid Boundary." << endl;
                 }
-            }
-        }
-        
-        // Fields:   x0 "Right-Bound ---> Left-Guard"
-        for(size_t i(0); i < Y.EMF().dim(); ++i) {
-            for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
-                for(size_t c(0); c < Nbc; c++) {
-                    Y.FLD(i)(c,iy) = Y.FLD(i)(Nx_local-2*Nbc+c,iy);
-                    // std::cout << "\n 2: FLD(" << i << "," << c << ") = " << Y.FLD(i)(Nx_local-2*Nbc+c) << "\n";
+                if (RANKX() == MPI_X()-1) {
+                    if (BNDX()==1) X_Data.mirror_bound_Xright(Y);    // Update node "N-1" in the x direction
+                    else cout<<"Invalid Boundary." << endl;
                 }
             }
         }
-        
-
-
-        // Harmonics:x0 "Left-Bound ---> Right-Guard" 
-        for(size_t s(0); s < Y.Species(); ++s) {
-            for(size_t i(0); i < Y.DF(s).dim(); ++i) {
-                for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells                    
-                    for(size_t c(0); c < Nbc; c++) {
-                        for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                            // std::cout << "\n 3: DF(" << i << "," << p << "," << Nx_local-Nbc+c << ") = " << (Y.DF(s)(i))(p, Nx_local-Nbc+c) << "\n";
-
-                            (Y.DF(s)(i))(p, Nx_local-Nbc+c,iy) = (Y.DF(s)(i))(p, Nbc+c,iy);
+        else { X_Data.sameNode_bound_X(Y); }
 
-                            // std::cout << "\n 3n: DF(" << i << "," << p << "," << Nx_local-Nbc+c << ") = " << (Y.DF(s)(i))(p, Nx_local-Nbc+c-100.0) << "\n";
-                            // if (c==2)
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-                            
-                        }
-                    }
+        if (MPI_Y() > 1) {
+            if (BNDY() != 0) {
+                if (RANKY() == 0) {
+                    if (BNDY()==1) X_Data.mirror_bound_Yleft(Y);     //  Update node "0" in the y direction
+                    else cout<<"Invalid Boundary." << endl;
                 }
-            }
-        }
-        
-        // Fields:   x0 "Left-Bound ---> Right-Guard"
-        for(size_t i(0); i < Y.EMF().dim(); ++i) {
-            for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells
-                for(size_t c(0); c < Nbc; c++) {
-                    // if (i == 0)                 std::cout << "\n 4: FLD(" << i << "," << Nx_local-Nbc+c << ") = " << Y.FLD(i)(Nx_local-Nbc+c) << "\n";
-                    Y.FLD(i)(Nx_local-Nbc+c,iy) = Y.FLD(i)(Nbc+c,iy);
-                    // if (i == 0)                 std::cout << "\n 4n: FLD(" << i << "," << Nx_local-Nbc+c << ") = " << Y.FLD(i)(Nx_local-Nbc+c) << "\n";
+                if (RANKY() == MPI_Y()-1) {
+                    if (BNDY()==1) X_Data.mirror_bound_Yright(Y);    // Update node "N-1" in the y direction
+                    else cout<<"Invalid Boundary." << endl;
                 }
             }
-            // Y.FLD(i)(Nx_local-1) = 0.0;
         }
-        
+        else { X_Data.sameNode_bound_Y(Y); }
 
-        // temp = Y.DF(0).getcurrent(0);
-        // for (size_t ix(0);ix<Y.SH(0,0,0).numx();++ix)
-        // {        
-        //     std::cout<<"\n      new[" << ix  << "] = " << temp[ix] << "\n";      
-            
-        // }
+    }
+//--------------------------------------------------------------
 
+//**************************************************************
 
-   //      if (Input::List().hydromotion)
-   //      {
-   //          // Hydro Quantities:   x0 "Right-Bound ---> Left-Guard"
-            // for(size_t c(0); c < Nbc; c++) {
-            //  Y.HYDRO().density(c) = Y.HYDRO().density(Nx_local-2*Nbc+c);
-   //              Y.HYDRO().velocity(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
-            //  Y.HYDRO().temperature(c) = Y.HYDRO().temperature(Nx_local-2*Nbc+c);
-            //  // Y.HYDRO().kpressure(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
-            //  // Y.HYDRO().mpressure(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
-            // }    
-    
-   //          // Hydro Quantities:   x0 "Left-Bound ---> Right-Guard"
-            // for(size_t c(0); c < Nbc; c++) {
-            //  Y.HYDRO().density(Nx_local-Nbc+c) =  Y.HYDRO().density(Nbc+c);
-   //              Y.HYDRO().velocity(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
-            //  Y.HYDRO().temperature(Nx_local-Nbc+c) =  Y.HYDRO().temperature(Nbc+c);
-            //  // Y.HYDRO().kpressure(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
-            //  // Y.HYDRO().mpressure(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
 
-            // }
-   //      }
+//**************************************************************
+//**************************************************************
+//   Definition of the Load Balance
+//**************************************************************
+//**************************************************************
 
+//  Imbalance of the most expensive node that triggers a re-cut
+static const double balance_threshold(0.05);
+
+//--------------------------------------------------------------
+//  The harmonics and the fields of the state, with the number of
+//  values in each cell. These are the arrays of the restart file
+static vector< pair<complex<double>*, size_t> > balance_arrays(State1D& Y){
+
+    vector< pair<complex<double>*, size_t> > arrays;
+    for (size_t s(0); s < Y.Species(); ++s) {
+        for (size_t nh(0); nh < Y.DF(s).dim(); ++nh) {
+            arrays.push_back(std::make_pair(&((Y.DF(s))(nh).array().array()[0]), (Y.DF(s))(0).nump()));
+        }
     }
+    for (size_t ifields(0); ifields < Y.Fields(); ++ifields) {
+        arrays.push_back(std::make_pair(&(Y.FLD(ifields).array()[0]), size_t(1)));
+    }
+    return arrays;
+}
 //--------------------------------------------------------------
+static vector< pair<complex<double>*, size_t> > balance_arrays(State2D& Y){
 
+    vector< pair<complex<double>*, size_t> > arrays;
+    for (size_t s(0); s < Y.Species(); ++s) {
+        for (size_t nh(0); nh < Y.DF(s).dim(); ++nh) {
+            arrays.push_back(std::make_pair(&((Y.DF(s))(nh).array().array()[0]), (Y.DF(s))(0).nump()));
+        }
+    }
+    for (size_t ifields(0); ifields < Y.Fields(); ++ifields) {
+        arrays.push_back(std::make_pair(&(Y.FLD(ifields).array().array()[0]), size_t(1)));
+    }
+    return arrays;
+}
 //--------------------------------------------------------------
-    void Node_Communications_2D::sameNode_mirror_X(State2D& Y) {
+
 //--------------------------------------------------------------
-//  Mirror boundary in the x direction for 1 node
+Load_Balance:: Load_Balance() :
 //--------------------------------------------------------------
-        int sign(1);
-
-
-        // Mirror the harmonics
-        for(size_t s(0); s < Y.Species(); ++s) {
-            for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells                
-                for(size_t l(0); l < Y.DF(s).l0(); ++l){
-                    for(size_t m(0); m < ((Y.DF(s).m0() < l)? Y.DF(s).m0():l)+1; ++m){
-                        sign = 1-2*((l+m)%2);          //(-1)^(m+n)
-
-                        // right boundary
-                        for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                            for (size_t c(0); c < Nbc; ++c) {
-                                Y.SH(s,l,m)(p, Nx_local-c-1, iy) = Y.SH(s,l,m)(p, Nx_local-2*Nbc+c, iy);
-                                Y.SH(s,l,m)(p, Nx_local-c-1, iy) *= sign;
-                            }
-                        }
-
-                        // left boundary
-                        for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                            for (size_t c(0); c < Nbc; ++c) {
-                                Y.SH(s,l,m)(p, c, iy) = Y.SH(s,l,m)(p, 2*Nbc-c-1, iy);
-                                Y.SH(s,l,m)(p, c, iy) *= sign;
-                            }
-                        }
+//  Constructor, the cells can only change owner when the restart
+//  and the particles do not depend on the decomposition
+//--------------------------------------------------------------
+        active(Input::List().mpi_balance_every > 0 && Input::List().MPI_X[0] > 1), 
+        steps(0), started(0.0), computing(0.0),
+        kept_rankx(0), kept_ranky(0)
+{
+    if (!active) return;
 
-                    }
-                }
-            }           
-        }
+    if (!Input::List().single_restart_file || !Input::List().local_restart_dir.empty()
+        || Input::List().particlepusher) {
+        int rank;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        if (!rank) std::cout << "\n MPI_Balance_every needs single_restart_file, no local_restart_dir and no particles,"
+                             << " the load balance is off \n";
+        active = false;
+    }
+}
+//--------------------------------------------------------------
 
-        // Mirror the fields 
-        for(size_t i(0); i < Y.EMF().dim(); ++i){
-            for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells    
-               // right boundary
-               for (size_t c(0); c < Nbc; ++c) 
-                   Y.FLD(i)(Nx_local-c-1,iy) = Y.FLD(i)(Nx_local-2*Nbc+c,iy);
-               // left boundary
-               for (size_t c(0); c < Nbc; ++c) 
-                  Y.FLD(i)(c,iy) = Y.FLD(i)(2*Nbc-c-1,iy);
-            }
-        }
+//--------------------------------------------------------------
+const vector<size_t>& Load_Balance:: Cuts() const {return cuts;}
+bool Load_Balance:: Pending() const {return !carry.empty();}
 
-        for(size_t iy(0); iy < Ny_local; ++iy){  // All the y cells    
-            for(size_t c(0); c < Nbc; c++) {
-                //Ey
-                Y.EMF().Ey()(Nx_local-Nbc+c,iy) *= -1.0; // right boundary 
-                Y.EMF().Ey()(c,iy) *= -1.0;  // left  boundary
+void Load_Balance:: Resume() {started = MPI_Wtime();}
+void Load_Balance:: Pause()  {computing += MPI_Wtime() - started;}
+//--------------------------------------------------------------
 
-                //Ez
-                Y.EMF().Ez()(Nx_local-Nbc+c,iy) *= -1.0; // right boundary 
-                Y.EMF().Ez()(c,iy) *= -1.0;  // left  boundary
-           
-                //Bx
-                Y.EMF().Bx()(Nx_local-Nbc+c,iy) *= -1.0; // right boundary 
-                Y.EMF().Bx()(c,iy) *= -1.0;  // left  boundary
-            }
-        }
+//--------------------------------------------------------------
+bool Load_Balance:: Due() {
+//--------------------------------------------------------------
+//  Every mpi_balance_every steps, all the nodes count the same
+//  steps since the time step is global
+//--------------------------------------------------------------
+    if (!active) return false;
+    return (++steps % Input::List().mpi_balance_every == 0);
+}
+//--------------------------------------------------------------
 
+//--------------------------------------------------------------
+bool Load_Balance:: Recut(valarray<double>& cost) {
+//--------------------------------------------------------------
+//  The cost of the x-cells of the node is the time of their 
+//  f00 collisions, the rest of the computing time is shared
+//  uniformly. The new cut k sits at the k-th share of the total 
+//  cost, it stays between the old cuts k-1 and k+1 so that the 
+//  cells only move between neighbors
+//--------------------------------------------------------------
+    size_t T(Input::List().MPI_X[0]),
+           Nmin(std::max(size_t(Input::List().BoundaryCells), size_t(2)));
 
-        // if (Input::List().hydromotion)
-        // {
-        //     // Hydro Quantities:   x0 "Right-Bound ---> Left-Guard"
-        //     for(size_t c(0); c < Nbc; c++) {
-        //         Y.HYDRO().velocity(c) *= -1.0;
-        //         // Y.HYDRO().temperature(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
-        //         // Y.HYDRO().kpressure(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
-        //         // Y.HYDRO().mpressure(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
-        //     }    
-    
-        //     // Hydro Quantities:   x0 "Left-Bound ---> Right-Guard"
-        //     for(size_t c(0); c < Nbc; c++) {
-        //         Y.HYDRO().velocity(Nx_local-Nbc+c) *= -1.0;// Y.HYDRO().velocity(Nbc+c);
-        //         // Y.HYDRO().temperature(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
-        //         // Y.HYDRO().kpressure(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
-        //         // Y.HYDRO().mpressure(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
+    if (cuts.empty()) {
+        for (size_t k(0); k < T+1; ++k) cuts.push_back(k * Input::List().NxLocalnobnd[0]);
+    }
+    size_t N(cuts.back());
+
+    double rest(computing - cost.sum());
+    if (rest > 0.0) cost += rest / cost.size();
+    computing = 0.0;
+
+    valarray<double> local(0.0, N), global(0.0, N);
+    for (size_t ix(0); ix < cost.size(); ++ix) local[Input::List().NxOffset[0] + ix] = cost[ix];
+    MPI_Allreduce(&local[0], &global[0], N, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+    // Imbalance of the current cuts
+    double total(global.sum()), heaviest(0.0);
+    for (size_t k(0); k < T; ++k) {
+        double node(0.0);
+        for (size_t ix(cuts[k]); ix < cuts[k+1]; ++ix) node += global[ix];
+        heaviest = std::max(heaviest, node);
+    }
+    double imbalance(heaviest * T / total - 1.0);
+    if (!(imbalance > balance_threshold)) return false;
 
-        //     }
-        // }
+    // Cumulative cost
+    valarray<double> below(0.0, N+1);
+    for (size_t ix(0); ix < N; ++ix) below[ix+1] = below[ix] + global[ix];
+
+    vector<size_t> recut(cuts);
+    for (size_t k(1); k < T; ++k) {
+        size_t lo(std::max(recut[k-1] + Nmin, cuts[k-1])),
+               hi(std::min(cuts[k+1], N - Nmin * (T-k)));
+        if (lo > hi) continue;
 
+        double share(total * k / T);
+        recut[k] = lo;
+        for (size_t ix(lo+1); ix < hi+1; ++ix) {
+            if (fabs(below[ix] - share) < fabs(below[recut[k]] - share)) recut[k] = ix;
+        }
+    }
+    if (recut == cuts) return false;
+
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    if (!rank) {
+        std::streamsize precision(std::cout.precision());
+        std::cout << "\n Load balance: " << std::setprecision(3) << 100.0 * imbalance << "% imbalance, x-cuts at"
+                  << std::setprecision(precision);
+        for (size_t k(1); k < T; ++k) std::cout << " " << recut[k];
+        std::cout << "\n";
     }
+
+    old_cuts = cuts;
+    cuts     = recut;
+    return true;
+}
 //--------------------------------------------------------------
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-//  Boundary conditions on both sides of a node
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
 //--------------------------------------------------------------
-    void Node_Communications_2D::sameNode_bound_Y(State2D& Y) {
+void Load_Balance:: Keep(const Arrays& arrays, const size_t rows, const size_t row0, const size_t k) {
 //--------------------------------------------------------------
-//  Choose between boundary conditions in the y direction
+//  Copy of the interior rows of the node before the re-partition
 //--------------------------------------------------------------
-    
-        switch (BNDY()) {
-            case 0:                   // periodic
-                sameNode_periodic_Y(Y);
+    size_t Nbc(Input::List().BoundaryCells), 
+           numx(Input::List().NxLocal[0]),
+           cells(old_cuts[k+1] - old_cuts[k]);
 
-                break;
-            case 1:                   // mirror boundary
-                sameNode_mirror_Y(Y);
-                break;
-            default:
-                cout<<"Not a valid boundary condition." << endl;
-                break;
+    carry.resize(arrays.size());
+    for (size_t a(0); a < arrays.size(); ++a) {
+        size_t nump(arrays[a].second);
+        carry[a].resize(rows * cells * nump);
+        for (size_t r(0); r < rows; ++r) {
+            complex<double>* row(arrays[a].first + ((row0 + r) * numx + Nbc) * nump);
+            std::copy(row, row + cells * nump, &carry[a][r * cells * nump]);
         }
     }
+}
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-    void Node_Communications_2D::sameNode_periodic_Y(State2D& Y) {
+void Load_Balance:: Hand_over(const Arrays& arrays, const size_t rows, const size_t row0, const size_t k,
+                              const int left, const int right, MPI_Comm comm) {
 //--------------------------------------------------------------
-//  Periodic boundary in the x direction for 1 node
+//  The node keeps the overlap of its old and new cells, sends 
+//  [o0,n0) to the left and [n1,o1) to the right and receives
+//  [n0,o0) from the left and [o1,n1) from the right
 //--------------------------------------------------------------
-        // valarray<double> temp(0.0,Y.SH(0,0,0).numx());
-  
-       
+    size_t Nbc(Input::List().BoundaryCells), 
+           numx(Input::List().NxLocal[0]),
+           o0(old_cuts[k]), o1(old_cuts[k+1]), 
+           n0(cuts[k]),     n1(cuts[k+1]);
 
-       // temp = Y.DF(0).getcurrent(0);
-       // for (size_t ix(0);ix<Y.SH(0,0,0).numx();++ix)
-       //  {        
-       //      std::cout<<"\n original[" << ix  << "] = " << temp[ix] << "\n";      
-            
-            
-       //  }
+    size_t per_cell(0);
+    for (size_t a(0); a < arrays.size(); ++a) per_cell += rows * arrays[a].second;
 
-        // Harmonics:x0 "Right-Bound ---> Left-Guard" 
-        for(size_t s(0); s < Y.Species(); ++s) {
-            for(size_t i(0); i < Y.DF(s).dim(); ++i) {
-                for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
-                    for(size_t c(0); c < Nbc; c++) {
-                        for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                            
-                            (Y.DF(s)(i))(p, ix, c) = (Y.DF(s)(i))(p, ix, Ny_local-2*Nbc+c);
-                            // std::cout << "\n 1: DF(" << i << "," << p << "," << c << ") = " << (Y.DF(s)(i))(p, Nx_local-2*Nbc+c) << "\n";
-                        }
-                    }
-                }
+    // [x0,x1) of the old cells to a message
+    struct Range { size_t x0, x1; size_t size() const {return (x1 > x0) ? x1 - x0 : 0;} };
+    Range to_left  = {o0, std::min(n0, o1)},        to_right   = {std::max(n1, o0), o1},
+          from_left = {n0, std::min(o0, n1)},       from_right = {std::max(o1, n0), n1},
+          kept      = {std::max(o0, n0), std::min(o1, n1)};
+
+    vector< vector< complex<double> > > msg(5);
+    Range ranges[5] = {to_left, to_right, from_left, from_right, kept};
+    for (size_t m(0); m < 5; ++m) msg[m].resize(ranges[m].size() * per_cell + 1);
+
+    // Pack from the kept interior
+    const size_t outgoing[3] = {0, 1, 4};
+    for (size_t o(0); o < 3; ++o) {
+        size_t m(outgoing[o]);
+        complex<double>* buf(&msg[m][0]);
+        for (size_t a(0); a < arrays.size(); ++a) {
+            size_t nump(arrays[a].second);
+            for (size_t r(0); r < rows; ++r) {
+                const complex<double>* src(&carry[a][(r * (o1 - o0) + ranges[m].x0 - o0) * nump]);
+                buf = std::copy(src, src + ranges[m].size() * nump, buf);
             }
         }
-        
-        // Fields:   x0 "Right-Bound ---> Left-Guard"
-        for(size_t i(0); i < Y.EMF().dim(); ++i) {
-            for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
-                for(size_t c(0); c < Nbc; c++) {
-                    Y.FLD(i)(ix, c) = Y.FLD(i)(ix, Ny_local-2*Nbc+c);
-                    // std::cout << "\n 2: FLD(" << i << "," << c << ") = " << Y.FLD(i)(Nx_local-2*Nbc+c) << "\n";
-                }
+    }
+
+    MPI_Request request[4];
+    MPI_Irecv(&msg[2][0], ranges[2].size() * per_cell, MPI_DOUBLE_COMPLEX, left,  1, comm, &request[0]);
+    MPI_Irecv(&msg[3][0], ranges[3].size() * per_cell, MPI_DOUBLE_COMPLEX, right, 0, comm, &request[1]);
+    MPI_Isend(&msg[0][0], ranges[0].size() * per_cell, MPI_DOUBLE_COMPLEX, left,  0, comm, &request[2]);
+    MPI_Isend(&msg[1][0], ranges[1].size() * per_cell, MPI_DOUBLE_COMPLEX, right, 1, comm, &request[3]);
+    MPI_Waitall(4, request, MPI_STATUSES_IGNORE);
+
+    // Unpack to the new interior
+    for (size_t m(2); m < 5; ++m) {
+        const complex<double>* buf(&msg[m][0]);
+        for (size_t a(0); a < arrays.size(); ++a) {
+            size_t nump(arrays[a].second);
+            for (size_t r(0); r < rows; ++r) {
+                complex<double>* dst(arrays[a].first + ((row0 + r) * numx + Nbc + ranges[m].x0 - n0) * nump);
+                std::copy(buf, buf + ranges[m].size() * nump, dst);
+                buf += ranges[m].size() * nump;
             }
         }
-        // std::cout << "13 \n";
+    }
 
+    carry.clear();
+}
+//--------------------------------------------------------------
 
-        // Harmonics:x0 "Left-Bound ---> Right-Guard" 
-        for(size_t s(0); s < Y.Species(); ++s) {
-            for(size_t i(0); i < Y.DF(s).dim(); ++i) {
-                for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
-                    for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                        for(size_t c(0); c < Nbc; c++) {
-                            // std::cout << "\n 3: DF(" << i << "," << p << "," << Nx_local-Nbc+c << ") = " << (Y.DF(s)(i))(p, Nx_local-Nbc+c) << "\n";
+//--------------------------------------------------------------
+bool Load_Balance:: Repartition(const Parallel_Environment_1D& PE, collisions_1D& collide, State1D& Y) {
+//--------------------------------------------------------------
+    if (!Due()) return false;
 
-                            (Y.DF(s)(i))(p, ix, Ny_local-Nbc+c) = (Y.DF(s)(i))(p, ix, Nbc+c);
+    valarray<double> cost(0.0, Input::List().NxLocalnobnd[0]);
+    collide.celltime(cost);
 
-                            // std::cout << "\n 3n: DF(" << i << "," << p << "," << Nx_local-Nbc+c << ") = " << (Y.DF(s)(i))(p, Nx_local-Nbc+c-100.0) << "\n";
-                            // if (c==2)
+    if (!Recut(cost)) return false;
 
-                            
-                        }
-                    }
-                }
-            }
-        }
-        // std::cout << "14 \n";
-        // Fields:   x0 "Left-Bound ---> Right-Guard"
-        for(size_t i(0); i < Y.EMF().dim(); ++i) {
-            for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
-                for(size_t c(0); c < Nbc; c++) {
-                    // if (i == 0)                 std::cout << "\n 4: FLD(" << i << "," << Nx_local-Nbc+c << ") = " << Y.FLD(i)(Nx_local-Nbc+c) << "\n";
-                    Y.FLD(i)(ix, Ny_local-Nbc+c) = Y.FLD(i)(ix, Nbc+c);
-                    // if (i == 0)                 std::cout << "\n 4n: FLD(" << i << "," << Nx_local-Nbc+c << ") = " << Y.FLD(i)(Nx_local-Nbc+c) << "\n";
-                }
-            }
-            // Y.FLD(i)(Nx_local-1) = 0.0;
-        }
-        // std::cout << "15 \n";
-        // temp = Y.DF(0).getcurrent(0);
-        // for (size_t ix(0);ix<Y.SH(0,0,0).numx();++ix)
-        // {        
-        //     std::cout<<"\n      new[" << ix  << "] = " << temp[ix] << "\n";      
-            
-        // }
+    Keep(balance_arrays(Y), 1, 0, PE.RANK());
+    return true;
+}
+//--------------------------------------------------------------
+bool Load_Balance:: Repartition(const Parallel_Environment_2D& PE, collisions_2D& collide, State2D& Y) {
+//--------------------------------------------------------------
+//  The columns of nodes share the cuts, the cost of an x-cell 
+//  adds up along y
+//--------------------------------------------------------------
+    if (!Due()) return false;
 
+    Array2D<double> seconds(Input::List().NxLocalnobnd[0], Input::List().NxLocalnobnd[1]);
+    seconds = 0.0;
+    collide.celltime(seconds);
 
-   //      if (Input::List().hydromotion)
-   //      {
-   //          // Hydro Quantities:   x0 "Right-Bound ---> Left-Guard"
-            // for(size_t c(0); c < Nbc; c++) {
-            //  Y.HYDRO().density(c) = Y.HYDRO().density(Nx_local-2*Nbc+c);
-   //              Y.HYDRO().velocity(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
-            //  Y.HYDRO().temperature(c) = Y.HYDRO().temperature(Nx_local-2*Nbc+c);
-            //  // Y.HYDRO().kpressure(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
-            //  // Y.HYDRO().mpressure(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
-            // }    
-    
-   //          // Hydro Quantities:   x0 "Left-Bound ---> Right-Guard"
-            // for(size_t c(0); c < Nbc; c++) {
-            //  Y.HYDRO().density(Nx_local-Nbc+c) =  Y.HYDRO().density(Nbc+c);
-   //              Y.HYDRO().velocity(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
-            //  Y.HYDRO().temperature(Nx_local-Nbc+c) =  Y.HYDRO().temperature(Nbc+c);
-            //  // Y.HYDRO().kpressure(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
-            //  // Y.HYDRO().mpressure(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
+    valarray<double> cost(0.0, seconds.dim1());
+    for (size_t iy(0); iy < seconds.dim2(); ++iy) {
+        for (size_t ix(0); ix < seconds.dim1(); ++ix) cost[ix] += seconds(ix,iy);
+    }
 
-            // }
-   //      }
+    if (!Recut(cost)) return false;
 
-    }
+    kept_rankx = PE.RANKX();
+    kept_ranky = PE.RANKY();
+    Keep(balance_arrays(Y), Input::List().NxLocalnobnd[1], Input::List().BoundaryCells, PE.RANKX());
+    return true;
+}
 //--------------------------------------------------------------
 
 //--------------------------------------------------------------
-    void Node_Communications_2D::sameNode_mirror_Y(State2D& Y) {
+void Load_Balance:: Take_over(Parallel_Environment_1D& PE, State1D& Y) {
 //--------------------------------------------------------------
-//  Mirror boundary in the x direction for 1 node
+    int left( (PE.RANK() > 0) ? PE.RANK()-1 : MPI_PROC_NULL ),
+        right((PE.RANK() < PE.MPI_Processes()-1) ? PE.RANK()+1 : MPI_PROC_NULL);
+
+    Hand_over(balance_arrays(Y), 1, 0, PE.RANK(), left, right, Harmonic_Group::Space());
+    PE.Neighbor_Communications(Y);
+}
 //--------------------------------------------------------------
-        int sign(1);
-        
+void Load_Balance:: Take_over(Parallel_Environment_2D& PE, State2D& Y) {
+//--------------------------------------------------------------
+//  The Cartesian topology of the new epoch has to place the node 
+//  where it was
+//--------------------------------------------------------------
+    if (PE.RANKX() != kept_rankx || PE.RANKY() != kept_ranky) {
+        std::cout << "\n Load balance: the Cartesian topology moved node " << PE.RANK() << ", terminating ... \n";
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
 
-        // Mirror the harmonics
-        for(size_t s(0); s < Y.Species(); ++s) {
-            for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
-                for(size_t l(0); l < Y.DF(s).l0(); ++l){
-                    for(size_t m(0); m < ((Y.DF(s).m0() < l)? Y.DF(s).m0():l)+1; ++m){
-                        sign = 1-2*((l+m)%2);          //(-1)^(m+n)
+    int left(MPI_PROC_NULL), right(MPI_PROC_NULL), neighbor[2] = {PE.RANKY(), 0};
+    if (PE.RANKX() > 0)              { neighbor[1] = PE.RANKX()-1; MPI_Cart_rank(PE.Comm(), neighbor, &left);  }
+    if (PE.RANKX() < PE.MPI_X()-1)   { neighbor[1] = PE.RANKX()+1; MPI_Cart_rank(PE.Comm(), neighbor, &right); }
 
-                        // right boundary
-                        for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                            for (size_t c(0); c < Nbc; ++c) {
-                                Y.SH(s,l,m)(p, ix, Ny_local-c-1) = Y.SH(s,l,m)(p, ix, Ny_local-2*Nbc+c);
-                                Y.SH(s,l,m)(p, ix, Ny_local-c-1) *= sign;
-                            }
-                        }
+    Hand_over(balance_arrays(Y), Input::List().NxLocalnobnd[1], Input::List().BoundaryCells, PE.RANKX(), left, right, PE.Comm());
+    PE.Neighbor_Communications(Y);
+}
+//--------------------------------------------------------------
 
-                        // left boundary
-                        for(size_t p(0); p < Y.SH(s,0,0).nump(); ++p) {
-                            for (size_t c(0); c < Nbc; ++c) {
-                                Y.SH(s,l,m)(p, ix, c) = Y.SH(s,l,m)(p, ix, 2*Nbc-c-1);
-                                Y.SH(s,l,m)(p, ix, c) *= sign;
-                            }
-                        }
+//**************************************************************
+//**************************************************************
+//   Definition of the split RK2 stage
+//**************************************************************
+//**************************************************************
 
-                    }
+//  Cells beyond the boundary cells that the stage reads, the
+//  reach of the 4th order x-derivative
+static const size_t edge_reach(2);
+
+//--------------------------------------------------------------
+//  Boundary cells [0,x0) and [x1,N) as in the collisions, the 
+//  edges [0,a) and [b,N) are copied. Without an interior beyond
+//  the reach of both edges the first pass takes every cell
+static void edge_cells(const size_t N, size_t& x0, size_t& x1, size_t& a, size_t& b){
+
+    size_t Nbc(Input::List().BoundaryCells);
+
+    x0 = std::min(2*Nbc,N/2);
+    x1 = std::max(N-2*Nbc,x0);
+    a  = x0 + edge_reach;
+    b  = (x1 > edge_reach) ? x1 - edge_reach : 0;
+
+    if (a >= b) { x0 = N; x1 = N; a = N; b = N; }
+}
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+template<class T> static void put(T& to, const T& from, const bool add){
+    if (add) to += from;
+    else     to  = from;
+}
+//--------------------------------------------------------------
+//  Cells [f0,f0+n) of From to [t0,t0+n) of To, added if add
+static void cells(const State1D& From, const size_t f0, State1D& To, const size_t t0, 
+                  const size_t n, const bool add){
+
+    for(size_t s(0); s < From.Species(); ++s) {
+        for(size_t i(0); i < From.DF(s).dim(); ++i) {
+            SHarmonic1D& from(From.DF(s)(i)); 
+            SHarmonic1D& to(To.DF(s)(i));
+            for (size_t ix(0); ix < n; ++ix) {
+                for (size_t ip(0); ip < from.nump(); ++ip) {
+                    put(to(ip,t0+ix), from(ip,f0+ix), add);
                 }
-            }           
+            }
         }
-
-        // Mirror the fields 
-        for(size_t i(0); i < Y.EMF().dim(); ++i){
-            for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
-               // right boundary
-               for (size_t c(0); c < Nbc; ++c) 
-                   Y.FLD(i)(ix, Ny_local-c-1) = Y.FLD(i)(ix, Ny_local-2*Nbc+c);
-               // left boundary
-               for (size_t c(0); c < Nbc; ++c) 
-                  Y.FLD(i)(ix, c) = Y.FLD(i)(ix, 2*Nbc-c-1);
+    }
+    for(size_t i(0); i < From.EMF().dim(); ++i) {
+        for (size_t ix(0); ix < n; ++ix) put(To.FLD(i)(t0+ix), From.FLD(i)(f0+ix), add);
+    }
+    Hydro1D& from(From.HYDRO()); 
+    Hydro1D& to(To.HYDRO());
+    for (size_t ix(0); ix < n; ++ix) {
+        put(to.density(t0+ix),      from.density(f0+ix),      add);
+        put(to.vx(t0+ix),           from.vx(f0+ix),           add);
+        put(to.vy(t0+ix),           from.vy(f0+ix),           add);
+        put(to.vz(t0+ix),           from.vz(f0+ix),           add);
+        put(to.temperature(t0+ix),  from.temperature(f0+ix),  add);
+        put(to.Z(t0+ix),            from.Z(f0+ix),            add);
+    }
+}
+//--------------------------------------------------------------
+//  Cells [fx0,fx0+nx)x[fy0,fy0+ny) of From to the ones at (tx0,ty0) of To, added if add
+static void cells(const State2D& From, const size_t fx0, const size_t fy0, 
+                  State2D& To, const size_t tx0, const size_t ty0, 
+                  const size_t nx, const size_t ny, const bool add){
+
+    for(size_t s(0); s < From.Species(); ++s) {
+        for(size_t i(0); i < From.DF(s).dim(); ++i) {
+            SHarmonic2D& from(From.DF(s)(i)); 
+            SHarmonic2D& to(To.DF(s)(i));
+            for (size_t iy(0); iy < ny; ++iy) {
+                for (size_t ix(0); ix < nx; ++ix) {
+                    for (size_t ip(0); ip < from.nump(); ++ip) {
+                        put(to(ip,tx0+ix,ty0+iy), from(ip,fx0+ix,fy0+iy), add);
+                    }
+                }
             }
         }
-
-        for(size_t ix(0); ix < Nx_local; ++ix){  // All the x cells
-            for(size_t c(0); c < Nbc; c++) {
-                //Ey
-                Y.EMF().Ey()(ix, Ny_local-Nbc+c) *= -1.0; // right boundary 
-                Y.EMF().Ey()(ix, c) *= -1.0;  // left  boundary
-
-                //Ez
-                Y.EMF().Ez()(ix, Ny_local-Nbc+c) *= -1.0; // right boundary 
-                Y.EMF().Ez()(ix, c) *= -1.0;  // left  boundary
-           
-                //Bx
-                Y.EMF().Bx()(ix, Ny_local-Nbc+c) *= -1.0; // right boundary 
-                Y.EMF().Bx()(ix, c) *= -1.0;  // left  boundary
+    }
+    for(size_t i(0); i < From.EMF().dim(); ++i) {
+        for (size_t iy(0); iy < ny; ++iy) {
+            for (size_t ix(0); ix < nx; ++ix) {
+                put(To.FLD(i)(tx0+ix,ty0+iy), From.FLD(i)(fx0+ix,fy0+iy), add);
             }
         }
-
-
-        // if (Input::List().hydromotion)
-        // {
-        //     // Hydro Quantities:   x0 "Right-Bound ---> Left-Guard"
-        //     for(size_t c(0); c < Nbc; c++) {
-        //         Y.HYDRO().velocity(c) *= -1.0;
-        //         // Y.HYDRO().temperature(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
-        //         // Y.HYDRO().kpressure(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
-        //         // Y.HYDRO().mpressure(c) = Y.HYDRO().velocity(Nx_local-2*Nbc+c);
-        //     }    
-    
-        //     // Hydro Quantities:   x0 "Left-Bound ---> Right-Guard"
-        //     for(size_t c(0); c < Nbc; c++) {
-        //         Y.HYDRO().velocity(Nx_local-Nbc+c) *= -1.0;// Y.HYDRO().velocity(Nbc+c);
-        //         // Y.HYDRO().temperature(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
-        //         // Y.HYDRO().kpressure(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
-        //         // Y.HYDRO().mpressure(Nx_local-Nbc+c) =  Y.HYDRO().velocity(Nbc+c);
-
-        //     }
-        // }
-
     }
+    Hydro2D& from(From.HYDRO()); 
+    Hydro2D& to(To.HYDRO());
+    for (size_t iy(0); iy < ny; ++iy) {
+        for (size_t ix(0); ix < nx; ++ix) {
+            put(to.density(tx0+ix,ty0+iy),      from.density(fx0+ix,fy0+iy),      add);
+            put(to.vx(tx0+ix,ty0+iy),           from.vx(fx0+ix,fy0+iy),           add);
+            put(to.vy(tx0+ix,ty0+iy),           from.vy(fx0+ix,fy0+iy),           add);
+            put(to.vz(tx0+ix,ty0+iy),           from.vz(fx0+ix,fy0+iy),           add);
+            put(to.temperature(tx0+ix,ty0+iy),  from.temperature(fx0+ix,fy0+iy),  add);
+            put(to.Z(tx0+ix,ty0+iy),            from.Z(fx0+ix,fy0+iy),            add);
+        }
+    }
+}
 //--------------------------------------------------------------
 
-//**************************************************************
-//**************************************************************
-//   Definition of the Parallel Environment
-//**************************************************************
-//**************************************************************
-
-
 //--------------------------------------------------------------
-    Parallel_Environment_2D:: Parallel_Environment_2D() : 
+Edge_Stage_1D::Edge_Stage_1D(const State1D& Y) : Nx(Y.SH(0,0,0).numx()) {
 //--------------------------------------------------------------
-//  Constructor, domain decomposition
+//  Constructor
+//--------------------------------------------------------------
+
+    edge_cells(Nx, x0, x1, a, b);
+
+    W  = new State1D(a + Nx - b, Input::List().ls, Input::List().ms, 
+                     Input::List().dp, 
+                     Input::List().qs, Input::List().mass, 
+                     Input::List().hydromass, Input::List().hydrocharge, 
+                     Input::List().numparticles, Input::List().particlemass, Input::List().particlecharge);
+    Wh = new State1D(*W);
+}
+//--------------------------------------------------------------
+Edge_Stage_1D::~Edge_Stage_1D(){
+    delete W;
+    delete Wh;
+}
 //--------------------------------------------------------------
-        bndX(Input::List().bndX),           // Type of boundary
-        bndY(Input::List().bndY),           // Type of boundary
-        
-        MPI_Processes_X(Input::List().MPI_X[0]),   // Number of processes in X-direction
-        MPI_Processes_Y(Input::List().MPI_X[1]),   // Number of processes in Y-direction
-        MPI_Procs(MPI_Processes_X*MPI_Processes_Y)
-    {
-        // Determination of the rank and size of the run
-        MPI_Comm_size(MPI_COMM_WORLD, &MPI_Procs);
-        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
-        rankx.push_back(rank % MPI_Processes_X);
-        rankx.push_back(rank / MPI_Processes_X);
+//--------------------------------------------------------------
+void Edge_Stage_1D::Edges(Algorithms::RK2<State1D>& RK, State1D& Y, const double h,
+                          Algorithms::AbstFunctor<State1D>* F) {
+//--------------------------------------------------------------
+//  Y gets the whole update of the boundary cells and half of the 
+//  update of the interior, the two edges are side by side in W
+//--------------------------------------------------------------
 
-        if (error_check()) {MPI_Finalize(); exit(1);}
+    const State1D& Y0(RK.First(Y, h, F));
 
-        // Determination of the local computational domain (i.e. the x-axis and the y-axis) 
-        for(size_t i(0); i < Input::List().xminLocal.size(); ++i) {
-            Input::List().xminLocal[i] = Input::List().xminGlobal[i]
-                                        + rankx[i] * Input::List().NxLocalnobnd[i] * Input::List().globdx[i] 
-                                        - Input::List().BoundaryCells * Input::List().globdx[i];
-            Input::List().xmaxLocal[i] = Input::List().xminLocal[i] 
-                                        + (Input::List().NxLocal[i]) * Input::List().globdx[i];
-        }
+    cells(Y0, 0, *W, 0, a, false);
+    cells(Y0, b, *W, a, Nx-b, false);
 
-//        exit(0);
+    (*F)(*W,*Wh); (*Wh) *= 0.5*h;
 
-         // Restart files will be generated when output_step % restart_step == 0 
-//          if ( ( (Input::List().n_outsteps + 1) >  Input::List().n_restarts ) &&
-//                (Input::List().n_restarts > 0)  ) { 
-//               restart_step = Input::List().n_outsteps / Input::List().n_restarts ;
-//          } 
-//          else restart_step = -1;
-//          if ( Input::List().restart_time > Input::List().n_restarts ) {
-//              restart_time = 0; 
-//          }
-//          else restart_time = Input::List().restart_time;
+    cells(*Wh, 0,        Y, 0,  x0,    true);
+    cells(*Wh, a+x1-b,   Y, x1, Nx-x1, true);
+}
+//--------------------------------------------------------------
 
-    }
 //--------------------------------------------------------------
-//  Destructor
+void Edge_Stage_1D::Interior(Algorithms::RK2<State1D>& RK, State1D& Y, const double h,
+                             Algorithms::AbstFunctor<State1D>* F) {
 //--------------------------------------------------------------
-    Parallel_Environment_2D:: ~Parallel_Environment_2D(){ }
+//  The rest of the update of the interior, the boundary cells 
+//  are in flight and are not written
 //--------------------------------------------------------------
 
+    if (x1 == x0) return;
+
+    cells(RK.Last(h, F), x0, Y, x0, x1-x0, true);
+}
 //--------------------------------------------------------------
-    bool Parallel_Environment_2D:: error_check() {
-//--------------------------------------------------------------
-//  Temporary error check
+
 //--------------------------------------------------------------
-        if ( MPI_Procs != (MPI_Processes_X * MPI_Processes_Y) ) { 
-            if (rank == 0) std:: cout << "the number of nodes in the input deck is "
-                                      << (MPI_Processes_X * MPI_Processes_Y) << ", terminating ..." << endl;
-            return true; 
-        }
-        // Test the number of cells
-        if (rank == 0){ 
-            if (Input::List().NxLocal[0] < 2*Input::List().BoundaryCells+1){
-                std::cout<<"Not enough cells per processor in the x direction" << endl;
-                return true;
-            }
-            if (Input::List().NxLocal[1] < 2*Input::List().BoundaryCells+1){ 
-                std::cout<<"Not enough cells per processor in the y direction" << endl;
-                return true;
-            }
-         } 
-         return false;
-    }
+Edge_Stage_2D::Edge_Stage_2D(const State2D& Y) : Nx(Y.SH(0,0,0).numx()), Ny(Y.SH(0,0,0).numy()) {
 //--------------------------------------------------------------
- 
+//  Constructor
 //--------------------------------------------------------------
-//  Basic information
+
+    edge_cells(Nx, x0, x1, a, b);
+    edge_cells(Ny, y0, y1, c, d);
+
+    Wx  = new State2D(a + Nx - b, Ny, Input::List().ls, Input::List().ms, 
+                      Input::List().dp, 
+                      Input::List().qs, Input::List().mass, 
+                      Input::List().hydromass, Input::List().hydrocharge);
+    Whx = new State2D(*Wx);
+    Wy  = new State2D(Nx, c + Ny - d, Input::List().ls, Input::List().ms, 
+                      Input::List().dp, 
+                      Input::List().qs, Input::List().mass, 
+                      Input::List().hydromass, Input::List().hydrocharge);
+    Why = new State2D(*Wy);
+}
 //--------------------------------------------------------------
-    int Parallel_Environment_2D:: RANK()  const {return rank;} 
-    int Parallel_Environment_2D:: RANKX() const {return rankx[0];} 
-    int Parallel_Environment_2D:: RANKY() const {return rankx[1];} 
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-    int Parallel_Environment_2D:: MPI_Processes() const {return MPI_Procs;} 
-    int Parallel_Environment_2D:: MPI_X() const {return MPI_Processes_X;} 
-    int Parallel_Environment_2D:: MPI_Y() const {return MPI_Processes_Y;} 
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-    int Parallel_Environment_2D:: BNDX()  const {return bndX;} 
-    int Parallel_Environment_2D:: BNDY()  const {return bndY;} 
+Edge_Stage_2D::~Edge_Stage_2D(){
+    delete Wx;
+    delete Whx;
+    delete Wy;
+    delete Why;
+}
 //--------------------------------------------------------------
 
-
 //--------------------------------------------------------------
-    void Parallel_Environment_2D::Neighbor_ImplicitE_Communications(State2D& Y){
+void Edge_Stage_2D::Edges(Algorithms::RK2<State2D>& RK, State2D& Y, const double h,
+                          Algorithms::AbstFunctor<State2D>* F) {
 //--------------------------------------------------------------
-//  Information exchange between neighbors 
+//  Y gets the whole update of the boundary cells and half of the 
+//  update of the interior. The strips along x take [0,x0) and 
+//  [x1,Nx) for every y, the strips along y the rest of [0,y0) 
+//  and [y1,Ny)
 //--------------------------------------------------------------
 
-        int moduloX(RANKX()%2); 
-        int RNx((RANKX()+1)%MPI_X() +RANKY()*MPI_X()),         // This is the right neighbor 
-            LNx((RANKX()-1+MPI_X())%MPI_X()+RANKY()*MPI_X()); // This is the left  neighbor 
-        
-        
-        if (MPI_X() > 1) {
-            //even nodes 
-            if (moduloX==0){
-                Bfield_Data.Send_right_X(Y,RNx);                  //   (Send) 0 --> 1               
-                if ((RANKX() != 0) || (BNDX()==0)){
-                    Bfield_Data.Recv_from_left_X(Y,LNx);          //          1 --> 0 (Receive)   
-                    Bfield_Data.Send_left_X(Y,LNx);               //          1 <-- 0 (Send)
-                }
-                else {
-                    if (BNDX()==1) {
-                        Bfield_Data.mirror_bound_Xleft(Y);        // Update node "0" in the x direction
-                    }
-                    else {
-                        cout<<"Invalid Boundary." << endl;
-                    }
-               } 
-               Bfield_Data.Recv_from_right_X(Y,RNx);               // (Receive) 0 <-- 1                            
-            }
-            //odd nodes 
-            else {
-                Bfield_Data.Recv_from_left_X(Y,LNx);               //           0 --> 1 (Receive)               
-                if ((RANKX()!=(MPI_X()-1)) || (BNDX()==0)){
-                     Bfield_Data.Send_right_X(Y,RNx);              //   (Send)  1 --> 0 
-                     Bfield_Data.Recv_from_right_X(Y,RNx);         // (Receive) 1 <-- 0
-                }
-                else {
-                    if (BNDX()==1) {
-                        Bfield_Data.mirror_bound_Xright(Y);        // Update node "N-1" in the x direction
-                    }
-                    else {
-                        cout<<"Invalid Boundary." << endl;;
-                    }
-                } 
-                Bfield_Data.Send_left_X(Y,LNx);                    //           0 <-- 1 (Send)              
-            } 
-        }
-        else { Bfield_Data.sameNode_bound_X(Y); }
+    const State2D& Y0(RK.First(Y, h, F));
 
+    cells(Y0, 0, 0, *Wx, 0, 0, a,    Ny, false);
+    cells(Y0, b, 0, *Wx, a, 0, Nx-b, Ny, false);
 
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+    (*F)(*Wx,*Whx); (*Whx) *= 0.5*h;
 
-         int moduloY(RANKY()%2);
-         int RNy((RANK()+MPI_X())%MPI_Processes()),                  // This is the right neighbor 
-             LNy((RANK()-MPI_X()+MPI_Processes())%MPI_Processes());          // This is the left  neighbor 
+    cells(*Whx, 0,      0, Y, 0,  0, x0,    Ny, true);
+    cells(*Whx, a+x1-b, 0, Y, x1, 0, Nx-x1, Ny, true);
 
-         if (MPI_Y() > 1) {
-            //even nodes 
-            if (moduloY==0){
-                Bfield_Data.Send_right_Y(Y,RNy);                     //   (Send) 0 --> 1               
-                if ((RANKY() != 0) || (BNDY()==0)){
-                    Bfield_Data.Recv_from_left_Y(Y,LNy);             //          1 --> 0 (Receive)                
-                    Bfield_Data.Send_left_Y(Y,LNy);                  //          1 <-- 0 (Send)
-                }
-                else {
-                    if (BNDY()==1) {
-                        Bfield_Data.mirror_bound_Yleft(Y);          //  Update node "0" in the y direction
-                    }
-                    else {
-                        cout<<"Invalid Boundary." << endl;
-                    }
-                }  
-                Bfield_Data.Recv_from_right_Y(Y,RNy);                // (Receive) 0 <-- 1                            
-            }
-            //odd nodes 
-            else {
-                Bfield_Data.Recv_from_left_Y(Y,LNy);                 //           0 --> 1 (Receive)               
-                if ((RANKY()!=(MPI_Y()-1)) || (BNDY()==0)){
-                     Bfield_Data.Send_right_Y(Y,RNy);                //   (Send)  1 --> 0 
-                     Bfield_Data.Recv_from_right_Y(Y,RNy);           // (Receive) 1 <-- 0
-                }
-                else {
-                    if (BNDY()==1) {
-                        Bfield_Data.mirror_bound_Yright(Y);          // Update node "N-1" in the x direction
-                    }
-                    else {
-                        cout<<"Invalid Boundary." << endl;
-                    }
-                } 
-                Bfield_Data.Send_left_Y(Y,LNy);                      //           0 <-- 1 (Send)              
-            }
-         }
-         else { Bfield_Data.sameNode_bound_Y(Y); }
-    }
-//--------------------------------------------------------------
+    if (x1 == x0) return;
+
+    cells(Y0, 0, 0, *Wy, 0, 0, Nx, c,    false);
+    cells(Y0, 0, d, *Wy, 0, c, Nx, Ny-d, false);
+
+    (*F)(*Wy,*Why); (*Why) *= 0.5*h;
 
+    cells(*Why, x0, 0,      Y, x0, 0,  x1-x0, y0,    true);
+    cells(*Why, x0, c+y1-d, Y, x0, y1, x1-x0, Ny-y1, true);
+}
+//--------------------------------------------------------------
 
 //--------------------------------------------------------------
-    void Parallel_Environment_2D::Neighbor_Communications(State2D& Y){
+void Edge_Stage_2D::Interior(Algorithms::RK2<State2D>& RK, State2D& Y, const double h,
+                             Algorithms::AbstFunctor<State2D>* F) {
 //--------------------------------------------------------------
-//  Information exchange between neighbors 
+//  The rest of the update of the interior, the boundary cells 
+//  are in flight and are not written
 //--------------------------------------------------------------
 
-        int moduloX(RANKX()%2); 
-        int RNx((RANKX()+1)%MPI_X() +RANKY()*MPI_X()),         // This is the right neighbor 
-            LNx((RANKX()-1+MPI_X())%MPI_X()+RANKY()*MPI_X()); // This is the left  neighbor 
+    if ((x1 == x0) || (y1 == y0)) return;
 
+    cells(RK.Last(h, F), x0, y0, Y, x0, y0, x1-x0, y1-y0, true);
+}
+//--------------------------------------------------------------
 
-        // std::cout << "Parallel: \n";
-        // std::cout << "MPI_X() = "<< MPI_X() << " \n";
-        // std::cout << "MPI_Y() = "<< MPI_Y() << " \n";    
+//**************************************************************
+//**************************************************************
+//**************************************************************
+//  Thread and memory placement
+//**************************************************************
+//**************************************************************
 
-        if (MPI_X() > 1) {
-            //even nodes 
-            if (moduloX==0){
-               X_Data.Send_right_X(Y,RNx);                  //   (Send) 0 --> 1               
-                if ((RANKX() != 0) || (BNDX()==0)){
-                    X_Data.Recv_from_left_X(Y,LNx);          //          1 --> 0 (Receive)   
-                    X_Data.Send_left_X(Y,LNx);               //          1 <-- 0 (Send)
-                }
-                else {
-                    if (BNDX()==1) {
-                        X_Data.mirror_bound_Xleft(Y);        // Update node "0" in the x direction
-                    }
-                    else {
-                        cout<<"Invalid Boundary." << endl;
-                    }
-               } 
-               X_Data.Recv_from_right_X(Y,RNx);               // (Receive) 0 <-- 1                            
-            }
-            //odd nodes 
-            else {
-                X_Data.Recv_from_left_X(Y,LNx);               //           0 --> 1 (Receive)               
-                if ((RANKX()!=(MPI_X()-1)) || (BNDX()==0)){
-                     X_Data.Send_right_X(Y,RNx);              //   (Send)  1 --> 0 
-                     X_Data.Recv_from_right_X(Y,RNx);         // (Receive) 1 <-- 0
-                }
-                else {
-                    if (BNDX()==1) {
-                        X_Data.mirror_bound_Xright(Y);        // Update node "N-1" in the x direction
-                    }
-                    else {
-                        cout<<"Invalid Boundary." << endl;
-                    }
-               } 
-                X_Data.Send_left_X(Y,LNx);                    //           0 <-- 1 (Send)              
-            } 
-         }
-         else { X_Data.sameNode_bound_X(Y); }
 
+//--------------------------------------------------------------
+//  The cpu and NUMA node the calling thread runs on, -1 if unknown
+static void current_cpu(int& cpu, int& node){
+    cpu = -1; node = -1;
+#ifdef __linux__
+    unsigned c(0), n(0);
+    if (syscall(SYS_getcpu, &c, &n, NULL) == 0) { cpu = int(c); node = int(n); }
+#endif
+}
+//--------------------------------------------------------------
+//  The NUMA node of the page that holds address, -1 if unknown
+static int page_node(const void* address){
+#ifdef __linux__
+    const size_t page_size(sysconf(_SC_PAGESIZE));
+    void* page(reinterpret_cast<void*>(reinterpret_cast<size_t>(address) & ~(page_size-1)));
+    int status(-1);
+    if (syscall(SYS_move_pages, 0, 1, &page, NULL, &status, 0) == 0 && status >= 0) return status;
+#endif
+    return -1;
+}
+//--------------------------------------------------------------
+//  Each harmonic is represented by its middle page and compared with
+//  the node of the thread that advances it
+static void placement_report(const vector<const void*>& harmonics, const vector<size_t>& owner){
 
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+    const int num_threads(Input::List().ompthreads);
+    vector<int> cpu(num_threads,-1), node(num_threads,-1);
 
-         int moduloY(RANKY()%2);
-         int RNy((RANK()+MPI_X())%MPI_Processes()),                  // This is the right neighbor 
-             LNy((RANK()-MPI_X()+MPI_Processes())%MPI_Processes());          // This is the left  neighbor 
+    #pragma omp parallel num_threads(num_threads)
+    {
+        const int t(omp_get_thread_num());
+        current_cpu(cpu[t], node[t]);
+    }
 
-         if (MPI_Y() > 1) {
-            //even nodes 
-            if (moduloY==0){
-                X_Data.Send_right_Y(Y,RNy);                     //   (Send) 0 --> 1               
-                if ((RANKY() != 0) || (BNDY()==0)){
-                    X_Data.Recv_from_left_Y(Y,LNy);             //          1 --> 0 (Receive)                
-                    X_Data.Send_left_Y(Y,LNy);                  //          1 <-- 0 (Send)
-                }
-                else {
-                    if (BNDY()==1) {
-                        X_Data.mirror_bound_Yleft(Y);          //  Update node "0" in the y direction
-                    }
-                    else {
-                        cout<<"Invalid Boundary." << endl;
-                    }
-                }  
-                X_Data.Recv_from_right_Y(Y,RNy);                // (Receive) 0 <-- 1                            
-            }
-            //odd nodes 
-            else {
-                X_Data.Recv_from_left_Y(Y,LNy);                 //           0 --> 1 (Receive)               
-                if ((RANKY()!=(MPI_Y()-1)) || (BNDY()==0)){
-                     X_Data.Send_right_Y(Y,RNy);                //   (Send)  1 --> 0 
-                     X_Data.Recv_from_right_Y(Y,RNy);           // (Receive) 1 <-- 0
-                }
-                else {
-                    if (BNDY()==1) {
-                        X_Data.mirror_bound_Yright(Y);          // Update node "N-1" in the x direction
-                    }
-                    else {
-                        cout<<"Invalid Boundary." << endl;
-                    }
-                } 
-                X_Data.Send_left_Y(Y,LNy);                      //           0 <-- 1 (Send)              
-            }
-         }
-         else { X_Data.sameNode_bound_Y(Y); }
+    map<int,size_t> per_node;
+    size_t local(0), known(0);
+    for (size_t i(0); i < harmonics.size(); ++i) {
+        int n(page_node(harmonics[i]));
+        ++per_node[n];
+        if (n < 0) continue;
+        ++known;
+        if (n == node[owner[i]]) ++local;
+    }
+
+    const char* binding[] = {"false", "true", "master", "close", "spread"};
+    int bind(omp_get_proc_bind());
+
+    std::cout << "OpenMP threads: " << num_threads << ", binding " << ((bind >= 0 && bind < 5) ? binding[bind] : "?");
+    if (bind == omp_proc_bind_false) std::cout << " (unpinned, set OMP_PROC_BIND and OMP_PLACES)";
+    std::cout << "\n    thread:cpu/node ";
+    for (int t(0); t < num_threads; ++t) std::cout << " " << t << ":" << cpu[t] << "/" << node[t];
 
+    std::cout << "\nHarmonics by NUMA node:";
+    for (map<int,size_t>::iterator it(per_node.begin()); it != per_node.end(); ++it) {
+        if (it->first < 0) std::cout << "  unknown " << it->second;
+        else               std::cout << "  node " << it->first << " " << it->second;
     }
+    if (known > 0) std::cout << "  (" << (100*local)/known << "% on the node of their thread)";
+    std::cout << "\n";
+}
 //--------------------------------------------------------------
+void Placement_report(State1D& Y, const int rank){
 
-//**************************************************************
+    if (rank != 0 || Harmonic_Group::Rank() != 0) return;
+
+    vector<const void*> harmonics;
+    vector<size_t> owner;
+    for (size_t s(0); s < Y.Species(); ++s) {
+        for (size_t i(0); i < Y.DF(s).dim(); ++i) {
+            valarray<complex<double> >& a(Y.DF(s)(i).array().array());
+            if (a.size() == 0) continue;
+            harmonics.push_back(&a[a.size()/2]);
+            owner.push_back(harmonic_thread(i, harmonic_chunks(Y.DF(s).dim()), Input::List().ompthreads));
+        }
+    }
+    placement_report(harmonics, owner);
+}
+//--------------------------------------------------------------
+void Placement_report(State2D& Y, const int rank){
 
+    if (rank != 0 || Harmonic_Group::Rank() != 0) return;
 
-//**************************************************************
+    vector<const void*> harmonics;
+    vector<size_t> owner;
+    for (size_t s(0); s < Y.Species(); ++s) {
+        for (size_t i(0); i < Y.DF(s).dim(); ++i) {
+            valarray<complex<double> >& a(Y.DF(s)(i).array().array());
+            if (a.size() == 0) continue;
+            harmonics.push_back(&a[a.size()/2]);
+            owner.push_back(harmonic_thread(i, harmonic_chunks(Y.DF(s).dim()), Input::List().ompthreads));
+        }
+    }
+    placement_report(harmonics, owner);
+}
+//--------------------------------------------------------------
+//  A re-cut moves harmonics between threads after their storage
+//  has been first touched. The pages are moved in place, the halo
+//  datatypes and requests keep the addresses of the harmonics
+void Place_harmonics(const size_t num_harmonics){
+#ifdef __linux__
+    int cpu, node;
+    current_cpu(cpu, node);
+    if (node < 0) return;
+
+    vector<valarray<complex<double> >*> arrays;
+    vector<size_t> ids;
+    live_harmonics(num_harmonics, arrays, ids);
+    const valarray<size_t> chunks(harmonic_chunks(num_harmonics));
+
+    const size_t page_size(sysconf(_SC_PAGESIZE));
+    const int move_pages_flag(2);                                   //  MPOL_MF_MOVE
+    vector<void*> pages;
+    for (size_t i(0); i < arrays.size(); ++i) {
+        if (harmonic_thread(ids[i], chunks, omp_get_num_threads()) != size_t(omp_get_thread_num())) continue;
+        valarray<complex<double> >& a(*arrays[i]);
+        if (a.size() == 0) continue;
+        size_t first(reinterpret_cast<size_t>(&a[0]) & ~(page_size-1));
+        size_t last(reinterpret_cast<size_t>(&a[a.size()-1]));
+        for (size_t page(first); page <= last; page += page_size) pages.push_back(reinterpret_cast<void*>(page));
+    }
+    if (pages.empty()) return;
+
+    vector<int> nodes(pages.size(), node), status(pages.size(), -1);
+    syscall(SYS_move_pages, 0, pages.size(), &pages[0], &nodes[0], &status[0], move_pages_flag);
+#else
+    (void) num_harmonics;
+#endif
+}
+//--------------------------------------------------------------
@@ -13,6 +13,124 @@
     #ifndef PARALLEL_ENVIRONMENT_H
     #define PARALLEL_ENVIRONMENT_H
 
+        class collisions_1D;
+        class collisions_2D;
+
+
+//**************************************************************
+//--------------------------------------------------------------
+        class Harmonic_Group {
+//--------------------------------------------------------------
+//      Hybrid decomposition. The MPI_Processes_Harmonics members
+//      of a group hold the same spatial subdomain, each of them
+//      evaluates the Vlasov terms of a share of the harmonics and
+//      advances and collides the harmonics it keeps. The harmonics
+//      up to l = 1 (l = 3 with the implicit E field) are kept by
+//      every member, the rest go to the members in equal shares
+//--------------------------------------------------------------
+        public:
+//          Splits MPI_COMM_WORLD, right after MPI_Init
+            static void Setup();
+
+//          The nodes of the spatial decomposition, one member of
+//          every group. MPI_COMM_WORLD without groups
+            static MPI_Comm Space();
+//          The members of the group of this node
+            static MPI_Comm Harmonics();
+            static int Rank();
+            static int Size();
+
+//          Share [h0,h1) of this member out of the harmonics [first,num)
+            static void Share(const size_t first, const size_t num, size_t& h0, size_t& h1);
+//          Chunks [f_start,f_end] of the OpenMP threads in that share
+            static void Chunks(const size_t first, const size_t num,
+                               valarray<size_t>& f_start, valarray<size_t>& f_end);
+
+//          The operators register the harmonics (l,m) of the
+//          distributions of l0,m0 whose terms this member evaluates
+            static void Evaluates(const size_t l0, const size_t m0, const size_t l, const size_t m);
+//          Number of leading harmonics every member keeps, the
+//          member that keeps harmonic id (-1 for all of them)
+            static size_t Low(const size_t l0, const size_t m0);
+            static int  Owner(const size_t l0, const size_t m0, const size_t id);
+            static bool Keeps(const size_t l0, const size_t m0, const size_t id);
+
+//          Before the terms are evaluated the harmonics this member
+//          reads are brought from their keepers. After, the terms
+//          written to the harmonics of others are added there, the
+//          terms of the leading harmonics are summed over the group
+//          and the harmonics this member does not keep are zeroed
+            static void Refresh(const State1D& Y);
+            static void Refresh(const State2D& Y);
+            static void Fold(State1D& Yslope);
+            static void Fold(State2D& Yslope);
+//          The first member gets the whole state, for the output
+            static void Collect(State1D& Y);
+            static void Collect(State2D& Y);
+
+        private:
+            static MPI_Comm space, harmonics;
+            static int rank, size;
+        };
+//--------------------------------------------------------------
+//**************************************************************
+
+
+//**************************************************************
+//--------------------------------------------------------------
+        class Shared_Halos {
+//--------------------------------------------------------------
+//      Halos between the nodes that run on the same host. Every
+//      node keeps the edge planes of its boundary cells in its part
+//      of an MPI-3 shared-memory window, and the neighbor copies
+//      its guard cells straight out of there. The harmonics are 
+//      valarrays and stay in private memory, the planes are copied
+//      in as contiguous blocks. The empty messages between the two
+//      only order the accesses
+//--------------------------------------------------------------
+        public:
+//          Constructors/Destructors, collective over comm
+            Shared_Halos(MPI_Comm comm, int _num_slots);
+            ~Shared_Halos();
+
+//          Whether node nb of comm runs on the same host
+            bool Shared(int nb) const;
+
+//          The boundary cells described by halo go into the given
+//          slot of this node, the guard cells are read from the slot
+//          of node nb. The datatypes remain with the caller
+            void Send(MPI_Datatype halo, int nb, int slot);
+            void Recv(MPI_Datatype halo, int nb, int slot);
+            void Clear();
+//          Collective over the host, once the halos are listed
+            void Allocate();
+
+//          Before and after the exchange of the other neighbors
+            void Pack();
+            void Unpack();
+
+        private:
+//          A contiguous part of a halo, at its absolute address
+            struct Block {
+                char*  address;
+                size_t bytes;
+            };
+            static void Blocks(MPI_Datatype type, MPI_Aint displ, vector<Block>& blocks);
+
+            MPI_Comm comm_host;             // Nodes on this host, MPI_COMM_NULL if none
+            vector<int> host_rank;          // Rank on the host of every node, -1 if elsewhere
+            int num_slots, parity;          // Two sets of slots, used in turn
+            MPI_Aint slot_bytes;
+            MPI_Win window;
+            vector< vector<Block> > send_blocks, recv_blocks;
+            vector<int> send_slot, recv_host, recv_slot;
+            vector<MPI_Request> notify;
+
+            char* Slot(int host, int slot, int set);
+        };
+//--------------------------------------------------------------
+//**************************************************************
+
 
 //**************************************************************
 //--------------------------------------------------------------
@@ -76,11 +194,13 @@
 //          Boundary conditions
             int BNDX()   const;
 
-//          Data exchange in x direction
-            void Send_right_X(State1D& Y, int dest);
-            void Recv_from_left_X(State1D& Y,int origin);
-            void Send_left_X(State1D& Y, int dest);
-            void Recv_from_right_X(State1D& Y, int origin); 
+//          Non-blocking data exchange in x direction, a negative
+//          neighbor means that there is no exchange on that side.
+//          The guard cells of Y are written in place, they and the
+//          boundary cells must not be modified between Post_X and
+//          Complete_X
+            void Post_X(State1D& Y, int left, int right);
+            void Complete_X(State1D& Y);
 
 //          Boundaries 
             void mirror_bound_Xleft(State1D& Y);
@@ -94,9 +214,29 @@
             size_t Nbc, bndX;
             int numspec;// numpmax;
 
-//          Information exchange
-            int  msg_sizeX;
-            complex<double> *msg_bufX;
+//          Information exchange with persistent requests, the
+//          datatypes describe the halos of the State at halo_base.
+//          The halos of neighbors on this host go through shared
+//          memory (Shared_Halos) instead of messages
+            int  par_sizeX;
+            complex<double> *par_sendX, *par_recvX[2];     // [0] = left, [1] = right
+            int  neighborX[2];
+            int  num_reqX, num_haloX;
+            MPI_Request  msg_reqX[4];
+            MPI_Datatype haloX[4];
+            complex<double>* halo_base;
+            MPI_Comm comm_halo;     // Halo traffic is kept apart from the output gathers
+            Shared_Halos shared;
+
+//          Halo datatypes in x direction
+            void Setup_X(State1D& Y, int left, int right);
+            void Free_X();
+            MPI_Datatype Halo_X(State1D& Y, size_t x0, complex<double>* parbuf);
+
+//          Particle exchange in x direction
+            void Pack_particles_X(State1D& Y, complex<double>* buf);
+            void Unpack_particles_left_X(State1D& Y, complex<double>* buf);
+            void Unpack_particles_right_X(State1D& Y, complex<double>* buf);
 
 //          Boundaries for single-node configurations
             void sameNode_periodic_X(State1D& Y);
@@ -119,7 +259,7 @@
 //--------------------------------------------------------------
         public:
 //          Constructors/Destructors
-            Parallel_Environment_1D(); 
+            Parallel_Environment_1D(const vector<size_t>& xcuts = vector<size_t>()); 
             ~Parallel_Environment_1D(); 
          
 //          Parallel parameters
@@ -131,6 +271,12 @@
             void Neighbor_ImplicitE_Communications(State1D& Y);
             void Neighbor_Communications(State1D& Y);
 
+//          Split information exchange. Work on the interior cells,
+//          i.e. the last Vlasov stage of the interior (Edge_Stage)
+//          and its collisions, can be done between the two calls
+            void Neighbor_Communications_Post(State1D& Y);
+            void Neighbor_Communications_Complete(State1D& Y);
+
         private:
 
 //          Boundaries 
@@ -160,7 +306,7 @@
 //--------------------------------------------------------------
         public:
 //          Constructors/Destructors
-            Node_ImplicitE_Communications_2D(); 
+            Node_ImplicitE_Communications_2D(MPI_Comm comm_cart); 
             ~Node_ImplicitE_Communications_2D();
          
 //          Boundary conditions
@@ -199,6 +345,7 @@
 //          Information exchange
             int  msg_sizeX, msg_sizeY;
             complex<double> *msg_bufX, *msg_bufY;
+            MPI_Comm comm;          // Cartesian topology of the nodes
 
 //          Boundaries for single-node configurations
             void sameNode_periodic_X(State2D& Y);
@@ -219,23 +366,20 @@
 //--------------------------------------------------------------
         public:
 //          Constructors/Destructors
-            Node_Communications_2D(); 
+            Node_Communications_2D(MPI_Comm comm_cart); 
             ~Node_Communications_2D();
          
 //          Boundary conditions
             int BNDX()   const;
             int BNDY()   const;
 
-//          Data exchange in x direction
-            void Send_right_X(State2D& Y, int dest);
-            void Recv_from_left_X(State2D& Y,int origin);
-            void Send_left_X(State2D& Y, int dest);
-            void Recv_from_right_X(State2D& Y, int origin); 
-
-            void Send_right_Y(State2D& Y, int dest);
-            void Recv_from_left_Y(State2D& Y,int origin);
-            void Send_left_Y(State2D& Y, int dest);
-            void Recv_from_right_Y(State2D& Y, int origin); 
+//          Non-blocking exchange of the faces and the corners with
+//          all the neighbors in a single neighborhood collective, 
+//          the neighbors on this host go through shared memory.
+//          The guard cells of Y are written in place, they and the
+//          boundary cells must not be modified between Post and Complete
+            void Post(State2D& Y);
+            void Complete(State2D& Y);
 
 //          Boundaries 
             void mirror_bound_Xleft(State2D& Y);
@@ -256,10 +400,30 @@
             size_t Nbc, bndX, bndY;
             size_t Nx_local, Ny_local;
 
-//          Information exchange
-            int  msg_sizeX, msg_sizeY; 
-            complex<double> *msg_bufX, *msg_bufY;
-            
+//          Information exchange on the graph of the neighbors, the
+//          datatypes describe the halos of the State at halo_base
+            MPI_Comm comm_topo;     // Cartesian topology of the nodes
+            MPI_Comm comm_halo;     // Faces and corners of this node
+            vector<int> dir_send, dir_recv;     // (dx,dy) of every neighbor
+            bool edgeX[2], edgeY[2];            // No neighbor, [0] = left, [1] = right
+            vector<MPI_Datatype> halo_send, halo_recv;
+            vector<int>      halo_count;
+            vector<MPI_Aint> halo_displ;
+            MPI_Request msg_req;
+            complex<double>* halo_base;
+
+//          Neighbors on this host, outside of the graph
+            vector<int> shared_send, shared_recv;   // (dx,dy,rank) of every neighbor
+            vector<MPI_Datatype> halo_shared;
+            Shared_Halos shared;
+
+//          Neighborhood and halo datatypes
+            void Neighborhood();
+            bool Neighbor(int* dims, int* periods, int* c, int& nb);
+            void Setup(State2D& Y);
+            void Free();
+            MPI_Datatype Halo(State2D& Y, int dx, int dy, bool guard);
+
 //          Boundaries for single-node configurations
             void sameNode_periodic_X(State2D& Y);
             void sameNode_mirror_X(State2D& Y);
@@ -284,7 +448,7 @@
 //--------------------------------------------------------------
         public:
 //          Constructors/Destructors
-            Parallel_Environment_2D(); 
+            Parallel_Environment_2D(const vector<size_t>& xcuts = vector<size_t>()); 
             ~Parallel_Environment_2D(); 
          
 //          Parallel parameters
@@ -297,6 +461,10 @@
             int MPI_X() const;
             int MPI_Y() const;
 
+//          Communicator of the Cartesian topology, the ranks and
+//          the coordinates of the nodes refer to it
+            MPI_Comm Comm() const;
+
 //          Restart 
 //             bool READ_RESTART() const;
 //             void Read_Restart(State2D& Y); 
@@ -310,6 +478,12 @@
             void Neighbor_ImplicitE_Communications(State2D& Y);
             void Neighbor_Communications(State2D& Y);
 
+//          Split information exchange. Work on the interior cells,
+//          i.e. the last Vlasov stage of the interior (Edge_Stage)
+//          and its collisions, can be done between the two calls
+            void Neighbor_Communications_Post(State2D& Y);
+            void Neighbor_Communications_Complete(State2D& Y);
+
         private:
 //          Parallel parameters
 //          Boundaries 
@@ -318,10 +492,15 @@
 
             int rank;
             vector<int> rankx;
-            
-
 
+//          Cartesian topology, built before the exchange modules
+            MPI_Comm comm_cart;
+            static MPI_Comm Cartesian_Topology();
 
+//          First interior x-cell of the node, the cuts are applied
+//          before the exchange modules read the local sizes
+            size_t x_offset;
+            static size_t Cut_X(MPI_Comm comm, const vector<size_t>& xcuts);
 
 //          Information Exchange
             Node_ImplicitE_Communications_2D Bfield_Data;
@@ -335,6 +514,136 @@
 //             int restart_step;
         };
 //--------------------------------------------------------------
+//**************************************************************
+
+//**************************************************************
+//--------------------------------------------------------------
+        class Load_Balance {
+//--------------------------------------------------------------
+//      Dynamic load balance along x. The cost of every x-cell is
+//      measured, the cuts between neighboring nodes are moved to
+//      even it out and the cells change owner while the run 
+//      objects are rebuilt for the new decomposition
+//--------------------------------------------------------------
+        public:
+//          Constructors/Destructors
+            Load_Balance();
+
+//          Cuts of the x-axis, empty for the equal split
+            const vector<size_t>& Cuts() const;
+
+//          Time spent computing, the exchanges are left out
+            void Resume();
+            void Pause();
+
+//          Measures the cost and re-cuts every mpi_balance_every steps.
+//          True when the cells have to change owner, the interior of 
+//          Y is kept until Take_over
+            bool Repartition(const Parallel_Environment_1D& PE, collisions_1D& collide, State1D& Y);
+            bool Repartition(const Parallel_Environment_2D& PE, collisions_2D& collide, State2D& Y);
+
+//          A re-partition waits for the new run objects
+            bool Pending() const;
+
+//          Moves the kept cells to their new owners and fills the guard cells
+            void Take_over(Parallel_Environment_1D& PE, State1D& Y);
+            void Take_over(Parallel_Environment_2D& PE, State2D& Y);
+
+        private:
+            typedef vector< pair<complex<double>*, size_t> > Arrays;
+
+            bool   active;
+            size_t steps;
+            double started, computing;
+
+//          Cuts before and after the re-partition, the node at 
+//          x-coordinate k owns [cuts[k], cuts[k+1])
+            vector<size_t> cuts, old_cuts;
+            int            kept_rankx, kept_ranky;
+
+//          Interior of the node before the re-partition, [row][cell][p]
+            vector< valarray< complex<double> > > carry;
+
+            bool Due();
+            bool Recut(valarray<double>& cost);
+            void Keep(const Arrays& arrays, const size_t rows, const size_t row0, const size_t k);
+            void Hand_over(const Arrays& arrays, const size_t rows, const size_t row0, const size_t k,
+                           const int left, const int right, MPI_Comm comm);
+        };
+//--------------------------------------------------------------
+//**************************************************************
+
+//**************************************************************
+//--------------------------------------------------------------
+        class Edge_Stage_1D {
+//--------------------------------------------------------------
+//      The last RK2 stage of a step in two passes around the halo
+//      exchange. The boundary cells the exchange reads are advanced
+//      first, from a copy of the edges of the state that reaches 
+//      two cells further in for the 4th order x-derivative. The 
+//      interior is advanced while the halos are in flight
+//--------------------------------------------------------------
+        public:
+//          Constructors/Destructors
+            Edge_Stage_1D(const State1D& Y);
+            ~Edge_Stage_1D();
+
+//          Step 1 and the last stage of the boundary cells, before the Post
+            void Edges(Algorithms::RK2<State1D>& RK, State1D& Y, const double h,
+                       Algorithms::AbstFunctor<State1D>* F);
+//          The last stage of the interior cells, between Post and Complete
+            void Interior(Algorithms::RK2<State1D>& RK, State1D& Y, const double h,
+                          Algorithms::AbstFunctor<State1D>* F);
+
+        private:
+//          Boundary cells [0,x0) and [x1,Nx), copied from [0,a) and [b,Nx)
+            size_t Nx, x0, x1, a, b;
+//          The copy of the edges and its slope
+            State1D *W, *Wh;
+        };
+//--------------------------------------------------------------
+//**************************************************************
+
+//**************************************************************
+//--------------------------------------------------------------
+        class Edge_Stage_2D {
+//--------------------------------------------------------------
+//      The last RK2 stage of a step in two passes around the halo
+//      exchange, as in 1D. The strips along x hold every y, the 
+//      strips along y fill in the boundary cells between them
+//--------------------------------------------------------------
+        public:
+//          Constructors/Destructors
+            Edge_Stage_2D(const State2D& Y);
+            ~Edge_Stage_2D();
+
+//          Step 1 and the last stage of the boundary cells, before the Post
+            void Edges(Algorithms::RK2<State2D>& RK, State2D& Y, const double h,
+                       Algorithms::AbstFunctor<State2D>* F);
+//          The last stage of the interior cells, between Post and Complete
+            void Interior(Algorithms::RK2<State2D>& RK, State2D& Y, const double h,
+                          Algorithms::AbstFunctor<State2D>* F);
+
+        private:
+//          Boundary cells outside [x0,x1)x[y0,y1), the strips are 
+//          copied from [0,a), [b,Nx) along x and [0,c), [d,Ny) along y
+            size_t Nx, Ny, x0, x1, a, b, y0, y1, c, d;
+//          The copies of the strips and their slopes
+            State2D *Wx, *Whx, *Wy, *Why;
+        };
+//--------------------------------------------------------------
+//**************************************************************
+
+//**************************************************************
+//--------------------------------------------------------------
+//      Startup report: the cpu and NUMA node of each OpenMP thread,
+//      and the NUMA node the harmonics of this rank were placed on
+        void Placement_report(State1D& Y, const int rank);
+        void Placement_report(State2D& Y, const int rank);
+//      Every thread of a team moves the pages of the harmonics it owns
+//      in the chunk table of num_harmonics to its own NUMA node
+        void Place_harmonics(const size_t num_harmonics);
+//--------------------------------------------------------------
 //**************************************************************
 
     #endif
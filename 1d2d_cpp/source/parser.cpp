@@ -18,6 +18,9 @@
 
 #include <math.h>
 #include <map>
+#include <string>
+#include <tuple>
+#include <utility>
 
 //  My libraries
 #include "lib-array.h"
@@ -55,62 +58,59 @@ void Parser::checkparse(parser_t& parser, std::string& expression_str, expressio
 }
 //----------------------------------------------------------------------------------------------------------------------------
 /**
- * @brief      parses function over x (or a grid) and returns a grid.
- *
- * @param      str_profile  The string profile
- * @param      profile      The profile
+ * @brief      A profile string prepared once: the constant, the piecewise table or the compiled 
+ *             expression, whose variables x, y and t are bound to the members of the same name.
+ *             The profiles are evaluated every step, so they are cached by string. Not thread-safe.
  */
 //----------------------------------------------------------------------------------------------------------------------------
-void Parser::parseprofile( const valarray<double>& grid, std::string& str_profile, valarray<double>& profile){
+namespace Parser{
+    class Profile {
+    public:
+        Profile(const std::string& str_profile, const std::string& variables);
+
+        char            kind;           // 'c'onstant, 'f'unction or 'p'iecewise
+        double          constant;
+        vector<double>  loc, val;
+        double          x, y, t;
+
+        symbol_table_t  symbol_table;
+        expression_t    expression;
+
+    private:
+        Profile(const Profile& other);
+    };
+
+    Profile& compiled(const std::string& str_profile, const std::string& variables);
+}
+//----------------------------------------------------------------------------------------------------------------------------
+Parser::Profile::Profile(const std::string& str_profile, const std::string& variables)
+    : kind(str_profile[0]), constant(0.0), x(0.0), y(0.0), t(0.0) {
 
     /// Find curly brackets
     std::size_t posL = str_profile.find("{");
     std::size_t posR = str_profile.find("}");
+    std::string inside = str_profile.substr(posL+1,posR-(posL+1));
 
-    /// Uniform profile, convert string to double and set.
-    if (str_profile[0] == 'c')
-    {
-        // std::cout<< "\nexpression_str is  " << str_profile.substr(posL+1,posR-(posL+1)) << "\n";
-        
-        // profile = std::stod(str_profile.substr(posL+1,posR-(posL+1)));
-        profile = std::strtod((str_profile.substr(posL+1,posR-(posL+1))).c_str(),NULL);
-        
-
-        // std::cout << "\nprofile[1] = " << writeable[0] << " , " << writeable[1] << "\n\n";
-        // std::cout << "\nprofile[1]= " << profile[1] << "\n\n";
-    }
-
-    // exit(1);
+    /// Uniform profile, convert string to double
+    if (kind == 'c') constant = std::strtod(inside.c_str(),NULL);
 
-    /// Profile defined by function
-    if (str_profile[0] == 'f')
+    /// Profile defined by function, only the variables of this overload are known
+    if (kind == 'f')
     {
-        /// Grab everything inside curly brackets
-        std::string expression_str = str_profile.substr(posL+1,posR-(posL+1));
-
-        symbol_table_t symbol_table;
         symbol_table.add_constants();
-        double xstr;
-        symbol_table.add_variable("x",xstr);
-
-        expression_t expression;
+        if (variables.find('x') != std::string::npos) symbol_table.add_variable("x",x);
+        if (variables.find('y') != std::string::npos) symbol_table.add_variable("y",y);
+        if (variables.find('t') != std::string::npos) symbol_table.add_variable("t",t);
 
         expression.register_symbol_table(symbol_table);
 
         parser_t parser;
-
-        checkparse(parser, expression_str, expression);
-
-        for (size_t i(0); i < profile.size(); ++i) {
-            xstr = grid[i];
-            profile[i] = expression.value();
-        }
+        checkparse(parser, inside, expression);
     }
 
-    if (str_profile[0] == 'p'){
-        std::string pcw_pairs = str_profile.substr(posL+1,posR-(posL+1));
+    if (kind == 'p'){
+        std::string pcw_pairs = inside;
         vector<size_t> positions_comma, positions_semicolon; // holds all the positions that sub occurs within str
-        vector<double> loc,val;
         size_t pos = pcw_pairs.find(',', 0);
         while(pos != string::npos)
         {
@@ -131,29 +131,60 @@ void Parser::parseprofile( const valarray<double>& grid, std::string& str_profil
             exit(1);
         }
 
-
-        // loc.push_back(std::stod(pcw_pairs.substr(0,positions_comma[0]-1)));
-        // std::string
         loc.push_back(std::strtod((pcw_pairs.substr(0,positions_comma[0]-1)).c_str(),NULL));
-        // val.push_back(std::stod(pcw_pairs.substr(positions_comma[0]+1,positions_semicolon[0]-positions_comma[0]-1)));
         val.push_back(std::strtod((pcw_pairs.substr(positions_comma[0]+1,positions_semicolon[0]-positions_comma[0]-1)).c_str(),NULL));
 
-        // std::cout << "loc0 = " << loc[0] << endl;
-        // std::cout << "val0 = " << val[0] << endl;
-
         for (size_t i(1); i < positions_comma.size(); ++i) {
-
-            // loc.push_back(std::stod(pcw_pairs.substr(positions_semicolon[i-1]+1,positions_comma[i]-positions_semicolon[i-1]-1)));
             loc.push_back(std::strtod((pcw_pairs.substr(positions_semicolon[i-1]+1,positions_comma[i]-positions_semicolon[i-1]-1)).c_str(),NULL));
-
-            // val.push_back(std::stod(pcw_pairs.substr(positions_comma[i]+1,positions_semicolon[i]-positions_comma[i]-1)));
             val.push_back(std::strtod((pcw_pairs.substr(positions_comma[i]+1,positions_semicolon[i]-positions_comma[i]-1)).c_str(),NULL));
+        }
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------------
+/**
+ * @brief      The cached profile of str_profile for the given variables, prepared on first use
+ */
+//----------------------------------------------------------------------------------------------------------------------------
+Parser::Profile& Parser::compiled(const std::string& str_profile, const std::string& variables){
+
+    static std::map<std::string, Profile> cache;
 
-            // std::cout << "loci = " << loc[i] << endl;
-            // std::cout << "vali = " << val[i] << endl;
+    std::string key(variables + ":" + str_profile);
+    std::map<std::string, Profile>::iterator it(cache.find(key));
+    if (it == cache.end()) {
+        it = cache.emplace(std::piecewise_construct, std::forward_as_tuple(key), 
+                           std::forward_as_tuple(str_profile, variables)).first;
+    }
 
+    return it->second;
+}
+//----------------------------------------------------------------------------------------------------------------------------
+/**
+ * @brief      parses function over x (or a grid) and returns a grid.
+ *
+ * @param      str_profile  The string profile
+ * @param      profile      The profile
+ */
+//----------------------------------------------------------------------------------------------------------------------------
+void Parser::parseprofile( const valarray<double>& grid, std::string& str_profile, valarray<double>& profile){
+
+    Profile& P(compiled(str_profile, "x"));
+
+    /// Uniform profile
+    if (P.kind == 'c') profile = P.constant;
+
+    /// Profile defined by function
+    if (P.kind == 'f')
+    {
+        for (size_t i(0); i < profile.size(); ++i) {
+            P.x = grid[i];
+            profile[i] = P.expression.value();
         }
+    }
 
+    if (P.kind == 'p'){
+        const vector<double>& loc(P.loc);
+        const vector<double>& val(P.val);
 
         double tmp_x, xx;
         size_t t(0);
@@ -166,8 +197,6 @@ void Parser::parseprofile( const valarray<double>& grid, std::string& str_profil
             while ((xx > loc[t]) && (t < loc.size()-1)) ++t;
             tmp_x = val[t-1] + (val[t]-val[t-1])/(loc[t]-loc[t-1])
                                * (xx - loc[t-1]);
-            // std::cout << i << "     " << x[i] << "      " << tmp_x << std::endl;
-            //             for (size_t j(0); j < Temp.dim2(); ++j)  Temp(i,j) *= tmp_x;
             profile[i] = tmp_x;
         }
     }
@@ -183,52 +212,23 @@ void Parser::parseprofile( const valarray<double>& grid, std::string& str_profil
 //----------------------------------------------------------------------------------------------------------------------------
 void Parser::parseprofile( const valarray<double>& grid1, const valarray<double>& grid2, std::string& str_profile, Array2D<double>& profile){
 
-    /// Find curly brackets
-    std::size_t posL = str_profile.find("{");
-    std::size_t posR = str_profile.find("}");
+    Profile& P(compiled(str_profile, "xy"));
 
-    /// Uniform profile, convert string to double and set.
-    if (str_profile[0] == 'c')
-    {
-        // std::cout<< "\nexpression_str is  " << str_profile.substr(posL+1,posR-(posL+1)) << "\n";
-        
-        // profile = std::stod(str_profile.substr(posL+1,posR-(posL+1)));
-        profile = std::strtod((str_profile.substr(posL+1,posR-(posL+1))).c_str(),NULL);
-        
-
-        // std::cout << "\nprofile[1] = " << writeable[0] << " , " << writeable[1] << "\n\n";
-        // std::cout << "\nprofile[1]= " << profile[1] << "\n\n";
-    }
+    /// Uniform profile
+    if (P.kind == 'c') profile = P.constant;
 
     /// Profile defined by function
-    if (str_profile[0] == 'f')
+    if (P.kind == 'f')
     {
-        /// Grab everything inside curly brackets
-        std::string expression_str = str_profile.substr(posL+1,posR-(posL+1));
-
-        symbol_table_t symbol_table;
-        symbol_table.add_constants();
-        double xstr, ystr;
-        symbol_table.add_variable("x",xstr);
-        symbol_table.add_variable("y",ystr);
-
-        expression_t expression;
-
-        expression.register_symbol_table(symbol_table);
-
-        parser_t parser;
-
-        checkparse(parser, expression_str, expression);
-
         for (size_t i1(0); i1 < grid1.size(); ++i1) 
         {
-            xstr = grid1[i1];
+            P.x = grid1[i1];
             
             for (size_t i2(0); i2 < grid2.size(); ++i2) 
             {
-                ystr = grid2[i2];
+                P.y = grid2[i2];
                 
-                profile(i1,i2) = expression.value();
+                profile(i1,i2) = P.expression.value();
 
             }
         }
@@ -307,49 +307,16 @@ void Parser::parseprofile( const valarray<double>& grid1, const valarray<double>
 //----------------------------------------------------------------------------------------------------------------------------
 void Parser::parseprofile(const double& input, std::string& str_profile, double& output){
 
-    /// Find curly brackets
-    std::size_t posL = str_profile.find("{");
-    std::size_t posR = str_profile.find("}");
+    Profile& P(compiled(str_profile, "t"));
 
-    /// Uniform profile, convert string to double and set.
-    if (str_profile[0] == 'c')
-    {
-        // std::cout<< "expression_str is  " << str_profile.substr(posL+1,posR-(posL+1)) << "\n";
-        // output = std::stod(str_profile.substr(posL+1,posR-(posL+1)));
-        output = std::strtod((str_profile.substr(posL+1,posR-(posL+1))).c_str(),NULL);
-        
-    }
+    /// Uniform profile
+    if (P.kind == 'c') output = P.constant;
 
     /// Profile defined by function
-    if (str_profile[0] == 'f')
+    if (P.kind == 'f')
     {
-        /// Grab everything inside curly brackets
-        std::string expression_str = str_profile.substr(posL+1,posR-(posL+1));
-
-        symbol_table_t symbol_table;
-        symbol_table.add_constants();
-        double xstr;
-        symbol_table.add_variable("t",xstr);
-
-        expression_t expression;
-
-        expression.register_symbol_table(symbol_table);
-
-        parser_t parser;
-
-        checkparse(parser, expression_str, expression);
-
-        // for (size_t i(0); i < profile.size(); ++i) {
-        xstr = input;
-        // std::cout<< "i= " << i << ",xstr = " << xstr << "\n";
-
-        // result =
-        // Temperature_map(s,i) = expression_Temperature.value();
-        output = expression.value();
-        // std::cout  << " \n 10: " << input << " , " << output << "\n";
-        // exit(1);
-        // printf("Result: %10.5f\n",expression.value());
-
+        P.t = input;
+        output = P.expression.value();
     }
 
     //     if (str_profile[0] == 'p'){
@@ -419,47 +386,21 @@ void Parser::parseprofile(const double& input, std::string& str_profile, double&
 //----------------------------------------------------------------------------------------------------------------------------
 void Parser::parseprofile(const valarray<double>& grid, const double& input, std::string& str_profile, valarray<double>& output){
 
-    /// Find curly brackets
-    std::size_t posL = str_profile.find("{");
-    std::size_t posR = str_profile.find("}");
+    Profile& P(compiled(str_profile, "xt"));
 
-    /// Uniform profile, convert string to double and set.
-    if (str_profile[0] == 'c')
-    {
-        // std::cout<< "expression_str is  " << str_profile.substr(posL+1,posR-(posL+1)) << "\n";
-        // output = std::stod(str_profile.substr(posL+1,posR-(posL+1)));
-        output = std::strtod((str_profile.substr(posL+1,posR-(posL+1))).c_str(),NULL);
-    }
+    /// Uniform profile
+    if (P.kind == 'c') output = P.constant;
 
     /// Profile defined by function
-    if (str_profile[0] == 'f')
+    if (P.kind == 'f')
     {
-        /// Grab everything inside curly brackets
-        std::string expression_str = str_profile.substr(posL+1,posR-(posL+1));
-
-        symbol_table_t symbol_table;
-        symbol_table.add_constants();
-        double xstr, tstr;
-        symbol_table.add_variable("x",xstr);
-        symbol_table.add_variable("t",tstr);
-
-        expression_t expression;
-
-        expression.register_symbol_table(symbol_table);
-
-        parser_t parser;
-
-        checkparse(parser, expression_str, expression);
-        tstr = input;
+        P.t = input;
 
         for (size_t i(0); i < output.size(); ++i) {
-            xstr = grid[i];
+            P.x = grid[i];
 
-            output[i] = expression.value();
+            output[i] = P.expression.value();
         }
-
-
-
     }
 
 }
@@ -467,55 +408,27 @@ void Parser::parseprofile(const valarray<double>& grid, const double& input, std
 //----------------------------------------------------------------------------------------------------------------------------
 void Parser::parseprofile(const valarray<double>& grid1, const valarray<double>& grid2, const double& input, std::string& str_profile, Array2D<double>& output){
 
-    /// Find curly brackets
-    std::size_t posL = str_profile.find("{");
-    std::size_t posR = str_profile.find("}");
+    Profile& P(compiled(str_profile, "xyt"));
 
-    /// Uniform profile, convert string to double and set.
-    if (str_profile[0] == 'c')
-    {
-        // std::cout<< "expression_str is  " << str_profile.substr(posL+1,posR-(posL+1)) << "\n";
-        // output = std::stod(str_profile.substr(posL+1,posR-(posL+1)));
-        output = std::strtod((str_profile.substr(posL+1,posR-(posL+1))).c_str(),NULL);
-    }
+    /// Uniform profile
+    if (P.kind == 'c') output = P.constant;
 
     /// Profile defined by function
-    if (str_profile[0] == 'f')
+    if (P.kind == 'f')
     {
-        /// Grab everything inside curly brackets
-        std::string expression_str = str_profile.substr(posL+1,posR-(posL+1));
-
-        symbol_table_t symbol_table;
-        symbol_table.add_constants();
-        double xstr, ystr, tstr;
-        symbol_table.add_variable("x",xstr);
-        symbol_table.add_variable("y",ystr);
-        symbol_table.add_variable("t",tstr);
-
-        expression_t expression;
-
-        expression.register_symbol_table(symbol_table);
-
-        parser_t parser;
-
-        checkparse(parser, expression_str, expression);
-        tstr = input;
+        P.t = input;
 
         for (size_t ix(0); ix < output.dim1(); ++ix) 
         {
+            P.x = grid1[ix];
+
             for (size_t iy(0); iy < output.dim2(); ++iy) 
             {
+                P.y = grid2[iy];
 
-                xstr = grid1[ix];
-                ystr = grid2[iy];
-
-                output(ix,iy) = expression.value();
+                output(ix,iy) = P.expression.value();
             }
         }
-
-
-
     }
 
 }
-
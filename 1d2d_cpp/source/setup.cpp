@@ -127,150 +127,260 @@ void Setup_Y::applyexternalfields(Grid_Info &grid, State2D& Y, double time)
 }
 //---------------------------------------------------------------------------
 //---------------------------------------------------------------------------
-void Setup_Y::applytravelingwave(Grid_Info &grid, State1D& Y, double time, double stepsize)
-{
-
-    for (size_t n(0); n < Input::List().num_waves; ++n)
-    {
-        valarray<double> Ex_profile( grid.axis.Nx(0));
-        valarray<double> Ey_profile( grid.axis.Nx(0));
-        valarray<double> Ez_profile( grid.axis.Nx(0));
-        valarray<double> Bx_profile( grid.axis.Nx(0));
-        valarray<double> By_profile( grid.axis.Nx(0));
-        valarray<double> Bz_profile( grid.axis.Nx(0));
+/**
+ * @brief      One field of a traveling wave on the local cells. At setup the profile is
+ *             sampled at the cells and at irregular times across the pulse. When a skeleton
+ *             of rank R <= 2, f(x,t) = sum_r G_r(x) f(x_r,t), reproduces all samples the
+ *             profile is separable: g(x)h(t) has R = 1 and a wave sin(kx-wt) has R = 2, and
+ *             a step only evaluates f at the R pivot cells x_r. Otherwise the whole profile
+ *             is evaluated at every step.
+ */
+namespace Setup_Y {
+    class Wave_Field {
+    public:
+        Wave_Field(const valarray<double>& _x, const valarray<double>& _y,
+                   const std::string& _str, const double t0, const double t1);
+
+        bool zero() const { return (rank == 0); }
+        bool separable() const { return _separable; }
+        const valarray<double>& operator()(const double time);
+
+    private:
+        void sample(const double time, valarray<double>& f);
+        void sample_pivots(const double time, valarray<double>& v);
+
+        std::string str;
+        valarray<double> x, y;                  // y is empty in 1D
+        size_t rank;
+        bool _separable;
+        valarray<double> px, py;                // pivot cells
+        vector< valarray<double> > G;           // spatial factors
+        valarray<double> pv, profile;
+    };
+}
+//---------------------------------------------------------------------------
+Setup_Y::Wave_Field::Wave_Field(const valarray<double>& _x, const valarray<double>& _y,
+                                const std::string& _str, const double t0, const double t1)
+    : str(_str), x(_x), y(_y), rank(0), _separable(true),
+      profile(0.0, _x.size()*(_y.size() > 0 ? _y.size() : 1)){
+
+    const size_t K(6);              // fit times, as many again to check the fit
+    const double tol(1e-10);
+    const size_t N(profile.size());
+
+    vector< valarray<double> > F(2*K, valarray<double>(0.0, N));
+    double scale(0.0);
+    for (size_t j(0); j < 2*K; ++j) {
+        double a(0.5 + 0.6180339887498949*j);
+        sample(t0 + (t1-t0)*(a - floor(a)), F[j]);
+        for (size_t i(0); i < N; ++i) scale = max(scale, fabs(F[j][i]));
+    }
+    if (scale == 0.0) return;
+
+//  Cross approximation with full pivoting on the fit times
+    vector< valarray<double> > Rm(F.begin(), F.begin()+K);
+    vector<size_t> I, J;
+    for (size_t r(0); r < 2; ++r) {
+        size_t im(0), jm(0);
+        double big(0.0);
+        for (size_t j(0); j < K; ++j) {
+            for (size_t i(0); i < N; ++i) {
+                if (fabs(Rm[j][i]) > big) { big = fabs(Rm[j][i]); im = i; jm = j; }
+            }
+        }
+        if (big <= tol*scale) break;
+        I.push_back(im); J.push_back(jm);
 
-        /// Parser::parse the strings
-        Parser::parseprofile(grid.axis.x(0), time, Input::List().ex_wave_profile_str[n], Ex_profile);
-        Parser::parseprofile(grid.axis.x(0), time, Input::List().ey_wave_profile_str[n], Ey_profile);
-        Parser::parseprofile(grid.axis.x(0), time, Input::List().ez_wave_profile_str[n], Ez_profile);
-        Parser::parseprofile(grid.axis.x(0), time, Input::List().bx_wave_profile_str[n], Bx_profile);
-        Parser::parseprofile(grid.axis.x(0), time, Input::List().by_wave_profile_str[n], By_profile);
-        Parser::parseprofile(grid.axis.x(0), time, Input::List().bz_wave_profile_str[n], Bz_profile);
+        valarray<double> column(Rm[jm]);
+        for (size_t j(0); j < K; ++j) Rm[j] -= column*(Rm[j][im]/column[im]);
+    }
+    rank = I.size();
+
+//  G = F(:,J) F(I,J)^-1
+    double M[2][2] = {{F[J[0]][I[0]], 0.0}, {0.0, 1.0}};
+    if (rank > 1) {
+        M[0][1] = F[J[1]][I[0]];
+        M[1][0] = F[J[0]][I[1]];
+        M[1][1] = F[J[1]][I[1]];
+    }
+    double det(M[0][0]*M[1][1] - M[0][1]*M[1][0]);
+    double Minv[2][2] = {{ M[1][1]/det, -M[0][1]/det}, {-M[1][0]/det, M[0][0]/det}};
 
+    G.assign(rank, valarray<double>(0.0, N));
+    for (size_t r(0); r < rank; ++r) {
+        for (size_t s(0); s < rank; ++s) G[r] += F[J[s]]*Minv[s][r];
+    }
 
-        double time_coeff(-1.0);
+    px.resize(rank); py.resize(rank); pv.resize(rank);
+    for (size_t r(0); r < rank; ++r) {
+        px[r] = x[I[r] % x.size()];
+        if (y.size() > 0) py[r] = y[I[r] / x.size()];
+    }
 
-        double pulse_start(Input::List().trav_wave_center[n] -
-                        Input::List().trav_wave_flat[n]*0.5 -
-                        Input::List().trav_wave_rise[n] );
+//  The skeleton has to reproduce every sample
+    for (size_t j(0); j < 2*K; ++j) {
+        valarray<double> fit(0.0, N);
+        for (size_t r(0); r < rank; ++r) fit += G[r]*F[j][I[r]];
+        fit -= F[j];
+        if (abs(fit).max() > tol*scale) {
+            _separable = false;
+            break;
+        }
+    }
+}
+//---------------------------------------------------------------------------
+//  The profile on the local cells
+const valarray<double>& Setup_Y::Wave_Field::operator()(const double time){
 
-        double pulse_end(Input::List().trav_wave_center[n] +
-                        Input::List().trav_wave_flat[n]*0.5 +
-                        Input::List().trav_wave_fall[n] );
+    if (!_separable) {
+        sample(time, profile);
+        return profile;
+    }
 
-        double normalized_time(0.0);
-        
-        if (time >= pulse_start && time <= pulse_end)
-        {
-        
-            if (time < Input::List().trav_wave_center[n] - 0.5*Input::List().trav_wave_flat[n])
-            {
-                normalized_time = (time - pulse_start)/ Input::List().trav_wave_rise[n];
+    sample_pivots(time, pv);
+    profile = G[0]*pv[0];
+    for (size_t r(1); r < rank; ++r) profile += G[r]*pv[r];
 
-                time_coeff  = 6.0 * pow(normalized_time,5.0);
-                time_coeff -= 15.0 * pow(normalized_time,4.0);
-                time_coeff += 10.0 * pow(normalized_time,3.0);
-            }
-            else if (time >= Input::List().trav_wave_center[n] - 0.5*Input::List().trav_wave_flat[n] &&
-                time <= Input::List().trav_wave_center[n] + 0.5*Input::List().trav_wave_flat[n])
-            {
-                time_coeff = 1.0;
-            }
-            else if (time > Input::List().trav_wave_center[n] + 0.5*Input::List().trav_wave_flat[n])
-            {
-                normalized_time = (time - (Input::List().trav_wave_center[n] + 0.5*Input::List().trav_wave_flat[n]))
-                / Input::List().trav_wave_fall[n];
+    return profile;
+}
+//---------------------------------------------------------------------------
+void Setup_Y::Wave_Field::sample(const double time, valarray<double>& f){
 
-                time_coeff  = 15.0 * pow(normalized_time,4.0);
-                time_coeff -= 6.0 * pow(normalized_time,5.0);
-                time_coeff -= 10.0 * pow(normalized_time,3.0);
-                time_coeff += 1.0;
-            }
+    if (y.size() == 0) {
+        Parser::parseprofile(x, time, str, f);
+        return;
+    }
+    Array2D<double> f2D(x.size(), y.size());
+    Parser::parseprofile(x, y, time, str, f2D);
+    f = f2D.array();
+}
+//---------------------------------------------------------------------------
+void Setup_Y::Wave_Field::sample_pivots(const double time, valarray<double>& v){
 
-            for (size_t ix(0);ix<Y.SH(0,0,0).numx();++ix)
-            {
-                Y.EMF().Ex()(ix) += Ex_profile[ix]*time_coeff*stepsize;
-                Y.EMF().Ey()(ix) += Ey_profile[ix]*time_coeff*stepsize;
-                Y.EMF().Ez()(ix) += Ez_profile[ix]*time_coeff*stepsize;
-                Y.EMF().Bx()(ix) += Bx_profile[ix]*time_coeff*stepsize;
-                Y.EMF().By()(ix) += By_profile[ix]*time_coeff*stepsize;
-                Y.EMF().Bz()(ix) += Bz_profile[ix]*time_coeff*stepsize;
-            }
-        }
+    if (y.size() == 0) {
+        Parser::parseprofile(px, time, str, v);
+        return;
     }
+    Array2D<double> v2D(rank, rank);
+    Parser::parseprofile(px, py, time, str, v2D);
+    for (size_t r(0); r < rank; ++r) v[r] = v2D(r,r);
 }
 //---------------------------------------------------------------------------
-void Setup_Y::applytravelingwave(Grid_Info &grid, State2D& Y, double time, double stepsize)
-{
+//---------------------------------------------------------------------------
+/**
+ * @brief      The pulse window [start, end] of wave n and its smoothstep envelope at time
+ *
+ * @return     false outside the window
+ */
+static bool travelingwave_envelope(const size_t n, const double time, double& time_coeff){
 
-    for (size_t n(0); n < Input::List().num_waves; ++n)
+    const double rise_end(Input::List().trav_wave_center[n] - 0.5*Input::List().trav_wave_flat[n]);
+    const double fall_start(Input::List().trav_wave_center[n] + 0.5*Input::List().trav_wave_flat[n]);
+
+    if (time < rise_end - Input::List().trav_wave_rise[n] ||
+        time > fall_start + Input::List().trav_wave_fall[n]) return false;
+
+    double normalized_time(0.0);
+    time_coeff = 1.0;
+
+    if (time < rise_end)
     {
+        normalized_time = (time - (rise_end - Input::List().trav_wave_rise[n])) / Input::List().trav_wave_rise[n];
+        time_coeff = normalized_time*normalized_time*normalized_time
+                   * (10.0 + normalized_time*(6.0*normalized_time - 15.0));
+    }
+    else if (time > fall_start)
+    {
+        normalized_time = (time - fall_start) / Input::List().trav_wave_fall[n];
+        time_coeff = 1.0 - normalized_time*normalized_time*normalized_time
+                         * (10.0 + normalized_time*(6.0*normalized_time - 15.0));
+    }
 
-        Array2D<double> Ex_profile( grid.axis.Nx(0), grid.axis.Nx(1));
-        Array2D<double> Ey_profile( grid.axis.Nx(0), grid.axis.Nx(1));
-        Array2D<double> Ez_profile( grid.axis.Nx(0), grid.axis.Nx(1));
-        Array2D<double> Bx_profile( grid.axis.Nx(0), grid.axis.Nx(1));
-        Array2D<double> By_profile( grid.axis.Nx(0), grid.axis.Nx(1));
-        Array2D<double> Bz_profile( grid.axis.Nx(0), grid.axis.Nx(1));
+    return true;
+}
+//---------------------------------------------------------------------------
+//  The six fields of every wave on the local cells, classified on the first call
+//  and again when the load balance moves the local cells
+static vector<Setup_Y::Wave_Field>& travelingwave_fields(Grid_Info &grid){
+
+    static vector<Setup_Y::Wave_Field> fields;
+    static size_t nx(0);
+    static double xfirst(0.0);
+
+    if (nx != grid.axis.Nx(0) || xfirst != grid.axis.x(0)[0]) {
+        fields.clear();
+        nx     = grid.axis.Nx(0);
+        xfirst = grid.axis.x(0)[0];
+    }
 
-        /// Parser::parse the strings
-        Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), time, Input::List().ex_wave_profile_str[n], Ex_profile);
-        Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), time, Input::List().ey_wave_profile_str[n], Ey_profile);
-        Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), time, Input::List().ez_wave_profile_str[n], Ez_profile);
-        Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), time, Input::List().bx_wave_profile_str[n], Bx_profile);
-        Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), time, Input::List().by_wave_profile_str[n], By_profile);
-        Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), time, Input::List().bz_wave_profile_str[n], Bz_profile);
+    if (fields.empty()) {
+        valarray<double> y;
+        if (grid.axis.xdim() > 1) y.resize(grid.axis.Nx(1));
+        if (y.size() > 0) y = grid.axis.x(1);
 
+        for (size_t n(0); n < Input::List().num_waves; ++n)
+        {
+            double t0(Input::List().trav_wave_center[n] - 0.5*Input::List().trav_wave_flat[n] - Input::List().trav_wave_rise[n]);
+            double t1(Input::List().trav_wave_center[n] + 0.5*Input::List().trav_wave_flat[n] + Input::List().trav_wave_fall[n]);
 
-        double time_coeff(-1.0);
+            const std::string* str[6] = { &Input::List().ex_wave_profile_str[n], &Input::List().ey_wave_profile_str[n],
+                                          &Input::List().ez_wave_profile_str[n], &Input::List().bx_wave_profile_str[n],
+                                          &Input::List().by_wave_profile_str[n], &Input::List().bz_wave_profile_str[n] };
+            for (size_t c(0); c < 6; ++c) fields.push_back(Setup_Y::Wave_Field(grid.axis.x(0), y, *str[c], t0, t1));
+        }
+    }
 
-        double pulse_start(Input::List().trav_wave_center[n] -
-                        Input::List().trav_wave_flat[n]*0.5 -
-                        Input::List().trav_wave_rise[n] );
+    return fields;
+}
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+void Setup_Y::applytravelingwave(Grid_Info &grid, State1D& Y, double time, double stepsize)
+{
+    vector<Wave_Field>& fields(travelingwave_fields(grid));
+
+    for (size_t n(0); n < Input::List().num_waves; ++n)
+    {
+        double time_coeff(0.0);
+        if (!travelingwave_envelope(n, time, time_coeff)) continue;
 
-        double pulse_end(Input::List().trav_wave_center[n] +
-                        Input::List().trav_wave_flat[n]*0.5 +
-                        Input::List().trav_wave_fall[n] );
+        Field1D* EMF[6] = { &Y.EMF().Ex(), &Y.EMF().Ey(), &Y.EMF().Ez(),
+                            &Y.EMF().Bx(), &Y.EMF().By(), &Y.EMF().Bz() };
 
-        double normalized_time(0.0);
-        
-        if (time >= pulse_start && time <= pulse_end)
+        for (size_t c(0); c < 6; ++c)
         {
-        
-            if (time < Input::List().trav_wave_center[n] - 0.5*Input::List().trav_wave_flat[n])
-            {
-                normalized_time = (time - pulse_start)/ Input::List().trav_wave_rise[n];
+            if (fields[6*n+c].zero()) continue;
 
-                time_coeff  = 6.0 * pow(normalized_time,5.0);
-                time_coeff -= 15.0 * pow(normalized_time,4.0);
-                time_coeff += 10.0 * pow(normalized_time,3.0);
-            }
-            else if (time >= Input::List().trav_wave_center[n] - 0.5*Input::List().trav_wave_flat[n] &&
-                time <= Input::List().trav_wave_center[n] + 0.5*Input::List().trav_wave_flat[n])
+            const valarray<double>& profile(fields[6*n+c](time));
+            for (size_t ix(0);ix<Y.SH(0,0,0).numx();++ix)
             {
-                time_coeff = 1.0;
+                (*EMF[c])(ix) += profile[ix]*time_coeff*stepsize;
             }
-            else if (time > Input::List().trav_wave_center[n] + 0.5*Input::List().trav_wave_flat[n])
-            {
-                normalized_time = (time - (Input::List().trav_wave_center[n] + 0.5*Input::List().trav_wave_flat[n]))
-                / Input::List().trav_wave_fall[n];
+        }
+    }
+}
+//---------------------------------------------------------------------------
+void Setup_Y::applytravelingwave(Grid_Info &grid, State2D& Y, double time, double stepsize)
+{
+    vector<Wave_Field>& fields(travelingwave_fields(grid));
 
-                time_coeff  = 15.0 * pow(normalized_time,4.0);
-                time_coeff -= 6.0 * pow(normalized_time,5.0);
-                time_coeff -= 10.0 * pow(normalized_time,3.0);
-                time_coeff += 1.0;
-            }
+    for (size_t n(0); n < Input::List().num_waves; ++n)
+    {
+        double time_coeff(0.0);
+        if (!travelingwave_envelope(n, time, time_coeff)) continue;
+
+        Field2D* EMF[6] = { &Y.EMF().Ex(), &Y.EMF().Ey(), &Y.EMF().Ez(),
+                            &Y.EMF().Bx(), &Y.EMF().By(), &Y.EMF().Bz() };
 
+        for (size_t c(0); c < 6; ++c)
+        {
+            if (fields[6*n+c].zero()) continue;
+
+            const valarray<double>& profile(fields[6*n+c](time));
             for (size_t ix(0);ix<Y.SH(0,0,0).numx();++ix)
             {
                 for (size_t iy(0);iy<Y.SH(0,0,0).numy();++iy)
                 {
-                    Y.EMF().Ex()(ix,iy) += Ex_profile(ix,iy)*time_coeff*stepsize;
-                    Y.EMF().Ey()(ix,iy) += Ey_profile(ix,iy)*time_coeff*stepsize;
-                    Y.EMF().Ez()(ix,iy) += Ez_profile(ix,iy)*time_coeff*stepsize;
-                    Y.EMF().Bx()(ix,iy) += Bx_profile(ix,iy)*time_coeff*stepsize;
-                    Y.EMF().By()(ix,iy) += By_profile(ix,iy)*time_coeff*stepsize;
-                    Y.EMF().Bz()(ix,iy) += Bz_profile(ix,iy)*time_coeff*stepsize;
+                    (*EMF[c])(ix,iy) += profile[ix+iy*grid.axis.Nx(0)]*time_coeff*stepsize;
                 }
             }
         }
@@ -449,39 +559,39 @@ void Setup_Y:: init_f0(size_t s, SHarmonic1D& h, const valarray<double>& p, cons
                        valarray<double>& density, valarray<double>& temperature, const double mass, const valarray<double>& pedestal){
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
-    double alpha, coeff, coefftemp, coefftemp_relativistic;
+    double alpha, coeff;
     double m = Input::List().super_gaussian_m;
 
     alpha = sqrt(3.0*tgamma(3.0/m)/2.0/tgamma(5.0/m));
     coeff = m/alpha/alpha/alpha/tgamma(3.0/m);
     coeff *= sqrt(M_PI)/4.0;
 
-    for (int j(0); j < h.numx(); ++j){
+    /// p/alpha is the same in every cell
+    const valarray<double> palpha(p/alpha);
 
-        // std::cout << "\n";
-
-        coefftemp = coeff*density[j]/pow(2.0*M_PI*temperature[j]*mass,1.5);
-        
-        // coefftemp_relativistic = density[j]/(4.0*M_PI*temperature[j]*pow(mass,3.)*boost::math::cyl_bessel_k(2.,1./temperature[j]));
+    //  Each thread fills a contiguous block of cells (static schedule,
+    //  as in the collision loops over x)
+    #pragma omp parallel num_threads(Input::List().ompthreads)
+    {
+        valarray<double> f0(palpha.size());
 
-        // std::cout << "\n\n coefftemp_relativistic = " << coefftemp_relativistic << "\n\n";
+        #pragma omp for schedule(static)
+        for (int j = 0; j < h.numx(); ++j){
 
-        
-        for (int k(0); k < h.nump(); ++k){
+            double coefftemp = coeff*density[j]/pow(2.0*M_PI*temperature[j]*mass,1.5);
 
             // New formulation for temperature distribution and super-Gaussians
-            h(k,j) = coefftemp*exp(-1.0*pow((p[k])/alpha/sqrt(2.0*temperature[j]*mass),m));
-            h(k,j)+= pedestal[j];
-            // std::cout << "f0[" << p[k] << "] = " << exp(-1.0*pow((p[k])/alpha/sqrt(2.0*temperature[j]*mass),m)) << "\n";
-            // 
+            f0  = palpha / sqrt(2.0*temperature[j]*mass);
+            f0  = exp(-pow(f0,m));
+            f0 *= coefftemp;
+            f0 += pedestal[j];
+
             // Maxwell-Jutner distribution
             // if (Input::List().relativity) 
             //     h(k,j) = coefftemp_relativistic*exp(-sqrt(1.0+p[k]*p[k])/temperature[j]);
 
-            // std::cout << "\n\n h(" << k << "," << j << ") = " << h(k,j) << "\n\n";
+            for (int k(0); k < h.nump(); ++k) h(k,j) = f0[k];
         }
-        // exit(1);    
-
     }
 
 }
@@ -491,44 +601,42 @@ void Setup_Y:: init_f0(size_t s, SHarmonic2D& h, const valarray<double>& p, cons
                        Array2D<double>& density, Array2D<double>& temperature, const double mass, const Array2D<double>& pedestal){
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
-    double alpha, coeff, coefftemp, coefftemp_relativistic;
+    double alpha, coeff;
     double m = Input::List().super_gaussian_m;
 
     alpha = sqrt(3.0*tgamma(3.0/m)/2.0/tgamma(5.0/m));
     coeff = m/alpha/alpha/alpha/tgamma(3.0/m);
     coeff *= sqrt(M_PI)/4.0;
 
-    for (int ix(0); ix < h.numx(); ++ix)
-    {
-        for (int iy(0); iy < h.numy(); ++iy)
-        {
-
-            // std::cout << "\n";
+    /// p/alpha is the same in every cell
+    const valarray<double> palpha(p/alpha);
 
-            coefftemp = coeff*density(ix,iy)/pow(2.0*M_PI*temperature(ix,iy)*mass,1.5);
-            
-            // coefftemp_relativistic = density(ix,iy)/(4.0*M_PI*temperature(ix,iy)*pow(mass,3.)*boost::math::cyl_bessel_k(2.,1./temperature(ix,iy)));
-
-            // std::cout << "\n\n coefftemp_relativistic = " << coefftemp_relativistic << "\n\n";
+    //  Each thread fills a contiguous block of cells (static schedule,
+    //  as in the collision loops over x)
+    #pragma omp parallel num_threads(Input::List().ompthreads)
+    {
+        valarray<double> f0(palpha.size());
 
-            
-            for (int k(0); k < h.nump(); ++k){
+        #pragma omp for collapse(2) schedule(static)
+        for (int ix = 0; ix < h.numx(); ++ix)
+        {
+            for (int iy = 0; iy < h.numy(); ++iy)
+            {
+                double coefftemp = coeff*density(ix,iy)/pow(2.0*M_PI*temperature(ix,iy)*mass,1.5);
 
                 // New formulation for temperature distribution and super-Gaussians
-                h(k,ix,iy) = coefftemp*exp(-1.0*pow((p[k])/alpha/sqrt(2.0*temperature(ix,iy)*mass),m));
-                h(k,ix,iy)+= pedestal(ix,iy);
-                // std::cout << "f0[" << ix << "," << iy << "," << p[k] << "] = " << h(k,ix,iy) << "\n";
-                // 
+                f0  = palpha / sqrt(2.0*temperature(ix,iy)*mass);
+                f0  = exp(-pow(f0,m));
+                f0 *= coefftemp;
+                f0 += pedestal(ix,iy);
+
                 // Maxwell-Jutner distribution
                 // if (Input::List().relativity) 
                 //     h(k,ix,iy) = coefftemp_relativistic*exp(-sqrt(1.0+p[k]*p[k])/temperature(ix,iy));
 
-                // std::cout << "\n\n h(" << k << "," << j << ") = " << h(k,j) << "\n\n";
+                for (int k(0); k < h.nump(); ++k) h(k,ix,iy) = f0[k];
             }
-              
-
         }
-        // exit(1);  
     }
 
 }
@@ -541,10 +649,10 @@ void Setup_Y:: init_f0(size_t s, SHarmonic2D& h, const valarray<double>& p, cons
  */
 //----------------------------------------------------------------------------------------------------------------------------
 void Setup_Y:: init_f1(size_t s, SHarmonic1D& h, const valarray<double>& p, const valarray<double>& x,
-                       valarray<double>& density, valarray<double>& temperature, valarray<double>& f10x, const SHarmonic1D& f0, const double mass){
+                       valarray<double>&, valarray<double>&, valarray<double>& f10x, const SHarmonic1D& f0, const double){
 //----------------------------------------------------------------------------------------------------------------------
 //----------------------------------------------------------------------------------------------------------------------
-    double alpha, coeff, coefftemp;
+    double alpha, coeff;
     double m = Input::List().super_gaussian_m;
 
     SHarmonic1D df0(f0); df0.Dp();
@@ -556,12 +664,14 @@ void Setup_Y:: init_f1(size_t s, SHarmonic1D& h, const valarray<double>& p, cons
     coeff *= sqrt(M_PI)/4.0;
 
 
-    for (int j(0); j < h.numx(); ++j){
+    const valarray<double> p3(pow(p,3.0));
+
+    #pragma omp parallel for schedule(static) num_threads(Input::List().ompthreads)
+    for (int j = 0; j < h.numx(); ++j){
 
-        coefftemp = coeff*density[j]/pow(2.0*M_PI*temperature[j]*mass,1.5)*f10x[j];
         for (int k(0); k < h.nump(); ++k){
             // New formulation for temperature distribution and super-Gaussians
-            h(k,j) = idp*df0(k,j)*pow(p[k],3.0)*f10x[j];
+            h(k,j) = idp*df0(k,j)*p3[k]*f10x[j];
         }
 
     }
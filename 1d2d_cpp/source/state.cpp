@@ -25,10 +25,14 @@
 
 // Standard Libraries
 #include <mpi.h>
+#include <omp.h>
 #include <iostream>
 #include <vector>
 #include <valarray>
 #include <complex>
+#include <algorithm>
+#include <map>
+#include <set>
 
 
 // My Libraries
@@ -36,7 +40,9 @@
 #include "lib-algorithms.h"
 
 // Declerations
+#include "input.h"
 #include "state.h"
+#include "parallel.h"
 
 //--------------------------------------------------------------
 //  Definition of the 1D spherical harmonic
@@ -57,6 +63,11 @@ SHarmonic1D::SHarmonic1D(const SHarmonic1D& other){
 SHarmonic1D:: ~SHarmonic1D(){
     delete sh;
 }
+//  Fresh storage, zeroed by the calling thread
+void SHarmonic1D::allocate(size_t nump, size_t numx){
+    delete sh;
+    sh = new Array2D<complex<double> >(nump,numx);
+}
 
 //--------------------------------------------------------------
 //  Operators
@@ -250,6 +261,11 @@ void SHarmonic1D::checknan(){
     SHarmonic2D:: ~SHarmonic2D(){
         delete sh; 
     }
+//  Fresh storage, zeroed by the calling thread
+    void SHarmonic2D::allocate(size_t nump, size_t numx, size_t numy){
+        delete sh;
+        sh = new Array3D <complex <double> >(nump,numx,numy);
+    }
 
 //--------------------------------------------------------------
 //  Operators
@@ -808,6 +824,53 @@ EMF1D& EMF1D::operator-=(const EMF1D& other){
     }    
 
 
+//**************************************************************
+//  The chunk tables of the harmonics and the distributions alive
+//  on this rank, whose harmonics are placed by those tables
+//--------------------------------------------------------------
+static map<size_t, valarray<size_t> > chunk_tables;
+static set<DistFunc1D*> live_1D;
+static set<DistFunc2D*> live_2D;
+//--------------------------------------------------------------
+valarray<size_t> harmonic_chunks(size_t num_harmonics){
+    map<size_t, valarray<size_t> >::const_iterator table(chunk_tables.find(num_harmonics));
+    if (table != chunk_tables.end()) return table->second;
+
+    valarray<size_t> f_start(Input::List().ompthreads), f_end(Input::List().ompthreads);
+    Harmonic_Group::Chunks(1, num_harmonics, f_start, f_end);
+    return f_start;
+}
+//--------------------------------------------------------------
+void harmonic_chunks(size_t num_harmonics, const valarray<size_t>& f_start){
+    chunk_tables[num_harmonics].resize(f_start.size());
+    chunk_tables[num_harmonics] = f_start;
+}
+//--------------------------------------------------------------
+//  The gap of 2 after a chunk is done by the same thread, the
+//  harmonics before and after the share by the first and the last
+//--------------------------------------------------------------
+size_t harmonic_thread(size_t id, const valarray<size_t>& f_start, size_t num_threads){
+    size_t t(f_start.size() - 1);
+    while (t > 0 && id < f_start[t]) --t;
+    return std::min(t, num_threads - 1);
+}
+//--------------------------------------------------------------
+void live_harmonics(size_t num_harmonics, vector<valarray<complex<double> >*>& arrays, vector<size_t>& ids){
+    for (set<DistFunc1D*>::const_iterator d(live_1D.begin()); d != live_1D.end(); ++d) {
+        if ((*d)->dim() != num_harmonics) continue;
+        for (size_t i(0); i < num_harmonics; ++i) {
+            arrays.push_back(&((**d)(i).array().array()));
+            ids.push_back(i);
+        }
+    }
+    for (set<DistFunc2D*>::const_iterator d(live_2D.begin()); d != live_2D.end(); ++d) {
+        if ((*d)->dim() != num_harmonics) continue;
+        for (size_t i(0); i < num_harmonics; ++i) {
+            arrays.push_back(&((**d)(i).array().array()));
+            ids.push_back(i);
+        }
+    }
+}
 //**************************************************************
 //  Definition of the 1D distribution function
 //--------------------------------------------------------------
@@ -830,7 +893,20 @@ DistFunc1D:: DistFunc1D(size_t l, size_t m,
 
 //      Generate container for the harmonics
     // sz = ((mmax+1)*(2*lmax-mmax+2))/2;
-    df = new vector<SHarmonic1D>(sz,SHarmonic1D(_dp.size(),nx));
+    df = new vector<SHarmonic1D>(sz,SHarmonic1D(0,0));
+    #pragma omp critical (live_distributions)
+    live_1D.insert(this);
+
+//      Each harmonic is allocated by the thread that advances it, so that
+//      its pages are first touched on the socket of that thread
+    const valarray<size_t> chunks(harmonic_chunks(sz));
+    #pragma omp parallel num_threads(Input::List().ompthreads)
+    {
+        for (size_t i(0); i < sz; ++i) {
+            if (harmonic_thread(i, chunks, omp_get_num_threads()) == size_t(omp_get_thread_num()))
+                (*df)[i].allocate(_dp.size(),nx);
+        }
+    }
     
 //      Define the index for the triangular array 
     ind = -1;
@@ -868,11 +944,20 @@ DistFunc1D:: DistFunc1D(const DistFunc1D& other)
 
 //      Generate container for the harmonics
     // sz = ((mmax+1)*(2*lmax-mmax+2))/2;
-    df = new vector<SHarmonic1D>(sz,SHarmonic1D(other(0).nump(),other(0).numx()));
-    
+    df = new vector<SHarmonic1D>(sz,SHarmonic1D(0,0));
+    #pragma omp critical (live_distributions)
+    live_1D.insert(this);
 
-    for(size_t i(0); i < sz ; ++i){
-        (*df).push_back(other(i));
+//      Allocated and copied by the thread that advances each harmonic
+    const valarray<size_t> chunks(harmonic_chunks(sz));
+    #pragma omp parallel num_threads(Input::List().ompthreads)
+    {
+        for (size_t i(0); i < sz; ++i) {
+            if (harmonic_thread(i, chunks, omp_get_num_threads()) == size_t(omp_get_thread_num())) {
+                (*df)[i].allocate(other(i).nump(),other(i).numx());
+                (*df)[i] = other(i);
+            }
+        }
     }
 
      // Define the index for the triangular array 
@@ -903,6 +988,8 @@ DistFunc1D:: DistFunc1D(const DistFunc1D& other)
 
 //  Destructor
 DistFunc1D:: ~DistFunc1D(){
+    #pragma omp critical (live_distributions)
+    live_1D.erase(this);
     delete df;
 }
 //--------------------------------------------------------------
@@ -1353,7 +1440,20 @@ void DistFunc1D::checknan(){
 
         // sz = ((mmax+1)*(2*lmax-mmax+2))/2;
         //      Generate container for the harmonics
-        df = new vector<SHarmonic2D>(sz,SHarmonic2D(_dp.size(),nx,ny)); 
+        df = new vector<SHarmonic2D>(sz,SHarmonic2D(0,0,0));
+        #pragma omp critical (live_distributions)
+        live_2D.insert(this);
+
+//      Each harmonic is allocated by the thread that advances it, so that
+//      its pages are first touched on the socket of that thread
+        const valarray<size_t> chunks(harmonic_chunks(sz));
+        #pragma omp parallel num_threads(Input::List().ompthreads)
+        {
+            for (size_t i(0); i < sz; ++i) {
+                if (harmonic_thread(i, chunks, omp_get_num_threads()) == size_t(omp_get_thread_num()))
+                    (*df)[i].allocate(_dp.size(),nx,ny);
+            }
+        }
         
 //      Define the index for the triangular array 
         ind = -1;
@@ -1391,11 +1491,20 @@ void DistFunc1D::checknan(){
         // sz = ((mmax+1)*(2*lmax-mmax+2))/2;
 
 //      Generate container for the harmonics
-        df = new vector<SHarmonic2D>(sz,SHarmonic2D(other(0).nump(),other(0).numx(),other(0).numy()));
+        df = new vector<SHarmonic2D>(sz,SHarmonic2D(0,0,0));
+        #pragma omp critical (live_distributions)
+        live_2D.insert(this);
 
-
-         for(size_t i(0); i < sz ; ++i){  
-            (*df).push_back(other(i));
+//      Allocated and copied by the thread that advances each harmonic
+        const valarray<size_t> chunks(harmonic_chunks(sz));
+        #pragma omp parallel num_threads(Input::List().ompthreads)
+        {
+            for (size_t i(0); i < sz; ++i) {
+                if (harmonic_thread(i, chunks, omp_get_num_threads()) == size_t(omp_get_thread_num())) {
+                    (*df)[i].allocate(other(i).nump(),other(i).numx(),other(i).numy());
+                    (*df)[i] = other(i);
+                }
+            }
         }
 
         //      Define the index for the triangular array 
@@ -1424,6 +1533,8 @@ void DistFunc1D::checknan(){
 
 //  Destructor
     DistFunc2D:: ~DistFunc2D(){
+        #pragma omp critical (live_distributions)
+        live_2D.erase(this);
         delete df;
     }
 //--------------------------------------------------------------
@@ -49,6 +49,9 @@ public:
     SHarmonic1D(const SHarmonic1D& other);
     ~SHarmonic1D();
 
+///     Replace the storage with zeroed storage, first touched by the calling thread
+    void allocate(size_t nump, size_t numx);
+
 ///     To retrieve the the array that stores the information
     Array2D<complex<double> >& array() const {return (*sh);}
     size_t dim()  const {return (*sh).dim();} //< Total number of values in the array
@@ -113,6 +116,9 @@ public:
         SHarmonic2D(const SHarmonic2D& other);
         ~SHarmonic2D();
 
+//      Replace the storage with zeroed storage, first touched by the calling thread
+        void allocate(size_t nump, size_t numx, size_t numy);
+
 //      Basic information
         Array3D < complex <double> >& array() const {return (*sh);}
         size_t dim()  const {return (*sh).dim();}
@@ -359,6 +365,19 @@ public:
  *   a DistFunc object, this class also contains information about the l_max, num_p, p_max, charge, and mass.
  *   
 */
+//  The chunk table of the harmonics, the first harmonic of each OpenMP
+//  thread in spatial advection. It starts as the cut of the share of
+//  this rank (Harmonic_Group::Chunks) and follows the re-cuts its
+//  Chunk_Balance settles on, for the distributions of num_harmonics
+valarray<size_t> harmonic_chunks(size_t num_harmonics);
+void harmonic_chunks(size_t num_harmonics, const valarray<size_t>& f_start);
+//  The OpenMP thread that advances harmonic id in that table; the
+//  storage of the harmonic is allocated by that thread
+size_t harmonic_thread(size_t id, const valarray<size_t>& f_start, size_t num_threads);
+//  The storage of the harmonics of the distributions of num_harmonics
+//  alive on this rank, with the index of each harmonic
+void live_harmonics(size_t num_harmonics, vector<valarray<complex<double> >*>& arrays, vector<size_t>& ids);
+//-------------------------------------------------------------------
 class DistFunc1D {
 //-------------------------------------------------------------------    	
 private:
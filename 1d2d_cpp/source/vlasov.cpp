@@ -17,6 +17,7 @@
 #include <math.h>
 #include <map>
 #include <omp.h>
+#include <mpi.h>
 
 //  My libraries
 #include "lib-array.h"
@@ -29,6 +30,7 @@
 #include "input.h"
 #include "fluid.h"
 #include "vlasov.h"
+#include "parallel.h"
 
 //**************************************************************
 //--------------------------------------------------------------
@@ -85,6 +87,225 @@ void Current::es1d(const DistFunc1D& Din, Field1D& Exh) {
 //**************************************************************
 //**************************************************************
 
+//**************************************************************
+//--------------------------------------------------------------
+//  Harmonic chunks of the OpenMP threads
+//--------------------------------------------------------------
+//  In a harmonic group the chunks (Harmonic_Group::Chunks) cover
+//  the share of this rank. The terms the first and the last thread
+//  take outside of the chunks belong to the first and the last share
+static bool first_share() {return Harmonic_Group::Rank() == 0;}
+static bool last_share()  {return Harmonic_Group::Rank() + 1 == Harmonic_Group::Size();}
+//--------------------------------------------------------------
+//  The terms the first thread takes outside of the chunks reach
+//  the chunks of the others in a group, or when one thread has
+//  the whole share
+static bool first_reach(const valarray<size_t>& f_start, const valarray<size_t>& f_end) {
+    return Harmonic_Group::Size() > 1 || f_start[0] == f_end[0];
+}
+//--------------------------------------------------------------
+//  The harmonics of the share of this rank in the order a sweep
+//  runs through them, and those the first and the last share take
+//  outside of the chunks, for the exchanges of the group
+static void evaluates(const size_t Nl, const size_t Nm, const size_t first,
+                      const valarray<size_t>& il, const valarray<size_t>& im) {
+    size_t h0, h1;
+    Harmonic_Group::Share(first, il.size(), h0, h1);
+    for (size_t id(h0); id < h1; ++id) Harmonic_Group::Evaluates(Nl, Nm, il[id], im[id]);
+
+    if (first_share()) {
+        Harmonic_Group::Evaluates(Nl, Nm, 0, 0);
+        Harmonic_Group::Evaluates(Nl, Nm, 1, 0);
+        for (size_t l(1); l < Nl+1 && Nm > 0; ++l) Harmonic_Group::Evaluates(Nl, Nm, l, 1);
+    }
+    if (last_share()) Harmonic_Group::Evaluates(Nl, Nm, Nl, 0);
+}
+//--------------------------------------------------------------
+//  Calls per timing round and the number of rounds to re-cut in
+static const size_t balance_window(4), balance_rounds(4);
+//--------------------------------------------------------------
+Chunk_Balance::Chunk_Balance(string _name, size_t Nl, size_t Nm, size_t _first, bool _places)
+//--------------------------------------------------------------
+//  Constructor
+//--------------------------------------------------------------
+:   name(_name), l0(Nl), m0(Nm),
+    calls(0), rounds(0),
+    timing(Input::List().ompthreads > 1),
+    places(_places), placed_at(0),
+    rank(0),
+    entered(0.0,Input::List().ompthreads), waited(0.0,Input::List().ompthreads),
+    busy(0.0,Input::List().ompthreads), idle(0.0,Input::List().ompthreads),
+    idle_first(0.0,Input::List().ompthreads), idle_best(0.0,Input::List().ompthreads),
+    wall_best(-1.0),
+    start_best(Input::List().ompthreads), end_best(Input::List().ompthreads)
+{
+    Harmonic_Group::Share(_first, ((Nm+1)*(2*Nl-Nm+2))/2, first, last);
+    recuttable = (last >= first + 4*Input::List().ompthreads);
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+}
+//--------------------------------------------------------------
+void Chunk_Balance::enter() {
+//--------------------------------------------------------------
+//  Start the clock of this thread for one call
+//--------------------------------------------------------------
+    if (!timing) return;
+
+    size_t this_thread(omp_get_thread_num());
+    entered[this_thread] = omp_get_wtime();
+    waited[this_thread]  = 0.0;
+}
+//--------------------------------------------------------------
+void Chunk_Balance::barrier() {
+//--------------------------------------------------------------
+//  Barrier of the team, the wait is idle time of this thread
+//--------------------------------------------------------------
+    if (!timing) {
+        #pragma omp barrier
+        return;
+    }
+
+    size_t this_thread(omp_get_thread_num());
+    double arrived(omp_get_wtime());
+    #pragma omp barrier
+    waited[this_thread] += omp_get_wtime() - arrived;
+}
+//--------------------------------------------------------------
+void Chunk_Balance::leave(valarray<size_t>& f_start, valarray<size_t>& f_end) {
+//--------------------------------------------------------------
+//  Final barrier of a call, closes a round every few calls
+//--------------------------------------------------------------
+    barrier();
+    if (!timing) return;
+
+    size_t this_thread(omp_get_thread_num());
+    double wall(omp_get_wtime() - entered[this_thread]);
+    busy[this_thread] += wall - waited[this_thread];
+    idle[this_thread] += waited[this_thread];
+
+    //  Every thread has booked its time before the round is closed,
+    //  and the new chunks are seen by all at the end of the single
+    #pragma omp barrier
+    #pragma omp single
+    {
+        ++calls;
+        if (calls % balance_window == 0) round(f_start, f_end);
+    }
+    if (calls == placed_at) Place_harmonics(((m0+1)*(2*l0-m0+2))/2);
+}
+//--------------------------------------------------------------
+void Chunk_Balance::round(valarray<size_t>& f_start, valarray<size_t>& f_end) {
+//--------------------------------------------------------------
+//  Keep the fastest chunks so far, then re-cut or stop timing
+//--------------------------------------------------------------
+    size_t num_threads(busy.size());
+    valarray<double> fraction(0.0,num_threads);
+    double wall(0.0);
+
+    for (size_t k(0); k < num_threads; ++k) {
+        double spent(busy[k] + idle[k]);
+        if (spent > 0.0) fraction[k] = idle[k] / spent;
+        wall = max(wall, spent);
+    }
+
+    if (rounds == 0) idle_first = fraction;
+    if (wall_best < 0.0 || wall < wall_best) {
+        wall_best  = wall;
+        idle_best  = fraction;
+        start_best = f_start;
+        end_best   = f_end;
+    }
+    ++rounds;
+
+    if (Input::List().ompbalance && recuttable && rounds < balance_rounds) {
+        recut(f_start, f_end);
+    }
+    else {
+        f_start = start_best;
+        f_end   = end_best;
+        timing  = false;
+        report();
+        if (places) place(f_start);
+    }
+
+    busy = 0.0;
+    idle = 0.0;
+}
+//--------------------------------------------------------------
+void Chunk_Balance::recut(valarray<size_t>& f_start, valarray<size_t>& f_end) const {
+//--------------------------------------------------------------
+//  Spread the busy time of each thread evenly over its region
+//  [f_start[k], f_start[k+1]) and cut the total into equal shares.
+//  A region keeps a chunk of 2 and the boundary gap of 2.
+//--------------------------------------------------------------
+    size_t num_threads(f_start.size());
+    double total(busy.sum());
+    if (!(total > 0.0)) return;
+
+    valarray<size_t> region(num_threads+1);
+    for (size_t k(0); k < num_threads; ++k) region[k] = f_start[k];
+    region[num_threads] = last;
+
+    size_t k(0);
+    double below(0.0);
+    for (size_t t(1); t < num_threads; ++t) {
+        double share(total * static_cast<double>(t) / static_cast<double>(num_threads));
+        while (k + 1 < num_threads && below + busy[k] < share) {
+            below += busy[k];
+            ++k;
+        }
+
+        double cut(static_cast<double>(region[k]));
+        if (busy[k] > 0.0) cut += (share - below) / busy[k] * static_cast<double>(region[k+1] - region[k]);
+
+        size_t start(static_cast<size_t>(cut + 0.5));
+        start = max(start, f_start[t-1] + 4);
+        start = min(start, last - 4*(num_threads - t));
+
+        f_start[t] = start;
+        f_end[t-1] = start - 2;
+    }
+    f_end[num_threads-1] = last;
+}
+//--------------------------------------------------------------
+void Chunk_Balance::place(const valarray<size_t>& f_start) {
+//--------------------------------------------------------------
+//  The chunks kept become the chunk table of the harmonics, and
+//  the team moves them to their new threads after this call
+//--------------------------------------------------------------
+    size_t num_harmonics(((m0+1)*(2*l0-m0+2))/2);
+    valarray<size_t> table(harmonic_chunks(num_harmonics));
+
+    bool same(table.size() == f_start.size());
+    for (size_t k(0); same && k < table.size(); ++k) same = (table[k] == f_start[k]);
+    if (same) return;
+
+    harmonic_chunks(num_harmonics, f_start);
+    placed_at = calls;
+}
+//--------------------------------------------------------------
+void Chunk_Balance::report() const {
+//--------------------------------------------------------------
+    if (rank != 0) return;
+
+    std::cout << " OpenMP idle per thread in " << name
+              << " (l0 = " << l0 << ", m0 = " << m0 << ") [%]:";
+    for (size_t k(0); k < idle_first.size(); ++k) {
+        std::cout << " " << static_cast<size_t>(100.0 * idle_first[k] + 0.5);
+    }
+    if (rounds > 1) {
+        std::cout << " ->";
+        for (size_t k(0); k < idle_best.size(); ++k) {
+            std::cout << " " << static_cast<size_t>(100.0 * idle_best[k] + 0.5);
+        }
+        std::cout << ", chunks start at";
+        for (size_t k(0); k < start_best.size(); ++k) std::cout << " " << start_best[k];
+    }
+    std::cout << "\n";
+}
+//--------------------------------------------------------------
+//**************************************************************
+
 //**************************************************************
 //--------------------------------------------------------------
 Electric_Field::Electric_Field(size_t Nl, size_t Nm, valarray<double> dp)
@@ -104,6 +325,7 @@ Electric_Field::Electric_Field(size_t Nl, size_t Nm, valarray<double> dp)
       dp.size())),
     invpr(pr),
     f_start(Input::List().ompthreads),f_end(Input::List().ompthreads),
+    balance("Electric_Field",Nl,Nm,1,false),
     dist_il((Nm+1)*(2*Nl-Nm+2)/2),dist_im((Nm+1)*(2*Nl-Nm+2)/2),
     nwsediag_il((Nm+1)*(2*Nl-Nm+2)/2),nwsediag_im((Nm+1)*(2*Nl-Nm+2)/2),
     neswdiag_il((Nm+1)*(2*Nl-Nm+2)/2),neswdiag_im((Nm+1)*(2*Nl-Nm+2)/2)
@@ -225,41 +447,8 @@ Electric_Field::Electric_Field(size_t Nl, size_t Nm, valarray<double> dp)
 // ----- // ----- // ----- // ----- // ----- // ----- // ----- // ----- 
 // ----- // ----- // ----- // ----- // ----- // ----- // ----- // ----- 
     // OpenMP stuff
-        size_t num_threads = Input::List().ompthreads;
         size_t num_dists = (((Nm+1)*(2*Nl-Nm+2))/2);
-        size_t fsperthread = static_cast<size_t>(num_dists/num_threads - 2);
-
-        if (num_threads > 272 || num_threads < 1) num_threads = 1;
-
-    // // std::cout << "\n numthreads = " << num_threads << "\n\n";    
-    //     size_t lsperthread = static_cast<size_t>(Nl/num_threads - 2);
-        
-        if (num_threads > 1) 
-        {    
-            f_start[0] = 1;
-            f_end[0]   = fsperthread - 2;           // Remember that f_end isn't actually processed
-                                                // until the boundaries so that a gap of 2 is 
-                                                // actually a gap of 3
-
-        // if (num_threads > 1) std::cout << "\nls[" << 0 << "]=" << f_start[0] << "\n\n";
-        // if (num_threads > 1) std::cout << "le[" << 0 << "]=" << f_end[0] << "\n\n";
-
-        for (size_t i(1); i<num_threads-1; ++i)
-        {        
-            f_start[i] = f_end[i-1] + 2;
-            f_end[i]   = f_start[i] + fsperthread;
-            // if (num_threads > 1)    std::cout << "\nls[" << i << "]=" << f_start[i] << "\n\n";
-            // if (num_threads > 1)    std::cout << "le[" << i << "]=" << f_end[i] << "\n\n";
-        }
-
-        f_start[num_threads-1] = f_end[num_threads-2] + 2;
-        f_end[num_threads-1]   = num_dists; 
-    }
-    else
-    {
-        f_start[0] = 1;
-        f_end[0]   = num_dists; 
-    }
+        Harmonic_Group::Chunks(1, num_dists, f_start, f_end);
 
     
 
@@ -350,6 +539,9 @@ Electric_Field::Electric_Field(size_t Nl, size_t Nm, valarray<double> dp)
 // ----- // ----- // ----- // ----- // ----- // ----- // ----- // ----- 
 // ----- // ----- // ----- // ----- // ----- // ----- // ----- // ----- 
 // ----- // ----- // ----- // ----- // ----- // ----- // ----- // -----     
+    evaluates(Nl, Nm, 1, dist_il, dist_im);
+    evaluates(Nl, Nm, 1, nwsediag_il, nwsediag_im);
+    evaluates(Nl, Nm, 1, neswdiag_il, neswdiag_im);
 }
 //--------------------------------------------------------------
 
@@ -361,6 +553,14 @@ void Electric_Field::operator()(const DistFunc1D& Din,
 //  This is the core calculation for the electric field
 //--------------------------------------------------------------
 
+    //  Outside of a functor's team: open one for this call only
+    if (omp_get_level() == 0) {
+        #pragma omp parallel num_threads(Input::List().ompthreads)
+        (*this)(Din,FEx,FEy,FEz,Dh);
+        return;
+    }
+    balance.enter();
+
 //     complex<double> ii(0.0,1.0);
 
 //     valarray<complex<double> > Ex(FEx.array());
@@ -551,7 +751,6 @@ void Electric_Field::operator()(const DistFunc1D& Din,
     //   The parallelization is performed in chunks and boundaries
     //   are taken care of later
     //  -------------------------------------------------------- //
-    #pragma omp parallel num_threads(Input::List().ompthreads)
     {   
         /// Determine which chunk to do
         size_t this_thread  = omp_get_thread_num();
@@ -581,7 +780,7 @@ void Electric_Field::operator()(const DistFunc1D& Din,
         size_t l(0),m(0);
 
 
-        if (this_thread == 0)
+        if (this_thread == 0 && first_share())
         {
             // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
             //      m = 0, l = 0
@@ -607,6 +806,9 @@ void Electric_Field::operator()(const DistFunc1D& Din,
 
             
         }
+        //  In a group, or with the whole share on one thread, another
+        //  chunk may start within reach of the harmonics written above
+        if (first_reach(f_start, f_end)) balance.barrier();
         // std::cout << "\n Checkpoint #1 \n";   Dh.checknan();
         
 
@@ -644,7 +846,7 @@ void Electric_Field::operator()(const DistFunc1D& Din,
 
         // std::cout << "\n Checkpoint #2 \n";   Dh.checknan();
         
-        #pragma omp barrier
+        balance.barrier();
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         //      Diagonal loop, f_start < l < f_end
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -677,7 +879,7 @@ void Electric_Field::operator()(const DistFunc1D& Din,
 
         // std::cout << "\n Checkpoint #3 \n";   Dh.checknan();        
         
-        #pragma omp barrier
+        balance.barrier();
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         //      Anti-Diagonal loop, f_start < l < f_end
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -719,7 +921,7 @@ void Electric_Field::operator()(const DistFunc1D& Din,
     //  -------------------------------------------------------- //
     //  Do the boundaries between the chunks
     //  -------------------------------------------------------- //
-    #pragma omp parallel num_threads(f_start.size()-1)
+    balance.barrier();
     // for (size_t threadboundaries = 0; threadboundaries < f_start.size()-1; ++threadboundaries)
     {  
         /// Determine which chunk to do
@@ -747,87 +949,93 @@ void Electric_Field::operator()(const DistFunc1D& Din,
 
         size_t l(0),m(0);
 
-        if (this_thread < f_start.size() - 1) 
+        /// The last thread has no boundary above its chunk
+        size_t b_start(0), b_end(0);
+        if (this_thread + 1 < f_start.size())
         {
-            // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-            //      Vertical loop, boundaries between threads
-            // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-            for (size_t id = f_end[this_thread]; id < f_start[this_thread+1]; ++id)
-            {
+            b_start = f_end[this_thread];
+            b_end   = f_start[this_thread+1];
+        }
 
-                l = dist_il[id];
-                m = dist_im[id];
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        //      Vertical loop, boundaries between threads
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        for (size_t id = b_start; id < b_end; ++id)
+        {
 
-                MakeGH(Din(l,m),G,H,l);
+            l = dist_il[id];
+            m = dist_im[id];
 
-                if (l == m)         // Diagonal, no l - 1
-                {
-                    if (l < l0) {   Ex *= A1(l,0);   Dh(l+1,0) += G.mxaxis(Ex);     Ex *= 1.0 / A1(l,0);}
-                }
-                else if (l == l0)   // Last l, no l + 1
-                {
-                                    Ex *= A2(l,0);  Dh(l-1,0) += H.mxaxis(Ex);      Ex *= 1.0 / A2(l,0);
-                }
-                else
-                {
-                                    Ex *= A2(l,0);              Dh(l-1,0) += H.mxaxis(Ex);
-                                    Ex *= A1(l,0) / A2(l,0);    Dh(l+1,0) += G.mxaxis(Ex);  Ex *= 1.0 / A1(l,0);
-                }
-            }
+            MakeGH(Din(l,m),G,H,l);
 
-            #pragma omp barrier
-            /// -------------------------------------------------------------------------------------- ///
-            /// Diagonal
-            /// -------------------------------------------------------------------------------------- ///
-            for (size_t id = f_end[this_thread]; id < f_start[this_thread+1]; ++id)
+            if (l == m)         // Diagonal, no l - 1
+            {
+                if (l < l0) {   Ex *= A1(l,0);   Dh(l+1,0) += G.mxaxis(Ex);     Ex *= 1.0 / A1(l,0);}
+            }
+            else if (l == l0)   // Last l, no l + 1
+            {
+                                Ex *= A2(l,0);  Dh(l-1,0) += H.mxaxis(Ex);      Ex *= 1.0 / A2(l,0);
+            }
+            else
             {
-                l = nwsediag_il[id];
-                m = nwsediag_im[id];
+                                Ex *= A2(l,0);              Dh(l-1,0) += H.mxaxis(Ex);
+                                Ex *= A1(l,0) / A2(l,0);    Dh(l+1,0) += G.mxaxis(Ex);  Ex *= 1.0 / A1(l,0);
+            }
+        }
 
-                MakeGH(Din(l,m),G,H,l);
+        balance.barrier();
+        /// -------------------------------------------------------------------------------------- ///
+        /// Diagonal
+        /// -------------------------------------------------------------------------------------- ///
+        for (size_t id = b_start; id < b_end; ++id)
+        {
+            l = nwsediag_il[id];
+            m = nwsediag_im[id];
 
-                if (m == 0)         // Top or Left, no l - 1, m - 1
-                {
-                                    Em *= C1[m];    Dh(l+1,m+1) += G.mxaxis(Em);        Em *= 1.0/C1[m];
-                }
-                else if (m == m0 || l == l0)   // Bottom or right, no l + 1, m + 1
-                {
-                                    Ep *= C4(l,m);  Dh(l-1,m-1) += H.mxaxis(Ep);        Ep *= 1.0/C4(l,m);
-                }
-                else
-                {
-                                    Em *= C1[m];    Dh(l+1,m+1) += G.mxaxis(Em);        Em *= 1.0/C1[m];
-                    if (m > 1)  {   Ep *= C4(l,m);  Dh(l-1,m-1) += H.mxaxis(Ep);        Ep *= 1.0/C4(l,m);}
-                }
-            }
+            MakeGH(Din(l,m),G,H,l);
 
-            #pragma omp barrier
-            /// -------------------------------------------------------------------------------------- ///
-            /// Anti-Diagonal
-            /// -------------------------------------------------------------------------------------- ///
-            for (size_t id = f_end[this_thread]; id < f_start[this_thread+1]; ++id)
+            if (m == 0)         // Top or Left, no l - 1, m - 1
+            {
+                                Em *= C1[m];    Dh(l+1,m+1) += G.mxaxis(Em);        Em *= 1.0/C1[m];
+            }
+            else if (m == m0 || l == l0)   // Bottom or right, no l + 1, m + 1
+            {
+                                Ep *= C4(l,m);  Dh(l-1,m-1) += H.mxaxis(Ep);        Ep *= 1.0/C4(l,m);
+            }
+            else
             {
-                l = neswdiag_il[id];
-                m = neswdiag_im[id];
+                                Em *= C1[m];    Dh(l+1,m+1) += G.mxaxis(Em);        Em *= 1.0/C1[m];
+                if (m > 1)  {   Ep *= C4(l,m);  Dh(l-1,m-1) += H.mxaxis(Ep);        Ep *= 1.0/C4(l,m);}
+            }
+        }
+
+        balance.barrier();
+        /// -------------------------------------------------------------------------------------- ///
+        /// Anti-Diagonal
+        /// -------------------------------------------------------------------------------------- ///
+        for (size_t id = b_start; id < b_end; ++id)
+        {
+            l = neswdiag_il[id];
+            m = neswdiag_im[id];
 
-                MakeGH(Din(l,m),G,H,l);
+            MakeGH(Din(l,m),G,H,l);
 
-                if (m == 0)         // Left wall, no l + 1, m - 1
-                {
-                    if (l > 1)                  {   Em *= C3[l];    Dh(l-1,1) += H.mxaxis(Em);        Em *= 1.0/C3[l];}
-                }
-                else if (m == m0)   // Right boundary, no l - 1, m + 1
-                {
-                    if (l < l0)                 {   Ep *= C2(l,m0);  Dh(l+1,m0-1) += G.mxaxis(Ep);        Ep *= 1.0/C2(l,m0);}
-                }
-                else
-                {
-                    if (m > 1 && l < l0)        {   Ep *= C2(l,m);  Dh(l+1,m-1) += G.mxaxis(Ep);        Ep *= 1.0/C2(l,m);}
-                    if (l - 1 != m && l != m)   {   Em *= C3[l];    Dh(l-1,m+1) += H.mxaxis(Em);        Em *= 1.0/C3[l];}
-                }
+            if (m == 0)         // Left wall, no l + 1, m - 1
+            {
+                if (l > 1)                  {   Em *= C3[l];    Dh(l-1,1) += H.mxaxis(Em);        Em *= 1.0/C3[l];}
+            }
+            else if (m == m0)   // Right boundary, no l - 1, m + 1
+            {
+                if (l < l0)                 {   Ep *= C2(l,m0);  Dh(l+1,m0-1) += G.mxaxis(Ep);        Ep *= 1.0/C2(l,m0);}
+            }
+            else
+            {
+                if (m > 1 && l < l0)        {   Ep *= C2(l,m);  Dh(l+1,m-1) += G.mxaxis(Ep);        Ep *= 1.0/C2(l,m);}
+                if (l - 1 != m && l != m)   {   Em *= C3[l];    Dh(l-1,m+1) += H.mxaxis(Em);        Em *= 1.0/C3[l];}
             }
         }
     }
+    balance.leave(f_start, f_end);
 
 }
 //--------------------------------------------------------------
@@ -839,12 +1047,19 @@ void Electric_Field::es1d(const DistFunc1D& Din,
 //  This is the core calculation for the electric field
 //--------------------------------------------------------------
 
+    //  Outside of a functor's team: open one for this call only
+    if (omp_get_level() == 0) {
+        #pragma omp parallel num_threads(Input::List().ompthreads)
+        es1d(Din,FEx,Dh);
+        return;
+    }
+    balance.enter();
+
     //  -------------------------------------------------------- //
     //   Because each iteration in the loop modifies + and - 1
     //   The parallelization is performed in chunks and boundaries
     //   are taken care of later
     //  -------------------------------------------------------- //
-    #pragma omp parallel num_threads(Input::List().ompthreads)
     {   
         /// Determine which chunk to do
         size_t this_thread  = omp_get_thread_num();
@@ -863,7 +1078,7 @@ void Electric_Field::es1d(const DistFunc1D& Din,
         //   Last thread takes the boundary condition (l = l0)
         //   Rest of the threads proceed to chunks
         //  -------------------------------------------------------- //
-        if (this_thread==0)
+        if (this_thread==0 && first_share())
         {       
             // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
             //      m = 0, l = 0
@@ -872,7 +1087,7 @@ void Electric_Field::es1d(const DistFunc1D& Din,
             Ex *= A1(0,0);  Dh(1,0) += G.mxaxis(Ex);
         }
 
-        if (this_thread==Input::List().ompthreads - 1)
+        if (this_thread==Input::List().ompthreads - 1 && last_share())
         {                       
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         //      m = 0,  l = l0
@@ -884,6 +1099,9 @@ void Electric_Field::es1d(const DistFunc1D& Din,
                                         // 
             f_end_thread -= 1;
         }
+        //  In a group, or with the whole share on one thread, another
+        //  chunk may start within reach of the harmonics written above
+        if (first_reach(f_start, f_end)) balance.barrier();
 
         //  -------------------------------------------------------- //
         //  Do the chunks
@@ -906,7 +1124,8 @@ void Electric_Field::es1d(const DistFunc1D& Din,
     //  -------------------------------------------------------- //
     //  Do the boundaries between the chunks
     //  -------------------------------------------------------- //
-    #pragma omp parallel for num_threads(f_start.size()-1)
+    balance.barrier();
+    #pragma omp for nowait
     for (size_t threadboundaries = 0; threadboundaries < f_start.size()-1; ++threadboundaries)
     {    
         SHarmonic1D G(pr.size(),FEx.numx()),H(pr.size(),FEx.numx());
@@ -924,6 +1143,7 @@ void Electric_Field::es1d(const DistFunc1D& Din,
             Ex *= A1(l,0) / A2(l,0);       Dh(l+1,0) += G.mxaxis(Ex);
         }
     }
+    balance.leave(f_start, f_end);
 
 
     }
@@ -1393,6 +1613,14 @@ void Electric_Field::operator()(const DistFunc2D& Din,
 //  This is the core calculation for the electric field
 //--------------------------------------------------------------
 
+    //  Outside of a functor's team: open one for this call only
+    if (omp_get_level() == 0) {
+        #pragma omp parallel num_threads(Input::List().ompthreads)
+        (*this)(Din,FEx,FEy,FEz,Dh);
+        return;
+    }
+    balance.enter();
+
 //     complex<double> ii(0.0,1.0);
 
 //     Array2D<complex<double> > Ex(FEx.array());
@@ -1586,7 +1814,6 @@ void Electric_Field::operator()(const DistFunc2D& Din,
     //   The parallelization is performed in chunks and boundaries
     //   are taken care of later
     //  -------------------------------------------------------- //
-    #pragma omp parallel num_threads(Input::List().ompthreads)
     {   
         /// Determine which chunk to do
         size_t this_thread  = omp_get_thread_num();
@@ -1616,7 +1843,7 @@ void Electric_Field::operator()(const DistFunc2D& Din,
         size_t l(0),m(0);
 
 
-        if (this_thread == 0)
+        if (this_thread == 0 && first_share())
         {
             // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
             //      m = 0, l = 0
@@ -1642,6 +1869,9 @@ void Electric_Field::operator()(const DistFunc2D& Din,
 
             
         }
+        //  In a group, or with the whole share on one thread, another
+        //  chunk may start within reach of the harmonics written above
+        if (first_reach(f_start, f_end)) balance.barrier();
         // std::cout << "\n Checkpoint #1 \n";   Dh.checknan();
         
 
@@ -1679,7 +1909,7 @@ void Electric_Field::operator()(const DistFunc2D& Din,
 
         // std::cout << "\n Checkpoint #2 \n";   Dh.checknan();
         
-        #pragma omp barrier
+        balance.barrier();
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         //      Diagonal loop, f_start < l < f_end
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1712,7 +1942,7 @@ void Electric_Field::operator()(const DistFunc2D& Din,
 
         // std::cout << "\n Checkpoint #3 \n";   Dh.checknan();        
         
-        #pragma omp barrier
+        balance.barrier();
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         //      Anti-Diagonal loop, f_start < l < f_end
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1752,7 +1982,7 @@ void Electric_Field::operator()(const DistFunc2D& Din,
     //  -------------------------------------------------------- //
     //  Do the boundaries between the chunks
     //  -------------------------------------------------------- //
-    #pragma omp parallel num_threads(f_start.size()-1)
+    balance.barrier();
     // for (size_t threadboundaries = 0; threadboundaries < f_start.size()-1; ++threadboundaries)
     {  
         /// Determine which chunk to do
@@ -1780,87 +2010,93 @@ void Electric_Field::operator()(const DistFunc2D& Din,
 
         size_t l(0),m(0);
 
-        if (this_thread < f_start.size() - 1) 
+        /// The last thread has no boundary above its chunk
+        size_t b_start(0), b_end(0);
+        if (this_thread + 1 < f_start.size())
+        {
+            b_start = f_end[this_thread];
+            b_end   = f_start[this_thread+1];
+        }
+
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        //      Vertical loop, boundaries between threads
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        for (size_t id = b_start; id < b_end; ++id)
         {
-            // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-            //      Vertical loop, boundaries between threads
-            // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-            for (size_t id = f_end[this_thread]; id < f_start[this_thread+1]; ++id)
-            {
 
-                l = dist_il[id];
-                m = dist_im[id];
+            l = dist_il[id];
+            m = dist_im[id];
 
-                MakeGH(Din(l,m),G,H,l);
+            MakeGH(Din(l,m),G,H,l);
 
-                if (l == m)         // Diagonal, no l - 1
-                {
-                    if (l < l0) {   Ex *= A1(l,0);   Dh(l+1,0) += G.mxy_matrix(Ex);     Ex *= 1.0 / A1(l,0);}
-                }
-                else if (l == l0)   // Last l, no l + 1
-                {
-                                    Ex *= A2(l,0);  Dh(l-1,0) += H.mxy_matrix(Ex);      Ex *= 1.0 / A2(l,0);
-                }
-                else
-                {
-                                    Ex *= A2(l,0);              Dh(l-1,0) += H.mxy_matrix(Ex);
-                                    Ex *= A1(l,0) / A2(l,0);    Dh(l+1,0) += G.mxy_matrix(Ex);  Ex *= 1.0 / A1(l,0);
-                }
+            if (l == m)         // Diagonal, no l - 1
+            {
+                if (l < l0) {   Ex *= A1(l,0);   Dh(l+1,0) += G.mxy_matrix(Ex);     Ex *= 1.0 / A1(l,0);}
             }
-
-            #pragma omp barrier
-            /// -------------------------------------------------------------------------------------- ///
-            /// Diagonal
-            /// -------------------------------------------------------------------------------------- ///
-            for (size_t id = f_end[this_thread]; id < f_start[this_thread+1]; ++id)
+            else if (l == l0)   // Last l, no l + 1
             {
-                l = nwsediag_il[id];
-                m = nwsediag_im[id];
+                                Ex *= A2(l,0);  Dh(l-1,0) += H.mxy_matrix(Ex);      Ex *= 1.0 / A2(l,0);
+            }
+            else
+            {
+                                Ex *= A2(l,0);              Dh(l-1,0) += H.mxy_matrix(Ex);
+                                Ex *= A1(l,0) / A2(l,0);    Dh(l+1,0) += G.mxy_matrix(Ex);  Ex *= 1.0 / A1(l,0);
+            }
+        }
+
+        balance.barrier();
+        /// -------------------------------------------------------------------------------------- ///
+        /// Diagonal
+        /// -------------------------------------------------------------------------------------- ///
+        for (size_t id = b_start; id < b_end; ++id)
+        {
+            l = nwsediag_il[id];
+            m = nwsediag_im[id];
 
-                MakeGH(Din(l,m),G,H,l);
+            MakeGH(Din(l,m),G,H,l);
 
-                if (m == 0)         // Top or Left, no l - 1, m - 1
-                {
-                                    Em *= C1[m];    Dh(l+1,m+1) += G.mxy_matrix(Em);        Em *= 1.0/C1[m];
-                }
-                else if (m == m0 || l == l0)   // Bottom or right, no l + 1, m + 1
-                {
-                                    Ep *= C4(l,m);  Dh(l-1,m-1) += H.mxy_matrix(Ep);        Ep *= 1.0/C4(l,m);
-                }
-                else
-                {
-                                    Em *= C1[m];    Dh(l+1,m+1) += G.mxy_matrix(Em);        Em *= 1.0/C1[m];
-                    if (m > 1)  {   Ep *= C4(l,m);  Dh(l-1,m-1) += H.mxy_matrix(Ep);        Ep *= 1.0/C4(l,m);}
-                }
+            if (m == 0)         // Top or Left, no l - 1, m - 1
+            {
+                                Em *= C1[m];    Dh(l+1,m+1) += G.mxy_matrix(Em);        Em *= 1.0/C1[m];
             }
-
-            #pragma omp barrier
-            /// -------------------------------------------------------------------------------------- ///
-            /// Anti-Diagonal
-            /// -------------------------------------------------------------------------------------- ///
-            for (size_t id = f_end[this_thread]; id < f_start[this_thread+1]; ++id)
+            else if (m == m0 || l == l0)   // Bottom or right, no l + 1, m + 1
             {
-                l = neswdiag_il[id];
-                m = neswdiag_im[id];
+                                Ep *= C4(l,m);  Dh(l-1,m-1) += H.mxy_matrix(Ep);        Ep *= 1.0/C4(l,m);
+            }
+            else
+            {
+                                Em *= C1[m];    Dh(l+1,m+1) += G.mxy_matrix(Em);        Em *= 1.0/C1[m];
+                if (m > 1)  {   Ep *= C4(l,m);  Dh(l-1,m-1) += H.mxy_matrix(Ep);        Ep *= 1.0/C4(l,m);}
+            }
+        }
 
-                MakeGH(Din(l,m),G,H,l);
+        balance.barrier();
+        /// -------------------------------------------------------------------------------------- ///
+        /// Anti-Diagonal
+        /// -------------------------------------------------------------------------------------- ///
+        for (size_t id = b_start; id < b_end; ++id)
+        {
+            l = neswdiag_il[id];
+            m = neswdiag_im[id];
 
-                if (m == 0)         // Left wall, no l + 1, m - 1
-                {
-                    if (l > 1)                  {   Em *= C3[l];    Dh(l-1,1) += H.mxy_matrix(Em);        Em *= 1.0/C3[l];}
-                }
-                else if (m == m0)   // Right boundary, no l - 1, m + 1
-                {
-                    if (l < l0)                 {   Ep *= C2(l,m0);  Dh(l+1,m0-1) += G.mxy_matrix(Ep);        Ep *= 1.0/C2(l,m0);}
-                }
-                else
-                {
-                    if (m > 1 && l < l0)        {   Ep *= C2(l,m);  Dh(l+1,m-1) += G.mxy_matrix(Ep);        Ep *= 1.0/C2(l,m);}
-                    if (l - 1 != m && l != m)   {   Em *= C3[l];    Dh(l-1,m+1) += H.mxy_matrix(Em);        Em *= 1.0/C3[l];}
-                }
+            MakeGH(Din(l,m),G,H,l);
+
+            if (m == 0)         // Left wall, no l + 1, m - 1
+            {
+                if (l > 1)                  {   Em *= C3[l];    Dh(l-1,1) += H.mxy_matrix(Em);        Em *= 1.0/C3[l];}
+            }
+            else if (m == m0)   // Right boundary, no l - 1, m + 1
+            {
+                if (l < l0)                 {   Ep *= C2(l,m0);  Dh(l+1,m0-1) += G.mxy_matrix(Ep);        Ep *= 1.0/C2(l,m0);}
+            }
+            else
+            {
+                if (m > 1 && l < l0)        {   Ep *= C2(l,m);  Dh(l+1,m-1) += G.mxy_matrix(Ep);        Ep *= 1.0/C2(l,m);}
+                if (l - 1 != m && l != m)   {   Em *= C3[l];    Dh(l-1,m+1) += H.mxy_matrix(Em);        Em *= 1.0/C3[l];}
             }
         }
     }
+    balance.leave(f_start, f_end);
 
 }
 //--------------------------------------------------------------
@@ -2234,6 +2470,7 @@ void Electric_Field::operator()(const DistFunc2D& Din,
 //--------------------------------------------------------------
     : A1(Nm+1), B1(Nl+1), A2(Nl+1,Nm+1), A3(0.5),
         f_start(Input::List().ompthreads),f_end(Input::List().ompthreads),//, sigma(Nx)//, killedbyPML((1.0,0.0),Nx)
+        balance("Magnetic_Field",Nl,Nm,3,false),
         dist_il((Nm+1)*(2*Nl-Nm+2)/2),dist_im((Nm+1)*(2*Nl-Nm+2)/2)
     {
 //      - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -2278,40 +2515,8 @@ void Electric_Field::operator()(const DistFunc2D& Din,
         // ----- // ----- // ----- // ----- // ----- // ----- // ----- // ----- 
         // ----- // ----- // ----- // ----- // ----- // ----- // ----- // ----- 
         // Prepare chunk indices for OpenMP 
-        size_t num_threads = Input::List().ompthreads;
         size_t num_dists = (Nm+1)*(2*Nl-Nm+2)/2;
-        size_t fsperthread = static_cast<size_t>(num_dists/num_threads - 2);
-        
-        if (num_threads > 1)
-        { 
-            // std::cout << "\n\n numthreads = " << num_threads;
-
-            f_start[0] = 3;
-            f_end[0]   = fsperthread-2;
-
-            // std::cout << "\nls[" << 0 << "]=" << f_start[0] << "\n\n";
-            // std::cout << "le[" << 0 << "]=" << f_end[0] << "\n\n";
-
-            for (size_t i(1); i<num_threads-1; ++i)
-            {        
-                f_start[i] = f_end[i-1] + 2;
-                f_end[i]   = f_start[i] + fsperthread;
-                
-                // std::cout << "\nls[" << i << "]=" << f_start[i] << "\n\n";
-                // std::cout << "le[" << i << "]=" << f_end[i] << "\n\n";
-            }
-
-            f_start[num_threads-1] = f_end[num_threads-2] + 2;
-            f_end[num_threads-1]   = num_dists;     
-
-            // std::cout << "\nls[" << num_threads-1 << "]=" << f_start[num_threads-1] << "\n\n";
-            // std::cout << "le[" << num_threads-1 << "]=" << f_end[num_threads-1] << "\n\n";
-        }
-        else
-        {
-            f_start[0] = 3;
-            f_end[0] = num_dists;
-        }
+        Harmonic_Group::Chunks(3, num_dists, f_start, f_end);
 
         size_t il(0), im(0);
         for (size_t id(0); id < num_dists; ++id)
@@ -2332,7 +2537,7 @@ void Electric_Field::operator()(const DistFunc2D& Din,
             }
         }
 
-
+        evaluates(Nl, Nm, 3, dist_il, dist_im);
     }
 //--------------------------------------------------------------
 
@@ -2345,9 +2550,16 @@ void Electric_Field::operator()(const DistFunc2D& Din,
 //  This is the core calculation for the magnetic field
 //--------------------------------------------------------------
 
+    //  Outside of a functor's team: open one for this call only
+    if (omp_get_level() == 0) {
+        #pragma omp parallel num_threads(Input::List().ompthreads)
+        (*this)(Din,FBx,FBy,FBz,Dh);
+        return;
+    }
+    balance.enter();
+
     complex<double> ii(0.0,1.0);
 
-    #pragma omp parallel num_threads(Input::List().ompthreads)
     {
         valarray<complex<double> > Bx(FBx.array());
         valarray<complex<double> > Bm(FBy.array());
@@ -2375,7 +2587,7 @@ void Electric_Field::operator()(const DistFunc2D& Din,
 
         size_t l(0),m(0);
 
-        if (this_thread == 0)
+        if (this_thread == 0 && first_share())
         {
             FLM = Din(1,0);                 Dh(1,1) += FLM.mxaxis(Bp);
             // - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -2388,6 +2600,9 @@ void Electric_Field::operator()(const DistFunc2D& Din,
             // - - - - - - - - - - - - - - - - - - - - - - - - - - -
             FLM = Din(1,1); Bm *= B1[1];    FLM = FLM.mxaxis(Bm);     Dh(1,0) += FLM.Re();  Bm /= B1[1];
         }
+        //  In a group, or with the whole share on one thread, another
+        //  chunk may start within reach of the harmonics written above
+        if (first_reach(f_start, f_end)) balance.barrier();
 
         // ----------------------------------------- //
         //              Do the chunks
@@ -2430,7 +2645,8 @@ void Electric_Field::operator()(const DistFunc2D& Din,
     //          Boundaries between chunks
     // ----------------------------------------- //
 
-    #pragma omp parallel for num_threads(f_start.size()-1)
+    balance.barrier();
+    #pragma omp for nowait
     for (size_t threadboundaries = 0; threadboundaries < f_start.size()-1; ++threadboundaries)
     {
         valarray<complex<double> > Bx(FBx.array());
@@ -2490,6 +2706,7 @@ void Electric_Field::operator()(const DistFunc2D& Din,
             }
         }
     }
+    balance.leave(f_start, f_end);
 }
 //--------------------------------------------------------------
 //--------------------------------------------------------------
@@ -2501,6 +2718,14 @@ void Magnetic_Field::operator()(const DistFunc2D& Din,
 //  This is the core calculation for the magnetic field
 //--------------------------------------------------------------
 
+    //  Outside of a functor's team: open one for this call only
+    if (omp_get_level() == 0) {
+        #pragma omp parallel num_threads(Input::List().ompthreads)
+        (*this)(Din,FBx,FBy,FBz,Dh);
+        return;
+    }
+    balance.enter();
+
 //     complex<double> ii(0.0,1.0);
 
 //     Array2D<complex<double> > Bx(FBx.array());
@@ -2573,7 +2798,6 @@ void Magnetic_Field::operator()(const DistFunc2D& Din,
 
     
 
-    #pragma omp parallel num_threads(Input::List().ompthreads)
     {
         complex<double> ii(0.0,1.0);
 
@@ -2603,7 +2827,7 @@ void Magnetic_Field::operator()(const DistFunc2D& Din,
 
         size_t l(0),m(0);
 
-        if (this_thread == 0)
+        if (this_thread == 0 && first_share())
         {
             FLM = Din(1,0);                 Dh(1,1) += FLM.mxy_matrix(Bp);
             // - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -2616,6 +2840,9 @@ void Magnetic_Field::operator()(const DistFunc2D& Din,
             // - - - - - - - - - - - - - - - - - - - - - - - - - - -
             FLM = Din(1,1); Bm *= B1[1];    FLM = FLM.mxy_matrix(Bm);     Dh(1,0) += FLM.Re();  Bm *= 1.0/B1[1];
         }
+        //  In a group, or with the whole share on one thread, another
+        //  chunk may start within reach of the harmonics written above
+        if (first_reach(f_start, f_end)) balance.barrier();
 
         // ----------------------------------------- //
         //              Do the chunks
@@ -2659,7 +2886,8 @@ void Magnetic_Field::operator()(const DistFunc2D& Din,
     //          Boundaries between chunks
     // ----------------------------------------- //
 
-    #pragma omp parallel for num_threads(f_start.size()-1)
+    balance.barrier();
+    #pragma omp for nowait
     for (size_t threadboundaries = 0; threadboundaries < f_start.size()-1; ++threadboundaries)
     {
         /// Local variables for each thread
@@ -2722,6 +2950,7 @@ void Magnetic_Field::operator()(const DistFunc2D& Din,
             }
         }
     }
+    balance.leave(f_start, f_end);
 
 }
 //--------------------------------------------------------------
@@ -2831,6 +3060,7 @@ Spatial_Advection::Spatial_Advection(size_t Nl, size_t Nm,
               complex<double>(1.0),
               dp.size())),
             f_start(Input::List().ompthreads),f_end(Input::List().ompthreads),//, sigma(Nx)//, killedbyPML((1.0,0.0),Nx)
+            balance("Spatial_Advection",Nl,Nm,1,true),
             dist_il((Nm+1)*(2*Nl-Nm+2)/2),dist_im((Nm+1)*(2*Nl-Nm+2)/2),
             nwsediag_il((Nm+1)*(2*Nl-Nm+2)/2),nwsediag_im((Nm+1)*(2*Nl-Nm+2)/2),
             neswdiag_il((Nm+1)*(2*Nl-Nm+2)/2),neswdiag_im((Nm+1)*(2*Nl-Nm+2)/2)
@@ -2917,41 +3147,8 @@ Spatial_Advection::Spatial_Advection(size_t Nl, size_t Nm,
            }
     // ----- // ----- // ----- // ----- // ----- // ----- // ----- // ----- 
     // OpenMP stuff
-        size_t num_threads = Input::List().ompthreads;
         size_t num_dists = (((Nm+1)*(2*Nl-Nm+2))/2);
-        size_t fsperthread = static_cast<size_t>(num_dists/num_threads - 2);
-
-        if (num_threads > 272 || num_threads < 1) num_threads = 1;
-
-    // // std::cout << "\n numthreads = " << num_threads << "\n\n";    
-    //     size_t lsperthread = static_cast<size_t>(Nl/num_threads - 2);
-    
-        if (num_threads > 1) 
-        {       
-            f_start[0] = 1;
-            f_end[0]   = fsperthread - 2;           // Remember that f_end isn't actually processed
-                                                    // until the boundaries so that a gap of 2 is 
-                                                    // actually a gap of 3
-
-            // if (num_threads > 1) std::cout << "\nls[" << 0 << "]=" << f_start[0] << "\n\n";
-            // if (num_threads > 1) std::cout << "le[" << 0 << "]=" << f_end[0] << "\n\n";
-
-            for (size_t i(1); i<num_threads-1; ++i)
-            {        
-                f_start[i] = f_end[i-1] + 2;
-                f_end[i]   = f_start[i] + fsperthread;
-                // if (num_threads > 1)    std::cout << "\nls[" << i << "]=" << f_start[i] << "\n\n";
-                // if (num_threads > 1)    std::cout << "le[" << i << "]=" << f_end[i] << "\n\n";
-            }
-
-            f_start[num_threads-1] = f_end[num_threads-2] + 2;
-            f_end[num_threads-1]   = num_dists; 
-        }
-        else
-        {
-            f_start[0] = 1;
-            f_end[0]   = num_dists; 
-        }
+        Harmonic_Group::Chunks(1, num_dists, f_start, f_end);
 
         
 
@@ -3041,6 +3238,9 @@ Spatial_Advection::Spatial_Advection(size_t Nl, size_t Nm,
 // ----- // ----- // ----- // ----- // ----- // ----- // ----- // ----- 
 // ----- // ----- // ----- // ----- // ----- // ----- // ----- // -----     
                 
+        evaluates(Nl, Nm, 1, dist_il, dist_im);
+        evaluates(Nl, Nm, 1, nwsediag_il, nwsediag_im);
+        evaluates(Nl, Nm, 1, neswdiag_il, neswdiag_im);
     }
 //--------------------------------------------------------------
 
@@ -3049,6 +3249,14 @@ Spatial_Advection::Spatial_Advection(size_t Nl, size_t Nm,
    void Spatial_Advection::operator()(const DistFunc2D& Din, DistFunc2D& Dh) {
 //--------------------------------------------------------------
 
+    //  Outside of a functor's team: open one for this call only
+    if (omp_get_level() == 0) {
+        #pragma omp parallel num_threads(Input::List().ompthreads)
+        (*this)(Din,Dh);
+        return;
+    }
+    balance.enter();
+
 //     valarray<complex<double> > vt(vr); vt *= 1.0/Din.mass(); 
 //         // vt += fluidvelocity;       
 //     size_t l0(Din.l0());
@@ -3174,7 +3382,6 @@ Spatial_Advection::Spatial_Advection(size_t Nl, size_t Nm,
     //   The parallelization is performed in chunks and boundaries
     //   are taken care of later
     //  -------------------------------------------------------- //
-    #pragma omp parallel num_threads(Input::List().ompthreads)
     {   
         /// Determine which chunk to do
         size_t this_thread  = omp_get_thread_num();
@@ -3190,7 +3397,7 @@ Spatial_Advection::Spatial_Advection(size_t Nl, size_t Nm,
 
         SHarmonic2D fd1(Din(0,0)),fd2(Din(0,0));
 
-        if (this_thread == 0)
+        if (this_thread == 0 && first_share())
         {
             // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
             //      m = 0, l = 0
@@ -3217,6 +3424,9 @@ Spatial_Advection::Spatial_Advection(size_t Nl, size_t Nm,
 
             vtemp *= 1.0/B2[l0];
         }
+        //  In a group, or with the whole share on one thread, another
+        //  chunk may start within reach of the harmonics written above
+        if (first_reach(f_start, f_end)) balance.barrier();
 
         // std::cout << "\n Checkpoint #1 \n";   Dh.checknan(); std::cout << ".. passed \n";
         
@@ -3252,7 +3462,7 @@ Spatial_Advection::Spatial_Advection(size_t Nl, size_t Nm,
         }
         // std::cout << "\n Checkpoint #2 \n";   Dh.checknan();    std::cout << ".. passed \n";
 
-        #pragma omp barrier
+        balance.barrier();
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         //      Diagonal loop, f_start < l < f_end
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -3279,7 +3489,7 @@ Spatial_Advection::Spatial_Advection(size_t Nl, size_t Nm,
         }
     
         // std::cout << "\n Checkpoint #3 \n";   Dh.checknan();    std::cout << ".. passed \n";        
-        #pragma omp barrier
+        balance.barrier();
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         //      Anti-Diagonal loop, f_start < l < f_end
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -3314,7 +3524,7 @@ Spatial_Advection::Spatial_Advection(size_t Nl, size_t Nm,
     //  -------------------------------------------------------- //
     //  Do the boundaries between the chunks
     //  -------------------------------------------------------- //
-    #pragma omp parallel num_threads(f_start.size()-1)
+    balance.barrier();
     // for (size_t threadboundaries = 0; threadboundaries < f_start.size()-1; ++threadboundaries)
     {  
         /// Determine which chunk to do
@@ -3329,92 +3539,98 @@ Spatial_Advection::Spatial_Advection(size_t Nl, size_t Nm,
 
         SHarmonic2D fd1(Din(0,0)),fd2(Din(0,0));
 
-        if (this_thread < f_start.size() - 1) 
+        /// The last thread has no boundary above its chunk
+        size_t b_start(0), b_end(0);
+        if (this_thread + 1 < f_start.size())
         {
-            // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-            //      Vertical loop, boundaries between threads
-            // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-            for (size_t id = f_end[this_thread]; id < f_start[this_thread+1]; ++id)
-            {
+            b_start = f_end[this_thread];
+            b_end   = f_start[this_thread+1];
+        }
 
-                l = dist_il[id];
-                m = dist_im[id];
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        //      Vertical loop, boundaries between threads
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        for (size_t id = b_start; id < b_end; ++id)
+        {
 
-                // std::cout << "\n (l,m) = " << l << ", " << m << " \n";
+            l = dist_il[id];
+            m = dist_im[id];
 
-                fd1 = Din(l,m);     fd1 = fd1.Dx(Input::List().dbydx_order);  
+            // std::cout << "\n (l,m) = " << l << ", " << m << " \n";
 
-                if (l == m)         // Diagonal, no l - 1
-                {
-                    if (l < l0){    vtemp *= A1(m,m);                           Dh(m+1,m) += fd1.mpaxis(vtemp);     vtemp /= A1(m,m);}
-                }
-                else if (l == l0)   // Last l, no l + 1
-                {                
-                                    vtemp *= A2(l0,m);                          Dh(l0-1,m) += fd1.mpaxis(vtemp);    vtemp /= A2(l0,m);
-                }
-                else
-                {
-                                    vtemp *= A2(l,m);               fd2 = fd1;  Dh(l-1,m) += fd1.mpaxis(vtemp);
-                                    vtemp *= A1(l,m)/A2(l  ,m);                 Dh(l+1,m) += fd2.mpaxis(vtemp);     vtemp /= A1(l,m);                    
-                }
-            }
+            fd1 = Din(l,m);     fd1 = fd1.Dx(Input::List().dbydx_order);  
 
-            #pragma omp barrier
-            /// -------------------------------------------------------------------------------------- ///
-            /// Diagonal
-            /// -------------------------------------------------------------------------------------- ///
-            for (size_t id = f_end[this_thread]; id < f_start[this_thread+1]; ++id)
+            if (l == m)         // Diagonal, no l - 1
+            {
+                if (l < l0){    vtemp *= A1(m,m);                           Dh(m+1,m) += fd1.mpaxis(vtemp);     vtemp /= A1(m,m);}
+            }
+            else if (l == l0)   // Last l, no l + 1
+            {                
+                                vtemp *= A2(l0,m);                          Dh(l0-1,m) += fd1.mpaxis(vtemp);    vtemp /= A2(l0,m);
+            }
+            else
             {
-                l = nwsediag_il[id];
-                m = nwsediag_im[id];
+                                vtemp *= A2(l,m);               fd2 = fd1;  Dh(l-1,m) += fd1.mpaxis(vtemp);
+                                vtemp *= A1(l,m)/A2(l  ,m);                 Dh(l+1,m) += fd2.mpaxis(vtemp);     vtemp /= A1(l,m);                    
+            }
+        }
 
-                fd1 = Din(l,m);     fd1 = fd1.Dy(Input::List().dbydy_order);;
+        balance.barrier();
+        /// -------------------------------------------------------------------------------------- ///
+        /// Diagonal
+        /// -------------------------------------------------------------------------------------- ///
+        for (size_t id = b_start; id < b_end; ++id)
+        {
+            l = nwsediag_il[id];
+            m = nwsediag_im[id];
 
-                if (m == 0)         // Top or Left, no l - 1, m - 1
-                {
-                    if (l < l0) {   vtemp *= C1[l];             Dh(l+1,m+1) += fd1.mpaxis(vtemp);   vtemp *= 1.0/C1[l];}
-                }
-                else if (m == m0 || l == l0)   // Bottom or right, no l + 1, m + 1
-                {
-                                    vtemp *= C4(l,m);           Dh(l-1,m-1) += fd1.mpaxis(vtemp);   vtemp *= 1.0/C4(l,m);
-                }
-                else
-                {       
-                    fd2 = fd1;      vtemp *= C1[l];             Dh(l+1,m+1) += fd1.mpaxis(vtemp);   vtemp *= 1.0/C1[l]; 
-                    if (m>1)    {   vtemp *= C4(l,m);           Dh(l-1,m-1) += fd2.mpaxis(vtemp);   vtemp *= 1.0/C4(l,m);}
-                }
-            }
+            fd1 = Din(l,m);     fd1 = fd1.Dy(Input::List().dbydy_order);;
 
-            #pragma omp barrier
-            /// -------------------------------------------------------------------------------------- ///
-            /// Anti-Diagonal
-            /// -------------------------------------------------------------------------------------- ///
-            for (size_t id = f_end[this_thread]; id < f_start[this_thread+1]; ++id)
+            if (m == 0)         // Top or Left, no l - 1, m - 1
             {
-                l = neswdiag_il[id];
-                m = neswdiag_im[id];
+                if (l < l0) {   vtemp *= C1[l];             Dh(l+1,m+1) += fd1.mpaxis(vtemp);   vtemp *= 1.0/C1[l];}
+            }
+            else if (m == m0 || l == l0)   // Bottom or right, no l + 1, m + 1
+            {
+                                vtemp *= C4(l,m);           Dh(l-1,m-1) += fd1.mpaxis(vtemp);   vtemp *= 1.0/C4(l,m);
+            }
+            else
+            {       
+                fd2 = fd1;      vtemp *= C1[l];             Dh(l+1,m+1) += fd1.mpaxis(vtemp);   vtemp *= 1.0/C1[l]; 
+                if (m>1)    {   vtemp *= C4(l,m);           Dh(l-1,m-1) += fd2.mpaxis(vtemp);   vtemp *= 1.0/C4(l,m);}
+            }
+        }
 
-                fd1 = Din(l,m);     fd1 = fd1.Dy(Input::List().dbydy_order);;
+        balance.barrier();
+        /// -------------------------------------------------------------------------------------- ///
+        /// Anti-Diagonal
+        /// -------------------------------------------------------------------------------------- ///
+        for (size_t id = b_start; id < b_end; ++id)
+        {
+            l = neswdiag_il[id];
+            m = neswdiag_im[id];
 
-                if (m == 0)         // Left wall, no l + 1, m - 1
-                {
-                    if (l > 1)  {               vtemp *= C3[l];         Dh(l-1,m+1) += fd1.mpaxis(vtemp);    vtemp *= 1.0/C3[l];}
-                }
-                else if (m == m0)   // Right boundary, no l - 1, m + 1
-                {
-                    if (l < l0) {               vtemp *= C2(l,m);       Dh(l+1,m-1) += fd1.mpaxis(vtemp);    vtemp *= 1.0/C2(l,m);}
-                }
-                else
-                {          
-                    if (m > 1 && l < l0)        
-                    {   
-                        fd2 = fd1;              vtemp *= C2(l,m);       Dh(l+1,m-1) += fd2.mpaxis(vtemp);    vtemp *= 1.0/C2(l,m);                  
-                    }
-                    if (l - 1 != m && l != m){  vtemp *= C3[l];         Dh(l-1,m+1) += fd1.mpaxis(vtemp);    vtemp *= 1.0/C3[l];}
+            fd1 = Din(l,m);     fd1 = fd1.Dy(Input::List().dbydy_order);;
+
+            if (m == 0)         // Left wall, no l + 1, m - 1
+            {
+                if (l > 1)  {               vtemp *= C3[l];         Dh(l-1,m+1) += fd1.mpaxis(vtemp);    vtemp *= 1.0/C3[l];}
+            }
+            else if (m == m0)   // Right boundary, no l - 1, m + 1
+            {
+                if (l < l0) {               vtemp *= C2(l,m);       Dh(l+1,m-1) += fd1.mpaxis(vtemp);    vtemp *= 1.0/C2(l,m);}
+            }
+            else
+            {          
+                if (m > 1 && l < l0)        
+                {   
+                    fd2 = fd1;              vtemp *= C2(l,m);       Dh(l+1,m-1) += fd2.mpaxis(vtemp);    vtemp *= 1.0/C2(l,m);                  
                 }
+                if (l - 1 != m && l != m){  vtemp *= C3[l];         Dh(l-1,m+1) += fd1.mpaxis(vtemp);    vtemp *= 1.0/C3[l];}
             }
         }
     }
+    balance.leave(f_start, f_end);
 }
 //--------------------------------------------------------------
 //--------------------------------------------------------------
@@ -3424,10 +3640,17 @@ Spatial_Advection::Spatial_Advection(size_t Nl, size_t Nm,
 void Spatial_Advection::operator()(const DistFunc1D& Din, DistFunc1D& Dh) 
 {
 //--------------------------------------------------------------
+
+    //  Outside of a functor's team: open one for this call only
+    if (omp_get_level() == 0) {
+        #pragma omp parallel num_threads(Input::List().ompthreads)
+        (*this)(Din,Dh);
+        return;
+    }
+    balance.enter();
     size_t l0(Din.l0());
     size_t m0(Din.m0());
 
-    #pragma omp parallel num_threads(Input::List().ompthreads)
     {
         size_t this_thread  = omp_get_thread_num();
 
@@ -3440,12 +3663,15 @@ void Spatial_Advection::operator()(const DistFunc1D& Din, DistFunc1D& Dh)
 
         SHarmonic1D fd1(vr.size(),Din(0,0).numx()),fd2(vr.size(),Din(0,0).numx());
         
-        if (this_thread == 0)
+        if (this_thread == 0 && first_share())
         {
             fd1 = Din(0,0);                         fd1 = fd1.Dx(Input::List().dbydx_order);
             vtemp *= A1(0,0);                       Dh(1,0) += fd1.mpaxis(vtemp);
             vtemp /= A1(0,0);
         }
+        //  In a group, or with the whole share on one thread, another
+        //  chunk may start within reach of the harmonics written above
+        if (first_reach(f_start, f_end)) balance.barrier();
 
         // ----------------------------------------- //
         //              Do the chunks
@@ -3477,7 +3703,8 @@ void Spatial_Advection::operator()(const DistFunc1D& Din, DistFunc1D& Dh)
     //          Boundaries between chunks
     // ----------------------------------------- //
 
-    #pragma omp parallel for num_threads(f_start.size()-1)
+    balance.barrier();
+    #pragma omp for nowait
     for (size_t threadboundaries = 0; threadboundaries < f_start.size()-1; ++threadboundaries)
     {
         valarray<complex<double> > vtemp(vr);
@@ -3507,6 +3734,7 @@ void Spatial_Advection::operator()(const DistFunc1D& Din, DistFunc1D& Dh)
             }
         }
     }
+    balance.leave(f_start, f_end);
 }
 //--------------------------------------------------------------
 //--------------------------------------------------------------
@@ -3514,11 +3742,18 @@ void Spatial_Advection::operator()(const DistFunc1D& Din, DistFunc1D& Dh)
 void Spatial_Advection::es1d(const DistFunc1D& Din, DistFunc1D& Dh) {
 //--------------------------------------------------------------
 
+    //  Outside of a functor's team: open one for this call only
+    if (omp_get_level() == 0) {
+        #pragma omp parallel num_threads(Input::List().ompthreads)
+        es1d(Din,Dh);
+        return;
+    }
+    balance.enter();
+
     // valarray<complex<double> > vtemp(vr);
 
     size_t l0(Din.l0());
 
-    #pragma omp parallel num_threads(Input::List().ompthreads)
     {   
         size_t this_thread  = omp_get_thread_num();
         // std::cout << "\n hi i'm " << this_thread << "\n";
@@ -3540,7 +3775,7 @@ void Spatial_Advection::es1d(const DistFunc1D& Din, DistFunc1D& Dh) {
         //   Last thread takes the boundary condition (l = l0)
         //  Rest proceed to chunks
         //  -------------------------------------------------------- //
-        if (this_thread == 0)
+        if (this_thread == 0 && first_share())
         {
             fd1 = Din(0,0);                         fd1 = fd1.Dx(Input::List().dbydx_order);
             vtemp *= A1(0,0);                       Dh(1,0) += fd1.mpaxis(vtemp);
@@ -3549,7 +3784,7 @@ void Spatial_Advection::es1d(const DistFunc1D& Din, DistFunc1D& Dh) {
             f_start_thread = 1;
         }
 
-        if (this_thread == Input::List().ompthreads - 1)    
+        if (this_thread == Input::List().ompthreads - 1 && last_share())
         {    
             fd1 = Din(l0,0);                        fd1 = fd1.Dx(Input::List().dbydx_order);
             vtemp *= A2(l0,0);                      Dh(l0-1,0) += fd1.mpaxis(vtemp);
@@ -3557,6 +3792,9 @@ void Spatial_Advection::es1d(const DistFunc1D& Din, DistFunc1D& Dh) {
 
             f_end_thread -= 1;
         }
+        //  In a group, or with the whole share on one thread, another
+        //  chunk may start within reach of the harmonics written above
+        if (first_reach(f_start, f_end)) balance.barrier();
 
         //  -------------------------------------------------------- //
         //  Do the chunks
@@ -3577,7 +3815,8 @@ void Spatial_Advection::es1d(const DistFunc1D& Din, DistFunc1D& Dh) {
     //  -------------------------------------------------------- //
     //  Do the boundaries between the chunks
     //  -------------------------------------------------------- //
-    #pragma omp parallel for num_threads(f_start.size()-1)
+    balance.barrier();
+    #pragma omp for nowait
     for (size_t threadboundaries = 0; threadboundaries < f_start.size()-1; ++threadboundaries)
     {
         SHarmonic1D fd1(vr.size(),Din(0,0).numx()),fd2(vr.size(),Din(0,0).numx());
@@ -3595,6 +3834,7 @@ void Spatial_Advection::es1d(const DistFunc1D& Din, DistFunc1D& Dh) {
             vtemp *= A1(l,0)/A2(l  ,0);                Dh(l+1,0) += fd2.mpaxis(vtemp);
         }
     }         
+    balance.leave(f_start, f_end);
 
     // }
     
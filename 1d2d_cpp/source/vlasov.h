@@ -12,6 +12,46 @@
 /** \addtogroup vfp1d
  *  @{
  */
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+//  Harmonic chunks of the OpenMP threads
+//  The threads of a chunked operator time their waits in its
+//  barriers over the first calls and the idle fractions are
+//  reported. With OpenMP_Balance the chunks are re-cut to the
+//  measured cost for a few rounds and the fastest one is kept.
+//  The balance of spatial advection places the harmonics, the
+//  chunks it keeps become their chunk table (harmonic_chunks).
+class Chunk_Balance {
+//--------------------------------------------------------------
+public:
+//      Constructors/Destructors
+    Chunk_Balance(string _name, size_t Nl, size_t Nm, size_t _first, bool _places);
+//          Timed synchronization of the team
+    void enter();
+    void barrier();
+    void leave(valarray<size_t>& f_start, valarray<size_t>& f_end);
+
+private:
+    void round(valarray<size_t>& f_start, valarray<size_t>& f_end);
+    void recut(valarray<size_t>& f_start, valarray<size_t>& f_end) const;
+    void report() const;
+    void place(const valarray<size_t>& f_start);
+
+    string                          name;
+    size_t                          l0, m0, first, last;    //  harmonics [first,last) of this rank
+    size_t                          calls, rounds;
+    bool                            timing, recuttable, places;
+    size_t                          placed_at;              //  the call the harmonics move after
+    int                             rank;
+
+    valarray<double>                entered, waited;        //  this call
+    valarray<double>                busy, idle;             //  this round
+    valarray<double>                idle_first, idle_best;  //  fraction of the round
+    double                          wall_best;
+    valarray<size_t>                start_best, end_best;
+};
+//--------------------------------------------------------------
+
 //--------------------------------------------------------------
 //--------------------------------------------------------------
 //  Spatial advection
@@ -23,7 +63,8 @@ public:
                         valarray<double> dp,
                         double xmin, double xmax, size_t Nx,
                         double ymin, double ymax, size_t Ny);
-//          Advance
+//          Advance: operator() and es1d are work-shared by every thread
+//          of the calling team, or fork their own outside of one
     void operator()(const DistFunc1D& Din, DistFunc1D& Dh);
     void operator()(const DistFunc2D& Din, DistFunc2D& Dh);
     void es1d(const DistFunc1D& Din, DistFunc1D& Dh);
@@ -37,6 +78,7 @@ private:
     valarray< complex<double> >  	vr;
     
     valarray<size_t>                f_start, f_end;
+    Chunk_Balance                   balance;
     valarray<size_t>                dist_il, dist_im;
     valarray<size_t>                nwsediag_il, nwsediag_im;
     valarray<size_t>                neswdiag_il, neswdiag_im;
@@ -58,7 +100,8 @@ public:
 //      Constructors/Destructors
     Electric_Field(size_t Nl, size_t Nm,                      
                     valarray<double> dp);
-//          Advance
+//          Advance: operator() and es1d are work-shared by every thread
+//          of the calling team, or fork their own outside of one
     void operator()(const DistFunc1D& Din,
                     const Field1D& FEx, const Field1D& FEy, const Field1D& FEz,
                     DistFunc1D& Dh);
@@ -112,6 +155,7 @@ private:
     valarray< complex<double> >     pr, invdp, invpr;
 
     valarray<size_t>                f_start, f_end;
+    Chunk_Balance                   balance;
     valarray<size_t>                dist_il, dist_im;
     valarray<size_t>                nwsediag_il, nwsediag_im;
     valarray<size_t>                neswdiag_il, neswdiag_im;
@@ -125,7 +169,8 @@ class Magnetic_Field {
 public:
 //      Constructors/Destructors
     Magnetic_Field(size_t Nl, size_t Nm,valarray<double> dp);
-//          Advance
+//          Advance: operator() is work-shared by every thread
+//          of the calling team, or forks its own outside of one
     void operator()(const DistFunc1D& Din,
                     const Field1D& FBx, const Field1D& FBy, const Field1D& FBz,
                     DistFunc1D& Dh);
@@ -151,6 +196,7 @@ private:
     complex<double> 				A3;
 
     valarray<size_t>                f_start, f_end;
+    Chunk_Balance                   balance;
     valarray<size_t>                dist_il, dist_im;
 };
 //--------------------------------------------------------------